@@ -54,9 +54,27 @@ HANDLE WINAPI AvSetMmThreadCharacteristicsA(const char *name, DWORD *index)
     return ret;
 }
 
+struct avrt_task
+{
+    HANDLE thread;
+    int    old_priority;
+    int    priority;
+};
+
+/* the MMCSS tasks that get a boost, audio ones run in the server's realtime range */
+static int get_task_priority(const WCHAR *name)
+{
+    if (!wcsicmp(name, L"Audio") || !wcsicmp(name, L"Pro Audio")) return THREAD_PRIORITY_TIME_CRITICAL;
+    if (!wcsicmp(name, L"Capture") || !wcsicmp(name, L"Playback") || !wcsicmp(name, L"Games"))
+        return THREAD_PRIORITY_HIGHEST;
+    return THREAD_PRIORITY_NORMAL;
+}
+
 HANDLE WINAPI AvSetMmThreadCharacteristicsW(const WCHAR *name, DWORD *index)
 {
-    FIXME("(%s,%p): stub\n", debugstr_w(name), index);
+    struct avrt_task *task;
+
+    TRACE("(%s,%p)\n", debugstr_w(name), index);
 
     if (!name)
     {
@@ -70,7 +88,21 @@ HANDLE WINAPI AvSetMmThreadCharacteristicsW(const WCHAR *name, DWORD *index)
         return NULL;
     }
 
-    return (HANDLE)0x12345678;
+    if (!(task = malloc(sizeof(*task))))
+    {
+        SetLastError(ERROR_OUTOFMEMORY);
+        return NULL;
+    }
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &task->thread,
+                         THREAD_QUERY_INFORMATION | THREAD_SET_INFORMATION, FALSE, 0))
+    {
+        free(task);
+        return NULL;
+    }
+    task->old_priority = GetThreadPriority(task->thread);
+    task->priority = get_task_priority(name);
+    if (task->priority > task->old_priority) SetThreadPriority(task->thread, task->priority);
+    return task;
 }
 
 BOOL WINAPI AvQuerySystemResponsiveness(HANDLE AvrtHandle, ULONG *value)
@@ -81,14 +113,40 @@ BOOL WINAPI AvQuerySystemResponsiveness(HANDLE AvrtHandle, ULONG *value)
 
 BOOL WINAPI AvRevertMmThreadCharacteristics(HANDLE AvrtHandle)
 {
-    FIXME("(%p): stub\n", AvrtHandle);
+    struct avrt_task *task = AvrtHandle;
+
+    TRACE("(%p)\n", AvrtHandle);
+
+    if (!task)
+    {
+        SetLastError(ERROR_INVALID_HANDLE);
+        return FALSE;
+    }
+    SetThreadPriority(task->thread, task->old_priority);
+    CloseHandle(task->thread);
+    free(task);
     return TRUE;
 }
 
 BOOL WINAPI AvSetMmThreadPriority(HANDLE AvrtHandle, AVRT_PRIORITY prio)
 {
-    FIXME("(%p)->(%u) stub\n", AvrtHandle, prio);
-    return TRUE;
+    struct avrt_task *task = AvrtHandle;
+    int priority;
+
+    TRACE("(%p)->(%u)\n", AvrtHandle, prio);
+
+    if (!task || prio < AVRT_PRIORITY_VERYLOW || prio > AVRT_PRIORITY_CRITICAL)
+    {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    if (prio == AVRT_PRIORITY_CRITICAL) priority = THREAD_PRIORITY_TIME_CRITICAL;
+    else if (task->priority == THREAD_PRIORITY_TIME_CRITICAL)
+        priority = prio >= AVRT_PRIORITY_NORMAL ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    else priority = max(THREAD_PRIORITY_LOWEST, min(THREAD_PRIORITY_HIGHEST, task->priority + prio));
+
+    return SetThreadPriority(task->thread, priority);
 }
 
 HANDLE WINAPI AvSetMmMaxThreadCharacteristicsA(const char *task1, const char *task2, DWORD *index)
@@ -117,7 +175,7 @@ HANDLE WINAPI AvSetMmMaxThreadCharacteristicsA(const char *task1, const char *ta
 
 HANDLE WINAPI AvSetMmMaxThreadCharacteristicsW(const WCHAR *task1, const WCHAR *task2, DWORD *index)
 {
-    FIXME("(%s,%s,%p): stub\n", debugstr_w(task1), debugstr_w(task2), index);
+    FIXME("(%s,%s,%p): semi-stub\n", debugstr_w(task1), debugstr_w(task2), index);
 
     if (!task1 || task2)
     {
@@ -125,11 +183,5 @@ HANDLE WINAPI AvSetMmMaxThreadCharacteristicsW(const WCHAR *task1, const WCHAR *
         return NULL;
     }
 
-    if (!index)
-    {
-        SetLastError(ERROR_INVALID_HANDLE);
-        return NULL;
-    }
-
-    return (HANDLE)0x12345678;
+    return AvSetMmThreadCharacteristicsW(task1, index);
 }
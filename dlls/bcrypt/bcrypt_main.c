@@ -1475,22 +1475,20 @@ static NTSTATUS key_symmetric_encrypt( struct key *key,  UCHAR *input, ULONG inp
 
     encrypt_params.key = key;
     encrypt_params.input = input;
-    encrypt_params.input_len = key->u.s.block_size;
+    encrypt_params.input_len = bytes_left & ~(key->u.s.block_size - 1);
     encrypt_params.output = output;
-    encrypt_params.output_len = key->u.s.block_size;
-    while (bytes_left >= key->u.s.block_size)
+    encrypt_params.output_len = encrypt_params.input_len;
+    if (encrypt_params.input_len)
     {
-        if ((status = UNIX_CALL( key_symmetric_encrypt, &encrypt_params )))
-            return status;
-        if (key->u.s.mode == CHAIN_MODE_ECB && (status = key_symmetric_set_vector( key, NULL, 0, TRUE )))
-            return status;
-        bytes_left -= key->u.s.block_size;
-        encrypt_params.input += key->u.s.block_size;
-        encrypt_params.output += key->u.s.block_size;
+        if ((status = UNIX_CALL( key_symmetric_encrypt, &encrypt_params ))) return status;
+        bytes_left -= encrypt_params.input_len;
+        encrypt_params.input += encrypt_params.input_len;
+        encrypt_params.output += encrypt_params.input_len;
     }
 
     if (flags & BCRYPT_BLOCK_PADDING)
     {
+        encrypt_params.input_len = encrypt_params.output_len = key->u.s.block_size;
         if (!(buf = malloc( key->u.s.block_size ))) return STATUS_NO_MEMORY;
         memcpy( buf, encrypt_params.input, bytes_left );
         memset( buf + bytes_left, key->u.s.block_size - bytes_left, key->u.s.block_size - bytes_left );
@@ -1577,22 +1575,21 @@ static NTSTATUS key_symmetric_decrypt( struct key *key, UCHAR *input, ULONG inpu
 
     decrypt_params.key = key;
     decrypt_params.input = input;
-    decrypt_params.input_len = key->u.s.block_size;
+    decrypt_params.input_len = bytes_left;
     decrypt_params.output = output;
-    decrypt_params.output_len = key->u.s.block_size;
-    while (bytes_left >= key->u.s.block_size)
+    decrypt_params.output_len = bytes_left;
+    if (bytes_left)
     {
         if ((status = UNIX_CALL( key_symmetric_decrypt, &decrypt_params ))) return status;
-        if (key->u.s.mode == CHAIN_MODE_ECB && (status = key_symmetric_set_vector( key, NULL, 0, TRUE )))
-            return status;
-        bytes_left -= key->u.s.block_size;
-        decrypt_params.input += key->u.s.block_size;
-        decrypt_params.output += key->u.s.block_size;
+        decrypt_params.input += bytes_left;
+        decrypt_params.output += bytes_left;
     }
 
     if (flags & BCRYPT_BLOCK_PADDING)
     {
         UCHAR *buf, *dst = decrypt_params.output;
+
+        decrypt_params.input_len = decrypt_params.output_len = key->u.s.block_size;
         if (!(buf = malloc( key->u.s.block_size ))) return STATUS_NO_MEMORY;
         decrypt_params.output = buf;
         status = UNIX_CALL( key_symmetric_decrypt, &decrypt_params );
@@ -94,7 +94,12 @@ typedef struct gnutls_x509_spki_st *gnutls_x509_spki_t;
 
 union key_data
 {
-    gnutls_cipher_hd_t cipher;
+    struct
+    {
+        gnutls_cipher_hd_t cipher;
+        ULONG              vector_len;  /* length of the vector the handle was created with */
+        BOOL               reset;       /* vector needs to be set again before the next operation */
+    } s;
     struct
     {
         gnutls_privkey_t privkey;
@@ -218,6 +223,7 @@ MAKE_FUNCPTR(gnutls_cipher_decrypt2);
 MAKE_FUNCPTR(gnutls_cipher_deinit);
 MAKE_FUNCPTR(gnutls_cipher_encrypt2);
 MAKE_FUNCPTR(gnutls_cipher_init);
+MAKE_FUNCPTR(gnutls_cipher_set_iv);
 MAKE_FUNCPTR(gnutls_dh_params_deinit);
 MAKE_FUNCPTR(gnutls_dh_params_export_raw);
 MAKE_FUNCPTR(gnutls_dh_params_import_raw);
@@ -478,6 +484,7 @@ static NTSTATUS gnutls_process_attach( void *args )
     LOAD_FUNCPTR(gnutls_cipher_deinit)
     LOAD_FUNCPTR(gnutls_cipher_encrypt2)
     LOAD_FUNCPTR(gnutls_cipher_init)
+    LOAD_FUNCPTR(gnutls_cipher_set_iv)
     LOAD_FUNCPTR(gnutls_dh_params_deinit)
     LOAD_FUNCPTR(gnutls_dh_params_export_raw)
     LOAD_FUNCPTR(gnutls_dh_params_import_raw)
@@ -841,20 +848,40 @@ static NTSTATUS key_symmetric_vector_reset( void *args )
 {
     struct key *key = args;
 
-    if (!key_data(key)->cipher) return STATUS_SUCCESS;
-    TRACE( "invalidating cipher handle\n" );
-    pgnutls_cipher_deinit( key_data(key)->cipher );
-    key_data(key)->cipher = NULL;
+    /* keep the handle and its key schedule, only the vector is set again on next use */
+    if (key_data(key)->s.cipher) key_data(key)->s.reset = TRUE;
     return STATUS_SUCCESS;
 }
 
+static void set_cipher_vector( struct key *key )
+{
+    static UCHAR zero_vector[16];
+
+    assert( key->u.s.block_size <= sizeof(zero_vector) );
+    if (key->u.s.vector) pgnutls_cipher_set_iv( key_data(key)->s.cipher, key->u.s.vector, key->u.s.vector_len );
+    else pgnutls_cipher_set_iv( key_data(key)->s.cipher, zero_vector, key->u.s.block_size );
+}
+
 static NTSTATUS init_cipher_handle( struct key *key )
 {
+    union key_data *data = key_data( key );
     gnutls_cipher_algorithm_t cipher;
     gnutls_datum_t secret, vector;
     int ret;
 
-    if (key_data(key)->cipher) return STATUS_SUCCESS;
+    if (data->s.cipher)
+    {
+        if (!data->s.reset) return STATUS_SUCCESS;
+        if (data->s.vector_len == (key->u.s.vector ? key->u.s.vector_len : 0))
+        {
+            set_cipher_vector( key );
+            data->s.reset = FALSE;
+            return STATUS_SUCCESS;
+        }
+        TRACE( "vector length changed, recreating cipher handle\n" );
+        pgnutls_cipher_deinit( data->s.cipher );
+        data->s.cipher = NULL;
+    }
     if ((cipher = get_gnutls_cipher( key )) == GNUTLS_CIPHER_UNKNOWN) return STATUS_NOT_SUPPORTED;
 
     secret.data = key->u.s.secret;
@@ -863,12 +890,14 @@ static NTSTATUS init_cipher_handle( struct key *key )
     vector.data = key->u.s.vector;
     vector.size = key->u.s.vector_len;
 
-    if ((ret = pgnutls_cipher_init( &key_data(key)->cipher, cipher, &secret, key->u.s.vector ? &vector : NULL )))
+    if ((ret = pgnutls_cipher_init( &data->s.cipher, cipher, &secret, key->u.s.vector ? &vector : NULL )))
     {
         pgnutls_perror( ret );
         return STATUS_INTERNAL_ERROR;
     }
 
+    data->s.vector_len = key->u.s.vector ? key->u.s.vector_len : 0;
+    data->s.reset = FALSE;
     return STATUS_SUCCESS;
 }
 
@@ -881,7 +910,7 @@ static NTSTATUS key_symmetric_set_auth_data( void *args )
     if (!params->auth_data) return STATUS_SUCCESS;
     if ((status = init_cipher_handle( params->key ))) return status;
 
-    if ((ret = pgnutls_cipher_add_auth( key_data(params->key)->cipher, params->auth_data, params->len )))
+    if ((ret = pgnutls_cipher_add_auth( key_data(params->key)->s.cipher, params->auth_data, params->len )))
     {
         pgnutls_perror( ret );
         return STATUS_INTERNAL_ERROR;
@@ -892,13 +921,25 @@ static NTSTATUS key_symmetric_set_auth_data( void *args )
 static NTSTATUS key_symmetric_encrypt( void *args )
 {
     const struct key_symmetric_encrypt_params *params = args;
+    struct key *key = params->key;
+    ULONG i, len = params->input_len;
     NTSTATUS status;
-    int ret;
+    int ret = 0;
 
-    if ((status = init_cipher_handle( params->key ))) return status;
+    if ((status = init_cipher_handle( key ))) return status;
 
-    if ((ret = pgnutls_cipher_encrypt2( key_data(params->key)->cipher, params->input, params->input_len,
-                                        params->output, params->output_len )))
+    /* ECB is emulated with CBC, restarting from a zero vector for each block */
+    if (key->u.s.mode == CHAIN_MODE_ECB) len = key->u.s.block_size;
+
+    for (i = 0; !ret && i < params->input_len; i += len)
+    {
+        if (i && key->u.s.mode == CHAIN_MODE_ECB) set_cipher_vector( key );
+        ret = pgnutls_cipher_encrypt2( key_data(key)->s.cipher, params->input + i, min( len, params->input_len - i ),
+                                 params->output + i, params->output_len - i );
+    }
+    if (key->u.s.mode == CHAIN_MODE_ECB) key_data(key)->s.reset = TRUE;
+
+    if (ret)
     {
         pgnutls_perror( ret );
         return STATUS_INTERNAL_ERROR;
@@ -909,13 +950,25 @@ static NTSTATUS key_symmetric_encrypt( void *args )
 static NTSTATUS key_symmetric_decrypt( void *args )
 {
     const struct key_symmetric_decrypt_params *params = args;
+    struct key *key = params->key;
+    ULONG i, len = params->input_len;
     NTSTATUS status;
-    int ret;
+    int ret = 0;
 
-    if ((status = init_cipher_handle( params->key ))) return status;
+    if ((status = init_cipher_handle( key ))) return status;
+
+    /* ECB is emulated with CBC, restarting from a zero vector for each block */
+    if (key->u.s.mode == CHAIN_MODE_ECB) len = key->u.s.block_size;
+
+    for (i = 0; !ret && i < params->input_len; i += len)
+    {
+        if (i && key->u.s.mode == CHAIN_MODE_ECB) set_cipher_vector( key );
+        ret = pgnutls_cipher_decrypt2( key_data(key)->s.cipher, params->input + i, min( len, params->input_len - i ),
+                                 params->output + i, params->output_len - i );
+    }
+    if (key->u.s.mode == CHAIN_MODE_ECB) key_data(key)->s.reset = TRUE;
 
-    if ((ret = pgnutls_cipher_decrypt2( key_data(params->key)->cipher, params->input, params->input_len,
-                                        params->output, params->output_len )))
+    if (ret)
     {
         pgnutls_perror( ret );
         return STATUS_INTERNAL_ERROR;
@@ -931,7 +984,7 @@ static NTSTATUS key_symmetric_get_tag( void *args )
 
     if ((status = init_cipher_handle( params->key ))) return status;
 
-    if ((ret = pgnutls_cipher_tag( key_data(params->key)->cipher, params->tag, params->len )))
+    if ((ret = pgnutls_cipher_tag( key_data(params->key)->s.cipher, params->tag, params->len )))
     {
         pgnutls_perror( ret );
         return STATUS_INTERNAL_ERROR;
@@ -943,7 +996,7 @@ static NTSTATUS key_symmetric_destroy( void *args )
 {
     struct key *key = args;
 
-    if (key_data(key)->cipher) pgnutls_cipher_deinit( key_data(key)->cipher );
+    if (key_data(key)->s.cipher) pgnutls_cipher_deinit( key_data(key)->s.cipher );
     return STATUS_SUCCESS;
 }
 
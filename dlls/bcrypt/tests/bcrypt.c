@@ -414,6 +414,44 @@ static void test_hashes(void)
         test_hash(tests+i);
 }
 
+static void test_hash_chunks(void)
+{
+    static const char expected[] = "55af394c980c7a7fb68aa904c4afdd93d76e5f826487105fc06f92a25bab8cbe";
+    static const ULONG chunks[] = { 1, 55, 63, 64, 65, 1000, 4096, 100000 };
+    BCRYPT_ALG_HANDLE alg;
+    BCRYPT_HASH_HANDLE hash;
+    UCHAR buf[512], hash_buf[32], *data;
+    ULONG i, j, size = 100000;
+    char str[65];
+    NTSTATUS ret;
+
+    ret = BCryptOpenAlgorithmProvider(&alg, BCRYPT_SHA256_ALGORITHM, MS_PRIMITIVE_PROVIDER, 0);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+    data = malloc(size);
+    for (i = 0; i < size; i++) data[i] = i * 7 + (i >> 8);
+
+    for (i = 0; i < ARRAY_SIZE(chunks); i++)
+    {
+        ret = BCryptCreateHash(alg, &hash, buf, sizeof(buf), NULL, 0, 0);
+        ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+        for (j = 0; j < size; j += chunks[i])
+        {
+            ret = BCryptHashData(hash, data + j, min(chunks[i], size - j), 0);
+            ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+        }
+        memset(hash_buf, 0, sizeof(hash_buf));
+        ret = BCryptFinishHash(hash, hash_buf, sizeof(hash_buf), 0);
+        ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+        format_hash(hash_buf, sizeof(hash_buf), str);
+        ok(!strcmp(str, expected), "%lu: got %s\n", chunks[i], str);
+        BCryptDestroyHash(hash);
+    }
+
+    free(data);
+    BCryptCloseAlgorithmProvider(alg, 0);
+}
+
 static void test_BcryptHash(void)
 {
     static const char expected[] =
@@ -4366,6 +4404,7 @@ START_TEST(bcrypt)
     test_BCryptGenRandom();
     test_BCryptGetFipsAlgorithmMode();
     test_hashes();
+    test_hash_chunks();
     test_BcryptHash();
     test_BcryptDeriveKeyPBKDF2();
     test_rng();
@@ -358,6 +358,12 @@ HRESULT apartment_get_local_server_stream(struct apartment *apt, IStream **ret)
     return hr;
 }
 
+static int ifstub_ipid_compare(const void *key, const struct rb_entry *entry)
+{
+    const struct ifstub *ifstub = RB_ENTRY_VALUE(entry, const struct ifstub, ipid_entry);
+    return memcmp(key, &ifstub->ipid, sizeof(IPID));
+}
+
 /* Creates new apartment for given model */
 static struct apartment *apartment_construct(DWORD model)
 {
@@ -370,6 +376,7 @@ static struct apartment *apartment_construct(DWORD model)
 
     list_init(&apt->proxies);
     list_init(&apt->stubmgrs);
+    rb_init(&apt->ifstubs, ifstub_ipid_compare);
     list_init(&apt->loaded_dlls);
     list_init(&apt->usage_cookies);
     apt->ipidc = 0;
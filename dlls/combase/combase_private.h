@@ -18,6 +18,7 @@
 #include "wine/orpc.h"
 
 #include "wine/list.h"
+#include "wine/rbtree.h"
 
 extern HINSTANCE hProxyDll;
 
@@ -33,6 +34,7 @@ struct apartment
     CRITICAL_SECTION cs;     /* thread safety */
     struct list proxies;     /* imported objects (CS cs) */
     struct list stubmgrs;    /* stub managers for exported objects (CS cs) */
+    struct rb_tree ifstubs;  /* interface stubs of the stub managers, by ipid (CS cs) */
     BOOL remunk_exported;    /* has the IRemUnknown interface for this apartment been created yet? (CS cs) */
     LONG remoting_started;   /* has the RPC system been started for this apartment? (LOCK) */
     struct list loaded_dlls; /* list of dlls loaded by this apartment (CS cs) */
@@ -207,6 +209,8 @@ typedef enum ifstub_state
 struct ifstub
 {
     struct list       entry;      /* entry in stub_manager->ifstubs list (CS stub_manager->lock) */
+    struct rb_entry   ipid_entry; /* entry in apartment->ifstubs tree (CS apartment->cs) */
+    struct stub_manager *manager; /* owning stub manager (RO) */
     IRpcStubBuffer   *stubbuffer; /* RO */
     IID               iid;        /* RO */
     IPID              ipid;       /* RO */
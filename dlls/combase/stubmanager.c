@@ -100,6 +100,7 @@ struct ifstub * stub_manager_new_ifstub(struct stub_manager *m, IRpcStubBuffer *
 
     stub->flags = flags;
     stub->iid = *iid;
+    stub->manager = m;
 
     /* FIXME: find a cleaner way of identifying that we are creating an ifstub
      * for the remunknown interface */
@@ -108,11 +109,15 @@ struct ifstub * stub_manager_new_ifstub(struct stub_manager *m, IRpcStubBuffer *
     else
         generate_ipid(m, &stub->ipid);
 
+    EnterCriticalSection(&m->apt->cs);
     EnterCriticalSection(&m->lock);
     list_add_head(&m->ifstubs, &stub->entry);
+    /* a shared ipid, like the IRemUnknown one, can only be found through the lists */
+    rb_put(&m->apt->ifstubs, &stub->ipid, &stub->ipid_entry);
     /* every normal marshal is counted so we don't allow more than we should */
     if (flags & MSHLFLAGS_NORMAL) m->norm_refs++;
     LeaveCriticalSection(&m->lock);
+    LeaveCriticalSection(&m->apt->cs);
 
     TRACE("ifstub %p created with ipid %s\n", stub, debugstr_guid(&stub->ipid));
 
@@ -318,8 +323,20 @@ ULONG stub_manager_int_release(struct stub_manager *m)
 
     /* remove from apartment so no other thread can access it... */
     if (!refs)
+    {
+        struct ifstub *ifstub;
+
         list_remove(&m->entry);
 
+        EnterCriticalSection(&m->lock);
+        LIST_FOR_EACH_ENTRY(ifstub, &m->ifstubs, struct ifstub, entry)
+        {
+            if (rb_get(&apt->ifstubs, &ifstub->ipid) == &ifstub->ipid_entry)
+                rb_remove(&apt->ifstubs, &ifstub->ipid_entry);
+        }
+        LeaveCriticalSection(&m->lock);
+    }
+
     LeaveCriticalSection(&apt->cs);
 
     /* ... so now we can delete it without being inside the apartment critsec */
@@ -472,15 +489,25 @@ ULONG stub_manager_ext_release(struct stub_manager *m, ULONG refs, BOOL tablewea
 static struct stub_manager *get_stub_manager_from_ipid(struct apartment *apt, const IPID *ipid, struct ifstub **ifstub)
 {
     struct stub_manager *result = NULL, *m;
+    struct rb_entry *entry;
 
     EnterCriticalSection(&apt->cs);
-    LIST_FOR_EACH_ENTRY(m, &apt->stubmgrs, struct stub_manager, entry)
+    if ((entry = rb_get(&apt->ifstubs, ipid)))
+    {
+        *ifstub = RB_ENTRY_VALUE(entry, struct ifstub, ipid_entry);
+        result = (*ifstub)->manager;
+        stub_manager_int_addref(result);
+    }
+    else
     {
-        if ((*ifstub = stub_manager_ipid_to_ifstub(m, ipid)))
+        LIST_FOR_EACH_ENTRY(m, &apt->stubmgrs, struct stub_manager, entry)
         {
-            result = m;
-            stub_manager_int_addref(result);
-            break;
+            if ((*ifstub = stub_manager_ipid_to_ifstub(m, ipid)))
+            {
+                result = m;
+                stub_manager_int_addref(result);
+                break;
+            }
         }
     }
     LeaveCriticalSection(&apt->cs);
@@ -484,14 +484,76 @@ static void CRYPT_CheckTrustedStatus(HCERTSTORE hRoot,
         CertFreeCertificateContext(trustedRoot);
 }
 
+/* Signature checks are by far the most expensive part of building a chain,
+ * and the same server and intermediate certs get verified over and over.
+ * Successful checks are remembered by the SHA-256 hashes of both certs.
+ */
+#define SIGNATURE_CACHE_SIZE 256
+
+struct verified_signature
+{
+    BYTE subject[32];
+    BYTE issuer[32];
+};
+
+static struct verified_signature signature_cache[SIGNATURE_CACHE_SIZE];
+
+static CRITICAL_SECTION signature_cache_cs;
+static CRITICAL_SECTION_DEBUG signature_cache_cs_debug =
+{
+    0, 0, &signature_cache_cs,
+    { &signature_cache_cs_debug.ProcessLocksList,
+      &signature_cache_cs_debug.ProcessLocksList },
+    0, 0, { (DWORD_PTR)(__FILE__ ": signature_cache_cs") }
+};
+static CRITICAL_SECTION signature_cache_cs = { &signature_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static BOOL CRYPT_HashCert(PCCERT_CONTEXT cert, BYTE *hash)
+{
+    DWORD size = 32;
+
+    return CryptHashCertificate2(BCRYPT_SHA256_ALGORITHM, 0, NULL,
+     cert->pbCertEncoded, cert->cbCertEncoded, hash, &size);
+}
+
+static BOOL CRYPT_VerifyCertSignature(PCCERT_CONTEXT subject,
+ PCCERT_CONTEXT issuer)
+{
+    struct verified_signature sig, *entry = NULL;
+    BOOL ret = FALSE;
+
+    if (CRYPT_HashCert(subject, sig.subject) &&
+     CRYPT_HashCert(issuer, sig.issuer))
+    {
+        entry = &signature_cache[(sig.subject[0] | sig.subject[1] << 8) %
+         SIGNATURE_CACHE_SIZE];
+        EnterCriticalSection(&signature_cache_cs);
+        ret = !memcmp(entry, &sig, sizeof(sig));
+        LeaveCriticalSection(&signature_cache_cs);
+        if (ret)
+            return TRUE;
+    }
+    if (CryptVerifyCertificateSignatureEx(0, subject->dwCertEncodingType,
+     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)subject,
+     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)issuer, 0, NULL))
+    {
+        if (entry)
+        {
+            EnterCriticalSection(&signature_cache_cs);
+            *entry = sig;
+            LeaveCriticalSection(&signature_cache_cs);
+        }
+        ret = TRUE;
+    }
+    return ret;
+}
+
 static void CRYPT_CheckRootCert(HCERTSTORE hRoot,
  PCERT_CHAIN_ELEMENT rootElement)
 {
     PCCERT_CONTEXT root = rootElement->pCertContext;
 
-    if (!CryptVerifyCertificateSignatureEx(0, root->dwCertEncodingType,
-     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)root,
-     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)root, 0, NULL))
+    if (!CRYPT_VerifyCertSignature(root, root))
     {
         TRACE_(chain)("Last certificate's signature is invalid\n");
         rootElement->TrustStatus.dwErrorStatus |=
@@ -1909,11 +1971,9 @@ static void CRYPT_CheckSimpleChain(CertificateChainEngine *engine,
         if (i != 0)
         {
             /* Check the signature of the cert this issued */
-            if (!CryptVerifyCertificateSignatureEx(0, X509_ASN_ENCODING,
-             CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT,
-             (void *)chain->rgpElement[i - 1]->pCertContext,
-             CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT,
-             (void *)chain->rgpElement[i]->pCertContext, 0, NULL))
+            if (!CRYPT_VerifyCertSignature(
+             chain->rgpElement[i - 1]->pCertContext,
+             chain->rgpElement[i]->pCertContext))
                 chain->rgpElement[i - 1]->TrustStatus.dwErrorStatus |=
                  CERT_TRUST_IS_NOT_SIGNATURE_VALID;
             /* Once a path length constraint has been violated, every remaining
@@ -485,6 +485,22 @@ struct d2d_curve_outline_vertex
     D2D1_POINT_2F prev, next;
 };
 
+/* GPU copies of the fill and outline data of a geometry, created on first
+ * use. Transforms and stroke widths are applied by the vertex shader, so
+ * these only depend on the device. */
+struct d2d_geometry_buffers
+{
+    ID3D11Device1 *device;
+
+    ID3D11Buffer *fill_ib, *fill_vb;
+    ID3D11Buffer *fill_bezier_vb;
+    ID3D11Buffer *fill_arc_vb;
+
+    ID3D11Buffer *outline_ib, *outline_vb;
+    ID3D11Buffer *outline_bezier_ib, *outline_bezier_vb;
+    ID3D11Buffer *outline_arc_ib, *outline_arc_vb;
+};
+
 struct d2d_geometry
 {
     ID2D1Geometry ID2D1Geometry_iface;
@@ -494,6 +510,11 @@ struct d2d_geometry
 
     D2D_MATRIX_3X2_F transform;
 
+    /* The geometry owning the fill and outline data. Transformed geometries
+     * share it with their source geometry. */
+    struct d2d_geometry *tessellation;
+    struct d2d_geometry_buffers buffers;
+
     struct
     {
         D2D1_POINT_2F *vertices;
@@ -593,6 +614,7 @@ void d2d_transformed_geometry_init(struct d2d_geometry *geometry, ID2D1Factory *
 HRESULT d2d_geometry_group_init(struct d2d_geometry *geometry, ID2D1Factory *factory,
         D2D1_FILL_MODE fill_mode, ID2D1Geometry **src_geometries, unsigned int geometry_count);
 struct d2d_geometry *unsafe_impl_from_ID2D1Geometry(ID2D1Geometry *iface);
+void d2d_geometry_buffers_cleanup(struct d2d_geometry_buffers *buffers);
 
 struct d2d_shader
 {
@@ -821,12 +821,48 @@ static HRESULT d2d_device_context_update_vs_cb(struct d2d_device_context *contex
     return S_OK;
 }
 
-static void d2d_device_context_draw_geometry(struct d2d_device_context *render_target,
-        const struct d2d_geometry *geometry, struct d2d_brush *brush, float stroke_width)
+static HRESULT d2d_device_context_get_geometry_buffer(struct d2d_device_context *context,
+        ID3D11Buffer **buffer, unsigned int bind_flags, const void *data, size_t size)
 {
     D3D11_SUBRESOURCE_DATA buffer_data;
     D3D11_BUFFER_DESC buffer_desc;
-    ID3D11Buffer *ib, *vb;
+
+    if (*buffer)
+        return S_OK;
+
+    buffer_desc.ByteWidth = size;
+    buffer_desc.Usage = D3D11_USAGE_IMMUTABLE;
+    buffer_desc.BindFlags = bind_flags;
+    buffer_desc.CPUAccessFlags = 0;
+    buffer_desc.MiscFlags = 0;
+
+    buffer_data.pSysMem = data;
+    buffer_data.SysMemPitch = 0;
+    buffer_data.SysMemSlicePitch = 0;
+
+    return ID3D11Device1_CreateBuffer(context->d3d_device, &buffer_desc, &buffer_data, buffer);
+}
+
+/* The buffers are kept with the geometry owning the tessellation, so that
+ * they're reused across draws and by transformed geometries. */
+static struct d2d_geometry_buffers *d2d_device_context_get_geometry_buffers(struct d2d_device_context *context,
+        const struct d2d_geometry *geometry)
+{
+    struct d2d_geometry_buffers *buffers = &geometry->tessellation->buffers;
+
+    if (buffers->device != context->d3d_device)
+    {
+        d2d_geometry_buffers_cleanup(buffers);
+        ID3D11Device1_AddRef(buffers->device = context->d3d_device);
+    }
+
+    return buffers;
+}
+
+static void d2d_device_context_draw_geometry(struct d2d_device_context *render_target,
+        const struct d2d_geometry *geometry, struct d2d_brush *brush, float stroke_width)
+{
+    struct d2d_geometry_buffers *buffers;
     HRESULT hr;
 
     if (FAILED(hr = d2d_device_context_update_vs_cb(render_target, &geometry->transform, stroke_width)))
@@ -841,105 +877,84 @@ static void d2d_device_context_draw_geometry(struct d2d_device_context *render_t
         return;
     }
 
-    buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-    buffer_desc.CPUAccessFlags = 0;
-    buffer_desc.MiscFlags = 0;
+    if (render_target->cs)
+        EnterCriticalSection(render_target->cs);
 
-    buffer_data.SysMemPitch = 0;
-    buffer_data.SysMemSlicePitch = 0;
+    buffers = d2d_device_context_get_geometry_buffers(render_target, geometry);
 
     if (geometry->outline.face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.face_count * sizeof(*geometry->outline.faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.faces,
+                geometry->outline.face_count * sizeof(*geometry->outline.faces))))
         {
             WARN("Failed to create index buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.vertex_count * sizeof(*geometry->outline.vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.vertices,
+                geometry->outline.vertex_count * sizeof(*geometry->outline.vertices))))
         {
             ERR("Failed to create vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
-            return;
+            goto done;
         }
 
-        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_OUTLINE, ib, 3 * geometry->outline.face_count, vb,
+        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_OUTLINE, buffers->outline_ib,
+                3 * geometry->outline.face_count, buffers->outline_vb,
                 sizeof(*geometry->outline.vertices), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->outline.bezier_face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.bezier_face_count * sizeof(*geometry->outline.bezier_faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.bezier_faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_bezier_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.bezier_faces,
+                geometry->outline.bezier_face_count * sizeof(*geometry->outline.bezier_faces))))
         {
             WARN("Failed to create curves index buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.bezier_count * sizeof(*geometry->outline.beziers);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.beziers;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_bezier_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.beziers,
+                geometry->outline.bezier_count * sizeof(*geometry->outline.beziers))))
         {
             ERR("Failed to create curves vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
-            return;
+            goto done;
         }
 
-        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_BEZIER_OUTLINE, ib,
-                3 * geometry->outline.bezier_face_count, vb,
+        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_BEZIER_OUTLINE, buffers->outline_bezier_ib,
+                3 * geometry->outline.bezier_face_count, buffers->outline_bezier_vb,
                 sizeof(*geometry->outline.beziers), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->outline.arc_face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.arc_face_count * sizeof(*geometry->outline.arc_faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.arc_faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_arc_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.arc_faces,
+                geometry->outline.arc_face_count * sizeof(*geometry->outline.arc_faces))))
         {
             WARN("Failed to create arcs index buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.arc_count * sizeof(*geometry->outline.arcs);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.arcs;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->outline_arc_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.arcs,
+                geometry->outline.arc_count * sizeof(*geometry->outline.arcs))))
         {
             ERR("Failed to create arcs vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
-            return;
+            goto done;
         }
 
         if (SUCCEEDED(d2d_device_context_update_ps_cb(render_target, brush, NULL, TRUE, TRUE)))
-            d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_ARC_OUTLINE, ib,
-                    3 * geometry->outline.arc_face_count, vb,
+            d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_ARC_OUTLINE, buffers->outline_arc_ib,
+                    3 * geometry->outline.arc_face_count, buffers->outline_arc_vb,
                     sizeof(*geometry->outline.arcs), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
+
+done:
+    if (render_target->cs)
+        LeaveCriticalSection(render_target->cs);
 }
 
 static void STDMETHODCALLTYPE d2d_device_context_DrawGeometry(ID2D1DeviceContext1 *iface,
@@ -975,18 +990,9 @@ static void STDMETHODCALLTYPE d2d_device_context_DrawGeometry(ID2D1DeviceContext
 static void d2d_device_context_fill_geometry(struct d2d_device_context *render_target,
         const struct d2d_geometry *geometry, struct d2d_brush *brush, struct d2d_brush *opacity_brush)
 {
-    D3D11_SUBRESOURCE_DATA buffer_data;
-    D3D11_BUFFER_DESC buffer_desc;
-    ID3D11Buffer *ib, *vb;
+    struct d2d_geometry_buffers *buffers;
     HRESULT hr;
 
-    buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-    buffer_desc.CPUAccessFlags = 0;
-    buffer_desc.MiscFlags = 0;
-
-    buffer_data.SysMemPitch = 0;
-    buffer_data.SysMemSlicePitch = 0;
-
     if (FAILED(hr = d2d_device_context_update_vs_cb(render_target, &geometry->transform, 0.0f)))
     {
         WARN("Failed to update vs constant buffer, hr %#lx.\n", hr);
@@ -999,72 +1005,66 @@ static void d2d_device_context_fill_geometry(struct d2d_device_context *render_t
         return;
     }
 
+    if (render_target->cs)
+        EnterCriticalSection(render_target->cs);
+
+    buffers = d2d_device_context_get_geometry_buffers(render_target, geometry);
+
     if (geometry->fill.face_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.face_count * sizeof(*geometry->fill.faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->fill_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->fill.faces,
+                geometry->fill.face_count * sizeof(*geometry->fill.faces))))
         {
             WARN("Failed to create index buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
-        buffer_desc.ByteWidth = geometry->fill.vertex_count * sizeof(*geometry->fill.vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->fill_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.vertices,
+                geometry->fill.vertex_count * sizeof(*geometry->fill.vertices))))
         {
             ERR("Failed to create vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
-            return;
+            goto done;
         }
 
-        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_TRIANGLE, ib, 3 * geometry->fill.face_count, vb,
+        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_TRIANGLE, buffers->fill_ib,
+                3 * geometry->fill.face_count, buffers->fill_vb,
                 sizeof(*geometry->fill.vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->fill.bezier_vertex_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.bezier_vertex_count * sizeof(*geometry->fill.bezier_vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.bezier_vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->fill_bezier_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.bezier_vertices,
+                geometry->fill.bezier_vertex_count * sizeof(*geometry->fill.bezier_vertices))))
         {
             ERR("Failed to create curves vertex buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
-        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.bezier_vertex_count, vb,
-                sizeof(*geometry->fill.bezier_vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
+        d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.bezier_vertex_count,
+                buffers->fill_bezier_vb, sizeof(*geometry->fill.bezier_vertices), brush, opacity_brush);
     }
 
     if (geometry->fill.arc_vertex_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.arc_vertex_count * sizeof(*geometry->fill.arc_vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.arc_vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (FAILED(hr = d2d_device_context_get_geometry_buffer(render_target, &buffers->fill_arc_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.arc_vertices,
+                geometry->fill.arc_vertex_count * sizeof(*geometry->fill.arc_vertices))))
         {
             ERR("Failed to create arc vertex buffer, hr %#lx.\n", hr);
-            return;
+            goto done;
         }
 
         if (SUCCEEDED(d2d_device_context_update_ps_cb(render_target, brush, opacity_brush, FALSE, TRUE)))
-            d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.arc_vertex_count, vb,
-                    sizeof(*geometry->fill.arc_vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
+            d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.arc_vertex_count,
+                    buffers->fill_arc_vb, sizeof(*geometry->fill.arc_vertices), brush, opacity_brush);
     }
+
+done:
+    if (render_target->cs)
+        LeaveCriticalSection(render_target->cs);
 }
 
 static void STDMETHODCALLTYPE d2d_device_context_FillGeometry(ID2D1DeviceContext1 *iface,
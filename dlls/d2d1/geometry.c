@@ -2704,8 +2704,32 @@ static BOOL d2d_geometry_fill_add_arc_triangle(struct d2d_geometry *geometry,
     return TRUE;
 }
 
+static void d2d_buffer_release(ID3D11Buffer *buffer)
+{
+    if (buffer)
+        ID3D11Buffer_Release(buffer);
+}
+
+void d2d_geometry_buffers_cleanup(struct d2d_geometry_buffers *buffers)
+{
+    d2d_buffer_release(buffers->fill_ib);
+    d2d_buffer_release(buffers->fill_vb);
+    d2d_buffer_release(buffers->fill_bezier_vb);
+    d2d_buffer_release(buffers->fill_arc_vb);
+    d2d_buffer_release(buffers->outline_ib);
+    d2d_buffer_release(buffers->outline_vb);
+    d2d_buffer_release(buffers->outline_bezier_ib);
+    d2d_buffer_release(buffers->outline_bezier_vb);
+    d2d_buffer_release(buffers->outline_arc_ib);
+    d2d_buffer_release(buffers->outline_arc_vb);
+    if (buffers->device)
+        ID3D11Device1_Release(buffers->device);
+    memset(buffers, 0, sizeof(*buffers));
+}
+
 static void d2d_geometry_cleanup(struct d2d_geometry *geometry)
 {
+    d2d_geometry_buffers_cleanup(&geometry->buffers);
     free(geometry->outline.arc_faces);
     free(geometry->outline.arcs);
     free(geometry->outline.bezier_faces);
@@ -2726,6 +2750,7 @@ static void d2d_geometry_init(struct d2d_geometry *geometry, ID2D1Factory *facto
     geometry->refcount = 1;
     ID2D1Factory_AddRef(geometry->factory = factory);
     geometry->transform = *transform;
+    geometry->tessellation = geometry;
 }
 
 static inline struct d2d_geometry *impl_from_ID2D1GeometrySink(ID2D1GeometrySink *iface)
@@ -2935,6 +2960,7 @@ static void STDMETHODCALLTYPE d2d_geometry_sink_EndFigure(ID2D1GeometrySink *ifa
         figure->flags |= D2D_FIGURE_FLAG_CLOSED;
     }
 
+    d2d_geometry_buffers_cleanup(&geometry->buffers);
     if (!d2d_geometry_add_figure_outline(geometry, figure, figure_end))
     {
         ERR("Failed to add figure outline.\n");
@@ -3223,6 +3249,7 @@ static HRESULT STDMETHODCALLTYPE d2d_geometry_sink_Close(ID2D1GeometrySink *ifac
         return D2DERR_WRONG_STATE;
     }
     geometry->u.path.state = D2D_GEOMETRY_STATE_CLOSED;
+    d2d_geometry_buffers_cleanup(&geometry->buffers);
 
     if (!d2d_geometry_intersect_self(geometry))
         goto done;
@@ -5225,6 +5252,7 @@ void d2d_transformed_geometry_init(struct d2d_geometry *geometry, ID2D1Factory *
     geometry->u.transformed.transform = *transform;
     geometry->fill = src_impl->fill;
     geometry->outline = src_impl->outline;
+    geometry->tessellation = src_impl->tessellation;
 }
 
 static inline struct d2d_geometry *impl_from_ID2D1GeometryGroup(ID2D1GeometryGroup *iface)
@@ -397,6 +397,271 @@ HRESULT WINAPI D3DAssemble(const void *data, SIZE_T datasize, const char *filena
     return hr;
 }
 
+/* Optional disk cache for compiled shaders, enabled by setting
+ * WINE_D3DCOMPILER_CACHE to its maximum size in MiB. Entries are named after
+ * a hash of the preprocessed source and of everything else that affects the
+ * output, and store the full key so that hash collisions are harmless. New
+ * entries are written to a temporary file and renamed into place, so that
+ * concurrent processes never see partial entries. */
+#define SHADER_CACHE_MAGIC 0x48435344 /* "DSCH" */
+
+struct shader_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t code_size;
+};
+
+struct shader_cache_file
+{
+    char name[MAX_PATH];
+    ULONGLONG size;
+    FILETIME time;
+};
+
+static CRITICAL_SECTION shader_cache_cs;
+static CRITICAL_SECTION_DEBUG shader_cache_cs_debug =
+{
+    0, 0, &shader_cache_cs,
+    { &shader_cache_cs_debug.ProcessLocksList,
+      &shader_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": shader_cache_cs") }
+};
+static CRITICAL_SECTION shader_cache_cs = { &shader_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static char shader_cache_dir[MAX_PATH];
+static ULONGLONG shader_cache_max_size, shader_cache_size;
+static BOOL shader_cache_initialised;
+
+static BOOL shader_cache_enabled(void)
+{
+    char buffer[16];
+    unsigned int len;
+
+    EnterCriticalSection(&shader_cache_cs);
+    if (!shader_cache_initialised)
+    {
+        shader_cache_initialised = TRUE;
+        if (GetEnvironmentVariableA("WINE_D3DCOMPILER_CACHE", buffer, sizeof(buffer))
+                && (shader_cache_max_size = (ULONGLONG)strtoul(buffer, NULL, 10) * 1024 * 1024)
+                && (len = GetEnvironmentVariableA("LOCALAPPDATA", shader_cache_dir, sizeof(shader_cache_dir)))
+                && len + strlen("\\wine\\d3dcompiler") < sizeof(shader_cache_dir))
+        {
+            strcat(shader_cache_dir, "\\wine");
+            CreateDirectoryA(shader_cache_dir, NULL);
+            strcat(shader_cache_dir, "\\d3dcompiler");
+            CreateDirectoryA(shader_cache_dir, NULL);
+            /* Make sure the size gets computed on the first store. */
+            shader_cache_size = ~(ULONGLONG)0;
+            TRACE("Caching up to %I64u MiB of shaders in %s.\n",
+                    shader_cache_max_size / (1024 * 1024), debugstr_a(shader_cache_dir));
+        }
+        else
+        {
+            shader_cache_max_size = 0;
+        }
+    }
+    LeaveCriticalSection(&shader_cache_cs);
+
+    return !!shader_cache_max_size;
+}
+
+static int __cdecl shader_cache_file_compare(const void *a, const void *b)
+{
+    const struct shader_cache_file *file_a = a, *file_b = b;
+
+    return CompareFileTime(&file_a->time, &file_b->time);
+}
+
+/* Remove the least recently used entries once the cache grows larger than
+ * its maximum size. Called with shader_cache_cs held. */
+static void shader_cache_evict(void)
+{
+    struct shader_cache_file *files = NULL, *new_files;
+    size_t count = 0, capacity = 0, i;
+    WIN32_FIND_DATAA data;
+    char path[MAX_PATH];
+    ULONGLONG size = 0;
+    HANDLE find;
+
+    snprintf(path, sizeof(path), "%s\\*.bin", shader_cache_dir);
+    if ((find = FindFirstFileA(path, &data)) == INVALID_HANDLE_VALUE)
+    {
+        shader_cache_size = 0;
+        return;
+    }
+
+    do
+    {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+        if (count == capacity)
+        {
+            capacity = max(capacity * 2, 64);
+            if (!(new_files = realloc(files, capacity * sizeof(*files))))
+                break;
+            files = new_files;
+        }
+        lstrcpynA(files[count].name, data.cFileName, sizeof(files[count].name));
+        files[count].size = ((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        files[count].time = data.ftLastWriteTime;
+        size += files[count++].size;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    if (size > shader_cache_max_size)
+    {
+        qsort(files, count, sizeof(*files), shader_cache_file_compare);
+        for (i = 0; i < count && size > shader_cache_max_size / 4 * 3; ++i)
+        {
+            snprintf(path, sizeof(path), "%s\\%s", shader_cache_dir, files[i].name);
+            if (DeleteFileA(path))
+                size -= files[i].size;
+        }
+        TRACE("Evicted %Iu cache entries.\n", i);
+    }
+
+    shader_cache_size = size;
+    free(files);
+}
+
+static void shader_cache_get_path(char *path, size_t size, const void *key, size_t key_size)
+{
+    const unsigned char *ptr = key;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    size_t i;
+
+    /* FNV-1a */
+    for (i = 0; i < key_size; ++i)
+        hash = (hash ^ ptr[i]) * 0x100000001b3ull;
+
+    snprintf(path, size, "%s\\%08x%08x.bin", shader_cache_dir, (uint32_t)(hash >> 32), (uint32_t)hash);
+}
+
+static BOOL shader_cache_load(const void *key, size_t key_size, ID3DBlob **blob)
+{
+    struct shader_cache_header header;
+    char path[MAX_PATH];
+    BOOL ret = FALSE;
+    FILETIME now;
+    void *buffer;
+    HANDLE file;
+    DWORD size;
+
+    shader_cache_get_path(path, sizeof(path), key, key_size);
+    if ((file = CreateFileA(path, GENERIC_READ | FILE_WRITE_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (ReadFile(file, &header, sizeof(header), &size, NULL) && size == sizeof(header)
+            && header.magic == SHADER_CACHE_MAGIC && header.version == D3D_COMPILER_VERSION
+            && header.key_size == key_size && (buffer = malloc(key_size)))
+    {
+        if (ReadFile(file, buffer, key_size, &size, NULL) && size == key_size && !memcmp(buffer, key, key_size)
+                && SUCCEEDED(D3DCreateBlob(header.code_size, blob)))
+        {
+            if (ReadFile(file, ID3D10Blob_GetBufferPointer(*blob), header.code_size, &size, NULL)
+                    && size == header.code_size)
+            {
+                /* Keep track of when entries were last used, for eviction. */
+                GetSystemTimeAsFileTime(&now);
+                SetFileTime(file, NULL, NULL, &now);
+                ret = TRUE;
+            }
+            else
+            {
+                ID3D10Blob_Release(*blob);
+                *blob = NULL;
+            }
+        }
+        free(buffer);
+    }
+    CloseHandle(file);
+
+    TRACE("%s %s.\n", debugstr_a(path), ret ? "found" : "not usable");
+    return ret;
+}
+
+static void shader_cache_store(const void *key, size_t key_size, const struct vkd3d_shader_code *code)
+{
+    struct shader_cache_header header;
+    char path[MAX_PATH], tmp[MAX_PATH];
+    DWORD size;
+    HANDLE file;
+    BOOL ret;
+
+    shader_cache_get_path(path, sizeof(path), key, key_size);
+    snprintf(tmp, sizeof(tmp), "%s.%lx.%lx.tmp", path, GetCurrentProcessId(), GetCurrentThreadId());
+    if ((file = CreateFileA(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create %s, error %lu.\n", debugstr_a(tmp), GetLastError());
+        return;
+    }
+
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = D3D_COMPILER_VERSION;
+    header.key_size = key_size;
+    header.code_size = code->size;
+    ret = WriteFile(file, &header, sizeof(header), &size, NULL)
+            && WriteFile(file, key, key_size, &size, NULL)
+            && WriteFile(file, code->code, code->size, &size, NULL);
+    CloseHandle(file);
+
+    if (!ret || !MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to write %s, error %lu.\n", debugstr_a(path), GetLastError());
+        DeleteFileA(tmp);
+        return;
+    }
+
+    EnterCriticalSection(&shader_cache_cs);
+    if (shader_cache_size != ~(ULONGLONG)0)
+        shader_cache_size += sizeof(header) + key_size + code->size;
+    if (shader_cache_size > shader_cache_max_size)
+        shader_cache_evict();
+    LeaveCriticalSection(&shader_cache_cs);
+}
+
+/* The key is the preprocessed source, followed by everything else that
+ * affects the compiled code. */
+static void *shader_cache_create_key(const struct vkd3d_shader_compile_info *compile_info,
+        const struct vkd3d_shader_hlsl_source_info *hlsl_info, UINT flags, size_t *key_size)
+{
+    const char *version = vkd3d_shader_get_version(NULL, NULL);
+    const char *source_name = compile_info->source_name ? compile_info->source_name : "";
+    const char *entry_point = hlsl_info->entry_point ? hlsl_info->entry_point : "";
+    struct vkd3d_shader_code preprocessed;
+    char *messages, *key, *ptr;
+    size_t size;
+    int ret;
+
+    ret = vkd3d_shader_preprocess(compile_info, &preprocessed, &messages);
+    vkd3d_shader_free_messages(messages);
+    if (ret)
+        return NULL;
+
+    size = preprocessed.size + strlen(version) + 1 + strlen(source_name) + 1 + strlen(entry_point) + 1
+            + strlen(hlsl_info->profile) + 1 + sizeof(flags) + hlsl_info->secondary_code.size;
+    if ((key = ptr = malloc(size)))
+    {
+        memcpy(ptr, preprocessed.code, preprocessed.size);
+        ptr += preprocessed.size;
+        ptr += sprintf(ptr, "%s", version) + 1;
+        ptr += sprintf(ptr, "%s", source_name) + 1;
+        ptr += sprintf(ptr, "%s", entry_point) + 1;
+        ptr += sprintf(ptr, "%s", hlsl_info->profile) + 1;
+        memcpy(ptr, &flags, sizeof(flags));
+        ptr += sizeof(flags);
+        if (hlsl_info->secondary_code.size)
+            memcpy(ptr, hlsl_info->secondary_code.code, hlsl_info->secondary_code.size);
+        *key_size = size;
+    }
+    vkd3d_shader_free_shader_code(&preprocessed);
+
+    return key;
+}
+
 HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filename,
         const D3D_SHADER_MACRO *macros, ID3DInclude *include, const char *entry_point,
         const char *profile, UINT flags, UINT effect_flags, UINT secondary_flags,
@@ -411,7 +676,8 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
     struct vkd3d_shader_compile_option *option;
     struct vkd3d_shader_code byte_code;
     const D3D_SHADER_MACRO *macro;
-    size_t profile_len, i;
+    size_t profile_len, i, cache_key_size;
+    void *cache_key = NULL;
     char *messages;
     HRESULT hr;
     int ret;
@@ -532,10 +798,23 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
         option->value = VKD3D_SHADER_COMPILE_OPTION_PACK_MATRIX_COLUMN_MAJOR;
     }
 
+    if (shader_blob && shader_cache_enabled()
+            && (cache_key = shader_cache_create_key(&compile_info, &hlsl_info, flags, &cache_key_size)))
+    {
+        if (shader_cache_load(cache_key, cache_key_size, shader_blob))
+        {
+            free(cache_key);
+            return S_OK;
+        }
+    }
+
     ret = vkd3d_shader_compile(&compile_info, &byte_code, &messages);
 
     if (ret)
         ERR("Failed to compile shader, vkd3d result %d.\n", ret);
+    else if (cache_key)
+        shader_cache_store(cache_key, cache_key_size, &byte_code);
+    free(cache_key);
 
     if (messages)
     {
@@ -1616,6 +1616,311 @@ void copy_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch,
     }
 }
 
+/* Runs a row job on the calling thread and, for large jobs, on the thread pool,
+ * handing out chunks of rows until all of them have been processed. */
+struct d3dx_row_job
+{
+    void (*callback)(void *context, unsigned int start, unsigned int end);
+    void *context;
+    unsigned int count;
+    unsigned int chunk;
+    LONG next;
+};
+
+static void d3dx_row_job_run(struct d3dx_row_job *job)
+{
+    unsigned int start;
+
+    while ((start = (InterlockedIncrement(&job->next) - 1) * job->chunk) < job->count)
+        job->callback(job->context, start, min(start + job->chunk, job->count));
+}
+
+static void CALLBACK d3dx_row_job_callback(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+    d3dx_row_job_run(context);
+}
+
+#define D3DX_ROW_JOB_MAX_THREADS 8
+#define D3DX_ROW_JOB_MIN_PIXELS (256 * 256)
+
+static void d3dx_run_row_job(void (*callback)(void *context, unsigned int start, unsigned int end),
+        void *context, unsigned int count, unsigned int chunk, unsigned int pixel_count)
+{
+    struct d3dx_row_job job = {callback, context, count, chunk};
+    unsigned int chunk_count = (count + chunk - 1) / chunk;
+    unsigned int thread_count = 1, i;
+    TP_WORK *work = NULL;
+
+    if (pixel_count >= D3DX_ROW_JOB_MIN_PIXELS && chunk_count > 1)
+    {
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+        thread_count = min(min(info.dwNumberOfProcessors, D3DX_ROW_JOB_MAX_THREADS), chunk_count);
+        if (thread_count > 1 && !(work = CreateThreadpoolWork(d3dx_row_job_callback, &job, NULL)))
+            thread_count = 1;
+    }
+
+    TRACE("Processing %u rows on %u threads.\n", count, thread_count);
+
+    for (i = 1; i < thread_count; ++i)
+        SubmitThreadpoolWork(work);
+    d3dx_row_job_run(&job);
+    if (work)
+    {
+        WaitForThreadpoolWorkCallbacks(work, FALSE);
+        CloseThreadpoolWork(work);
+    }
+}
+
+/* Fast paths for the most common conversions. They must produce exactly the
+ * same results as the generic code in convert_argb_rows(). */
+typedef void (*argb_row_func)(const BYTE *src, BYTE *dst, unsigned int width);
+
+static void convert_row_a8r8g8b8_x8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const DWORD *s = (const DWORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x)
+        d[x] = s[x] & 0x00ffffff;
+}
+
+static void convert_row_x8r8g8b8_a8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const DWORD *s = (const DWORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x)
+        d[x] = s[x] | 0xff000000;
+}
+
+static inline DWORD r5g6b5_to_x8r8g8b8(WORD c)
+{
+    DWORD r = (c >> 11) & 0x1f, g = (c >> 5) & 0x3f, b = c & 0x1f;
+
+    return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+}
+
+static void convert_row_r5g6b5_a8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const WORD *s = (const WORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x)
+        d[x] = r5g6b5_to_x8r8g8b8(s[x]) | 0xff000000;
+}
+
+static void convert_row_r5g6b5_x8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const WORD *s = (const WORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x)
+        d[x] = r5g6b5_to_x8r8g8b8(s[x]);
+}
+
+static void convert_row_x8r8g8b8_r5g6b5(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const DWORD *s = (const DWORD *)src;
+    WORD *d = (WORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x)
+        d[x] = ((s[x] >> 8) & 0xf800) | ((s[x] >> 5) & 0x07e0) | ((s[x] >> 3) & 0x001f);
+}
+
+static inline DWORD float_to_unorm8(float f)
+{
+    return (DWORD)(f * 255 + 0.5f) & 0xff;
+}
+
+static void convert_row_a16b16g16r16f_a8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const WORD *s = (const WORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x, s += 4)
+        d[x] = float_to_unorm8(float_16_to_32(s[3])) << 24 | float_to_unorm8(float_16_to_32(s[0])) << 16
+                | float_to_unorm8(float_16_to_32(s[1])) << 8 | float_to_unorm8(float_16_to_32(s[2]));
+}
+
+static void convert_row_a16b16g16r16f_x8r8g8b8(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const WORD *s = (const WORD *)src;
+    DWORD *d = (DWORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x, s += 4)
+        d[x] = float_to_unorm8(float_16_to_32(s[0])) << 16 | float_to_unorm8(float_16_to_32(s[1])) << 8
+                | float_to_unorm8(float_16_to_32(s[2]));
+}
+
+static void convert_row_a8r8g8b8_a16b16g16r16f(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const DWORD *s = (const DWORD *)src;
+    WORD *d = (WORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x, d += 4)
+    {
+        d[0] = float_32_to_16((float)((s[x] >> 16) & 0xff) / 0xff);
+        d[1] = float_32_to_16((float)((s[x] >> 8) & 0xff) / 0xff);
+        d[2] = float_32_to_16((float)(s[x] & 0xff) / 0xff);
+        d[3] = float_32_to_16((float)(s[x] >> 24) / 0xff);
+    }
+}
+
+static void convert_row_x8r8g8b8_a16b16g16r16f(const BYTE *src, BYTE *dst, unsigned int width)
+{
+    const DWORD *s = (const DWORD *)src;
+    WORD one = float_32_to_16(1.0f);
+    WORD *d = (WORD *)dst;
+    unsigned int x;
+
+    for (x = 0; x < width; ++x, d += 4)
+    {
+        d[0] = float_32_to_16((float)((s[x] >> 16) & 0xff) / 0xff);
+        d[1] = float_32_to_16((float)((s[x] >> 8) & 0xff) / 0xff);
+        d[2] = float_32_to_16((float)(s[x] & 0xff) / 0xff);
+        d[3] = one;
+    }
+}
+
+static argb_row_func get_argb_row_func(D3DFORMAT src_format, D3DFORMAT dst_format)
+{
+    static const struct
+    {
+        D3DFORMAT src_format;
+        D3DFORMAT dst_format;
+        argb_row_func func;
+    }
+    row_funcs[] =
+    {
+        {D3DFMT_A8R8G8B8,      D3DFMT_X8R8G8B8,      convert_row_a8r8g8b8_x8r8g8b8},
+        {D3DFMT_X8R8G8B8,      D3DFMT_A8R8G8B8,      convert_row_x8r8g8b8_a8r8g8b8},
+        {D3DFMT_R5G6B5,        D3DFMT_A8R8G8B8,      convert_row_r5g6b5_a8r8g8b8},
+        {D3DFMT_R5G6B5,        D3DFMT_X8R8G8B8,      convert_row_r5g6b5_x8r8g8b8},
+        {D3DFMT_A8R8G8B8,      D3DFMT_R5G6B5,        convert_row_x8r8g8b8_r5g6b5},
+        {D3DFMT_X8R8G8B8,      D3DFMT_R5G6B5,        convert_row_x8r8g8b8_r5g6b5},
+        {D3DFMT_A16B16G16R16F, D3DFMT_A8R8G8B8,      convert_row_a16b16g16r16f_a8r8g8b8},
+        {D3DFMT_A16B16G16R16F, D3DFMT_X8R8G8B8,      convert_row_a16b16g16r16f_x8r8g8b8},
+        {D3DFMT_A8R8G8B8,      D3DFMT_A16B16G16R16F, convert_row_a8r8g8b8_a16b16g16r16f},
+        {D3DFMT_X8R8G8B8,      D3DFMT_A16B16G16R16F, convert_row_x8r8g8b8_a16b16g16r16f},
+    };
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(row_funcs); ++i)
+    {
+        if (row_funcs[i].src_format == src_format && row_funcs[i].dst_format == dst_format)
+            return row_funcs[i].func;
+    }
+    return NULL;
+}
+
+struct argb_conversion
+{
+    const BYTE *src;
+    UINT src_row_pitch, src_slice_pitch;
+    const struct volume *src_size;
+    const struct pixel_format_desc *src_format;
+    BYTE *dst;
+    UINT dst_row_pitch, dst_slice_pitch;
+    const struct volume *dst_size;
+    const struct pixel_format_desc *dst_format;
+    D3DCOLOR color_key;
+    const PALETTEENTRY *palette;
+    UINT width, height;
+    struct argb_conversion_info conv_info, ck_conv_info;
+    const struct pixel_format_desc *ck_format;
+    argb_row_func row_func;
+};
+
+static void convert_argb_rows(void *context, unsigned int start, unsigned int end)
+{
+    const struct argb_conversion *conv = context;
+    const struct pixel_format_desc *src_format = conv->src_format;
+    const struct pixel_format_desc *dst_format = conv->dst_format;
+    DWORD channels[4] = {0};
+    unsigned int row, x, y, z;
+
+    for (row = start; row < end; ++row)
+    {
+        const BYTE *src_ptr;
+        BYTE *dst_ptr;
+
+        z = row / conv->height;
+        y = row % conv->height;
+        src_ptr = conv->src + z * conv->src_slice_pitch + y * conv->src_row_pitch;
+        dst_ptr = conv->dst + z * conv->dst_slice_pitch + y * conv->dst_row_pitch;
+
+        if (conv->row_func)
+        {
+            conv->row_func(src_ptr, dst_ptr, conv->width);
+            dst_ptr += conv->width * dst_format->bytes_per_pixel;
+        }
+        else for (x = 0; x < conv->width; x++) {
+            if (!src_format->to_rgba && !dst_format->from_rgba
+                    && src_format->type == dst_format->type
+                    && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
+            {
+                DWORD val;
+
+                get_relevant_argb_components(&conv->conv_info, src_ptr, channels);
+                val = make_argb_color(&conv->conv_info, channels);
+
+                if (conv->color_key)
+                {
+                    DWORD ck_pixel;
+
+                    get_relevant_argb_components(&conv->ck_conv_info, src_ptr, channels);
+                    ck_pixel = make_argb_color(&conv->ck_conv_info, channels);
+                    if (ck_pixel == conv->color_key)
+                        val &= ~conv->conv_info.destmask[0];
+                }
+                memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
+            }
+            else
+            {
+                struct vec4 color, tmp;
+
+                format_to_vec4(src_format, src_ptr, &color);
+                if (src_format->to_rgba)
+                    src_format->to_rgba(&color, &tmp, conv->palette);
+                else
+                    tmp = color;
+
+                if (conv->ck_format)
+                {
+                    DWORD ck_pixel;
+
+                    format_from_vec4(conv->ck_format, &tmp, (BYTE *)&ck_pixel);
+                    if (ck_pixel == conv->color_key)
+                        tmp.w = 0.0f;
+                }
+
+                if (dst_format->from_rgba)
+                    dst_format->from_rgba(&tmp, &color);
+                else
+                    color = tmp;
+
+                format_from_vec4(dst_format, &color, dst_ptr);
+            }
+
+            src_ptr += src_format->bytes_per_pixel;
+            dst_ptr += dst_format->bytes_per_pixel;
+        }
+
+        if (conv->src_size->width < conv->dst_size->width) /* black out remaining pixels */
+            memset(dst_ptr, 0, dst_format->bytes_per_pixel * (conv->dst_size->width - conv->src_size->width));
+    }
+}
+
 /************************************************************
  * convert_argb_pixels
  *
@@ -1628,98 +1933,47 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
         const struct volume *dst_size, const struct pixel_format_desc *dst_format, D3DCOLOR color_key,
         const PALETTEENTRY *palette)
 {
-    struct argb_conversion_info conv_info, ck_conv_info;
-    const struct pixel_format_desc *ck_format = NULL;
-    DWORD channels[4];
-    UINT min_width, min_height, min_depth;
-    UINT x, y, z;
+    struct argb_conversion conv;
+    UINT min_depth;
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
             "dst_row_pitch %u, dst_slice_pitch %u, dst_size %p, dst_format %p, color_key 0x%08lx, palette %p.\n",
             src, src_row_pitch, src_slice_pitch, src_size, src_format, dst, dst_row_pitch, dst_slice_pitch, dst_size,
             dst_format, color_key, palette);
 
-    ZeroMemory(channels, sizeof(channels));
-    init_argb_conversion_info(src_format, dst_format, &conv_info);
-
-    min_width = min(src_size->width, dst_size->width);
-    min_height = min(src_size->height, dst_size->height);
+    conv.src = src;
+    conv.src_row_pitch = src_row_pitch;
+    conv.src_slice_pitch = src_slice_pitch;
+    conv.src_size = src_size;
+    conv.src_format = src_format;
+    conv.dst = dst;
+    conv.dst_row_pitch = dst_row_pitch;
+    conv.dst_slice_pitch = dst_slice_pitch;
+    conv.dst_size = dst_size;
+    conv.dst_format = dst_format;
+    conv.color_key = color_key;
+    conv.palette = palette;
+    conv.ck_format = NULL;
+    conv.row_func = color_key ? NULL : get_argb_row_func(src_format->format, dst_format->format);
+    init_argb_conversion_info(src_format, dst_format, &conv.conv_info);
+
+    conv.width = min(src_size->width, dst_size->width);
+    conv.height = min(src_size->height, dst_size->height);
     min_depth = min(src_size->depth, dst_size->depth);
 
     if (color_key)
     {
         /* Color keys are always represented in D3DFMT_A8R8G8B8 format. */
-        ck_format = get_format_info(D3DFMT_A8R8G8B8);
-        init_argb_conversion_info(src_format, ck_format, &ck_conv_info);
+        conv.ck_format = get_format_info(D3DFMT_A8R8G8B8);
+        init_argb_conversion_info(src_format, conv.ck_format, &conv.ck_conv_info);
     }
 
-    for (z = 0; z < min_depth; z++) {
-        const BYTE *src_slice_ptr = src + z * src_slice_pitch;
-        BYTE *dst_slice_ptr = dst + z * dst_slice_pitch;
-
-        for (y = 0; y < min_height; y++) {
-            const BYTE *src_ptr = src_slice_ptr + y * src_row_pitch;
-            BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
-
-            for (x = 0; x < min_width; x++) {
-                if (!src_format->to_rgba && !dst_format->from_rgba
-                        && src_format->type == dst_format->type
-                        && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
-                {
-                    DWORD val;
-
-                    get_relevant_argb_components(&conv_info, src_ptr, channels);
-                    val = make_argb_color(&conv_info, channels);
-
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
+    if (conv.width && conv.height)
+        d3dx_run_row_job(convert_argb_rows, &conv, min_depth * conv.height, 16,
+                min_depth * conv.height * conv.width);
 
-                        get_relevant_argb_components(&ck_conv_info, src_ptr, channels);
-                        ck_pixel = make_argb_color(&ck_conv_info, channels);
-                        if (ck_pixel == color_key)
-                            val &= ~conv_info.destmask[0];
-                    }
-                    memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
-                }
-                else
-                {
-                    struct vec4 color, tmp;
-
-                    format_to_vec4(src_format, src_ptr, &color);
-                    if (src_format->to_rgba)
-                        src_format->to_rgba(&color, &tmp, palette);
-                    else
-                        tmp = color;
-
-                    if (ck_format)
-                    {
-                        DWORD ck_pixel;
-
-                        format_from_vec4(ck_format, &tmp, (BYTE *)&ck_pixel);
-                        if (ck_pixel == color_key)
-                            tmp.w = 0.0f;
-                    }
-
-                    if (dst_format->from_rgba)
-                        dst_format->from_rgba(&tmp, &color);
-                    else
-                        color = tmp;
-
-                    format_from_vec4(dst_format, &color, dst_ptr);
-                }
-
-                src_ptr += src_format->bytes_per_pixel;
-                dst_ptr += dst_format->bytes_per_pixel;
-            }
-
-            if (src_size->width < dst_size->width) /* black out remaining pixels */
-                memset(dst_ptr, 0, dst_format->bytes_per_pixel * (dst_size->width - src_size->width));
-        }
-
-        if (src_size->height < dst_size->height) /* black out remaining pixels */
-            memset(dst + src_size->height * dst_row_pitch, 0, dst_row_pitch * (dst_size->height - src_size->height));
-    }
+    if (min_depth && src_size->height < dst_size->height) /* black out remaining pixels */
+        memset(dst + src_size->height * dst_row_pitch, 0, dst_row_pitch * (dst_size->height - src_size->height));
     if (src_size->depth < dst_size->depth) /* black out remaining pixels */
         memset(dst + src_size->depth * dst_slice_pitch, 0, dst_slice_pitch * (dst_size->depth - src_size->depth));
 }
@@ -1909,6 +2163,35 @@ exit:
     return S_OK;
 }
 
+struct dxtn_compression
+{
+    const BYTE *src;
+    uint32_t src_slice_pitch;
+    BYTE *dst;
+    uint32_t dst_row_pitch;
+    uint32_t dst_slice_pitch;
+    uint32_t width, height, block_rows;
+    GLenum gl_format;
+};
+
+/* Each row of 4x4 blocks is compressed independently, rows can be spread over several threads. */
+static void compress_dxtn_rows(void *context, unsigned int start, unsigned int end)
+{
+    const struct dxtn_compression *compression = context;
+    unsigned int row, y, z;
+
+    for (row = start; row < end; ++row)
+    {
+        z = row / compression->block_rows;
+        y = (row % compression->block_rows) * 4;
+
+        tx_compress_dxtn(4, compression->width, min(compression->height - y, 4),
+                compression->src + z * compression->src_slice_pitch + y * compression->width * 4,
+                compression->gl_format, compression->dst + z * compression->dst_slice_pitch
+                + (y / 4) * compression->dst_row_pitch, compression->dst_row_pitch);
+    }
+}
+
 HRESULT d3dx_pixels_init(const void *data, uint32_t row_pitch, uint32_t slice_pitch,
         const PALETTEENTRY *palette, D3DFORMAT format, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom,
         uint32_t front, uint32_t back, struct d3dx_pixels *pixels)
@@ -2055,8 +2338,8 @@ HRESULT d3dx_load_pixels_from_pixels(struct d3dx_pixels *dst_pixels,
                 color_key);
         if (SUCCEEDED(hr))
         {
+            struct dxtn_compression compression;
             GLenum gl_format = 0;
-            uint32_t i;
 
             TRACE("Compressing DXTn surface.\n");
             switch (dst_desc->format)
@@ -2076,14 +2359,18 @@ HRESULT d3dx_load_pixels_from_pixels(struct d3dx_pixels *dst_pixels,
                     ERR("Unexpected destination compressed format %u.\n", dst_desc->format);
             }
 
-            for (i = 0; i < dst_size_aligned.depth; ++i)
-            {
-                BYTE *uncompressed_mem_slice = (BYTE *)uncompressed_mem + (i * uncompressed_slice_pitch);
-                BYTE *dst_memory_slice = ((BYTE *)dst_pixels->data) + (i * dst_pixels->slice_pitch);
-
-                tx_compress_dxtn(4, dst_size_aligned.width, dst_size_aligned.height, uncompressed_mem_slice, gl_format,
-                        dst_memory_slice, dst_pixels->row_pitch);
-            }
+            compression.src = uncompressed_mem;
+            compression.src_slice_pitch = uncompressed_slice_pitch;
+            compression.dst = dst_pixels->data;
+            compression.dst_row_pitch = dst_pixels->row_pitch;
+            compression.dst_slice_pitch = dst_pixels->slice_pitch;
+            compression.width = dst_size_aligned.width;
+            compression.height = dst_size_aligned.height;
+            compression.block_rows = (dst_size_aligned.height + 3) / 4;
+            compression.gl_format = gl_format;
+            if (compression.width && compression.block_rows)
+                d3dx_run_row_job(compress_dxtn_rows, &compression, dst_size_aligned.depth * compression.block_rows,
+                        4, dst_size_aligned.depth * dst_size_aligned.height * dst_size_aligned.width);
         }
         free(uncompressed_mem);
         goto exit;
@@ -2850,15 +2850,18 @@ unsigned dwarf2_cache_cuhead(struct dwarf2_module_info_s* module, struct symt_co
 
 static dwarf2_parse_context_t* dwarf2_locate_cu(dwarf2_parse_module_context_t* module_ctx, ULONG_PTR ref)
 {
-    unsigned i;
+    unsigned low = 0, high = module_ctx->unit_contexts.num_elts, mid;
     dwarf2_parse_context_t* ctx;
-    const BYTE* where;
-    for (i = 0; i < module_ctx->unit_contexts.num_elts; ++i)
+    const BYTE* where = module_ctx->sections[section_debug].address + ref;
+
+    /* unit contexts are stored in the order of their headers in .debug_info */
+    while (low < high)
     {
-        ctx = vector_at(&module_ctx->unit_contexts, i);
-        where = module_ctx->sections[ctx->section].address + ref;
-        if (where >= ctx->traverse_DIE.data && where < ctx->traverse_DIE.end_data)
-            return ctx;
+        mid = low + (high - low) / 2;
+        ctx = vector_at(&module_ctx->unit_contexts, mid);
+        if (where < ctx->traverse_DIE.data) high = mid;
+        else if (where >= ctx->traverse_DIE.end_data) low = mid + 1;
+        else return ctx;
     }
     FIXME("Couldn't find ref 0x%Ix inside sect\n", ref);
     return NULL;
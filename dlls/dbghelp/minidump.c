@@ -30,6 +30,8 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(dbghelp);
 
+#define DUMP_BUFFER_SIZE    (1024 * 1024)
+
 /******************************************************************
  *		fetch_process_info
  *
@@ -793,6 +795,38 @@ static  unsigned        dump_threads(struct dump_context* dc,
     return sz;
 }
 
+/******************************************************************
+ *		dump_memory_range
+ *
+ * Copies a memory range of the target process at the current position
+ * of the minidump file.
+ * Reading a remote process is a server round trip, so this is done in
+ * big chunks. The pages which can't be read are zero-filled to keep
+ * the following data at the expected place.
+ */
+static void dump_memory_range(struct dump_context* dc, ULONG64 base, ULONG64 size,
+                              char* buffer, unsigned buffer_size)
+{
+    DWORD       written;
+    ULONG64     pos;
+    unsigned    len, done, chunk;
+
+    for (pos = 0; pos < size; pos += len)
+    {
+        len = min(size - pos, buffer_size);
+        if (!read_process_memory(dc->process, base + pos, buffer, len))
+        {
+            for (done = 0; done < len; done += chunk)
+            {
+                chunk = min(len - done, 0x1000 - ((base + pos + done) & 0xfff));
+                if (!read_process_memory(dc->process, base + pos + done, buffer + done, chunk))
+                    memset(buffer + done, 0, chunk);
+            }
+        }
+        WriteFile(dc->hFile, buffer, len, &written, NULL);
+    }
+}
+
 /******************************************************************
  *		dump_memory_info
  *
@@ -802,10 +836,9 @@ static unsigned         dump_memory_info(struct dump_context* dc)
 {
     MINIDUMP_MEMORY_LIST        mdMemList;
     MINIDUMP_MEMORY_DESCRIPTOR  mdMem;
-    DWORD                       written;
-    unsigned                    i, pos, len, sz;
+    unsigned                    i, sz, buffer_size = DUMP_BUFFER_SIZE;
     RVA                         rva_base;
-    char                        tmp[1024];
+    char                        tmp[1024], *buffer;
 
     mdMemList.NumberOfMemoryRanges = dc->num_mem;
     append(dc, &mdMemList.NumberOfMemoryRanges,
@@ -815,18 +848,19 @@ static unsigned         dump_memory_info(struct dump_context* dc)
     dc->rva += sz;
     sz += sizeof(mdMemList.NumberOfMemoryRanges);
 
+    if (!(buffer = HeapAlloc(GetProcessHeap(), 0, buffer_size)))
+    {
+        buffer = tmp;
+        buffer_size = sizeof(tmp);
+    }
+
     for (i = 0; i < dc->num_mem; i++)
     {
         mdMem.StartOfMemoryRange = dc->mem[i].base;
         mdMem.Memory.Rva = dc->rva;
         mdMem.Memory.DataSize = dc->mem[i].size;
         SetFilePointer(dc->hFile, dc->rva, NULL, FILE_BEGIN);
-        for (pos = 0; pos < dc->mem[i].size; pos += sizeof(tmp))
-        {
-            len = min(dc->mem[i].size - pos, sizeof(tmp));
-            if (read_process_memory(dc->process, dc->mem[i].base + pos, tmp, len))
-                WriteFile(dc->hFile, tmp, len, &written, NULL);
-        }
+        dump_memory_range(dc, dc->mem[i].base, dc->mem[i].size, buffer, buffer_size);
         dc->rva += mdMem.Memory.DataSize;
         writeat(dc, rva_base + i * sizeof(mdMem), &mdMem, sizeof(mdMem));
         if (dc->mem[i].rva)
@@ -835,6 +869,7 @@ static unsigned         dump_memory_info(struct dump_context* dc)
         }
     }
 
+    if (buffer != tmp) HeapFree(GetProcessHeap(), 0, buffer);
     return sz;
 }
 
@@ -847,11 +882,9 @@ static unsigned         dump_memory64_info(struct dump_context* dc)
 {
     MINIDUMP_MEMORY64_LIST          mdMem64List;
     MINIDUMP_MEMORY_DESCRIPTOR64    mdMem64;
-    DWORD                           written;
-    unsigned                        i, len, sz;
+    unsigned                        i, sz, buffer_size = DUMP_BUFFER_SIZE;
     RVA                             rva_base;
-    char                            tmp[1024];
-    ULONG64                         pos;
+    char                            tmp[1024], *buffer;
     LARGE_INTEGER                   filepos;
 
     sz = sizeof(mdMem64List.NumberOfMemoryRanges) +
@@ -871,22 +904,24 @@ static unsigned         dump_memory64_info(struct dump_context* dc)
 
     /* dc->rva is not updated past this point. The end of the dump
      * is just the full memory data. */
+    if (!(buffer = HeapAlloc(GetProcessHeap(), 0, buffer_size)))
+    {
+        buffer = tmp;
+        buffer_size = sizeof(tmp);
+    }
+
     filepos.QuadPart = dc->rva;
     for (i = 0; i < dc->num_mem64; i++)
     {
         mdMem64.StartOfMemoryRange = dc->mem64[i].base;
         mdMem64.DataSize = dc->mem64[i].size;
         SetFilePointerEx(dc->hFile, filepos, NULL, FILE_BEGIN);
-        for (pos = 0; pos < dc->mem64[i].size; pos += sizeof(tmp))
-        {
-            len = min(dc->mem64[i].size - pos, sizeof(tmp));
-            if (read_process_memory(dc->process, dc->mem64[i].base + pos, tmp, len))
-                WriteFile(dc->hFile, tmp, len, &written, NULL);
-        }
+        dump_memory_range(dc, dc->mem64[i].base, dc->mem64[i].size, buffer, buffer_size);
         filepos.QuadPart += mdMem64.DataSize;
         writeat(dc, rva_base + i * sizeof(mdMem64), &mdMem64, sizeof(mdMem64));
     }
 
+    if (buffer != tmp) HeapFree(GetProcessHeap(), 0, buffer);
     return sz;
 }
 
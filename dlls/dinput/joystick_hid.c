@@ -172,6 +172,17 @@ struct pid_effect_state
     struct hid_value_caps *actuator_override_switch_caps;
 };
 
+/* input object of the device state report, collected once to avoid enumerating
+ * every object again for each input report */
+struct hid_input_object
+{
+    UINT index;
+    DWORD type;
+    DWORD ofs;
+    USAGE usage_page;
+    USAGE usage;
+};
+
 struct hid_joystick
 {
     struct dinput_device base;
@@ -190,6 +201,8 @@ struct hid_joystick
     char *feature_report_buf;
     USAGE_AND_PAGE *usages_buf;
     UINT usages_count;
+    struct hid_input_object *input_objects;
+    UINT input_objects_count;
 
     BYTE effect_inuse[255];
     struct list effect_list;
@@ -819,6 +832,7 @@ static void hid_joystick_destroy( IDirectInputDevice8W *iface )
     struct hid_joystick *impl = impl_from_IDirectInputDevice8W( iface );
     TRACE( "iface %p.\n", iface );
 
+    free( impl->input_objects );
     free( impl->usages_buf );
     free( impl->feature_report_buf );
     free( impl->output_report_buf );
@@ -1144,23 +1158,18 @@ struct parse_device_state_params
     DWORD seq;
 };
 
-static BOOL check_device_state_button( struct dinput_device *device, UINT index, struct hid_value_caps *caps,
-                                       const DIDEVICEOBJECTINSTANCEW *instance, void *data )
+static void read_device_state_button( struct hid_joystick *impl, const struct hid_input_object *object,
+                                      struct parse_device_state_params *params )
 {
-    IDirectInputDevice8W *iface = &device->IDirectInputDevice8W_iface;
-    struct parse_device_state_params *params = data;
+    IDirectInputDevice8W *iface = &impl->base.IDirectInputDevice8W_iface;
     BYTE old_value, value;
 
-    if (instance->wReportId != device->device_state_report_id) return DIENUM_CONTINUE;
-
-    value = params->buttons[instance->wUsage - 1];
-    old_value = params->old_state[instance->dwOfs];
+    value = params->buttons[object->usage - 1];
+    old_value = params->old_state[object->ofs];
     if (params->reset_state) value = 0;
 
-    device->device_state[instance->dwOfs] = value;
-    if (old_value != value) queue_event( iface, index, value, params->time, params->seq );
-
-    return DIENUM_CONTINUE;
+    impl->base.device_state[object->ofs] = value;
+    if (old_value != value) queue_event( iface, object->index, value, params->time, params->seq );
 }
 
 static LONG sign_extend( ULONG value, struct object_properties *properties )
@@ -1218,59 +1227,45 @@ static LONG scale_axis_value( ULONG value, struct object_properties *properties
     return phy_min + MulDiv( tmp - log_min, phy_max - phy_min, log_max - log_min );
 }
 
-static BOOL read_device_state_value( struct dinput_device *device, UINT index, struct hid_value_caps *caps,
-                                     const DIDEVICEOBJECTINSTANCEW *instance, void *data )
+static void read_device_state_value( struct hid_joystick *impl, const struct hid_input_object *object,
+                                     struct parse_device_state_params *params )
 {
-    struct hid_joystick *impl = CONTAINING_RECORD( device, struct hid_joystick, base );
     IDirectInputDevice8W *iface = &impl->base.IDirectInputDevice8W_iface;
     ULONG logical_value, report_len = impl->caps.InputReportByteLength;
-    struct parse_device_state_params *params = data;
+    struct object_properties *properties = impl->base.object_properties + object->index;
     char *report_buf = impl->input_report_buf;
-    struct object_properties *properties;
     LONG old_value, value;
     NTSTATUS status;
 
-    if (index == -1) return DIENUM_STOP;
-    properties = device->object_properties + index;
-
-    if (instance->wReportId != impl->base.device_state_report_id) return DIENUM_CONTINUE;
-
-    status = HidP_GetUsageValue( HidP_Input, instance->wUsagePage, 0, instance->wUsage,
+    status = HidP_GetUsageValue( HidP_Input, object->usage_page, 0, object->usage,
                                  &logical_value, impl->preparsed, report_buf, report_len );
     if (status != HIDP_STATUS_SUCCESS) WARN( "HidP_GetUsageValue %04x:%04x returned %#lx\n",
-                                             instance->wUsagePage, instance->wUsage, status );
-    if (instance->dwType & DIDFT_AXIS) value = scale_axis_value( logical_value, properties );
+                                             object->usage_page, object->usage, status );
+    if (object->type & DIDFT_AXIS) value = scale_axis_value( logical_value, properties );
     else value = scale_value( logical_value, properties );
 
     if (params->reset_state)
     {
-        if (instance->dwType & DIDFT_POV) value = -1;
-        else if (instance->dwType & DIDFT_AXIS)
+        if (object->type & DIDFT_POV) value = -1;
+        else if (object->type & DIDFT_AXIS)
         {
             if (!properties->range_min) value = properties->range_max / 2;
             else value = round( (properties->range_min + properties->range_max) / 2.0 );
         }
     }
 
-    old_value = *(LONG *)(params->old_state + instance->dwOfs);
-    *(LONG *)(impl->base.device_state + instance->dwOfs) = value;
-    if (old_value != value) queue_event( iface, index, value, params->time, params->seq );
-
-    return DIENUM_CONTINUE;
+    old_value = *(LONG *)(params->old_state + object->ofs);
+    *(LONG *)(impl->base.device_state + object->ofs) = value;
+    if (old_value != value) queue_event( iface, object->index, value, params->time, params->seq );
 }
 
 static HRESULT hid_joystick_read( IDirectInputDevice8W *iface )
 {
-    static const DIPROPHEADER filter =
-    {
-        .dwSize = sizeof(filter),
-        .dwHeaderSize = sizeof(filter),
-        .dwHow = DIPH_DEVICE,
-    };
     struct hid_joystick *impl = impl_from_IDirectInputDevice8W( iface );
     ULONG i, index, count, report_len = impl->caps.InputReportByteLength;
     DIDATAFORMAT *format = &impl->base.device_format;
     char *report_buf = impl->input_report_buf;
+    struct hid_input_object *object, *object_end;
     struct parse_device_state_params params;
     struct hid_joystick_effect *effect;
     UINT device_state, effect_state;
@@ -1328,8 +1323,11 @@ static HRESULT hid_joystick_read( IDirectInputDevice8W *iface )
                     params.buttons[usages->Usage - 1] = 0x80;
             }
 
-            enum_objects( impl, &filter, DIDFT_AXIS | DIDFT_POV, read_device_state_value, &params );
-            enum_objects( impl, &filter, DIDFT_BUTTON, check_device_state_button, &params );
+            object_end = impl->input_objects + impl->input_objects_count;
+            for (object = impl->input_objects; object != object_end; object++)
+                if (!(object->type & DIDFT_BUTTON)) read_device_state_value( impl, object, &params );
+            for (object = impl->input_objects; object != object_end; object++)
+                if (object->type & DIDFT_BUTTON) read_device_state_button( impl, object, &params );
             if (impl->base.hEvent && memcmp( &params.old_state, impl->base.device_state, format->dwDataSize ))
                 SetEvent( impl->base.hEvent );
         }
@@ -1740,6 +1738,24 @@ static BOOL init_object_properties( struct dinput_device *device, UINT index, st
     return DIENUM_CONTINUE;
 }
 
+static BOOL init_input_object( struct dinput_device *device, UINT index, struct hid_value_caps *caps,
+                               const DIDEVICEOBJECTINSTANCEW *instance, void *data )
+{
+    struct hid_joystick *impl = CONTAINING_RECORD( device, struct hid_joystick, base );
+    struct hid_input_object *object;
+
+    if (index == -1) return DIENUM_STOP;
+    if (instance->wReportId != device->device_state_report_id) return DIENUM_CONTINUE;
+
+    object = impl->input_objects + impl->input_objects_count++;
+    object->index = index;
+    object->type = instance->dwType;
+    object->ofs = instance->dwOfs;
+    object->usage_page = instance->wUsagePage;
+    object->usage = instance->wUsage;
+    return DIENUM_CONTINUE;
+}
+
 static BOOL init_pid_reports( struct dinput_device *device, UINT index, struct hid_value_caps *caps,
                               const DIDEVICEOBJECTINSTANCEW *instance, void *data )
 {
@@ -2156,6 +2172,11 @@ HRESULT hid_joystick_create_device( struct dinput *dinput, const GUID *guid, IDi
     if (FAILED(hr = dinput_device_init_device_format( &impl->base.IDirectInputDevice8W_iface ))) goto failed;
     enum_objects( impl, &filter, DIDFT_AXIS | DIDFT_POV, init_object_properties, NULL );
 
+    hr = E_OUTOFMEMORY;
+    size = impl->base.device_format.dwNumObjs;
+    if (size && !(impl->input_objects = calloc( size, sizeof(*impl->input_objects) ))) goto failed;
+    enum_objects( impl, &filter, DIDFT_AXIS | DIDFT_POV | DIDFT_BUTTON, init_input_object, NULL );
+
     *out = &impl->base.IDirectInputDevice8W_iface;
     return DI_OK;
 
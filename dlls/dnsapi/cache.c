@@ -0,0 +1,219 @@
+/*
+ * DNS resolver cache
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "windef.h"
+#include "winbase.h"
+#include "winternl.h"
+#include "winerror.h"
+#include "windns.h"
+
+#include "wine/debug.h"
+#include "wine/list.h"
+#include "dnsapi.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(dnsapi);
+
+#define CACHE_MAX_ENTRIES   1024
+#define CACHE_MAX_TTL       86400  /* same limits as the Windows resolver cache */
+#define CACHE_NEGATIVE_TTL  900
+
+struct cache_entry
+{
+    struct list  entry;
+    char        *name;
+    WORD         type;
+    BOOL         pending;      /* a query for this entry is in flight */
+    DNS_STATUS   status;
+    DNS_RECORDA *records;
+    ULONGLONG    expires;      /* in ms */
+};
+
+static CRITICAL_SECTION cache_cs;
+static CRITICAL_SECTION_DEBUG cache_cs_debug =
+{
+    0, 0, &cache_cs,
+    { &cache_cs_debug.ProcessLocksList, &cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": cache_cs") }
+};
+static CRITICAL_SECTION cache_cs = { &cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static CONDITION_VARIABLE cache_cond = CONDITION_VARIABLE_INIT;
+static struct list cache = LIST_INIT( cache );
+static unsigned int cache_count;
+static LONG cache_hits, cache_misses, cache_coalesced;
+
+static void free_entry( struct cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    cache_count--;
+    DnsRecordListFree( (DNS_RECORD *)entry->records, DnsFreeRecordList );
+    free( entry->name );
+    free( entry );
+}
+
+static struct cache_entry *find_entry( const char *name, WORD type )
+{
+    struct cache_entry *entry;
+
+    LIST_FOR_EACH_ENTRY( entry, &cache, struct cache_entry, entry )
+        if (entry->type == type && !_stricmp( entry->name, name )) return entry;
+    return NULL;
+}
+
+static DNS_RECORDA *copy_records( const DNS_RECORDA *records, ULONGLONG expires, ULONGLONG now, DWORD options )
+{
+    DNS_RECORDA *ret, *r;
+
+    if (!(ret = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)records, DnsCharSetUtf8, DnsCharSetUtf8 )))
+        return NULL;
+    if (!(options & DNS_QUERY_DONT_RESET_TTL_VALUES))
+        for (r = ret; r; r = r->pNext) r->dwTtl = min( r->dwTtl, (expires - now) / 1000 );
+    return ret;
+}
+
+/* Look up a name in the cache. On a miss, and unless cache_only is set, the query
+ * is reserved for the caller, who must then pass its result to cache_store(); other
+ * threads asking for the same name wait for that result instead of querying too. */
+BOOL cache_lookup( const char *name, WORD type, DWORD options, BOOL cache_only,
+                   DNS_STATUS *status, DNS_RECORDA **result )
+{
+    struct cache_entry *entry;
+    BOOL waited = FALSE;
+    ULONGLONG now;
+
+    EnterCriticalSection( &cache_cs );
+    for (;;)
+    {
+        now = GetTickCount64();
+        if (!(entry = find_entry( name, type ))) break;
+        if (entry->pending)
+        {
+            if (cache_only) break;
+            if (!waited) InterlockedIncrement( &cache_coalesced );
+            waited = TRUE;
+            SleepConditionVariableCS( &cache_cond, &cache_cs, INFINITE );
+            continue;
+        }
+        if (entry->expires <= now)
+        {
+            free_entry( entry );
+            entry = NULL;
+            break;
+        }
+
+        list_remove( &entry->entry );
+        list_add_head( &cache, &entry->entry );
+        *status = entry->status;
+        *result = NULL;
+        if (entry->records && !(*result = copy_records( entry->records, entry->expires, now, options )))
+            *status = ERROR_NOT_ENOUGH_MEMORY;
+        LeaveCriticalSection( &cache_cs );
+
+        InterlockedIncrement( &cache_hits );
+        TRACE( "%s %s found in cache, status %ld\n", debugstr_a(name), debugstr_type(type), *status );
+        return TRUE;
+    }
+
+    InterlockedIncrement( &cache_misses );
+    if (!cache_only && (entry = calloc( 1, sizeof(*entry) )))
+    {
+        if ((entry->name = strdup( name )))
+        {
+            entry->type = type;
+            entry->pending = TRUE;
+            list_add_head( &cache, &entry->entry );
+            cache_count++;
+        }
+        else free( entry );
+    }
+    LeaveCriticalSection( &cache_cs );
+    return FALSE;
+}
+
+/* positive answers live as long as their shortest TTL, negative ones as long as the SOA allows */
+static ULONGLONG get_ttl( DNS_STATUS status, const DNS_RECORDA *records )
+{
+    ULONGLONG ttl = ~0u;
+    BOOL answers = FALSE;
+    const DNS_RECORDA *r;
+
+    if (status && status != DNS_ERROR_RCODE_NAME_ERROR) return 0;
+
+    for (r = records; r; r = r->pNext)
+    {
+        if (r->Flags.S.Section != DnsSectionAnswer) continue;
+        ttl = min( ttl, r->dwTtl );
+        answers = TRUE;
+    }
+    if (answers) return min( ttl, CACHE_MAX_TTL );
+
+    ttl = CACHE_NEGATIVE_TTL;
+    for (r = records; r; r = r->pNext)
+        if (r->wType == DNS_TYPE_SOA) ttl = min( ttl, min( r->dwTtl, r->Data.SOA.dwDefaultTtl ));
+    return ttl;
+}
+
+/* store the result of a query reserved by cache_lookup() and wake up the threads waiting for it */
+void cache_store( const char *name, WORD type, DNS_STATUS status, const DNS_RECORDA *records )
+{
+    ULONGLONG ttl = get_ttl( status, records );
+    struct cache_entry *entry, *next;
+
+    EnterCriticalSection( &cache_cs );
+    if ((entry = find_entry( name, type )) && entry->pending)
+    {
+        entry->pending = FALSE;
+        entry->status = status;
+        if (!ttl || (records && !(entry->records = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)records,
+                                                                                     DnsCharSetUtf8, DnsCharSetUtf8 ))))
+            free_entry( entry );
+        else
+        {
+            entry->expires = GetTickCount64() + ttl * 1000;
+            TRACE( "caching %s %s for %I64us, status %ld\n", debugstr_a(name), debugstr_type(type), ttl, status );
+        }
+    }
+
+    LIST_FOR_EACH_ENTRY_SAFE_REV( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (cache_count <= CACHE_MAX_ENTRIES) break;
+        if (!entry->pending) free_entry( entry );
+    }
+    WakeAllConditionVariable( &cache_cond );
+    LeaveCriticalSection( &cache_cs );
+}
+
+/* remove the entries of a name, or all of them */
+void cache_flush( const char *name )
+{
+    struct cache_entry *entry, *next;
+
+    EnterCriticalSection( &cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (entry->pending || (name && _stricmp( entry->name, name ))) continue;
+        free_entry( entry );
+    }
+    LeaveCriticalSection( &cache_cs );
+
+    TRACE( "%ld hits, %ld misses, %ld coalesced queries\n", cache_hits, cache_misses, cache_coalesced );
+}
@@ -99,6 +99,10 @@ static inline char *strdup_ua( const char *src )
 
 extern const char *debugstr_type( unsigned short );
 
+extern BOOL cache_lookup( const char *, WORD, DWORD, BOOL, DNS_STATUS *, DNS_RECORDA ** );
+extern void cache_store( const char *, WORD, DNS_STATUS, const DNS_RECORDA * );
+extern void cache_flush( const char * );
+
 struct get_searchlist_params
 {
     WCHAR           *list;
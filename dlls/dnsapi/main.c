@@ -44,6 +44,8 @@ BOOL WINAPI DllMain( HINSTANCE hinst, DWORD reason, LPVOID reserved )
             ERR( "No libresolv support, expect problems\n" );
         break;
     case DLL_PROCESS_DETACH:
+        if (reserved) break;
+        cache_flush( NULL );
         break;
     }
     return TRUE;
@@ -91,7 +93,17 @@ DNS_STATUS WINAPI DnsAcquireContextHandle_W( DWORD flags, void *cred, HANDLE *co
  */
 VOID WINAPI DnsFlushResolverCache(void)
 {
-    FIXME(": stub\n");
+    void (WINAPI *flush_addrinfo_cache)(void);
+    HMODULE ws2_32;
+
+    TRACE( "()\n" );
+
+    cache_flush( NULL );
+
+    /* ws2_32 keeps the results of the host resolver in its own cache */
+    if ((ws2_32 = GetModuleHandleW( L"ws2_32.dll" )) &&
+        (flush_addrinfo_cache = (void *)GetProcAddress( ws2_32, "__wine_flush_addrinfo_cache" )))
+        flush_addrinfo_cache();
 }
 
 /******************************************************************************
@@ -100,8 +112,13 @@ VOID WINAPI DnsFlushResolverCache(void)
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
-    if (!entry) return FALSE;
+    char *name;
+
+    TRACE( "%s\n", debugstr_a(entry) );
+
+    if (!entry || !(name = strdup_au( entry ))) return FALSE;
+    cache_flush( name );
+    free( name );
     return TRUE;
 }
 
@@ -111,8 +128,10 @@ BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
+    TRACE( "%s\n", debugstr_a(entry) );
+
     if (!entry) return FALSE;
+    cache_flush( entry );
     return TRUE;
 }
 
@@ -122,8 +141,13 @@ BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_W( PCWSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_w(entry) );
-    if (!entry) return FALSE;
+    char *name;
+
+    TRACE( "%s\n", debugstr_w(entry) );
+
+    if (!entry || !(name = strdup_wu( entry ))) return FALSE;
+    cache_flush( name );
+    free( name );
     return TRUE;
 }
 
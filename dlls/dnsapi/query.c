@@ -163,6 +163,49 @@ DNS_STATUS WINAPI DnsQuery_A( const char *name, WORD type, DWORD options, void *
     return status;
 }
 
+static DNS_STATUS do_query( const char *name, WORD type, DWORD options, void *servers, DNS_RECORDA **result )
+{
+    DNS_STATUS ret;
+    unsigned char answer[4096];
+    DWORD len = sizeof(answer);
+    struct query_params query_params = { name, type, options, answer, &len };
+
+    if ((ret = RESOLV_CALL( set_serverlist, servers ))) return ret;
+
+    ret = RESOLV_CALL( query, &query_params );
+    if (!ret)
+    {
+        DNS_MESSAGE_BUFFER *buffer = (DNS_MESSAGE_BUFFER *)answer;
+
+        if (len < sizeof(buffer->MessageHead)) return DNS_ERROR_BAD_PACKET;
+        DNS_BYTE_FLIP_HEADER_COUNTS( &buffer->MessageHead );
+        switch (buffer->MessageHead.ResponseCode)
+        {
+        case DNS_RCODE_NOERROR:  ret = DnsExtractRecordsFromMessage_UTF8( buffer, len, result ); break;
+        case DNS_RCODE_FORMERR:  ret = DNS_ERROR_RCODE_FORMAT_ERROR; break;
+        case DNS_RCODE_SERVFAIL: ret = DNS_ERROR_RCODE_SERVER_FAILURE; break;
+        case DNS_RCODE_NXDOMAIN: ret = DNS_ERROR_RCODE_NAME_ERROR; break;
+        case DNS_RCODE_NOTIMPL:  ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED; break;
+        case DNS_RCODE_REFUSED:  ret = DNS_ERROR_RCODE_REFUSED; break;
+        case DNS_RCODE_YXDOMAIN: ret = DNS_ERROR_RCODE_YXDOMAIN; break;
+        case DNS_RCODE_YXRRSET:  ret = DNS_ERROR_RCODE_YXRRSET; break;
+        case DNS_RCODE_NXRRSET:  ret = DNS_ERROR_RCODE_NXRRSET; break;
+        case DNS_RCODE_NOTAUTH:  ret = DNS_ERROR_RCODE_NOTAUTH; break;
+        case DNS_RCODE_NOTZONE:  ret = DNS_ERROR_RCODE_NOTZONE; break;
+        default:                 ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED; break;
+        }
+    }
+
+    if (ret == DNS_ERROR_RCODE_NAME_ERROR && type == DNS_TYPE_A &&
+        !(options & DNS_QUERY_NO_NETBT))
+    {
+        TRACE( "dns lookup failed, trying netbios query\n" );
+        ret = do_query_netbios( name, result );
+    }
+
+    return ret;
+}
+
 /******************************************************************************
  * DnsQuery_UTF8              [DNSAPI.@]
  *
@@ -170,10 +213,7 @@ DNS_STATUS WINAPI DnsQuery_A( const char *name, WORD type, DWORD options, void *
 DNS_STATUS WINAPI DnsQuery_UTF8( const char *name, WORD type, DWORD options, void *servers, DNS_RECORDA **result,
                                  void **reserved )
 {
-    DNS_STATUS ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED;
-    unsigned char answer[4096];
-    DWORD len = sizeof(answer);
-    struct query_params query_params = { name, type, options, answer, &len };
+    DNS_STATUS ret;
     const char *end;
 
     TRACE( "(%s, %s, %#lx, %p, %p, %p)\n", debugstr_a(name), debugstr_type( type ),
@@ -219,39 +259,15 @@ DNS_STATUS WINAPI DnsQuery_UTF8( const char *name, WORD type, DWORD options, voi
         }
     }
 
-    if ((ret = RESOLV_CALL( set_serverlist, servers ))) return ret;
+    /* queries sent to specific servers don't go through the cache */
+    if (servers || (options & (DNS_QUERY_BYPASS_CACHE | DNS_QUERY_WIRE_ONLY)))
+        return do_query( name, type, options, servers, result );
 
-    ret = RESOLV_CALL( query, &query_params );
-    if (!ret)
-    {
-        DNS_MESSAGE_BUFFER *buffer = (DNS_MESSAGE_BUFFER *)answer;
-
-        if (len < sizeof(buffer->MessageHead)) return DNS_ERROR_BAD_PACKET;
-        DNS_BYTE_FLIP_HEADER_COUNTS( &buffer->MessageHead );
-        switch (buffer->MessageHead.ResponseCode)
-        {
-        case DNS_RCODE_NOERROR:  ret = DnsExtractRecordsFromMessage_UTF8( buffer, len, result ); break;
-        case DNS_RCODE_FORMERR:  ret = DNS_ERROR_RCODE_FORMAT_ERROR; break;
-        case DNS_RCODE_SERVFAIL: ret = DNS_ERROR_RCODE_SERVER_FAILURE; break;
-        case DNS_RCODE_NXDOMAIN: ret = DNS_ERROR_RCODE_NAME_ERROR; break;
-        case DNS_RCODE_NOTIMPL:  ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED; break;
-        case DNS_RCODE_REFUSED:  ret = DNS_ERROR_RCODE_REFUSED; break;
-        case DNS_RCODE_YXDOMAIN: ret = DNS_ERROR_RCODE_YXDOMAIN; break;
-        case DNS_RCODE_YXRRSET:  ret = DNS_ERROR_RCODE_YXRRSET; break;
-        case DNS_RCODE_NXRRSET:  ret = DNS_ERROR_RCODE_NXRRSET; break;
-        case DNS_RCODE_NOTAUTH:  ret = DNS_ERROR_RCODE_NOTAUTH; break;
-        case DNS_RCODE_NOTZONE:  ret = DNS_ERROR_RCODE_NOTZONE; break;
-        default:                 ret = DNS_ERROR_RCODE_NOT_IMPLEMENTED; break;
-        }
-    }
-
-    if (ret == DNS_ERROR_RCODE_NAME_ERROR && type == DNS_TYPE_A &&
-        !(options & DNS_QUERY_NO_NETBT))
-    {
-        TRACE( "dns lookup failed, trying netbios query\n" );
-        ret = do_query_netbios( name, result );
-    }
+    if (cache_lookup( name, type, options, options & DNS_QUERY_NO_WIRE_QUERY, &ret, result )) return ret;
+    if (options & DNS_QUERY_NO_WIRE_QUERY) return DNS_ERROR_RECORD_DOES_NOT_EXIST;
 
+    ret = do_query( name, type, options, NULL, result );
+    cache_store( name, type, ret, ret ? NULL : *result );
     return ret;
 }
 
@@ -115,6 +115,13 @@ static void test_DnsQuery(void)
     ok(status == ERROR_SUCCESS, "got %ld\n", status);
     DnsRecordListFree(rec, DnsFreeRecordList);
 
+    /* the answer is now in the resolver cache */
+    rec = NULL;
+    status = DnsQuery_W(L"winehq.org", DNS_TYPE_A, DNS_QUERY_NO_WIRE_QUERY, NULL, &rec, NULL);
+    ok(status == ERROR_SUCCESS, "got %ld\n", status);
+    ok(rec != NULL, "got NULL\n");
+    DnsRecordListFree(rec, DnsFreeRecordList);
+
     /* Show that DNS_TYPE_A returns CNAMEs too */
     rec = NULL;
     wcscpy(domain, L"test.winehq.org"); /* should be a CNAME */
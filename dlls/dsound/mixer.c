@@ -286,6 +286,54 @@ static inline float get_current_sample(const IDirectSoundBufferImpl *dsb,
     return dsb->get(dsb, buffer + (mixpos % buflen), channel);
 }
 
+/* Same as calling get_current_sample() for count consecutive frames, without
+ * recomputing the wrap-around for each of them. */
+static void get_current_samples(const IDirectSoundBufferImpl *dsb, float *out,
+        BYTE *buffer, DWORD buflen, DWORD mixpos, UINT count, DWORD channel)
+{
+    UINT istride = dsb->pwfx->nBlockAlign;
+    UINT i, run;
+
+    while (count)
+    {
+        if (mixpos >= buflen)
+        {
+            if (!(dsb->playflags & DSBPLAY_LOOPING))
+            {
+                memset(out, 0, count * sizeof(*out));
+                return;
+            }
+            mixpos %= buflen;
+        }
+
+        run = min(count, (buflen - mixpos + istride - 1) / istride);
+        for (i = 0; i < run; i++)
+            *(out++) = dsb->get(dsb, buffer + mixpos + i * istride, channel);
+        mixpos += run * istride;
+        count -= run;
+    }
+}
+
+/* Dot product with independent partial sums, so that consecutive
+ * multiply-adds don't have to wait on each other. */
+static inline float fir_dot_product(const float *fir_copy, const float *cache, int count)
+{
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    int j;
+
+    for (j = 0; j + 4 <= count; j += 4)
+    {
+        sum0 += fir_copy[j] * cache[j];
+        sum1 += fir_copy[j + 1] * cache[j + 1];
+        sum2 += fir_copy[j + 2] * cache[j + 2];
+        sum3 += fir_copy[j + 3] * cache[j + 3];
+    }
+    for (; j < count; j++)
+        sum0 += fir_copy[j] * cache[j];
+
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
 static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
 {
     UINT istride = dsb->pwfx->nBlockAlign;
@@ -362,12 +410,11 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
      */
     itmp = intermediate;
     for (channel = 0; channel < channels; channel++) {
-        for (i = 0; i < committed_samples; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->committedbuff,
-                dsb->writelead, dsb->committed_mixpos + i * istride, channel);
-        for (; i < required_input; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->buffer->memory,
-                    dsb->buflen, dsb->sec_mixpos + i * istride, channel);
+        get_current_samples(dsb, itmp, dsb->committedbuff, dsb->writelead,
+                dsb->committed_mixpos, committed_samples, channel);
+        get_current_samples(dsb, itmp + committed_samples, dsb->buffer->memory, dsb->buflen,
+                dsb->sec_mixpos + committed_samples * istride, required_input - committed_samples, channel);
+        itmp += required_input;
     }
 
     for(i = 0; i < count; ++i) {
@@ -378,22 +425,20 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
         UINT idx = (ipos + 1) * dsbfirstep - int_fir_steps - 1;
         float rem = int_fir_steps + 1.0 - total_fir_steps;
 
+        float rem_inv = 1.0f - rem;
+
         int fir_used = 0;
         while (idx < fir_len - 1) {
-            fir_copy[fir_used++] = fir[idx] * (1.0 - rem) + fir[idx + 1] * rem;
-            idx += dsb->firstep;
+            fir_copy[fir_used++] = fir[idx] * rem_inv + fir[idx + 1] * rem;
+            idx += dsbfirstep;
         }
 
         assert(fir_used <= fir_cachesize);
         assert(ipos + fir_used <= required_input);
 
         for (channel = 0; channel < dsb->mix_channels; channel++) {
-            int j;
-            float sum = 0.0;
             float* cache = &intermediate[channel * required_input + ipos];
-            for (j = 0; j < fir_used; j++)
-                sum += fir_copy[j] * cache[j];
-            dsb->put(dsb, i * ostride, channel, sum * dsb->firgain);
+            dsb->put(dsb, i * ostride, channel, fir_dot_product(fir_copy, cache, fir_used) * dsb->firgain);
         }
     }
 
@@ -1513,6 +1513,54 @@ static void analyzer_dump_user_features(DWRITE_TYPOGRAPHIC_FEATURES const **feat
     }
 }
 
+#define SHAPED_RUN_MAX_LENGTH 512
+#define SHAPED_RUN_MAX_FEATURES 64
+
+/* Serialize everything the shaping result depends on. Text is placed last, so that
+   runs of different lengths or parameters differ early. */
+static void *get_shaped_run_key(const WCHAR *text, UINT32 length, const struct scriptshaping_context *context,
+        const WCHAR *digits, UINT32 *key_size)
+{
+    UINT32 i, feature_count = 0, size, *key, *ptr;
+
+    if (length > SHAPED_RUN_MAX_LENGTH)
+        return NULL;
+
+    for (i = 0; context->user_features.features && i < context->user_features.range_count; ++i)
+        feature_count += context->user_features.features[i]->featureCount;
+    if (feature_count > SHAPED_RUN_MAX_FEATURES)
+        return NULL;
+
+    size = (6 + (NATIVE_DIGITS_LEN + 1) / 2) * sizeof(*key) + length * sizeof(WCHAR);
+    if (context->user_features.features)
+        size += context->user_features.range_count * 2 * sizeof(*key) + feature_count * sizeof(DWRITE_FONT_FEATURE);
+    if (!(key = calloc(1, size)))
+        return NULL;
+
+    ptr = key;
+    *ptr++ = context->script;
+    *ptr++ = context->language_tag;
+    *ptr++ = context->is_rtl;
+    *ptr++ = context->is_sideways;
+    *ptr++ = length;
+    *ptr++ = context->user_features.features ? context->user_features.range_count : 0;
+    for (i = 0; i < NATIVE_DIGITS_LEN && digits[i]; ++i)
+        ((WCHAR *)ptr)[i] = digits[i];
+    ptr += (NATIVE_DIGITS_LEN + 1) / 2;
+    for (i = 0; context->user_features.features && i < context->user_features.range_count; ++i)
+    {
+        *ptr++ = context->user_features.range_lengths[i];
+        *ptr++ = context->user_features.features[i]->featureCount;
+        memcpy(ptr, context->user_features.features[i]->features,
+                context->user_features.features[i]->featureCount * sizeof(DWRITE_FONT_FEATURE));
+        ptr += context->user_features.features[i]->featureCount * sizeof(DWRITE_FONT_FEATURE) / sizeof(*ptr);
+    }
+    memcpy(ptr, text, length * sizeof(WCHAR));
+
+    *key_size = size;
+    return key;
+}
+
 static HRESULT WINAPI dwritetextanalyzer_GetGlyphs(IDWriteTextAnalyzer2 *iface,
     WCHAR const* text, UINT32 length, IDWriteFontFace* fontface, BOOL is_sideways,
     BOOL is_rtl, DWRITE_SCRIPT_ANALYSIS const* analysis, WCHAR const* locale,
@@ -1526,6 +1574,8 @@ static HRESULT WINAPI dwritetextanalyzer_GetGlyphs(IDWriteTextAnalyzer2 *iface,
     struct dwrite_fontface *font_obj;
     WCHAR digits[NATIVE_DIGITS_LEN];
     unsigned int glyph_count;
+    UINT32 key_size = 0;
+    void *key = NULL;
     HRESULT hr;
 
     TRACE("%s:%u, %p, %d, %d, %s, %s, %p, %p, %p, %u, %u, %p, %p, %p, %p, %p.\n", debugstr_wn(text, length),
@@ -1545,8 +1595,6 @@ static HRESULT WINAPI dwritetextanalyzer_GetGlyphs(IDWriteTextAnalyzer2 *iface,
     context.length = length;
     context.is_rtl = is_rtl;
     context.is_sideways = is_sideways;
-    context.u.subst.glyphs = calloc(glyph_count, sizeof(*glyphs));
-    context.u.subst.glyph_props = calloc(glyph_count, sizeof(*glyph_props));
     context.u.subst.text_props = text_props;
     context.u.subst.clustermap = clustermap;
     context.u.subst.max_glyph_count = max_glyph_count;
@@ -1556,11 +1604,22 @@ static HRESULT WINAPI dwritetextanalyzer_GetGlyphs(IDWriteTextAnalyzer2 *iface,
     context.user_features.features = features;
     context.user_features.range_lengths = feature_range_lengths;
     context.user_features.range_count = feature_ranges;
-    context.glyph_infos = calloc(glyph_count, sizeof(*context.glyph_infos));
     context.table = &context.cache->gsub;
 
     *actual_glyph_count = 0;
 
+    if ((key = get_shaped_run_key(text, length, &context, digits, &key_size))
+            && fontface_get_shaped_run(font_obj, key, key_size, length, max_glyph_count, clustermap, text_props,
+            glyphs, glyph_props, actual_glyph_count))
+    {
+        free(key);
+        return S_OK;
+    }
+
+    context.u.subst.glyphs = calloc(glyph_count, sizeof(*glyphs));
+    context.u.subst.glyph_props = calloc(glyph_count, sizeof(*glyph_props));
+    context.glyph_infos = calloc(glyph_count, sizeof(*context.glyph_infos));
+
     if (!context.u.subst.glyphs || !context.u.subst.glyph_props || !context.glyph_infos)
     {
         hr = E_OUTOFMEMORY;
@@ -1574,12 +1633,16 @@ static HRESULT WINAPI dwritetextanalyzer_GetGlyphs(IDWriteTextAnalyzer2 *iface,
         *actual_glyph_count = context.glyph_count;
         memcpy(glyphs, context.u.subst.glyphs, context.glyph_count * sizeof(*glyphs));
         memcpy(glyph_props, context.u.subst.glyph_props, context.glyph_count * sizeof(*glyph_props));
+        if (key)
+            fontface_add_shaped_run(font_obj, key, key_size, length, clustermap, text_props, glyphs, glyph_props,
+                    context.glyph_count);
     }
 
 failed:
     free(context.u.subst.glyph_props);
     free(context.u.subst.glyphs);
     free(context.glyph_infos);
+    free(key);
 
     return hr;
 }
@@ -264,6 +264,13 @@ struct dwrite_fontface
         size_t max_size;
         size_t size;
     } cache;
+    struct
+    {
+        struct wine_rb_tree tree;
+        struct list mru;
+        size_t max_size;
+        size_t size;
+    } shaped_runs;
     CRITICAL_SECTION cs;
 
     USHORT simulations;
@@ -376,6 +383,12 @@ struct dwrite_fontface;
 extern float fontface_get_scaled_design_advance(struct dwrite_fontface *fontface, DWRITE_MEASURING_MODE measuring_mode,
         float emsize, float ppdip, const DWRITE_MATRIX *transform, UINT16 glyph, BOOL is_sideways);
 extern struct dwrite_fontface *unsafe_impl_from_IDWriteFontFace(IDWriteFontFace *iface);
+extern BOOL fontface_get_shaped_run(struct dwrite_fontface *fontface, const void *key, UINT32 key_size,
+        UINT32 length, UINT32 max_glyph_count, UINT16 *clustermap, DWRITE_SHAPING_TEXT_PROPERTIES *text_props,
+        UINT16 *glyphs, DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props, UINT32 *glyph_count);
+extern void fontface_add_shaped_run(struct dwrite_fontface *fontface, const void *key, UINT32 key_size,
+        UINT32 length, const UINT16 *clustermap, const DWRITE_SHAPING_TEXT_PROPERTIES *text_props,
+        const UINT16 *glyphs, const DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props, UINT32 glyph_count);
 
 struct dwrite_textformat_data
 {
@@ -69,6 +69,28 @@ struct cache_entry
     unsigned int has_bitmap : 1;
 };
 
+/* GetGlyphs() results, keyed by the text and all shaping parameters. */
+struct shaped_run
+{
+    struct wine_rb_entry entry;
+    struct list mru;
+    size_t size;
+    UINT32 length;
+    UINT32 glyph_count;
+    UINT16 *clustermap;
+    DWRITE_SHAPING_TEXT_PROPERTIES *text_props;
+    UINT16 *glyphs;
+    DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props;
+    UINT32 key_size;
+    BYTE key[1];
+};
+
+struct shaped_run_key
+{
+    const void *data;
+    UINT32 size;
+};
+
 /* Ignore dx and dy because FreeType doesn't actually use it */
 static inline void matrix_2x2_from_dwrite_matrix(MATRIX_2X2 *m1, const DWRITE_MATRIX *m2)
 {
@@ -260,16 +282,29 @@ static int fontface_cache_compare(const void *k, const struct wine_rb_entry *e)
     return 0;
 }
 
+static int fontface_shaped_run_compare(const void *k, const struct wine_rb_entry *e)
+{
+    const struct shaped_run *run = WINE_RB_ENTRY_VALUE(e, const struct shaped_run, entry);
+    const struct shaped_run_key *key = k;
+
+    if (key->size != run->key_size) return key->size < run->key_size ? -1 : 1;
+    return memcmp(key->data, run->key, key->size);
+}
+
 static void fontface_cache_init(struct dwrite_fontface *fontface)
 {
     wine_rb_init(&fontface->cache.tree, fontface_cache_compare);
     list_init(&fontface->cache.mru);
     fontface->cache.max_size = 0x8000;
+    wine_rb_init(&fontface->shaped_runs.tree, fontface_shaped_run_compare);
+    list_init(&fontface->shaped_runs.mru);
+    fontface->shaped_runs.max_size = 0x10000;
 }
 
 static void fontface_cache_clear(struct dwrite_fontface *fontface)
 {
     struct cache_entry *entry, *entry2;
+    struct shaped_run *run, *run2;
 
     LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &fontface->cache.mru, struct cache_entry, mru)
     {
@@ -277,6 +312,97 @@ static void fontface_cache_clear(struct dwrite_fontface *fontface)
         fontface_release_cache_entry(entry);
     }
     memset(&fontface->cache, 0, sizeof(fontface->cache));
+
+    LIST_FOR_EACH_ENTRY_SAFE(run, run2, &fontface->shaped_runs.mru, struct shaped_run, mru)
+    {
+        list_remove(&run->mru);
+        free(run);
+    }
+    memset(&fontface->shaped_runs, 0, sizeof(fontface->shaped_runs));
+}
+
+BOOL fontface_get_shaped_run(struct dwrite_fontface *fontface, const void *key, UINT32 key_size,
+        UINT32 length, UINT32 max_glyph_count, UINT16 *clustermap, DWRITE_SHAPING_TEXT_PROPERTIES *text_props,
+        UINT16 *glyphs, DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props, UINT32 *glyph_count)
+{
+    struct shaped_run_key run_key = { key, key_size };
+    struct shaped_run *run = NULL;
+    struct wine_rb_entry *e;
+
+    EnterCriticalSection(&fontface->cs);
+    if ((e = wine_rb_get(&fontface->shaped_runs.tree, &run_key)))
+    {
+        run = WINE_RB_ENTRY_VALUE(e, struct shaped_run, entry);
+        /* Let the caller fail the same way it would without the cache. */
+        if (run->length != length || run->glyph_count > max_glyph_count)
+            run = NULL;
+    }
+    if (run)
+    {
+        memcpy(clustermap, run->clustermap, length * sizeof(*clustermap));
+        memcpy(text_props, run->text_props, length * sizeof(*text_props));
+        memcpy(glyphs, run->glyphs, run->glyph_count * sizeof(*glyphs));
+        memcpy(glyph_props, run->glyph_props, run->glyph_count * sizeof(*glyph_props));
+        *glyph_count = run->glyph_count;
+
+        list_remove(&run->mru);
+        list_add_head(&fontface->shaped_runs.mru, &run->mru);
+    }
+    LeaveCriticalSection(&fontface->cs);
+
+    return !!run;
+}
+
+void fontface_add_shaped_run(struct dwrite_fontface *fontface, const void *key, UINT32 key_size,
+        UINT32 length, const UINT16 *clustermap, const DWRITE_SHAPING_TEXT_PROPERTIES *text_props,
+        const UINT16 *glyphs, const DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props, UINT32 glyph_count)
+{
+    struct shaped_run_key run_key = { key, key_size };
+    struct shaped_run *run, *old_run;
+    size_t size, offset;
+    BYTE *ptr;
+
+    offset = (offsetof(struct shaped_run, key[key_size]) + 3) & ~3;
+    size = offset + length * (sizeof(*clustermap) + sizeof(*text_props)) +
+            glyph_count * (sizeof(*glyphs) + sizeof(*glyph_props));
+    if (size > fontface->shaped_runs.max_size / 4) return;
+    if (!(run = malloc(size))) return;
+
+    run->size = size;
+    run->length = length;
+    run->glyph_count = glyph_count;
+    run->key_size = key_size;
+    memcpy(run->key, key, key_size);
+    ptr = (BYTE *)run + offset;
+    run->clustermap = memcpy(ptr, clustermap, length * sizeof(*clustermap));
+    ptr += length * sizeof(*clustermap);
+    run->glyphs = memcpy(ptr, glyphs, glyph_count * sizeof(*glyphs));
+    ptr += glyph_count * sizeof(*glyphs);
+    run->text_props = memcpy(ptr, text_props, length * sizeof(*text_props));
+    ptr += length * sizeof(*text_props);
+    run->glyph_props = memcpy(ptr, glyph_props, glyph_count * sizeof(*glyph_props));
+
+    EnterCriticalSection(&fontface->cs);
+    while (fontface->shaped_runs.size + size > fontface->shaped_runs.max_size
+            && !list_empty(&fontface->shaped_runs.mru))
+    {
+        old_run = LIST_ENTRY(list_tail(&fontface->shaped_runs.mru), struct shaped_run, mru);
+        fontface->shaped_runs.size -= old_run->size;
+        wine_rb_remove(&fontface->shaped_runs.tree, &old_run->entry);
+        list_remove(&old_run->mru);
+        free(old_run);
+    }
+    if (wine_rb_put(&fontface->shaped_runs.tree, &run_key, &run->entry) == -1)
+    {
+        /* Another thread shaped the same run. */
+        free(run);
+    }
+    else
+    {
+        list_add_head(&fontface->shaped_runs.mru, &run->mru);
+        fontface->shaped_runs.size += size;
+    }
+    LeaveCriticalSection(&fontface->cs);
 }
 
 struct dwrite_font_propvec {
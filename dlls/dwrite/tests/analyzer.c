@@ -1738,6 +1738,14 @@ if (0) {
     ok(actual_count == 4, "got %d\n", actual_count);
     ok(glyphs1[0] != glyphs2[0], "got %d\n", glyphs1[0]);
 
+    /* shaping the same run again gives the same glyphs */
+    actual_count = 0;
+    hr = IDWriteTextAnalyzer_GetGlyphs(analyzer, test1W, lstrlenW(test1W), fontface, FALSE, FALSE, &sa, NULL,
+        NULL, NULL, NULL, 0, maxglyphcount, clustermap, props, glyphs2, shapingprops, &actual_count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(actual_count == 4, "got %d\n", actual_count);
+    ok(!memcmp(glyphs1, glyphs2, actual_count * sizeof(*glyphs1)), "Unexpected glyphs.\n");
+
     /* embedded control codes, with unknown script id 0 */
     get_fontface_glyphs(fontface, test3W, glyphs2);
     get_fontface_advances(fontface, 10.0, glyphs2, advances2, 2);
@@ -170,6 +170,13 @@ HRESULT dxgi_adapter_create(struct dxgi_factory *factory, UINT ordinal,
 struct dxgi_adapter *unsafe_impl_from_IDXGIAdapter(IDXGIAdapter *iface);
 
 /* IDXGISwapChain */
+struct dxgi_frame_limiter
+{
+    LONGLONG frequency;
+    LONGLONG period;
+    LONGLONG next;
+};
+
 struct d3d11_swapchain
 {
     IDXGISwapChain1 IDXGISwapChain1_iface;
@@ -183,6 +190,8 @@ struct d3d11_swapchain
     IDXGIOutput *target;
     LONG present_count;
     LONG in_set_fullscreen_state;
+
+    struct dxgi_frame_limiter frame_limiter;
 };
 
 HRESULT d3d11_swapchain_init(struct d3d11_swapchain *swapchain, struct dxgi_device *device,
@@ -27,6 +27,84 @@
 WINE_DEFAULT_DEBUG_CHANNEL(dxgi);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
+static struct
+{
+    /* Maximum number of frames queued by Present() when the application
+     * doesn't control it, 0 for the default behaviour. */
+    unsigned int max_frame_latency;
+    /* Frame rate limit, in frames per second, 0 to disable it. */
+    double max_frame_rate;
+}
+dxgi_present_settings;
+
+static BOOL WINAPI dxgi_init_present_settings(INIT_ONCE *once, void *param, void **context)
+{
+    const char *env;
+
+    if ((env = getenv("WINE_DXGI_MAX_FRAME_LATENCY")))
+    {
+        dxgi_present_settings.max_frame_latency = min(strtoul(env, NULL, 10), DXGI_MAX_SWAP_CHAIN_BUFFERS);
+        TRACE("Limiting frame latency to %u.\n", dxgi_present_settings.max_frame_latency);
+    }
+    if ((env = getenv("WINE_DXGI_MAX_FRAME_RATE")))
+    {
+        dxgi_present_settings.max_frame_rate = max(strtod(env, NULL), 0.0);
+        TRACE("Limiting frame rate to %.8e.\n", dxgi_present_settings.max_frame_rate);
+    }
+
+    return TRUE;
+}
+
+static void dxgi_get_present_settings(void)
+{
+    static INIT_ONCE init_once = INIT_ONCE_STATIC_INIT;
+
+    InitOnceExecuteOnce(&init_once, dxgi_init_present_settings, NULL, NULL);
+}
+
+static void dxgi_frame_limiter_init(struct dxgi_frame_limiter *limiter)
+{
+    LARGE_INTEGER frequency;
+
+    memset(limiter, 0, sizeof(*limiter));
+    if (!dxgi_present_settings.max_frame_rate)
+        return;
+
+    QueryPerformanceFrequency(&frequency);
+    limiter->frequency = frequency.QuadPart;
+    limiter->period = frequency.QuadPart / dxgi_present_settings.max_frame_rate;
+}
+
+/* Sleep() is only accurate to about a millisecond, so sleep until shortly
+ * before the target time and spin for the rest. */
+static void dxgi_frame_limiter_wait(struct dxgi_frame_limiter *limiter)
+{
+    LONGLONG remaining;
+    LARGE_INTEGER now;
+
+    if (!limiter->period)
+        return;
+
+    QueryPerformanceCounter(&now);
+    if ((remaining = limiter->next - now.QuadPart) > 0)
+    {
+        if ((remaining = remaining * 1000 / limiter->frequency) > 2)
+            Sleep(remaining - 2);
+
+        do
+        {
+            YieldProcessor();
+            QueryPerformanceCounter(&now);
+        } while (now.QuadPart < limiter->next);
+    }
+
+    /* Don't try to catch up after a long frame. */
+    if (now.QuadPart - limiter->next > limiter->period)
+        limiter->next = now.QuadPart + limiter->period;
+    else
+        limiter->next += limiter->period;
+}
+
 static DXGI_SWAP_EFFECT dxgi_swap_effect_from_wined3d(enum wined3d_swap_effect swap_effect)
 {
     switch (swap_effect)
@@ -320,6 +398,8 @@ static HRESULT d3d11_swapchain_present(struct d3d11_swapchain *swapchain,
         return S_OK;
     }
 
+    dxgi_frame_limiter_wait(&swapchain->frame_limiter);
+
     if (SUCCEEDED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, NULL, NULL, NULL, sync_interval, 0)))
         InterlockedIncrement(&swapchain->present_count);
     return hr;
@@ -891,8 +971,12 @@ HRESULT d3d11_swapchain_init(struct d3d11_swapchain *swapchain, struct dxgi_devi
     swapchain->IDXGISwapChain1_iface.lpVtbl = &d3d11_swapchain_vtbl;
     swapchain->state_parent.ops = &d3d11_swapchain_state_parent_ops;
     swapchain->refcount = 1;
+    dxgi_get_present_settings();
+    dxgi_frame_limiter_init(&swapchain->frame_limiter);
     wined3d_mutex_lock();
     wined3d_private_store_init(&swapchain->private_store);
+    if (dxgi_present_settings.max_frame_latency)
+        wined3d_device_set_max_frame_latency(device->wined3d_device, dxgi_present_settings.max_frame_latency);
 
     if (!desc->windowed && (!desc->backbuffer_width || !desc->backbuffer_height))
         FIXME("Fullscreen swapchain with back buffer width/height equal to 0 not supported properly.\n");
@@ -971,12 +1055,14 @@ struct dxgi_vk_funcs
     PFN_vkDestroyImage p_vkDestroyImage;
     PFN_vkDestroySemaphore p_vkDestroySemaphore;
     PFN_vkDestroySurfaceKHR p_vkDestroySurfaceKHR;
+    PFN_vkEnumerateDeviceExtensionProperties p_vkEnumerateDeviceExtensionProperties;
     PFN_vkResetCommandBuffer p_vkResetCommandBuffer;
     PFN_vkDestroySwapchainKHR p_vkDestroySwapchainKHR;
     PFN_vkEndCommandBuffer p_vkEndCommandBuffer;
     PFN_vkFreeMemory p_vkFreeMemory;
     PFN_vkGetImageMemoryRequirements p_vkGetImageMemoryRequirements;
     PFN_vkGetInstanceProcAddr p_vkGetInstanceProcAddr;
+    PFN_vkGetPhysicalDeviceFeatures2KHR p_vkGetPhysicalDeviceFeatures2KHR;
     PFN_vkGetPhysicalDeviceMemoryProperties p_vkGetPhysicalDeviceMemoryProperties;
     PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR p_vkGetPhysicalDeviceSurfaceCapabilitiesKHR;
     PFN_vkGetPhysicalDeviceSurfaceFormatsKHR p_vkGetPhysicalDeviceSurfaceFormatsKHR;
@@ -989,6 +1075,7 @@ struct dxgi_vk_funcs
     PFN_vkQueueWaitIdle p_vkQueueWaitIdle;
     PFN_vkResetFences p_vkResetFences;
     PFN_vkWaitForFences p_vkWaitForFences;
+    PFN_vkWaitForPresentKHR p_vkWaitForPresentKHR;
 
     void *vulkan_module;
 };
@@ -1078,6 +1165,10 @@ struct d3d12_swapchain
 
     uint64_t frame_number;
     uint32_t frame_latency;
+    /* The frame latency fence is signalled when presents are actually
+     * completed, using VK_KHR_present_wait. */
+    bool present_wait;
+    struct dxgi_frame_limiter frame_limiter;
 };
 
 enum d3d12_swapchain_op_type
@@ -1336,6 +1427,60 @@ static BOOL d3d12_swapchain_is_present_mode_supported(struct d3d12_swapchain *sw
     return supported;
 }
 
+/* vkd3d enables VK_KHR_present_id and VK_KHR_present_wait together, when
+ * both extensions and their features are supported. */
+static bool d3d12_swapchain_is_present_wait_supported(struct d3d12_swapchain *swapchain)
+{
+    VkPhysicalDevice vk_physical_device = swapchain->vk_physical_device;
+    const struct dxgi_vk_funcs *vk_funcs = &swapchain->vk_funcs;
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features;
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features;
+    VkPhysicalDeviceFeatures2 features2;
+    bool present_id = false, present_wait = false;
+    VkExtensionProperties *extensions;
+    uint32_t count, i;
+    VkResult vr;
+
+    if (!vk_funcs->p_vkWaitForPresentKHR || !vk_funcs->p_vkGetPhysicalDeviceFeatures2KHR)
+        return false;
+
+    if ((vr = vk_funcs->p_vkEnumerateDeviceExtensionProperties(vk_physical_device, NULL, &count, NULL)) < 0)
+    {
+        WARN("Failed to get device extension count, vr %d.\n", vr);
+        return false;
+    }
+    if (!(extensions = calloc(count, sizeof(*extensions))))
+        return false;
+    if ((vr = vk_funcs->p_vkEnumerateDeviceExtensionProperties(vk_physical_device, NULL, &count, extensions)) >= 0)
+    {
+        for (i = 0; i < count; ++i)
+        {
+            if (!strcmp(extensions[i].extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME))
+                present_id = true;
+            else if (!strcmp(extensions[i].extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+                present_wait = true;
+        }
+    }
+    else
+    {
+        WARN("Failed to get device extensions, vr %d.\n", vr);
+    }
+    free(extensions);
+
+    if (!present_id || !present_wait)
+        return false;
+
+    present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    present_wait_features.pNext = NULL;
+    present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.pNext = &present_wait_features;
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &present_id_features;
+    vk_funcs->p_vkGetPhysicalDeviceFeatures2KHR(vk_physical_device, &features2);
+
+    return present_id_features.presentId && present_wait_features.presentWait;
+}
+
 static HRESULT d3d12_swapchain_create_user_buffers(struct d3d12_swapchain *swapchain)
 {
     const struct dxgi_vk_funcs *vk_funcs = &swapchain->vk_funcs;
@@ -2077,9 +2222,12 @@ static HRESULT d3d12_swapchain_set_sync_interval(struct d3d12_swapchain *swapcha
 static VkResult d3d12_swapchain_queue_present(struct d3d12_swapchain *swapchain, VkImage vk_src_image,
         uint64_t frame_number)
 {
+    /* Present IDs must be non-zero. */
+    uint64_t frame_id = frame_number + 1;
     const struct dxgi_vk_funcs *vk_funcs = &swapchain->vk_funcs;
     VkPresentInfoKHR present_info;
     VkCommandBuffer vk_cmd_buffer;
+    VkPresentIdKHR present_id;
     VkSubmitInfo submit_info;
     VkImage vk_dst_image;
     VkQueue vk_queue;
@@ -2141,6 +2289,15 @@ static VkResult d3d12_swapchain_queue_present(struct d3d12_swapchain *swapchain,
     present_info.pImageIndices = &swapchain->vk_image_index;
     present_info.pResults = NULL;
 
+    if (swapchain->present_wait)
+    {
+        present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        present_id.pNext = NULL;
+        present_id.swapchainCount = 1;
+        present_id.pPresentIds = &frame_id;
+        present_info.pNext = &present_id;
+    }
+
     if ((vr = vk_funcs->p_vkQueuePresentKHR(vk_queue, &present_info)) >= 0)
         swapchain->vk_image_index = INVALID_VK_IMAGE_INDEX;
 
@@ -2182,8 +2339,25 @@ static HRESULT d3d12_swapchain_op_present_execute(struct d3d12_swapchain *swapch
          * account for the "++swapchain->frame_number" there. */
         uint64_t number = op->present.frame_number + DXGI_MAX_SWAP_CHAIN_BUFFERS + 1;
 
-        if (FAILED(hr = ID3D12CommandQueue_Signal(swapchain->command_queue,
-                swapchain->frame_latency_fence, number)))
+        if (swapchain->present_wait)
+        {
+            const struct dxgi_vk_funcs *vk_funcs = &swapchain->vk_funcs;
+
+            /* Waiting here also keeps at most one present queued on the
+             * Vulkan side. Don't let a lost present block the application
+             * forever though. */
+            if ((vr = vk_funcs->p_vkWaitForPresentKHR(swapchain->vk_device, swapchain->vk_swapchain,
+                    op->present.frame_number + 1, 100000000)) < 0)
+                WARN("Failed to wait for present, vr %d.\n", vr);
+
+            hr = ID3D12Fence_Signal(swapchain->frame_latency_fence, number);
+        }
+        else
+        {
+            hr = ID3D12CommandQueue_Signal(swapchain->command_queue, swapchain->frame_latency_fence, number);
+        }
+
+        if (FAILED(hr))
         {
             ERR("Failed to signal frame latency fence, hr %#lx.\n", hr);
             return hr;
@@ -2225,6 +2399,8 @@ static HRESULT d3d12_swapchain_present(struct d3d12_swapchain *swapchain,
     op->present.vk_image = swapchain->vk_images[swapchain->current_buffer_index];
     op->present.frame_number = swapchain->frame_number;
 
+    dxgi_frame_limiter_wait(&swapchain->frame_limiter);
+
     EnterCriticalSection(&swapchain->worker_cs);
     list_add_tail(&swapchain->worker_ops, &op->entry);
     WakeAllConditionVariable(&swapchain->worker_cv);
@@ -2244,6 +2420,18 @@ static HRESULT d3d12_swapchain_present(struct d3d12_swapchain *swapchain,
             return hr;
         }
     }
+    else if (swapchain->frame_latency_fence)
+    {
+        uint64_t number = swapchain->frame_number + DXGI_MAX_SWAP_CHAIN_BUFFERS;
+
+        /* Block until the number of queued frames is low enough. */
+        if (FAILED(hr = ID3D12Fence_SetEventOnCompletion(swapchain->frame_latency_fence,
+                number - swapchain->frame_latency, NULL)))
+        {
+            ERR("Failed to wait for frame latency fence, hr %#lx.\n", hr);
+            return hr;
+        }
+    }
 
     if (FAILED(hr = ID3D12CommandQueue_Signal(swapchain->command_queue,
             swapchain->present_fence, swapchain->frame_number)))
@@ -2984,6 +3172,7 @@ static BOOL init_vk_funcs(struct dxgi_vk_funcs *dxgi, VkInstance vk_instance, Vk
     }
     LOAD_INSTANCE_PFN(vkCreateWin32SurfaceKHR)
     LOAD_INSTANCE_PFN(vkDestroySurfaceKHR)
+    LOAD_INSTANCE_PFN(vkEnumerateDeviceExtensionProperties)
     LOAD_INSTANCE_PFN(vkGetPhysicalDeviceMemoryProperties)
     LOAD_INSTANCE_PFN(vkGetPhysicalDeviceSurfaceCapabilitiesKHR)
     LOAD_INSTANCE_PFN(vkGetPhysicalDeviceSurfaceFormatsKHR)
@@ -3028,6 +3217,10 @@ static BOOL init_vk_funcs(struct dxgi_vk_funcs *dxgi, VkInstance vk_instance, Vk
     LOAD_DEVICE_PFN(vkWaitForFences)
 #undef LOAD_DEVICE_PFN
 
+    dxgi->p_vkGetPhysicalDeviceFeatures2KHR = (void *)vkGetInstanceProcAddr(vk_instance,
+            "vkGetPhysicalDeviceFeatures2KHR");
+    dxgi->p_vkWaitForPresentKHR = (void *)vkGetDeviceProcAddr(vk_device, "vkWaitForPresentKHR");
+
     return TRUE;
 }
 
@@ -3236,10 +3429,16 @@ static HRESULT d3d12_swapchain_init(struct d3d12_swapchain *swapchain, IWineDXGI
 
     swapchain->current_buffer_index = 0;
 
+    dxgi_get_present_settings();
+    dxgi_frame_limiter_init(&swapchain->frame_limiter);
+
     if (swapchain_desc->Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
-    {
         swapchain->frame_latency = 1;
+    else
+        swapchain->frame_latency = dxgi_present_settings.max_frame_latency;
 
+    if (swapchain->frame_latency)
+    {
         if (FAILED(hr = ID3D12Device_CreateFence(device, DXGI_MAX_SWAP_CHAIN_BUFFERS,
                 0, &IID_ID3D12Fence, (void **)&swapchain->frame_latency_fence)))
         {
@@ -3248,6 +3447,12 @@ static HRESULT d3d12_swapchain_init(struct d3d12_swapchain *swapchain, IWineDXGI
             return hr;
         }
 
+        if ((swapchain->present_wait = d3d12_swapchain_is_present_wait_supported(swapchain)))
+            TRACE("Using VK_KHR_present_wait for frame latency.\n");
+    }
+
+    if (swapchain_desc->Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
+    {
         if (!(swapchain->frame_latency_event = CreateEventW(NULL, FALSE, TRUE, NULL)))
         {
             hr = HRESULT_FROM_WIN32(GetLastError());
@@ -811,6 +811,7 @@ static HRESULT init_script_cache(const HDC hdc, SCRIPT_CACHE *psc)
     LeaveCriticalSection(&cs_script_cache);
 
     if (!(sc = heap_alloc_zero(sizeof(ScriptCache)))) return E_OUTOFMEMORY;
+    list_init(&sc->shaped_runs);
     if (!GetTextMetricsW(hdc, &sc->tm))
     {
         heap_free(sc);
@@ -853,6 +854,126 @@ static HRESULT init_script_cache(const HDC hdc, SCRIPT_CACHE *psc)
     return S_OK;
 }
 
+/* Results of ScriptShapeOpenType() for runs shaped through the font tables, RichEdit
+ * and other editors shape the same visible lines on every repaint. */
+#define SHAPED_RUN_MAX_CHARS 256
+#define SHAPED_RUN_MAX_COUNT 256
+
+struct shaped_run
+{
+    struct list entry;
+    DWORD hash;
+    SCRIPT_ANALYSIS sa;
+    OPENTYPE_TAG script;
+    OPENTYPE_TAG lang;
+    int chars;
+    int max_glyphs;
+    int glyphs;
+    WORD *log_clust;
+    SCRIPT_CHARPROP *char_props;
+    WORD *out_glyphs;
+    SCRIPT_GLYPHPROP *glyph_props;
+    WCHAR text[1];
+};
+
+static DWORD hash_shaped_run(const SCRIPT_ANALYSIS *psa, const WCHAR *chars, int count)
+{
+    DWORD hash = 2166136261u;
+    int i;
+
+    hash = (hash ^ psa->eScript) * 16777619;
+    for (i = 0; i < count; i++) hash = (hash ^ chars[i]) * 16777619;
+    return hash;
+}
+
+static struct shaped_run *find_shaped_run(ScriptCache *sc, DWORD hash, const SCRIPT_ANALYSIS *psa,
+                                          OPENTYPE_TAG script, OPENTYPE_TAG lang,
+                                          const WCHAR *chars, int count, int max_glyphs)
+{
+    struct shaped_run *run;
+
+    LIST_FOR_EACH_ENTRY(run, &sc->shaped_runs, struct shaped_run, entry)
+    {
+        if (run->hash != hash || run->chars != count || run->max_glyphs != max_glyphs) continue;
+        if (run->script != script || run->lang != lang || memcmp(&run->sa, psa, sizeof(*psa))) continue;
+        if (!memcmp(run->text, chars, count * sizeof(*chars))) return run;
+    }
+    return NULL;
+}
+
+static BOOL get_shaped_run(ScriptCache *sc, const SCRIPT_ANALYSIS *psa, OPENTYPE_TAG script, OPENTYPE_TAG lang,
+                           const WCHAR *chars, int count, int max_glyphs, WORD *log_clust,
+                           SCRIPT_CHARPROP *char_props, WORD *out_glyphs, SCRIPT_GLYPHPROP *glyph_props,
+                           int *glyphs)
+{
+    struct shaped_run *run;
+
+    if (count > SHAPED_RUN_MAX_CHARS) return FALSE;
+
+    EnterCriticalSection(&cs_script_cache);
+    if ((run = find_shaped_run(sc, hash_shaped_run(psa, chars, count), psa, script, lang, chars, count, max_glyphs)))
+    {
+        memcpy(log_clust, run->log_clust, count * sizeof(*log_clust));
+        memcpy(char_props, run->char_props, count * sizeof(*char_props));
+        memcpy(out_glyphs, run->out_glyphs, run->glyphs * sizeof(*out_glyphs));
+        memcpy(glyph_props, run->glyph_props, max(count, run->glyphs) * sizeof(*glyph_props));
+        *glyphs = run->glyphs;
+
+        list_remove(&run->entry);
+        list_add_head(&sc->shaped_runs, &run->entry);
+    }
+    LeaveCriticalSection(&cs_script_cache);
+
+    return !!run;
+}
+
+static void add_shaped_run(ScriptCache *sc, const SCRIPT_ANALYSIS *psa, OPENTYPE_TAG script, OPENTYPE_TAG lang,
+                           const WCHAR *chars, int count, int max_glyphs, const WORD *log_clust,
+                           const SCRIPT_CHARPROP *char_props, const WORD *out_glyphs,
+                           const SCRIPT_GLYPHPROP *glyph_props, int glyphs)
+{
+    int props = max(count, glyphs);
+    struct shaped_run *run;
+    DWORD hash;
+
+    if (count > SHAPED_RUN_MAX_CHARS) return;
+    if (!(run = heap_alloc(FIELD_OFFSET(struct shaped_run, text[count]) + count * sizeof(*log_clust) +
+                           count * sizeof(*char_props) + glyphs * sizeof(*out_glyphs) +
+                           props * sizeof(*glyph_props))))
+        return;
+
+    run->hash = hash = hash_shaped_run(psa, chars, count);
+    run->sa = *psa;
+    run->script = script;
+    run->lang = lang;
+    run->chars = count;
+    run->max_glyphs = max_glyphs;
+    run->glyphs = glyphs;
+    memcpy(run->text, chars, count * sizeof(*chars));
+    run->log_clust = memcpy(run->text + count, log_clust, count * sizeof(*log_clust));
+    run->char_props = memcpy(run->log_clust + count, char_props, count * sizeof(*char_props));
+    run->out_glyphs = memcpy(run->char_props + count, out_glyphs, glyphs * sizeof(*out_glyphs));
+    run->glyph_props = memcpy(run->out_glyphs + glyphs, glyph_props, props * sizeof(*glyph_props));
+
+    EnterCriticalSection(&cs_script_cache);
+    if (find_shaped_run(sc, hash, psa, script, lang, chars, count, max_glyphs))
+    {
+        /* Another thread shaped the same run */
+        LeaveCriticalSection(&cs_script_cache);
+        heap_free(run);
+        return;
+    }
+    if (sc->shaped_run_count == SHAPED_RUN_MAX_COUNT)
+    {
+        struct shaped_run *old = LIST_ENTRY(list_tail(&sc->shaped_runs), struct shaped_run, entry);
+        list_remove(&old->entry);
+        heap_free(old);
+    }
+    else sc->shaped_run_count++;
+    list_add_head(&sc->shaped_runs, &run->entry);
+    LeaveCriticalSection(&cs_script_cache);
+}
+
 static WCHAR mirror_char( WCHAR ch )
 {
     extern const WCHAR wine_mirror_map[];
@@ -999,6 +1120,7 @@ HRESULT WINAPI ScriptFreeCache(SCRIPT_CACHE *psc)
 
     if (psc && *psc)
     {
+        struct shaped_run *run, *next_run;
         unsigned int i;
         INT n;
 
@@ -1045,6 +1167,8 @@ HRESULT WINAPI ScriptFreeCache(SCRIPT_CACHE *psc)
         }
         heap_free(((ScriptCache *)*psc)->scripts);
         heap_free(((ScriptCache *)*psc)->otm);
+        LIST_FOR_EACH_ENTRY_SAFE(run, next_run, &((ScriptCache *)*psc)->shaped_runs, struct shaped_run, entry)
+            heap_free(run);
         heap_free(*psc);
         *psc = NULL;
     }
@@ -3095,6 +3219,11 @@ HRESULT WINAPI ScriptShapeOpenType( HDC hdc, SCRIPT_CACHE *psc,
     if (psa && !psa->fNoGlyphIndex && ((ScriptCache *)*psc)->sfnt)
     {
         WCHAR *rChars;
+
+        if (get_shaped_run((ScriptCache *)*psc, psa, tagScript, tagLangSys, pwcChars, cChars, cMaxGlyphs,
+                           pwLogClust, pCharProps, pwOutGlyphs, pOutGlyphProps, pcGlyphs))
+            return S_OK;
+
         if ((hr = SHAPE_CheckFontForRequiredFeatures(hdc, (ScriptCache *)*psc, psa)) != S_OK) return hr;
 
         if (!(rChars = heap_calloc(cChars, sizeof(*rChars))))
@@ -3169,6 +3298,9 @@ HRESULT WINAPI ScriptShapeOpenType( HDC hdc, SCRIPT_CACHE *psc,
             }
         }
         heap_free(rChars);
+
+        add_shaped_run((ScriptCache *)*psc, psa, tagScript, tagLangSys, pwcChars, cChars, cMaxGlyphs,
+                       pwLogClust, pCharProps, pwOutGlyphs, pOutGlyphProps, *pcGlyphs);
     }
     else
     {
@@ -207,6 +207,9 @@ typedef struct {
 
     OPENTYPE_TAG userScript;
     OPENTYPE_TAG userLang;
+
+    struct list shaped_runs;
+    unsigned int shaped_run_count;
 } ScriptCache;
 
 typedef struct _scriptData
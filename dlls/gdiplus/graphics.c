@@ -410,6 +410,47 @@ static GpStatus get_clip_hrgn(GpGraphics *graphics, HRGN *hrgn)
     return stat;
 }
 
+/* Blend spans directly into 32bpp bitmaps, with the same results as going
+ * through GdipBitmapGetPixel() and GdipBitmapSetPixel(). */
+static void alpha_blend_bmp_pixels_32bpp(GpBitmap *dst_bitmap, INT dst_x, INT dst_y,
+    const BYTE *src, INT src_width, INT src_height, INT src_stride, PixelFormat fmt,
+    CompositingMode comp_mode)
+{
+    ARGB alpha_mask = dst_bitmap->format == PixelFormat32bppRGB ? 0xff000000 : 0;
+    INT x, y, start_x = 0, start_y = 0;
+
+    if (dst_x < 0) start_x = -dst_x;
+    if (dst_y < 0) start_y = -dst_y;
+    src_width = min(src_width, dst_bitmap->width - dst_x);
+    src_height = min(src_height, dst_bitmap->height - dst_y);
+
+    for (y = start_y; y < src_height; y++)
+    {
+        const ARGB *src_row = (const ARGB *)(src + src_stride * y);
+        ARGB *dst_row = (ARGB *)(dst_bitmap->bits + dst_bitmap->stride * (y + dst_y)) + dst_x;
+
+        for (x = start_x; x < src_width; x++)
+        {
+            ARGB src_color = src_row[x], dst_color;
+
+            if (!(src_color & 0xff000000))
+            {
+                if (comp_mode == CompositingModeSourceCopy) dst_row[x] = 0;
+                continue;
+            }
+
+            if (comp_mode == CompositingModeSourceCopy)
+                dst_color = src_color;
+            else if (fmt & PixelFormatPAlpha)
+                dst_color = color_over_fgpremult(dst_row[x] | alpha_mask, src_color);
+            else
+                dst_color = color_over(dst_row[x] | alpha_mask, src_color);
+
+            dst_row[x] = alpha_mask ? dst_color & 0xffffff : dst_color;
+        }
+    }
+}
+
 /* Draw ARGB data to the given graphics object */
 static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_y,
     const BYTE *src, INT src_width, INT src_height, INT src_stride, const PixelFormat fmt)
@@ -418,6 +459,13 @@ static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_
     INT x, y;
     CompositingMode comp_mode = graphics->compmode;
 
+    if (dst_bitmap->format == PixelFormat32bppARGB || dst_bitmap->format == PixelFormat32bppRGB)
+    {
+        alpha_blend_bmp_pixels_32bpp(dst_bitmap, dst_x, dst_y, src, src_width, src_height,
+            src_stride, fmt, comp_mode);
+        return Ok;
+    }
+
     for (y=0; y<src_height; y++)
     {
         for (x=0; x<src_width; x++)
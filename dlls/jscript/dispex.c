@@ -3223,6 +3223,18 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/* Same as jsdisp_get_id(), but first tries the id passed in, usually the one a previous
+ * lookup of the same name returned. Ids are never reused within an object. */
+HRESULT jsdisp_get_id_hint(jsdisp_t *jsdisp, const WCHAR *name, DISPID *id)
+{
+    dispex_prop_t *prop;
+
+    if((prop = get_prop(jsdisp, *id)) && !wcscmp(prop->name, name))
+        return S_OK;
+
+    return jsdisp_get_id(jsdisp, name, 0, id);
+}
+
 HRESULT jsdisp_get_idx_id(jsdisp_t *jsdisp, DWORD idx, DISPID *id)
 {
     WCHAR name[11];
@@ -1462,6 +1462,8 @@ static HRESULT interp_array(script_ctx_t *ctx)
 static HRESULT interp_member(script_ctx_t *ctx)
 {
     const BSTR arg = get_op_bstr(ctx, 0);
+    call_frame_t *frame = ctx->call_ctx;
+    jsdisp_t *jsdisp;
     IDispatch *obj;
     jsval_t v;
     DISPID id;
@@ -1473,7 +1475,14 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    /* the second argument caches the id found by the last lookup */
+    if((jsdisp = to_jsdisp(obj))) {
+        id = get_op_uint(ctx, 1);
+        hres = jsdisp_get_id_hint(jsdisp, arg, &id);
+        if(SUCCEEDED(hres))
+            frame->bytecode->instrs[frame->ip].u.arg[1].uint = id;
+    }else
+        hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
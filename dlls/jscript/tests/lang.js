@@ -2081,6 +2081,30 @@ function returnTest() {
 
 ok(returnTest() === undefined, "returnTest = " + returnTest());
 
+function getMemberX(o) {
+    return o.x;
+}
+
+(function() {
+    var proto = {x: "proto"}, a = {x: 1, y: 2}, b = {y: 3, x: 4}, c = Object.create(proto);
+
+    ok(getMemberX(a) === 1, "getMemberX(a) = " + getMemberX(a));
+    ok(getMemberX(b) === 4, "getMemberX(b) = " + getMemberX(b));
+    ok(getMemberX(a) === 1, "getMemberX(a) = " + getMemberX(a));
+    ok(getMemberX(c) === "proto", "getMemberX(c) = " + getMemberX(c));
+    c.x = "own";
+    ok(getMemberX(c) === "own", "getMemberX(c) = " + getMemberX(c));
+    delete c.x;
+    ok(getMemberX(c) === "proto", "getMemberX(c) = " + getMemberX(c));
+    delete proto.x;
+    ok(getMemberX(c) === undefined, "getMemberX(c) = " + getMemberX(c));
+    proto.x = "new proto";
+    ok(getMemberX(c) === "new proto", "getMemberX(c) = " + getMemberX(c));
+    delete a.x;
+    ok(getMemberX(a) === undefined, "getMemberX(a) = " + getMemberX(a));
+    ok(getMemberX({}) === undefined, "getMemberX({}) = " + getMemberX({}));
+})();
+
 ActiveXObject = 1;
 ok(ActiveXObject === 1, "ActiveXObject = " + ActiveXObject);
 
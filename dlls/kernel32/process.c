@@ -765,9 +765,13 @@ BOOL WINAPI GetFirmwareType(FIRMWARE_TYPE *type)
  */
 BOOL WINAPI GetNumaNodeProcessorMask(UCHAR node, PULONGLONG mask)
 {
-    FIXME("(%c %p): stub\n", node, mask);
-    SetLastError(ERROR_CALL_NOT_IMPLEMENTED);
-    return FALSE;
+    GROUP_AFFINITY affinity;
+
+    TRACE("(%u %p)\n", node, mask);
+
+    if (!GetNumaNodeProcessorMaskEx(node, &affinity)) return FALSE;
+    *mask = affinity.Group ? 0 : affinity.Mask;
+    return TRUE;
 }
 
 /**********************************************************************
@@ -799,7 +803,10 @@ BOOL WINAPI GetNumaProcessorNode(UCHAR processor, PUCHAR node)
 
     if (processor < system_info.NumberOfProcessors)
     {
-        *node = 0;
+        PROCESSOR_NUMBER number = { 0, processor };
+        USHORT node_number;
+
+        *node = GetNumaProcessorNodeEx(&number, &node_number) ? node_number : 0;
         return TRUE;
     }
 
@@ -813,7 +820,25 @@ BOOL WINAPI GetNumaProcessorNode(UCHAR processor, PUCHAR node)
  */
 BOOL WINAPI GetNumaProcessorNodeEx(PPROCESSOR_NUMBER processor, PUSHORT node_number)
 {
-    SetLastError(ERROR_CALL_NOT_IMPLEMENTED);
+    GROUP_AFFINITY affinity;
+    ULONG node, highest;
+
+    TRACE("(%p, %p)\n", processor, node_number);
+
+    if (processor->Number < sizeof(affinity.Mask) * 8 && GetNumaHighestNodeNumber(&highest))
+    {
+        for (node = 0; node <= highest; node++)
+        {
+            if (!GetNumaNodeProcessorMaskEx(node, &affinity)) continue;
+            if (affinity.Group != processor->Group) continue;
+            if (!(affinity.Mask & ((KAFFINITY)1 << processor->Number))) continue;
+            *node_number = node;
+            return TRUE;
+        }
+    }
+
+    *node_number = 0xffff;
+    SetLastError(ERROR_INVALID_PARAMETER);
     return FALSE;
 }
 
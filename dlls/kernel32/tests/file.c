@@ -1138,6 +1138,82 @@ static DWORD WINAPI copy_progress_cb(LARGE_INTEGER total_size, LARGE_INTEGER tot
     return PROGRESS_CANCEL;
 }
 
+struct copy_progress
+{
+    unsigned int  calls;
+    LARGE_INTEGER transferred;
+};
+
+static DWORD WINAPI copy_chunks_cb(LARGE_INTEGER total_size, LARGE_INTEGER total_transferred,
+                                   LARGE_INTEGER stream_size, LARGE_INTEGER stream_transferred,
+                                   DWORD stream, DWORD reason, HANDLE source, HANDLE dest, LPVOID userdata)
+{
+    struct copy_progress *progress = userdata;
+
+    if (!progress->calls++)
+        ok(reason == CALLBACK_STREAM_SWITCH, "expected CALLBACK_STREAM_SWITCH, got %lu\n", reason);
+    else
+        ok(reason == CALLBACK_CHUNK_FINISHED, "expected CALLBACK_CHUNK_FINISHED, got %lu\n", reason);
+    ok(stream == 1, "got stream %lu\n", stream);
+    ok(total_transferred.QuadPart >= progress->transferred.QuadPart, "transferred size went backwards\n");
+    ok(total_transferred.QuadPart <= total_size.QuadPart, "transferred %s of %s\n",
+       wine_dbgstr_longlong(total_transferred.QuadPart), wine_dbgstr_longlong(total_size.QuadPart));
+    progress->transferred = total_transferred;
+    return PROGRESS_CONTINUE;
+}
+
+static void test_CopyFileEx_progress(void)
+{
+    char temp_path[MAX_PATH], source[MAX_PATH], dest[MAX_PATH];
+    struct copy_progress progress = { 0 };
+    static const DWORD size = 300000;
+    DWORD ret, i, count;
+    char *buffer;
+    HANDLE hfile;
+    BOOL cancel;
+    BOOL retok;
+
+    GetTempPathA(MAX_PATH, temp_path);
+    GetTempFileNameA(temp_path, "pfx", 0, source);
+    GetTempFileNameA(temp_path, "pfx", 0, dest);
+
+    buffer = HeapAlloc(GetProcessHeap(), 0, size);
+    for (i = 0; i < size; i++) buffer[i] = i * 7;
+    hfile = CreateFileA(source, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, 0);
+    ok(hfile != INVALID_HANDLE_VALUE, "failed to create source file, error %ld\n", GetLastError());
+    retok = WriteFile(hfile, buffer, size, &count, NULL);
+    ok(retok && count == size, "WriteFile failed, error %ld\n", GetLastError());
+    CloseHandle(hfile);
+
+    retok = CopyFileExA(source, dest, copy_chunks_cb, &progress, NULL, 0);
+    ok(retok, "CopyFileExA failed, error %ld\n", GetLastError());
+    ok(progress.calls >= 2, "got %u calls\n", progress.calls);
+    ok(progress.transferred.QuadPart == size, "got %s transferred\n",
+       wine_dbgstr_longlong(progress.transferred.QuadPart));
+
+    hfile = CreateFileA(dest, GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, 0);
+    ok(hfile != INVALID_HANDLE_VALUE, "failed to open destination file, error %ld\n", GetLastError());
+    ok(GetFileSize(hfile, NULL) == size, "got size %lu\n", GetFileSize(hfile, NULL));
+    memset(buffer, 0, size);
+    retok = ReadFile(hfile, buffer, size, &count, NULL);
+    ok(retok && count == size, "ReadFile failed, error %ld\n", GetLastError());
+    for (i = 0; i < size; i++) if (buffer[i] != (char)(i * 7)) break;
+    ok(i == size, "data differs at %lu\n", i);
+    CloseHandle(hfile);
+
+    /* a cancel flag set before the copy aborts it */
+    cancel = TRUE;
+    SetLastError(0xdeadbeef);
+    retok = CopyFileExA(source, dest, NULL, NULL, &cancel, 0);
+    ok(!retok, "CopyFileExA unexpectedly succeeded\n");
+    ok(GetLastError() == ERROR_REQUEST_ABORTED, "expected ERROR_REQUEST_ABORTED, got %ld\n", GetLastError());
+
+    HeapFree(GetProcessHeap(), 0, buffer);
+    ret = DeleteFileA(source);
+    ok(ret, "DeleteFileA failed with error %ld\n", GetLastError());
+    DeleteFileA(dest);
+}
+
 static void test_CopyFileEx(void)
 {
     char temp_path[MAX_PATH];
@@ -1161,23 +1237,17 @@ static void test_CopyFileEx(void)
     ok(hfile != INVALID_HANDLE_VALUE, "failed to open destination file, error %ld\n", GetLastError());
     SetLastError(0xdeadbeef);
     retok = CopyFileExA(source, dest, copy_progress_cb, hfile, NULL, 0);
-    todo_wine
     ok(!retok, "CopyFileExA unexpectedly succeeded\n");
-    todo_wine
     ok(GetLastError() == ERROR_REQUEST_ABORTED, "expected ERROR_REQUEST_ABORTED, got %ld\n", GetLastError());
     ok(GetFileAttributesA(dest) != INVALID_FILE_ATTRIBUTES, "file was deleted\n");
 
     hfile = CreateFileA(dest, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_WRITE | FILE_SHARE_DELETE,
                         NULL, OPEN_EXISTING, 0, 0);
-    todo_wine
     ok(hfile != INVALID_HANDLE_VALUE, "failed to open destination file, error %ld\n", GetLastError());
     SetLastError(0xdeadbeef);
     retok = CopyFileExA(source, dest, copy_progress_cb, hfile, NULL, 0);
-    todo_wine
     ok(!retok, "CopyFileExA unexpectedly succeeded\n");
-    todo_wine
     ok(GetLastError() == ERROR_REQUEST_ABORTED, "expected ERROR_REQUEST_ABORTED, got %ld\n", GetLastError());
-    todo_wine
     ok(GetFileAttributesA(dest) == INVALID_FILE_ATTRIBUTES, "file was not deleted\n");
 
     retok = CopyFileExA(source, NULL, copy_progress_cb, hfile, NULL, 0);
@@ -2359,6 +2429,57 @@ cleanup:
     DeleteFileA( filename );
 }
 
+static void test_many_locks(void)
+{
+    static const DWORD count = 2000;
+    HANDLE handle, handle2;
+    DWORD i;
+    BOOL ret;
+
+    handle = CreateFileA( filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                          NULL, CREATE_ALWAYS, 0, 0 );
+    ok( handle != INVALID_HANDLE_VALUE, "couldn't create file \"%s\" (err=%ld)\n", filename, GetLastError() );
+    handle2 = CreateFileA( filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL, OPEN_EXISTING, 0, 0 );
+    ok( handle2 != INVALID_HANDLE_VALUE, "couldn't open file \"%s\" (err=%ld)\n", filename, GetLastError() );
+
+    /* lock every other pair of bytes, in an order that isn't sorted */
+    for (i = 0; i < count; i++)
+    {
+        DWORD pos = ((i * 7919) % count) * 4;
+        ret = LockFile( handle, pos, 0, 2, 0 );
+        ok( ret, "LockFile %lu failed\n", pos );
+    }
+    ok( !LockFile( handle2, 10 * 4 + 1, 0, 1, 0 ), "locked byte could be locked\n" );
+    ok( !LockFile( handle2, 10 * 4 - 1, 0, 2, 0 ), "overlapping range could be locked\n" );
+    ok( LockFile( handle2, 10 * 4 + 2, 0, 2, 0 ), "unlocked range couldn't be locked\n" );
+    ok( !LockFile( handle2, 0, 0, count * 4, 0 ), "whole range could be locked\n" );
+    ok( UnlockFile( handle2, 10 * 4 + 2, 0, 2, 0 ), "UnlockFile failed\n" );
+
+    /* unlock half of them and check that the holes became available */
+    for (i = 0; i < count; i += 2)
+    {
+        ret = UnlockFile( handle, i * 4, 0, 2, 0 );
+        ok( ret, "UnlockFile %lu failed\n", i * 4 );
+    }
+    ok( !UnlockFile( handle, 0, 0, 2, 0 ), "range was unlocked twice\n" );
+    ok( LockFile( handle2, 0, 0, 3, 0 ), "unlocked range couldn't be locked\n" );
+    ok( !LockFile( handle2, 4, 0, 1, 0 ), "locked byte could be locked\n" );
+    ok( UnlockFile( handle2, 0, 0, 3, 0 ), "UnlockFile failed\n" );
+
+    for (i = 1; i < count; i += 2)
+    {
+        ret = UnlockFile( handle, i * 4, 0, 2, 0 );
+        ok( ret, "UnlockFile %lu failed\n", i * 4 );
+    }
+    ok( LockFile( handle2, 0, 0, count * 4, 0 ), "whole range couldn't be locked\n" );
+    ok( UnlockFile( handle2, 0, 0, count * 4, 0 ), "UnlockFile failed\n" );
+
+    CloseHandle( handle2 );
+    CloseHandle( handle );
+    DeleteFileA( filename );
+}
+
 static BOOL create_fake_dll( LPCSTR filename )
 {
     IMAGE_DOS_HEADER *dos;
@@ -6014,6 +6135,80 @@ static void test_move_file(void)
     SetCurrentDirectoryA( cwd );
 }
 
+static void test_case_insensitive_lookup(void)
+{
+    char cwd[MAX_PATH], temp_dir[MAX_PATH], name[MAX_PATH];
+    unsigned int i;
+    DWORD attrs;
+    BOOL ret;
+
+    GetCurrentDirectoryA( sizeof(cwd), cwd );
+    GetTempPathA( sizeof(temp_dir), temp_dir );
+    SetCurrentDirectoryA( temp_dir );
+
+    ret = CreateDirectoryA( "winetest_case", NULL );
+    ok(ret, "failed to create directory, error %lu\n", GetLastError());
+    for (i = 0; i < 64; i++)
+    {
+        sprintf( name, "winetest_case\\LongName%04u.Data", i );
+        create_file( name );
+    }
+
+    attrs = GetFileAttributesA( "winetest_case\\longname0010.data" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "winetest_case\\LONGNAME0063.DATA" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "winetest_case\\longname0064.data" );
+    ok(attrs == INVALID_FILE_ATTRIBUTES, "got %#lx\n", attrs);
+
+    /* changes to the directory are seen right away */
+    create_file( "winetest_case\\NewLongName.Data" );
+    attrs = GetFileAttributesA( "winetest_case\\newlongname.data" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+
+    ret = DeleteFileA( "winetest_case\\longname0001.DATA" );
+    ok(ret, "failed to delete file, error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "winetest_case\\LongName0001.data" );
+    ok(attrs == INVALID_FILE_ATTRIBUTES, "got %#lx\n", attrs);
+
+    ret = MoveFileA( "winetest_case\\LongName0002.Data", "winetest_case\\MovedLongName.Data" );
+    ok(ret, "failed to move file, error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "winetest_case\\longname0002.data" );
+    ok(attrs == INVALID_FILE_ATTRIBUTES, "got %#lx\n", attrs);
+    attrs = GetFileAttributesA( "winetest_case\\MOVEDLONGNAME.DATA" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+
+    /* parent directories resolved through a different case */
+    ret = CreateDirectoryA( "winetest_case\\SubDir", NULL );
+    ok(ret, "failed to create directory, error %lu\n", GetLastError());
+    create_file( "winetest_case\\SubDir\\File.Txt" );
+    attrs = GetFileAttributesA( "WINETEST_CASE\\subdir\\file.txt" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "WINETEST_CASE\\SUBDIR\\FILE.TXT" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+    ret = MoveFileA( "winetest_case\\subdir", "winetest_case\\OtherDir" );
+    ok(ret, "failed to move directory, error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "WINETEST_CASE\\subdir\\file.txt" );
+    ok(attrs == INVALID_FILE_ATTRIBUTES, "got %#lx\n", attrs);
+    ok(GetLastError() == ERROR_PATH_NOT_FOUND, "got error %lu\n", GetLastError());
+    attrs = GetFileAttributesA( "WINETEST_CASE\\otherdir\\file.txt" );
+    ok(attrs != INVALID_FILE_ATTRIBUTES, "got error %lu\n", GetLastError());
+    DeleteFileA( "winetest_case\\OtherDir\\File.Txt" );
+    RemoveDirectoryA( "winetest_case\\OtherDir" );
+
+    for (i = 0; i < 64; i++)
+    {
+        sprintf( name, "winetest_case\\LongName%04u.Data", i );
+        DeleteFileA( name );
+    }
+    DeleteFileA( "winetest_case\\NewLongName.Data" );
+    DeleteFileA( "winetest_case\\MovedLongName.Data" );
+    ret = RemoveDirectoryA( "winetest_case" );
+    ok(ret, "failed to remove directory, error %lu\n", GetLastError());
+
+    SetCurrentDirectoryA( cwd );
+}
+
 static void test_eof(void)
 {
     char temp_path[MAX_PATH], filename[MAX_PATH], buffer[20];
@@ -6244,6 +6439,7 @@ START_TEST(file)
     test_CopyFileW();
     test_CopyFile2();
     test_CopyFileEx();
+    test_CopyFileEx_progress();
     test_CreateFile();
     test_CreateFileA();
     test_CreateFileW();
@@ -6265,6 +6461,7 @@ START_TEST(file)
     test_FindFirstFileExA(FindExInfoStandard, FindExSearchLimitToDirectories, FIND_FIRST_EX_LARGE_FETCH);
     test_FindFirstFileExA(FindExInfoBasic, FindExSearchLimitToDirectories, 0);
     test_LockFile();
+    test_many_locks();
     test_file_sharing();
     test_offset_in_overlapped_structure();
     test_MapFile();
@@ -6294,5 +6491,6 @@ START_TEST(file)
     test_ReOpenFile();
     test_hard_link();
     test_move_file();
+    test_case_insensitive_lookup();
     test_eof();
 }
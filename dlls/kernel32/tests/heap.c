@@ -3727,6 +3727,113 @@ static void test_heap_sizes(void)
     test_heap_size( 0x150000 );
 }
 
+struct heap_stress_params
+{
+    HANDLE heap;
+    HANDLE start_event;
+    void **shared;
+};
+
+static DWORD WINAPI heap_stress_thread( void *arg )
+{
+    struct heap_stress_params *params = arg;
+    void *ptrs[64], *ptr;
+    UINT i, j, fail = 0;
+    BOOL ret;
+
+    WaitForSingleObject( params->start_event, INFINITE );
+
+    for (i = 0; i < 2000; ++i)
+    {
+        for (j = 0; j < ARRAY_SIZE(ptrs); ++j)
+            if (!(ptrs[j] = HeapAlloc( params->heap, 0, 8 + (j % 8) * 16 ))) fail++;
+
+        /* hand one block over to another thread and free the one we got, if any */
+        ptr = InterlockedExchangePointer( params->shared, ptrs[0] );
+        if (ptr && !HeapFree( params->heap, 0, ptr )) fail++;
+
+        for (j = 1; j < ARRAY_SIZE(ptrs); ++j)
+            if (!HeapFree( params->heap, 0, ptrs[j] )) fail++;
+    }
+
+    ok( !fail, "got %u failures\n", fail );
+
+    ptr = InterlockedExchangePointer( params->shared, NULL );
+    ret = !ptr || HeapFree( params->heap, 0, ptr );
+    ok( ret, "HeapFree failed, error %lu\n", GetLastError() );
+
+    return 0;
+}
+
+static void test_heap_threads(void)
+{
+    struct heap_stress_params params[4];
+    HANDLE threads[4], heap, start_event;
+    WINE_HEAP_STATISTICS *stats;
+    void *shared = NULL;
+    ULONG compat_info = 2;
+    SIZE_T size;
+    DWORD ticks, res;
+    UINT i;
+    BOOL ret;
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( !!heap, "HeapCreate failed, error %lu\n", GetLastError() );
+    ret = pHeapSetInformation( heap, HeapCompatibilityInformation, &compat_info, sizeof(compat_info) );
+    ok( ret, "HeapSetInformation failed, error %lu\n", GetLastError() );
+
+    start_event = CreateEventW( NULL, TRUE, FALSE, NULL );
+    ok( !!start_event, "CreateEventW failed, error %lu\n", GetLastError() );
+
+    for (i = 0; i < ARRAY_SIZE(threads); ++i)
+    {
+        params[i].heap = heap;
+        params[i].start_event = start_event;
+        params[i].shared = &shared;
+        threads[i] = CreateThread( NULL, 0, heap_stress_thread, &params[i], 0, NULL );
+        ok( !!threads[i], "CreateThread failed, error %lu\n", GetLastError() );
+    }
+
+    ticks = GetTickCount();
+    SetEvent( start_event );
+    res = WaitForMultipleObjects( ARRAY_SIZE(threads), threads, TRUE, 60000 );
+    ok( !res, "WaitForMultipleObjects returned %#lx, error %lu\n", res, GetLastError() );
+    trace( "%u threads alloc/free took %lu ms\n", (UINT)ARRAY_SIZE(threads), GetTickCount() - ticks );
+
+    for (i = 0; i < ARRAY_SIZE(threads); ++i) CloseHandle( threads[i] );
+    CloseHandle( start_event );
+
+    ret = HeapValidate( heap, 0, NULL );
+    ok( ret, "HeapValidate failed\n" );
+
+    size = 0;
+    ret = pHeapQueryInformation( heap, HeapWineStatistics, NULL, 0, &size );
+    if (!ret && GetLastError() == ERROR_INVALID_PARAMETER) win_skip( "HeapWineStatistics not supported\n" );
+    else
+    {
+        ok( !ret, "HeapQueryInformation succeeded\n" );
+        ok( GetLastError() == ERROR_INSUFFICIENT_BUFFER, "got error %lu\n", GetLastError() );
+        ok( size >= sizeof(*stats), "got size %Iu\n", size );
+
+        stats = HeapAlloc( GetProcessHeap(), 0, size );
+        ret = pHeapQueryInformation( heap, HeapWineStatistics, stats, size, &size );
+        ok( ret, "HeapQueryInformation failed, error %lu\n", GetLastError() );
+        ok( size == offsetof( WINE_HEAP_STATISTICS, Bins[stats->BinCount] ), "got size %Iu\n", size );
+        ok( stats->CommittedSize >= stats->UsedSize, "committed %#Ix, used %#Ix\n",
+            stats->CommittedSize, stats->UsedSize );
+        ok( stats->SubheapCount >= 1, "got SubheapCount %lu\n", stats->SubheapCount );
+        ok( stats->LfhAllocCount + stats->AllocCount >= ARRAY_SIZE(threads) * 2000 * 64,
+            "got AllocCount %I64u, LfhAllocCount %I64u\n", stats->AllocCount, stats->LfhAllocCount );
+        ok( stats->LfhAllocCount > 0, "got LfhAllocCount %I64u\n", stats->LfhAllocCount );
+        trace( "committed %#Ix, used %#Ix, free %#Ix, LFH hit rate %I64u%%\n", stats->CommittedSize,
+               stats->UsedSize, stats->FreeSize, stats->LfhAllocCount * 100 / (stats->AllocCount + stats->LfhAllocCount) );
+        HeapFree( GetProcessHeap(), 0, stats );
+    }
+
+    ret = HeapDestroy( heap );
+    ok( ret, "HeapDestroy failed, error %lu\n", GetLastError() );
+}
+
 START_TEST(heap)
 {
     int argc;
@@ -3764,4 +3871,5 @@ START_TEST(heap)
     }
     else win_skip( "RtlGetNtGlobalFlags not found, skipping heap debug tests\n" );
     test_heap_sizes();
+    test_heap_threads();
 }
@@ -3863,6 +3863,64 @@ static void test_GetNumaProcessorNode(void)
     }
 }
 
+static void test_GetNumaNodeProcessorMask(void)
+{
+    PROCESSOR_NUMBER number;
+    GROUP_AFFINITY affinity;
+    ULONGLONG mask, all = 0;
+    ULONG highest, i;
+    USHORT node;
+    SYSTEM_INFO si;
+    BOOL ret;
+    void *ptr;
+
+    ret = GetNumaHighestNodeNumber(&highest);
+    ok(ret, "GetNumaHighestNodeNumber failed, error %lu\n", GetLastError());
+
+    for (i = 0; i <= highest; i++)
+    {
+        ret = GetNumaNodeProcessorMaskEx(i, &affinity);
+        if (!ret) continue;  /* node numbers may have holes */
+        ret = GetNumaNodeProcessorMask(i, &mask);
+        ok(ret, "GetNumaNodeProcessorMask failed for node %lu, error %lu\n", i, GetLastError());
+        if (!affinity.Group)
+        {
+            ok(mask == affinity.Mask, "node %lu: got mask %I64x, expected %Ix\n", i, mask, affinity.Mask);
+            ok(!(all & mask), "node %lu: mask %I64x overlaps other nodes\n", i, mask);
+            all |= mask;
+        }
+    }
+
+    SetLastError(0xdeadbeef);
+    ret = GetNumaNodeProcessorMaskEx(highest + 1, &affinity);
+    ok(!ret, "GetNumaNodeProcessorMaskEx succeeded for node %lu\n", highest + 1);
+    ok(GetLastError() == ERROR_INVALID_PARAMETER, "got error %lu\n", GetLastError());
+
+    GetSystemInfo(&si);
+    for (i = 0; i < min(si.dwNumberOfProcessors, 64); i++)
+    {
+        number.Group = 0;
+        number.Number = i;
+        number.Reserved = 0;
+        ret = GetNumaProcessorNodeEx(&number, &node);
+        ok(ret, "GetNumaProcessorNodeEx failed for processor %lu, error %lu\n", i, GetLastError());
+        if (!ret) continue;
+        ok(node <= highest, "processor %lu: got node %u, highest %lu\n", i, node, highest);
+        ret = GetNumaNodeProcessorMaskEx(node, &affinity);
+        ok(ret && (affinity.Mask & ((KAFFINITY)1 << i)), "processor %lu is not in the mask of node %u\n", i, node);
+    }
+
+    for (i = 0; i <= highest; i++)
+    {
+        if (!GetNumaNodeProcessorMaskEx(i, &affinity)) continue;
+        ptr = VirtualAllocExNuma(GetCurrentProcess(), NULL, 0x10000, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, i);
+        ok(ptr != NULL, "VirtualAllocExNuma failed for node %lu, error %lu\n", i, GetLastError());
+        if (!ptr) continue;
+        memset(ptr, 0x55, 0x10000);
+        VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+}
+
 static void test_session_info(void)
 {
     DWORD session_id, active_session;
@@ -5460,6 +5518,7 @@ START_TEST(process)
     test_DuplicateHandle();
     test_StdHandleInheritance();
     test_GetNumaProcessorNode();
+    test_GetNumaNodeProcessorMask();
     test_session_info();
     test_GetLogicalProcessorInformationEx();
     test_GetSystemCpuSetInformation();
@@ -2388,6 +2388,60 @@ static void test_write_watch(void)
     VirtualFree( base, 0, MEM_RELEASE );
 }
 
+static void test_write_watch_large(void)
+{
+    SIZE_T size = (SIZE_T)4 << 30, chunk = 0x10000, i;
+    ULONG_PTR count, written = 0;
+    LARGE_INTEGER start, end, freq;
+    void **results;
+    ULONG pagesize;
+    DWORD ret;
+    char *base;
+
+    if (sizeof(void *) < 8 || !pGetWriteWatch)
+    {
+        skip( "large write watch test needs 64-bit GetWriteWatch\n" );
+        return;
+    }
+
+    base = VirtualAlloc( 0, size, MEM_RESERVE | MEM_WRITE_WATCH, PAGE_READWRITE );
+    if (!base)
+    {
+        skip( "could not reserve %#Ix bytes, error %lu\n", size, GetLastError() );
+        return;
+    }
+
+    /* commit and dirty a sparse set of chunks spread over the whole range */
+    for (i = 0; i < size; i += size / 64)
+    {
+        ok( VirtualAlloc( base + i, chunk, MEM_COMMIT, PAGE_READWRITE ) == base + i,
+            "VirtualAlloc failed %lu\n", GetLastError() );
+        memset( base + i, 0xcc, chunk / 2 );
+        written += chunk / 2 / si.dwPageSize;
+    }
+
+    results = HeapAlloc( GetProcessHeap(), 0, written * 2 * sizeof(*results) );
+
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &start );
+    count = written * 2;
+    ret = pGetWriteWatch( WRITE_WATCH_FLAG_RESET, base, size, results, &count, &pagesize );
+    QueryPerformanceCounter( &end );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == written, "got count %Iu, expected %Iu\n", count, written );
+    ok( results[0] == base, "got first address %p, expected %p\n", results[0], base );
+    trace( "GetWriteWatch over %#Ix bytes took %lu us\n", size,
+           (DWORD)((end.QuadPart - start.QuadPart) * 1000000 / freq.QuadPart) );
+
+    count = written * 2;
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( !count, "got count %Iu\n", count );
+
+    HeapFree( GetProcessHeap(), 0, results );
+    VirtualFree( base, 0, MEM_RELEASE );
+}
+
 #if defined(__i386__) || defined(__x86_64__)
 
 static DWORD WINAPI stack_commit_func( void *arg )
@@ -4466,6 +4520,53 @@ static void test_shared_memory_ro(BOOL is_child, DWORD child_access)
     CloseHandle(mapping);
 }
 
+static void test_large_pages(void)
+{
+    SIZE_T size = GetLargePageMinimum();
+    MEMORY_BASIC_INFORMATION info;
+    void *addr;
+    BOOL ret;
+
+    if (!size)
+    {
+        skip( "large pages not supported\n" );
+        return;
+    }
+
+    SetLastError( 0xdeadbeef );
+    addr = VirtualAlloc( NULL, size, MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE );
+    ok( !addr, "VirtualAlloc succeeded\n" );
+    ok( GetLastError() == ERROR_INVALID_PARAMETER || broken(GetLastError() == ERROR_PRIVILEGE_NOT_HELD),
+        "got error %lu\n", GetLastError() );
+
+    SetLastError( 0xdeadbeef );
+    addr = VirtualAlloc( NULL, size + si.dwPageSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+    ok( !addr, "VirtualAlloc succeeded\n" );
+    ok( GetLastError() == ERROR_INVALID_PARAMETER || broken(GetLastError() == ERROR_PRIVILEGE_NOT_HELD),
+        "got error %lu\n", GetLastError() );
+
+    SetLastError( 0xdeadbeef );
+    addr = VirtualAlloc( NULL, 2 * size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+    if (!addr && GetLastError() == ERROR_PRIVILEGE_NOT_HELD)
+    {
+        win_skip( "SeLockMemoryPrivilege not held\n" );
+        return;
+    }
+    ok( !!addr, "VirtualAlloc failed, error %lu\n", GetLastError() );
+    ok( !((UINT_PTR)addr & (size - 1)), "got unaligned address %p\n", addr );
+
+    memset( &info, 0, sizeof(info) );
+    VirtualQuery( addr, &info, sizeof(info) );
+    ok( info.AllocationBase == addr, "got AllocationBase %p\n", info.AllocationBase );
+    ok( info.RegionSize == 2 * size, "got RegionSize %#Ix\n", info.RegionSize );
+    ok( info.State == MEM_COMMIT, "got State %#lx\n", info.State );
+    ok( info.Protect == PAGE_READWRITE, "got Protect %#lx\n", info.Protect );
+    memset( addr, 0xcc, 2 * size );
+
+    ret = VirtualFree( addr, 0, MEM_RELEASE );
+    ok( ret, "VirtualFree failed, error %lu\n", GetLastError() );
+}
+
 static void test_PrefetchVirtualMemory(void)
 {
     WIN32_MEMORY_RANGE_ENTRY entries[2];
@@ -4590,7 +4691,9 @@ START_TEST(virtual)
     test_IsBadWritePtr();
     test_IsBadCodePtr();
     test_write_watch();
+    test_write_watch_large();
     test_PrefetchVirtualMemory();
+    test_large_pages();
 #if defined(__i386__) || defined(__x86_64__)
     test_stack_commit();
 #endif
@@ -487,25 +487,75 @@ BOOL WINAPI DECLSPEC_HOTPATCH AreFileApisANSI(void)
     return !oem_file_apis;
 }
 
+/* state of a file copy, for the progress routine */
+struct copy_state
+{
+    LPPROGRESS_ROUTINE progress;
+    void              *param;
+    BOOL              *cancel;
+    HANDLE             source;
+    HANDLE             dest;
+    LARGE_INTEGER      size;
+    LARGE_INTEGER      done;
+    DWORD              result;
+};
+
+/* size of the ranges duplicated at once, so that progress is reported regularly */
+#define COPY_EXTENTS_CHUNK_SIZE (64 * 1024 * 1024)
+
+/******************************************************************************
+ *  report_copy_progress
+ *
+ * Returns FALSE if the copy has to be aborted.
+ */
+static BOOL report_copy_progress( struct copy_state *state, DWORD reason )
+{
+    if (state->cancel && *state->cancel)
+    {
+        state->result = PROGRESS_CANCEL;
+        return FALSE;
+    }
+    if (!state->progress) return TRUE;
+
+    state->result = state->progress( state->size, state->done, state->size, state->done, 1, reason,
+                                     state->source, state->dest, state->param );
+    switch (state->result)
+    {
+    case PROGRESS_QUIET:
+        state->progress = NULL;
+        return TRUE;
+    case PROGRESS_CONTINUE:
+        return TRUE;
+    case PROGRESS_CANCEL:
+    case PROGRESS_STOP:
+        return FALSE;
+    default:
+        FIXME( "unhandled progress result %lu\n", state->result );
+        return TRUE;
+    }
+}
+
 /******************************************************************************
  *  copy_file
  */
-static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDED_PARAMETERS *params )
+static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDED_PARAMETERS *params,
+                       LPPROGRESS_ROUTINE progress_routine, void *progress_param )
 {
     DWORD flags = params ? params->dwCopyFlags : 0;
-    BOOL *cancel_ptr = params ? params->pfCancel : NULL;
     PCOPYFILE2_PROGRESS_ROUTINE progress = params ? params->pProgressRoutine : NULL;
 
     static const int buffer_size = 65536;
+    struct copy_state state = { progress_routine, progress_param, params ? params->pfCancel : NULL };
+    DUPLICATE_EXTENTS_DATA extents;
+    FILE_STANDARD_INFORMATION std;
+    FILE_DISPOSITION_INFORMATION disp;
     HANDLE h1, h2;
     FILE_BASIC_INFORMATION info;
     IO_STATUS_BLOCK io;
-    DWORD count;
+    DWORD count, access;
     BOOL ret = FALSE;
     char *buffer;
 
-    if (cancel_ptr)
-        FIXME("pfCancel is not supported\n");
     if (progress)
         FIXME("PCOPYFILE2_PROGRESS_ROUTINE is not supported\n");
 
@@ -563,9 +613,19 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
         }
     }
 
-    if ((h2 = CreateFileW( dest, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
-                           (flags & COPY_FILE_FAIL_IF_EXISTS) ? CREATE_NEW : CREATE_ALWAYS,
-                           info.FileAttributes, h1 )) == INVALID_HANDLE_VALUE)
+    /* the destination is deleted if the copy is cancelled, when other opens allow it */
+    access = GENERIC_WRITE;
+    if (state.progress || state.cancel) access |= DELETE;
+    for (;;)
+    {
+        h2 = CreateFileW( dest, access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                          (flags & COPY_FILE_FAIL_IF_EXISTS) ? CREATE_NEW : CREATE_ALWAYS,
+                          info.FileAttributes, h1 );
+        if (h2 != INVALID_HANDLE_VALUE || !(access & DELETE)) break;
+        if (GetLastError() != ERROR_SHARING_VIOLATION && GetLastError() != ERROR_ACCESS_DENIED) break;
+        access &= ~DELETE;
+    }
+    if (h2 == INVALID_HANDLE_VALUE)
     {
         WARN("Unable to open dest %s\n", debugstr_w(dest));
         HeapFree( GetProcessHeap(), 0, buffer );
@@ -573,9 +633,35 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
         return FALSE;
     }
 
+    state.source = h1;
+    state.dest = h2;
+    if (!NtQueryInformationFile( h1, &io, &std, sizeof(std), FileStandardInformation ))
+        state.size = std.EndOfFile;
+    if (!report_copy_progress( &state, CALLBACK_STREAM_SWITCH )) goto done;
+
+    /* let the filesystem share or copy the data without going through our buffer */
+    while (state.done.QuadPart < state.size.QuadPart)
+    {
+        extents.FileHandle = h1;
+        extents.SourceFileOffset = state.done;
+        extents.TargetFileOffset = state.done;
+        extents.ByteCount.QuadPart = min( state.size.QuadPart - state.done.QuadPart, COPY_EXTENTS_CHUNK_SIZE );
+        if (NtFsControlFile( h2, NULL, NULL, NULL, &io, FSCTL_DUPLICATE_EXTENTS_TO_FILE,
+                             &extents, sizeof(extents), NULL, 0 ))
+            break;
+        state.done.QuadPart += extents.ByteCount.QuadPart;
+        if (!report_copy_progress( &state, CALLBACK_CHUNK_FINISHED )) goto done;
+    }
+    if (state.done.QuadPart &&
+        (!SetFilePointerEx( h1, state.done, NULL, FILE_BEGIN ) ||
+         !SetFilePointerEx( h2, state.done, NULL, FILE_BEGIN )))
+        goto done;
+
     while (ReadFile( h1, buffer, buffer_size, &count, NULL ) && count)
     {
         char *p = buffer;
+        state.done.QuadPart += count;
+        if (state.done.QuadPart > state.size.QuadPart) state.size = state.done;
         while (count != 0)
         {
             DWORD res;
@@ -583,16 +669,24 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
             p += res;
             count -= res;
         }
+        if (!report_copy_progress( &state, CALLBACK_CHUNK_FINISHED )) goto done;
     }
     ret = TRUE;
 done:
     /* Maintain the timestamp of source file to destination file */
     info.FileAttributes = 0;
     NtSetInformationFile( h2, &io, &info, sizeof(info), FileBasicInformation );
+    if (!ret && state.result == PROGRESS_CANCEL && (access & DELETE))
+    {
+        disp.DoDeleteFile = TRUE;
+        NtSetInformationFile( h2, &io, &disp, sizeof(disp), FileDispositionInformation );
+    }
     HeapFree( GetProcessHeap(), 0, buffer );
     CloseHandle( h1 );
     CloseHandle( h2 );
     if (ret) SetLastError( 0 );
+    else if (state.result == PROGRESS_CANCEL || state.result == PROGRESS_STOP)
+        SetLastError( ERROR_REQUEST_ABORTED );
     return ret;
 }
 
@@ -601,7 +695,7 @@ done:
  */
 HRESULT WINAPI CopyFile2( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDED_PARAMETERS *params )
 {
-    return copy_file(source, dest, params) ? S_OK : HRESULT_FROM_WIN32(GetLastError());
+    return copy_file( source, dest, params, NULL, NULL ) ? S_OK : HRESULT_FROM_WIN32(GetLastError());
 }
 
 
@@ -613,18 +707,13 @@ BOOL WINAPI CopyFileExW( const WCHAR *source, const WCHAR *dest, LPPROGRESS_ROUT
 {
     COPYFILE2_EXTENDED_PARAMETERS params;
 
-    if (progress)
-        FIXME("LPPROGRESS_ROUTINE is not supported\n");
-    if (cancel_ptr)
-        FIXME("cancel_ptr is not supported\n");
-
     params.dwSize = sizeof(params);
     params.dwCopyFlags = flags;
     params.pProgressRoutine = NULL;
     params.pvCallbackContext = NULL;
-    params.pfCancel = NULL;
+    params.pfCancel = cancel_ptr;
 
-    return copy_file( source, dest, &params );
+    return copy_file( source, dest, &params, progress, param );
 }
 
 
@@ -1502,13 +1502,46 @@ BOOL WINAPI SetProcessDefaultCpuSets(HANDLE process, const ULONG *cpu_set_ids, U
 }
 
 
+/* the NUMA nodes reported by the logical processor information, to be freed by the caller */
+static SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *get_numa_nodes( DWORD *len )
+{
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info = NULL;
+    NTSTATUS status;
+    LOGICAL_PROCESSOR_RELATIONSHIP relationship = RelationNumaNode;
+
+    *len = 0;
+    for (;;)
+    {
+        status = NtQuerySystemInformationEx( SystemLogicalProcessorInformationEx, &relationship,
+                                             sizeof(relationship), info, *len, len );
+        if (status != STATUS_INFO_LENGTH_MISMATCH) break;
+        HeapFree( GetProcessHeap(), 0, info );
+        if (!(info = HeapAlloc( GetProcessHeap(), 0, *len ))) return NULL;
+    }
+    if (!status) return info;
+    HeapFree( GetProcessHeap(), 0, info );
+    return NULL;
+}
+
+
 /**********************************************************************
  *             GetNumaHighestNodeNumber   (kernelbase.@)
  */
 BOOL WINAPI DECLSPEC_HOTPATCH GetNumaHighestNodeNumber( ULONG *node )
 {
-    FIXME( "semi-stub: %p\n", node );
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info, *ptr;
+    DWORD len, pos;
+
+    TRACE( "%p\n", node );
+
     *node = 0;
+    if (!(info = get_numa_nodes( &len ))) return TRUE;
+    for (pos = 0; pos < len; pos += ptr->Size)
+    {
+        ptr = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)((char *)info + pos);
+        *node = max( *node, ptr->NumaNode.NodeNumber );
+    }
+    HeapFree( GetProcessHeap(), 0, info );
     return TRUE;
 }
 
@@ -1518,9 +1551,24 @@ BOOL WINAPI DECLSPEC_HOTPATCH GetNumaHighestNodeNumber( ULONG *node )
  */
 BOOL WINAPI DECLSPEC_HOTPATCH GetNumaNodeProcessorMaskEx( USHORT node, GROUP_AFFINITY *mask )
 {
-    FIXME( "stub: %hu %p\n", node, mask );
-    SetLastError( ERROR_CALL_NOT_IMPLEMENTED );
-    return FALSE;
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info, *ptr;
+    DWORD len, pos;
+    BOOL ret = FALSE;
+
+    TRACE( "%hu %p\n", node, mask );
+
+    if (!(info = get_numa_nodes( &len ))) return FALSE;
+    for (pos = 0; pos < len; pos += ptr->Size)
+    {
+        ptr = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)((char *)info + pos);
+        if (ptr->NumaNode.NodeNumber != node) continue;
+        *mask = ptr->NumaNode.GroupMask;
+        ret = TRUE;
+        break;
+    }
+    HeapFree( GetProcessHeap(), 0, info );
+    if (!ret) SetLastError( ERROR_INVALID_PARAMETER );
+    return ret;
 }
 
 
@@ -1552,8 +1600,14 @@ LPVOID WINAPI DECLSPEC_HOTPATCH MapViewOfFileExNuma( HANDLE handle, DWORD access
 LPVOID WINAPI DECLSPEC_HOTPATCH VirtualAllocExNuma( HANDLE process, void *addr, SIZE_T size,
                                                     DWORD type, DWORD protect, DWORD node )
 {
-    if (node) FIXME( "Ignoring preferred node %lu\n", node );
-    return VirtualAllocEx( process, addr, size, type, protect );
+    MEM_EXTENDED_PARAMETER param;
+
+    if (node == NUMA_NO_PREFERRED_NODE) return VirtualAllocEx( process, addr, size, type, protect );
+
+    memset( &param, 0, sizeof(param) );
+    param.Type = MemExtendedParameterNumaNode;
+    param.ULong = node;
+    return VirtualAlloc2( process, addr, size, type, protect, &param, 1 );
 }
 
 
@@ -28,6 +28,8 @@
 #include "d3d9.h"
 #include "evr.h"
 
+#include "wine/list.h"
+
 WINE_DEFAULT_DEBUG_CHANNEL(mfplat);
 
 #define ALIGN_SIZE(size, alignment) (((size) + (alignment)) & ~((alignment)))
@@ -45,6 +47,7 @@ struct buffer
     BYTE *data;
     DWORD max_length;
     DWORD current_length;
+    DWORD alignment;
 
     struct
     {
@@ -76,6 +79,79 @@ struct buffer
     CRITICAL_SECTION cs;
 };
 
+/* Freshly allocated large buffers are page-faulted in on every use, which adds up
+ * quickly at video frame sizes; keep some freed ones for buffers of the same size. */
+#define BUFFER_POOL_MIN_LENGTH  0x10000
+#define BUFFER_POOL_MAX_SIZE    (128 * 1024 * 1024)
+#define BUFFER_POOL_MAX_COUNT   32
+
+struct pooled_data
+{
+    struct list entry; /* stored in the free memory itself */
+    DWORD length;
+    DWORD alignment;
+};
+
+static CRITICAL_SECTION buffer_pool_cs = { NULL, -1, 0, 0, 0, 0 };
+static struct list buffer_pool = LIST_INIT(buffer_pool);
+static SIZE_T buffer_pool_size;
+static unsigned int buffer_pool_count, buffer_pool_hits, buffer_pool_misses;
+
+static void *alloc_buffer_data(DWORD length, DWORD alignment)
+{
+    struct pooled_data *pooled;
+
+    if (length < BUFFER_POOL_MIN_LENGTH)
+        return _aligned_malloc(length, alignment);
+
+    EnterCriticalSection(&buffer_pool_cs);
+    LIST_FOR_EACH_ENTRY(pooled, &buffer_pool, struct pooled_data, entry)
+    {
+        if (pooled->length != length || pooled->alignment != alignment) continue;
+        list_remove(&pooled->entry);
+        buffer_pool_size -= length;
+        buffer_pool_count--;
+        buffer_pool_hits++;
+        LeaveCriticalSection(&buffer_pool_cs);
+        return pooled;
+    }
+    if (!(++buffer_pool_misses % 256))
+        TRACE("%u hits, %u misses, %u buffers pooled.\n", buffer_pool_hits, buffer_pool_misses, buffer_pool_count);
+    LeaveCriticalSection(&buffer_pool_cs);
+
+    return _aligned_malloc(length, alignment);
+}
+
+static void free_buffer_data(void *data, DWORD length, DWORD alignment)
+{
+    struct pooled_data *pooled = data;
+
+    if (!data || length < BUFFER_POOL_MIN_LENGTH || length > BUFFER_POOL_MAX_SIZE)
+    {
+        _aligned_free(data);
+        return;
+    }
+
+    pooled->length = length;
+    pooled->alignment = alignment;
+
+    EnterCriticalSection(&buffer_pool_cs);
+    list_add_head(&buffer_pool, &pooled->entry);
+    buffer_pool_size += length;
+    buffer_pool_count++;
+
+    /* drop the least recently freed buffers */
+    while (buffer_pool_size > BUFFER_POOL_MAX_SIZE || buffer_pool_count > BUFFER_POOL_MAX_COUNT)
+    {
+        pooled = LIST_ENTRY(list_tail(&buffer_pool), struct pooled_data, entry);
+        list_remove(&pooled->entry);
+        buffer_pool_size -= pooled->length;
+        buffer_pool_count--;
+        _aligned_free(pooled);
+    }
+    LeaveCriticalSection(&buffer_pool_cs);
+}
+
 static void copy_image(const struct buffer *buffer, BYTE *dest, LONG dest_stride, const BYTE *src,
         LONG src_stride, DWORD width, DWORD lines)
 {
@@ -173,7 +249,7 @@ static ULONG WINAPI memory_buffer_Release(IMFMediaBuffer *iface)
         }
         DeleteCriticalSection(&buffer->cs);
         free(buffer->_2d.linear_buffer);
-        _aligned_free(buffer->data);
+        free_buffer_data(buffer->data, buffer->max_length, buffer->alignment);
         free(buffer);
     }
 
@@ -1350,7 +1426,7 @@ static HRESULT memory_buffer_init(struct buffer *buffer, DWORD max_length, DWORD
         alignment++;
     }
 
-    if (!(buffer->data = _aligned_malloc(max_length, alignment)))
+    if (!(buffer->data = alloc_buffer_data(max_length, alignment)))
         return E_OUTOFMEMORY;
     memset(buffer->data, 0, max_length);
 
@@ -1358,6 +1434,7 @@ static HRESULT memory_buffer_init(struct buffer *buffer, DWORD max_length, DWORD
     buffer->refcount = 1;
     buffer->max_length = max_length;
     buffer->current_length = 0;
+    buffer->alignment = alignment;
     InitializeCriticalSection(&buffer->cs);
 
     return S_OK;
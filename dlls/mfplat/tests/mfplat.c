@@ -9493,6 +9493,23 @@ static void test_MFLockSharedWorkQueue(void)
     hr = MFUnlockWorkQueue(queue);
     ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
 
+    /* Queues are shared per usage class. */
+    queue = 0;
+    hr = pMFLockSharedWorkQueue(L"Audio", 0, &taskid, &queue);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(queue & MFASYNC_CALLBACK_QUEUE_PRIVATE_MASK, "Unexpected queue id.\n");
+
+    queue2 = 0;
+    hr = pMFLockSharedWorkQueue(L"Audio", 0, NULL, &queue2);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(queue == queue2, "Unexpected queue %#lx.\n", queue2);
+
+    hr = MFUnlockWorkQueue(queue2);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    hr = MFUnlockWorkQueue(queue);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
     hr = MFShutdown();
     ok(hr == S_OK, "Failed to shut down, hr %#lx.\n", hr);
 }
@@ -7608,6 +7608,7 @@ static UINT ACTION_HandleStandardAction(MSIPACKAGE *package, LPCWSTR action)
 
 UINT ACTION_PerformAction(MSIPACKAGE *package, const WCHAR *action)
 {
+    DWORD start = GetTickCount();
     UINT rc;
 
     TRACE("Performing action (%s)\n", debugstr_w(action));
@@ -7621,6 +7622,7 @@ UINT ACTION_PerformAction(MSIPACKAGE *package, const WCHAR *action)
     if (rc == ERROR_FUNCTION_NOT_CALLED)
         WARN("unhandled msi action %s\n", debugstr_w(action));
 
+    TRACE("action %s returned %u after %lu ms\n", debugstr_w(action), rc, GetTickCount() - start);
     return rc;
 }
 
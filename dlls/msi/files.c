@@ -489,16 +489,22 @@ static UINT create_folder( MSIPACKAGE *package, const WCHAR *dir )
     return ERROR_SUCCESS;
 }
 
-static MSIFILE *find_file( MSIPACKAGE *package, UINT disk_id, const WCHAR *filename )
+/* files are sorted by sequence and cabinets normally store them in the same order,
+ * so start looking at the last file extracted and wrap around if needed */
+static MSIFILE *find_file( MSIPACKAGE *package, MSIFILE *start, const WCHAR *filename )
 {
+    struct list *ptr = &start->entry;
     MSIFILE *file;
 
-    LIST_FOR_EACH_ENTRY( file, &package->files, MSIFILE, entry )
+    do
     {
-        if (file->disk_id == disk_id &&
+        if (ptr == &package->files) continue;
+        file = LIST_ENTRY( ptr, MSIFILE, entry );
+        if (file->disk_id == start->disk_id &&
             file->state != msifs_installed &&
             !wcsicmp( filename, file->File )) return file;
-    }
+    } while ((ptr = ptr->next) != &start->entry);
+
     return NULL;
 }
 
@@ -509,7 +515,7 @@ static BOOL installfiles_cb(MSIPACKAGE *package, LPCWSTR filename, DWORD action,
 
     if (action == MSICABEXTRACT_BEGINEXTRACT)
     {
-        if (!(file = find_file( package, file->disk_id, filename )))
+        if (!(file = find_file( package, file, filename )))
         {
             TRACE("unknown file in cabinet (%s)\n", debugstr_w(filename));
             return FALSE;
@@ -17,8 +17,11 @@
  */
 
 #include <stdarg.h>
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
 #include "windef.h"
 #include "winbase.h"
+#include "winternl.h"
 #include "wine/debug.h"
 #include "wine/list.h"
 
@@ -67,22 +70,34 @@ void __stdcall __std_wait_for_threadpool_work_callbacks(PTP_WORK work, BOOL canc
 void __stdcall __std_atomic_notify_one_direct(void *addr)
 {
     TRACE("(%p)\n", addr);
-    WakeByAddressSingle(addr);
+    RtlWakeAddressSingle(addr);
 }
 
 void __stdcall __std_atomic_notify_all_direct(void *addr)
 {
     TRACE("(%p)\n", addr);
-    WakeByAddressAll(addr);
+    RtlWakeAddressAll(addr);
 }
 
 BOOL __stdcall __std_atomic_wait_direct(volatile void *addr, void *cmp,
                                         SIZE_T size, DWORD timeout)
 {
+    LARGE_INTEGER to;
+    NTSTATUS status;
+
     TRACE("(%p %p %Id %ld)\n", addr, cmp, size, timeout);
-    return WaitOnAddress(addr, cmp, size, timeout);
+
+    to.QuadPart = -(LONGLONG)timeout * 10000;
+    status = RtlWaitOnAddress((const void *)addr, cmp, size, timeout == INFINITE ? NULL : &to);
+    if (!status) return TRUE;
+    SetLastError(RtlNtStatusToDosError(status));
+    return FALSE;
 }
 
+/* the indirect waits and the shared mutexes are looked up in a table hashed by address,
+ * every bucket has its own lock so that unrelated objects don't contend */
+#define WAIT_TABLE_SIZE 256
+
 typedef struct
 {
     SRWLOCK srwlock;
@@ -96,22 +111,65 @@ struct shared_mutex_elem
     shared_mutex mutex;
 };
 
-static CRITICAL_SECTION shared_mutex_cs;
-static CRITICAL_SECTION_DEBUG shared_mutex_cs_debug =
+static struct wait_table_entry
 {
-    0, 0, &shared_mutex_cs,
-    { &shared_mutex_cs_debug.ProcessLocksList, &shared_mutex_cs_debug.ProcessLocksList },
-      0, 0, { (DWORD_PTR)(__FILE__ ": shared_mutex_cs") }
-};
-static CRITICAL_SECTION shared_mutex_cs = { &shared_mutex_cs_debug, -1, 0, 0, 0, 0 };
-static struct list shared_mutex_list = LIST_INIT(shared_mutex_list);
+    SRWLOCK lock;
+    CONDITION_VARIABLE cv;
+    struct list shared_mutexes;
+} wait_table[WAIT_TABLE_SIZE];
+
+static struct wait_table_entry *get_wait_table_entry(const void *ptr)
+{
+    ULONG_PTR hash = (ULONG_PTR)ptr;
+
+    hash ^= hash >> 17;
+    hash ^= hash >> 9;
+    return &wait_table[(hash >> 3) % WAIT_TABLE_SIZE];
+}
+
+typedef BOOLEAN (__stdcall *atomic_wait_equal_fn)(const void *, void *, SIZE_T, void *);
+
+BOOL __stdcall __std_atomic_wait_indirect(const void *addr, void *cmp, SIZE_T size,
+        void *param, atomic_wait_equal_fn are_equal, DWORD timeout)
+{
+    struct wait_table_entry *entry = get_wait_table_entry(addr);
+    BOOL ret = TRUE;
+
+    TRACE("(%p %p %Id %p %p %ld)\n", addr, cmp, size, param, are_equal, timeout);
+
+    AcquireSRWLockExclusive(&entry->lock);
+    if (are_equal(addr, cmp, size, param))
+        ret = SleepConditionVariableSRW(&entry->cv, &entry->lock, timeout, 0);
+    ReleaseSRWLockExclusive(&entry->lock);
+    return ret;
+}
+
+void __stdcall __std_atomic_notify_all_indirect(const void *addr)
+{
+    struct wait_table_entry *entry = get_wait_table_entry(addr);
+
+    TRACE("(%p)\n", addr);
+
+    AcquireSRWLockExclusive(&entry->lock);
+    WakeAllConditionVariable(&entry->cv);
+    ReleaseSRWLockExclusive(&entry->lock);
+}
+
+void __stdcall __std_atomic_notify_one_indirect(const void *addr)
+{
+    TRACE("(%p)\n", addr);
+
+    /* the condition variable may be shared with waiters on other addresses */
+    __std_atomic_notify_all_indirect(addr);
+}
 
-/* shared_mutex_cs must be held by caller */
-static struct shared_mutex_elem* find_shared_mutex(void *ptr)
+/* the table entry lock must be held by caller */
+static struct shared_mutex_elem* find_shared_mutex(struct wait_table_entry *entry, void *ptr)
 {
     struct shared_mutex_elem *sme;
 
-    LIST_FOR_EACH_ENTRY(sme, &shared_mutex_list, struct shared_mutex_elem, entry)
+    if (!entry->shared_mutexes.next) list_init(&entry->shared_mutexes);
+    LIST_FOR_EACH_ENTRY(sme, &entry->shared_mutexes, struct shared_mutex_elem, entry)
     {
         if (sme->ptr == ptr)
             return sme;
@@ -121,16 +179,17 @@ static struct shared_mutex_elem* find_shared_mutex(void *ptr)
 
 shared_mutex* __stdcall __std_acquire_shared_mutex_for_instance(void *ptr)
 {
+    struct wait_table_entry *entry = get_wait_table_entry(ptr);
     struct shared_mutex_elem *sme;
 
     TRACE("(%p)\n", ptr);
 
-    EnterCriticalSection(&shared_mutex_cs);
-    sme = find_shared_mutex(ptr);
+    AcquireSRWLockExclusive(&entry->lock);
+    sme = find_shared_mutex(entry, ptr);
     if (sme)
     {
         sme->ref++;
-        LeaveCriticalSection(&shared_mutex_cs);
+        ReleaseSRWLockExclusive(&entry->lock);
         return &sme->mutex;
     }
 
@@ -138,22 +197,23 @@ shared_mutex* __stdcall __std_acquire_shared_mutex_for_instance(void *ptr)
     sme->ref = 1;
     sme->ptr = ptr;
     InitializeSRWLock(&sme->mutex.srwlock);
-    list_add_head(&shared_mutex_list, &sme->entry);
-    LeaveCriticalSection(&shared_mutex_cs);
+    list_add_head(&entry->shared_mutexes, &sme->entry);
+    ReleaseSRWLockExclusive(&entry->lock);
     return &sme->mutex;
 }
 
 void __stdcall __std_release_shared_mutex_for_instance(void *ptr)
 {
+    struct wait_table_entry *entry = get_wait_table_entry(ptr);
     struct shared_mutex_elem *sme;
 
     TRACE("(%p)\n", ptr);
 
-    EnterCriticalSection(&shared_mutex_cs);
-    sme = find_shared_mutex(ptr);
+    AcquireSRWLockExclusive(&entry->lock);
+    sme = find_shared_mutex(entry, ptr);
     if (!sme)
     {
-        LeaveCriticalSection(&shared_mutex_cs);
+        ReleaseSRWLockExclusive(&entry->lock);
         return;
     }
 
@@ -163,5 +223,5 @@ void __stdcall __std_release_shared_mutex_for_instance(void *ptr)
         list_remove(&sme->entry);
         free(sme);
     }
-    LeaveCriticalSection(&shared_mutex_cs);
+    ReleaseSRWLockExclusive(&entry->lock);
 }
@@ -3,14 +3,14 @@
 @ stub __std_atomic_get_mutex
 @ stub __std_atomic_has_cmpxchg16b
 @ stdcall __std_atomic_notify_all_direct(ptr)
-@ stub __std_atomic_notify_all_indirect
+@ stdcall __std_atomic_notify_all_indirect(ptr)
 @ stdcall __std_atomic_notify_one_direct(ptr)
-@ stub __std_atomic_notify_one_indirect
+@ stdcall __std_atomic_notify_one_indirect(ptr)
 @ stub __std_atomic_set_api_level
 @ stdcall __std_atomic_wait_direct(ptr ptr long long)
 @ stub __std_atomic_wait_get_deadline
 @ stub __std_atomic_wait_get_remaining_timeout
-@ stub __std_atomic_wait_indirect
+@ stdcall __std_atomic_wait_indirect(ptr ptr long ptr ptr long)
 @ stdcall __std_bulk_submit_threadpool_work(ptr long)
 @ stub __std_calloc_crt
 @ stdcall __std_close_threadpool_work(ptr)
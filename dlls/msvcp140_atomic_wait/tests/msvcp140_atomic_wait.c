@@ -37,6 +37,9 @@ static void (__stdcall *p___std_submit_threadpool_work)(PTP_WORK);
 static void (__stdcall *p___std_wait_for_threadpool_work_callbacks)(PTP_WORK, BOOL);
 static BOOL (__stdcall *p___std_atomic_wait_direct)(volatile void*, void*, size_t, DWORD);
 static void (__stdcall *p___std_atomic_notify_one_direct)(void*);
+static BOOL (__stdcall *p___std_atomic_wait_indirect)(const void*, void*, size_t, void*,
+        BOOLEAN (__stdcall*)(const void*, void*, size_t, void*), DWORD);
+static void (__stdcall *p___std_atomic_notify_one_indirect)(const void*);
 static shared_mutex* (__stdcall *p___std_acquire_shared_mutex_for_instance)(void*);
 static void (__stdcall *p___std_release_shared_mutex_for_instance)(void*);
 
@@ -58,6 +61,8 @@ static HMODULE init(void)
     SET(p___std_wait_for_threadpool_work_callbacks, "__std_wait_for_threadpool_work_callbacks");
     SET(p___std_atomic_wait_direct, "__std_atomic_wait_direct");
     SET(p___std_atomic_notify_one_direct, "__std_atomic_notify_one_direct");
+    SET(p___std_atomic_wait_indirect, "__std_atomic_wait_indirect");
+    SET(p___std_atomic_notify_one_indirect, "__std_atomic_notify_one_indirect");
     SET(p___std_acquire_shared_mutex_for_instance, "__std_acquire_shared_mutex_for_instance");
     SET(p___std_release_shared_mutex_for_instance, "__std_release_shared_mutex_for_instance");
     return msvcp;
@@ -246,6 +251,56 @@ static void test___std_atomic_wait_direct(void)
     CloseHandle(thread);
 }
 
+static LONG indirect_value;
+
+static BOOLEAN __stdcall indirect_equal(const void *addr, void *cmp, size_t size, void *param)
+{
+    ok(param == (void *)0xdeadbeef, "param = %p\n", param);
+    return !memcmp(addr, cmp, size);
+}
+
+static void __cdecl atomic_wait_indirect_thread(void *arg)
+{
+    LONG compare = 0;
+    int r;
+
+    while (indirect_value == compare)
+    {
+        r = p___std_atomic_wait_indirect(&indirect_value, &compare, sizeof(compare),
+                (void *)0xdeadbeef, indirect_equal, 2000);
+        ok(r == 1, "r = %d\n", r);
+    }
+}
+
+static void test___std_atomic_wait_indirect(void)
+{
+    LONG compare = 0;
+    HANDLE thread;
+    DWORD gle;
+    int r;
+
+    indirect_value = 0;
+    SetLastError(0);
+    r = p___std_atomic_wait_indirect(&indirect_value, &compare, sizeof(compare),
+            (void *)0xdeadbeef, indirect_equal, 1);
+    ok(!r, "r = %d\n", r);
+    gle = GetLastError();
+    ok(gle == ERROR_TIMEOUT, "expected %d, got %ld\n", ERROR_TIMEOUT, gle);
+
+    compare = 1;
+    r = p___std_atomic_wait_indirect(&indirect_value, &compare, sizeof(compare),
+            (void *)0xdeadbeef, indirect_equal, 0);
+    ok(r == 1, "r = %d\n", r);
+
+    thread = (HANDLE)_beginthread(atomic_wait_indirect_thread, 0, NULL);
+    ok(thread != INVALID_HANDLE_VALUE, "_beginthread failed\n");
+    Sleep(100);
+    InterlockedExchange(&indirect_value, 1);
+    p___std_atomic_notify_one_indirect(&indirect_value);
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
 static void test___std_acquire_shared_mutex_for_instance(void)
 {
     shared_mutex *ret1, *ret2;
@@ -280,6 +335,7 @@ START_TEST(msvcp140_atomic_wait)
     test___std_parallel_algorithms_hw_threads();
     test_threadpool_work();
     test___std_atomic_wait_direct();
+    test___std_atomic_wait_indirect();
     test___std_acquire_shared_mutex_for_instance();
     FreeLibrary(msvcp);
 }
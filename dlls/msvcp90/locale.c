@@ -355,6 +355,15 @@ size_t __thiscall locale_id_operator_size_t(locale_id *this)
     return this->id;
 }
 
+/* The facets of a locale implementation can't change once it's shared, only
+ * the fallback objects created by the use_facet functions need the lock. */
+static inline const locale_facet* locale_find_facet(const locale *loc, const locale_id *id)
+{
+    if(!id->id || id->id >= loc->ptr->facet_cnt)
+        return NULL;
+    return loc->ptr->facetvec[id->id];
+}
+
 /* ?_Id_cnt_func@id@locale@std@@CAAAHXZ */
 /* ?_Id_cnt_func@id@locale@std@@CAAEAHXZ */
 int* __cdecl locale_id__Id_cnt_func(void)
@@ -1093,6 +1102,9 @@ static collate* collate_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &collate_char_id)))
+        return (collate*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&collate_char_id));
     if(fac) {
@@ -1380,6 +1392,9 @@ static collate* collate_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &collate_wchar_id)))
+        return (collate*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&collate_wchar_id));
     if(fac) {
@@ -1427,6 +1442,9 @@ static collate* collate_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &collate_short_id)))
+        return (collate*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&collate_short_id));
     if(fac) {
@@ -1940,6 +1958,9 @@ ctype_char* ctype_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &ctype_char_id)))
+        return (ctype_char*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&ctype_char_id));
     if(fac) {
@@ -2765,6 +2786,9 @@ ctype_wchar* ctype_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &ctype_wchar_id)))
+        return (ctype_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&ctype_wchar_id));
     if(fac) {
@@ -2793,6 +2817,9 @@ ctype_wchar* ctype_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &ctype_short_id)))
+        return (ctype_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&ctype_short_id));
     if(fac) {
@@ -3324,6 +3351,9 @@ codecvt_char* codecvt_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &codecvt_char_id)))
+        return (codecvt_char*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&codecvt_char_id));
     if(fac) {
@@ -3660,6 +3690,9 @@ codecvt_wchar* codecvt_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &codecvt_wchar_id)))
+        return (codecvt_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&codecvt_wchar_id));
     if(fac) {
@@ -3713,6 +3746,9 @@ codecvt_wchar* codecvt_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &codecvt_short_id)))
+        return (codecvt_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&codecvt_short_id));
     if(fac) {
@@ -4629,6 +4665,9 @@ static numpunct_char* numpunct_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &numpunct_char_id)))
+        return (numpunct_char*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&numpunct_char_id));
     if(fac) {
@@ -4998,6 +5037,9 @@ static numpunct_wchar* numpunct_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &numpunct_wchar_id)))
+        return (numpunct_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&numpunct_wchar_id));
     if(fac) {
@@ -5048,6 +5090,9 @@ static numpunct_wchar* numpunct_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &numpunct_short_id)))
+        return (numpunct_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&numpunct_short_id));
     if(fac) {
@@ -5471,6 +5516,9 @@ num_get* num_get_wchar_use_facet(const locale *loc)
         _Lockit lock;
         const locale_facet *fac;
 
+        if((fac = locale_find_facet(loc, &num_get_wchar_id)))
+            return (num_get*)fac;
+
         _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
         fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_get_wchar_id));
         if(fac) {
@@ -5518,6 +5566,9 @@ num_get* num_get_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &num_get_short_id)))
+        return (num_get*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_get_short_id));
     if(fac) {
@@ -6715,6 +6766,9 @@ num_get* num_get_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &num_get_char_id)))
+        return (num_get*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_get_char_id));
     if(fac) {
@@ -7660,6 +7714,9 @@ num_put* num_put_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &num_put_char_id)))
+        return (num_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_put_char_id));
     if(fac) {
@@ -8452,6 +8509,9 @@ num_put* num_put_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &num_put_wchar_id)))
+        return (num_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_put_wchar_id));
     if(fac) {
@@ -8480,6 +8540,9 @@ num_put* num_put_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &num_put_short_id)))
+        return (num_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&num_put_short_id));
     if(fac) {
@@ -9460,6 +9523,9 @@ static time_put* time_put_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &time_put_char_id)))
+        return (time_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&time_put_char_id));
     if(fac) {
@@ -9823,6 +9889,9 @@ static time_put* time_put_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &time_put_wchar_id)))
+        return (time_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&time_put_wchar_id));
     if(fac) {
@@ -9873,6 +9942,9 @@ static time_put* time_put_short_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &time_put_short_id)))
+        return (time_put*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&time_put_short_id));
     if(fac) {
@@ -10253,6 +10325,9 @@ static time_get_char* time_get_char_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &time_get_char_id)))
+        return (time_get_char*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&time_get_char_id));
     if(fac) {
@@ -11134,6 +11209,9 @@ static time_get_wchar* time_get_wchar_use_facet(const locale *loc)
     _Lockit lock;
     const locale_facet *fac;
 
+    if((fac = locale_find_facet(loc, &time_get_wchar_id)))
+        return (time_get_wchar*)fac;
+
     _Lockit_ctor_locktype(&lock, _LOCK_LOCALE);
     fac = locale__Getfacet(loc, locale_id_operator_size_t(&time_get_wchar_id));
     if(fac) {
@@ -2165,9 +2165,9 @@
 @ cdecl fgetws(ptr long ptr)
 @ cdecl floor(double)
 @ cdecl -arch=!i386 floorf(float)
-@ cdecl fma(double double double)
-@ cdecl fmaf(float float float)
-@ cdecl fmal(double double double) fma
+@ cdecl fma(double double double) MSVCRT_fma
+@ cdecl fmaf(float float float) MSVCRT_fmaf
+@ cdecl fmal(double double double) MSVCRT_fma
 @ cdecl fmax(double double)
 @ cdecl fmaxf(float float)
 @ cdecl fmaxl(double double) fmax
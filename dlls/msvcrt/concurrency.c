@@ -112,6 +112,7 @@ typedef struct {
     struct _StructuredTaskCollection *task_collection;
     CRITICAL_SECTION beacons_cs;
     struct list beacons;
+    struct Scheduler *chore_scheduler; /* set while the thread is a chore worker of a scheduler */
 } ExternalContextBase;
 extern const vtable_ptr ExternalContextBase_vtable;
 static void ExternalContextBase_ctor(ExternalContextBase*);
@@ -154,8 +155,10 @@ typedef struct {
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
     struct list scheduled_chores;
+    LONG chore_workers;
 } ThreadScheduler;
 extern const vtable_ptr ThreadScheduler_vtable;
+static void release_chore_worker(ThreadScheduler*);
 
 typedef struct {
     Scheduler *scheduler;
@@ -964,12 +967,19 @@ void __thiscall ExternalContextBase_Block(ExternalContextBase *this)
 
     TRACE("(%p)->()\n", this);
 
+    /* let another thread run the pending chores while this one is blocked */
+    if (this->chore_scheduler)
+        release_chore_worker((ThreadScheduler*)this->chore_scheduler);
+
     blocked = InterlockedIncrement(&this->blocked);
     while (blocked >= 1)
     {
         RtlWaitOnAddress(&this->blocked, &blocked, sizeof(LONG), NULL);
         blocked = this->blocked;
     }
+
+    if (this->chore_scheduler)
+        InterlockedIncrement(&((ThreadScheduler*)this->chore_scheduler)->chore_workers);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Yield, 4)
@@ -1635,6 +1645,7 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
 
     list_init(&this->scheduled_chores);
+    this->chore_workers = 0;
     return this;
 }
 
@@ -2295,9 +2306,53 @@ static BOOL pick_and_execute_chore(ThreadScheduler *scheduler)
     return TRUE;
 }
 
+/* the number of threads running chores is limited to the number of virtual processors */
+static BOOL reserve_chore_worker(ThreadScheduler *scheduler)
+{
+    LONG workers = scheduler->chore_workers;
+
+    while (workers < (LONG)scheduler->virt_proc_no)
+    {
+        LONG prev = InterlockedCompareExchange(&scheduler->chore_workers, workers + 1, workers);
+        if (prev == workers) return TRUE;
+        workers = prev;
+    }
+    return FALSE;
+}
+
+static BOOL chores_pending(ThreadScheduler *scheduler)
+{
+    BOOL ret;
+
+    EnterCriticalSection(&scheduler->cs);
+    ret = !list_empty(&scheduler->scheduled_chores);
+    LeaveCriticalSection(&scheduler->cs);
+    return ret;
+}
+
 static void __cdecl _StructuredTaskCollection_scheduler_cb(void *data)
 {
-    pick_and_execute_chore((ThreadScheduler*)get_current_scheduler());
+    ThreadScheduler *scheduler = (ThreadScheduler*)get_current_scheduler();
+    ExternalContextBase *ctx = (ExternalContextBase*)get_current_context();
+    BOOL worker = ctx->context.vtable == &ExternalContextBase_vtable;
+
+    if (worker) ctx->chore_scheduler = &scheduler->scheduler;
+    for (;;)
+    {
+        while (pick_and_execute_chore(scheduler)) ;
+
+        InterlockedDecrement(&scheduler->chore_workers);
+        /* a chore may have been queued after the last check, while all workers were busy */
+        if (!chores_pending(scheduler) || !reserve_chore_worker(scheduler)) break;
+    }
+    if (worker) ctx->chore_scheduler = NULL;
+}
+
+static void release_chore_worker(ThreadScheduler *scheduler)
+{
+    InterlockedDecrement(&scheduler->chore_workers);
+    if (chores_pending(scheduler) && reserve_chore_worker(scheduler))
+        call_Scheduler_ScheduleTask(&scheduler->scheduler, _StructuredTaskCollection_scheduler_cb, NULL);
 }
 
 static bool schedule_chore(_StructuredTaskCollection *this,
@@ -2332,7 +2387,8 @@ static bool schedule_chore(_StructuredTaskCollection *this,
     list_add_head(&scheduler->scheduled_chores, &sc->entry);
     LeaveCriticalSection(&scheduler->cs);
     *pscheduler = &scheduler->scheduler;
-    return TRUE;
+    /* only start a new worker when all the current ones are busy */
+    return reserve_chore_worker(scheduler);
 }
 
 #if _MSVCR_VER >= 110
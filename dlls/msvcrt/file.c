@@ -3641,6 +3641,7 @@ int CDECL _write(int fd, const void* buf, unsigned int count)
     {
         const char *s = buf;
         char lfbuf[2048];
+        const char *data = lfbuf;
         DWORD j = 0;
 
         if (ioinfo_get_textmode(info) == TEXTMODE_ANSI && console)
@@ -3697,11 +3698,32 @@ int CDECL _write(int fd, const void* buf, unsigned int count)
         }
         else if (ioinfo_get_textmode(info) == TEXTMODE_ANSI)
         {
-            for (j = 0; i < count && j < sizeof(lfbuf)-1; i++, j++)
+            const char *lf = memchr(s + i, '\n', count - i);
+            DWORD len;
+
+            if (!lf)
+            {
+                /* nothing to translate, write the rest in one go */
+                data = s + i;
+                j = count - i;
+                i = count;
+            }
+
+            /* copy the runs between line feeds as a whole */
+            while (i < count && j < sizeof(lfbuf)-1)
             {
-                if (s[i] == '\n')
+                if (lf == s + i)
+                {
                     lfbuf[j++] = '\r';
-                lfbuf[j] = s[i];
+                    lfbuf[j++] = '\n';
+                    i++;
+                    lf = memchr(s + i, '\n', count - i);
+                    continue;
+                }
+                len = min((lf ? lf - s : count) - i, sizeof(lfbuf) - 1 - j);
+                memcpy(lfbuf + j, s + i, len);
+                i += len;
+                j += len;
             }
         }
         else if (ioinfo_get_textmode(info) == TEXTMODE_UTF16LE || console)
@@ -3747,7 +3769,7 @@ int CDECL _write(int fd, const void* buf, unsigned int count)
             if (!WriteConsoleW(hand, lfbuf, j, &num_written, NULL))
                 num_written = -1;
         }
-        else if (!WriteFile(hand, lfbuf, j, &num_written, NULL))
+        else if (!WriteFile(hand, data, j, &num_written, NULL))
         {
             num_written = -1;
         }
@@ -53,8 +53,293 @@ static unsigned int MSVCRT_amblksiz = 16;
 /* FIXME - According to documentation it should be 480 bytes, at runtime default is 0 */
 static size_t MSVCRT_sbh_threshold = 0;
 
+/* Optional small blocks pool, enabled with WINEMSVCRTPOOL=1.
+ *
+ * Blocks up to POOL_MAX_SIZE are carved out of chunks of a single size class, allocated
+ * from a reserved address range so that pool pointers are recognized with a range check.
+ * Each thread keeps free lists of pool blocks, refilled from and flushed to the global
+ * free lists in batches, so that most allocations don't take any lock.
+ */
+#define POOL_ALIGN       16
+#define POOL_MAX_SIZE    1024
+#define POOL_CLASS_COUNT (POOL_MAX_SIZE / POOL_ALIGN)
+#define POOL_CHUNK_SIZE  0x10000
+#define POOL_CACHE_MAX   64     /* max cached blocks per size class and thread */
+#define POOL_BATCH       32     /* blocks moved between thread and global free lists at once */
+#define POOL_BLOCK_FREE  0xffff
+#ifdef _WIN64
+#define POOL_RESERVE_SIZE 0x40000000
+#else
+#define POOL_RESERVE_SIZE 0x4000000
+#endif
+
+struct pool_free
+{
+    struct pool_free *next;
+};
+
+struct pool_chunk
+{
+    unsigned int   block_size;
+    unsigned int   block_count;
+    unsigned int   data_offset;
+    unsigned short sizes[1];    /* requested size of each block, or POOL_BLOCK_FREE */
+};
+
+struct pool_cache
+{
+    struct pool_free *free[POOL_CLASS_COUNT];
+    unsigned int      count[POOL_CLASS_COUNT];
+};
+
+static char *pool_base, *pool_end, *pool_next;
+static struct pool_free *pool_free_lists[POOL_CLASS_COUNT];
+static SRWLOCK pool_lock = SRWLOCK_INIT;
+
+static inline BOOL pool_contains(const void *ptr)
+{
+    return (const char *)ptr >= pool_base && (const char *)ptr < pool_next;
+}
+
+static inline struct pool_chunk *pool_get_chunk(const void *ptr)
+{
+    return (struct pool_chunk *)(pool_base + (((const char *)ptr - pool_base) & ~(POOL_CHUNK_SIZE - 1)));
+}
+
+/* get the index of a pool block, or -1 if ptr isn't the start of a block */
+static int pool_block_index(const struct pool_chunk *chunk, const void *ptr)
+{
+    size_t offset = (const char *)ptr - (const char *)chunk - chunk->data_offset;
+
+    if (offset >= chunk->block_count * chunk->block_size || offset % chunk->block_size) return -1;
+    return offset / chunk->block_size;
+}
+
+/* allocate a new chunk for a size class, pool_lock must be held */
+static BOOL pool_add_chunk(unsigned int class)
+{
+    unsigned int block_size = (class + 1) * POOL_ALIGN, count, offset, i;
+    struct pool_chunk *chunk = (struct pool_chunk *)pool_next;
+    struct pool_free *block;
+
+    if (pool_next == pool_end) return FALSE;
+    if (!VirtualAlloc(chunk, POOL_CHUNK_SIZE, MEM_COMMIT, PAGE_READWRITE)) return FALSE;
+
+    count = (POOL_CHUNK_SIZE - offsetof(struct pool_chunk, sizes)) / (block_size + sizeof(chunk->sizes[0]));
+    for (;;)
+    {
+        offset = offsetof(struct pool_chunk, sizes) + count * sizeof(chunk->sizes[0]);
+        offset = (offset + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1);
+        if (offset + count * block_size <= POOL_CHUNK_SIZE) break;
+        count--;
+    }
+    chunk->block_size = block_size;
+    chunk->block_count = count;
+    chunk->data_offset = offset;
+
+    for (i = count; i--;)
+    {
+        chunk->sizes[i] = POOL_BLOCK_FREE;
+        block = (struct pool_free *)((char *)chunk + offset + i * block_size);
+        block->next = pool_free_lists[class];
+        pool_free_lists[class] = block;
+    }
+    pool_next += POOL_CHUNK_SIZE;
+    return TRUE;
+}
+
+static struct pool_cache *pool_get_cache(void)
+{
+    thread_data_t *data = msvcrt_get_thread_data();
+
+    if (!data->heap_cache) data->heap_cache = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(struct pool_cache));
+    return data->heap_cache;
+}
+
+static void *pool_alloc(DWORD flags, size_t size)
+{
+    unsigned int class = size ? (size - 1) / POOL_ALIGN : 0, i;
+    struct pool_cache *cache;
+    struct pool_chunk *chunk;
+    struct pool_free *block;
+
+    if (!(cache = pool_get_cache())) return NULL;
+
+    if (!cache->free[class])
+    {
+        AcquireSRWLockExclusive(&pool_lock);
+        if (!pool_free_lists[class]) pool_add_chunk(class);
+        for (i = 0; i < POOL_BATCH && (block = pool_free_lists[class]); i++)
+        {
+            pool_free_lists[class] = block->next;
+            block->next = cache->free[class];
+            cache->free[class] = block;
+            cache->count[class]++;
+        }
+        ReleaseSRWLockExclusive(&pool_lock);
+        if (!cache->free[class]) return NULL;
+    }
+
+    block = cache->free[class];
+    cache->free[class] = block->next;
+    cache->count[class]--;
+
+    chunk = pool_get_chunk(block);
+    chunk->sizes[pool_block_index(chunk, block)] = size;
+    if (flags & HEAP_ZERO_MEMORY) memset(block, 0, size);
+    return block;
+}
+
+static void pool_release(struct pool_free *block, unsigned int class)
+{
+    struct pool_cache *cache = pool_get_cache();
+    unsigned int i;
+
+    if (cache)
+    {
+        block->next = cache->free[class];
+        cache->free[class] = block;
+        if (++cache->count[class] <= POOL_CACHE_MAX) return;
+    }
+
+    AcquireSRWLockExclusive(&pool_lock);
+    if (!cache)
+    {
+        block->next = pool_free_lists[class];
+        pool_free_lists[class] = block;
+    }
+    else for (i = 0; i < POOL_BATCH; i++)
+    {
+        block = cache->free[class];
+        cache->free[class] = block->next;
+        cache->count[class]--;
+        block->next = pool_free_lists[class];
+        pool_free_lists[class] = block;
+    }
+    ReleaseSRWLockExclusive(&pool_lock);
+}
+
+static BOOL pool_free(void *ptr)
+{
+    struct pool_chunk *chunk = pool_get_chunk(ptr);
+    int index = pool_block_index(chunk, ptr);
+
+    if (index == -1 || chunk->sizes[index] == POOL_BLOCK_FREE)
+    {
+        WARN("invalid pool block %p\n", ptr);
+        return FALSE;
+    }
+    chunk->sizes[index] = POOL_BLOCK_FREE;
+    pool_release(ptr, chunk->block_size / POOL_ALIGN - 1);
+    return TRUE;
+}
+
+static size_t pool_size(const void *ptr)
+{
+    struct pool_chunk *chunk = pool_get_chunk(ptr);
+    int index = pool_block_index(chunk, ptr);
+
+    if (index == -1 || chunk->sizes[index] == POOL_BLOCK_FREE) return ~(size_t)0;
+    return chunk->sizes[index];
+}
+
+static void *pool_realloc(DWORD flags, void *ptr, size_t size)
+{
+    struct pool_chunk *chunk = pool_get_chunk(ptr);
+    int index = pool_block_index(chunk, ptr);
+    size_t old_size;
+    void *ret;
+
+    if (index == -1 || chunk->sizes[index] == POOL_BLOCK_FREE) return NULL;
+    old_size = chunk->sizes[index];
+
+    if (size <= chunk->block_size)
+    {
+        if ((flags & HEAP_ZERO_MEMORY) && size > old_size) memset((char *)ptr + old_size, 0, size - old_size);
+        chunk->sizes[index] = size;
+        return ptr;
+    }
+    if (flags & HEAP_REALLOC_IN_PLACE_ONLY) return NULL;
+
+    if (!(size <= POOL_MAX_SIZE && (ret = pool_alloc(flags, size))) && !(ret = HeapAlloc(heap, flags, size)))
+        return NULL;
+    memcpy(ret, ptr, old_size);
+    pool_free(ptr);
+    return ret;
+}
+
+/* move the blocks cached by a thread back to the global free lists */
+void msvcrt_free_heap_cache(thread_data_t *data)
+{
+    struct pool_cache *cache = data->heap_cache;
+    struct pool_free *block;
+    unsigned int i;
+
+    if (!cache) return;
+    data->heap_cache = NULL;
+
+    AcquireSRWLockExclusive(&pool_lock);
+    for (i = 0; i < POOL_CLASS_COUNT; i++)
+    {
+        while ((block = cache->free[i]))
+        {
+            cache->free[i] = block->next;
+            block->next = pool_free_lists[i];
+            pool_free_lists[i] = block;
+        }
+    }
+    ReleaseSRWLockExclusive(&pool_lock);
+    HeapFree(GetProcessHeap(), 0, cache);
+}
+
+/* walk the pool blocks after the heap ones */
+static int pool_walk(_HEAPINFO *next)
+{
+    struct pool_chunk *chunk;
+    int index = -1;
+
+    if (pool_contains(next->_pentry))
+    {
+        chunk = pool_get_chunk(next->_pentry);
+        if (next->_useflag == _FREEENTRY)
+            index = pool_block_index(chunk, (struct pool_free *)next->_pentry - 1);
+        else
+            index = pool_block_index(chunk, next->_pentry);
+        if (index == -1) return _HEAPBADPTR;
+    }
+    else chunk = (struct pool_chunk *)pool_base;
+
+    if (++index == chunk->block_count)
+    {
+        chunk = (struct pool_chunk *)((char *)chunk + POOL_CHUNK_SIZE);
+        index = 0;
+    }
+    if ((char *)chunk >= pool_next) return _HEAPEND;
+
+    next->_pentry = (int *)((char *)chunk + chunk->data_offset + index * chunk->block_size);
+    if (chunk->sizes[index] == POOL_BLOCK_FREE)
+    {
+        /* don't expose the free list pointer */
+        next->_pentry = (int *)((struct pool_free *)next->_pentry + 1);
+        next->_size = chunk->block_size - sizeof(struct pool_free);
+        next->_useflag = _FREEENTRY;
+    }
+    else
+    {
+        next->_size = chunk->sizes[index];
+        next->_useflag = _USEDENTRY;
+    }
+    return _HEAPOK;
+}
+
 static void* msvcrt_heap_alloc(DWORD flags, size_t size)
 {
+    if(pool_base && size <= POOL_MAX_SIZE)
+    {
+        void *ret = pool_alloc(flags, size);
+        if(ret) return ret;
+    }
+
     if(size < MSVCRT_sbh_threshold)
     {
         void *memblock, *temp, **saved;
@@ -73,6 +358,9 @@ static void* msvcrt_heap_alloc(DWORD flags, size_t size)
 
 static void* msvcrt_heap_realloc(DWORD flags, void *ptr, size_t size)
 {
+    if(pool_contains(ptr))
+        return pool_realloc(flags, ptr, size);
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         /* TODO: move data to normal heap if it exceeds sbh_threshold limit */
@@ -105,6 +393,9 @@ static void* msvcrt_heap_realloc(DWORD flags, void *ptr, size_t size)
 
 static BOOL msvcrt_heap_free(void *ptr)
 {
+    if(pool_contains(ptr))
+        return pool_free(ptr);
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         void **saved = SAVED_PTR(ptr);
@@ -116,6 +407,9 @@ static BOOL msvcrt_heap_free(void *ptr)
 
 static size_t msvcrt_heap_size(void *ptr)
 {
+    if(pool_contains(ptr))
+        return pool_size(ptr);
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         void **saved = SAVED_PTR(ptr);
@@ -277,6 +571,16 @@ int CDECL _heapwalk(_HEAPINFO *next)
   if (sb_heap)
       FIXME("small blocks heap not supported\n");
 
+  if (pool_contains(next->_pentry))
+  {
+    int ret;
+
+    AcquireSRWLockShared(&pool_lock);
+    ret = pool_walk(next);
+    ReleaseSRWLockShared(&pool_lock);
+    return ret;
+  }
+
   LOCK_HEAP;
   phe.lpData = next->_pentry;
   phe.cbData = next->_size;
@@ -296,7 +600,18 @@ int CDECL _heapwalk(_HEAPINFO *next)
     {
       UNLOCK_HEAP;
       if (GetLastError() == ERROR_NO_MORE_ITEMS)
-         return _HEAPEND;
+      {
+        int ret = _HEAPEND;
+
+        if (pool_base)
+        {
+          next->_pentry = NULL;
+          AcquireSRWLockShared(&pool_lock);
+          if (pool_next != pool_base) ret = pool_walk(next);
+          ReleaseSRWLockShared(&pool_lock);
+        }
+        return ret;
+      }
       msvcrt_set_errno(GetLastError());
       if (!phe.lpData)
         return _HEAPBADBEGIN;
@@ -829,8 +1144,19 @@ int CDECL wmemcpy_s(wchar_t *dest, size_t numberOfElements,
 
 BOOL msvcrt_init_heap(void)
 {
+    char buffer[16];
+
     heap = HeapCreate(0, 0, 0);
-    return heap != NULL;
+    if (!heap) return FALSE;
+
+    if (GetEnvironmentVariableA("WINEMSVCRTPOOL", buffer, sizeof(buffer)) && atoi(buffer) &&
+        (pool_base = VirtualAlloc(NULL, POOL_RESERVE_SIZE, MEM_RESERVE, PAGE_READWRITE)))
+    {
+        TRACE("using small blocks pool at %p\n", pool_base);
+        pool_next = pool_base;
+        pool_end = pool_base + POOL_RESERVE_SIZE;
+    }
+    return TRUE;
 }
 
 void msvcrt_destroy_heap(void)
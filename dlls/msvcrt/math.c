@@ -65,11 +65,50 @@ typedef int (CDECL *MSVCRT_matherr_func)(struct _exception *);
 static MSVCRT_matherr_func MSVCRT_default_matherr_func = NULL;
 
 BOOL sse2_supported;
+BOOL erms_supported;
 static BOOL sse2_enabled;
+#if defined(__x86_64__) && _MSVCR_VER>=120
+static BOOL fma3_supported;
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+static inline void do_cpuid( int regs[4], int ax, int cx )
+{
+    __asm__( "cpuid" : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(ax), "c"(cx) );
+}
+
+/* enhanced rep movsb/stosb, the feature isn't reported by IsProcessorFeaturePresent */
+static BOOL have_erms(void)
+{
+    int regs[4];
+
+    do_cpuid( regs, 0, 0 );
+    if (regs[0] < 7) return FALSE;
+    do_cpuid( regs, 7, 0 );
+    return (regs[1] >> 9) & 1;
+}
+#endif
+
+#if defined(__x86_64__) && _MSVCR_VER>=120
+static BOOL have_fma3(void)
+{
+    int regs[4];
+
+    if (!IsProcessorFeaturePresent( PF_AVX_INSTRUCTIONS_AVAILABLE )) return FALSE;
+    do_cpuid( regs, 1, 0 );
+    return (regs[2] >> 12) & 1;
+}
+#endif
 
 void msvcrt_init_math( void *module )
 {
     sse2_supported = IsProcessorFeaturePresent( PF_XMMI64_INSTRUCTIONS_AVAILABLE );
+#if defined(__i386__) || defined(__x86_64__)
+    erms_supported = have_erms();
+#endif
+#if defined(__x86_64__) && _MSVCR_VER>=120
+    fma3_supported = have_fma3();
+#endif
 #if _MSVCR_VER <=71
     sse2_enabled = FALSE;
     {
@@ -1612,6 +1651,45 @@ double CDECL MSVCRT_rint(double x)
     return y;
 }
 
+/*********************************************************************
+ *      fma (MSVCR120.@)
+ *
+ * Use the FMA3 instruction when available, it's much faster than the
+ * exact software emulation and gives the same results.
+ */
+double CDECL MSVCRT_fma(double x, double y, double z)
+{
+#ifdef __x86_64__
+    if (fma3_supported)
+    {
+        double r = x;
+
+        __asm__( "vfmadd213sd %2, %1, %0" : "+x" (r) : "x" (y), "xm" (z) );
+        if (isnan(r) && !isnan(x) && !isnan(y) && !isnan(z)) *_errno() = EDOM;
+        return r;
+    }
+#endif
+    return fma(x, y, z);
+}
+
+/*********************************************************************
+ *      fmaf (MSVCR120.@)
+ */
+float CDECL MSVCRT_fmaf(float x, float y, float z)
+{
+#ifdef __x86_64__
+    if (fma3_supported)
+    {
+        float r = x;
+
+        __asm__( "vfmadd213ss %2, %1, %0" : "+x" (r) : "x" (y), "xm" (z) );
+        if (isnan(r) && !isnan(x) && !isnan(y) && !isnan(z)) *_errno() = EDOM;
+        return r;
+    }
+#endif
+    return fmaf(x, y, z);
+}
+
 /*********************************************************************
  *		_nearbyint (MSVCR120.@)
  *
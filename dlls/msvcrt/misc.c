@@ -258,6 +258,28 @@ static inline void swap(char *l, char *r, size_t size)
 {
     char tmp;
 
+    if(!(size % sizeof(size_t)) && !(((ULONG_PTR)l | (ULONG_PTR)r) % sizeof(size_t))) {
+        size_t *lw = (size_t*)l, *rw = (size_t*)r, w;
+
+        for(size /= sizeof(size_t); size; size--) {
+            w = *lw;
+            *lw++ = *rw;
+            *rw++ = w;
+        }
+        return;
+    }
+
+    if(!(size % sizeof(UINT)) && !(((ULONG_PTR)l | (ULONG_PTR)r) % sizeof(UINT))) {
+        UINT *lw = (UINT*)l, *rw = (UINT*)r, w;
+
+        for(size /= sizeof(UINT); size; size--) {
+            w = *lw;
+            *lw++ = *rw;
+            *rw++ = w;
+        }
+        return;
+    }
+
     while(size--) {
         tmp = *l;
         *l++ = *r;
@@ -284,20 +306,57 @@ static void small_sort(void *base, size_t nmemb, size_t size,
     }
 }
 
+static void sift_down(void *base, size_t nmemb, size_t size, size_t parent,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    size_t child;
+
+#define X(i) ((char*)base+size*(i))
+    while((child = 2*parent+1) < nmemb) {
+        if(child+1 < nmemb && compar(context, X(child+1), X(child)) > 0)
+            child++;
+        if(compar(context, X(child), X(parent)) <= 0)
+            break;
+        swap(X(parent), X(child), size);
+        parent = child;
+    }
+#undef X
+}
+
+static void heap_sort(void *base, size_t nmemb, size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    size_t e;
+
+    for(e=nmemb/2; e>0; e--)
+        sift_down(base, nmemb, size, e-1, compar, context);
+    for(e=nmemb-1; e>0; e--) {
+        swap(base, (char*)base+size*e, size);
+        sift_down(base, e, size, 0, compar, context);
+    }
+}
+
 static void quick_sort(void *base, size_t nmemb, size_t size,
         int (CDECL *compar)(void *, const void *, const void *), void *context)
 {
     size_t stack_lo[8*sizeof(size_t)], stack_hi[8*sizeof(size_t)];
+    unsigned int stack_depth[8*sizeof(size_t)];
     size_t beg, end, lo, hi, med;
+    unsigned int depth;
     int stack_pos;
 
+    /* fall back to heap sort when partitioning degenerates, like introsort does */
+    for(depth=0, lo=nmemb; lo>1; lo>>=1) depth += 2;
+
     stack_pos = 0;
     stack_lo[stack_pos] = 0;
     stack_hi[stack_pos] = nmemb-1;
+    stack_depth[stack_pos] = depth;
 
 #define X(i) ((char*)base+size*(i))
     while(stack_pos >= 0) {
         beg = stack_lo[stack_pos];
+        depth = stack_depth[stack_pos];
         end = stack_hi[stack_pos--];
 
         if(end-beg < 8) {
@@ -305,6 +364,11 @@ static void quick_sort(void *base, size_t nmemb, size_t size,
             continue;
         }
 
+        if(!depth--) {
+            heap_sort(X(beg), end-beg+1, size, compar, context);
+            continue;
+        }
+
         lo = beg;
         hi = end;
         med = lo + (hi-lo+1)/2;
@@ -349,13 +413,17 @@ static void quick_sort(void *base, size_t nmemb, size_t size,
         if(hi-beg >= end-lo) {
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
         }else {
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
         }
     }
 #undef X
@@ -34,6 +34,7 @@
 #undef wcsncpy
 
 extern BOOL sse2_supported;
+extern BOOL erms_supported;
 
 #define DBL80_MAX_10_EXP 4932
 #define DBL80_MIN_10_EXP -4951
@@ -180,6 +181,7 @@ struct __thread_data {
     _invalid_parameter_handler      invalid_parameter_handler;
     HMODULE                         module;
 #endif
+    void                           *heap_cache;         /* small blocks pool cache */
 };
 
 typedef struct __thread_data thread_data_t;
@@ -241,6 +243,7 @@ extern void msvcrt_free_signals(void);
 extern void msvcrt_free_popen_data(void);
 extern BOOL msvcrt_init_heap(void);
 extern void msvcrt_destroy_heap(void);
+extern void msvcrt_free_heap_cache(thread_data_t*);
 extern void msvcrt_init_clock(void);
 
 #if _MSVCR_VER >= 100
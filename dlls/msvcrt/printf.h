@@ -545,6 +545,7 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LON
 {
     unsigned int base;
     const char *digits;
+    ULONGLONG v = x;
     int i, j, k;
 
     if(flags->Format == 'o')
@@ -560,7 +561,7 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LON
         digits = "0123456789abcdefx";
 
     if(x<0 && (flags->Format=='d' || flags->Format=='i')) {
-        x = -x;
+        v = -v;
         flags->Sign = '-';
     }
 
@@ -569,12 +570,23 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LON
         flags->Alternate = FALSE;
         if(flags->Precision)
             buf[i++] = '0';
-    } else {
-        while(x != 0) {
-            j = (ULONGLONG)x%base;
-            x = (ULONGLONG)x/base;
-            buf[i++] = digits[j];
+    } else if(base == 10) {
+        DWORD d;
+
+        /* only do a 64-bit division once every LIMB_DIGITS digits */
+        while(v > 0xffffffff) {
+            d = v % LIMB_MAX;
+            v /= LIMB_MAX;
+            for(j = 0; j < LIMB_DIGITS; j++, d /= 10)
+                buf[i++] = '0' + d % 10;
         }
+        for(d = v; d; d /= 10)
+            buf[i++] = '0' + d % 10;
+    } else {
+        int shift = (base == 16 ? 4 : 3);
+
+        for(; v; v >>= shift)
+            buf[i++] = digits[v & (base - 1)];
     }
     k = flags->Precision-i;
     while(k-- > 0)
@@ -628,6 +640,24 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
         b->data[1] = m / LIMB_MAX;
         e2 -= MANT_BITS;
 
+        /* integral values that fit in 64 bits can be split into limbs directly */
+        if(e2 <= 64 - MANT_BITS && e2 > -MANT_BITS &&
+                (e2 >= 0 || !(m & (((ULONGLONG)1 << -e2) - 1)))) {
+            m = (e2 >= 0 ? m << e2 : m >> -e2);
+            b->data[0] = m % LIMB_MAX;
+            m /= LIMB_MAX;
+            b->data[1] = m % LIMB_MAX;
+            b->data[2] = m / LIMB_MAX;
+            if(b->data[2]) {
+                b->e = 3;
+                e10 = LIMB_DIGITS;
+            } else if(!b->data[1]) {
+                b->e = 1;
+                e10 = -LIMB_DIGITS;
+            }
+            e2 = 0;
+        }
+
         while(e2 > 0) {
             int shift = e2 > 29 ? 29 : e2;
             if(bnum_lshift(b, shift)) e10 += LIMB_DIGITS;
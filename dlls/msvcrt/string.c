@@ -1559,13 +1559,22 @@ int CDECL _atoldbl(_LDOUBLE *value, char *str)
     return _atoldbl_l( (MSVCRT__LDOUBLE*)value, str, NULL );
 }
 
+/* word at a time helpers, aligned word reads never cross a page boundary */
+#define WORD_ONES  (~(size_t)0 / 0xff)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+#define WORD_HAS_ZERO(x) (((x) - WORD_ONES) & ~(x) & WORD_HIGHS)
+
 /*********************************************************************
  *              strlen (MSVCRT.@)
  */
 size_t __cdecl strlen(const char *str)
 {
     const char *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    for (; (size_t)s % sizeof(size_t); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !WORD_HAS_ZERO(*w); w++) ;
+    for (s = (const char *)w; *s; s++) ;
     return s - str;
 }
 
@@ -3041,6 +3050,9 @@ __ASM_GLOBAL_FUNC( sse2_memmove,
 
 #endif
 
+/* below that size the startup cost of rep movsb/stosb outweighs its throughput */
+#define ERMS_MIN_SIZE 2048
+
 /*********************************************************************
  *                  memmove (MSVCRT.@)
  */
@@ -3051,6 +3063,15 @@ __ASM_GLOBAL_FUNC( sse2_memmove,
 #endif
 void * __cdecl memmove(void *dst, const void *src, size_t n)
 {
+#if defined(__i386__) || defined(__x86_64__)
+    /* rep movsb beats vector loops for large forward copies on CPUs with ERMS */
+    if (erms_supported && n >= ERMS_MIN_SIZE && (size_t)dst - (size_t)src >= n)
+    {
+        void *d = dst;
+        __asm__ __volatile__( "cld; rep; movsb" : "+D"(d), "+S"(src), "+c"(n) : : "memory" );
+        return dst;
+    }
+#endif
 #ifdef __x86_64__
     return sse2_memmove(dst, src, n);
 #else
@@ -3213,6 +3234,13 @@ void *__cdecl memset(void *dst, int c, size_t n)
         *(unaligned_ui64 *)(d + n - 24) = v;
         if (n <= 64) return dst;
 
+#if defined(__i386__) || defined(__x86_64__)
+        if (erms_supported && n >= ERMS_MIN_SIZE)
+        {
+            __asm__ __volatile__( "cld; rep; stosb" : "+D"(d), "+c"(n) : "a"(c) : "memory" );
+            return dst;
+        }
+#endif
         n = (n - a) & ~0x1f;
         memset_aligned_32(d + a, v, n);
         return dst;
@@ -3248,6 +3276,16 @@ void *__cdecl memset(void *dst, int c, size_t n)
  */
 char* __cdecl strchr(const char *str, int c)
 {
+    size_t mask = WORD_ONES * (unsigned char)c;
+    const size_t *w;
+
+    for (; (size_t)str % sizeof(size_t); str++)
+    {
+        if (*str == (char)c) return (char*)str;
+        if (!*str) return NULL;
+    }
+    for (w = (const size_t *)str; !WORD_HAS_ZERO(*w) && !WORD_HAS_ZERO(*w ^ mask); w++) ;
+    str = (const char *)w;
     do
     {
         if (*str == (char)c) return (char*)str;
@@ -3270,9 +3308,14 @@ char* __cdecl strrchr(const char *str, int c)
  */
 void* __cdecl memchr(const void *ptr, int c, size_t n)
 {
+    size_t mask = WORD_ONES * (unsigned char)c;
     const unsigned char *p = ptr;
+    const size_t *w;
 
-    for (p = ptr; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (; n && (size_t)p % sizeof(size_t); n--, p++)
+        if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (w = (const size_t *)p; n >= sizeof(size_t) && !WORD_HAS_ZERO(*w ^ mask); n -= sizeof(size_t)) w++;
+    for (p = (const unsigned char *)w; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
     return NULL;
 }
 
@@ -3281,7 +3324,18 @@ void* __cdecl memchr(const void *ptr, int c, size_t n)
  */
 int __cdecl strcmp(const char *str1, const char *str2)
 {
+    if ((size_t)str1 % sizeof(size_t) == (size_t)str2 % sizeof(size_t))
+    {
+        const size_t *w1, *w2;
+
+        for (; (size_t)str1 % sizeof(size_t); str1++, str2++)
+            if (!*str1 || *str1 != *str2) goto done;
+        for (w1 = (const size_t *)str1, w2 = (const size_t *)str2; *w1 == *w2 && !WORD_HAS_ZERO(*w1); w1++, w2++) ;
+        str1 = (const char *)w1;
+        str2 = (const char *)w2;
+    }
     while (*str1 && *str1 == *str2) { str1++; str2++; }
+done:
     if ((unsigned char)*str1 > (unsigned char)*str2) return 1;
     if ((unsigned char)*str1 < (unsigned char)*str2) return -1;
     return 0;
@@ -2732,6 +2732,51 @@ static void test__open_osfhandle(void)
     CloseHandle(tmp);
 }
 
+static void test_write_text_lf(void)
+{
+    static const int line_lens[] = { 0, 1, 2046, 2047, 2048, 5000, 3, 0 };
+    char *tempf, *inbuffer, *outbuffer, *expected;
+    int i, j, fd, len = 0, expected_len = 0;
+
+    outbuffer = malloc(16384);
+    expected = malloc(16384);
+    inbuffer = malloc(16384);
+    for (i = 0; i < ARRAY_SIZE(line_lens); i++)
+    {
+        for (j = 0; j < line_lens[i]; j++)
+            outbuffer[len++] = expected[expected_len++] = 'a' + j % 26;
+        outbuffer[len++] = '\n';
+        expected[expected_len++] = '\r';
+        expected[expected_len++] = '\n';
+    }
+    /* trailing data without a line feed */
+    memset(outbuffer + len, 'z', 3000);
+    memset(expected + expected_len, 'z', 3000);
+    len += 3000;
+    expected_len += 3000;
+
+    tempf = _tempnam(".", "wne");
+    fd = _open(tempf, _O_CREAT | _O_TRUNC | _O_TEXT | _O_WRONLY, _S_IREAD | _S_IWRITE);
+    ok(fd != -1, "can't open '%s': %d\n", tempf, errno);
+    ok(_write(fd, outbuffer, len) == len, "_write failed\n");
+    ok(_write(fd, "\n", 1) == 1, "_write failed\n");
+    ok(_write(fd, "zz", 2) == 2, "_write failed\n");
+    _close(fd);
+    memcpy(expected + expected_len, "\r\nzz", 4);
+    expected_len += 4;
+
+    fd = _open(tempf, _O_RDONLY | _O_BINARY);
+    ok(_read(fd, inbuffer, 16384) == expected_len, "got wrong length\n");
+    ok(!memcmp(inbuffer, expected, expected_len), "got wrong data\n");
+    _close(fd);
+
+    unlink(tempf);
+    free(tempf);
+    free(inbuffer);
+    free(outbuffer);
+    free(expected);
+}
+
 static void test_write_flush_size(FILE *file, int bufsize)
 {
     char *inbuffer;
@@ -3143,6 +3188,7 @@ START_TEST(file)
     test_file_inherit(arg_v[0]);
     test_invalid_stdin(arg_v[0]);
     test_file_write_read();
+    test_write_text_lf();
     test_chsize();
     test_stat();
     test_unlink();
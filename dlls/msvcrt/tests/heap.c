@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <malloc.h>
 #include <errno.h>
+#include <stdio.h>
+#include <string.h>
 #include "wine/test.h"
 
 static void (__cdecl *p_aligned_free)(void*);
@@ -494,10 +496,105 @@ static void test_calloc(void)
     free(ptr);
 }
 
+static DWORD WINAPI pool_free_thread(void *arg)
+{
+    void **blocks = arg;
+    unsigned int i;
+
+    for (i = 0; i < 256; i++) free(blocks[i]);
+    return 0;
+}
+
+static void test_pool_child(void)
+{
+    void *blocks[256], *mem, *mem2;
+    _HEAPINFO info;
+    unsigned int i;
+    HANDLE thread;
+    BOOL found;
+    int ret;
+
+    for (i = 0; i < ARRAY_SIZE(blocks); i++)
+    {
+        blocks[i] = malloc(i * 4);
+        ok(blocks[i] != NULL, "malloc(%u) failed\n", i * 4);
+        ok(_msize(blocks[i]) == i * 4, "_msize returned %Iu, expected %u\n", _msize(blocks[i]), i * 4);
+        memset(blocks[i], i, i * 4);
+    }
+    for (i = 1; i < ARRAY_SIZE(blocks); i++)
+        ok(((unsigned char *)blocks[i])[i * 4 - 1] == (i & 0xff), "block %u corrupted\n", i);
+
+    /* free the blocks from another thread */
+    thread = CreateThread(NULL, 0, pool_free_thread, blocks, 0, NULL);
+    ok(thread != NULL, "CreateThread failed\n");
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+
+    mem = malloc(20);
+    ok(mem != NULL, "malloc failed\n");
+    memset(mem, 0xcc, 20);
+    mem2 = _expand(mem, 24);
+    if (mem2)
+    {
+        ok(mem2 == mem, "_expand moved the block\n");
+        ok(_msize(mem) == 24, "_msize returned %Iu\n", _msize(mem));
+    }
+    mem = realloc(mem, 2000);
+    ok(mem != NULL, "realloc failed\n");
+    ok(((unsigned char *)mem)[19] == 0xcc, "block contents not preserved\n");
+    ok(_msize(mem) == 2000, "_msize returned %Iu\n", _msize(mem));
+    mem = realloc(mem, 100);
+    ok(mem != NULL, "realloc failed\n");
+    ok(((unsigned char *)mem)[19] == 0xcc, "block contents not preserved\n");
+
+    mem2 = calloc(1, 48);
+    ok(mem2 != NULL, "calloc failed\n");
+    for (i = 0; i < 48; i++) if (((unsigned char *)mem2)[i]) break;
+    ok(i == 48, "calloc block not zeroed\n");
+
+    memset(&info, 0, sizeof(info));
+    found = FALSE;
+    while ((ret = _heapwalk(&info)) == _HEAPOK)
+        if (info._pentry == mem2 && info._useflag == _USEDENTRY && info._size == 48) found = TRUE;
+    ok(ret == _HEAPEND, "_heapwalk returned %d\n", ret);
+    ok(found, "block %p not found by _heapwalk\n", mem2);
+
+    free(mem2);
+    free(mem);
+}
+
+static void test_pool(void)
+{
+    PROCESS_INFORMATION info;
+    STARTUPINFOA startup;
+    char cmdline[MAX_PATH + 32];
+    char **argv;
+
+    winetest_get_mainargs(&argv);
+    sprintf(cmdline, "\"%s\" heap pool", argv[0]);
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+
+    SetEnvironmentVariableA("WINEMSVCRTPOOL", "1");
+    ok(CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &startup, &info),
+       "CreateProcess failed, error %lu\n", GetLastError());
+    SetEnvironmentVariableA("WINEMSVCRTPOOL", NULL);
+    winetest_wait_child_process(info.hProcess);
+    CloseHandle(info.hProcess);
+    CloseHandle(info.hThread);
+}
+
 START_TEST(heap)
 {
+    char **argv;
     void *mem;
 
+    if (winetest_get_mainargs(&argv) >= 3 && !strcmp(argv[2], "pool"))
+    {
+        test_pool_child();
+        return;
+    }
+
     mem = malloc(0);
     ok(mem != NULL, "memory not allocated for size 0\n");
     free(mem);
@@ -519,4 +616,5 @@ START_TEST(heap)
     test_aligned();
     test_sbheap();
     test_calloc();
+    test_pool();
 }
@@ -434,10 +434,22 @@ static int __cdecl qsort_comp(void *ctx, const void *l, const void *r)
     return *(int*)l%1000 - *(int*)r%1000;
 }
 
+static int __cdecl qsort_comp64(void *ctx, const void *l, const void *r)
+{
+    return *(const LONGLONG*)l < *(const LONGLONG*)r ? -1 : *(const LONGLONG*)l > *(const LONGLONG*)r;
+}
+
+static int __cdecl qsort_comp3(void *ctx, const void *l, const void *r)
+{
+    return memcmp(l, r, 3);
+}
+
 static void test_qsort_s(void)
 {
     static const int nonstable_test[] = {9000, 8001, 7002, 6003, 1003, 5004, 4005, 3006, 2007};
+    unsigned char bytes[99];
     int tab[100], i;
+    LONGLONG *big;
 
     struct qsort_test small_sort = {
         0, tab, {
@@ -525,6 +537,20 @@ static void test_qsort_s(void)
     p_qsort_s(tab, 100, sizeof(int), qsort_comp, NULL);
     for(i=0; i<100; i++)
         ok(tab[i] == i, "data sorted incorrectly on position %d: %d\n", i, tab[i]);
+
+    /* organ pipe input degrades median of three partitioning */
+    big = malloc(10000 * sizeof(*big));
+    for(i=0; i<10000; i++) big[i] = i < 5000 ? i : 10000-i;
+    p_qsort_s(big, 10000, sizeof(*big), qsort_comp64, NULL);
+    for(i=1; i<10000; i++)
+        ok(big[i-1] <= big[i], "data sorted incorrectly on position %d\n", i);
+    free(big);
+
+    /* elements not multiple of the word size */
+    for(i=0; i<99; i++) bytes[i] = rand();
+    p_qsort_s(bytes, 33, 3, qsort_comp3, NULL);
+    for(i=1; i<33; i++)
+        ok(memcmp(bytes + 3*(i-1), bytes + 3*i, 3) <= 0, "data sorted incorrectly on position %d\n", i);
 }
 
 static int eq_nan(UINT64 ai, double b)
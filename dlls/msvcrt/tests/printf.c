@@ -251,6 +251,19 @@ static void test_sprintf( void )
         { "%.0f", "-1", 0, DOUBLE_ARG, 0, 0, -0.5 },
         { "%.0f", "1", 0, DOUBLE_ARG, 0, 0, 0.5 },
         { "%.0f", "2", 0, DOUBLE_ARG, 0, 0, 1.5 },
+        { "%I64u", "18446744073709551615", 0, ULONGLONG_ARG, 0, ~(ULONGLONG)0 },
+        { "%I64d", "-9223372036854775808", 0, ULONGLONG_ARG, 0, (ULONGLONG)1 << 63 },
+        { "%I64d", "1000000000000000000", 0, ULONGLONG_ARG, 0, 1000000000000000000 },
+        { "%#I64o", "01777777777777777777777", 0, ULONGLONG_ARG, 0, ~(ULONGLONG)0 },
+        { "%#I64X", "0X123456789ABCDEF0", 0, ULONGLONG_ARG, 0, 0x123456789abcdef0 },
+        { "%f", "1000000000.000000", 0, DOUBLE_ARG, 0, 0, 1000000000.0 },
+        { "%f", "18446744073709549568.000000", 0, DOUBLE_ARG, 0, 0, 18446744073709549568.0 },
+        { "%f", "18446744073709551616.000000", 0, DOUBLE_ARG, 0, 0, 18446744073709551616.0 },
+        { "%.3e", "1.235e+025", 0, DOUBLE_ARG, 0, 0, 12345678901234567890123456.0 },
+        { "%.3e", "-9.877e+008", 0, DOUBLE_ARG, 0, 0, -987654321.0 },
+        { "%g", "100", 0, DOUBLE_ARG, 0, 0, 100.0 },
+        { "%g", "1e+015", 0, DOUBLE_ARG, 0, 0, 1e15 },
+        { "%.20g", "4294967296", 0, DOUBLE_ARG, 0, 0, 4294967296.0 },
         { "%.30f", "0.333333333333333310000000000000", 0, TODO_FLAG | DOUBLE_ARG, 0, 0, 1.0/3.0 },
         { "%.30lf", "1.414213562373095100000000000000", 0, TODO_FLAG | DOUBLE_ARG, 0, 0, sqrt(2) },
     };
@@ -58,6 +58,13 @@ static char *buf_to_string(const unsigned char *bin, int len, int nr)
 static void* (__cdecl *pmemcpy)(void *, const void *, size_t n);
 static int (__cdecl *p_memcpy_s)(void *, size_t, const void *, size_t);
 static int (__cdecl *p_memmove_s)(void *, size_t, const void *, size_t);
+static void * (__cdecl *p_memmove)(void *, const void *, size_t);
+static void * (__cdecl *p_memset)(void *, int, size_t);
+static size_t (__cdecl *p_strlen)(const char *);
+static char * (__cdecl *p_strchr)(const char *, int);
+static void * (__cdecl *p_memchr)(const void *, int, size_t);
+static size_t (__cdecl *p_wcslen)(const wchar_t *);
+static int (__cdecl *p_wcscmp)(const wchar_t *, const wchar_t *);
 static int* (__cdecl *pmemcmp)(void *, const void *, size_t n);
 static int (__cdecl *p_strcmp)(const char *, const char *);
 static int (__cdecl *p_strncmp)(const char *, const char *, size_t);
@@ -934,6 +941,86 @@ static void test_memcpy_s(void)
     ok(!memcmp(buf, big, sizeof(big)), "unexpected buf\n");
 }
 
+static void test_memmove_sizes(void)
+{
+    static const size_t sizes[] = { 1, 15, 64, 65, 1000, 2047, 2048, 2049, 4096 + 3, 65536 + 17 };
+    static const int offsets[] = { 0, 1, 7, 32, -1, -33 };
+    unsigned char *buf = malloc( 3 * 65600 ), *ref = malloc( 3 * 65600 );
+    unsigned int i, j, k;
+    void *ret;
+
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(offsets); j++)
+        {
+            unsigned char *src = buf + 65600, *dst = src + offsets[j];
+
+            for (k = 0; k < 3 * 65600; k++) buf[k] = ref[k] = k * 7 + 1;
+            for (k = 0; k < sizes[i]; k++) ref[65600 + offsets[j] + k] = buf[65600 + k];
+
+            ret = p_memmove( dst, src, sizes[i] );
+            ok( ret == dst, "got %p, expected %p\n", ret, dst );
+            ok( !memcmp( buf, ref, 3 * 65600 ), "memmove size %Iu offset %d failed\n", sizes[i], offsets[j] );
+        }
+
+        for (k = 0; k < 3 * 65600; k++) buf[k] = ref[k] = k * 7 + 1;
+        for (k = 0; k < sizes[i]; k++) ref[3 + k] = 0xa5;
+        ret = p_memset( buf + 3, 0x1a5, sizes[i] );
+        ok( ret == buf + 3, "got %p, expected %p\n", ret, buf + 3 );
+        ok( !memcmp( buf, ref, 3 * 65600 ), "memset size %Iu failed\n", sizes[i] );
+    }
+    free( buf );
+    free( ref );
+}
+
+static void test_string_alignment(void)
+{
+    char *buf = VirtualAlloc( NULL, 0x2000, MEM_COMMIT, PAGE_READWRITE ), *str, cmp[64];
+    wchar_t *wstr, wcmp[32];
+    unsigned int len, align, i;
+    DWORD old;
+
+    /* strings ending right before an inaccessible page */
+    VirtualProtect( buf + 0x1000, 0x1000, PAGE_NOACCESS, &old );
+    for (len = 0; len < 40; len++)
+    {
+        for (align = 0; align < 16; align++)
+        {
+            str = buf + 0x1000 - len - 1 - align;
+            memset( str, 'a', len );
+            str[len] = 0;
+            if (len) str[len - 1] = 'b';
+
+            ok( p_strlen( str ) == len, "%u/%u: got %Iu\n", len, align, p_strlen( str ));
+            ok( p_strchr( str, 'b' ) == (len ? str + len - 1 : NULL), "%u/%u: wrong strchr\n", len, align );
+            ok( p_strchr( str, 0 ) == str + len, "%u/%u: wrong strchr\n", len, align );
+            ok( p_memchr( str, 'b', len ) == (len ? str + len - 1 : NULL), "%u/%u: wrong memchr\n", len, align );
+
+            memcpy( cmp + (align * 3) % 8, str, len + 1 );
+            ok( !p_strcmp( str, cmp + (align * 3) % 8 ), "%u/%u: strings differ\n", len, align );
+            if (len)
+            {
+                cmp[(align * 3) % 8 + len - 1] = 'c';
+                ok( p_strcmp( str, cmp + (align * 3) % 8 ) < 0, "%u/%u: wrong strcmp\n", len, align );
+            }
+
+            if (len >= ARRAY_SIZE(wcmp)) continue;
+            wstr = (wchar_t *)(buf + 0x1000) - len - 1 - align / 2;
+            for (i = 0; i < len; i++) wstr[i] = 0x8000 + i;
+            wstr[len] = 0;
+            ok( p_wcslen( wstr ) == len, "%u/%u: got %Iu\n", len, align, p_wcslen( wstr ));
+            memcpy( wcmp + align % 4, wstr, (len + 1) * sizeof(wchar_t) );
+            ok( !p_wcscmp( wstr, wcmp + align % 4 ), "%u/%u: strings differ\n", len, align );
+            if (len)
+            {
+                wcmp[align % 4 + len - 1] = 0x7fff;
+                ok( p_wcscmp( wstr, wcmp + align % 4 ) > 0, "%u/%u: wrong wcscmp\n", len, align );
+            }
+        }
+    }
+    VirtualFree( buf, 0, MEM_RELEASE );
+}
+
 static void test_memmove_s(void)
 {
     static char dest[8];
@@ -4705,12 +4792,19 @@ START_TEST(string)
     SET(pmemcpy,"memcpy");
     p_memcpy_s = (void*)GetProcAddress( hMsvcrt, "memcpy_s" );
     p_memmove_s = (void*)GetProcAddress( hMsvcrt, "memmove_s" );
+    p_memmove = (void*)GetProcAddress( hMsvcrt, "memmove" );
+    p_memset = (void*)GetProcAddress( hMsvcrt, "memset" );
     SET(pmemcmp,"memcmp");
     SET(p_mbctype,"_mbctype");
     SET(p__mb_cur_max,"__mb_cur_max");
     SET(p_strcpy, "strcpy");
     SET(p_strcmp, "strcmp");
     SET(p_strncmp, "strncmp");
+    SET(p_strlen, "strlen");
+    SET(p_strchr, "strchr");
+    SET(p_memchr, "memchr");
+    SET(p_wcslen, "wcslen");
+    SET(p_wcscmp, "wcscmp");
     pstrcpy_s = (void *)GetProcAddress( hMsvcrt,"strcpy_s" );
     pstrcat_s = (void *)GetProcAddress( hMsvcrt,"strcat_s" );
     p_strncpy_s = (void *)GetProcAddress( hMsvcrt, "strncpy_s" );
@@ -4789,6 +4883,8 @@ START_TEST(string)
     test_strcpy_s();
     test_memcpy_s();
     test_memmove_s();
+    test_memmove_sizes();
+    test_string_alignment();
     test_strcat_s();
     test_strncat_s();
     test__mbscat_s();
@@ -1962,17 +1962,33 @@ int WINAPIV _swprintf_p_l(wchar_t *buffer, size_t length,
     return r;
 }
 
+/* word at a time helpers, aligned word reads never cross a page boundary */
+#define WORD_ONES16  (~(size_t)0 / 0xffff)
+#define WORD_HIGHS16 (WORD_ONES16 * 0x8000)
+#define WORD_HAS_ZERO16(x) (((x) - WORD_ONES16) & ~(x) & WORD_HIGHS16)
+
 /*********************************************************************
  *              wcscmp (MSVCRT.@)
  */
 int CDECL wcscmp(const wchar_t *str1, const wchar_t *str2)
 {
+    if ((size_t)str1 % sizeof(size_t) == (size_t)str2 % sizeof(size_t) && !((size_t)str1 % sizeof(wchar_t)))
+    {
+        const size_t *w1, *w2;
+
+        for (; (size_t)str1 % sizeof(size_t); str1++, str2++)
+            if (!*str1 || *str1 != *str2) goto done;
+        for (w1 = (const size_t *)str1, w2 = (const size_t *)str2; *w1 == *w2 && !WORD_HAS_ZERO16(*w1); w1++, w2++) ;
+        str1 = (const wchar_t *)w1;
+        str2 = (const wchar_t *)w2;
+    }
     while (*str1 && (*str1 == *str2))
     {
         str1++;
         str2++;
     }
 
+done:
     if (*str1 < *str2)
         return -1;
     if (*str1 > *str2)
@@ -2969,7 +2985,16 @@ wchar_t* CDECL wcsrchr(const wchar_t *str, wchar_t ch)
 size_t CDECL wcslen(const wchar_t *str)
 {
     const wchar_t *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    if ((size_t)s % sizeof(wchar_t))
+    {
+        while (*s) s++;
+        return s - str;
+    }
+    for (; (size_t)s % sizeof(size_t); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !WORD_HAS_ZERO16(*w); w++) ;
+    for (s = (const wchar_t *)w; *s; s++) ;
     return s - str;
 }
 
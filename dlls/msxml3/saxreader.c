@@ -38,6 +38,7 @@
 #include "shlwapi.h"
 
 #include "wine/debug.h"
+#include "wine/rbtree.h"
 
 #include "msxml_private.h"
 
@@ -161,13 +162,28 @@ typedef struct
 typedef struct
 {
     struct list entry;
-    BSTR prefix;
     BSTR local;
     BSTR qname;
     ns *ns; /* namespaces defined in this particular element */
     int ns_count;
 } element_entry;
 
+/* element and attribute names, converted once per parse */
+struct name_entry
+{
+    struct rb_entry entry;
+    xmlChar *prefix;
+    xmlChar *local;
+    BSTR bstr_local;
+    BSTR qname;
+};
+
+struct name_key
+{
+    const xmlChar *prefix;
+    const xmlChar *local;
+};
+
 enum saxhandler_type
 {
     SAXContentHandler = 0,
@@ -305,6 +321,7 @@ typedef struct
     int column;
     BOOL vbInterface;
     struct list elements;
+    struct rb_tree names;
 
     BSTR namespaceUri;
     int attr_alloc_count;
@@ -460,18 +477,78 @@ static BSTR build_qname(BSTR prefix, BSTR local)
         return SysAllocString(local);
 }
 
-static element_entry* alloc_element_entry(const xmlChar *local, const xmlChar *prefix, int nb_ns,
-    const xmlChar **namespaces)
+static int name_entry_compare(const void *key, const struct rb_entry *entry)
 {
+    const struct name_entry *name = RB_ENTRY_VALUE(entry, struct name_entry, entry);
+    const struct name_key *k = key;
+    int ret;
+
+    if ((ret = xmlStrcmp(k->prefix, name->prefix))) return ret;
+    return xmlStrcmp(k->local, name->local);
+}
+
+static void free_name_entry(struct rb_entry *entry, void *context)
+{
+    struct name_entry *name = RB_ENTRY_VALUE(entry, struct name_entry, entry);
+
+    xmlFree(name->prefix);
+    xmlFree(name->local);
+    SysFreeString(name->bstr_local);
+    SysFreeString(name->qname);
+    free(name);
+}
+
+/* returned strings are owned by the locator and stay valid until it's released */
+static struct name_entry *get_name_entry(saxlocator *locator, const xmlChar *prefix, const xmlChar *local)
+{
+    struct name_entry *name;
+    struct name_key key;
+    struct rb_entry *entry;
+
+    key.prefix = prefix ? prefix : (const xmlChar *)"";
+    key.local = local;
+    if ((entry = rb_get(&locator->names, &key)))
+        return RB_ENTRY_VALUE(entry, struct name_entry, entry);
+
+    if (!(name = calloc(1, sizeof(*name)))) return NULL;
+    name->prefix = xmlStrdup(key.prefix);
+    name->local = xmlStrdup(local);
+    if (!name->prefix || !name->local || !(name->bstr_local = bstr_from_xmlChar(local)))
+    {
+        free_name_entry(&name->entry, NULL);
+        return NULL;
+    }
+    if (*key.prefix)
+    {
+        BSTR bstr_prefix = bstr_from_xmlChar(key.prefix);
+        name->qname = bstr_prefix ? build_qname(bstr_prefix, name->bstr_local) : NULL;
+        SysFreeString(bstr_prefix);
+    }
+    else
+        name->qname = SysAllocStringLen(name->bstr_local, SysStringLen(name->bstr_local));
+    if (!name->qname)
+    {
+        free_name_entry(&name->entry, NULL);
+        return NULL;
+    }
+
+    rb_put(&locator->names, &key, &name->entry);
+    return name;
+}
+
+static element_entry* alloc_element_entry(saxlocator *locator, const xmlChar *local, const xmlChar *prefix,
+    int nb_ns, const xmlChar **namespaces)
+{
+    struct name_entry *name;
     element_entry *ret;
     int i;
 
     ret = malloc(sizeof(*ret));
     if (!ret) return ret;
 
-    ret->local  = bstr_from_xmlChar(local);
-    ret->prefix = bstr_from_xmlChar(prefix);
-    ret->qname  = build_qname(ret->prefix, ret->local);
+    name = get_name_entry(locator, prefix, local);
+    ret->local  = name ? name->bstr_local : NULL;
+    ret->qname  = name ? name->qname : NULL;
     ret->ns = nb_ns ? malloc(nb_ns * sizeof(ns)) : NULL;
     ret->ns_count = nb_ns;
 
@@ -494,10 +571,6 @@ static void free_element_entry(element_entry *element)
         SysFreeString(element->ns[i].uri);
     }
 
-    SysFreeString(element->prefix);
-    SysFreeString(element->local);
-    SysFreeString(element->qname);
-
     free(element->ns);
     free(element);
 }
@@ -621,23 +694,6 @@ static BSTR bstr_from_xmlCharN(const xmlChar *buf, int len)
     return bstr;
 }
 
-static BSTR QName_from_xmlChar(const xmlChar *prefix, const xmlChar *name)
-{
-    xmlChar *qname;
-    BSTR bstr;
-
-    if(!name) return NULL;
-
-    if(!prefix || !*prefix)
-        return bstr_from_xmlChar(name);
-
-    qname = xmlBuildQName(name, prefix, NULL, 0);
-    bstr = bstr_from_xmlChar(qname);
-    xmlFree(qname);
-
-    return bstr;
-}
-
 static BSTR pooled_bstr_from_xmlChar(struct bstrpool *pool, const xmlChar *buf)
 {
     BSTR pool_entry = bstr_from_xmlChar(buf);
@@ -1432,13 +1488,11 @@ static void free_attribute_values(saxlocator *locator)
 
     for (i = 0; i < locator->attr_count; i++)
     {
-        SysFreeString(locator->attributes[i].szLocalname);
         locator->attributes[i].szLocalname = NULL;
 
         SysFreeString(locator->attributes[i].szValue);
         locator->attributes[i].szValue = NULL;
 
-        SysFreeString(locator->attributes[i].szQName);
         locator->attributes[i].szQName = NULL;
     }
 }
@@ -1448,8 +1502,8 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
         int nb_attributes, const xmlChar **xmlAttributes)
 {
     static const xmlChar xmlns[] = "xmlns";
-    static const WCHAR xmlnsW[] = { 'x','m','l','n','s',0 };
 
+    struct name_entry *name;
     struct _attributes *attrs;
     int i;
 
@@ -1480,19 +1534,19 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
 
     for (i = 0; i < nb_namespaces; i++)
     {
-        SysFreeString(attrs[nb_attributes+i].szLocalname);
-        attrs[nb_attributes+i].szLocalname = SysAllocStringLen(NULL, 0);
+        name = get_name_entry(locator, NULL, (const xmlChar *)"");
+        attrs[nb_attributes+i].szLocalname = name ? name->bstr_local : NULL;
 
         attrs[nb_attributes+i].szURI = locator->namespaceUri;
 
         SysFreeString(attrs[nb_attributes+i].szValue);
         attrs[nb_attributes+i].szValue = bstr_from_xmlChar(xmlNamespaces[2*i+1]);
 
-        SysFreeString(attrs[nb_attributes+i].szQName);
         if(!xmlNamespaces[2*i])
-            attrs[nb_attributes+i].szQName = SysAllocString(xmlnsW);
+            name = get_name_entry(locator, NULL, xmlns);
         else
-            attrs[nb_attributes+i].szQName = QName_from_xmlChar(xmlns, xmlNamespaces[2*i]);
+            name = get_name_entry(locator, xmlns, xmlNamespaces[2*i]);
+        attrs[nb_attributes+i].szQName = name ? name->qname : NULL;
     }
 
     for (i = 0; i < nb_attributes; i++)
@@ -1505,14 +1559,12 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
             /* that's an important feature to keep same uri pointer for every reported attribute */
             attrs[i].szURI = find_element_uri(locator, xmlAttributes[i*5+2]);
 
-        SysFreeString(attrs[i].szLocalname);
-        attrs[i].szLocalname = bstr_from_xmlChar(xmlAttributes[i*5]);
+        name = get_name_entry(locator, xmlAttributes[i*5+1], xmlAttributes[i*5]);
+        attrs[i].szLocalname = name ? name->bstr_local : NULL;
+        attrs[i].szQName = name ? name->qname : NULL;
 
         SysFreeString(attrs[i].szValue);
         attrs[i].szValue = saxreader_get_unescaped_value(xmlAttributes[i*5+3], xmlAttributes[i*5+4]-xmlAttributes[i*5+3]);
-
-        SysFreeString(attrs[i].szQName);
-        attrs[i].szQName = QName_from_xmlChar(xmlAttributes[i*5+1], xmlAttributes[i*5]);
     }
 
     return S_OK;
@@ -1612,7 +1664,7 @@ static void libxmlStartElementNS(
     if(This->saxreader->version < MSXML4)
         This->column++;
 
-    element = alloc_element_entry(localname, prefix, nb_namespaces, namespaces);
+    element = alloc_element_entry(This, localname, prefix, nb_namespaces, namespaces);
     push_element_ns(This, element);
 
     if (is_namespaces_enabled(This->saxreader))
@@ -2332,11 +2384,7 @@ static ULONG WINAPI isaxlocator_Release(
         SysFreeString(This->namespaceUri);
 
         for(index = 0; index < This->attr_alloc_count; index++)
-        {
-            SysFreeString(This->attributes[index].szLocalname);
             SysFreeString(This->attributes[index].szValue);
-            SysFreeString(This->attributes[index].szQName);
-        }
         free(This->attributes);
 
         /* element stack */
@@ -2345,6 +2393,7 @@ static ULONG WINAPI isaxlocator_Release(
             list_remove(&element->entry);
             free_element_entry(element);
         }
+        rb_destroy(&This->names, free_name_entry, NULL);
 
         ISAXXMLReader_Release(&This->saxreader->ISAXXMLReader_iface);
         free(This);
@@ -2479,6 +2528,7 @@ static HRESULT SAXLocator_create(saxreader *reader, saxlocator **ppsaxlocator, B
     }
 
     list_init(&locator->elements);
+    rb_init(&locator->names, name_entry_compare);
 
     *ppsaxlocator = locator;
 
@@ -188,6 +188,18 @@ struct guid_index
     ULONG rosterindex;
 };
 
+struct string_lookup
+{
+    ULONG hash;
+    ULONG pos;         /* position in the string index */
+};
+
+struct guid_lookup
+{
+    GUID  guid;
+    ULONG pos;         /* position in the guid index */
+};
+
 struct wndclass_redirect_data
 {
     ULONG size;
@@ -582,6 +594,15 @@ typedef struct _ACTIVATION_CONTEXT
     struct guidsection_header *comserver_section;
     struct guidsection_header *ifaceps_section;
     struct guidsection_header *clrsurrogate_section;
+    /* sorted lookup tables for the section indexes */
+    struct string_lookup      *wndclass_lookup;
+    struct string_lookup      *dllredirect_lookup;
+    struct string_lookup      *progid_lookup;
+    struct string_lookup      *activatable_class_lookup;
+    struct guid_lookup        *tlib_lookup;
+    struct guid_lookup        *comserver_lookup;
+    struct guid_lookup        *ifaceps_lookup;
+    struct guid_lookup        *clrsurrogate_lookup;
 } ACTIVATION_CONTEXT;
 
 struct actctx_loader
@@ -1130,6 +1151,14 @@ static void actctx_release( ACTIVATION_CONTEXT *actctx )
         RtlFreeHeap( GetProcessHeap(), 0, actctx->clrsurrogate_section );
         RtlFreeHeap( GetProcessHeap(), 0, actctx->progid_section );
         RtlFreeHeap( GetProcessHeap(), 0, actctx->activatable_class_section );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->wndclass_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->dllredirect_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->progid_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->activatable_class_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->tlib_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->comserver_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->ifaceps_lookup );
+        RtlFreeHeap( GetProcessHeap(), 0, actctx->clrsurrogate_lookup );
         actctx->magic = 0;
         RtlFreeHeap( GetProcessHeap(), 0, actctx );
     }
@@ -3568,53 +3597,131 @@ static NTSTATUS build_dllredirect_section(ACTIVATION_CONTEXT* actctx, struct str
     return STATUS_SUCCESS;
 }
 
-static struct string_index *find_string_index(const struct strsection_header *section, const UNICODE_STRING *name)
+static int __cdecl string_lookup_compare(const void *a, const void *b)
 {
-    struct string_index *iter, *index = NULL;
-    UNICODE_STRING str;
-    ULONG hash = 0, i;
+    const struct string_lookup *l1 = a, *l2 = b;
 
-    RtlHashUnicodeString(name, TRUE, HASH_STRING_ALGORITHM_X65599, &hash);
-    iter = (struct string_index*)((BYTE*)section + section->index_offset);
+    if (l1->hash != l2->hash) return l1->hash < l2->hash ? -1 : 1;
+    return l1->pos < l2->pos ? -1 : l1->pos > l2->pos;
+}
+
+static int __cdecl guid_lookup_compare(const void *a, const void *b)
+{
+    const struct guid_lookup *l1 = a, *l2 = b;
+    int ret;
+
+    if ((ret = memcmp(&l1->guid, &l2->guid, sizeof(l1->guid)))) return ret;
+    return l1->pos < l2->pos ? -1 : l1->pos > l2->pos;
+}
+
+/* sort the index entries of a section by hash, entries with the same hash stay in index order */
+static struct string_lookup *get_string_lookup(const struct strsection_header *section, struct string_lookup **lookup)
+{
+    const struct string_index *index = (const struct string_index *)((const BYTE *)section + section->index_offset);
+    struct string_lookup *table;
+    ULONG i;
 
+    if (*lookup) return *lookup;
+    if (!(table = RtlAllocateHeap(GetProcessHeap(), 0, max(section->count, 1) * sizeof(*table)))) return NULL;
     for (i = 0; i < section->count; i++)
     {
-        if (iter->hash == hash)
-        {
-            str.Buffer = (WCHAR *)((BYTE *)section + iter->name_offset);
-            str.Length = iter->name_len;
-            if (RtlEqualUnicodeString( &str, name, TRUE ))
-            {
-                index = iter;
-                break;
-            }
-            else
-                WARN("hash collision 0x%08lx, %s, %s\n", hash, debugstr_us(name), debugstr_us(&str));
-        }
-        iter++;
+        table[i].hash = index[i].hash;
+        table[i].pos = i;
     }
+    qsort(table, section->count, sizeof(*table), string_lookup_compare);
 
-    return index;
+    if (InterlockedCompareExchangePointer((void **)lookup, table, NULL))
+        RtlFreeHeap(GetProcessHeap(), 0, table);
+    return *lookup;
 }
 
-static struct guid_index *find_guid_index(const struct guidsection_header *section, const GUID *guid)
+static struct guid_lookup *get_guid_lookup(const struct guidsection_header *section, struct guid_lookup **lookup)
 {
-    struct guid_index *iter, *index = NULL;
+    const struct guid_index *index = (const struct guid_index *)((const BYTE *)section + section->index_offset);
+    struct guid_lookup *table;
     ULONG i;
 
-    iter = (struct guid_index*)((BYTE*)section + section->index_offset);
-
+    if (*lookup) return *lookup;
+    if (!(table = RtlAllocateHeap(GetProcessHeap(), 0, max(section->count, 1) * sizeof(*table)))) return NULL;
     for (i = 0; i < section->count; i++)
     {
-        if (!memcmp(guid, &iter->guid, sizeof(*guid)))
-        {
-            index = iter;
-            break;
-        }
-        iter++;
+        table[i].guid = index[i].guid;
+        table[i].pos = i;
+    }
+    qsort(table, section->count, sizeof(*table), guid_lookup_compare);
+
+    if (InterlockedCompareExchangePointer((void **)lookup, table, NULL))
+        RtlFreeHeap(GetProcessHeap(), 0, table);
+    return *lookup;
+}
+
+static BOOL string_index_matches(const struct strsection_header *section, const struct string_index *index,
+                                 ULONG hash, const UNICODE_STRING *name)
+{
+    UNICODE_STRING str;
+
+    if (index->hash != hash) return FALSE;
+    str.Buffer = (WCHAR *)((BYTE *)section + index->name_offset);
+    str.Length = index->name_len;
+    if (RtlEqualUnicodeString( &str, name, TRUE )) return TRUE;
+    WARN("hash collision 0x%08lx, %s, %s\n", hash, debugstr_us(name), debugstr_us(&str));
+    return FALSE;
+}
+
+static struct string_index *find_string_index(const struct strsection_header *section,
+                                              struct string_lookup **lookup, const UNICODE_STRING *name)
+{
+    struct string_index *index = (struct string_index*)((BYTE*)section + section->index_offset);
+    struct string_lookup *table;
+    ULONG hash = 0, i, min, max;
+
+    RtlHashUnicodeString(name, TRUE, HASH_STRING_ALGORITHM_X65599, &hash);
+
+    if (!(table = get_string_lookup(section, lookup)))
+    {
+        for (i = 0; i < section->count; i++)
+            if (string_index_matches(section, &index[i], hash, name)) return &index[i];
+        return NULL;
+    }
+
+    /* find the first entry with a matching hash */
+    min = 0;
+    max = section->count;
+    while (min < max)
+    {
+        ULONG pos = (min + max) / 2;
+        if (table[pos].hash < hash) min = pos + 1;
+        else max = pos;
+    }
+    for (i = min; i < section->count && table[i].hash == hash; i++)
+        if (string_index_matches(section, &index[table[i].pos], hash, name)) return &index[table[i].pos];
+    return NULL;
+}
+
+static struct guid_index *find_guid_index(const struct guidsection_header *section,
+                                          struct guid_lookup **lookup, const GUID *guid)
+{
+    struct guid_index *index = (struct guid_index*)((BYTE*)section + section->index_offset);
+    struct guid_lookup *table;
+    ULONG i, min, max;
+
+    if (!(table = get_guid_lookup(section, lookup)))
+    {
+        for (i = 0; i < section->count; i++)
+            if (!memcmp(guid, &index[i].guid, sizeof(*guid))) return &index[i];
+        return NULL;
     }
 
-    return index;
+    min = 0;
+    max = section->count;
+    while (min < max)
+    {
+        ULONG pos = (min + max) / 2;
+        if (memcmp(&table[pos].guid, guid, sizeof(*guid)) < 0) min = pos + 1;
+        else max = pos;
+    }
+    if (min < section->count && !memcmp(&table[min].guid, guid, sizeof(*guid))) return &index[table[min].pos];
+    return NULL;
 }
 
 static inline struct dllredirect_data *get_dllredirect_data(ACTIVATION_CONTEXT *ctxt, struct string_index *index)
@@ -3641,7 +3748,7 @@ static NTSTATUS find_dll_redirection(ACTIVATION_CONTEXT* actctx, const UNICODE_S
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_string_index(actctx->dllredirect_section, name);
+    index = find_string_index(actctx->dllredirect_section, &actctx->dllredirect_lookup, name);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     if (data)
@@ -3664,11 +3771,6 @@ static NTSTATUS find_dll_redirection(ACTIVATION_CONTEXT* actctx, const UNICODE_S
     return STATUS_SUCCESS;
 }
 
-static inline struct string_index *get_wndclass_first_index(ACTIVATION_CONTEXT *actctx)
-{
-    return (struct string_index*)((BYTE*)actctx->wndclass_section + actctx->wndclass_section->index_offset);
-}
-
 static inline struct wndclass_redirect_data *get_wndclass_data(ACTIVATION_CONTEXT *ctxt, struct string_index *index)
 {
     return (struct wndclass_redirect_data*)((BYTE*)ctxt->wndclass_section + index->data_offset);
@@ -3814,11 +3916,8 @@ static NTSTATUS build_wndclass_section(ACTIVATION_CONTEXT* actctx, struct strsec
 static NTSTATUS find_window_class(ACTIVATION_CONTEXT* actctx, const UNICODE_STRING *name,
                                   PACTCTX_SECTION_KEYED_DATA data)
 {
-    struct string_index *iter, *index = NULL;
+    struct string_index *index;
     struct wndclass_redirect_data *class;
-    UNICODE_STRING str;
-    ULONG hash;
-    int i;
 
     if (!(actctx->sections & WINDOWCLASS_SECTION)) return STATUS_SXS_KEY_NOT_FOUND;
 
@@ -3833,27 +3932,7 @@ static NTSTATUS find_window_class(ACTIVATION_CONTEXT* actctx, const UNICODE_STRI
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    hash = 0;
-    RtlHashUnicodeString(name, TRUE, HASH_STRING_ALGORITHM_X65599, &hash);
-    iter = get_wndclass_first_index(actctx);
-
-    for (i = 0; i < actctx->wndclass_section->count; i++)
-    {
-        if (iter->hash == hash)
-        {
-            str.Buffer = (WCHAR *)((BYTE *)actctx->wndclass_section + iter->name_offset);
-            str.Length = iter->name_len;
-            if (RtlEqualUnicodeString( &str, name, TRUE ))
-            {
-                index = iter;
-                break;
-            }
-            else
-                WARN("hash collision 0x%08lx, %s, %s\n", hash, debugstr_us(name), debugstr_us(&str));
-        }
-        iter++;
-    }
-
+    index = find_string_index(actctx->wndclass_section, &actctx->wndclass_lookup, name);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     if (data)
@@ -3877,11 +3956,6 @@ static NTSTATUS find_window_class(ACTIVATION_CONTEXT* actctx, const UNICODE_STRI
     return STATUS_SUCCESS;
 }
 
-static inline struct string_index *get_activatable_class_first_index(ACTIVATION_CONTEXT *actctx)
-{
-    return (struct string_index *)((BYTE *)actctx->activatable_class_section + actctx->activatable_class_section->index_offset);
-}
-
 static inline struct activatable_class_data *get_activatable_class_data(ACTIVATION_CONTEXT *ctxt, struct string_index *index)
 {
     return (struct activatable_class_data *)((BYTE *)ctxt->activatable_class_section + index->data_offset);
@@ -4014,11 +4088,8 @@ static NTSTATUS build_activatable_class_section(ACTIVATION_CONTEXT *actctx, stru
 static NTSTATUS find_activatable_class(ACTIVATION_CONTEXT* actctx, const UNICODE_STRING *name,
                                        PACTCTX_SECTION_KEYED_DATA data)
 {
-    struct string_index *iter, *index = NULL;
+    struct string_index *index;
     struct activatable_class_data *class;
-    UNICODE_STRING str;
-    ULONG hash;
-    int i;
 
     if (!(actctx->sections & ACTIVATABLE_CLASS_SECTION)) return STATUS_SXS_KEY_NOT_FOUND;
 
@@ -4033,27 +4104,7 @@ static NTSTATUS find_activatable_class(ACTIVATION_CONTEXT* actctx, const UNICODE
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    hash = 0;
-    RtlHashUnicodeString(name, TRUE, HASH_STRING_ALGORITHM_X65599, &hash);
-    iter = get_activatable_class_first_index(actctx);
-
-    for (i = 0; i < actctx->activatable_class_section->count; i++)
-    {
-        if (iter->hash == hash)
-        {
-            str.Buffer = (WCHAR *)((BYTE *)actctx->activatable_class_section + iter->name_offset);
-            str.Length = iter->name_len;
-            if (RtlEqualUnicodeString( &str, name, TRUE ))
-            {
-                index = iter;
-                break;
-            }
-            else
-                WARN("hash collision 0x%08lx, %s, %s\n", hash, debugstr_us(name), debugstr_us(&str));
-        }
-        iter++;
-    }
-
+    index = find_string_index(actctx->activatable_class_section, &actctx->activatable_class_lookup, name);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     if (data)
@@ -4224,7 +4275,7 @@ static NTSTATUS find_tlib_redirection(ACTIVATION_CONTEXT* actctx, const GUID *gu
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_guid_index(actctx->tlib_section, guid);
+    index = find_guid_index(actctx->tlib_section, &actctx->tlib_lookup, guid);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     tlib = get_tlib_data(actctx, index);
@@ -4557,7 +4608,7 @@ static NTSTATUS find_comserver_redirection(ACTIVATION_CONTEXT* actctx, const GUI
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_guid_index(actctx->comserver_section, guid);
+    index = find_guid_index(actctx->comserver_section, &actctx->comserver_lookup, guid);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     comclass = get_comclass_data(actctx, index);
@@ -4747,7 +4798,7 @@ static NTSTATUS find_cominterface_redirection(ACTIVATION_CONTEXT* actctx, const
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_guid_index(actctx->ifaceps_section, guid);
+    index = find_guid_index(actctx->ifaceps_section, &actctx->ifaceps_lookup, guid);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     iface = get_ifaceps_data(actctx, index);
@@ -4895,7 +4946,7 @@ static NTSTATUS find_clr_surrogate(ACTIVATION_CONTEXT* actctx, const GUID *guid,
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_guid_index(actctx->clrsurrogate_section, guid);
+    index = find_guid_index(actctx->clrsurrogate_section, &actctx->clrsurrogate_lookup, guid);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     surrogate = get_surrogate_data(actctx, index);
@@ -5006,7 +5057,7 @@ static void add_progid_record(ACTIVATION_CONTEXT* actctx, struct strsection_head
             RtlInitUnicodeString(&str, entity->u.comclass.clsid);
             RtlGUIDFromString(&str, &clsid);
 
-            guid_index = find_guid_index(actctx->comserver_section, &clsid);
+            guid_index = find_guid_index(actctx->comserver_section, &actctx->comserver_lookup, &clsid);
             comclass = get_comclass_data(actctx, guid_index);
 
             if (entity->u.comclass.progid)
@@ -5109,7 +5160,7 @@ static NTSTATUS find_progid_redirection(ACTIVATION_CONTEXT* actctx, const UNICOD
             RtlFreeHeap(GetProcessHeap(), 0, section);
     }
 
-    index = find_string_index(actctx->progid_section, name);
+    index = find_string_index(actctx->progid_section, &actctx->progid_lookup, name);
     if (!index) return STATUS_SXS_KEY_NOT_FOUND;
 
     if (data)
@@ -276,6 +276,16 @@ static inline struct group **bin_get_affinity_group( struct bin *bin, BYTE affin
     return bin->affinity_group_base + affinity * BLOCK_SIZE_BIN_COUNT;
 }
 
+/* per-affinity LFH counters, stored after the bins affinity group pointers */
+struct DECLSPEC_CACHEALIGN affinity_stats
+{
+    LONG64 lfh_alloc;
+};
+
+#define BINS_GROUPS_SIZE  ((sizeof(struct bin) + sizeof(struct group *) * ARRAY_SIZE(affinity_mapping)) * BLOCK_SIZE_BIN_COUNT)
+#define BINS_STATS_OFFSET ROUND_SIZE( BINS_GROUPS_SIZE, sizeof(struct affinity_stats) - 1 )
+#define BINS_TOTAL_SIZE   (BINS_STATS_OFFSET + sizeof(struct affinity_stats) * ARRAY_SIZE(affinity_mapping))
+
 struct heap
 {                                  /* win32/win64 */
     DWORD_PTR        unknown1[2];   /* 0000/0000 */
@@ -300,6 +310,8 @@ struct heap
     RTL_CRITICAL_SECTION cs;
     struct entry     free_lists[FREE_LIST_COUNT];
     struct bin      *bins;
+    SIZE_T           alloc_count;   /* backend allocations, protected by the heap lock */
+    SIZE_T           decommit_count; /* subheap decommits and releases, protected by the heap lock */
     SUBHEAP          subheap;
 };
 
@@ -310,6 +322,11 @@ C_ASSERT( offsetof(struct heap, subheap) <= REGION_ALIGN - 1 );
 
 #define HEAP_MAGIC       ((DWORD)('H' | ('E'<<8) | ('A'<<16) | ('P'<<24)))
 
+static inline struct affinity_stats *heap_get_affinity_stats( const struct heap *heap, BYTE affinity )
+{
+    return (struct affinity_stats *)((char *)heap->bins + BINS_STATS_OFFSET) + affinity;
+}
+
 #define HEAP_INITIAL_SIZE      0x10000
 #define HEAP_INITIAL_GROW_SIZE 0x100000
 #define HEAP_MAX_GROW_SIZE     0xfd0000
@@ -827,7 +844,7 @@ static inline BOOL subheap_commit( const struct heap *heap, SUBHEAP *subheap, co
     return TRUE;
 }
 
-static inline BOOL subheap_decommit( const struct heap *heap, SUBHEAP *subheap, const void *commit_end )
+static inline BOOL subheap_decommit( struct heap *heap, SUBHEAP *subheap, const void *commit_end )
 {
     char *base = subheap_base( subheap );
     SIZE_T size;
@@ -846,6 +863,7 @@ static inline BOOL subheap_decommit( const struct heap *heap, SUBHEAP *subheap,
         return FALSE;
     }
 
+    heap->decommit_count++;
     subheap->data_size = (char *)commit_end - (char *)(subheap + 1);
     return TRUE;
 }
@@ -940,6 +958,7 @@ static NTSTATUS heap_free_block( struct heap *heap, ULONG flags, struct block *b
 
         list_remove( &subheap->entry );
         NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+        heap->decommit_count++;
         return STATUS_SUCCESS;
     }
 
@@ -1019,6 +1038,7 @@ static NTSTATUS heap_allocate_large( struct heap *heap, ULONG flags, SIZE_T bloc
 
     heap_lock( heap, flags );
     list_add_tail( &heap->large_list, &arena->entry );
+    heap->alloc_count++;
     heap_unlock( heap, flags );
 
     valgrind_make_noaccess( (char *)block + sizeof(*block) + arena->data_size,
@@ -1585,7 +1605,7 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
 
     if (heap->flags & HEAP_GROWABLE)
     {
-        SIZE_T size = (sizeof(struct bin) + sizeof(struct group *) * ARRAY_SIZE(affinity_mapping)) * BLOCK_SIZE_BIN_COUNT;
+        SIZE_T size = BINS_TOTAL_SIZE;
         NtAllocateVirtualMemory( NtCurrentProcess(), (void *)&heap->bins,
                                  0, &size, MEM_COMMIT, PAGE_READWRITE );
 
@@ -1742,6 +1762,7 @@ static NTSTATUS heap_allocate_block( struct heap *heap, ULONG flags, SIZE_T bloc
     mark_block_tail( block, flags );
 
     if ((next = next_block( subheap, block ))) block_set_flags( next, BLOCK_FLAG_PREV_FREE, 0 );
+    heap->alloc_count++;
 
     *ret = block + 1;
     return STATUS_SUCCESS;
@@ -1764,6 +1785,9 @@ struct DECLSPEC_ALIGN(BLOCK_ALIGN) group
 #define GROUP_BLOCK_COUNT     (sizeof(((struct group *)0)->free_bits) * 8 - 1)
 #define GROUP_FLAG_FREE       (1u << GROUP_BLOCK_COUNT)
 
+/* amount of memory worth of fully freed groups each bin keeps for re-use */
+#define GROUP_CACHE_SIZE      0x40000
+
 static inline UINT block_get_group_index( const struct block *block )
 {
     return block->base_offset;
@@ -1886,6 +1910,13 @@ static struct group *heap_acquire_bin_group( struct heap *heap, ULONG flags, SIZ
     return group_allocate( heap, flags, block_size );
 }
 
+/* maximum number of fully freed groups kept in the bin shared list, larger for small block sizes */
+static inline ULONG bin_get_group_cache_limit( SIZE_T block_size )
+{
+    SIZE_T group_size = offsetof( struct group, first_block ) + GROUP_BLOCK_COUNT * block_size;
+    return max( ARRAY_SIZE(affinity_mapping), GROUP_CACHE_SIZE / group_size );
+}
+
 /* release a thread owned and fully freed group to the bin shared group, or free its memory */
 static NTSTATUS heap_release_bin_group( struct heap *heap, ULONG flags, struct bin *bin, struct group *group )
 {
@@ -1898,7 +1929,7 @@ static NTSTATUS heap_release_bin_group( struct heap *heap, ULONG flags, struct b
         return STATUS_SUCCESS;
 
     /* try re-using the block group instead of releasing it */
-    if (RtlQueryDepthSList( &bin->groups ) <= ARRAY_SIZE(affinity_mapping))
+    if (RtlQueryDepthSList( &bin->groups ) <= bin_get_group_cache_limit( block_get_size( &group->first_block ) ))
     {
         RtlInterlockedPushEntrySList( &bin->groups, &group->entry );
         return STATUS_SUCCESS;
@@ -1953,6 +1984,7 @@ static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T
         block->tail_size = block_size - sizeof(*block) - size;
         initialize_block( block, 0, size, flags );
         mark_block_tail( block, flags );
+        InterlockedIncrement64( &heap_get_affinity_stats( heap, heap_current_thread_affinity() )->lfh_alloc );
         *ret = block + 1;
     }
 
@@ -2566,6 +2598,85 @@ ULONG WINAPI RtlGetProcessHeaps( ULONG count, HANDLE *heaps )
     return total;
 }
 
+static void heap_stats_add_block( WINE_HEAP_STATISTICS *stats, const struct block *block )
+{
+    SIZE_T block_size = block_get_size( block );
+    WINE_HEAP_BIN_STATISTICS *bin;
+
+    if (block_get_flags( block ) & BLOCK_FLAG_FREE)
+    {
+        bin = stats->Bins + min( BLOCK_SIZE_BIN( block_size ), BLOCK_SIZE_BIN_COUNT - 1 );
+        bin->FreeSize += block_size;
+        stats->FreeSize += block_size;
+    }
+    else if (block_get_flags( block ) & BLOCK_FLAG_LFH)
+    {
+        /* the block holds a LFH group, free bits may be changed concurrently by other threads */
+        const struct group *group = (const struct group *)(block + 1);
+        ULONG free_bits = ReadNoFence( &group->free_bits ) & ~GROUP_FLAG_FREE;
+        SIZE_T group_block_size = block_get_size( &group->first_block );
+        ULONG free_count = 0;
+
+        for (; free_bits; free_bits &= free_bits - 1) free_count++;
+        bin = stats->Bins + BLOCK_SIZE_BIN( group_block_size );
+        bin->LfhGroupCount++;
+        bin->LfhFreeSize += free_count * group_block_size;
+        bin->LfhUsedSize += (GROUP_BLOCK_COUNT - free_count) * group_block_size;
+        stats->FreeSize += free_count * group_block_size;
+        stats->UsedSize += (GROUP_BLOCK_COUNT - free_count) * group_block_size;
+    }
+    else
+    {
+        bin = stats->Bins + min( BLOCK_SIZE_BIN( block_size ), BLOCK_SIZE_BIN_COUNT - 1 );
+        bin->UsedSize += block_size;
+        stats->UsedSize += block_size;
+    }
+}
+
+static NTSTATUS heap_get_statistics( struct heap *heap, ULONG flags, WINE_HEAP_STATISTICS *stats, SIZE_T size )
+{
+    const ARENA_LARGE *large;
+    const struct block *block;
+    const SUBHEAP *subheap;
+    ULONG i;
+
+    memset( stats, 0, size );
+    stats->BinCount = BLOCK_SIZE_BIN_COUNT;
+    for (i = 0; i < BLOCK_SIZE_BIN_COUNT; ++i)
+    {
+        stats->Bins[i].BlockSize = BLOCK_BIN_SIZE( i );
+        if (heap->bins) stats->Bins[i].LfhEnabled = ReadNoFence( &heap->bins[i].enabled );
+    }
+
+    for (i = 0; heap->bins && i < ARRAY_SIZE(affinity_mapping); ++i)
+        stats->LfhAllocCount += InterlockedCompareExchange64( &heap_get_affinity_stats( heap, i )->lfh_alloc, 0, 0 );
+
+    heap_lock( heap, flags );
+
+    stats->AllocCount = heap->alloc_count;
+    stats->DecommitCount = heap->decommit_count;
+
+    LIST_FOR_EACH_ENTRY( subheap, &heap->subheap_list, SUBHEAP, entry )
+    {
+        stats->SubheapCount++;
+        stats->CommittedSize += (char *)subheap_commit_end( subheap ) - (char *)subheap_base( subheap );
+        for (block = first_block( subheap ); block; block = next_block( subheap, block ))
+            heap_stats_add_block( stats, block );
+    }
+
+    LIST_FOR_EACH_ENTRY( large, &heap->large_list, ARENA_LARGE, entry )
+    {
+        stats->LargeBlockCount++;
+        stats->CommittedSize += (char *)&large->block + large->block_size - (char *)large;
+        if (block_get_flags( &large->block ) & BLOCK_FLAG_LFH) heap_stats_add_block( stats, &large->block );
+        else stats->UsedSize += large->data_size;
+    }
+
+    heap_unlock( heap, flags );
+
+    return STATUS_SUCCESS;
+}
+
 /***********************************************************************
  *           RtlQueryHeapInformation    (NTDLL.@)
  */
@@ -2577,6 +2688,16 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS i
 
     TRACE( "handle %p, info_class %u, info %p, size_in %Iu, size_out %p.\n", handle, info_class, info, size_in, size_out );
 
+    /* Wine extension, kept out of the switch as it isn't part of the enumeration */
+    if (info_class == HeapWineStatistics)
+    {
+        SIZE_T size = offsetof( WINE_HEAP_STATISTICS, Bins[BLOCK_SIZE_BIN_COUNT] );
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_ACCESS_VIOLATION;
+        if (size_out) *size_out = size;
+        if (size_in < size) return STATUS_BUFFER_TOO_SMALL;
+        return heap_get_statistics( heap, flags, info, size );
+    }
+
     switch (info_class)
     {
     case HeapCompatibilityInformation:
@@ -143,6 +143,8 @@ typedef struct _wine_modref
     struct file_id        id;
     ULONG                 CheckSum;
     BOOL                  system;
+    DWORD                *export_hash;       /* hash index of the export names, built on first use */
+    DWORD                 export_hash_mask;
 } WINE_MODREF;
 
 static UINT tls_module_count;      /* number of modules with TLS directory */
@@ -202,6 +204,7 @@ static struct rb_tree known_dlls;
 
 static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system );
 static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved );
+static void invalidate_missing_dirs(void);
 static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
                                     DWORD exp_size, DWORD ordinal, LPCWSTR load_path );
 static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
@@ -234,6 +237,109 @@ static BOOL get_env( const WCHAR *var, WCHAR *val, unsigned int len )
     return !RtlQueryEnvironmentVariable_U( NULL, &name, &value );
 }
 
+/* optional trace of the loader activity, in the Chrome trace event format */
+static HANDLE load_trace_file;
+static LARGE_INTEGER load_trace_freq;
+
+/***********************************************************************
+ *           init_load_trace
+ *
+ * Open the file named by WINELOADERTRACE (a unix path); the events of
+ * all the processes using it are appended to it.
+ */
+static void init_load_trace(void)
+{
+    UNICODE_STRING nameW;
+    OBJECT_ATTRIBUTES attr;
+    IO_STATUS_BLOCK io;
+    LARGE_INTEGER counter;
+    WCHAR value[MAX_PATH], *buffer;
+    char path[MAX_PATH * 3];
+    DWORD len;
+    ULONG size = 0;
+
+    if (!get_env( L"WINELOADERTRACE", value, sizeof(value) )) return;
+    if (RtlUnicodeToUTF8N( path, sizeof(path) - 1, &len, value, wcslen(value) * sizeof(WCHAR) )) return;
+    path[len] = 0;
+
+    if (wine_unix_to_nt_file_name( path, NULL, &size ) != STATUS_BUFFER_TOO_SMALL) return;
+    if (!(buffer = RtlAllocateHeap( GetProcessHeap(), 0, size * sizeof(WCHAR) ))) return;
+    if (!wine_unix_to_nt_file_name( path, buffer, &size ))
+    {
+        RtlInitUnicodeString( &nameW, buffer );
+        InitializeObjectAttributes( &attr, &nameW, OBJ_CASE_INSENSITIVE, 0, NULL );
+        if (!NtCreateFile( &load_trace_file, FILE_APPEND_DATA | SYNCHRONIZE, &attr, &io, NULL, 0,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_OPEN_IF,
+                           FILE_SYNCHRONOUS_IO_NONALERT | FILE_NON_DIRECTORY_FILE, NULL, 0 ))
+        {
+            NtQueryPerformanceCounter( &counter, &load_trace_freq );
+            /* the closing bracket is optional in that format */
+            if (io.Information == FILE_CREATED)
+                NtWriteFile( load_trace_file, 0, NULL, NULL, &io, (void *)"[\n", 2, NULL, NULL );
+        }
+    }
+    RtlFreeHeap( GetProcessHeap(), 0, buffer );
+}
+
+static ULONGLONG load_trace_time(void)
+{
+    LARGE_INTEGER counter;
+
+    if (!load_trace_file) return 0;
+    NtQueryPerformanceCounter( &counter, NULL );
+    return counter.QuadPart;
+}
+
+static ULONGLONG load_trace_usecs( ULONGLONG counter )
+{
+    ULONGLONG freq = load_trace_freq.QuadPart;
+    return counter / freq * 1000000 + counter % freq * 1000000 / freq;
+}
+
+static int WINAPIV load_trace_sprintf( char *buffer, size_t size, const char *format, ... )
+{
+    va_list args;
+    int len;
+
+    va_start( args, format );
+    len = _vsnprintf( buffer, size, format, args );
+    va_end( args );
+    return len;
+}
+
+/***********************************************************************
+ *           load_trace_event
+ *
+ * Record an event that started at the given load_trace_time().
+ */
+static void load_trace_event( const char *cat, const WCHAR *name, ULONGLONG start )
+{
+    IO_STATUS_BLOCK io;
+    ULONGLONG end;
+    char buffer[512], str[128];
+    const WCHAR *p;
+    unsigned int i;
+    int len;
+
+    if (!load_trace_file || !start) return;
+    end = load_trace_time();
+
+    /* keep module names as base names, the json string needs no escaping then */
+    if (name && (p = wcsrchr( name, '\\' ))) name = p + 1;
+    for (i = 0; name && name[i] && i < sizeof(str) - 1; i++)
+        str[i] = (name[i] >= 0x20 && name[i] < 0x7f && name[i] != '"' && name[i] != '\\') ? name[i] : '?';
+    str[i] = 0;
+
+    len = load_trace_sprintf( buffer, sizeof(buffer), "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                              "\"ts\":%I64u,\"dur\":%I64u,\"pid\":%lu,\"tid\":%lu},\n",
+                              str, cat, load_trace_usecs( start ), load_trace_usecs( end - start ),
+                              HandleToULong( NtCurrentTeb()->ClientId.UniqueProcess ),
+                              HandleToULong( NtCurrentTeb()->ClientId.UniqueThread ));
+    if (len <= 0) return;
+
+    NtWriteFile( load_trace_file, 0, NULL, NULL, &io, buffer, len, NULL, NULL );
+}
+
 #define RTL_UNLOAD_EVENT_TRACE_NUMBER 64
 
 typedef struct _RTL_UNLOAD_EVENT_TRACE
@@ -1082,6 +1188,70 @@ static int find_name_in_exports( HMODULE module, const IMAGE_EXPORT_DIRECTORY *e
 }
 
 
+#define EXPORT_HASH_MIN_NAMES 64  /* below that a binary search is just as fast */
+
+static DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 2166136261u;
+
+    while (*name) hash = (hash ^ (unsigned char)*name++) * 16777619u;
+    return hash;
+}
+
+/*************************************************************************
+ *		build_export_hash
+ *
+ * Build an open addressing hash index of the export names of a module.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL build_export_hash( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports )
+{
+    const DWORD *names = get_rva( wm->ldr.DllBase, exports->AddressOfNames );
+    DWORD i, pos, size = 1;
+
+    while (size < 2 * exports->NumberOfNames) size <<= 1;
+    if (!(wm->export_hash = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY, size * sizeof(DWORD) )))
+        return FALSE;
+    wm->export_hash_mask = size - 1;
+
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        pos = hash_export_name( get_rva( wm->ldr.DllBase, names[i] )) & wm->export_hash_mask;
+        while (wm->export_hash[pos]) pos = (pos + 1) & wm->export_hash_mask;
+        wm->export_hash[pos] = i + 1;
+    }
+    TRACE( "%s: %lu names in %lu buckets\n", debugstr_w(wm->ldr.BaseDllName.Buffer),
+           exports->NumberOfNames, size );
+    return TRUE;
+}
+
+/*************************************************************************
+ *		find_name_in_export_hash
+ *
+ * Helper for find_named_export, look up a name in the hash index of a module.
+ * Returns -2 if the module has no usable index.
+ */
+static int find_name_in_export_hash( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports, const char *name )
+{
+    const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    WINE_MODREF *wm;
+    DWORD pos, idx;
+
+    if (exports->NumberOfNames < EXPORT_HASH_MIN_NAMES) return -2;
+    if (!(wm = get_modref( module ))) return -2;
+    if (!wm->export_hash && !build_export_hash( wm, exports )) return -2;
+
+    pos = hash_export_name( name ) & wm->export_hash_mask;
+    while ((idx = wm->export_hash[pos]))
+    {
+        if (!strcmp( get_rva( module, names[idx - 1] ), name )) return ordinals[idx - 1];
+        pos = (pos + 1) & wm->export_hash_mask;
+    }
+    return -1;
+}
+
+
 /*************************************************************************
  *		find_named_export
  *
@@ -1103,8 +1273,10 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
             return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path );
     }
 
-    /* then do a binary search */
-    if ((ordinal = find_name_in_exports( module, exports, name )) == -1) return NULL;
+    /* then use the hash index, or do a binary search for small tables */
+    if ((ordinal = find_name_in_export_hash( module, exports, name )) == -2)
+        ordinal = find_name_in_exports( module, exports, name );
+    if (ordinal == -1) return NULL;
     return find_ordinal_export( module, exports, exp_size, ordinal, load_path );
 
 }
@@ -1682,22 +1854,29 @@ static NTSTATUS MODULE_InitDLL( WINE_MODREF *wm, UINT reason, LPVOID lpReserved
     NTSTATUS status = STATUS_SUCCESS;
     DLLENTRYPROC entry = wm->ldr.EntryPoint;
     void *module = wm->ldr.DllBase;
+    ULONGLONG start;
     BOOL retv = FALSE;
 
     /* Skip calls for modules loaded with special load flags */
 
     if (wm->ldr.Flags & LDR_DONT_RESOLVE_REFS) return STATUS_SUCCESS;
+    start = load_trace_time();
     if (wm->ldr.TlsIndex == -1) call_tls_callbacks( wm->ldr.DllBase, reason );
-    if (!entry) return STATUS_SUCCESS;
+    if (!entry)
+    {
+        load_trace_event( reason_names[reason], wm->ldr.BaseDllName.Buffer, start );
+        return STATUS_SUCCESS;
+    }
 
-    if (TRACE_ON(relay))
+    if (TRACE_ON(relay) || load_trace_file)
     {
         size_t len = min( wm->ldr.BaseDllName.Length, sizeof(mod_name)-sizeof(WCHAR) );
         memcpy( mod_name, wm->ldr.BaseDllName.Buffer, len );
         mod_name[len / sizeof(WCHAR)] = 0;
+    }
+    if (TRACE_ON(relay))
         TRACE_(relay)("\1Call PE DLL (proc=%p,module=%p %s,reason=%s,res=%p)\n",
                       entry, module, debugstr_w(mod_name), reason_names[reason], lpReserved );
-    }
     else TRACE("(%p %s,%s,%p) - CALL\n", module, debugstr_w(wm->ldr.BaseDllName.Buffer),
                reason_names[reason], lpReserved );
 
@@ -1724,6 +1903,8 @@ static NTSTATUS MODULE_InitDLL( WINE_MODREF *wm, UINT reason, LPVOID lpReserved
     else
         TRACE("(%p,%s,%p) - RETURN %d\n", module, reason_names[reason], lpReserved, retv );
 
+    load_trace_event( reason_names[reason], mod_name, start );
+
     return status;
 }
 
@@ -1778,6 +1959,9 @@ static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved )
 
     TRACE("(%s,%p) - START\n", debugstr_w(wm->ldr.BaseDllName.Buffer), lpReserved );
 
+    /* the entry point may create the directories we found missing */
+    invalidate_missing_dirs();
+
     /* Tag current MODREF to prevent recursive loop */
     wm->ldr.Flags |= LDR_LOAD_IN_PROGRESS;
     if (lpReserved) wm->ldr.LoadCount = -1;  /* pin it if imported by the main exe */
@@ -2335,10 +2519,13 @@ static NTSTATUS build_module( LPCWSTR load_path, const UNICODE_STRING *nt_name,
         ((nt->FileHeader.Characteristics & IMAGE_FILE_DLL) ||
          nt->OptionalHeader.Subsystem == IMAGE_SUBSYSTEM_NATIVE))
     {
+        ULONGLONG start = load_trace_time();
+
         if (wm->ldr.Flags & LDR_COR_ILONLY)
             status = fixup_imports_ilonly( wm, load_path, &wm->ldr.EntryPoint );
         else
             status = fixup_imports( wm, load_path );
+        load_trace_event( "imports", wm->ldr.BaseDllName.Buffer, start );
         if (status != STATUS_SUCCESS)
         {
             /* the module has only be inserted in the load & memory order lists */
@@ -2721,7 +2908,7 @@ static NTSTATUS get_dll_load_path_search_flags( LPCWSTR module, DWORD flags, WCH
  * Open a file for a new dll. Helper for find_dll_file.
  */
 static NTSTATUS open_dll_file( UNICODE_STRING *nt_name, WINE_MODREF **pwm, HANDLE *mapping,
-                               SECTION_IMAGE_INFORMATION *image_info, struct file_id *id )
+                               SECTION_IMAGE_INFORMATION *image_info, struct file_id *id, NTSTATUS *open_status )
 {
     FILE_BASIC_INFORMATION info;
     OBJECT_ATTRIBUTES attr;
@@ -2743,6 +2930,7 @@ static NTSTATUS open_dll_file( UNICODE_STRING *nt_name, WINE_MODREF **pwm, HANDL
                               FILE_SHARE_READ | FILE_SHARE_DELETE,
                               FILE_SYNCHRONOUS_IO_NONALERT | FILE_NON_DIRECTORY_FILE )))
     {
+        if (open_status) *open_status = status;
         if (status != STATUS_OBJECT_PATH_NOT_FOUND &&
             status != STATUS_OBJECT_NAME_NOT_FOUND &&
             !NtQueryAttributesFile( &attr, &info ))
@@ -2823,9 +3011,11 @@ static NTSTATUS load_native_dll( LPCWSTR load_path, const UNICODE_STRING *nt_nam
 {
     void *module = NULL;
     SIZE_T len = 0;
+    ULONGLONG start = load_trace_time();
     NTSTATUS status = NtMapViewOfSection( mapping, NtCurrentProcess(), &module, 0, 0, NULL, &len,
                                           ViewShare, 0, PAGE_EXECUTE_READ );
 
+    load_trace_event( "map", nt_name->Buffer, start );
     if (!NT_SUCCESS(status)) return status;
 
     if ((*pwm = find_existing_module( module )))  /* already loaded */
@@ -3194,7 +3384,7 @@ static NTSTATUS find_builtin_without_file( const WCHAR *name, UNICODE_STRING *ne
         RtlAppendUnicodeToString( new_name, pe_dir );
         RtlAppendUnicodeToString( new_name, L"\\" );
         RtlAppendUnicodeToString( new_name, name );
-        status = open_dll_file( new_name, pwm, mapping, image_info, id );
+        status = open_dll_file( new_name, pwm, mapping, image_info, id, NULL );
         if (status != STATUS_DLL_NOT_FOUND) goto done;
 
         new_name->Length = len;
@@ -3203,7 +3393,7 @@ static NTSTATUS find_builtin_without_file( const WCHAR *name, UNICODE_STRING *ne
         RtlAppendUnicodeToString( new_name, pe_dir );
         RtlAppendUnicodeToString( new_name, L"\\" );
         RtlAppendUnicodeToString( new_name, name );
-        status = open_dll_file( new_name, pwm, mapping, image_info, id );
+        status = open_dll_file( new_name, pwm, mapping, image_info, id, NULL );
         if (status != STATUS_DLL_NOT_FOUND) goto done;
         RtlFreeUnicodeString( new_name );
     }
@@ -3216,12 +3406,12 @@ static NTSTATUS find_builtin_without_file( const WCHAR *name, UNICODE_STRING *ne
         RtlAppendUnicodeToString( new_name, pe_dir );
         RtlAppendUnicodeToString( new_name, L"\\" );
         RtlAppendUnicodeToString( new_name, name );
-        status = open_dll_file( new_name, pwm, mapping, image_info, id );
+        status = open_dll_file( new_name, pwm, mapping, image_info, id, NULL );
         if (status != STATUS_DLL_NOT_FOUND) goto done;
         new_name->Length = len;
         RtlAppendUnicodeToString( new_name, L"\\" );
         RtlAppendUnicodeToString( new_name, name );
-        status = open_dll_file( new_name, pwm, mapping, image_info, id );
+        status = open_dll_file( new_name, pwm, mapping, image_info, id, NULL );
         if (status == STATUS_NOT_SUPPORTED) found_image = TRUE;
         else if (status != STATUS_DLL_NOT_FOUND) goto done;
         RtlFreeUnicodeString( new_name );
@@ -3242,6 +3432,51 @@ done:
 }
 
 
+/* Load path directories found missing while resolving imports. Every dependency that isn't
+ * already loaded is searched through the whole load path, so a long PATH with stale entries
+ * costs a failed open per entry and per dll. The list is dropped whenever application code
+ * may have run, or the dll directories changed, see invalidate_missing_dirs(). */
+#define MAX_MISSING_DIRS 32
+static WCHAR *missing_dirs[MAX_MISSING_DIRS];
+static unsigned int missing_dir_count;
+static LONG missing_dirs_generation, missing_dirs_valid_generation;
+
+static void invalidate_missing_dirs(void)
+{
+    InterlockedIncrement( &missing_dirs_generation );
+}
+
+/* the loader_section must be locked while calling this function */
+static BOOL is_missing_dir( const WCHAR *dir, ULONG len )
+{
+    unsigned int i;
+
+    if (missing_dirs_valid_generation != missing_dirs_generation)
+    {
+        for (i = 0; i < missing_dir_count; i++) RtlFreeHeap( GetProcessHeap(), 0, missing_dirs[i] );
+        missing_dir_count = 0;
+        missing_dirs_valid_generation = missing_dirs_generation;
+        return FALSE;
+    }
+
+    for (i = 0; i < missing_dir_count; i++)
+        if (!wcsnicmp( missing_dirs[i], dir, len ) && !missing_dirs[i][len]) return TRUE;
+    return FALSE;
+}
+
+static void add_missing_dir( const WCHAR *dir, ULONG len )
+{
+    WCHAR *copy;
+
+    if (!len || missing_dir_count == MAX_MISSING_DIRS) return;
+    if (!(copy = RtlAllocateHeap( GetProcessHeap(), 0, (len + 1) * sizeof(WCHAR) ))) return;
+    memcpy( copy, dir, len * sizeof(WCHAR) );
+    copy[len] = 0;
+    missing_dirs[missing_dir_count++] = copy;
+    TRACE( "skipping %s for the rest of this load\n", debugstr_w(copy) );
+}
+
+
 /***********************************************************************
  *	search_dll_file
  *
@@ -3253,8 +3488,8 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
 {
     WCHAR *name;
     BOOL found_image = FALSE;
-    NTSTATUS status = STATUS_DLL_NOT_FOUND;
-    ULONG len;
+    NTSTATUS status = STATUS_DLL_NOT_FOUND, open_status;
+    ULONG len, dir_len;
 
     if (!paths) paths = default_load_path;
     len = wcslen( paths );
@@ -3270,8 +3505,14 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
         LPCWSTR ptr = paths;
 
         while (*ptr && *ptr != ';') ptr++;
-        len = ptr - paths;
+        len = dir_len = ptr - paths;
         if (*ptr == ';') ptr++;
+        if (is_missing_dir( paths, dir_len ))
+        {
+            status = STATUS_DLL_NOT_FOUND;
+            paths = ptr;
+            continue;
+        }
         memcpy( name, paths, len * sizeof(WCHAR) );
         if (len && name[len - 1] != '\\') name[len++] = '\\';
         wcscpy( name + len, search );
@@ -3279,9 +3520,11 @@ static NTSTATUS search_dll_file( LPCWSTR paths, LPCWSTR search, UNICODE_STRING *
         nt_name->Buffer = NULL;
         if ((status = RtlDosPathNameToNtPathName_U_WithStatus( name, nt_name, NULL, NULL ))) goto done;
 
-        status = open_dll_file( nt_name, pwm, mapping, image_info, id );
+        open_status = STATUS_SUCCESS;
+        status = open_dll_file( nt_name, pwm, mapping, image_info, id, &open_status );
         if (status == STATUS_NOT_SUPPORTED) found_image = TRUE;
         else if (status != STATUS_DLL_NOT_FOUND) goto done;
+        else if (open_status == STATUS_OBJECT_PATH_NOT_FOUND) add_missing_dir( paths, dir_len );
         RtlFreeUnicodeString( nt_name );
         paths = ptr;
     }
@@ -3364,7 +3607,7 @@ static NTSTATUS find_dll_file( const WCHAR *load_path, const WCHAR *libname, UNI
     }
     else if (!(status = RtlDosPathNameToNtPathName_U_WithStatus( libname, nt_name, NULL, NULL )))
     {
-        status = open_dll_file( nt_name, pwm, mapping, image_info, id );
+        status = open_dll_file( nt_name, pwm, mapping, image_info, id, NULL );
         if (status == STATUS_DLL_NOT_FOUND && known_dll_name)
             status = find_builtin_without_file( known_dll_name, nt_name, pwm, mapping, image_info, id );
     }
@@ -3426,6 +3669,7 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
     HANDLE mapping = 0;
     SECTION_IMAGE_INFORMATION image_info;
     NTSTATUS nts = STATUS_DLL_NOT_FOUND;
+    ULONGLONG start = load_trace_time();
     ULONG64 prev;
 
     TRACE( "looking for %s in %s\n", debugstr_w(libname), debugstr_w(load_path) );
@@ -3440,6 +3684,7 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
         nts = find_dll_file( load_path, libname, &nt_name, pwm, &mapping, &image_info, &id );
         system = FALSE;
     }
+    load_trace_event( "find", libname, start );
 
     if (*pwm)  /* found already loaded module */
     {
@@ -3564,9 +3809,13 @@ NTSTATUS WINAPI DECLSPEC_HOTPATCH LdrLoadDll(LPCWSTR path_name, DWORD flags,
     WINE_MODREF *wm;
     NTSTATUS nts;
     WCHAR *dllname = append_dll_ext( libname->Buffer );
+    ULONGLONG start = load_trace_time();
 
     RtlEnterCriticalSection( &loader_section );
 
+    load_trace_event( "lock wait", libname->Buffer, start );
+    start = load_trace_time();
+    invalidate_missing_dirs();
     nts = load_dll( path_name, dllname ? dllname : libname->Buffer, flags, &wm, FALSE );
 
     if (nts == STATUS_SUCCESS && !(wm->ldr.Flags & LDR_DONT_RESOLVE_REFS))
@@ -3580,6 +3829,7 @@ NTSTATUS WINAPI DECLSPEC_HOTPATCH LdrLoadDll(LPCWSTR path_name, DWORD flags,
     }
     *hModule = (wm) ? wm->ldr.DllBase : NULL;
 
+    load_trace_event( "LdrLoadDll", libname->Buffer, start );
     RtlLeaveCriticalSection( &loader_section );
     RtlFreeHeap( GetProcessHeap(), 0, dllname );
     return nts;
@@ -4021,6 +4271,7 @@ void WINAPI LdrShutdownProcess(void)
         RtlProcessFlsData( NtCurrentTeb()->FlsSlots, 1 );
 
     process_detach();
+    dump_lock_stats();
 }
 
 
@@ -4139,6 +4390,7 @@ static void free_modref( WINE_MODREF *wm )
     RtlReleaseActivationContext( wm->ldr.ActivationContext );
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.DllBase );
     if (cached_modref == wm) cached_modref = NULL;
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_hash );
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
@@ -4579,6 +4831,7 @@ void loader_init( CONTEXT *context, void **entry )
         actctx_init();
         locale_init();
         get_env_var( L"WINESYSTEMDLLPATH", 0, &system_dll_path );
+        init_load_trace();
         if (wm->ldr.Flags & LDR_COR_ILONLY)
             status = fixup_imports_ilonly( wm, NULL, entry );
         else
@@ -4606,6 +4859,8 @@ void loader_init( CONTEXT *context, void **entry )
 
     if (!attach_done)  /* first time around */
     {
+        ULONGLONG start = load_trace_time();
+
         attach_done = 1;
         if ((status = alloc_thread_tls()) != STATUS_SUCCESS)
         {
@@ -4634,6 +4889,7 @@ void loader_init( CONTEXT *context, void **entry )
                  debugstr_w(NtCurrentTeb()->Peb->ProcessParameters->ImagePathName.Buffer), status );
             NtTerminateProcess( GetCurrentProcess(), status );
         }
+        load_trace_event( "process init", wm->ldr.BaseDllName.Buffer, start );
         release_address_space();
         if (wm->ldr.TlsIndex == -1) call_tls_callbacks( wm->ldr.DllBase, DLL_PROCESS_ATTACH );
         if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
@@ -4795,6 +5051,7 @@ NTSTATUS WINAPI LdrSetDllDirectory( const UNICODE_STRING *dir )
     RtlFreeUnicodeString( &dll_directory );
     dll_directory = new;
     RtlLeaveCriticalSection( &dlldir_section );
+    invalidate_missing_dirs();
     return status;
 }
 
@@ -4837,6 +5094,7 @@ NTSTATUS WINAPI LdrAddDllDirectory( const UNICODE_STRING *dir, void **cookie )
         RtlEnterCriticalSection( &dlldir_section );
         list_add_head( &dll_dir_list, &ptr->entry );
         RtlLeaveCriticalSection( &dlldir_section );
+        invalidate_missing_dirs();
         *cookie = ptr;
     }
     else RtlFreeHeap( GetProcessHeap(), 0, ptr );
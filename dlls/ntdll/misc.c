@@ -339,8 +339,10 @@ ULONG WINAPI EtwEventSetInformation( REGHANDLE handle, EVENT_INFO_CLASS class, v
  */
 ULONG WINAPI EtwEventWriteString( REGHANDLE handle, UCHAR level, ULONGLONG keyword, PCWSTR string )
 {
-    FIXME("%s, %u, %s, %s: stub\n", wine_dbgstr_longlong(handle), level,
-          wine_dbgstr_longlong(keyword), debugstr_w(string));
+    static int once;
+
+    if (!once++) FIXME("%s, %u, %s, %s: stub\n", wine_dbgstr_longlong(handle), level,
+                       wine_dbgstr_longlong(keyword), debugstr_w(string));
     return ERROR_SUCCESS;
 }
 
@@ -350,8 +352,10 @@ ULONG WINAPI EtwEventWriteString( REGHANDLE handle, UCHAR level, ULONGLONG keywo
 ULONG WINAPI EtwEventWriteTransfer( REGHANDLE handle, PCEVENT_DESCRIPTOR descriptor, LPCGUID activity,
                                     LPCGUID related, ULONG count, PEVENT_DATA_DESCRIPTOR data )
 {
-    FIXME("%s, %p, %s, %s, %lu, %p: stub\n", wine_dbgstr_longlong(handle), descriptor,
-          debugstr_guid(activity), debugstr_guid(related), count, data);
+    static int once;
+
+    if (!once++) FIXME("%s, %p, %s, %s, %lu, %p: stub\n", wine_dbgstr_longlong(handle), descriptor,
+                       debugstr_guid(activity), debugstr_guid(related), count, data);
     return ERROR_SUCCESS;
 }
 
@@ -438,7 +442,9 @@ BOOLEAN WINAPI EtwEventEnabled( REGHANDLE handle, const EVENT_DESCRIPTOR *descri
 ULONG WINAPI EtwEventWrite( REGHANDLE handle, const EVENT_DESCRIPTOR *descriptor, ULONG count,
     EVENT_DATA_DESCRIPTOR *data )
 {
-    FIXME("(%s, %p, %lu, %p): stub\n", wine_dbgstr_longlong(handle), descriptor, count, data);
+    static int once;
+
+    if (!once++) FIXME("(%s, %p, %lu, %p): stub\n", wine_dbgstr_longlong(handle), descriptor, count, data);
     return ERROR_SUCCESS;
 }
 
@@ -447,7 +453,9 @@ ULONG WINAPI EtwEventWrite( REGHANDLE handle, const EVENT_DESCRIPTOR *descriptor
  */
 ULONG WINAPI EtwGetTraceEnableFlags( TRACEHANDLE handle )
 {
-    FIXME("(%s) stub\n", wine_dbgstr_longlong(handle));
+    static int once;
+
+    if (!once++) FIXME("(%s) stub\n", wine_dbgstr_longlong(handle));
     return 0;
 }
 
@@ -456,7 +464,9 @@ ULONG WINAPI EtwGetTraceEnableFlags( TRACEHANDLE handle )
  */
 UCHAR WINAPI EtwGetTraceEnableLevel( TRACEHANDLE handle )
 {
-    FIXME("(%s) stub\n", wine_dbgstr_longlong(handle));
+    static int once;
+
+    if (!once++) FIXME("(%s) stub\n", wine_dbgstr_longlong(handle));
     return TRACE_LEVEL_VERBOSE;
 }
 
@@ -465,7 +475,9 @@ UCHAR WINAPI EtwGetTraceEnableLevel( TRACEHANDLE handle )
  */
 TRACEHANDLE WINAPI EtwGetTraceLoggerHandle( PVOID buf )
 {
-    FIXME("(%p) stub\n", buf);
+    static int once;
+
+    if (!once++) FIXME("(%p) stub\n", buf);
     return INVALID_PROCESSTRACE_HANDLE;
 }
 
@@ -474,7 +486,9 @@ TRACEHANDLE WINAPI EtwGetTraceLoggerHandle( PVOID buf )
  */
 ULONG WINAPI EtwLogTraceEvent( TRACEHANDLE SessionHandle, PEVENT_TRACE_HEADER EventTrace )
 {
-    FIXME("%s %p\n", wine_dbgstr_longlong(SessionHandle), EventTrace);
+    static int once;
+
+    if (!once++) FIXME("%s %p\n", wine_dbgstr_longlong(SessionHandle), EventTrace);
     return ERROR_CALL_NOT_IMPLEMENTED;
 }
 
@@ -484,7 +498,9 @@ ULONG WINAPI EtwLogTraceEvent( TRACEHANDLE SessionHandle, PEVENT_TRACE_HEADER Ev
 ULONG WINAPI EtwTraceMessageVa( TRACEHANDLE handle, ULONG flags, LPGUID guid, USHORT number,
                                 va_list args )
 {
-    FIXME("(%s %lx %s %d) : stub\n", wine_dbgstr_longlong(handle), flags, debugstr_guid(guid), number);
+    static int once;
+
+    if (!once++) FIXME("(%s %lx %s %d) : stub\n", wine_dbgstr_longlong(handle), flags, debugstr_guid(guid), number);
     return ERROR_SUCCESS;
 }
 
@@ -38,6 +38,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(sync);
 WINE_DECLARE_DEBUG_CHANNEL(relay);
+WINE_DECLARE_DEBUG_CHANNEL(lockstats);
 
 static const char *debugstr_timeout( const LARGE_INTEGER *timeout )
 {
@@ -142,6 +143,121 @@ DWORD WINAPI RtlRunOnceComplete( RTL_RUN_ONCE *once, ULONG flags, void *context
 }
 
 
+/***********************************************************************
+ * Lock contention statistics
+ *
+ * Enabled with WINEDEBUG=+lockstats. Critical sections and SRW locks get
+ * an entry in a fixed-size table the first time they are acquired, and the
+ * entries are dumped at process exit sorted by total wait time. Only the
+ * contended path queries the time; when disabled, the cost is a test of a
+ * cached flag.
+ ***********************************************************************/
+
+struct lock_stats
+{
+    const void *lock;
+    const char *name;
+    LONG        acquires;   /* number of acquires */
+    LONG        contended;  /* number of acquires that had to wait */
+    LONGLONG    wait_time;  /* total time spent waiting, in performance counter ticks */
+    void       *owner;      /* return address of the last acquirer */
+    void       *blocker;    /* owner seen by the last contended acquire */
+};
+
+static struct lock_stats lock_stats[1024];
+
+static inline BOOL lock_stats_enabled(void)
+{
+    static int enabled = -1;
+
+    if (enabled == -1) enabled = TRACE_ON(lockstats);
+    return enabled;
+}
+
+static struct lock_stats *get_lock_stats( const void *lock, const char *name )
+{
+    unsigned int i, hash = ((ULONG_PTR)lock >> 3) % ARRAY_SIZE(lock_stats);
+
+    for (i = 0; i < 16; i++)
+    {
+        struct lock_stats *stats = &lock_stats[(hash + i) % ARRAY_SIZE(lock_stats)];
+        const void *prev = stats->lock;
+
+        if (!prev && !(prev = InterlockedCompareExchangePointer( (void **)&stats->lock, (void *)lock, NULL )))
+        {
+            stats->name = name;
+            return stats;
+        }
+        if (prev == lock) return stats;
+    }
+    return NULL;  /* table is full around this slot, don't track the lock */
+}
+
+static inline void lock_stats_acquired( struct lock_stats *stats, void *caller )
+{
+    InterlockedIncrement( &stats->acquires );
+    stats->owner = caller;
+}
+
+static LONGLONG lock_stats_begin_wait( struct lock_stats *stats )
+{
+    LARGE_INTEGER counter;
+
+    InterlockedIncrement( &stats->contended );
+    stats->blocker = stats->owner;
+    NtQueryPerformanceCounter( &counter, NULL );
+    return counter.QuadPart;
+}
+
+static void lock_stats_end_wait( struct lock_stats *stats, LONGLONG start )
+{
+    LARGE_INTEGER counter;
+
+    NtQueryPerformanceCounter( &counter, NULL );
+    InterlockedExchangeAdd64( &stats->wait_time, counter.QuadPart - start );
+}
+
+static int __cdecl compare_lock_stats( const void *a, const void *b )
+{
+    const struct lock_stats *stats1 = *(const struct lock_stats **)a, *stats2 = *(const struct lock_stats **)b;
+
+    if (stats1->wait_time != stats2->wait_time) return stats1->wait_time < stats2->wait_time ? 1 : -1;
+    return stats2->contended - stats1->contended;
+}
+
+/***********************************************************************
+ *           dump_lock_stats
+ *
+ * Print the lock statistics collected so far, most contended first.
+ */
+void dump_lock_stats(void)
+{
+    static struct lock_stats *sorted[ARRAY_SIZE(lock_stats)];
+    LARGE_INTEGER frequency;
+    unsigned int i, count = 0;
+
+    if (!lock_stats_enabled()) return;
+
+    for (i = 0; i < ARRAY_SIZE(lock_stats); i++)
+        if (lock_stats[i].lock) sorted[count++] = &lock_stats[i];
+    qsort( sorted, count, sizeof(*sorted), compare_lock_stats );
+
+    NtQueryPerformanceCounter( NULL, &frequency );
+    TRACE_(lockstats)( "%u locks tracked\n", count );
+    for (i = 0; i < count && i < 64; i++)
+    {
+        struct lock_stats *stats = sorted[i];
+
+        if (!stats->contended) break;
+        TRACE_(lockstats)( "%p %s: %ld acquires, %ld contended, %s us waited, last owner %p, last blocker %p\n",
+                           stats->lock, stats->name ? debugstr_a(stats->name) : "(srw)",
+                           stats->acquires, stats->contended,
+                           wine_dbgstr_longlong( stats->wait_time * 1000000 / frequency.QuadPart ),
+                           stats->owner, stats->blocker );
+    }
+}
+
+
 /***********************************************************************
  * Critical sections
  ***********************************************************************/
@@ -359,11 +475,19 @@ NTSTATUS WINAPI RtlpUnWaitCriticalSection( RTL_CRITICAL_SECTION *crit )
  */
 NTSTATUS WINAPI RtlEnterCriticalSection( RTL_CRITICAL_SECTION *crit )
 {
+    struct lock_stats *stats = NULL;
+
+    if (lock_stats_enabled()) stats = get_lock_stats( crit, crit_section_get_name( crit ));
+
     if (crit->SpinCount)
     {
         ULONG count;
 
-        if (RtlTryEnterCriticalSection( crit )) return STATUS_SUCCESS;
+        if (RtlTryEnterCriticalSection( crit ))
+        {
+            if (stats) lock_stats_acquired( stats, __builtin_return_address(0) );
+            return STATUS_SUCCESS;
+        }
         for (count = crit->SpinCount; count > 0; count--)
         {
             if (crit->LockCount > 0) break;  /* more than one waiter, don't bother spinning */
@@ -380,15 +504,23 @@ NTSTATUS WINAPI RtlEnterCriticalSection( RTL_CRITICAL_SECTION *crit )
         if (crit->OwningThread == ULongToHandle(GetCurrentThreadId()))
         {
             crit->RecursionCount++;
+            if (stats) lock_stats_acquired( stats, __builtin_return_address(0) );
             return STATUS_SUCCESS;
         }
 
         /* Now wait for it */
-        RtlpWaitForCriticalSection( crit );
+        if (stats)
+        {
+            LONGLONG start = lock_stats_begin_wait( stats );
+            RtlpWaitForCriticalSection( crit );
+            lock_stats_end_wait( stats, start );
+        }
+        else RtlpWaitForCriticalSection( crit );
     }
 done:
     crit->OwningThread   = ULongToHandle(GetCurrentThreadId());
     crit->RecursionCount = 1;
+    if (stats) lock_stats_acquired( stats, __builtin_return_address(0) );
     return STATUS_SUCCESS;
 }
 
@@ -521,6 +653,10 @@ void WINAPI RtlInitializeSRWLock( RTL_SRWLOCK *lock )
 void WINAPI RtlAcquireSRWLockExclusive( RTL_SRWLOCK *lock )
 {
     union { RTL_SRWLOCK *rtl; struct srw_lock *s; LONG *l; } u = { lock };
+    struct lock_stats *stats = NULL;
+    LONGLONG start = 0;
+
+    if (lock_stats_enabled()) stats = get_lock_stats( lock, NULL );
 
     InterlockedExchangeAdd16( &u.s->exclusive_waiters, 2 );
 
@@ -548,9 +684,16 @@ void WINAPI RtlAcquireSRWLockExclusive( RTL_SRWLOCK *lock )
             }
         } while (InterlockedCompareExchange( u.l, new.l, old.l ) != old.l);
 
-        if (!wait) return;
+        if (!wait) break;
+        if (stats && !start) start = lock_stats_begin_wait( stats );
         RtlWaitOnAddress( &u.s->owners, &new.s.owners, sizeof(short), NULL );
     }
+
+    if (stats)
+    {
+        if (start) lock_stats_end_wait( stats, start );
+        lock_stats_acquired( stats, __builtin_return_address(0) );
+    }
 }
 
 /***********************************************************************
@@ -563,6 +706,10 @@ void WINAPI RtlAcquireSRWLockExclusive( RTL_SRWLOCK *lock )
 void WINAPI RtlAcquireSRWLockShared( RTL_SRWLOCK *lock )
 {
     union { RTL_SRWLOCK *rtl; struct srw_lock *s; LONG *l; } u = { lock };
+    struct lock_stats *stats = NULL;
+    LONGLONG start = 0;
+
+    if (lock_stats_enabled()) stats = get_lock_stats( lock, NULL );
 
     for (;;)
     {
@@ -587,9 +734,16 @@ void WINAPI RtlAcquireSRWLockShared( RTL_SRWLOCK *lock )
             }
         } while (InterlockedCompareExchange( u.l, new.l, old.l ) != old.l);
 
-        if (!wait) return;
+        if (!wait) break;
+        if (stats && !start) start = lock_stats_begin_wait( stats );
         RtlWaitOnAddress( u.s, &new.s, sizeof(struct srw_lock), NULL );
     }
+
+    if (stats)
+    {
+        if (start) lock_stats_end_wait( stats, start );
+        lock_stats_acquired( stats, __builtin_return_address(0) );
+    }
 }
 
 /***********************************************************************
@@ -836,25 +990,38 @@ struct futex_entry
     DWORD tid;
 };
 
-struct futex_queue
+/* each queue gets its own cache line, so that threads hammering different
+ * queues don't bounce the same line between CPUs */
+struct DECLSPEC_CACHEALIGN futex_queue
 {
     struct list queue;
     LONG lock;
 };
 
-static struct futex_queue futex_queues[256];
+#define FUTEX_QUEUE_BITS 9
+
+static struct futex_queue futex_queues[1 << FUTEX_QUEUE_BITS];
 
 static struct futex_queue *get_futex_queue( const void *addr )
 {
     ULONG_PTR val = (ULONG_PTR)addr;
 
-    return &futex_queues[(val >> 4) % ARRAY_SIZE(futex_queues)];
+    /* Fibonacci hashing; a plain modulo maps every page-aligned address
+     * (and thus most heap-allocated locks of a given size) to one queue */
+#ifdef _WIN64
+    return &futex_queues[(val * 0x9e3779b97f4a7c15ull) >> (64 - FUTEX_QUEUE_BITS)];
+#else
+    return &futex_queues[(val * 0x9e3779b9u) >> (32 - FUTEX_QUEUE_BITS)];
+#endif
 }
 
 static void spin_lock( LONG *lock )
 {
     while (InterlockedCompareExchange( lock, -1, 0 ))
-        YieldProcessor();
+    {
+        /* spin on a plain read so that waiters don't keep stealing the line */
+        while (ReadNoFence( lock )) YieldProcessor();
+    }
 }
 
 static void spin_unlock( LONG *lock )
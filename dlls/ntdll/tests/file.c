@@ -4345,7 +4345,8 @@ static void test_file_access_information(void)
     FILE_ACCESS_INFORMATION info;
     IO_STATUS_BLOCK io;
     NTSTATUS status;
-    HANDLE h;
+    HANDLE h, dup;
+    unsigned int i;
 
     if (!(h = create_temp_file(0))) return;
 
@@ -4360,6 +4361,19 @@ static void test_file_access_information(void)
     ok( status == STATUS_SUCCESS, "expected STATUS_SUCCESS, got %08lx\n", status );
     ok( info.AccessFlags == 0x13019f, "got %08lx\n", info.AccessFlags );
 
+    /* the second query is served from the cached handle information */
+    ok( DuplicateHandle( GetCurrentProcess(), h, GetCurrentProcess(), &dup,
+                         FILE_READ_DATA | SYNCHRONIZE, FALSE, 0 ), "DuplicateHandle failed %lu\n", GetLastError() );
+    for (i = 0; i < 2; i++)
+    {
+        memset(&info, 0x11, sizeof(info));
+        status = pNtQueryInformationFile( dup, &io, &info, sizeof(info), FileAccessInformation );
+        ok( status == STATUS_SUCCESS, "%u: expected STATUS_SUCCESS, got %08lx\n", i, status );
+        ok( info.AccessFlags == (FILE_READ_DATA | SYNCHRONIZE), "%u: got %08lx\n", i, info.AccessFlags );
+        ok( io.Information == sizeof(info), "%u: got %Iu\n", i, io.Information );
+    }
+    CloseHandle( dup );
+
     CloseHandle( h );
 }
 
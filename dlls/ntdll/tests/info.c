@@ -2019,10 +2019,79 @@ static void test_query_process_io(void)
 
     /* Check if we have some return values */
     if (winetest_debug > 1) trace("OtherOperationCount : 0x%s\n", wine_dbgstr_longlong(pii.OtherOperationCount));
-    todo_wine
+    ok( pii.OtherOperationCount > 0, "Expected an OtherOperationCount > 0\n");
+}
+
+static void test_query_process_io_statistics(void)
+{
+    char path[MAX_PATH], filename[MAX_PATH], buffer[100] = {0};
+    PROCESS_WINE_IO_STATISTICS *stats;
+    IO_COUNTERS before, after;
+    NTSTATUS status;
+    ULONG len, i;
+    HANDLE file;
+    DWORD size;
+    BOOL ret;
+
+    GetTempPathA( MAX_PATH, path );
+    GetTempFileNameA( path, "nio", 0, filename );
+    file = CreateFileA( filename, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                        FILE_FLAG_DELETE_ON_CLOSE, NULL );
+    ok( file != INVALID_HANDLE_VALUE, "CreateFile failed %lu\n", GetLastError() );
+
+    status = NtQueryInformationProcess( GetCurrentProcess(), ProcessIoCounters, &before, sizeof(before), NULL );
+    ok( !status, "got %08lx\n", status );
+    ret = WriteFile( file, buffer, sizeof(buffer), &size, NULL );
+    ok( ret, "WriteFile failed %lu\n", GetLastError() );
+    SetFilePointer( file, 0, NULL, FILE_BEGIN );
+    ret = ReadFile( file, buffer, sizeof(buffer), &size, NULL );
+    ok( ret, "ReadFile failed %lu\n", GetLastError() );
+    status = NtQueryInformationProcess( GetCurrentProcess(), ProcessIoCounters, &after, sizeof(after), NULL );
+    ok( !status, "got %08lx\n", status );
+
+    ok( after.ReadOperationCount > before.ReadOperationCount, "read operations not accounted for\n" );
+    ok( after.WriteOperationCount > before.WriteOperationCount, "write operations not accounted for\n" );
+    ok( after.ReadTransferCount >= before.ReadTransferCount + sizeof(buffer), "read bytes not accounted for\n" );
+    ok( after.WriteTransferCount >= before.WriteTransferCount + sizeof(buffer), "write bytes not accounted for\n" );
+
+    status = NtQueryInformationProcess( GetCurrentProcess(), ProcessWineIoStatistics, NULL, 0, &len );
+    if (status == STATUS_INVALID_INFO_CLASS)
+    {
+        win_skip( "ProcessWineIoStatistics is not supported\n" );
+        CloseHandle( file );
+        return;
+    }
+    ok( status == STATUS_INFO_LENGTH_MISMATCH, "got %08lx\n", status );
+
+    len = offsetof( PROCESS_WINE_IO_STATISTICS, Handles[256] );
+    stats = malloc( len );
+    status = NtQueryInformationProcess( GetCurrentProcess(), ProcessWineIoStatistics, stats, len, &len );
+    ok( !status, "got %08lx\n", status );
+    ok( len == offsetof( PROCESS_WINE_IO_STATISTICS, Handles[stats->Count] ), "got len %lu\n", len );
+    for (i = 0; i < stats->Count; i++) if (stats->Handles[i].Handle == (ULONG_PTR)file) break;
+    ok( i < stats->Count, "handle %p not found\n", file );
+    if (i < stats->Count)
+    {
+        ok( stats->Handles[i].ReadOperationCount == 1, "got %lu reads\n", stats->Handles[i].ReadOperationCount );
+        ok( stats->Handles[i].WriteOperationCount == 1, "got %lu writes\n", stats->Handles[i].WriteOperationCount );
+        ok( stats->Handles[i].ReadTransferCount == sizeof(buffer), "got %I64u bytes read\n",
+            stats->Handles[i].ReadTransferCount );
+        ok( stats->Handles[i].WriteTransferCount == sizeof(buffer), "got %I64u bytes written\n",
+            stats->Handles[i].WriteTransferCount );
+        ok( !stats->Handles[i].AsyncOperationCount, "got %lu async operations\n",
+            stats->Handles[i].AsyncOperationCount );
+    }
+
+    if (stats->Count)
     {
-        ok( pii.OtherOperationCount > 0, "Expected an OtherOperationCount > 0\n");
+        len = offsetof( PROCESS_WINE_IO_STATISTICS, Handles[0] );
+        status = NtQueryInformationProcess( GetCurrentProcess(), ProcessWineIoStatistics, stats, len, &len );
+        ok( status == STATUS_INFO_LENGTH_MISMATCH, "got %08lx\n", status );
+        ok( !stats->Count, "got count %lu\n", stats->Count );
+        ok( len >= offsetof( PROCESS_WINE_IO_STATISTICS, Handles[1] ), "got len %lu\n", len );
     }
+    free( stats );
+    CloseHandle( file );
 }
 
 static void test_query_process_times(void)
@@ -4006,6 +4075,7 @@ START_TEST(info)
     /* NtQueryInformationProcess */
     test_query_process_basic();
     test_query_process_io();
+    test_query_process_io_statistics();
     test_query_process_vm();
     test_query_process_times();
     test_query_process_debug_port(argc, argv);
@@ -367,12 +367,156 @@ static void test_ports_server( HANDLE PortHandle )
     HeapFree(GetProcessHeap(), 0, LpcMessage);
 }
 
+struct alpc_message
+{
+    PORT_MESSAGE header;
+    char         data[64];
+};
+
+static NTSTATUS (WINAPI *pNtAlpcAcceptConnectPort)(HANDLE*,HANDLE,ULONG,OBJECT_ATTRIBUTES*,ALPC_PORT_ATTRIBUTES*,
+                                                   void*,PORT_MESSAGE*,ALPC_MESSAGE_ATTRIBUTES*,BOOLEAN);
+static NTSTATUS (WINAPI *pNtAlpcConnectPort)(HANDLE*,UNICODE_STRING*,OBJECT_ATTRIBUTES*,ALPC_PORT_ATTRIBUTES*,
+                                             ULONG,PSID,PORT_MESSAGE*,SIZE_T*,ALPC_MESSAGE_ATTRIBUTES*,
+                                             ALPC_MESSAGE_ATTRIBUTES*,LARGE_INTEGER*);
+static NTSTATUS (WINAPI *pNtAlpcCreatePort)(HANDLE*,OBJECT_ATTRIBUTES*,ALPC_PORT_ATTRIBUTES*);
+static NTSTATUS (WINAPI *pNtAlpcSendWaitReceivePort)(HANDLE,ULONG,PORT_MESSAGE*,ALPC_MESSAGE_ATTRIBUTES*,
+                                                     PORT_MESSAGE*,SIZE_T*,ALPC_MESSAGE_ATTRIBUTES*,LARGE_INTEGER*);
+
+static const WCHAR alpc_port_name[] = L"\\RPC Control\\WineTestAlpcPort";
+
+static void set_alpc_message( struct alpc_message *msg, const char *data )
+{
+    memset( &msg->header, 0, sizeof(msg->header) );
+    strcpy( msg->data, data );
+    msg->header.DataSize = strlen( data ) + 1;
+    msg->header.MessageSize = sizeof(msg->header) + msg->header.DataSize;
+}
+
+static DWORD WINAPI alpc_client( void *arg )
+{
+    struct alpc_message msg, reply;
+    UNICODE_STRING name;
+    NTSTATUS status;
+    HANDLE port;
+    SIZE_T size;
+
+    RtlInitUnicodeString( &name, alpc_port_name );
+    set_alpc_message( &msg, "connect" );
+    size = sizeof(msg);
+    status = pNtAlpcConnectPort( &port, &name, NULL, NULL, 0, NULL, &msg.header, &size, NULL, NULL, NULL );
+    ok( !status, "NtAlpcConnectPort failed %#lx\n", status );
+    if (status) return 1;
+
+    set_alpc_message( &msg, "datagram" );
+    status = pNtAlpcSendWaitReceivePort( port, 0, &msg.header, NULL, NULL, NULL, NULL, NULL );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+
+    set_alpc_message( &msg, "request" );
+    memset( &reply, 0xcc, sizeof(reply) );
+    size = sizeof(reply);
+    status = pNtAlpcSendWaitReceivePort( port, ALPC_MSGFLG_SYNC_REQUEST, &msg.header, NULL,
+                                         &reply.header, &size, NULL, NULL );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+    ok( (reply.header.MessageType & 0xff) == LPC_REPLY, "got type %#x\n", reply.header.MessageType );
+    ok( reply.header.DataSize == sizeof("reply"), "got size %u\n", reply.header.DataSize );
+    ok( reply.header.MessageId == msg.header.MessageId, "got id %lu, expected %lu\n",
+        reply.header.MessageId, msg.header.MessageId );
+    ok( !strcmp( reply.data, "reply" ), "got %s\n", debugstr_a(reply.data) );
+
+    NtClose( port );
+    return 0;
+}
+
+static void test_alpc(void)
+{
+    ALPC_PORT_ATTRIBUTES attr = { 0 };
+    struct alpc_message msg;
+    UNICODE_STRING name;
+    OBJECT_ATTRIBUTES obj;
+    LARGE_INTEGER timeout;
+    HANDLE server, port, client, thread;
+    NTSTATUS status;
+    SIZE_T size;
+    DWORD tid;
+
+    pNtAlpcAcceptConnectPort = (void *)GetProcAddress( GetModuleHandleA("ntdll.dll"), "NtAlpcAcceptConnectPort" );
+    pNtAlpcConnectPort = (void *)GetProcAddress( GetModuleHandleA("ntdll.dll"), "NtAlpcConnectPort" );
+    pNtAlpcCreatePort = (void *)GetProcAddress( GetModuleHandleA("ntdll.dll"), "NtAlpcCreatePort" );
+    pNtAlpcSendWaitReceivePort = (void *)GetProcAddress( GetModuleHandleA("ntdll.dll"), "NtAlpcSendWaitReceivePort" );
+    if (!pNtAlpcCreatePort)
+    {
+        win_skip( "ALPC ports are not supported\n" );
+        return;
+    }
+
+    RtlInitUnicodeString( &name, alpc_port_name );
+    InitializeObjectAttributes( &obj, &name, 0, NULL, NULL );
+    attr.MaxMessageLength = sizeof(msg);
+    status = pNtAlpcCreatePort( &server, &obj, &attr );
+    ok( !status, "NtAlpcCreatePort failed %#lx\n", status );
+    if (status) return;
+
+    status = pNtAlpcCreatePort( &port, &obj, &attr );
+    ok( status == STATUS_OBJECT_NAME_COLLISION, "NtAlpcCreatePort returned %#lx\n", status );
+
+    thread = CreateThread( NULL, 0, alpc_client, NULL, 0, &tid );
+    timeout.QuadPart = -50000000;
+
+    size = sizeof(msg);
+    status = pNtAlpcSendWaitReceivePort( server, 0, NULL, NULL, &msg.header, &size, NULL, &timeout );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+    ok( (msg.header.MessageType & 0xff) == LPC_CONNECTION_REQUEST, "got type %#x\n", msg.header.MessageType );
+    ok( msg.header.ClientId.UniqueThread == ULongToHandle( tid ), "got thread %p\n", msg.header.ClientId.UniqueThread );
+    ok( !strcmp( msg.data, "connect" ), "got %s\n", debugstr_a(msg.data) );
+    ok( size == sizeof(msg.header) + sizeof("connect"), "got size %Iu\n", size );
+
+    status = pNtAlpcAcceptConnectPort( &client, server, 0, NULL, NULL, NULL, &msg.header, NULL, TRUE );
+    ok( !status, "NtAlpcAcceptConnectPort failed %#lx\n", status );
+
+    size = sizeof(msg);
+    status = pNtAlpcSendWaitReceivePort( server, 0, NULL, NULL, &msg.header, &size, NULL, &timeout );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+    ok( (msg.header.MessageType & 0xff) == LPC_DATAGRAM, "got type %#x\n", msg.header.MessageType );
+    ok( !strcmp( msg.data, "datagram" ), "got %s\n", debugstr_a(msg.data) );
+
+    size = sizeof(msg);
+    status = pNtAlpcSendWaitReceivePort( server, 0, NULL, NULL, &msg.header, &size, NULL, &timeout );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+    ok( (msg.header.MessageType & 0xff) == LPC_REQUEST, "got type %#x\n", msg.header.MessageType );
+    ok( !strcmp( msg.data, "request" ), "got %s\n", debugstr_a(msg.data) );
+
+    strcpy( msg.data, "reply" );
+    msg.header.DataSize = sizeof("reply");
+    msg.header.MessageSize = sizeof(msg.header) + msg.header.DataSize;
+    status = pNtAlpcSendWaitReceivePort( server, 0, &msg.header, NULL, NULL, NULL, NULL, NULL );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+
+    status = pNtAlpcSendWaitReceivePort( server, 0, &msg.header, NULL, NULL, NULL, NULL, NULL );
+    ok( status == STATUS_REPLY_MESSAGE_MISMATCH, "NtAlpcSendWaitReceivePort returned %#lx\n", status );
+
+    size = sizeof(msg);
+    status = pNtAlpcSendWaitReceivePort( server, 0, NULL, NULL, &msg.header, &size, NULL, &timeout );
+    ok( !status, "NtAlpcSendWaitReceivePort failed %#lx\n", status );
+    ok( (msg.header.MessageType & 0xff) == LPC_PORT_CLOSED, "got type %#x\n", msg.header.MessageType );
+
+    ok( !WaitForSingleObject( thread, 5000 ), "thread didn't exit\n" );
+    CloseHandle( thread );
+    NtClose( client );
+    NtClose( server );
+
+    set_alpc_message( &msg, "connect" );
+    status = pNtAlpcConnectPort( &port, &name, NULL, NULL, 0, NULL, &msg.header, NULL, NULL, NULL, &timeout );
+    ok( status == STATUS_OBJECT_NAME_NOT_FOUND, "NtAlpcConnectPort returned %#lx\n", status );
+}
+
 START_TEST(port)
 {
     OBJECT_ATTRIBUTES obj;
     HANDLE port_handle;
     NTSTATUS status;
 
+    test_alpc();
+
     if (!init_function_ptrs())
         return;
 
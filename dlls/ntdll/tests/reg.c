@@ -2555,6 +2555,84 @@ static void test_NtRenameKey(void)
     pNtClose(key);
 }
 
+static void test_many_subkeys(void)
+{
+    static const unsigned int count = 1000;
+    char buffer[sizeof(KEY_FULL_INFORMATION) + 64];
+    KEY_BASIC_INFORMATION *basic = (KEY_BASIC_INFORMATION *)buffer;
+    KEY_VALUE_BASIC_INFORMATION *value_info = (KEY_VALUE_BASIC_INFORMATION *)buffer;
+    KEY_FULL_INFORMATION *full = (KEY_FULL_INFORMATION *)buffer;
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING str;
+    HANDLE key, subkey;
+    NTSTATUS status;
+    unsigned int i;
+    WCHAR name[16];
+    DWORD size;
+
+    InitializeObjectAttributes(&attr, &winetestpath, 0, 0, 0);
+    status = pNtCreateKey(&key, KEY_ALL_ACCESS, &attr, 0, 0, 0, 0);
+    ok(!status, "Unexpected status %#lx.\n", status);
+
+    attr.RootDirectory = key;
+    attr.ObjectName = &str;
+
+    /* insert subkeys and values out of order */
+    for (i = 0; i < count; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"key%04u", (i * 7) % count);
+        pRtlInitUnicodeString(&str, name);
+        status = pNtCreateKey(&subkey, KEY_ALL_ACCESS, &attr, 0, 0, REG_OPTION_VOLATILE, 0);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+        pNtClose(subkey);
+        status = pNtSetValueKey(key, &str, 0, REG_DWORD, &i, sizeof(i));
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+    }
+
+    status = pNtQueryKey(key, KeyFullInformation, full, sizeof(buffer), &size);
+    ok(!status, "Unexpected status %#lx.\n", status);
+    ok(full->SubKeys == count, "got %lu subkeys\n", full->SubKeys);
+    ok(full->Values == count, "got %lu values\n", full->Values);
+
+    for (i = 0; i < count; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"key%04u", i);
+        status = pNtEnumerateKey(key, i, KeyBasicInformation, basic, sizeof(buffer), &size);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+        ok(basic->NameLength == wcslen(name) * sizeof(WCHAR) && !memcmp(basic->Name, name, basic->NameLength),
+           "%u: got %s\n", i, wine_dbgstr_wn(basic->Name, basic->NameLength / sizeof(WCHAR)));
+        status = pNtEnumerateValueKey(key, i, KeyValueBasicInformation, value_info, sizeof(buffer), &size);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+        ok(value_info->NameLength == wcslen(name) * sizeof(WCHAR) &&
+           !memcmp(value_info->Name, name, value_info->NameLength),
+           "%u: got %s\n", i, wine_dbgstr_wn(value_info->Name, value_info->NameLength / sizeof(WCHAR)));
+    }
+    status = pNtEnumerateKey(key, count, KeyBasicInformation, basic, sizeof(buffer), &size);
+    ok(status == STATUS_NO_MORE_ENTRIES, "Unexpected status %#lx.\n", status);
+
+    /* delete them in a different order */
+    for (i = 0; i < count; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"key%04u", (i * 13) % count);
+        pRtlInitUnicodeString(&str, name);
+        status = pNtOpenKey(&subkey, DELETE, &attr);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+        status = pNtDeleteKey(subkey);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+        pNtClose(subkey);
+        status = pNtDeleteValueKey(key, &str);
+        ok(!status, "%u: unexpected status %#lx.\n", i, status);
+    }
+
+    status = pNtQueryKey(key, KeyFullInformation, full, sizeof(buffer), &size);
+    ok(!status, "Unexpected status %#lx.\n", status);
+    ok(!full->SubKeys, "got %lu subkeys\n", full->SubKeys);
+    ok(!full->Values, "got %lu values\n", full->Values);
+
+    pNtDeleteKey(key);
+    pNtClose(key);
+}
+
 static BOOL set_privileges(LPCSTR privilege, BOOL set)
 {
     TOKEN_PRIVILEGES tp;
@@ -2687,6 +2765,7 @@ START_TEST(reg)
     test_symlinks();
     test_redirection();
     test_NtRenameKey();
+    test_many_subkeys();
     test_NtRegLoadKeyEx();
 
     pRtlFreeUnicodeString(&winetestpath);
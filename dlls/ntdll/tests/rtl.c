@@ -3675,6 +3675,36 @@ static void test_RtlFindExportedRoutineByName(void)
     ok( proc == NULL, "Shouldn't find forwarded function\n" );
 }
 
+static void test_export_names(void)
+{
+    HMODULE module = GetModuleHandleW( L"ntdll" );
+    const IMAGE_EXPORT_DIRECTORY *exports;
+    const DWORD *names;
+    void *proc, *expect;
+    ULONG size, i;
+
+    if (!pRtlFindExportedRoutineByName)
+    {
+        win_skip( "RtlFindExportedRoutineByName is not present\n" );
+        return;
+    }
+    exports = RtlImageDirectoryEntryToData( module, TRUE, IMAGE_DIRECTORY_ENTRY_EXPORT, &size );
+    ok( exports != NULL, "no export directory\n" );
+    names = (const DWORD *)((const char *)module + exports->AddressOfNames);
+
+    /* every exported name must resolve to the same address as a plain table lookup */
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        const char *name = (const char *)module + names[i];
+
+        if (!(expect = pRtlFindExportedRoutineByName( module, name ))) continue;
+        proc = GetProcAddress( module, name );
+        ok( proc == expect, "%s: got %p, expected %p\n", name, proc, expect );
+    }
+    proc = GetProcAddress( module, "NtNonExistentFunction" );
+    ok( !proc, "got %p\n", proc );
+}
+
 START_TEST(rtl)
 {
     InitFunctionPtrs();
@@ -3722,4 +3752,5 @@ START_TEST(rtl)
     test_RtlInitializeSid();
     test_RtlValidSecurityDescriptor();
     test_RtlFindExportedRoutineByName();
+    test_export_names();
 }
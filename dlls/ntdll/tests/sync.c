@@ -901,6 +901,126 @@ static void test_close_io_completion(void)
     CloseHandle( thread );
 }
 
+static HANDLE latency_events[2];
+
+static DWORD WINAPI latency_thread( void *arg )
+{
+    unsigned int i, count = PtrToUlong( arg );
+    NTSTATUS status;
+
+    for (i = 0; i < count; i++)
+    {
+        status = NtWaitForSingleObject( latency_events[0], FALSE, NULL );
+        ok( !status, "got %#lx\n", status );
+        status = pNtSetEvent( latency_events[1], NULL );
+        ok( !status, "got %#lx\n", status );
+    }
+    return 0;
+}
+
+/* bounce between two threads to measure how quickly a waiter sees an event
+ * that is signaled shortly after it started waiting */
+static void test_event_latency(void)
+{
+    static const unsigned int count = 10000;
+    LARGE_INTEGER start, end, frequency;
+    NTSTATUS status;
+    unsigned int i;
+    HANDLE thread;
+
+    for (i = 0; i < 2; i++)
+    {
+        status = pNtCreateEvent( &latency_events[i], EVENT_ALL_ACCESS, NULL, SynchronizationEvent, FALSE );
+        ok( !status, "got %#lx\n", status );
+    }
+
+    thread = CreateThread( NULL, 0, latency_thread, ULongToPtr( count ), 0, NULL );
+    ok( !!thread, "failed to create thread, error %lu\n", GetLastError() );
+
+    QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < count; i++)
+    {
+        status = pNtSetEvent( latency_events[0], NULL );
+        ok( !status, "got %#lx\n", status );
+        status = NtWaitForSingleObject( latency_events[1], FALSE, NULL );
+        ok( !status, "got %#lx\n", status );
+    }
+    QueryPerformanceCounter( &end );
+
+    trace( "%u round trips, %.2f us each\n", count,
+           (end.QuadPart - start.QuadPart) * 1000000.0 / frequency.QuadPart / count );
+
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    pNtClose( latency_events[0] );
+    pNtClose( latency_events[1] );
+}
+
+struct contention_thread
+{
+    LONG *turn;
+    BOOL second;
+};
+
+static DWORD WINAPI futex_contention_thread( void *arg )
+{
+    struct contention_thread *params = arg;
+    LONG *turn = params->turn, mine = params->second ? 1 : 0, other = !mine;
+    unsigned int i;
+
+    for (i = 0; i < 2000; i++)
+    {
+        while (ReadNoFence( turn ) != mine) pRtlWaitOnAddress( turn, &other, 4, NULL );
+        InterlockedExchange( turn, other );
+        pRtlWakeAddressSingle( turn );
+    }
+    return 0;
+}
+
+/* several pairs of threads bouncing on their own page-aligned address at the
+ * same time; measures how much the pairs get in each other's way */
+static void test_wait_on_address_contention(void)
+{
+    static const unsigned int pairs = 4;
+    LARGE_INTEGER start, end, frequency;
+    struct contention_thread params[8];
+    HANDLE threads[8];
+    LONG *turns[4];
+    unsigned int i;
+
+    if (!pRtlWaitOnAddress)
+    {
+        win_skip( "RtlWaitOnAddress not supported, skipping test\n" );
+        return;
+    }
+
+    QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < 2 * pairs; i++)
+    {
+        if (!(i % 2))
+        {
+            turns[i / 2] = VirtualAlloc( NULL, 0x1000, MEM_COMMIT, PAGE_READWRITE );
+            ok( !!turns[i / 2], "failed to allocate memory, error %lu\n", GetLastError() );
+        }
+        params[i].turn = turns[i / 2];
+        params[i].second = i % 2;
+        threads[i] = CreateThread( NULL, 0, futex_contention_thread, &params[i], 0, NULL );
+        ok( !!threads[i], "failed to create thread, error %lu\n", GetLastError() );
+    }
+    WaitForMultipleObjects( 2 * pairs, threads, TRUE, INFINITE );
+    QueryPerformanceCounter( &end );
+
+    trace( "%u pairs, %.2f ms\n", pairs, (end.QuadPart - start.QuadPart) * 1000.0 / frequency.QuadPart );
+
+    for (i = 0; i < 2 * pairs; i++)
+    {
+        CloseHandle( threads[i] );
+        if (i % 2) VirtualFree( turns[i / 2], 0, MEM_RELEASE );
+    }
+}
+
 START_TEST(sync)
 {
     HMODULE module = GetModuleHandleA("ntdll.dll");
@@ -949,4 +1069,6 @@ START_TEST(sync)
     test_resource();
     test_tid_alert( argv );
     test_close_io_completion();
+    test_event_latency();
+    test_wait_on_address_contention();
 }
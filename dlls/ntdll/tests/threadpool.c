@@ -767,6 +767,43 @@ static void test_tp_work(void)
     pTpReleasePool(pool);
 }
 
+static LONG throughput_count;
+
+static void CALLBACK throughput_cb(TP_CALLBACK_INSTANCE *instance, void *userdata)
+{
+    if (!InterlockedDecrement(&throughput_count)) SetEvent(userdata);
+}
+
+static void test_tp_work_throughput(void)
+{
+    static const LONG count = 100000;
+    LARGE_INTEGER start, end, frequency;
+    NTSTATUS status;
+    HANDLE event;
+    DWORD result;
+    LONG i;
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    ok(event != NULL, "CreateEvent failed with error %lu\n", GetLastError());
+
+    throughput_count = count;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    for (i = 0; i < count; i++)
+    {
+        status = pTpSimpleTryPost(throughput_cb, event, NULL);
+        ok(!status, "TpSimpleTryPost failed with status %lx\n", status);
+    }
+    result = WaitForSingleObject(event, 30000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %lu\n", result);
+    QueryPerformanceCounter(&end);
+
+    trace("%ld simple callbacks in %.2f ms\n", count,
+          (end.QuadPart - start.QuadPart) * 1000.0 / frequency.QuadPart);
+
+    CloseHandle(event);
+}
+
 static void test_tp_work_scheduler(void)
 {
     TP_CALLBACK_ENVIRON environment;
@@ -2398,6 +2435,7 @@ START_TEST(threadpool)
     test_tp_simple();
     test_tp_work();
     test_tp_work_scheduler();
+    test_tp_work_throughput();
     test_tp_group_wait();
     test_tp_group_cancel();
     test_tp_instance();
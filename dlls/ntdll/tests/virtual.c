@@ -2189,6 +2189,82 @@ static void test_syscalls(void)
     UnmapViewOfFile( ptr );
 }
 
+static void test_fragmented_address_space(void)
+{
+    const unsigned int count = is_win64 ? 16384 : 4096, aligned_count = 256;
+    LARGE_INTEGER start, end, freq;
+    MEM_EXTENDED_PARAMETER ext;
+    MEM_ADDRESS_REQUIREMENTS a;
+    void **views, **aligned;
+    NTSTATUS status;
+    unsigned int i;
+    SIZE_T size;
+
+    if (!pNtAllocateVirtualMemoryEx)
+    {
+        win_skip("NtAllocateVirtualMemoryEx() is missing\n");
+        return;
+    }
+
+    views = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, count * sizeof(*views));
+    aligned = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, aligned_count * sizeof(*aligned));
+
+    /* leave lots of small holes in the address space */
+    for (i = 0; i < count; i++)
+    {
+        size = 0x10000;
+        status = NtAllocateVirtualMemory(NtCurrentProcess(), &views[i], 0, &size, MEM_RESERVE, PAGE_READWRITE);
+        if (status) break;
+    }
+    ok(i == count, "Failed to reserve view %u, status %08lx.\n", i, status);
+    for (i = 0; i < count; i += 2)
+    {
+        size = 0;
+        if (!views[i]) break;
+        status = NtFreeVirtualMemory(NtCurrentProcess(), &views[i], &size, MEM_RELEASE);
+        ok(!status, "Unexpected status %08lx.\n", status);
+        views[i] = NULL;
+    }
+
+    memset(&a, 0, sizeof(a));
+    a.Alignment = 0x100000;
+    memset(&ext, 0, sizeof(ext));
+    ext.Type = MemExtendedParameterAddressRequirements;
+    ext.Pointer = &a;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+    for (i = 0; i < aligned_count; i++)
+    {
+        size = 0x20000;
+        status = pNtAllocateVirtualMemoryEx(NtCurrentProcess(), &aligned[i], &size, MEM_RESERVE | MEM_TOP_DOWN,
+                                            PAGE_READWRITE, &ext, 1);
+        if (status) break;
+    }
+    QueryPerformanceCounter(&end);
+    ok(i == aligned_count, "Failed to reserve aligned view %u, status %08lx.\n", i, status);
+    trace("%u aligned top-down reservations with %u holes took %lu us\n", i, count / 2,
+          (DWORD)((end.QuadPart - start.QuadPart) * 1000000 / freq.QuadPart));
+
+    for (i = 0; i < aligned_count; i++)
+    {
+        if (!aligned[i]) break;
+        ok(!((ULONG_PTR)aligned[i] & 0xfffff), "Got unaligned address %p.\n", aligned[i]);
+        size = 0;
+        status = NtFreeVirtualMemory(NtCurrentProcess(), &aligned[i], &size, MEM_RELEASE);
+        ok(!status, "Unexpected status %08lx.\n", status);
+    }
+    for (i = 1; i < count; i += 2)
+    {
+        size = 0;
+        if (!views[i]) continue;
+        status = NtFreeVirtualMemory(NtCurrentProcess(), &views[i], &size, MEM_RELEASE);
+        ok(!status, "Unexpected status %08lx.\n", status);
+    }
+    HeapFree(GetProcessHeap(), 0, aligned);
+    HeapFree(GetProcessHeap(), 0, views);
+}
+
 static void test_NtFreeVirtualMemory(void)
 {
     void *addr1, *addr;
@@ -2491,6 +2567,103 @@ static void test_query_region_information(void)
     NtClose(mapping);
 }
 
+static void test_NtExtendSection(void)
+{
+    static const char testfile[] = "testfile.xxx";
+    SECTION_BASIC_INFORMATION info;
+    HANDLE file, mapping, mapping2;
+    LARGE_INTEGER size;
+    NTSTATUS status;
+    DWORD file_size;
+
+    file = CreateFileA( testfile, GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, 0 );
+    ok( file != INVALID_HANDLE_VALUE, "Failed to create test file\n" );
+
+    mapping = CreateFileMappingA( file, NULL, PAGE_READWRITE, 0, 0x1000, NULL );
+    ok( mapping != 0, "CreateFileMapping failed\n" );
+
+    size.QuadPart = 0x3000;
+    status = NtExtendSection( mapping, &size );
+    ok( status == STATUS_SUCCESS, "NtExtendSection returned %08lx\n", status );
+    ok( size.QuadPart == 0x3000, "wrong size %s\n", wine_dbgstr_longlong(size.QuadPart) );
+
+    status = NtQuerySection( mapping, SectionBasicInformation, &info, sizeof(info), NULL );
+    ok( status == STATUS_SUCCESS, "NtQuerySection returned %08lx\n", status );
+    ok( info.Size.QuadPart == 0x3000, "wrong size %s\n", wine_dbgstr_longlong(info.Size.QuadPart) );
+    file_size = GetFileSize( file, NULL );
+    ok( file_size == 0x3000, "wrong file size %#lx\n", file_size );
+
+    /* sections never shrink */
+    size.QuadPart = 0x2000;
+    status = NtExtendSection( mapping, &size );
+    ok( status == STATUS_SUCCESS, "NtExtendSection returned %08lx\n", status );
+    ok( size.QuadPart == 0x3000, "wrong size %s\n", wine_dbgstr_longlong(size.QuadPart) );
+
+    status = NtDuplicateObject( NtCurrentProcess(), mapping, NtCurrentProcess(), &mapping2,
+                                SECTION_MAP_READ | SECTION_QUERY, 0, 0 );
+    ok( status == STATUS_SUCCESS, "NtDuplicateObject returned %08lx\n", status );
+    size.QuadPart = 0x4000;
+    status = NtExtendSection( mapping2, &size );
+    ok( status == STATUS_ACCESS_DENIED, "NtExtendSection returned %08lx\n", status );
+    NtClose( mapping2 );
+
+    NtClose( mapping );
+    NtClose( file );
+    DeleteFileA( testfile );
+}
+
+static void test_query_usage_information(void)
+{
+    MEMORY_WINE_USAGE_INFORMATION info;
+    NTSTATUS status;
+    SIZE_T size;
+    char *ptr;
+    int dummy;
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), NULL, MemoryWineUsageInformation, &info, sizeof(info), &size);
+    if (status == STATUS_INVALID_INFO_CLASS)
+    {
+        win_skip("MemoryWineUsageInformation is not supported.\n");
+        return;
+    }
+    ok(!status, "Unexpected status %08lx.\n", status);
+    ok(size == sizeof(info), "Unexpected size %Iu.\n", size);
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), NULL, MemoryWineUsageInformation, &info, sizeof(info) - 1, NULL);
+    ok(status == STATUS_INFO_LENGTH_MISMATCH, "Unexpected status %08lx.\n", status);
+
+    ptr = VirtualAlloc(NULL, 0x100000, MEM_RESERVE, PAGE_READWRITE);
+    ok(!!ptr, "VirtualAlloc failed.\n");
+    ok(!!VirtualAlloc(ptr, 0x4000, MEM_COMMIT, PAGE_READWRITE), "VirtualAlloc failed.\n");
+    memset(ptr, 0xcc, 0x2000);
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), ptr, MemoryWineUsageInformation, &info, sizeof(info), NULL);
+    ok(!status, "Unexpected status %08lx.\n", status);
+    ok(info.BaseAddress == (ULONG_PTR)ptr, "Unexpected base %I64x, expected %p.\n", info.BaseAddress, ptr);
+    ok(info.RegionSize == 0x100000, "Unexpected region size %I64x.\n", info.RegionSize);
+    ok(info.CommitSize == 0x4000, "Unexpected commit size %I64x.\n", info.CommitSize);
+    ok(info.ResidentSize >= 0x2000 && info.ResidentSize <= 0x4000, "Unexpected resident size %I64x.\n",
+       info.ResidentSize);
+    ok(info.UsageType == MemoryWineUsagePrivate, "Unexpected type %lu.\n", info.UsageType);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), GetModuleHandleA(NULL), MemoryWineUsageInformation,
+                                  &info, sizeof(info), NULL);
+    ok(!status, "Unexpected status %08lx.\n", status);
+    ok(info.BaseAddress == (ULONG_PTR)GetModuleHandleA(NULL), "Unexpected base %I64x.\n", info.BaseAddress);
+    ok(info.UsageType == MemoryWineUsageImage, "Unexpected type %lu.\n", info.UsageType);
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), &dummy, MemoryWineUsageInformation, &info, sizeof(info), NULL);
+    ok(!status, "Unexpected status %08lx.\n", status);
+    ok(info.UsageType == MemoryWineUsageStack, "Unexpected type %lu.\n", info.UsageType);
+    ok(info.ResidentSize, "Stack is not resident.\n");
+
+    status = NtQueryVirtualMemory(NtCurrentProcess(), GetProcessHeap(), MemoryWineUsageInformation,
+                                  &info, sizeof(info), NULL);
+    ok(!status, "Unexpected status %08lx.\n", status);
+    ok(info.UsageType == MemoryWineUsageHeap, "Unexpected type %lu.\n", info.UsageType);
+}
+
 static void test_query_image_information(void)
 {
     MEMORY_IMAGE_INFORMATION info;
@@ -2745,13 +2918,16 @@ START_TEST(virtual)
     test_NtAllocateVirtualMemory();
     test_NtAllocateVirtualMemoryEx();
     test_NtAllocateVirtualMemoryEx_address_requirements();
+    test_fragmented_address_space();
     test_NtFreeVirtualMemory();
     test_RtlCreateUserStack();
     test_NtMapViewOfSection();
     test_NtMapViewOfSectionEx();
+    test_NtExtendSection();
     test_prefetch();
     test_user_shared_data();
     test_syscalls();
     test_query_region_information();
     test_query_image_information();
+    test_query_usage_information();
 }
@@ -1426,7 +1426,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
  */
 static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
 {
-    struct waitqueue_bucket *bucket;
+    struct waitqueue_bucket *bucket, *best = NULL;
     NTSTATUS status;
     HANDLE thread;
     BOOL alertable = (wait->u.wait.flags & WT_EXECUTEINIOTHREAD) != 0;
@@ -1440,18 +1440,23 @@ static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
 
     RtlEnterCriticalSection( &waitqueue.cs );
 
-    /* Try to assign to existing bucket if possible. */
+    /* Try to assign to existing bucket if possible. Use the fullest one, so
+     * that sparsely used buckets get a chance to drain and their threads
+     * to exit, instead of every bucket staying partially filled. */
     LIST_FOR_EACH_ENTRY( bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
     {
-        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS && bucket->alertable == alertable)
-        {
-            list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
-            wait->u.wait.bucket = bucket;
-            bucket->objcount++;
+        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS && bucket->alertable == alertable &&
+            (!best || bucket->objcount > best->objcount))
+            best = bucket;
+    }
+    if (best)
+    {
+        list_add_tail( &best->reserved, &wait->u.wait.wait_entry );
+        wait->u.wait.bucket = best;
+        best->objcount++;
 
-            status = STATUS_SUCCESS;
-            goto out;
-        }
+        status = STATUS_SUCCESS;
+        goto out;
     }
 
     /* Create a new bucket and corresponding worker thread. */
@@ -1993,16 +1998,23 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
 {
     struct threadpool *pool = object->pool;
     NTSTATUS status = STATUS_UNSUCCESSFUL;
+    BOOL new_worker = FALSE;
 
     assert( !object->shutdown );
     assert( !pool->shutdown );
 
     RtlEnterCriticalSection( &pool->cs );
 
-    /* Start new worker threads if required. */
+    /* Start new worker threads if required. The thread is accounted for
+     * here, but created after the lock is released, so that submitters
+     * and workers don't wait for the thread creation. */
     if (pool->num_busy_workers >= pool->num_workers &&
         pool->num_workers < pool->max_workers)
-        status = tp_new_worker_thread( pool );
+    {
+        InterlockedIncrement( &pool->refcount );
+        pool->num_workers++;
+        new_worker = TRUE;
+    }
 
     /* Queue work item and increment refcount. */
     InterlockedIncrement( &object->refcount );
@@ -2013,14 +2025,31 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
     if (object->type == TP_OBJECT_TYPE_WAIT && signaled)
         object->u.wait.signaled++;
 
-    /* No new thread started - wake up one existing thread. */
-    if (status != STATUS_SUCCESS)
+    RtlLeaveCriticalSection( &pool->cs );
+
+    if (new_worker)
     {
-        assert( pool->num_workers > 0 );
-        RtlWakeConditionVariable( &pool->update_event );
+        HANDLE thread;
+
+        status = RtlCreateUserThread( GetCurrentProcess(), NULL, FALSE, 0,
+                                      pool->stack_info.StackReserve, pool->stack_info.StackCommit,
+                                      threadpool_worker_proc, pool, &thread, NULL );
+        if (status == STATUS_SUCCESS) NtClose( thread );
+        else
+        {
+            RtlEnterCriticalSection( &pool->cs );
+            pool->num_workers--;
+            assert( pool->num_workers > 0 );
+            RtlLeaveCriticalSection( &pool->cs );
+            InterlockedDecrement( &pool->refcount );
+        }
     }
 
-    RtlLeaveCriticalSection( &pool->cs );
+    /* No new thread started - wake up one existing thread. This is done
+     * outside of the lock, so that the woken thread doesn't immediately
+     * block on it again. */
+    if (status != STATUS_SUCCESS)
+        RtlWakeConditionVariable( &pool->update_event );
 }
 
 /***********************************************************************
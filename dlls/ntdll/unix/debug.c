@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <errno.h>
@@ -67,6 +68,11 @@ static struct __wine_debug_channel *debug_options;
 
 static const char * const debug_classes[] = { "fixme", "err", "warn", "trace" };
 
+/* with WINE_DEBUG_RING_SIZE set, output is kept in memory and only written at exit */
+static char *ring_buffer;
+static size_t ring_size;
+static size_t ring_pos;
+
 /* get the debug info pointer for the current thread */
 static inline struct debug_info *get_info(void)
 {
@@ -78,6 +84,27 @@ static inline struct debug_info *get_info(void)
 #endif
 }
 
+/* write debug output, or add it to the ring buffer */
+static void debug_write( const char *str, size_t len )
+{
+    size_t pos, count;
+
+    if (!ring_buffer)
+    {
+        write( 2, str, len );
+        return;
+    }
+    if (len > ring_size)
+    {
+        str += len - ring_size;
+        len = ring_size;
+    }
+    pos = __atomic_fetch_add( &ring_pos, len, __ATOMIC_RELAXED ) & (ring_size - 1);
+    count = min( len, ring_size - pos );
+    memcpy( ring_buffer + pos, str, count );
+    memcpy( ring_buffer, str + count, len - count );
+}
+
 /* add a string to the output buffer */
 static int append_output( struct debug_info *info, const char *str, size_t len )
 {
@@ -199,6 +226,51 @@ static void debug_usage(void)
     exit(1);
 }
 
+/* allocate the ring buffer, its size is given in megabytes */
+static void init_ring_buffer(void)
+{
+    const char *str = getenv( "WINE_DEBUG_RING_SIZE" );
+    size_t size;
+    void *ptr;
+
+    if (!str || !(size = strtoul( str, NULL, 10 ))) return;
+    size = min( size, 1024 ) << 20;
+    while (size & (size - 1)) size &= size - 1;
+    if ((ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 )) == MAP_FAILED) return;
+    ring_size = size;
+    ring_buffer = ptr;
+}
+
+/***********************************************************************
+ *		dbg_flush_ring_buffer
+ *
+ * Write out the contents of the ring buffer, oldest lines first.
+ */
+void dbg_flush_ring_buffer(void)
+{
+    char *buffer = InterlockedExchangePointer( (void **)&ring_buffer, NULL );
+    size_t pos = __atomic_load_n( &ring_pos, __ATOMIC_RELAXED ), start, len;
+    const char *p;
+
+    if (!buffer) return;
+    if (pos <= ring_size)
+    {
+        write( 2, buffer, pos );
+        return;
+    }
+
+    /* skip the partially overwritten oldest line */
+    start = pos & (ring_size - 1);
+    len = ring_size - start;
+    if ((p = memchr( buffer + start, '\n', len )))
+    {
+        write( 2, p + 1, buffer + ring_size - p - 1 );
+        write( 2, buffer, start );
+    }
+    else if ((p = memchr( buffer, '\n', start )))
+        write( 2, p + 1, buffer + start - p - 1 );
+}
+
 /* initialize all options at startup */
 static void init_options(void)
 {
@@ -207,6 +279,7 @@ static void init_options(void)
     struct stat st1, st2;
 
     nb_debug_options = 0;
+    init_ring_buffer();
 
     /* check for stderr pointing to /dev/null */
     if (!fstat( 2, &st1 ) && S_ISCHR(st1.st_mode) &&
@@ -273,7 +346,8 @@ NTSTATUS unixcall_wine_dbg_write( void *args )
 {
     struct wine_dbg_write_params *params = args;
 
-    return write( 2, params->str, params->len );
+    debug_write( params->str, params->len );
+    return params->len;
 }
 
 unsigned int WINAPI __wine_dbg_ftrace( char *str, unsigned int str_size, unsigned int ctx )
@@ -336,7 +410,8 @@ NTSTATUS wow64_wine_dbg_write( void *args )
         unsigned int len;
     } const *params32 = args;
 
-    return write( 2, ULongToPtr(params32->str), params32->len );
+    debug_write( ULongToPtr(params32->str), params32->len );
+    return params32->len;
 }
 #endif
 
@@ -352,7 +427,7 @@ int __cdecl __wine_dbg_output( const char *str )
     if (end)
     {
         ret += append_output( info, str, end + 1 - str );
-        write( 2, info->output, info->out_pos );
+        debug_write( info->output, info->out_pos );
         info->out_pos = 0;
         str = end + 1;
     }
@@ -33,6 +33,7 @@
 #include <stdarg.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #ifdef HAVE_SYS_PRCTL_H
@@ -113,29 +114,23 @@ static char *get_nls_file_path( UINT type, UINT id )
     return path;
 }
 
-static void *read_nls_file( const char *name )
+/* map an NLS file read-only, so that its pages are shared with the other processes using it */
+static void *read_nls_file( const char *name, size_t *size )
 {
     const char *dir = build_dir ? build_dir : data_dir;
     char *path;
     struct stat st;
-    void *data, *ret = NULL;
+    void *ret = NULL;
     int fd;
 
     if (asprintf( &path, "%s/nls/%s", dir, name ) == -1) return NULL;
 
     if ((fd = open( path, O_RDONLY )) != -1)
     {
-        fstat( fd, &st );
-        if ((data = malloc( st.st_size )) && st.st_size > 0x1000 &&
-            read( fd, data, st.st_size ) == st.st_size)
-        {
-            ret = data;
-        }
-        else
-        {
-            free( data );
-            data = NULL;
-        }
+        if (!fstat( fd, &st ) && st.st_size > 0x1000 &&
+            (ret = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+            ret = NULL;
+        if (ret && size) *size = st.st_size;
         close( fd );
     }
     else ERR( "failed to load %s\n", path );
@@ -204,7 +199,7 @@ static struct norm_table *nfc_table;
 
 static void init_unix_codepage(void)
 {
-    nfc_table = read_nls_file( "normnfc.nls" );
+    nfc_table = read_nls_file( "normnfc.nls", NULL );
 }
 
 #elif defined(__ANDROID__)  /* Android always uses UTF-8 */
@@ -306,7 +301,7 @@ static void init_unix_codepage(void)
                 void *data;
 
                 snprintf( buffer, sizeof(buffer), "c_%03u.nls", charset_names[pos].cp );
-                if ((data = read_nls_file( buffer ))) init_codepage_table( data, &unix_cp );
+                if ((data = read_nls_file( buffer, NULL ))) init_codepage_table( data, &unix_cp );
             }
             return;
         }
@@ -804,6 +799,7 @@ static void init_locale(void)
     const char *all, *ctype, *messages;
     const NLS_LOCALE_HEADER *locale_table;
     const NLS_LOCALE_DATA *locale;
+    size_t size;
     char *p;
 
     if (!(all = setlocale( LC_ALL, "" )) && (all = getenv( "LC_ALL" )))
@@ -874,7 +870,7 @@ static void init_locale(void)
     }
 #endif
 
-    if ((header = read_nls_file( "locale.nls" )))
+    if ((header = read_nls_file( "locale.nls", &size )))
     {
         locale_table = (const NLS_LOCALE_HEADER *)((char *)header + header->locales);
         while (!(locale = get_win_locale( locale_table, system_locale )))
@@ -892,7 +888,7 @@ static void init_locale(void)
         }
         if (locale) user_lcid = locale->idefaultlanguage;
 
-        free( header );
+        munmap( header, size );
     }
     if (!system_lcid) system_lcid = MAKELANGID( LANG_ENGLISH, SUBLANG_DEFAULT );
     if (!user_lcid) user_lcid = system_lcid;
@@ -912,7 +908,7 @@ void init_environment(void)
     init_unix_codepage();
     init_locale();
 
-    if ((case_table = read_nls_file( "l_intl.nls" )))
+    if ((case_table = read_nls_file( "l_intl.nls", NULL )))
     {
         uctable = case_table + 2;
         lctable = case_table + case_table[1] + 2;
@@ -804,6 +804,33 @@ static BOOL update_grabbed_object( struct esync *obj )
     return ret;
 }
 
+/* Check the shared state of the objects for a hint that one of them became signaled. */
+static BOOL any_object_signaled( struct esync * const *objs, DWORD count )
+{
+    DWORD i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!objs[i]) continue;
+        switch (objs[i]->type)
+        {
+        case ESYNC_MUTEX:
+            if (!((struct mutex *)objs[i]->shm)->count) return TRUE;
+            break;
+        case ESYNC_SEMAPHORE:
+            if (((struct semaphore *)objs[i]->shm)->count) return TRUE;
+            break;
+        case ESYNC_AUTO_EVENT:
+        case ESYNC_MANUAL_EVENT:
+            if (((struct event *)objs[i]->shm)->signaled) return TRUE;
+            break;
+        default:
+            break;
+        }
+    }
+    return FALSE;
+}
+
 /* A value of STATUS_NOT_IMPLEMENTED returned from this function means that we
  * need to delegate to server_select(). */
 static NTSTATUS __esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN wait_any,
@@ -821,6 +848,7 @@ static NTSTATUS __esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEA
     ULONGLONG end;
     int64_t value;
     ssize_t size;
+    unsigned int spin, spins;
     int i, j, ret;
 
     /* Grab the APC fd if we don't already have it. */
@@ -1005,6 +1033,18 @@ static NTSTATUS __esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEA
         }
         pollcount = i;
 
+        /* The objects may well be signaled again before poll() would put us to
+         * sleep and wake us up, so spin on their shared state for a bit first. */
+        if ((!timeout || timeout->QuadPart) && objs[0] && (spins = get_sync_spin_count( objs[0]->shm )))
+        {
+            for (spin = 0; spin < spins; spin++)
+            {
+                YieldProcessor();
+                if (any_object_signaled( objs, count )) break;
+            }
+            update_sync_spin_count( objs[0]->shm, spin, spin < spins );
+        }
+
         while (1)
         {
             if (ac_odyssey && alertable)
@@ -49,6 +49,11 @@
 #ifdef HAVE_SYS_SYSCALL_H
 # include <sys/syscall.h>
 #endif
+#if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup)
+# include <sys/mman.h>
+# include <linux/io_uring.h>
+# define USE_FILE_URING
+#endif
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/ioctl.h>
@@ -106,6 +111,9 @@
 #undef XATTR_ADDITIONAL_OPTIONS
 #include <sys/extattr.h>
 #endif
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
 #include <time.h>
 #include <unistd.h>
 
@@ -122,11 +130,14 @@
 #include "ddk/mountmgr.h"
 #include "wine/server.h"
 #include "wine/list.h"
+#include "wine/rbtree.h"
+#include "wine/sdt.h"
 #include "wine/debug.h"
 #include "unix_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(file);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
+WINE_DECLARE_DEBUG_CHANNEL(dirindex);
 
 #define MAX_DOS_DRIVES 26
 
@@ -535,21 +546,24 @@ struct dir_name
     char name[1];
 };
 
-static struct list dir_queue = LIST_INIT( dir_queue );
+static struct list dir_queue = LIST_INIT( dir_queue );  /* protected by dir_mutex */
 
-static NTSTATUS add_dir_to_queue( const char *name )
+static LONG dir_prefetch_pending = -1;  /* prefetch roots not started yet, -1 until initialized */
+static void start_dir_prefetch( const char *unix_name );
+
+static NTSTATUS add_dir_to_queue( struct list *queue, const char *name )
 {
     int len = strlen( name ) + 1;
     struct dir_name *dir = malloc( offsetof( struct dir_name, name[len] ));
     if (!dir) return STATUS_NO_MEMORY;
     strcpy( dir->name, name );
-    list_add_tail( &dir_queue, &dir->entry );
+    list_add_tail( queue, &dir->entry );
     return STATUS_SUCCESS;
 }
 
-static NTSTATUS next_dir_in_queue( char *name )
+static NTSTATUS next_dir_in_queue( struct list *queue, char *name )
 {
-    struct list *head = list_head( &dir_queue );
+    struct list *head = list_head( queue );
     if (head)
     {
         struct dir_name *dir = LIST_ENTRY( head, struct dir_name, entry );
@@ -561,11 +575,11 @@ static NTSTATUS next_dir_in_queue( char *name )
     return STATUS_OBJECT_NAME_NOT_FOUND;
 }
 
-static void flush_dir_queue(void)
+static void flush_dir_queue( struct list *queue )
 {
     struct list *head;
 
-    while ((head = list_head( &dir_queue )))
+    while ((head = list_head( queue )))
     {
         struct dir_name *dir = LIST_ENTRY( head, struct dir_name, entry );
         list_remove( &dir->entry );
@@ -1676,14 +1690,59 @@ static NTSTATUS fd_set_file_info( int fd, HANDLE handle, UINT attr, BOOL force_s
 
 
 /* get the stat info and file attributes for a file (by name) */
+/* lstat() a file, also returning whether it is a mount point: 1 if it is, 0 if not, -1 if unknown */
+static int lstat_mount_point( const char *path, struct stat *st, int *mount_point )
+{
+#ifdef HAVE_STATX
+    /* only ask for what fill_file_info() needs */
+    static const unsigned int mask = STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_INO | STATX_SIZE |
+                                     STATX_BLOCKS | STATX_ATIME | STATX_MTIME | STATX_CTIME;
+    static BOOL no_statx;
+    struct statx stx;
+
+    if (!no_statx)
+    {
+        if (!statx( AT_FDCWD, path, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &stx ))
+        {
+            memset( st, 0, sizeof(*st) );
+            st->st_dev     = makedev( stx.stx_dev_major, stx.stx_dev_minor );
+            st->st_rdev    = makedev( stx.stx_rdev_major, stx.stx_rdev_minor );
+            st->st_ino     = stx.stx_ino;
+            st->st_mode    = stx.stx_mode;
+            st->st_nlink   = stx.stx_nlink;
+            st->st_uid     = stx.stx_uid;
+            st->st_gid     = stx.stx_gid;
+            st->st_size    = stx.stx_size;
+            st->st_blksize = stx.stx_blksize;
+            st->st_blocks  = stx.stx_blocks;
+            st->st_atim.tv_sec  = stx.stx_atime.tv_sec;
+            st->st_atim.tv_nsec = stx.stx_atime.tv_nsec;
+            st->st_mtim.tv_sec  = stx.stx_mtime.tv_sec;
+            st->st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
+            st->st_ctim.tv_sec  = stx.stx_ctime.tv_sec;
+            st->st_ctim.tv_nsec = stx.stx_ctime.tv_nsec;
+            if (stx.stx_attributes_mask & STATX_ATTR_MOUNT_ROOT)
+                *mount_point = !!(stx.stx_attributes & STATX_ATTR_MOUNT_ROOT);
+            else
+                *mount_point = -1;
+            return 0;
+        }
+        if (errno != ENOSYS) return -1;
+        no_statx = TRUE;
+    }
+#endif
+    *mount_point = -1;
+    return lstat( path, st );
+}
+
 static int get_file_info( const char *path, struct stat *st, ULONG *attr )
 {
     char *parent_path;
     char attr_data[65];
-    int attr_len, ret;
+    int attr_len, ret, mount_point;
 
     *attr = 0;
-    ret = lstat( path, st );
+    ret = lstat_mount_point( path, st, &mount_point );
     if (ret == -1) return ret;
     if (S_ISLNK( st->st_mode ))
     {
@@ -1692,6 +1751,11 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr )
         /* is a symbolic link and a directory, consider these "reparse points" */
         if (S_ISDIR( st->st_mode )) *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
     }
+    else if (S_ISDIR( st->st_mode ) && mount_point != -1)
+    {
+        /* consider mount points to be reparse points (IO_REPARSE_TAG_MOUNT_POINT) */
+        if (mount_point) *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
+    }
     else if (S_ISDIR( st->st_mode ) && (parent_path = malloc( strlen(path) + 4 )))
     {
         struct stat parent_st;
@@ -2255,12 +2319,21 @@ static NTSTATUS get_dir_data_entry( struct dir_data *dir_data, void *info_ptr, I
     struct stat st;
     ULONG name_len, start, dir_size, attributes;
 
-    if (get_file_info( names->unix_name, &st, &attributes ) == -1)
+    if (class == FileNamesInformation)
+    {
+        /* only the name is returned, stat just enough to check the ignored files */
+        if (ignored_files_count && !stat( names->unix_name, &st ) && is_ignored_file( &st ))
+        {
+            TRACE( "ignoring file %s\n", names->unix_name );
+            return STATUS_SUCCESS;
+        }
+    }
+    else if (get_file_info( names->unix_name, &st, &attributes ) == -1)
     {
         TRACE( "file no longer exists %s\n", names->unix_name );
         return STATUS_SUCCESS;
     }
-    if (is_ignored_file( &st ))
+    else if (is_ignored_file( &st ))
     {
         TRACE( "ignoring file %s\n", names->unix_name );
         return STATUS_SUCCESS;
@@ -2737,6 +2810,17 @@ NTSTATUS WINAPI NtQueryDirectoryFile( HANDLE handle, HANDLE event, PIO_APC_ROUTI
         return STATUS_INVALID_PARAMETER;
     }
 
+    if (dir_prefetch_pending)
+    {
+        char *unix_name;
+
+        if (!server_get_unix_name( handle, &unix_name ))
+        {
+            start_dir_prefetch( unix_name );
+            free( unix_name );
+        }
+    }
+
     io->Information = 0;
 
     mutex_lock( &dir_mutex );
@@ -2775,6 +2859,507 @@ NTSTATUS WINAPI NtQueryDirectoryFile( HANDLE handle, HANDLE event, PIO_APC_ROUTI
 }
 
 
+/* index of the names of a directory, hashed on their upper-case form */
+struct dir_index_entry
+{
+    unsigned int next;              /* offset + 1 of the next entry in the bucket */
+    unsigned int hash;              /* hash of the upper-case name */
+    char         name[1];           /* unix name */
+};
+
+struct dir_index
+{
+    struct wine_rb_entry entry;     /* entry in dir_indexes tree */
+    struct list          lru;       /* entry in dir_index_lru list */
+    dev_t                dev;       /* device of the directory */
+    ino_t                ino;       /* inode of the directory */
+    time_t               mtime;     /* modification time of the directory when indexed */
+    long                 mtime_ns;
+    int                  wd;        /* inotify watch descriptor */
+    size_t               size;      /* total allocated size */
+    char                *data;      /* entries */
+    unsigned int         mask;      /* buckets count - 1 */
+    unsigned int         buckets[1];
+};
+
+#define DIR_INDEX_DEFAULT_BUDGET 16  /* in MiB */
+
+static int dir_index_compare( const void *key, const struct wine_rb_entry *entry )
+{
+    const struct stat *st = key;
+    const struct dir_index *index = WINE_RB_ENTRY_VALUE( entry, const struct dir_index, entry );
+
+    if (st->st_dev != index->dev) return st->st_dev < index->dev ? -1 : 1;
+    if (st->st_ino != index->ino) return st->st_ino < index->ino ? -1 : 1;
+    return 0;
+}
+
+static pthread_mutex_t dir_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct wine_rb_tree dir_indexes = { dir_index_compare };
+static struct list dir_index_lru = LIST_INIT( dir_index_lru );
+static size_t dir_index_budget = ~(size_t)0;
+static size_t dir_index_size;
+static unsigned int dir_index_count;
+static int dir_index_inotify = -1;
+static ULONG64 dir_index_hits, dir_index_misses, dir_index_builds, dir_index_invalidations;
+
+static inline long get_mtime_ns( const struct stat *st )
+{
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    return st->st_mtim.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+static unsigned int hash_dir_entry_name( const WCHAR *name, int length )
+{
+    unsigned int hash = 0;
+    while (length--) hash = hash * 31 + ntdll_towupper( *name++ );
+    return hash;
+}
+
+static void dump_dir_index_stats(void)
+{
+    TRACE_( dirindex )( "%u indexes, %lu bytes, hits %s misses %s builds %s invalidations %s\n",
+                        dir_index_count, (unsigned long)dir_index_size,
+                        wine_dbgstr_longlong( dir_index_hits ), wine_dbgstr_longlong( dir_index_misses ),
+                        wine_dbgstr_longlong( dir_index_builds ),
+                        wine_dbgstr_longlong( dir_index_invalidations ));
+}
+
+static void free_dir_index( struct dir_index *index )
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    if (index->wd != -1) inotify_rm_watch( dir_index_inotify, index->wd );
+#endif
+    free( index->data );
+    free( index );
+}
+
+/* remove an index from the cache; dir_index_mutex must be held */
+static void remove_dir_index( struct dir_index *index )
+{
+    wine_rb_remove( &dir_indexes, &index->entry );
+    list_remove( &index->lru );
+    dir_index_size -= index->size;
+    dir_index_count--;
+    dir_index_invalidations++;
+    free_dir_index( index );
+}
+
+/* invalidate the indexes of the directories that changed; dir_index_mutex must be held */
+static void process_dir_index_events(void)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *event;
+    struct dir_index *index, *next;
+    ssize_t len, pos;
+
+    if (dir_index_inotify == -1) return;
+
+    while ((len = read( dir_index_inotify, buffer, sizeof(buffer) )) > 0)
+    {
+        for (pos = 0; pos < len; pos += sizeof(*event) + event->len)
+        {
+            event = (const struct inotify_event *)(buffer + pos);
+            LIST_FOR_EACH_ENTRY_SAFE( index, next, &dir_index_lru, struct dir_index, lru )
+            {
+                if (!(event->mask & IN_Q_OVERFLOW) && index->wd != event->wd) continue;
+                if (event->mask & IN_IGNORED) index->wd = -1;  /* the watch is already gone */
+                remove_dir_index( index );
+                if (!(event->mask & IN_Q_OVERFLOW)) break;
+            }
+        }
+    }
+#endif
+}
+
+/* read a whole directory into a new index */
+static struct dir_index *build_dir_index( const char *unix_name, const struct stat *st )
+{
+    WCHAR buffer[MAX_DIR_ENTRY_LEN];
+    struct dir_index_entry *entry;
+    struct dir_index *index;
+    struct dirent *de;
+    char *data = NULL, *new_data;
+    size_t data_size = 0, data_max = 0, entry_size;
+    unsigned int count = 0, buckets, pos;
+    int wd = -1, ret;
+    DIR *dir;
+
+#ifdef HAVE_SYS_INOTIFY_H
+    /* add the watch first, so that changes made while reading are noticed */
+    if (dir_index_inotify != -1)
+        wd = inotify_add_watch( dir_index_inotify, unix_name, IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR );
+#endif
+
+    if (!(dir = opendir( unix_name ))) goto failed;
+    while ((de = readdir( dir )))
+    {
+        ret = ntdll_umbstowcs( de->d_name, strlen(de->d_name), buffer, MAX_DIR_ENTRY_LEN );
+        entry_size = (offsetof( struct dir_index_entry, name[strlen(de->d_name) + 1] ) + 3) & ~3;
+        if (data_size + entry_size > data_max)
+        {
+            data_max = max( 4096, max( data_max * 2, data_size + entry_size ));
+            if (!(new_data = realloc( data, data_max )))
+            {
+                closedir( dir );
+                goto failed;
+            }
+            data = new_data;
+        }
+        entry = (struct dir_index_entry *)(data + data_size);
+        entry->next = 0;
+        entry->hash = hash_dir_entry_name( buffer, ret );
+        strcpy( entry->name, de->d_name );
+        data_size += entry_size;
+        count++;
+    }
+    closedir( dir );
+
+    for (buckets = 16; buckets < count; buckets *= 2) ;
+    if (!(index = calloc( 1, offsetof( struct dir_index, buckets[buckets] )))) goto failed;
+    index->dev      = st->st_dev;
+    index->ino      = st->st_ino;
+    index->mtime    = st->st_mtime;
+    index->mtime_ns = get_mtime_ns( st );
+    index->wd       = wd;
+    index->data     = data;
+    index->size     = offsetof( struct dir_index, buckets[buckets] ) + data_max;
+    index->mask     = buckets - 1;
+
+    /* chain entries in directory order, as a directory scan would find them */
+    for (pos = 0; pos < data_size; pos += entry_size)
+    {
+        entry = (struct dir_index_entry *)(data + pos);
+        entry_size = (offsetof( struct dir_index_entry, name[strlen(entry->name) + 1] ) + 3) & ~3;
+        entry->next = index->buckets[entry->hash & index->mask];
+        index->buckets[entry->hash & index->mask] = pos + 1;
+    }
+    /* that reversed the chains, put them back in order */
+    for (pos = 0; pos < buckets; pos++)
+    {
+        unsigned int prev = 0, cur = index->buckets[pos], next;
+        while (cur)
+        {
+            entry = (struct dir_index_entry *)(data + cur - 1);
+            next = entry->next;
+            entry->next = prev;
+            prev = cur;
+            cur = next;
+        }
+        index->buckets[pos] = prev;
+    }
+    return index;
+
+failed:
+#ifdef HAVE_SYS_INOTIFY_H
+    if (wd != -1) inotify_rm_watch( dir_index_inotify, wd );
+#endif
+    free( data );
+    return NULL;
+}
+
+static BOOL lookup_dir_index( const struct dir_index *index, const WCHAR *name, int length, char *unix_name )
+{
+    WCHAR buffer[MAX_DIR_ENTRY_LEN];
+    unsigned int hash = hash_dir_entry_name( name, length ), pos = index->buckets[hash & index->mask];
+    const struct dir_index_entry *entry;
+    int ret;
+
+    while (pos)
+    {
+        entry = (const struct dir_index_entry *)(index->data + pos - 1);
+        if (entry->hash == hash)
+        {
+            ret = ntdll_umbstowcs( entry->name, strlen(entry->name), buffer, MAX_DIR_ENTRY_LEN );
+            if (ret == length && !wcsnicmp( buffer, name, ret ))
+            {
+                strcpy( unix_name, entry->name );
+                return TRUE;
+            }
+        }
+        pos = entry->next;
+    }
+    return FALSE;
+}
+
+/* find a cached index for the directory, checking that it's still valid; dir_index_mutex must be held */
+static struct dir_index *get_dir_index( const struct stat *st )
+{
+    struct wine_rb_entry *entry;
+    struct dir_index *index;
+
+    process_dir_index_events();
+    if (!(entry = wine_rb_get( &dir_indexes, st ))) return NULL;
+    index = WINE_RB_ENTRY_VALUE( entry, struct dir_index, entry );
+    if (index->mtime != st->st_mtime || index->mtime_ns != get_mtime_ns( st ))
+    {
+        remove_dir_index( index );
+        return NULL;
+    }
+    list_remove( &index->lru );
+    list_add_head( &dir_index_lru, &index->lru );
+    return index;
+}
+
+/* add a newly built index to the cache; dir_index_mutex must be held */
+static BOOL add_dir_index( struct dir_index *new_index, const struct stat *st )
+{
+    dir_index_builds++;
+    if (get_dir_index( st ))
+    {
+        /* another thread was faster and owns the watch */
+        new_index->wd = -1;
+        return FALSE;
+    }
+    if (new_index->size > dir_index_budget) return FALSE;
+
+    while (dir_index_size + new_index->size > dir_index_budget && !list_empty( &dir_index_lru ))
+        remove_dir_index( LIST_ENTRY( list_tail( &dir_index_lru ), struct dir_index, lru ));
+    wine_rb_put( &dir_indexes, st, &new_index->entry );
+    list_add_head( &dir_index_lru, &new_index->lru );
+    dir_index_size += new_index->size;
+    dir_index_count++;
+    return TRUE;
+}
+
+static BOOL init_dir_indexes(void)
+{
+    const char *env;
+
+    if (!dir_index_budget) return FALSE;
+
+    mutex_lock( &dir_index_mutex );
+    if (dir_index_budget == ~(size_t)0)
+    {
+        /* WINEDIRINDEX=<size in MiB>, memory budget for directory indexes, 0 to disable them */
+        if ((env = getenv( "WINEDIRINDEX" ))) dir_index_budget = (size_t)max( 0, atoi( env )) << 20;
+        else dir_index_budget = (size_t)DIR_INDEX_DEFAULT_BUDGET << 20;
+#ifdef HAVE_SYS_INOTIFY_H
+        if (dir_index_budget) dir_index_inotify = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#endif
+    }
+    mutex_unlock( &dir_index_mutex );
+    return dir_index_budget != 0;
+}
+
+/***********************************************************************
+ *           find_file_in_dir_index
+ *
+ * Look for a file in the cached index of a directory, building it if needed.
+ * On success the unix name is stored into unix_name.
+ * Returns 1 if found, 0 if not found, -1 if the index couldn't be used.
+ */
+static int find_file_in_dir_index( const char *dir, const WCHAR *name, int length, char *unix_name )
+{
+    struct dir_index *index, *new_index;
+    struct stat st;
+    int ret;
+
+    if (!init_dir_indexes() || stat( dir, &st ) == -1) return -1;
+
+    mutex_lock( &dir_index_mutex );
+    if ((index = get_dir_index( &st )))
+    {
+        ret = lookup_dir_index( index, name, length, unix_name );
+        if (ret) dir_index_hits++;
+        else dir_index_misses++;
+        mutex_unlock( &dir_index_mutex );
+        return ret;
+    }
+    mutex_unlock( &dir_index_mutex );
+
+    if (!(new_index = build_dir_index( dir, &st ))) return -1;
+
+    mutex_lock( &dir_index_mutex );
+    ret = lookup_dir_index( new_index, name, length, unix_name );
+    if (!add_dir_index( new_index, &st )) free_dir_index( new_index );
+    if (ret) dir_index_hits++;
+    else dir_index_misses++;
+    dump_dir_index_stats();
+    mutex_unlock( &dir_index_mutex );
+    return ret;
+}
+
+
+/* background warm-up of directory trees, enabled with WINEDIRPREFETCH */
+
+struct prefetch_root
+{
+    const char *path;               /* unix path of the tree */
+    size_t      len;
+    LONG        started;            /* prefetch already queued */
+};
+
+#define DIR_PREFETCH_DEFAULT_THREADS 2
+#define DIR_PREFETCH_MAX_THREADS     8
+#define DIR_PREFETCH_FILE_SIZE       (256 * 1024)  /* amount of file data to read ahead */
+
+static pthread_once_t dir_prefetch_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t dir_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dir_prefetch_cond = PTHREAD_COND_INITIALIZER;
+static struct list dir_prefetch_queue = LIST_INIT( dir_prefetch_queue );  /* protected by dir_prefetch_mutex */
+static struct prefetch_root *dir_prefetch_roots;
+static unsigned int dir_prefetch_root_count;
+static unsigned int dir_prefetch_threads;
+static LONG dir_prefetch_started;
+
+static void dir_prefetch_init(void)
+{
+    const char *env;
+    char *roots, *p, *next;
+    unsigned int count = 1;
+    size_t len;
+
+    /* WINEDIRPREFETCH=<unix dir>[:<unix dir>...], warm up the trees on first access below them */
+    if (!(env = getenv( "WINEDIRPREFETCH" )) || !*env || !(roots = strdup( env ))) goto done;
+
+    for (p = roots; (p = strchr( p, ':' )); p++) count++;
+    if (!(dir_prefetch_roots = calloc( count, sizeof(*dir_prefetch_roots) ))) goto done;
+    for (p = roots; p; p = next)
+    {
+        if ((next = strchr( p, ':' ))) *next++ = 0;
+        if (p[0] != '/') continue;
+        len = strlen( p );
+        while (len > 1 && p[len - 1] == '/') p[--len] = 0;
+        dir_prefetch_roots[dir_prefetch_root_count].path = p;
+        dir_prefetch_roots[dir_prefetch_root_count].len = len;
+        dir_prefetch_root_count++;
+    }
+
+    /* WINEDIRPREFETCHTHREADS=<count>, number of threads used for the warm-up */
+    if ((env = getenv( "WINEDIRPREFETCHTHREADS" ))) dir_prefetch_threads = atoi( env );
+    else dir_prefetch_threads = DIR_PREFETCH_DEFAULT_THREADS;
+    dir_prefetch_threads = max( 1, min( DIR_PREFETCH_MAX_THREADS, dir_prefetch_threads ));
+
+done:
+    dir_prefetch_pending = dir_prefetch_root_count;
+}
+
+/* build the index of a directory ahead of time, without evicting indexes already in use */
+static void warm_dir_index( const char *dir, const struct stat *st )
+{
+    struct dir_index *index;
+    BOOL cached;
+
+    if (!init_dir_indexes()) return;
+
+    mutex_lock( &dir_index_mutex );
+    cached = get_dir_index( st ) != NULL;
+    mutex_unlock( &dir_index_mutex );
+    if (cached || !(index = build_dir_index( dir, st ))) return;
+
+    mutex_lock( &dir_index_mutex );
+    if (dir_index_size + index->size > dir_index_budget || !add_dir_index( index, st ))
+        free_dir_index( index );
+    mutex_unlock( &dir_index_mutex );
+}
+
+/* warm up a directory and queue its subdirectories; name must have room for PATH_MAX chars */
+static void prefetch_dir( char *name )
+{
+    struct dirent *de;
+    struct stat st;
+    size_t pos;
+    DIR *dir;
+    int fd;
+
+    if (stat( name, &st ) == -1 || !S_ISDIR( st.st_mode )) return;
+    warm_dir_index( name, &st );
+
+    if (!(dir = opendir( name ))) return;
+    pos = strlen( name );
+    if (name[pos - 1] != '/') name[pos++] = '/';
+    while ((de = readdir( dir )))
+    {
+        if (!strcmp( de->d_name, "." ) || !strcmp( de->d_name, ".." )) continue;
+        if (pos + strlen( de->d_name ) >= PATH_MAX) continue;
+        strcpy( name + pos, de->d_name );
+        if (lstat( name, &st ) == -1) continue;
+        if (S_ISDIR( st.st_mode ))
+        {
+            mutex_lock( &dir_prefetch_mutex );
+            if (!add_dir_to_queue( &dir_prefetch_queue, name )) pthread_cond_signal( &dir_prefetch_cond );
+            mutex_unlock( &dir_prefetch_mutex );
+        }
+        else if (S_ISREG( st.st_mode ) && st.st_size &&
+                 (fd = open( name, O_RDONLY | O_NONBLOCK | O_CLOEXEC )) != -1)
+        {
+#ifdef HAVE_POSIX_FADVISE
+            posix_fadvise( fd, 0, DIR_PREFETCH_FILE_SIZE, POSIX_FADV_WILLNEED );
+#elif defined(__linux__)
+            readahead( fd, 0, DIR_PREFETCH_FILE_SIZE );
+#endif
+            close( fd );
+        }
+    }
+    closedir( dir );
+}
+
+/* the workers only make plain unix calls, they don't have a TEB and mustn't use debug output */
+static void *dir_prefetch_thread( void *arg )
+{
+    char name[PATH_MAX];
+
+    for (;;)
+    {
+        pthread_mutex_lock( &dir_prefetch_mutex );
+        while (next_dir_in_queue( &dir_prefetch_queue, name ))
+            pthread_cond_wait( &dir_prefetch_cond, &dir_prefetch_mutex );
+        pthread_mutex_unlock( &dir_prefetch_mutex );
+        prefetch_dir( name );
+    }
+    return NULL;
+}
+
+static void start_dir_prefetch_threads(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    unsigned int i;
+
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    for (i = 0; i < dir_prefetch_threads; i++)
+        if (pthread_create( &thread, &attr, dir_prefetch_thread, NULL )) break;
+    pthread_attr_destroy( &attr );
+    if (!i) ERR( "failed to create prefetch threads\n" );
+}
+
+
+/***********************************************************************
+ *           start_dir_prefetch
+ *
+ * Queue the warm-up of the configured tree containing unix_name, the first time it's accessed.
+ */
+static void start_dir_prefetch( const char *unix_name )
+{
+    struct prefetch_root *root;
+    unsigned int i;
+
+    pthread_once( &dir_prefetch_once, dir_prefetch_init );
+
+    for (i = 0; i < dir_prefetch_root_count; i++)
+    {
+        root = &dir_prefetch_roots[i];
+        if (root->started || strncmp( unix_name, root->path, root->len )) continue;
+        if (root->len > 1 && unix_name[root->len] && unix_name[root->len] != '/') continue;
+        if (root->len >= PATH_MAX || InterlockedExchange( &root->started, 1 )) continue;
+        InterlockedDecrement( &dir_prefetch_pending );
+
+        TRACE_( dirindex )( "prefetching %s with %u threads\n", debugstr_a(root->path), dir_prefetch_threads );
+        mutex_lock( &dir_prefetch_mutex );
+        if (!add_dir_to_queue( &dir_prefetch_queue, root->path )) pthread_cond_signal( &dir_prefetch_cond );
+        mutex_unlock( &dir_prefetch_mutex );
+        if (!InterlockedExchange( &dir_prefetch_started, 1 )) start_dir_prefetch_threads();
+    }
+}
+
+
 /***********************************************************************
  *           find_file_in_dir
  *
@@ -2815,6 +3400,18 @@ static NTSTATUS find_file_in_dir( char *unix_name, int pos, const WCHAR *name, i
 
     if (!is_name_8_dot_3 && !get_dir_case_sensitivity( unix_name )) goto not_found;
 
+    /* look it up in the directory index; short names are not indexed and need a full scan */
+
+    switch (find_file_in_dir_index( unix_name, name, length, unix_name + pos ))
+    {
+    case 1:
+        unix_name[pos - 1] = '/';
+        return STATUS_SUCCESS;
+    case 0:
+        if (!is_name_8_dot_3) goto not_found;
+        break;
+    }
+
     /* now look for it through the directory */
 
 #ifdef VFAT_IOCTL_READDIR_BOTH
@@ -3298,7 +3895,7 @@ static NTSTATUS find_file_id( char **unix_name, ULONG *len, ULONGLONG file_id, d
     struct stat st;
     char *name = *unix_name;
 
-    while (!(status = next_dir_in_queue( name )))
+    while (!(status = next_dir_in_queue( &dir_queue, name )))
     {
         if (!(dir = opendir( name ))) continue;
         TRACE( "searching %s for %s\n", debugstr_a(name), wine_dbgstr_longlong(file_id) );
@@ -3326,7 +3923,7 @@ static NTSTATUS find_file_id( char **unix_name, ULONG *len, ULONGLONG file_id, d
                 return STATUS_SUCCESS;
             }
             if (!S_ISDIR( st.st_mode )) continue;
-            if ((status = add_dir_to_queue( name )) != STATUS_SUCCESS)
+            if ((status = add_dir_to_queue( &dir_queue, name )) != STATUS_SUCCESS)
             {
                 closedir( dir );
                 return status;
@@ -3390,12 +3987,12 @@ static NTSTATUS file_id_to_unix_file_name( const OBJECT_ATTRIBUTES *attr, char *
         }
         else
         {
-            status = add_dir_to_queue( "." );
+            status = add_dir_to_queue( &dir_queue, "." );
             if (!status)
                 status = find_file_id( &unix_name, &len, file_id, root_st.st_dev );
             if (!status)  /* get rid of "./" prefix */
                 memmove( unix_name, unix_name + 2, strlen(unix_name) - 1 );
-            flush_dir_queue();
+            flush_dir_queue( &dir_queue );
         }
         if (fchdir( old_cwd ) == -1) chdir( "/" );
     }
@@ -3433,15 +4030,129 @@ done:
  *
  * Helper for nt_to_unix_file_name
  */
+/* cache of resolved parent directories, for paths whose case doesn't match the files on disk */
+
+#define UNIX_NAME_CACHE_SIZE 1024  /* must be a power of 2 */
+
+struct unix_name_cache_entry
+{
+    unsigned int hash;      /* hash of the key */
+    unsigned int gen;       /* cache generation when the entry was added */
+    char        *base;      /* unix directory the NT path is relative to */
+    WCHAR       *dir;       /* upper-case NT directory path */
+    int          dir_len;
+    char        *unix_dir;  /* resolved unix directory */
+    dev_t        dev;       /* device and inode of the resolved directory */
+    ino_t        ino;
+};
+
+static pthread_mutex_t unix_name_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct unix_name_cache_entry unix_name_cache[UNIX_NAME_CACHE_SIZE];
+static LONG unix_name_cache_gen;
+
+/* invalidate all the cached directories; called on changes made to the namespace */
+static inline void invalidate_unix_name_cache(void)
+{
+    InterlockedIncrement( &unix_name_cache_gen );
+}
+
+static unsigned int hash_unix_name_cache_key( const char *base, int base_len, const WCHAR *dir, int dir_len )
+{
+    unsigned int hash = 0;
+    int i;
+
+    for (i = 0; i < base_len; i++) hash = hash * 31 + (unsigned char)base[i];
+    for (i = 0; i < dir_len; i++) hash = hash * 31 + ntdll_towupper( dir[i] );
+    return hash;
+}
+
+/* look for the unix directory of NT directory path dir relative to the unix base directory */
+static char *get_cached_unix_dir( const char *base, int base_len, const WCHAR *dir, int dir_len )
+{
+    unsigned int hash = hash_unix_name_cache_key( base, base_len, dir, dir_len );
+    struct unix_name_cache_entry *entry = &unix_name_cache[hash & (UNIX_NAME_CACHE_SIZE - 1)];
+    char *ret = NULL;
+    struct stat st;
+    dev_t dev = 0;
+    ino_t ino = 0;
+    int i;
+
+    mutex_lock( &unix_name_cache_mutex );
+    if (entry->unix_dir && entry->hash == hash && entry->dir_len == dir_len &&
+        entry->gen == (unsigned int)ReadNoFence( &unix_name_cache_gen ) &&
+        !strncmp( entry->base, base, base_len ) && !entry->base[base_len])
+    {
+        for (i = 0; i < dir_len; i++) if (entry->dir[i] != ntdll_towupper( dir[i] )) break;
+        if (i == dir_len && (ret = strdup( entry->unix_dir )))
+        {
+            dev = entry->dev;
+            ino = entry->ino;
+        }
+    }
+    mutex_unlock( &unix_name_cache_mutex );
+
+    /* make sure the directory is still the one we resolved */
+    if (ret && (stat( ret, &st ) == -1 || !S_ISDIR( st.st_mode ) || st.st_dev != dev || st.st_ino != ino))
+    {
+        TRACE( "stale entry %s\n", debugstr_a(ret) );
+        free( ret );
+        ret = NULL;
+    }
+    return ret;
+}
+
+static void add_cached_unix_dir( const char *base, int base_len, const WCHAR *dir, int dir_len,
+                                 const char *unix_dir, unsigned int gen )
+{
+    unsigned int hash = hash_unix_name_cache_key( base, base_len, dir, dir_len );
+    struct unix_name_cache_entry *entry = &unix_name_cache[hash & (UNIX_NAME_CACHE_SIZE - 1)];
+    char *new_base, *new_unix_dir;
+    WCHAR *new_dir;
+    struct stat st;
+    int i;
+
+    if (stat( unix_dir, &st ) == -1 || !S_ISDIR( st.st_mode )) return;
+
+    new_base = malloc( base_len + 1 );
+    new_dir = malloc( dir_len * sizeof(WCHAR) );
+    new_unix_dir = strdup( unix_dir );
+    if (!new_base || !new_dir || !new_unix_dir)
+    {
+        free( new_base );
+        free( new_dir );
+        free( new_unix_dir );
+        return;
+    }
+    memcpy( new_base, base, base_len );
+    new_base[base_len] = 0;
+    for (i = 0; i < dir_len; i++) new_dir[i] = ntdll_towupper( dir[i] );
+
+    mutex_lock( &unix_name_cache_mutex );
+    /* replace whatever was in the slot */
+    free( entry->base );
+    free( entry->dir );
+    free( entry->unix_dir );
+    entry->hash     = hash;
+    entry->gen      = gen;
+    entry->base     = new_base;
+    entry->dir      = new_dir;
+    entry->dir_len  = dir_len;
+    entry->unix_dir = new_unix_dir;
+    entry->dev      = st.st_dev;
+    entry->ino      = st.st_ino;
+    mutex_unlock( &unix_name_cache_mutex );
+}
+
 static NTSTATUS lookup_unix_name( const WCHAR *name, int name_len, char **buffer, int unix_len, int pos,
                                   UINT disposition, BOOL is_unix )
 {
     static const WCHAR invalid_charsW[] = { INVALID_NT_CHARS, '/', 0 };
     NTSTATUS status;
-    int ret;
+    int ret, dir_len = 0, base_pos = 0;
+    unsigned int cache_gen = 0;
     struct stat st;
-    char *unix_name = *buffer;
-    const WCHAR *ptr, *end;
+    char *unix_name = *buffer, *cached;
+    const WCHAR *ptr, *end, *dir = NULL;
 
     /* check syntax of individual components */
 
@@ -3488,6 +4199,42 @@ static NTSTATUS lookup_unix_name( const WCHAR *name, int name_len, char **buffer
     if (is_unix && (disposition == FILE_OPEN || disposition == FILE_OVERWRITE))
         return STATUS_OBJECT_NAME_NOT_FOUND;
 
+    /* resolve the parent directory from the cache if possible, only relative names aren't cached */
+
+    if (!is_unix && unix_name[0] == '/')
+    {
+        for (dir_len = name_len - 1; dir_len > 0; dir_len--) if (name[dir_len] == '\\') break;
+        if (dir_len > 0 && dir_len < name_len - 1)
+        {
+            cache_gen = ReadNoFence( &unix_name_cache_gen );
+            base_pos = pos;
+            dir = name;
+            if ((cached = get_cached_unix_dir( unix_name, pos, name, dir_len )))
+            {
+                int len = strlen( cached );
+
+                if (unix_len < len + MAX_DIR_ENTRY_LEN + 3)
+                {
+                    char *new_name;
+                    unix_len = len + 2 * MAX_DIR_ENTRY_LEN;
+                    if (!(new_name = realloc( unix_name, unix_len )))
+                    {
+                        free( cached );
+                        return STATUS_NO_MEMORY;
+                    }
+                    unix_name = *buffer = new_name;
+                }
+                strcpy( unix_name, cached );
+                free( cached );
+                pos = len;
+                name += dir_len + 1;
+                name_len -= dir_len + 1;
+                dir = NULL;  /* nothing to add */
+            }
+        }
+        else dir_len = 0;
+    }
+
     /* now do it component by component */
 
     while (name_len)
@@ -3500,6 +4247,13 @@ static NTSTATUS lookup_unix_name( const WCHAR *name, int name_len, char **buffer
         if (next < name + name_len) next++;
         name_len -= next - name;
 
+        /* the parent directory of the last element is resolved by now */
+        if (!name_len && dir)
+        {
+            unix_name[pos] = 0;
+            add_cached_unix_dir( unix_name, base_pos, dir, dir_len, unix_name, cache_gen );
+        }
+
         /* grow the buffer if needed */
 
         if (unix_len - pos < MAX_DIR_ENTRY_LEN + 3)
@@ -4233,6 +4987,7 @@ NTSTATUS WINAPI NtCreateFile( HANDLE *handle, ACCESS_MASK access, OBJECT_ATTRIBU
 
     if (status == STATUS_SUCCESS)
     {
+        if (dir_prefetch_pending) start_dir_prefetch( unix_name );
         name_hidden = is_hidden_file( unix_name );
         status = open_unix_file( handle, unix_name, access, &new_attr, attributes,
                                  sharing, disposition, options, ea_buffer, ea_length );
@@ -4401,7 +5156,10 @@ NTSTATUS WINAPI NtDeleteFile( OBJECT_ATTRIBUTES *attr )
         if (!(status = open_unix_file( &handle, unix_name, GENERIC_READ | GENERIC_WRITE | DELETE, &new_attr,
                                        0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, FILE_OPEN,
                                        FILE_DELETE_ON_CLOSE, NULL, 0 )))
+        {
             NtClose( handle );
+            invalidate_unix_name_cache();
+        }
         free( unix_name );
     }
     free( nt_name.Buffer );
@@ -4500,7 +5258,7 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         sizeof(FILE_STANDARD_INFORMATION),             /* FileStandardInformation */
         sizeof(FILE_INTERNAL_INFORMATION),             /* FileInternalInformation */
         sizeof(FILE_EA_INFORMATION),                   /* FileEaInformation */
-        0,                                             /* FileAccessInformation */
+        sizeof(FILE_ACCESS_INFORMATION),               /* FileAccessInformation */
         sizeof(FILE_NAME_INFORMATION),                 /* FileNameInformation */
         sizeof(FILE_RENAME_INFORMATION)-sizeof(WCHAR), /* FileRenameInformation */
         0,                                             /* FileLinkInformation */
@@ -4508,7 +5266,7 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         sizeof(FILE_DISPOSITION_INFORMATION),          /* FileDispositionInformation */
         sizeof(FILE_POSITION_INFORMATION),             /* FilePositionInformation */
         sizeof(FILE_FULL_EA_INFORMATION),              /* FileFullEaInformation */
-        0,                                             /* FileModeInformation */
+        sizeof(FILE_MODE_INFORMATION),                 /* FileModeInformation */
         sizeof(FILE_ALIGNMENT_INFORMATION),            /* FileAlignmentInformation */
         sizeof(FILE_ALL_INFORMATION),                  /* FileAllInformation */
         sizeof(FILE_ALLOCATION_INFORMATION),           /* FileAllocationInformation */
@@ -4574,7 +5332,8 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
     struct stat st;
     int fd, needs_close = FALSE;
     ULONG attr;
-    unsigned int options;
+    enum server_fd_type type;
+    unsigned int options, access;
     unsigned int status;
 
     TRACE( "(%p,%p,%p,0x%08x,0x%08x)\n", handle, io, ptr, (int)len, class);
@@ -4588,14 +5347,38 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
     if (len < info_sizes[class])
         return io->Status = STATUS_INFO_LENGTH_MISMATCH;
 
-    if ((status = server_get_unix_fd( handle, 0, &fd, &needs_close, NULL, &options )))
+    if ((status = server_get_unix_fd( handle, 0, &fd, &needs_close, &type, &options )))
     {
         if (status != STATUS_BAD_DEVICE_TYPE) return io->Status = status;
         return server_get_file_info( handle, io, ptr, len, class );
     }
 
+    /* only files and directories use the generic server implementation */
+    if (class == FileAccessInformation || class == FileModeInformation)
+    {
+        if ((type != FD_TYPE_FILE && type != FD_TYPE_DIR) ||
+            !server_get_cached_fd_info( handle, &access, NULL ))
+        {
+            if (needs_close) close( fd );
+            return server_get_file_info( handle, io, ptr, len, class );
+        }
+    }
+
     switch (class)
     {
+    case FileAccessInformation:
+        {
+            FILE_ACCESS_INFORMATION *info = ptr;
+            info->AccessFlags = access;
+        }
+        break;
+    case FileModeInformation:
+        {
+            FILE_MODE_INFORMATION *info = ptr;
+            info->Mode = options & (FILE_WRITE_THROUGH | FILE_SEQUENTIAL_ONLY | FILE_NO_INTERMEDIATE_BUFFERING |
+                                    FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT);
+        }
+        break;
     case FileBasicInformation:
         if (fd_get_file_info( fd, options, &st, &attr ) == -1)
             status = errno_to_status( errno );
@@ -4653,9 +5436,13 @@ NTSTATUS WINAPI NtQueryInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
                 fill_file_info( &st, attr, info, FileAllInformation );
                 info->StandardInformation.DeletePending = FALSE; /* FIXME */
                 info->EaInformation.EaSize = 0;
-                info->AccessInformation.AccessFlags = 0;  /* FIXME */
+                if (!server_get_cached_fd_info( handle, &access, NULL )) access = 0;  /* FIXME */
+                info->AccessInformation.AccessFlags = access;
                 info->PositionInformation.CurrentByteOffset.QuadPart = lseek( fd, 0, SEEK_CUR );
-                info->ModeInformation.Mode = 0;  /* FIXME */
+                info->ModeInformation.Mode = options & (FILE_WRITE_THROUGH | FILE_SEQUENTIAL_ONLY |
+                                                        FILE_NO_INTERMEDIATE_BUFFERING |
+                                                        FILE_SYNCHRONOUS_IO_ALERT |
+                                                        FILE_SYNCHRONOUS_IO_NONALERT);
                 info->AlignmentInformation.AlignmentRequirement = 1;  /* FIXME */
 
                 status = fill_name_info( unix_name, &info->NameInformation, &name_len );
@@ -4911,6 +5698,7 @@ NTSTATUS WINAPI NtSetInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
         {
             FILE_COMPLETION_INFORMATION *info = ptr;
 
+            sock_release_direct_recv( handle );
             SERVER_START_REQ( set_completion_info )
             {
                 req->handle   = wine_server_obj_handle( handle );
@@ -5000,6 +5788,7 @@ NTSTATUS WINAPI NtSetInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
                 status = wine_server_call( req );
             }
             SERVER_END_REQ;
+            if (!status) invalidate_unix_name_cache();
         }
         else status = STATUS_INVALID_PARAMETER_3;
         break;
@@ -5019,6 +5808,7 @@ NTSTATUS WINAPI NtSetInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
                 status = wine_server_call( req );
             }
             SERVER_END_REQ;
+            if (!status) invalidate_unix_name_cache();
         }
         else status = STATUS_INVALID_PARAMETER_3;
         break;
@@ -5062,6 +5852,7 @@ NTSTATUS WINAPI NtSetInformationFile( HANDLE handle, IO_STATUS_BLOCK *io,
                     status = wine_server_call( req );
                 }
                 SERVER_END_REQ;
+                if (!status) invalidate_unix_name_cache();
 
                 free( unix_name );
             }
@@ -5192,6 +5983,7 @@ struct async_fileio *alloc_fileio( DWORD size, async_callback_t callback, HANDLE
     {
         io->callback = callback;
         io->handle   = handle;
+        io->start    = get_io_time();
     }
     return io;
 }
@@ -5261,6 +6053,7 @@ static BOOL async_read_proc( void *user, ULONG_PTR *info, unsigned int *status )
     }
 
     *info = fileio->already;
+    if (!*status) server_record_io( fileio->io.handle, IO_STAT_READ, fileio->already, fileio->io.start, TRUE );
     release_fileio( &fileio->io );
     return TRUE;
 }
@@ -5306,6 +6099,7 @@ static BOOL async_write_proc( void *user, ULONG_PTR *info, unsigned int *status
     }
 
     *info = fileio->already;
+    if (!*status) server_record_io( fileio->io.handle, IO_STAT_WRITE, fileio->already, fileio->io.start, TRUE );
     release_fileio( &fileio->io );
     return TRUE;
 }
@@ -5858,12 +6652,312 @@ static NTSTATUS cancel_async_file_read( HANDLE handle, IO_STATUS_BLOCK *io )
     return count ? STATUS_SUCCESS : STATUS_NOT_FOUND;
 }
 
-/******************************************************************************
- *              NtReadFile   (NTDLL.@)
+#ifdef USE_FILE_URING
+
+/* Overlapped reads and writes on regular files can be handed to an io_uring
+ * instance, so that they really run asynchronously and many of them can be in
+ * flight at once. A dedicated thread reaps the completions and reports them
+ * the same way the synchronous path does.
  */
-NTSTATUS WINAPI NtReadFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
-                            IO_STATUS_BLOCK *io, void *buffer, ULONG length,
-                            LARGE_INTEGER *offset, ULONG *key )
+
+struct file_uring_job
+{
+    struct list  entry;        /* entry in file_uring_jobs list */
+    HANDLE       handle;       /* file handle, for cancellation and completion ports */
+    HANDLE       event;        /* event to signal */
+    client_ptr_t iosb;         /* I/O status block */
+    ULONG_PTR    cvalue;       /* completion value */
+    void        *buffer;       /* user buffer */
+    ULONG        length;       /* buffer length */
+    ULONG64      offset;       /* file offset */
+    int          unix_fd;      /* private duplicate of the file descriptor */
+    BOOL         write;        /* write request */
+    BOOL         cancelled;    /* a cancel request was queued for it */
+    DWORD        thread_id;    /* id of the thread that issued it */
+    ULONGLONG    start;        /* submission time */
+};
+
+static pthread_mutex_t file_uring_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t file_uring_once = PTHREAD_ONCE_INIT;
+static struct list file_uring_jobs = LIST_INIT( file_uring_jobs );
+static unsigned int file_uring_depth;    /* maximum number of requests in flight */
+static unsigned int file_uring_inflight; /* current number of requests in flight */
+static int file_uring_fd = -1;
+
+static struct
+{
+    unsigned int        *head;
+    unsigned int        *tail;
+    unsigned int         mask;
+    struct io_uring_sqe *sqes;
+} file_uring_sq;
+
+static struct
+{
+    unsigned int        *head;
+    unsigned int        *tail;
+    unsigned int         mask;
+    struct io_uring_cqe *cqes;
+} file_uring_cq;
+
+/* report the result of a request; file_uring_mutex must not be held */
+static void complete_file_uring_job( struct file_uring_job *job, int res )
+{
+    unsigned int status;
+    ULONG total = 0;
+
+    if (res == -EFAULT && !job->write)
+    {
+        /* the buffer may be protected by write watches, retry through the usual path */
+        while ((res = virtual_locked_pread( job->unix_fd, job->buffer, job->length, job->offset )) == -1 &&
+               errno == EINTR) ;
+        if (res == -1) res = -errno;
+    }
+
+    if (res >= 0)
+    {
+        total = res;
+        status = (total || job->write) ? STATUS_SUCCESS : STATUS_END_OF_FILE;
+    }
+    else if (res == -ECANCELED) status = STATUS_CANCELLED;
+    else if (res == -EFAULT) status = STATUS_INVALID_USER_BUFFER;
+    else status = errno_to_status( -res );
+
+    TRACE( "job %p handle %p %s %#x bytes at %s = %#x (%#x)\n", job, job->handle, job->write ? "write" : "read",
+           (int)job->length, wine_dbgstr_longlong( job->offset ), status, (int)total );
+
+    if (status == STATUS_SUCCESS || status == STATUS_END_OF_FILE)
+        server_record_io( job->handle, job->write ? IO_STAT_WRITE : IO_STAT_READ, total, job->start, TRUE );
+    close( job->unix_fd );
+    set_async_iosb( job->iosb, status, total );
+    if (job->event) NtSetEvent( job->event, NULL );
+    if (job->cvalue) add_completion( job->handle, job->cvalue, status, total, TRUE );
+
+    mutex_lock( &file_uring_mutex );
+    list_remove( &job->entry );
+    file_uring_inflight--;
+    mutex_unlock( &file_uring_mutex );
+    free( job );
+}
+
+static void CALLBACK file_uring_thread( void *arg )
+{
+    struct io_uring_cqe *cqe;
+    unsigned int head;
+    ULONG64 user_data;
+    int res;
+
+    for (;;)
+    {
+        head = *file_uring_cq.head;
+        if (head == __atomic_load_n( file_uring_cq.tail, __ATOMIC_ACQUIRE ))
+        {
+            if (syscall( __NR_io_uring_enter, file_uring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0 ) == -1 &&
+                errno != EINTR)
+                WARN( "io_uring_enter failed: %s\n", strerror( errno ));
+            continue;
+        }
+        cqe = &file_uring_cq.cqes[head & file_uring_cq.mask];
+        user_data = cqe->user_data;
+        res = cqe->res;
+        __atomic_store_n( file_uring_cq.head, head + 1, __ATOMIC_RELEASE );
+
+        /* cancel requests have no job */
+        if (user_data) complete_file_uring_job( (struct file_uring_job *)(ULONG_PTR)user_data, res );
+    }
+}
+
+static void file_uring_init(void)
+{
+    struct io_uring_params params;
+    size_t sq_size, cq_size;
+    unsigned int *array, i;
+    const char *env;
+    HANDLE thread;
+    char *ring;
+    void *sqes;
+    int fd, depth;
+
+    /* WINEFILEURING=<queue depth>, submit overlapped regular file I/O through io_uring */
+    if (!(env = getenv( "WINEFILEURING" )) || (depth = atoi( env )) <= 0) return;
+    /* the reaper thread runs unix code directly, which is only possible without a wow64 layer */
+    if (is_wow64() || is_arm64ec()) return;
+
+    file_uring_depth = min( depth, 4096 );
+    memset( &params, 0, sizeof(params) );
+    if ((fd = syscall( __NR_io_uring_setup, file_uring_depth * 2, &params )) == -1)
+    {
+        WARN( "io_uring_setup failed: %s\n", strerror( errno ));
+        return;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) goto failed;
+
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring = mmap( NULL, max( sq_size, cq_size ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQ_RING );
+    if (ring == MAP_FAILED) goto failed;
+    sqes = mmap( NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, IORING_OFF_SQES );
+    if (sqes == MAP_FAILED) goto failed;
+
+    file_uring_sq.head = (unsigned int *)(ring + params.sq_off.head);
+    file_uring_sq.tail = (unsigned int *)(ring + params.sq_off.tail);
+    file_uring_sq.mask = *(unsigned int *)(ring + params.sq_off.ring_mask);
+    file_uring_sq.sqes = sqes;
+    file_uring_cq.head = (unsigned int *)(ring + params.cq_off.head);
+    file_uring_cq.tail = (unsigned int *)(ring + params.cq_off.tail);
+    file_uring_cq.mask = *(unsigned int *)(ring + params.cq_off.ring_mask);
+    file_uring_cq.cqes = (struct io_uring_cqe *)(ring + params.cq_off.cqes);
+
+    /* submission entries are always used in ring order */
+    array = (unsigned int *)(ring + params.sq_off.array);
+    for (i = 0; i < params.sq_entries; i++) array[i] = i;
+    /* each request can come with a cancel request */
+    file_uring_depth = min( file_uring_depth, params.sq_entries / 2 );
+    file_uring_fd = fd;
+
+    if (NtCreateThreadEx( &thread, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), file_uring_thread, NULL,
+                          THREAD_CREATE_FLAGS_SKIP_THREAD_ATTACH | THREAD_CREATE_FLAGS_HIDE_FROM_DEBUGGER,
+                          0, 0, 0, NULL ))
+    {
+        ERR( "failed to create io_uring thread\n" );
+        file_uring_fd = -1;
+        goto failed;
+    }
+    NtClose( thread );
+    TRACE( "using io_uring for overlapped file I/O, queue depth %u\n", file_uring_depth );
+    return;
+
+failed:
+    close( fd );
+}
+
+/* queue a request to the ring and hand it to the kernel; file_uring_mutex must be held */
+static BOOL file_uring_submit( BYTE opcode, int fd, void *addr, ULONG length, ULONG64 offset, ULONG64 user_data )
+{
+    unsigned int tail = *file_uring_sq.tail;
+    struct io_uring_sqe *sqe = &file_uring_sq.sqes[tail & file_uring_sq.mask];
+    int ret;
+
+    memset( sqe, 0, sizeof(*sqe) );
+    sqe->opcode    = opcode;
+    sqe->fd        = fd;
+    sqe->addr      = (ULONG_PTR)addr;
+    sqe->len       = length;
+    sqe->off       = offset;
+    sqe->user_data = user_data;
+    __atomic_store_n( file_uring_sq.tail, tail + 1, __ATOMIC_RELEASE );
+
+    while ((ret = syscall( __NR_io_uring_enter, file_uring_fd, 1, 0, 0, NULL, 0 )) == -1 && errno == EINTR) ;
+    if (ret == 1) return TRUE;
+    /* the entry wasn't consumed, take it back */
+    __atomic_store_n( file_uring_sq.tail, tail, __ATOMIC_RELEASE );
+    return FALSE;
+}
+
+/***********************************************************************
+ *           queue_file_uring_io
+ *
+ * Try to submit an overlapped read or write through io_uring.
+ * Returns STATUS_PENDING on success, STATUS_NOT_SUPPORTED if the caller should do the I/O itself.
+ */
+static NTSTATUS queue_file_uring_io( HANDLE handle, int unix_handle, HANDLE event, IO_STATUS_BLOCK *io,
+                                     ULONG_PTR cvalue, void *buffer, ULONG length, ULONG64 offset, BOOL write )
+{
+    struct file_uring_job *job;
+    NTSTATUS status = STATUS_NOT_SUPPORTED;
+
+    pthread_once( &file_uring_once, file_uring_init );
+    if (file_uring_fd == -1) return STATUS_NOT_SUPPORTED;
+
+    if (!(job = malloc( sizeof(*job) ))) return STATUS_NOT_SUPPORTED;
+    if ((job->unix_fd = dup( unix_handle )) == -1)
+    {
+        free( job );
+        return STATUS_NOT_SUPPORTED;
+    }
+    job->handle    = handle;
+    job->event     = event;
+    job->iosb      = iosb_client_ptr( io );
+    job->cvalue    = cvalue;
+    job->buffer    = buffer;
+    job->length    = length;
+    job->offset    = offset;
+    job->write     = write;
+    job->cancelled = FALSE;
+    job->thread_id = GetCurrentThreadId();
+    job->start     = get_io_time();
+
+    io->Status = STATUS_PENDING;
+    io->Information = 0;
+    NtResetEvent( event, NULL );
+
+    mutex_lock( &file_uring_mutex );
+    if (file_uring_inflight < file_uring_depth)
+    {
+        list_add_tail( &file_uring_jobs, &job->entry );
+        file_uring_inflight++;
+        if (file_uring_submit( write ? IORING_OP_WRITE : IORING_OP_READ, job->unix_fd, buffer, length,
+                               offset, (ULONG_PTR)job ))
+            status = STATUS_PENDING;
+        else
+        {
+            list_remove( &job->entry );
+            file_uring_inflight--;
+        }
+    }
+    mutex_unlock( &file_uring_mutex );
+
+    if (status != STATUS_PENDING)
+    {
+        close( job->unix_fd );
+        free( job );
+    }
+    return status;
+}
+
+/* cancel the io_uring requests of a file, either a specific one or those of the current thread */
+static NTSTATUS cancel_file_uring_io( HANDLE handle, IO_STATUS_BLOCK *io )
+{
+    DWORD thread_id = GetCurrentThreadId();
+    client_ptr_t iosb = io ? iosb_client_ptr( io ) : 0;
+    struct file_uring_job *job;
+    unsigned int count = 0;
+
+    if (file_uring_fd == -1) return STATUS_NOT_FOUND;
+
+    mutex_lock( &file_uring_mutex );
+    LIST_FOR_EACH_ENTRY( job, &file_uring_jobs, struct file_uring_job, entry )
+    {
+        if (job->handle != handle) continue;
+        if (io ? job->iosb != iosb : job->thread_id != thread_id) continue;
+        count++;
+        if (job->cancelled) continue;
+        /* the completion of the request reports STATUS_CANCELLED if it was still pending */
+        job->cancelled = file_uring_submit( IORING_OP_ASYNC_CANCEL, -1, job, 0, 0, 0 );
+    }
+    mutex_unlock( &file_uring_mutex );
+    return count ? STATUS_SUCCESS : STATUS_NOT_FOUND;
+}
+
+#else  /* USE_FILE_URING */
+
+static NTSTATUS queue_file_uring_io( HANDLE handle, int unix_handle, HANDLE event, IO_STATUS_BLOCK *io,
+                                     ULONG_PTR cvalue, void *buffer, ULONG length, ULONG64 offset, BOOL write )
+{
+    return STATUS_NOT_SUPPORTED;
+}
+
+static NTSTATUS cancel_file_uring_io( HANDLE handle, IO_STATUS_BLOCK *io )
+{
+    return STATUS_NOT_FOUND;
+}
+
+#endif  /* USE_FILE_URING */
+
+static NTSTATUS read_file( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                           IO_STATUS_BLOCK *io, void *buffer, ULONG length,
+                           LARGE_INTEGER *offset, ULONG *key )
 {
     int result, unix_handle, needs_close;
     unsigned int options;
@@ -5874,6 +6968,7 @@ NTSTATUS WINAPI NtReadFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, vo
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
     BOOL send_completion = FALSE, async_read, timeout_init_done = FALSE;
+    ULONGLONG start = get_io_time();
 
     TRACE( "(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p)\n",
            handle, event, apc, apc_user, io, buffer, (int)length, offset, key );
@@ -5905,6 +7000,15 @@ NTSTATUS WINAPI NtReadFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, vo
             goto err;
         }
 
+        /* the completion must be visible to waits on the event, waits on the file handle would need the server */
+        if (async_read && length && event && !apc &&
+            (status = queue_file_uring_io( handle, unix_handle, event, io, cvalue, buffer, length,
+                                           offset->QuadPart, FALSE )) == STATUS_PENDING)
+        {
+            if (needs_close) close( unix_handle );
+            return status;
+        }
+
         if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
         {
             /* async I/O doesn't make sense on regular files */
@@ -6050,6 +7154,7 @@ err:
         io->Status = status;
         io->Information = total;
         TRACE("= SUCCESS (%u)\n", total);
+        server_record_io( handle, IO_STAT_READ, total, start, FALSE );
         if (event) NtSetEvent( event, NULL );
         if (apc && (!status || async_read)) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc,
                                                               (ULONG_PTR)apc_user, iosb_ptr, 0 );
@@ -6068,6 +7173,22 @@ err:
 }
 
 
+/******************************************************************************
+ *              NtReadFile   (NTDLL.@)
+ */
+NTSTATUS WINAPI NtReadFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                            IO_STATUS_BLOCK *io, void *buffer, ULONG length,
+                            LARGE_INTEGER *offset, ULONG *key )
+{
+    NTSTATUS status;
+
+    WINE_PROBE2( wine, read_file_start, handle, length );
+    status = read_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+    WINE_PROBE2( wine, read_file_end, handle, status );
+    return status;
+}
+
+
 /******************************************************************************
  *              NtReadFileScatter   (NTDLL.@)
  */
@@ -6082,6 +7203,7 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
     BOOL send_completion = FALSE;
+    ULONGLONG start = get_io_time();
 
     TRACE( "(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p),partial stub!\n",
            file, event, apc, apc_user, io, segments, (int)length, offset, key );
@@ -6131,6 +7253,7 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
     io->Status = status;
     io->Information = total;
     TRACE("= 0x%08x (%u)\n", status, total);
+    server_record_io( file, IO_STAT_READ, total, start, FALSE );
     if (event) NtSetEvent( event, NULL );
     if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_ptr, 0 );
     if (send_completion) add_completion( file, cvalue, status, total, TRUE );
@@ -6145,12 +7268,9 @@ error:
 }
 
 
-/******************************************************************************
- *              NtWriteFile   (NTDLL.@)
- */
-NTSTATUS WINAPI NtWriteFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
-                             IO_STATUS_BLOCK *io, const void *buffer, ULONG length,
-                             LARGE_INTEGER *offset, ULONG *key )
+static NTSTATUS write_file( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                            IO_STATUS_BLOCK *io, const void *buffer, ULONG length,
+                            LARGE_INTEGER *offset, ULONG *key )
 {
     int result, unix_handle, needs_close;
     unsigned int options;
@@ -6161,6 +7281,7 @@ NTSTATUS WINAPI NtWriteFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, v
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
     BOOL send_completion = FALSE, async_write, append_write = FALSE, timeout_init_done = FALSE;
+    ULONGLONG start = get_io_time();
     LARGE_INTEGER offset_eof;
 
     TRACE( "(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p)\n",
@@ -6223,6 +7344,13 @@ NTSTATUS WINAPI NtWriteFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, v
                 status = STATUS_INVALID_PARAMETER;
                 goto done;
             }
+            else if (async_write && length && event && !apc &&
+                     (status = queue_file_uring_io( handle, unix_handle, event, io, cvalue, (void *)buffer,
+                                                    length, off, TRUE )) == STATUS_PENDING)
+            {
+                if (needs_close) close( unix_handle );
+                return status;
+            }
 
             /* async I/O doesn't make sense on regular files */
             while ((result = pwrite( unix_handle, buffer, length, off )) == -1)
@@ -6360,6 +7488,7 @@ err:
         io->Status = status;
         io->Information = total;
         TRACE("= SUCCESS (%u)\n", total);
+        server_record_io( handle, IO_STAT_WRITE, total, start, FALSE );
         if (event) NtSetEvent( event, NULL );
         if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_ptr, 0 );
     }
@@ -6375,6 +7504,22 @@ err:
 }
 
 
+/******************************************************************************
+ *              NtWriteFile   (NTDLL.@)
+ */
+NTSTATUS WINAPI NtWriteFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                             IO_STATUS_BLOCK *io, const void *buffer, ULONG length,
+                             LARGE_INTEGER *offset, ULONG *key )
+{
+    NTSTATUS status;
+
+    WINE_PROBE2( wine, write_file_start, handle, length );
+    status = write_file( handle, event, apc, apc_user, io, buffer, length, offset, key );
+    WINE_PROBE2( wine, write_file_end, handle, status );
+    return status;
+}
+
+
 /******************************************************************************
  *              NtWriteFileGather   (NTDLL.@)
  */
@@ -6389,6 +7534,7 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
     BOOL send_completion = FALSE;
+    ULONGLONG start = get_io_time();
 
     TRACE( "(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p),partial stub!\n",
            file, event, apc, apc_user, io, segments, (int)length, offset, key );
@@ -6449,6 +7595,7 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
         io->Status = status;
         io->Information = total;
         TRACE("= SUCCESS (%u)\n", total);
+        server_record_io( file, IO_STAT_WRITE, total, start, FALSE );
         if (event) NtSetEvent( event, NULL );
         if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_ptr, 0 );
     }
@@ -6481,6 +7628,10 @@ NTSTATUS WINAPI NtDeviceIoControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUT
     if (HandleToLong( handle ) == ~0)
         return STATUS_INVALID_HANDLE;
 
+    /* socket reads and writes are accounted for by the socket code */
+    if (device != FILE_DEVICE_BEEP && device != FILE_DEVICE_NETWORK)
+        server_record_io( handle, IO_STAT_OTHER, 0, 0, FALSE );
+
     switch (device)
     {
     case FILE_DEVICE_BEEP:
@@ -6515,6 +7666,95 @@ NTSTATUS WINAPI NtDeviceIoControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUT
 }
 
 
+#if defined(__linux__) && !defined(FICLONERANGE)
+struct file_clone_range
+{
+    INT64  src_fd;
+    UINT64 src_offset;
+    UINT64 src_length;
+    UINT64 dest_offset;
+};
+#define FICLONERANGE _IOW( 0x94, 13, struct file_clone_range )
+#endif
+
+/******************************************************************************
+ *           duplicate_extents
+ *
+ * Implementation of FSCTL_DUPLICATE_EXTENTS_TO_FILE. The extents are shared when
+ * the filesystem supports reflinks, otherwise the data is copied in the kernel.
+ */
+static NTSTATUS duplicate_extents( HANDLE handle, const DUPLICATE_EXTENTS_DATA *data )
+{
+    enum server_fd_type type;
+    int src_fd, dst_fd, src_close, dst_close;
+    NTSTATUS status;
+
+    if (data->SourceFileOffset.QuadPart < 0 || data->TargetFileOffset.QuadPart < 0 ||
+        data->ByteCount.QuadPart < 0)
+        return STATUS_INVALID_PARAMETER;
+
+    if ((status = server_get_unix_fd( handle, FILE_WRITE_DATA, &dst_fd, &dst_close, &type, NULL )))
+        return status;
+    if (type != FD_TYPE_FILE)
+    {
+        if (dst_close) close( dst_fd );
+        return STATUS_INVALID_PARAMETER;
+    }
+    if ((status = server_get_unix_fd( data->FileHandle, FILE_READ_DATA, &src_fd, &src_close, &type, NULL )))
+    {
+        if (dst_close) close( dst_fd );
+        return status;
+    }
+    status = STATUS_NOT_SUPPORTED;
+    if (type != FD_TYPE_FILE) status = STATUS_INVALID_PARAMETER;
+    else if (!data->ByteCount.QuadPart) status = STATUS_SUCCESS;
+    else
+    {
+#ifdef FICLONERANGE
+        struct file_clone_range range;
+
+        range.src_fd      = src_fd;
+        range.src_offset  = data->SourceFileOffset.QuadPart;
+        range.src_length  = data->ByteCount.QuadPart;
+        range.dest_offset = data->TargetFileOffset.QuadPart;
+        if (!ioctl( dst_fd, FICLONERANGE, &range )) status = STATUS_SUCCESS;
+        else TRACE( "FICLONERANGE failed: %s\n", strerror( errno ));
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+        if (status)
+        {
+            off_t src_pos = data->SourceFileOffset.QuadPart, dst_pos = data->TargetFileOffset.QuadPart;
+            ULONGLONG remaining = data->ByteCount.QuadPart;
+            ssize_t ret;
+
+            while (remaining)
+            {
+                if ((ret = copy_file_range( src_fd, &src_pos, dst_fd, &dst_pos, min( remaining, 1 << 30 ), 0 )) > 0)
+                {
+                    remaining -= ret;
+                    status = STATUS_SUCCESS;
+                    continue;
+                }
+                if (!ret) break;  /* end of the source file */
+                if (errno == EINTR) continue;
+                /* unsupported combinations are reported before copying anything */
+                if (remaining == data->ByteCount.QuadPart &&
+                    (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+                    status = STATUS_NOT_SUPPORTED;
+                else
+                    status = errno_to_status( errno );
+                break;
+            }
+            if (!remaining) status = STATUS_SUCCESS;
+        }
+#endif
+    }
+    if (src_close) close( src_fd );
+    if (dst_close) close( dst_fd );
+    return status;
+}
+
+
 /* Tell Valgrind to ignore any holes in structs we will be passing to the
  * server */
 static void ignore_server_ioctl_struct_holes( ULONG code, const void *in_buffer, ULONG in_size )
@@ -6555,6 +7795,7 @@ NTSTATUS WINAPI NtFsControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     if (!io) return STATUS_INVALID_PARAMETER;
 
     ignore_server_ioctl_struct_holes( code, in_buffer, in_size );
+    server_record_io( handle, IO_STAT_OTHER, 0, 0, FALSE );
 
     switch (code)
     {
@@ -6600,6 +7841,13 @@ NTSTATUS WINAPI NtFsControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
         break;
     }
 
+    case FSCTL_DUPLICATE_EXTENTS_TO_FILE:
+        io->Information = 0;
+        if (in_size >= sizeof(DUPLICATE_EXTENTS_DATA))
+            status = duplicate_extents( handle, in_buffer );
+        else status = STATUS_INVALID_PARAMETER;
+        break;
+
     case FSCTL_GET_REPARSE_POINT:
         io->Information = 0;
         if (out_buffer && out_size)
@@ -6716,6 +7964,8 @@ NTSTATUS WINAPI NtCancelIoFile( HANDLE handle, IO_STATUS_BLOCK *io_status )
 
     if (ac_odyssey && !cancel_async_file_read( handle, NULL ))
         return (io_status->Status = STATUS_SUCCESS);
+    if (!cancel_file_uring_io( handle, NULL ))
+        return (io_status->Status = STATUS_SUCCESS);
 
     SERVER_START_REQ( cancel_async )
     {
@@ -6744,6 +7994,8 @@ NTSTATUS WINAPI NtCancelIoFileEx( HANDLE handle, IO_STATUS_BLOCK *io, IO_STATUS_
 
     if (ac_odyssey && !cancel_async_file_read( handle, io ))
         return (io_status->Status = STATUS_SUCCESS);
+    if (!cancel_file_uring_io( handle, io ))
+        return (io_status->Status = STATUS_SUCCESS);
 
     SERVER_START_REQ( cancel_async )
     {
@@ -50,6 +50,7 @@
 #include "winternl.h"
 #include "wine/debug.h"
 #include "wine/server.h"
+#include "wine/sdt.h"
 
 #include "unix_private.h"
 #include "fsync.h"
@@ -158,6 +159,16 @@ static inline int futex_wait_multiple( const struct futex_waitv *futexes,
         return syscall( __NR_futex_waitv, futexes, count, 0, NULL, 0 );
 }
 
+static inline BOOL futexes_changed( const struct futex_waitv *futexes, int count )
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (__atomic_load_n( (int *)(uintptr_t)futexes[i].uaddr, __ATOMIC_RELAXED ) != (int)futexes[i].val)
+            return TRUE;
+    return FALSE;
+}
+
 static inline int futex_wake( int *addr, int val )
 {
     return syscall( __NR_futex, addr, 1, val, NULL, 0, 0 );
@@ -186,6 +197,7 @@ int do_fsync(void)
 struct fsync
 {
     enum fsync_type type;
+    unsigned int shm_idx;   /* index of the shm section */
     void *shm;              /* pointer to shm section */
 };
 
@@ -309,23 +321,6 @@ static void grab_object( struct fsync *obj )
     __atomic_add_fetch( &shm[2], 1, __ATOMIC_SEQ_CST );
 }
 
-static unsigned int shm_index_from_shm( char *shm )
-{
-    unsigned int i, idx_offset;
-
-    for (i = 0; i < ARRAY_SIZE(shm_addrs); ++i)
-    {
-        if (shm >= (char *)shm_addrs[i] && shm < (char *)shm_addrs[i] + FSYNC_SHM_PAGE_SIZE)
-        {
-            idx_offset = (shm - (char *)shm_addrs[i]) / 16;
-            return i * (FSYNC_SHM_PAGE_SIZE / 16) + idx_offset;
-        }
-    }
-
-    ERR( "Index for shm %p not found.\n", shm );
-    return ~0u;
-}
-
 static void put_object( struct fsync *obj )
 {
     int *shm = obj->shm;
@@ -335,7 +330,7 @@ static void put_object( struct fsync *obj )
         /* We are holding the last reference, it should be released on server so shm idx get freed. */
         SERVER_START_REQ( fsync_free_shm_idx )
         {
-            req->shm_idx = shm_index_from_shm( obj->shm );
+            req->shm_idx = obj->shm_idx;
             wine_server_call( req );
         }
         SERVER_END_REQ;
@@ -367,6 +362,7 @@ again:
     if (!cache.type || !cache.shm_idx) return FALSE;
 
     obj->type = cache.type;
+    obj->shm_idx = cache.shm_idx;
     obj->shm = get_shm( cache.shm_idx );
     grab_object( obj );
     if (((int *)obj->shm)[2] < 2 ||
@@ -435,6 +431,7 @@ static NTSTATUS get_object( HANDLE handle, struct fsync *obj )
     TRACE("Got shm index %d for handle %p.\n", shm_idx, handle);
 
     obj->type = type;
+    obj->shm_idx = shm_idx;
     obj->shm = get_shm( shm_idx );
     /* get_fsync_idx server request increments shared mem refcount, so not grabbing object here. */
     return ret;
@@ -457,12 +454,16 @@ static NTSTATUS get_object_for_wait( HANDLE handle, struct fsync *obj, int *prev
     return STATUS_SUCCESS;
 }
 
+static void close_local_timer( HANDLE handle );
+
 NTSTATUS fsync_close( HANDLE handle )
 {
     UINT_PTR entry, idx = handle_to_index( handle, &entry );
 
     TRACE("%p.\n", handle);
 
+    close_local_timer( handle );
+
     if (entry < FSYNC_LIST_ENTRIES && fsync_list[entry])
     {
         struct fsync_cache cache;
@@ -852,6 +853,328 @@ NTSTATUS fsync_query_mutex( HANDLE handle, void *info, ULONG *ret_len )
     return STATUS_SUCCESS;
 }
 
+/* Unnamed timers without an APC routine can be armed in-process: a timer
+ * thread signals their shm futex directly, so that arming a timer doesn't
+ * need a server call and expiry doesn't go through the server's timeout
+ * loop. The server timer is left disarmed; as soon as the timer is needed
+ * by a server wait or another process, its state is handed back to the
+ * server for good. */
+
+struct local_timer
+{
+    HANDLE        handle;
+    struct fsync  obj;
+    BOOL          manual;
+    BOOL          armed;
+    ULONGLONG     when;     /* monotonic expiry time */
+    unsigned int  period;   /* in ms */
+};
+
+static struct local_timer *local_timers;
+static unsigned int local_timer_count, local_timer_size;
+static pthread_mutex_t local_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t local_timer_cond;
+static pthread_once_t local_timer_once = PTHREAD_ONCE_INIT;
+
+static int do_local_timers(void)
+{
+    static int do_local_timers_cached = -1;
+
+    if (do_local_timers_cached == -1)
+        do_local_timers_cached = getenv("WINEFSYNC_LOCAL_TIMERS") && atoi(getenv("WINEFSYNC_LOCAL_TIMERS"));
+    return do_local_timers_cached;
+}
+
+static ULONGLONG local_timer_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return nt_time_from_ts( &ts );
+}
+
+static struct local_timer *find_local_timer( HANDLE handle )
+{
+    unsigned int i;
+
+    for (i = 0; i < local_timer_count; i++)
+        if (local_timers[i].handle == handle) return &local_timers[i];
+    return NULL;
+}
+
+/* remove a timer from the list; local_timer_mutex must be held */
+static void remove_local_timer( struct local_timer *timer, struct local_timer *removed )
+{
+    *removed = *timer;
+    *timer = local_timers[--local_timer_count];
+}
+
+static void *local_timer_thread( void *arg )
+{
+    sigset_t sigset;
+
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_BLOCK, &sigset, NULL );
+
+    pthread_mutex_lock( &local_timer_mutex );
+    for (;;)
+    {
+        ULONGLONG now = local_timer_now(), next = 0;
+        unsigned int i;
+
+        for (i = 0; i < local_timer_count; i++)
+        {
+            struct local_timer *timer = &local_timers[i];
+            struct event *event = timer->obj.shm;
+
+            if (!timer->armed) continue;
+            if (timer->when <= now)
+            {
+                if (!__atomic_exchange_n( &event->signaled, 1, __ATOMIC_SEQ_CST ))
+                    futex_wake( &event->signaled, INT_MAX );
+
+                if (timer->period)
+                {
+                    timer->when += (ULONGLONG)timer->period * 10000;
+                    if (timer->when <= now) timer->when = now + (ULONGLONG)timer->period * 10000;
+                }
+                else timer->armed = FALSE;
+            }
+            if (timer->armed && (!next || timer->when < next)) next = timer->when;
+        }
+
+        if (!next) pthread_cond_wait( &local_timer_cond, &local_timer_mutex );
+        else
+        {
+            struct timespec ts;
+
+            next -= SECS_1601_TO_1970 * TICKSPERSEC;
+            ts.tv_sec = next / TICKSPERSEC;
+            ts.tv_nsec = (next % TICKSPERSEC) * 100;
+            pthread_cond_timedwait( &local_timer_cond, &local_timer_mutex, &ts );
+        }
+    }
+    return NULL;
+}
+
+static void local_timer_init(void)
+{
+    pthread_condattr_t condattr;
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    pthread_condattr_init( &condattr );
+    pthread_condattr_setclock( &condattr, CLOCK_MONOTONIC );
+    pthread_cond_init( &local_timer_cond, &condattr );
+    pthread_condattr_destroy( &condattr );
+
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    if (pthread_create( &thread, &attr, local_timer_thread, NULL ))
+        ERR( "failed to create timer thread\n" );
+    pthread_attr_destroy( &attr );
+}
+
+/* start handling a freshly created timer in-process, if possible */
+void fsync_register_timer( HANDLE handle, BOOLEAN manual )
+{
+    struct local_timer *timer;
+    struct fsync obj;
+
+    if (!do_local_timers()) return;
+    if (get_object( handle, &obj )) return;
+    pthread_once( &local_timer_once, local_timer_init );
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (local_timer_count == local_timer_size)
+    {
+        unsigned int size = max( 16, local_timer_size * 2 );
+        struct local_timer *new_timers = realloc( local_timers, size * sizeof(*new_timers) );
+
+        if (!new_timers)
+        {
+            pthread_mutex_unlock( &local_timer_mutex );
+            put_object( &obj );
+            return;
+        }
+        local_timers = new_timers;
+        local_timer_size = size;
+    }
+    timer = &local_timers[local_timer_count++];
+    timer->handle = handle;
+    timer->obj    = obj;
+    timer->manual = manual;
+    timer->armed  = FALSE;
+    timer->when   = 0;
+    timer->period = 0;
+    pthread_mutex_unlock( &local_timer_mutex );
+}
+
+/* stop handling a timer in-process and pass its current state to the server */
+static void release_local_timer( HANDLE handle )
+{
+    struct local_timer *timer, removed;
+    struct event *event;
+
+    if (!local_timer_count) return;
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (!(timer = find_local_timer( handle )))
+    {
+        pthread_mutex_unlock( &local_timer_mutex );
+        return;
+    }
+    remove_local_timer( timer, &removed );
+    pthread_mutex_unlock( &local_timer_mutex );
+
+    TRACE( "handing timer %p back to the server\n", handle );
+
+    event = removed.obj.shm;
+    if (removed.armed || __atomic_load_n( &event->signaled, __ATOMIC_SEQ_CST ))
+    {
+        ULONGLONG now = local_timer_now();
+
+        SERVER_START_REQ( set_timer )
+        {
+            req->handle   = wine_server_obj_handle( handle );
+            req->period   = removed.armed ? removed.period : 0;
+            /* an already signaled timer is set to expire immediately */
+            req->expire   = removed.armed && removed.when > now ? -(LONGLONG)(removed.when - now) : 0;
+            req->callback = 0;
+            req->arg      = 0;
+            wine_server_call( req );
+        }
+        SERVER_END_REQ;
+    }
+    put_object( &removed.obj );
+}
+
+void fsync_release_timers( DWORD count, const HANDLE *handles )
+{
+    DWORD i;
+
+    if (!local_timer_count) return;
+    for (i = 0; i < count; i++) release_local_timer( handles[i] );
+}
+
+/* called from NtClose(); the server-side object goes away with the handle */
+static void close_local_timer( HANDLE handle )
+{
+    struct local_timer *timer, removed;
+
+    if (!local_timer_count) return;
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (!(timer = find_local_timer( handle )))
+    {
+        pthread_mutex_unlock( &local_timer_mutex );
+        return;
+    }
+    remove_local_timer( timer, &removed );
+    pthread_mutex_unlock( &local_timer_mutex );
+    put_object( &removed.obj );
+}
+
+NTSTATUS fsync_set_timer( HANDLE handle, const LARGE_INTEGER *when, PTIMER_APC_ROUTINE callback,
+                          ULONG period, BOOLEAN *state )
+{
+    struct local_timer *timer;
+    struct event *event;
+    ULONGLONG now;
+    int prev;
+
+    if (!local_timer_count) return STATUS_NOT_IMPLEMENTED;
+
+    if (callback)
+    {
+        /* APCs have to be queued by the server */
+        release_local_timer( handle );
+        return STATUS_NOT_IMPLEMENTED;
+    }
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (!(timer = find_local_timer( handle )))
+    {
+        pthread_mutex_unlock( &local_timer_mutex );
+        return STATUS_NOT_IMPLEMENTED;
+    }
+
+    TRACE( "%p, when %s, period %u.\n", handle, wine_dbgstr_longlong( when->QuadPart ), (int)period );
+
+    event = timer->obj.shm;
+    prev = __atomic_load_n( &event->signaled, __ATOMIC_SEQ_CST );
+    if (timer->manual)
+    {
+        period = 0;  /* period doesn't make any sense for a manual timer */
+        __atomic_store_n( &event->signaled, 0, __ATOMIC_SEQ_CST );
+    }
+
+    now = local_timer_now();
+    if (when->QuadPart == TIMEOUT_INFINITE) timer->armed = FALSE;
+    else
+    {
+        if (when->QuadPart <= 0) timer->when = now - when->QuadPart;
+        else
+        {
+            struct timespec ts;
+            LONGLONG system_now;
+
+            clock_gettime( CLOCK_REALTIME, &ts );
+            system_now = nt_time_from_ts( &ts );
+            timer->when = now + max( when->QuadPart - system_now, 0 );
+        }
+        timer->armed = TRUE;
+    }
+    timer->period = period;
+    pthread_cond_signal( &local_timer_cond );
+    pthread_mutex_unlock( &local_timer_mutex );
+
+    if (state) *state = prev;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS fsync_cancel_timer( HANDLE handle, BOOLEAN *state )
+{
+    struct local_timer *timer;
+    struct event *event;
+
+    if (!local_timer_count) return STATUS_NOT_IMPLEMENTED;
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (!(timer = find_local_timer( handle )))
+    {
+        pthread_mutex_unlock( &local_timer_mutex );
+        return STATUS_NOT_IMPLEMENTED;
+    }
+    timer->armed = FALSE;
+    event = timer->obj.shm;
+    if (state) *state = __atomic_load_n( &event->signaled, __ATOMIC_SEQ_CST );
+    pthread_mutex_unlock( &local_timer_mutex );
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS fsync_query_timer( HANDLE handle, TIMER_BASIC_INFORMATION *info )
+{
+    struct local_timer *timer;
+    struct event *event;
+    ULONGLONG now;
+
+    if (!local_timer_count) return STATUS_NOT_IMPLEMENTED;
+
+    pthread_mutex_lock( &local_timer_mutex );
+    if (!(timer = find_local_timer( handle )))
+    {
+        pthread_mutex_unlock( &local_timer_mutex );
+        return STATUS_NOT_IMPLEMENTED;
+    }
+    now = local_timer_now();
+    event = timer->obj.shm;
+    info->RemainingTime.QuadPart = timer->armed && timer->when > now ? timer->when - now : 0;
+    info->TimerState = __atomic_load_n( &event->signaled, __ATOMIC_SEQ_CST );
+    pthread_mutex_unlock( &local_timer_mutex );
+    return STATUS_SUCCESS;
+}
+
 static inline void try_yield_to_waiters( int prev_pid )
 {
     if (!fsync_yield_to_waiters) return;
@@ -931,6 +1254,7 @@ static NTSTATUS __fsync_wait_objects( DWORD count, const HANDLE *handles,
     int dummy_futex = 0;
     LONGLONG timeleft;
     DWORD waitcount;
+    unsigned int spin, spins;
     int i, ret;
 
     /* Grab the APC futex if we don't already have it. */
@@ -964,6 +1288,7 @@ static NTSTATUS __fsync_wait_objects( DWORD count, const HANDLE *handles,
         else if (ret == STATUS_NOT_IMPLEMENTED)
         {
             objs[i].type = 0;
+            objs[i].shm_idx = 0;
             objs[i].shm = NULL;
             has_server = 1;
         }
@@ -982,6 +1307,8 @@ static NTSTATUS __fsync_wait_objects( DWORD count, const HANDLE *handles,
     else if (has_server)
     {
         put_objects( objs, count );
+        /* the server has to signal any in-process timers we wait on */
+        fsync_release_timers( count, handles );
         return STATUS_NOT_IMPLEMENTED;
     }
 
@@ -1159,6 +1486,19 @@ static NTSTATUS __fsync_wait_objects( DWORD count, const HANDLE *handles,
                 return STATUS_TIMEOUT;
             }
 
+            /* The object may well be signaled again before a futex sleep and
+             * wakeup would complete, so spin on the futexes for a bit first. */
+            if ((spins = get_sync_spin_count( objs[0].shm )))
+            {
+                for (spin = 0; spin < spins; spin++)
+                {
+                    YieldProcessor();
+                    if (futexes_changed( futexes, waitcount )) break;
+                }
+                update_sync_spin_count( objs[0].shm, spin, spin < spins );
+                if (spin < spins) continue;
+            }
+
             ret = futex_wait_multiple( futexes, waitcount, timeout ? &end : NULL, clock_id );
 
             /* FUTEX_WAIT_MULTIPLE can succeed or return -EINTR, -EAGAIN,
@@ -1439,7 +1779,9 @@ NTSTATUS fsync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN wait_an
         put_object( &obj );
     }
 
+    WINE_PROBE3( wine, fsync_wait_start, count, wait_any, timeout ? timeout->QuadPart : TIMEOUT_INFINITE );
     ret = __fsync_wait_objects( count, handles, wait_any, alertable, timeout );
+    WINE_PROBE2( wine, fsync_wait_end, count, ret );
 
     if (msgwait)
         server_set_msgwait( 0 );
@@ -42,6 +42,12 @@ extern NTSTATUS fsync_open_mutex( HANDLE *handle, ACCESS_MASK access,
     const OBJECT_ATTRIBUTES *attr );
 extern NTSTATUS fsync_release_mutex( HANDLE handle, LONG *prev );
 extern NTSTATUS fsync_query_mutex( HANDLE handle, void *info, ULONG *ret_len );
+extern void fsync_register_timer( HANDLE handle, BOOLEAN manual );
+extern void fsync_release_timers( DWORD count, const HANDLE *handles );
+extern NTSTATUS fsync_set_timer( HANDLE handle, const LARGE_INTEGER *when, PTIMER_APC_ROUTINE callback,
+    ULONG period, BOOLEAN *state );
+extern NTSTATUS fsync_cancel_timer( HANDLE handle, BOOLEAN *state );
+extern NTSTATUS fsync_query_timer( HANDLE handle, TIMER_BASIC_INFORMATION *info );
 
 extern NTSTATUS fsync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN wait_any,
                                     BOOLEAN alertable, const LARGE_INTEGER *timeout );
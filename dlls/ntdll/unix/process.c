@@ -439,7 +439,13 @@ static NTSTATUS spawn_process( const RTL_USER_PROCESS_PARAMETERS *params, int so
 
     if (!(pid = fork()))  /* child */
     {
+        /* the child only waits for the exec and exits, so the grandchild can borrow its address
+         * space instead of copying the page tables of the whole process a second time */
+#ifdef __linux__
+        if (!(pid = vfork()))  /* grandchild */
+#else
         if (!(pid = fork()))  /* grandchild */
+#endif
         {
             if ((peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
                 params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
@@ -842,6 +848,9 @@ NTSTATUS WINAPI NtCreateUserProcess( HANDLE *process_handle_ptr, HANDLE *thread_
     wine_server_send_fd( socketfd[1] );
     close( socketfd[1] );
 
+    /* inherited sockets are shared with the child */
+    if (process_flags & PROCESS_CREATE_FLAGS_INHERIT_HANDLES) sock_release_direct_recv( NULL );
+
     /* create the process on the server side */
 
     SERVER_START_REQ( new_process )
@@ -1111,6 +1120,59 @@ void fill_vm_counters( VM_COUNTERS_EX *pvmi, int unix_pid )
 
 #endif
 
+/* retrieve the statistics of the handles of a process, asking other processes for one handle at a time */
+static NTSTATUS get_io_statistics( HANDLE process, PROCESS_WINE_IO_STATISTICS *stats, ULONG size, ULONG *ret_len )
+{
+    PROCESS_WINE_HANDLE_IO_INFORMATION entry;
+    ULONG count = 0, max;
+    HANDLE prev = 0;
+    unsigned int status;
+
+    if (size < offsetof( PROCESS_WINE_IO_STATISTICS, Handles ))
+    {
+        *ret_len = sizeof(*stats);
+        return STATUS_INFO_LENGTH_MISMATCH;
+    }
+    max = (size - offsetof( PROCESS_WINE_IO_STATISTICS, Handles )) / sizeof(entry);
+
+    for (;;)
+    {
+        if (process == GetCurrentProcess())
+        {
+            if (!server_get_handle_io( prev, &entry )) break;
+        }
+        else
+        {
+            apc_call_t call;
+            apc_result_t result;
+
+            memset( &call, 0, sizeof(call) );
+            call.handle_io.type   = APC_HANDLE_IO;
+            call.handle_io.handle = wine_server_obj_handle( prev );
+            if ((status = server_queue_process_apc( process, &call, &result ))) return status;
+            if (!result.handle_io.handle) break;
+
+            entry.Handle              = result.handle_io.handle;
+            entry.ReadTransferCount   = result.handle_io.read_bytes;
+            entry.WriteTransferCount  = result.handle_io.write_bytes;
+            entry.ReadTime            = result.handle_io.read_time;
+            entry.WriteTime           = result.handle_io.write_time;
+            entry.ReadOperationCount  = result.handle_io.read_ops;
+            entry.WriteOperationCount = result.handle_io.write_ops;
+            entry.AsyncOperationCount = result.handle_io.async_ops;
+            entry.ZeroCopyOperationCount = result.handle_io.zerocopy_ops;
+        }
+        if (count < max) stats->Handles[count] = entry;
+        count++;
+        prev = wine_server_ptr_handle( entry.Handle );
+    }
+
+    stats->Count = min( count, max );
+    stats->Reserved = 0;
+    *ret_len = offsetof( PROCESS_WINE_IO_STATISTICS, Handles[count] );
+    return count > max ? STATUS_INFO_LENGTH_MISMATCH : STATUS_SUCCESS;
+}
+
 #define UNIMPLEMENTED_INFO_CLASS(c) \
     case c: \
         FIXME( "(process=%p) Unimplemented information class: " #c "\n", handle); \
@@ -1203,13 +1265,32 @@ NTSTATUS WINAPI NtQueryInformationProcess( HANDLE handle, PROCESSINFOCLASS class
             {
                 if (!info) ret = STATUS_ACCESS_VIOLATION;
                 else if (!handle) ret = STATUS_INVALID_HANDLE;
-                else
+                else if (handle == GetCurrentProcess())
                 {
-                    /* FIXME : real data */
-                    memset(&pii, 0 , sizeof(IO_COUNTERS));
+                    server_get_io_counters( &pii );
                     memcpy(info, &pii, sizeof(IO_COUNTERS));
                     len = sizeof(IO_COUNTERS);
                 }
+                else
+                {
+                    apc_call_t call;
+                    apc_result_t result;
+
+                    memset( &call, 0, sizeof(call) );
+                    call.io_counters.type = APC_IO_COUNTERS;
+                    if (!(ret = server_queue_process_apc( handle, &call, &result )) &&
+                        !(ret = result.io_counters.status))
+                    {
+                        pii.ReadOperationCount  = result.io_counters.read_ops;
+                        pii.WriteOperationCount = result.io_counters.write_ops;
+                        pii.OtherOperationCount = result.io_counters.other_ops;
+                        pii.ReadTransferCount   = result.io_counters.read_bytes;
+                        pii.WriteTransferCount  = result.io_counters.write_bytes;
+                        pii.OtherTransferCount  = result.io_counters.other_bytes;
+                        memcpy(info, &pii, sizeof(IO_COUNTERS));
+                        len = sizeof(IO_COUNTERS);
+                    }
+                }
                 if (size > sizeof(IO_COUNTERS)) ret = STATUS_INFO_LENGTH_MISMATCH;
             }
             else
@@ -1572,6 +1653,10 @@ NTSTATUS WINAPI NtQueryInformationProcess( HANDLE handle, PROCESSINFOCLASS class
         else ret = STATUS_INFO_LENGTH_MISMATCH;
         break;
 
+    case ProcessWineIoStatistics:
+        ret = get_io_statistics( handle, info, size, &len );
+        break;
+
     case ProcessWineLdtCopy:
         if (handle == NtCurrentProcess())
         {
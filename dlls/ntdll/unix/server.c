@@ -250,9 +250,32 @@ static void read_reply_data( void *buffer, size_t size )
  */
 static inline unsigned int wait_reply( struct __server_request_info *req )
 {
-    read_reply_data( &req->u.reply, sizeof(req->u.reply) );
-    if (req->u.reply.reply_header.reply_size)
-        read_reply_data( req->reply_data, req->u.reply.reply_header.reply_size );
+    data_size_t max_size = req->u.req.request_header.reply_size;
+    struct iovec vec[2];
+    int ret;
+
+    /* the server writes the reply and its data at once, so try to get both in a single call */
+    vec[0].iov_base = &req->u.reply;
+    vec[0].iov_len  = sizeof(req->u.reply);
+    vec[1].iov_base = req->reply_data;
+    vec[1].iov_len  = max_size;
+
+    for (;;)
+    {
+        if ((ret = readv( ntdll_get_thread_data()->reply_fd, vec, max_size ? 2 : 1 )) > 0) break;
+        if (!ret || errno == EPIPE) abort_thread(0);  /* the server closed the connection */
+        if (errno != EINTR) server_protocol_perror( "read" );
+    }
+
+    if (ret < sizeof(req->u.reply))
+    {
+        read_reply_data( (char *)&req->u.reply + ret, sizeof(req->u.reply) - ret );
+        ret = 0;
+    }
+    else ret -= sizeof(req->u.reply);
+
+    if (ret < req->u.reply.reply_header.reply_size)
+        read_reply_data( (char *)req->reply_data + ret, req->u.reply.reply_header.reply_size - ret );
     return req->u.reply.reply_header.error;
 }
 
@@ -275,6 +298,70 @@ unsigned int server_call_unlocked( void *req_ptr )
 }
 
 
+/***********************************************************************
+ *           server_call_batch
+ *
+ * Send several independent requests to the server in a single round trip.
+ * Each request gets its own reply and status; the return value only
+ * reports errors affecting the batch as a whole.
+ */
+unsigned int server_call_batch( struct __server_request_info **reqs, unsigned int count )
+{
+    data_size_t size = 0, reply_size = 0, pos, max_size;
+    unsigned int i, j, ret, done = 0;
+    char *data, *replies;
+
+    for (i = 0; i < count; i++)
+    {
+        size += sizeof(reqs[i]->u.req) + ((reqs[i]->u.req.request_header.request_size + 7) & ~7);
+        reply_size += sizeof(reqs[i]->u.reply) + ((reqs[i]->u.req.request_header.reply_size + 7) & ~7);
+    }
+    if (!(data = calloc( 1, size + reply_size ))) return STATUS_NO_MEMORY;
+    replies = data + size;
+
+    for (i = pos = 0; i < count; i++)
+    {
+        memcpy( data + pos, &reqs[i]->u.req, sizeof(reqs[i]->u.req) );
+        pos += sizeof(reqs[i]->u.req);
+        for (j = 0; j < reqs[i]->data_count; j++)
+        {
+            memcpy( data + pos, reqs[i]->data[j].ptr, reqs[i]->data[j].size );
+            pos += reqs[i]->data[j].size;
+        }
+        pos = (pos + 7) & ~7;
+    }
+
+    SERVER_START_REQ( batch_requests )
+    {
+        wine_server_add_data( req, data, size );
+        wine_server_set_reply( req, replies, reply_size );
+        ret = wine_server_call( req );
+        done = reply->count;
+    }
+    SERVER_END_REQ;
+
+    for (i = pos = 0; i < count; i++)
+    {
+        max_size = (reqs[i]->u.req.request_header.reply_size + 7) & ~7;
+        if (i < done)
+        {
+            memcpy( &reqs[i]->u.reply, replies + pos, sizeof(reqs[i]->u.reply) );
+            if (reqs[i]->u.reply.reply_header.reply_size)
+                memcpy( reqs[i]->reply_data, replies + pos + sizeof(reqs[i]->u.reply),
+                        reqs[i]->u.reply.reply_header.reply_size );
+        }
+        else
+        {
+            memset( &reqs[i]->u.reply, 0, sizeof(reqs[i]->u.reply) );
+            reqs[i]->u.reply.reply_header.error = ret ? ret : STATUS_INVALID_PARAMETER;
+        }
+        pos += sizeof(reqs[i]->u.reply) + max_size;
+    }
+    free( data );
+    return ret;
+}
+
+
 /***********************************************************************
  *           wine_server_call
  *
@@ -504,6 +591,28 @@ static void invoke_system_apc( const apc_call_t *call, apc_result_t *result, BOO
         }
         break;
     }
+    case APC_VIRTUAL_USAGE:
+    {
+        MEMORY_WINE_USAGE_INFORMATION info;
+        result->type = call->type;
+        addr = wine_server_get_ptr( call->virtual_usage.addr );
+        if ((ULONG_PTR)addr == call->virtual_usage.addr)
+            result->virtual_usage.status = NtQueryVirtualMemory( NtCurrentProcess(), addr,
+                                                                 MemoryWineUsageInformation, &info,
+                                                                 sizeof(info), NULL );
+        else
+            result->virtual_usage.status = STATUS_NO_MORE_ENTRIES;
+
+        if (result->virtual_usage.status == STATUS_SUCCESS)
+        {
+            result->virtual_usage.base     = info.BaseAddress;
+            result->virtual_usage.size     = info.RegionSize;
+            result->virtual_usage.commit   = info.CommitSize;
+            result->virtual_usage.resident = info.ResidentSize;
+            result->virtual_usage.usage    = info.UsageType;
+        }
+        break;
+    }
     case APC_VIRTUAL_PROTECT:
         result->type = call->type;
         addr = wine_server_get_ptr( call->virtual_protect.addr );
@@ -686,6 +795,40 @@ static void invoke_system_apc( const apc_call_t *call, apc_result_t *result, BOO
         if (!self) NtClose( wine_server_ptr_handle(call->dup_handle.dst_process) );
         break;
     }
+    case APC_IO_COUNTERS:
+    {
+        IO_COUNTERS counters;
+
+        result->type = call->type;
+        server_get_io_counters( &counters );
+        result->io_counters.status      = STATUS_SUCCESS;
+        result->io_counters.read_ops    = counters.ReadOperationCount;
+        result->io_counters.write_ops   = counters.WriteOperationCount;
+        result->io_counters.other_ops   = counters.OtherOperationCount;
+        result->io_counters.read_bytes  = counters.ReadTransferCount;
+        result->io_counters.write_bytes = counters.WriteTransferCount;
+        result->io_counters.other_bytes = counters.OtherTransferCount;
+        break;
+    }
+    case APC_HANDLE_IO:
+    {
+        PROCESS_WINE_HANDLE_IO_INFORMATION info;
+
+        result->type = call->type;
+        if (server_get_handle_io( wine_server_ptr_handle( call->handle_io.handle ), &info ))
+        {
+            result->handle_io.handle      = info.Handle;
+            result->handle_io.read_bytes  = info.ReadTransferCount;
+            result->handle_io.write_bytes = info.WriteTransferCount;
+            result->handle_io.read_time   = info.ReadTime;
+            result->handle_io.write_time  = info.WriteTime;
+            result->handle_io.read_ops    = info.ReadOperationCount;
+            result->handle_io.write_ops   = info.WriteOperationCount;
+            result->handle_io.async_ops   = info.AsyncOperationCount;
+            result->handle_io.zerocopy_ops = info.ZeroCopyOperationCount;
+        }
+        break;
+    }
     default:
         server_protocol_error( "get_apc_request: bad type %d\n", call->type );
         break;
@@ -1005,11 +1148,47 @@ union fd_cache_entry
 
 C_ASSERT( sizeof(union fd_cache_entry) == sizeof(LONG64) );
 
+/* full access mask and sharing flags, stored alongside the fd cache entry */
+union fd_cache_info
+{
+    LONG64 data;
+    struct
+    {
+        unsigned int access;
+        unsigned int sharing;
+    } s;
+};
+
+C_ASSERT( sizeof(union fd_cache_info) == sizeof(LONG64) );
+
+/* I/O statistics of a handle, stored in blocks indexed like the fd cache */
+struct handle_io_stats
+{
+    LONG64 read_bytes;
+    LONG64 write_bytes;
+    LONG64 read_time;
+    LONG64 write_time;
+    LONG   read_ops;
+    LONG   write_ops;
+    LONG   async_ops;
+    LONG   other_ops;
+    LONG   zerocopy_ops;
+};
+
+static IO_COUNTERS io_counters;
+
 #define FD_CACHE_BLOCK_SIZE  (65536 / sizeof(union fd_cache_entry))
-#define FD_CACHE_ENTRIES     128
+/* enough blocks to cover the whole server handle table (0x00ffffff entries) */
+#define FD_CACHE_ENTRIES     (0x01000000 / FD_CACHE_BLOCK_SIZE)
 
 static union fd_cache_entry *fd_cache[FD_CACHE_ENTRIES];
 static union fd_cache_entry fd_cache_initial_block[FD_CACHE_BLOCK_SIZE];
+static union fd_cache_info *fd_cache_info[FD_CACHE_ENTRIES];
+static union fd_cache_info fd_cache_initial_info[FD_CACHE_BLOCK_SIZE];
+static struct handle_io_stats *io_stats[FD_CACHE_ENTRIES];
+static LONG *sock_states[FD_CACHE_ENTRIES];
+static unsigned int fd_cache_misses;  /* protected by fd_cache_mutex */
+static unsigned int fd_cache_uncached;  /* protected by fd_cache_mutex */
 
 static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
 {
@@ -1025,10 +1204,11 @@ static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
  * Caller must hold fd_cache_mutex.
  */
 static BOOL add_fd_to_cache( HANDLE handle, int fd, enum server_fd_type type,
-                            unsigned int access, unsigned int options )
+                            unsigned int access, unsigned int sharing, unsigned int options )
 {
     unsigned int entry, idx = handle_to_index( handle, &entry );
     union fd_cache_entry cache;
+    union fd_cache_info info;
 
     if (entry >= FD_CACHE_ENTRIES)
     {
@@ -1038,16 +1218,27 @@ static BOOL add_fd_to_cache( HANDLE handle, int fd, enum server_fd_type type,
 
     if (!fd_cache[entry])  /* do we need to allocate a new block of entries? */
     {
-        if (!entry) fd_cache[0] = fd_cache_initial_block;
+        if (!entry)
+        {
+            fd_cache_info[0] = fd_cache_initial_info;
+            fd_cache[0] = fd_cache_initial_block;
+        }
         else
         {
-            void *ptr = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * sizeof(union fd_cache_entry),
-                                         PROT_READ | PROT_WRITE );
+            union fd_cache_entry *ptr = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * (sizeof(union fd_cache_entry) +
+                                                                               sizeof(union fd_cache_info)),
+                                                         PROT_READ | PROT_WRITE );
             if (ptr == MAP_FAILED) return FALSE;
+            fd_cache_info[entry] = (union fd_cache_info *)(ptr + FD_CACHE_BLOCK_SIZE);
             fd_cache[entry] = ptr;
         }
     }
 
+    /* the info is published before the fd entry, so it is valid whenever the fd is */
+    info.s.access = access;
+    info.s.sharing = sharing;
+    interlocked_xchg64( &fd_cache_info[entry][idx].data, info.data );
+
     /* store fd+1 so that 0 can be used as the unset value */
     cache.s.fd = fd + 1;
     cache.s.type = type;
@@ -1084,6 +1275,29 @@ static inline NTSTATUS get_cached_fd( HANDLE handle, int *fd, enum server_fd_typ
 }
 
 
+/***********************************************************************
+ *           server_get_cached_fd_info
+ *
+ * Retrieve the full access mask and sharing mode of a handle present in the fd cache.
+ */
+BOOL server_get_cached_fd_info( HANDLE handle, unsigned int *access, unsigned int *sharing )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fd_cache_entry cache;
+    union fd_cache_info info;
+
+    if (entry >= FD_CACHE_ENTRIES || !fd_cache[entry]) return FALSE;
+
+    cache.data = InterlockedCompareExchange64( &fd_cache[entry][idx].data, 0, 0 );
+    if (!cache.data || cache.s.type == FD_TYPE_INVALID) return FALSE;
+
+    info.data = InterlockedCompareExchange64( &fd_cache_info[entry][idx].data, 0, 0 );
+    if (access) *access = info.s.access;
+    if (sharing) *sharing = info.s.sharing;
+    return TRUE;
+}
+
+
 /***********************************************************************
  *           remove_fd_from_cache
  */
@@ -1098,11 +1312,177 @@ static int remove_fd_from_cache( HANDLE handle )
         cache.data = interlocked_xchg64( &fd_cache[entry][idx].data, 0 );
         if (cache.s.type != FD_TYPE_INVALID) fd = cache.s.fd - 1;
     }
+    /* the statistics don't carry over to the next handle using this index */
+    if (entry < FD_CACHE_ENTRIES && io_stats[entry])
+        memset( &io_stats[entry][idx], 0, sizeof(io_stats[entry][idx]) );
+    /* the new generation keeps late completions on the old handle from affecting the next one */
+    if (entry < FD_CACHE_ENTRIES && sock_states[entry])
+    {
+        LONG state = ReadNoFence( &sock_states[entry][idx] );
+        InterlockedExchange( &sock_states[entry][idx],
+                             (state & SOCK_STATE_GEN_MASK) + (1 << SOCK_STATE_GEN_SHIFT) );
+    }
 
     return fd;
 }
 
 
+/***********************************************************************
+ *           server_record_io
+ *
+ * Account for a completed I/O operation on a handle. A zero start time skips the timing.
+ */
+void server_record_io( HANDLE handle, enum io_stat_type type, ULONG_PTR bytes, ULONGLONG start, BOOL async )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    struct handle_io_stats *stats;
+    LONG64 time = start ? get_io_time() - start : 0;
+
+    switch (type)
+    {
+    case IO_STAT_READ:
+        InterlockedIncrement64( (LONG64 *)&io_counters.ReadOperationCount );
+        InterlockedExchangeAdd64( (LONG64 *)&io_counters.ReadTransferCount, bytes );
+        break;
+    case IO_STAT_WRITE:
+        InterlockedIncrement64( (LONG64 *)&io_counters.WriteOperationCount );
+        InterlockedExchangeAdd64( (LONG64 *)&io_counters.WriteTransferCount, bytes );
+        break;
+    case IO_STAT_OTHER:
+        InterlockedIncrement64( (LONG64 *)&io_counters.OtherOperationCount );
+        InterlockedExchangeAdd64( (LONG64 *)&io_counters.OtherTransferCount, bytes );
+        break;
+    case IO_STAT_ZEROCOPY:
+        break;
+    }
+
+    if (entry >= FD_CACHE_ENTRIES) return;
+    if (!(stats = io_stats[entry]))  /* allocate a new block of statistics */
+    {
+        stats = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * sizeof(*stats), PROT_READ | PROT_WRITE );
+        if (stats == MAP_FAILED) return;
+        if (InterlockedCompareExchangePointer( (void **)&io_stats[entry], stats, NULL ))
+        {
+            munmap( stats, FD_CACHE_BLOCK_SIZE * sizeof(*stats) );
+            stats = io_stats[entry];
+        }
+    }
+    stats += idx;
+
+    switch (type)
+    {
+    case IO_STAT_READ:
+        InterlockedIncrement( &stats->read_ops );
+        InterlockedExchangeAdd64( &stats->read_bytes, bytes );
+        InterlockedExchangeAdd64( &stats->read_time, time );
+        break;
+    case IO_STAT_WRITE:
+        InterlockedIncrement( &stats->write_ops );
+        InterlockedExchangeAdd64( &stats->write_bytes, bytes );
+        InterlockedExchangeAdd64( &stats->write_time, time );
+        break;
+    case IO_STAT_OTHER:
+        InterlockedIncrement( &stats->other_ops );
+        return;
+    case IO_STAT_ZEROCOPY:  /* the write itself is accounted separately */
+        InterlockedExchangeAdd( &stats->zerocopy_ops, bytes );
+        return;
+    }
+    if (async) InterlockedIncrement( &stats->async_ops );
+}
+
+
+/***********************************************************************
+ *           server_get_sock_state
+ *
+ * Return the client-side state of a socket handle, optionally allocating it.
+ */
+LONG *server_get_sock_state( HANDLE handle, BOOL create )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    LONG *states;
+
+    if (entry >= FD_CACHE_ENTRIES) return NULL;
+    if (!(states = sock_states[entry]))  /* allocate a new block of states */
+    {
+        if (!create) return NULL;
+        states = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * sizeof(*states), PROT_READ | PROT_WRITE );
+        if (states == MAP_FAILED) return NULL;
+        if (InterlockedCompareExchangePointer( (void **)&sock_states[entry], states, NULL ))
+        {
+            munmap( states, FD_CACHE_BLOCK_SIZE * sizeof(*states) );
+            states = sock_states[entry];
+        }
+    }
+    return states + idx;
+}
+
+
+/***********************************************************************
+ *           server_clear_sock_states
+ *
+ * Clear the given flags in the state of all socket handles.
+ */
+void server_clear_sock_states( LONG mask )
+{
+    unsigned int entry, idx;
+
+    for (entry = 0; entry < FD_CACHE_ENTRIES; entry++)
+    {
+        if (!sock_states[entry]) continue;
+        for (idx = 0; idx < FD_CACHE_BLOCK_SIZE; idx++)
+            if (ReadNoFence( &sock_states[entry][idx] ) & mask)
+                InterlockedAnd( &sock_states[entry][idx], ~mask );
+    }
+}
+
+
+/***********************************************************************
+ *           server_get_io_counters
+ */
+void server_get_io_counters( IO_COUNTERS *counters )
+{
+    counters->ReadOperationCount  = InterlockedCompareExchange64( (LONG64 *)&io_counters.ReadOperationCount, 0, 0 );
+    counters->WriteOperationCount = InterlockedCompareExchange64( (LONG64 *)&io_counters.WriteOperationCount, 0, 0 );
+    counters->OtherOperationCount = InterlockedCompareExchange64( (LONG64 *)&io_counters.OtherOperationCount, 0, 0 );
+    counters->ReadTransferCount   = InterlockedCompareExchange64( (LONG64 *)&io_counters.ReadTransferCount, 0, 0 );
+    counters->WriteTransferCount  = InterlockedCompareExchange64( (LONG64 *)&io_counters.WriteTransferCount, 0, 0 );
+    counters->OtherTransferCount  = InterlockedCompareExchange64( (LONG64 *)&io_counters.OtherTransferCount, 0, 0 );
+}
+
+
+/***********************************************************************
+ *           server_get_handle_io
+ *
+ * Retrieve the statistics of the first handle after the given one that did some reads or writes.
+ */
+BOOL server_get_handle_io( HANDLE prev, PROCESS_WINE_HANDLE_IO_INFORMATION *info )
+{
+    unsigned int entry, idx = wine_server_obj_handle( prev ) >> 2;  /* index of the next handle */
+    struct handle_io_stats *stats;
+
+    for (entry = idx / FD_CACHE_BLOCK_SIZE, idx %= FD_CACHE_BLOCK_SIZE; entry < FD_CACHE_ENTRIES; entry++, idx = 0)
+    {
+        if (!(stats = io_stats[entry])) continue;
+        for (; idx < FD_CACHE_BLOCK_SIZE; idx++)
+        {
+            if (!ReadNoFence( &stats[idx].read_ops ) && !ReadNoFence( &stats[idx].write_ops )) continue;
+            info->Handle              = (entry * FD_CACHE_BLOCK_SIZE + idx + 1) << 2;
+            info->ReadTransferCount   = InterlockedCompareExchange64( &stats[idx].read_bytes, 0, 0 );
+            info->WriteTransferCount  = InterlockedCompareExchange64( &stats[idx].write_bytes, 0, 0 );
+            info->ReadTime            = InterlockedCompareExchange64( &stats[idx].read_time, 0, 0 );
+            info->WriteTime           = InterlockedCompareExchange64( &stats[idx].write_time, 0, 0 );
+            info->ReadOperationCount  = ReadNoFence( &stats[idx].read_ops );
+            info->WriteOperationCount = ReadNoFence( &stats[idx].write_ops );
+            info->AsyncOperationCount = ReadNoFence( &stats[idx].async_ops );
+            info->ZeroCopyOperationCount = ReadNoFence( &stats[idx].zerocopy_ops );
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+
 /***********************************************************************
  *           server_get_unix_fd
  *
@@ -1127,6 +1507,7 @@ int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
     ret = get_cached_fd( handle, &fd, type, &access, options );
     if (ret == STATUS_INVALID_HANDLE)
     {
+        fd_cache_misses++;
         SERVER_START_REQ( get_handle_fd )
         {
             req->handle = wine_server_obj_handle( handle );
@@ -1139,17 +1520,20 @@ int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                 {
                     assert( wine_server_ptr_handle(fd_handle) == handle );
                     *needs_close = (!reply->cacheable ||
-                                    !add_fd_to_cache( handle, fd, reply->type,
-                                                      reply->access, reply->options ));
+                                    !add_fd_to_cache( handle, fd, reply->type, reply->access,
+                                                      reply->sharing, reply->options ));
+                    if (*needs_close) fd_cache_uncached++;
                 }
                 else ret = STATUS_TOO_MANY_OPENED_FILES;
             }
             else if (reply->cacheable)
             {
-                add_fd_to_cache( handle, ret, FD_TYPE_INVALID, 0, 0 );
+                add_fd_to_cache( handle, ret, FD_TYPE_INVALID, 0, 0, 0 );
             }
         }
         SERVER_END_REQ;
+        TRACE( "handle %p not cached, %u misses, %u uncacheable\n",
+               handle, fd_cache_misses, fd_cache_uncached );
     }
     server_leave_uninterrupted_section( &fd_cache_mutex, &sigset );
 
@@ -1792,6 +2176,12 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source, HANDLE
         return result.dup_handle.status;
     }
 
+    /* a timer armed in-process can't be shared */
+    if (do_fsync() && source_process == NtCurrentProcess())
+        fsync_release_timers( 1, &source );
+    /* neither can a socket that bypasses the server for receives */
+    if (source_process == NtCurrentProcess()) sock_release_direct_recv( source );
+
     server_enter_uninterrupted_section( &fd_cache_mutex, &sigset );
 
     /* always remove the cached fd; if the server request fails we'll just
@@ -28,6 +28,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#ifdef HAVE_SYS_SENDFILE_H
+# include <sys/sendfile.h>
+#endif
 #include <unistd.h>
 #ifdef HAVE_IFADDRS_H
 # include <ifaddrs.h>
@@ -108,6 +111,17 @@ union unix_sockaddr
 #endif
 };
 
+/* a pending datagram receive or send, which a batched call made for another async of the same
+ * socket can complete; protected by sock_batch_mutex */
+struct sock_batch_entry
+{
+    struct list  entry;         /* entry in recv_batch_list or send_batch_list */
+    BOOL         queued;        /* the entry is in one of the lists */
+    BOOL         done;          /* the I/O was done by a batched call */
+    unsigned int status;        /* result of the batched call */
+    ULONG_PTR    size;          /* size transferred by the batched call */
+};
+
 struct async_recv_ioctl
 {
     struct async_fileio io;
@@ -118,6 +132,9 @@ struct async_recv_ioctl
     int unix_flags;
     unsigned int count;
     BOOL icmp_over_dgram;
+    BOOL batchable;             /* can be received together with other datagrams */
+    struct sock_batch_entry batch;
+    int queued_gen;             /* handle generation the receive is counted in, or -1 */
     struct iovec iov[1];
 };
 
@@ -127,9 +144,15 @@ struct async_send_ioctl
     const struct WS_sockaddr *addr;
     int addr_len;
     int unix_flags;
+    int sock_type;
+    BOOL batchable;             /* can be sent together with other datagrams */
+    BOOL zerocopy;              /* let the kernel send from the user buffers */
+    BOOL zerocopy_wait;         /* parked until the kernel released the buffers */
+    unsigned int zerocopy_sends; /* number of sendmsg() calls done with MSG_ZEROCOPY */
     unsigned int sent_len;
     unsigned int count;
     unsigned int iov_cursor;
+    struct sock_batch_entry batch;
     struct iovec iov[1];
 };
 
@@ -151,6 +174,7 @@ struct async_transmit_ioctl
     unsigned int head_len;
     unsigned int tail_len;
     LARGE_INTEGER offset;
+    BOOL use_sendfile;          /* file data can be sent directly from the page cache */
 };
 
 static int get_sock_type( HANDLE handle );
@@ -812,6 +836,230 @@ static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *siz
     return status;
 }
 
+/* maximum number of datagrams transferred by one batched call */
+#define SOCK_BATCH_MAX 16
+
+static pthread_mutex_t sock_batch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct list recv_batch_list = LIST_INIT( recv_batch_list );
+static struct list send_batch_list = LIST_INIT( send_batch_list );
+
+/* add a pending async to a batch list; signals must be blocked since the server request
+ * that queued the async, so that its callback can't run before it is added */
+static void add_sock_batch_entry( struct list *list, struct sock_batch_entry *batch )
+{
+    sigset_t sigset;
+
+    server_enter_uninterrupted_section( &sock_batch_mutex, &sigset );
+    list_add_tail( list, &batch->entry );
+    batch->queued = TRUE;
+    server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+}
+
+static void remove_sock_batch_entry( struct sock_batch_entry *batch )
+{
+    sigset_t sigset;
+
+    if (!batch->queued) return;
+    server_enter_uninterrupted_section( &sock_batch_mutex, &sigset );
+    list_remove( &batch->entry );
+    batch->queued = FALSE;
+    server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+}
+
+/* retrieve the result of an async whose I/O was done by a batched call, if any */
+static BOOL get_sock_batch_result( struct sock_batch_entry *batch, ULONG_PTR *size, unsigned int *status )
+{
+    sigset_t sigset;
+    BOOL ret;
+
+    if (!batch->queued) return FALSE;
+    server_enter_uninterrupted_section( &sock_batch_mutex, &sigset );
+    if ((ret = batch->done))
+    {
+        *size = batch->size;
+        *status = batch->status;
+    }
+    server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+    return ret;
+}
+
+/* let the server complete the asyncs whose I/O was done by a batched call */
+static void alert_sock_batch( HANDLE handle, const client_ptr_t *users, unsigned int count, BOOL write )
+{
+    SERVER_START_REQ( alert_socket_asyncs )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        req->write  = write;
+        wine_server_add_data( req, users, count * sizeof(*users) );
+        if (wine_server_call( req ))
+            WARN( "alert_socket_asyncs failed.\n" );
+    }
+    SERVER_END_REQ;
+}
+
+#ifdef HAVE_RECVMMSG
+/* receive a datagram for an alerted async, and at the same time for the other asyncs
+ * pending on the same socket, which the server would only wake up one by one */
+static NTSTATUS try_recv_batch( int fd, struct async_recv_ioctl *async, ULONG_PTR *size )
+{
+    struct async_recv_ioctl *batch[SOCK_BATCH_MAX], *other;
+    union unix_sockaddr unix_addr[SOCK_BATCH_MAX];
+    struct mmsghdr msgs[SOCK_BATCH_MAX];
+    client_ptr_t users[SOCK_BATCH_MAX];
+    unsigned int i, count = 0, alerts = 0, status = STATUS_SUCCESS;
+    sigset_t sigset;
+    int ret;
+
+    server_enter_uninterrupted_section( &sock_batch_mutex, &sigset );
+
+    if (async->batch.done)
+    {
+        *size = async->batch.size;
+        status = async->batch.status;
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        return status;
+    }
+
+    batch[count++] = async;
+    LIST_FOR_EACH_ENTRY( other, &recv_batch_list, struct async_recv_ioctl, batch.entry )
+    {
+        if (count == SOCK_BATCH_MAX) break;
+        if (other == async || other->batch.done || other->io.handle != async->io.handle) continue;
+        batch[count++] = other;
+    }
+
+    if (count == 1)
+    {
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        return try_recv( fd, async, size );
+    }
+
+    memset( msgs, 0, count * sizeof(*msgs) );
+    for (i = 0; i < count; i++)
+    {
+        if (batch[i]->addr)
+        {
+            msgs[i].msg_hdr.msg_name = &unix_addr[i].addr;
+            msgs[i].msg_hdr.msg_namelen = sizeof(unix_addr[i]);
+        }
+        msgs[i].msg_hdr.msg_iov = batch[i]->iov;
+        msgs[i].msg_hdr.msg_iovlen = batch[i]->count;
+    }
+    while ((ret = recvmmsg( fd, msgs, count, 0, NULL )) < 0 && errno == EINTR);
+
+    if (ret <= 0)
+    {
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        /* let try_recv() deal with errors, and with buffers that need write watches updated */
+        if (ret < 0 && errno == EWOULDBLOCK) return STATUS_DEVICE_NOT_READY;
+        return try_recv( fd, async, size );
+    }
+
+    TRACE( "received %d datagrams for %u asyncs\n", ret, count );
+
+    for (i = 0; i < ret; i++)
+    {
+        struct async_recv_ioctl *cur = batch[i];
+        unsigned int res = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? STATUS_BUFFER_OVERFLOW : STATUS_SUCCESS;
+
+        if (cur->addr && msgs[i].msg_hdr.msg_namelen)
+            *cur->addr_len = sockaddr_from_unix( &unix_addr[i], cur->addr, *cur->addr_len );
+
+        if (cur == async)
+        {
+            *size = msgs[i].msg_len;
+            status = res;
+            continue;
+        }
+        cur->batch.done = TRUE;
+        cur->batch.status = res;
+        cur->batch.size = msgs[i].msg_len;
+        users[alerts++] = wine_server_client_ptr( &cur->io );
+    }
+
+    server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+
+    if (alerts) alert_sock_batch( async->io.handle, users, alerts, FALSE );
+    return status;
+}
+#endif
+
+/* Direct receives: once the server tells us nobody else can queue receives on or watch
+ * a socket, receives which can be satisfied right away bypass it while we have none queued. */
+static LONG sock_direct_epoch;  /* bumped whenever a socket may become shared */
+
+static BOOL do_direct_recv(void)
+{
+    static int do_direct_recv_cached = -1;
+
+    if (do_direct_recv_cached == -1)
+        do_direct_recv_cached = getenv( "WINE_SOCK_DIRECT_RECV" ) && atoi( getenv( "WINE_SOCK_DIRECT_RECV" ) );
+    return do_direct_recv_cached;
+}
+
+/* return the direct receive flags of a socket with nothing queued, or 0 */
+static LONG get_sock_direct_flags( HANDLE handle )
+{
+    LONG *state, val;
+
+    if (!do_direct_recv() || !(state = server_get_sock_state( handle, FALSE ))) return 0;
+    val = ReadNoFence( state );
+    if (!(val & SOCK_STATE_DIRECT) || (val & SOCK_STATE_QUEUED)) return 0;
+    return val & (SOCK_STATE_DIRECT | SOCK_STATE_COMPLETION);
+}
+
+/* count a receive about to be queued on the server, returning the handle generation */
+static int sock_recv_queued( HANDLE handle )
+{
+    LONG *state;
+
+    if (!do_direct_recv() || !(state = server_get_sock_state( handle, TRUE ))) return -1;
+    return (ULONG)InterlockedIncrement( state ) >> SOCK_STATE_GEN_SHIFT;
+}
+
+static void sock_recv_dequeued( HANDLE handle, int gen )
+{
+    LONG *state, val, prev;
+
+    if (gen == -1 || !(state = server_get_sock_state( handle, FALSE ))) return;
+    for (val = ReadNoFence( state ); ; val = prev)
+    {
+        if ((int)((ULONG)val >> SOCK_STATE_GEN_SHIFT) != gen || !(val & SOCK_STATE_QUEUED)) return;
+        if ((prev = InterlockedCompareExchange( state, val - 1, val )) == val) return;
+    }
+}
+
+static void sock_set_direct_flags( HANDLE handle, int gen, LONG epoch, LONG flags )
+{
+    LONG *state, val, prev;
+
+    if (gen == -1 || !(state = server_get_sock_state( handle, FALSE ))) return;
+    for (val = ReadNoFence( state ); ; val = prev)
+    {
+        if ((int)((ULONG)val >> SOCK_STATE_GEN_SHIFT) != gen) return;
+        prev = InterlockedCompareExchange( state, (val & ~(SOCK_STATE_DIRECT | SOCK_STATE_COMPLETION)) | flags, val );
+        if (prev == val) break;
+    }
+    /* the socket may have been shared while we were talking to the server */
+    if ((flags & SOCK_STATE_DIRECT) && ReadNoFence( &sock_direct_epoch ) != epoch)
+        InterlockedAnd( state, ~SOCK_STATE_DIRECT );
+}
+
+/***********************************************************************
+ *           sock_release_direct_recv
+ *
+ * Go back to receiving through the server on a socket, or on all of them if handle is NULL.
+ */
+void sock_release_direct_recv( HANDLE handle )
+{
+    LONG *state;
+
+    if (!do_direct_recv()) return;
+    InterlockedIncrement( &sock_direct_epoch );
+    if (!handle) server_clear_sock_states( SOCK_STATE_DIRECT );
+    else if ((state = server_get_sock_state( handle, FALSE ))) InterlockedAnd( state, ~SOCK_STATE_DIRECT );
+}
+
 static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
 {
     struct async_recv_ioctl *async = user;
@@ -819,34 +1067,66 @@ static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
 
     TRACE( "%#x\n", *status );
 
-    if (*status == STATUS_ALERTED)
+    /* the datagram may already have been received on our behalf */
+    if (get_sock_batch_result( &async->batch, info, status ))
+        TRACE( "got batched status %#x, %#lx bytes read\n", *status, *info );
+    else if (*status == STATUS_ALERTED)
     {
         if ((*status = server_get_unix_fd( async->io.handle, 0, &fd, &needs_close, NULL, NULL )))
+        {
+            remove_sock_batch_entry( &async->batch );
+            sock_recv_dequeued( async->io.handle, async->queued_gen );
             return TRUE;
+        }
 
-        *status = try_recv( fd, async, info );
+#ifdef HAVE_RECVMMSG
+        if (async->batch.queued)
+            *status = try_recv_batch( fd, async, info );
+        else
+#endif
+            *status = try_recv( fd, async, info );
         TRACE( "got status %#x, %#lx bytes read\n", *status, *info );
         if (needs_close) close( fd );
 
         if (*status == STATUS_DEVICE_NOT_READY)
             return FALSE;
     }
+    remove_sock_batch_entry( &async->batch );
+    sock_recv_dequeued( async->io.handle, async->queued_gen );
+    if (!NT_ERROR(*status)) server_record_io( async->io.handle, IO_STAT_READ, *info, async->io.start, TRUE );
     release_fileio( &async->io );
     return TRUE;
 }
 
-static BOOL is_icmp_over_dgram( int fd )
+/* retrieve the protocol of a socket, or 0 if it can't be determined */
+static int get_sock_protocol( int fd )
 {
-#ifdef linux
-    socklen_t len;
+#ifdef SO_PROTOCOL
+    socklen_t len = sizeof(int);
     int val;
 
-    len = sizeof(val);
-    if (getsockopt( fd, SOL_SOCKET, SO_PROTOCOL, (char *)&val, &len ) || val != IPPROTO_ICMP)
-        return FALSE;
+    if (!getsockopt( fd, SOL_SOCKET, SO_PROTOCOL, (char *)&val, &len )) return val;
+#endif
+    return 0;
+}
 
-    len = sizeof(val);
-    return !getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&val, &len ) && val == SOCK_DGRAM;
+static int get_sock_fd_type( int fd, int protocol )
+{
+    socklen_t len = sizeof(int);
+    int val;
+
+    /* UDP sockets are always message based, no need to ask */
+    if (protocol == IPPROTO_UDP) return SOCK_DGRAM;
+    if (getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&val, &len )) return -1;
+    return val;
+}
+
+static BOOL is_icmp_over_dgram( int fd, int protocol, int type )
+{
+#ifdef linux
+    if (protocol != IPPROTO_ICMP) return FALSE;
+    if (type == -1) type = get_sock_fd_type( fd, protocol );
+    return type == SOCK_DGRAM;
 #else
     return FALSE;
 #endif
@@ -858,6 +1138,9 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     HANDLE wait_handle;
     BOOL nonblocking;
     unsigned int i, status;
+    LONG direct, epoch;
+    int protocol;
+    sigset_t sigset;
     ULONG options;
 
     for (i = 0; i < async->count; ++i)
@@ -869,6 +1152,44 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         }
     }
 
+    protocol = get_sock_protocol( fd );
+    async->icmp_over_dgram = is_icmp_over_dgram( fd, protocol, -1 );
+#ifdef HAVE_RECVMMSG
+    async->batchable = protocol == IPPROTO_UDP && !async->unix_flags && !async->control;
+#else
+    async->batchable = FALSE;
+#endif
+    async->batch.queued = async->batch.done = FALSE;
+    async->queued_gen = -1;
+
+    if (!(async->unix_flags & MSG_OOB) && (direct = get_sock_direct_flags( handle )))
+    {
+        ULONG_PTR information = 0;
+
+        status = try_recv( fd, async, &information );
+        /* an empty stream read may be hiding a reset the server already consumed */
+        if (status != STATUS_DEVICE_NOT_READY && (information || protocol == IPPROTO_UDP || NT_ERROR(status)))
+        {
+            if (!NT_ERROR(status))
+            {
+                io->Status = status;
+                io->Information = information;
+                server_record_io( handle, IO_STAT_READ, information, async->io.start, FALSE );
+                if (event) NtSetEvent( event, NULL );
+                if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_client_ptr(io), 0 );
+                else if (apc_user && (direct & SOCK_STATE_COMPLETION))
+                    add_completion( handle, (ULONG_PTR)apc_user, status, information, FALSE );
+            }
+            release_fileio( &async->io );
+            return status;
+        }
+    }
+
+    epoch = ReadNoFence( &sock_direct_epoch );
+    async->queued_gen = sock_recv_queued( handle );
+
+    if (async->batchable) pthread_sigmask( SIG_BLOCK, &server_block_set, &sigset );
+
     SERVER_START_REQ( recv_socket )
     {
         req->force_async = force_async;
@@ -878,6 +1199,7 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         wait_handle = wine_server_ptr_handle( reply->wait );
         options     = reply->options;
         nonblocking = reply->nonblocking;
+        direct      = reply->direct ? SOCK_STATE_DIRECT | (reply->completion ? SOCK_STATE_COMPLETION : 0) : 0;
     }
     SERVER_END_REQ;
 
@@ -895,10 +1217,20 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         {
             io->Status = status;
             io->Information = information;
+            server_record_io( handle, IO_STAT_READ, information, async->io.start, FALSE );
         }
         set_async_direct_result( &wait_handle, status, information, FALSE );
     }
 
+    if (async->batchable)
+    {
+        if (status == STATUS_PENDING) add_sock_batch_entry( &recv_batch_list, &async->batch );
+        pthread_sigmask( SIG_SETMASK, &sigset, NULL );
+    }
+
+    sock_set_direct_flags( handle, async->queued_gen, epoch, NT_ERROR(status) ? 0 : direct );
+    if (status != STATUS_PENDING) sock_recv_dequeued( handle, async->queued_gen );
+
     if (status != STATUS_PENDING)
         release_fileio( &async->io );
 
@@ -954,7 +1286,6 @@ static NTSTATUS sock_ioctl_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     async->addr = addr;
     async->addr_len = addr_len;
     async->ret_flags = ret_flags;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, force_async );
 }
@@ -977,7 +1308,6 @@ NTSTATUS sock_read( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc,
     async->addr = NULL;
     async->addr_len = NULL;
     async->ret_flags = NULL;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, 1 );
 }
@@ -987,15 +1317,15 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
 {
     union unix_sockaddr unix_addr;
     struct msghdr hdr;
-    int attempt = 0;
-    int sock_type;
-    socklen_t len = sizeof(sock_type);
+    int attempt = 0, flags = async->unix_flags;
     ssize_t ret;
 
-    getsockopt(fd, SOL_SOCKET, SO_TYPE, &sock_type, &len);
+#ifdef MSG_ZEROCOPY
+    if (async->zerocopy) flags |= MSG_ZEROCOPY;
+#endif
 
     memset( &hdr, 0, sizeof(hdr) );
-    if (async->addr && sock_type != SOCK_STREAM)
+    if (async->addr && async->sock_type != SOCK_STREAM)
     {
         hdr.msg_name = &unix_addr;
         hdr.msg_namelen = sockaddr_to_unix( async->addr, async->addr_len, &unix_addr );
@@ -1026,13 +1356,20 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
     hdr.msg_iov = async->iov + async->iov_cursor;
     hdr.msg_iovlen = async->count - async->iov_cursor;
 
-    while ((ret = sendmsg( fd, &hdr, async->unix_flags )) == -1)
+    while ((ret = sendmsg( fd, &hdr, flags )) == -1)
     {
         if (errno == EISCONN)
         {
             hdr.msg_name = NULL;
             hdr.msg_namelen = 0;
         }
+#ifdef MSG_ZEROCOPY
+        else if (errno == ENOBUFS && (flags & MSG_ZEROCOPY))
+        {
+            /* the pages could not be pinned, copy them instead */
+            flags &= ~MSG_ZEROCOPY;
+        }
+#endif
         else if (errno != EINTR)
         {
             if (errno != EWOULDBLOCK) WARN( "sendmsg: %s\n", strerror( errno ) );
@@ -1051,6 +1388,9 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
         }
     }
 
+#ifdef MSG_ZEROCOPY
+    if (flags & MSG_ZEROCOPY) async->zerocopy_sends++;
+#endif
     async->sent_len += ret;
 
     while (async->iov_cursor < async->count && ret >= async->iov[async->iov_cursor].iov_len)
@@ -1064,6 +1404,83 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
     return STATUS_SUCCESS;
 }
 
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+/* Zero-copy sends: large stream sends let the kernel send from the user buffers, and
+ * only complete once the server got the kernel notification that it released them. */
+static pthread_mutex_t zerocopy_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int get_zerocopy_threshold(void)
+{
+    static int zerocopy_threshold_cached = -1;
+
+    if (zerocopy_threshold_cached == -1)
+    {
+        const char *env = getenv( "WINE_SOCK_ZEROCOPY_THRESHOLD" );
+        zerocopy_threshold_cached = env ? max( atoi( env ), 0 ) : 0;
+    }
+    return zerocopy_threshold_cached;
+}
+
+static BOOL sock_use_zerocopy( int fd, int protocol, const struct async_send_ioctl *async )
+{
+    unsigned int threshold = get_zerocopy_threshold(), i;
+    SIZE_T len = 0;
+    int one = 1;
+
+    if (!threshold || protocol != IPPROTO_TCP || (async->unix_flags & MSG_OOB)) return FALSE;
+    for (i = 0; i < async->count; i++) len += async->iov[i].iov_len;
+    if (len < threshold) return FALSE;
+    return !setsockopt( fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one) );
+}
+
+/* send with MSG_ZEROCOPY and report the sends to the server, which numbers them like the
+ * kernel does; returns STATUS_PENDING if the completed send has to wait for its buffers */
+static NTSTATUS try_send_zerocopy( int fd, struct async_send_ioctl *async )
+{
+    unsigned int status, prev = async->zerocopy_sends;
+    sigset_t sigset;
+
+    server_enter_uninterrupted_section( &zerocopy_mutex, &sigset );
+
+    status = try_send( fd, async );
+    if (async->zerocopy_sends != prev || (status == STATUS_SUCCESS && async->zerocopy_sends))
+    {
+        SERVER_START_REQ( socket_wait_zerocopy )
+        {
+            req->handle = wine_server_obj_handle( async->io.handle );
+            req->user   = status == STATUS_SUCCESS ? wine_server_client_ptr( &async->io ) : 0;
+            req->count  = async->zerocopy_sends - prev;
+            if (!wine_server_call( req ) && reply->wait)
+            {
+                async->zerocopy_wait = TRUE;
+                status = STATUS_PENDING;
+            }
+        }
+        SERVER_END_REQ;
+    }
+
+    server_leave_uninterrupted_section( &zerocopy_mutex, &sigset );
+
+    if (async->zerocopy_sends != prev)
+        server_record_io( async->io.handle, IO_STAT_ZEROCOPY, async->zerocopy_sends - prev, 0, FALSE );
+    return status;
+}
+
+#else
+
+static BOOL sock_use_zerocopy( int fd, int protocol, const struct async_send_ioctl *async )
+{
+    return FALSE;
+}
+
+static NTSTATUS try_send_zerocopy( int fd, struct async_send_ioctl *async )
+{
+    return try_send( fd, async );
+}
+
+#endif
+
 static void hack_update_status( HANDLE handle, unsigned int *status )
 {
     /* HACK: VRChat relies on send() reporting STATUS_SUCCESS for dropped UDP sockets when the
@@ -1079,6 +1496,89 @@ static void hack_update_status( HANDLE handle, unsigned int *status )
     }
 }
 
+#ifdef HAVE_SENDMMSG
+/* send the datagram of an alerted async, together with the datagrams of the other asyncs
+ * pending on the same socket */
+static NTSTATUS try_send_batch( int fd, struct async_send_ioctl *async )
+{
+    struct async_send_ioctl *batch[SOCK_BATCH_MAX], *other;
+    union unix_sockaddr unix_addr[SOCK_BATCH_MAX];
+    struct mmsghdr msgs[SOCK_BATCH_MAX];
+    client_ptr_t users[SOCK_BATCH_MAX];
+    unsigned int i, count = 0, alerts = 0;
+    sigset_t sigset;
+    int ret;
+
+    server_enter_uninterrupted_section( &sock_batch_mutex, &sigset );
+
+    if (async->batch.done)
+    {
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        return async->batch.status;
+    }
+
+    memset( msgs, 0, sizeof(msgs) );
+    batch[count++] = async;
+    LIST_FOR_EACH_ENTRY( other, &send_batch_list, struct async_send_ioctl, batch.entry )
+    {
+        if (count == SOCK_BATCH_MAX) break;
+        if (other == async || other->batch.done || other->io.handle != async->io.handle) continue;
+        batch[count++] = other;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (!batch[i]->addr) continue;
+        msgs[i].msg_hdr.msg_name = &unix_addr[i];
+        msgs[i].msg_hdr.msg_namelen = sockaddr_to_unix( batch[i]->addr, batch[i]->addr_len, &unix_addr[i] );
+        /* leave invalid addresses to try_send() */
+        if (!msgs[i].msg_hdr.msg_namelen) break;
+    }
+    count = i;
+
+    if (count <= 1)
+    {
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        return try_send( fd, async );
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        msgs[i].msg_hdr.msg_iov = batch[i]->iov;
+        msgs[i].msg_hdr.msg_iovlen = batch[i]->count;
+    }
+    while ((ret = sendmmsg( fd, msgs, count, 0 )) < 0 && errno == EINTR);
+
+    if (ret <= 0)
+    {
+        server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+        /* let try_send() deal with errors */
+        if (ret < 0 && errno == EWOULDBLOCK) return STATUS_DEVICE_NOT_READY;
+        return try_send( fd, async );
+    }
+
+    TRACE( "sent %d datagrams for %u asyncs\n", ret, count );
+
+    /* the first message is our own */
+    async->sent_len = msgs[0].msg_len;
+    async->iov_cursor = async->count;
+    for (i = 1; i < ret; i++)
+    {
+        other = batch[i];
+        other->sent_len = msgs[i].msg_len;
+        other->iov_cursor = other->count;
+        other->batch.done = TRUE;
+        other->batch.status = STATUS_SUCCESS;
+        users[alerts++] = wine_server_client_ptr( &other->io );
+    }
+
+    server_leave_uninterrupted_section( &sock_batch_mutex, &sigset );
+
+    if (alerts) alert_sock_batch( async->io.handle, users, alerts, TRUE );
+    return STATUS_SUCCESS;
+}
+#endif
+
 static BOOL async_send_proc( void *user, ULONG_PTR *info, unsigned int *status )
 {
     struct async_send_ioctl *async = user;
@@ -1086,21 +1586,39 @@ static BOOL async_send_proc( void *user, ULONG_PTR *info, unsigned int *status )
 
     TRACE( "%#x\n", *status );
 
-    if (*status == STATUS_ALERTED)
+    /* the datagram may already have been sent on our behalf */
+    if (get_sock_batch_result( &async->batch, info, status ))
+        TRACE( "got batched status %#x\n", *status );
+    else if (*status == STATUS_ALERTED && async->zerocopy_wait)
+        *status = STATUS_SUCCESS;  /* the kernel released the buffers */
+    else if (*status == STATUS_ALERTED)
     {
         if ((*status = server_get_unix_fd( async->io.handle, 0, &fd, &needs_close, NULL, NULL )))
+        {
+            remove_sock_batch_entry( &async->batch );
             return TRUE;
+        }
 
-        *status = try_send( fd, async );
+#ifdef HAVE_SENDMMSG
+        if (async->batch.queued)
+            *status = try_send_batch( fd, async );
+        else
+#endif
+        if (async->zerocopy)
+            *status = try_send_zerocopy( fd, async );
+        else
+            *status = try_send( fd, async );
         TRACE( "got status %#x\n", *status );
         hack_update_status( async->io.handle, status );
 
         if (needs_close) close( fd );
 
-        if (*status == STATUS_DEVICE_NOT_READY)
+        if (*status == STATUS_DEVICE_NOT_READY || *status == STATUS_PENDING)
             return FALSE;
     }
+    remove_sock_batch_entry( &async->batch );
     *info = async->sent_len;
+    if (!NT_ERROR(*status)) server_record_io( async->io.handle, IO_STAT_WRITE, *info, async->io.start, TRUE );
     release_fileio( &async->io );
     return TRUE;
 }
@@ -1136,8 +1654,23 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     HANDLE wait_handle;
     BOOL nonblocking;
     unsigned int status;
+    int protocol;
+    sigset_t sigset;
     ULONG options;
 
+    protocol = get_sock_protocol( fd );
+    async->sock_type = get_sock_fd_type( fd, protocol );
+#ifdef HAVE_SENDMMSG
+    async->batchable = protocol == IPPROTO_UDP && !async->unix_flags;
+#else
+    async->batchable = FALSE;
+#endif
+    async->batch.queued = async->batch.done = FALSE;
+    async->zerocopy = async->zerocopy_wait = FALSE;
+    async->zerocopy_sends = 0;
+
+    if (async->batchable) pthread_sigmask( SIG_BLOCK, &server_block_set, &sigset );
+
     SERVER_START_REQ( send_socket )
     {
         req->force_async = force_async;
@@ -1152,14 +1685,21 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     /* the server currently will never succeed immediately */
     assert(status == STATUS_ALERTED || status == STATUS_PENDING || NT_ERROR(status));
 
-    if (!NT_ERROR(status) && is_icmp_over_dgram( fd ))
+    if (!NT_ERROR(status) && is_icmp_over_dgram( fd, protocol, async->sock_type ))
         sock_save_icmp_id( async );
 
+    /* only when the completion may be delayed */
+    if (!NT_ERROR(status) && (force_async || !nonblocking))
+        async->zerocopy = sock_use_zerocopy( fd, protocol, async );
+
     if (status == STATUS_ALERTED)
     {
         ULONG_PTR information;
 
-        status = try_send( fd, async );
+        if (async->zerocopy)
+            status = try_send_zerocopy( fd, async );
+        else
+            status = try_send( fd, async );
         hack_update_status( handle, &status );
 
         if (status == STATUS_DEVICE_NOT_READY && (force_async || !nonblocking))
@@ -1177,11 +1717,18 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         {
             io->Status = status;
             io->Information = information;
+            server_record_io( handle, IO_STAT_WRITE, information, async->io.start, FALSE );
         }
 
         set_async_direct_result( &wait_handle, status, information, FALSE );
     }
 
+    if (async->batchable)
+    {
+        if (status == STATUS_PENDING) add_sock_batch_entry( &send_batch_list, &async->batch );
+        pthread_sigmask( SIG_SETMASK, &sigset, NULL );
+    }
+
     if (status != STATUS_PENDING)
         release_fileio( &async->io );
 
@@ -1266,6 +1813,35 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
 {
     ssize_t ret;
 
+    if (!async->file && async->buffer_cursor == async->read_len &&
+        async->head_cursor < async->head_len && async->tail_cursor < async->tail_len)
+    {
+        /* no file data in between, send the header and the tail together */
+        struct iovec iov[2];
+        struct msghdr hdr;
+        size_t head_sent;
+
+        iov[0].iov_base = (char *)async->head + async->head_cursor;
+        iov[0].iov_len = async->head_len - async->head_cursor;
+        iov[1].iov_base = (char *)async->tail + async->tail_cursor;
+        iov[1].iov_len = async->tail_len - async->tail_cursor;
+        memset( &hdr, 0, sizeof(hdr) );
+        hdr.msg_iov = iov;
+        hdr.msg_iovlen = 2;
+
+        TRACE( "sending %zu bytes of header and tail data\n", iov[0].iov_len + iov[1].iov_len );
+        while ((ret = sendmsg( sock_fd, &hdr, 0 )) < 0 && errno == EINTR);
+        if (ret < 0)
+        {
+            if (errno != EWOULDBLOCK) WARN( "sendmsg: %s\n", strerror( errno ) );
+            return sock_errno_to_status( errno );
+        }
+        TRACE( "sendmsg returned %zd\n", ret );
+        head_sent = min( (size_t)ret, iov[0].iov_len );
+        async->head_cursor += head_sent;
+        async->tail_cursor += ret - head_sent;
+    }
+
     while (async->head_cursor < async->head_len)
     {
         TRACE( "sending %u bytes of header data\n", async->head_len - async->head_cursor );
@@ -1276,6 +1852,44 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         async->head_cursor += ret;
     }
 
+#ifdef HAVE_SYS_SENDFILE_H
+    while (async->file && async->use_sendfile)
+    {
+        size_t count = 1 << 30;
+        off_t pos = async->offset.QuadPart;
+
+        if (async->file_len) count = min( count, async->file_len - async->file_cursor );
+        count = min( count, ~0u - async->file_cursor );
+
+        TRACE( "sending %zu bytes of file data with sendfile\n", count );
+        if (async->offset.QuadPart == FILE_USE_FILE_POINTER_POSITION)
+            ret = sendfile( sock_fd, file_fd, NULL, count );
+        else
+            ret = sendfile( sock_fd, file_fd, &pos, count );
+        if (ret < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EWOULDBLOCK) return STATUS_DEVICE_NOT_READY;
+            if ((errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP) && !async->file_cursor)
+            {
+                /* not supported for this file, fall back to reading into the buffer */
+                TRACE( "sendfile failed: %s\n", strerror( errno ) );
+                async->use_sendfile = FALSE;
+                break;
+            }
+            WARN( "sendfile: %s\n", strerror( errno ) );
+            return sock_errno_to_status( errno );
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+
+        async->file_cursor += ret;
+        if (async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            async->offset.QuadPart += ret;
+        if (!ret || (async->file_len && async->file_cursor == async->file_len))
+            async->file = NULL;
+    }
+#endif
+
     while (async->buffer_cursor < async->read_len)
     {
         TRACE( "sending %u bytes of file data\n", async->read_len - async->buffer_cursor );
@@ -1411,6 +2025,16 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     async->tail = u64_to_user_ptr(params->tail_ptr);
     async->tail_len = params->tail_len;
     async->offset = params->offset;
+    async->use_sendfile = FALSE;
+#ifdef HAVE_SYS_SENDFILE_H
+    if (async->file)
+    {
+        int sock_type;
+        socklen_t len = sizeof(sock_type);
+
+        async->use_sendfile = !getsockopt( fd, SOL_SOCKET, SO_TYPE, &sock_type, &len ) && sock_type == SOCK_STREAM;
+    }
+#endif
 
     SERVER_START_REQ( send_socket )
     {
@@ -1521,6 +2145,134 @@ static int get_sock_type( HANDLE handle )
 }
 
 
+/* registered I/O transfers never wait; they are done directly on the unix socket */
+static NTSTATUS try_rio_recv( int fd, const struct afd_rio_params *params, ULONG_PTR *size )
+{
+    union unix_sockaddr unix_addr;
+    struct msghdr hdr;
+    struct iovec iov;
+    ssize_t ret;
+
+    iov.iov_base = u64_to_user_ptr(params->buffer_ptr);
+    iov.iov_len = params->len;
+    memset( &hdr, 0, sizeof(hdr) );
+    if (params->addr_ptr)
+    {
+        hdr.msg_name = &unix_addr.addr;
+        hdr.msg_namelen = sizeof(unix_addr);
+    }
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+
+    while ((ret = virtual_locked_recvmsg( fd, &hdr, MSG_DONTWAIT )) < 0 && errno == EINTR);
+    if (ret < 0)
+    {
+        if (errno != EWOULDBLOCK) WARN( "recvmsg: %s\n", strerror( errno ) );
+        return sock_errno_to_status( errno );
+    }
+
+    if (params->addr_ptr && hdr.msg_namelen)
+        sockaddr_from_unix( &unix_addr, u64_to_user_ptr(params->addr_ptr), params->addr_len );
+    *size = ret;
+    return (hdr.msg_flags & MSG_TRUNC) ? STATUS_BUFFER_OVERFLOW : STATUS_SUCCESS;
+}
+
+static NTSTATUS try_rio_send( int fd, const struct afd_rio_params *params, ULONG_PTR *size )
+{
+    union unix_sockaddr unix_addr;
+    struct msghdr hdr;
+    struct iovec iov;
+    ssize_t ret;
+
+    iov.iov_base = u64_to_user_ptr(params->buffer_ptr);
+    iov.iov_len = params->len;
+    memset( &hdr, 0, sizeof(hdr) );
+    if (params->addr_ptr)
+    {
+        hdr.msg_name = &unix_addr;
+        if (!(hdr.msg_namelen = sockaddr_to_unix( u64_to_user_ptr(params->addr_ptr), params->addr_len, &unix_addr )))
+            return STATUS_INVALID_PARAMETER;
+    }
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+
+    while ((ret = sendmsg( fd, &hdr, MSG_DONTWAIT )) < 0 && errno == EINTR);
+    if (ret < 0 && errno == EISCONN)
+    {
+        hdr.msg_name = NULL;
+        hdr.msg_namelen = 0;
+        while ((ret = sendmsg( fd, &hdr, MSG_DONTWAIT )) < 0 && errno == EINTR);
+    }
+    if (ret < 0)
+    {
+        if (errno != EWOULDBLOCK) WARN( "sendmsg: %s\n", strerror( errno ) );
+        return sock_errno_to_status( errno );
+    }
+
+    *size = ret;
+    return STATUS_SUCCESS;
+}
+
+static BOOL do_direct_accept(void)
+{
+    static int do_direct_accept_cached = -1;
+
+    if (do_direct_accept_cached == -1)
+        do_direct_accept_cached = getenv( "WINE_SOCK_DIRECT_ACCEPT" ) && atoi( getenv( "WINE_SOCK_DIRECT_ACCEPT" ) );
+    return do_direct_accept_cached;
+}
+
+static BOOL do_reuseport(void)
+{
+    static int do_reuseport_cached = -1;
+
+    if (do_reuseport_cached == -1)
+        do_reuseport_cached = getenv( "WINE_SOCK_REUSEPORT" ) && atoi( getenv( "WINE_SOCK_REUSEPORT" ) );
+    return do_reuseport_cached;
+}
+
+/* Accept a waiting connection on the listener's fd, without the server polling it for us,
+ * and hand it to the server, which completes the request as if it had accepted it. */
+static NTSTATUS try_direct_accept( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                                   IO_STATUS_BLOCK *io, UINT code, const void *in_buffer, UINT in_size,
+                                   void *out_buffer, UINT out_size )
+{
+    struct afd_accept_fd_params params = {0};
+    int fd, needs_close, acceptfd;
+    NTSTATUS status;
+
+    if (!do_direct_accept()) return STATUS_BAD_DEVICE_TYPE;
+
+    if (code == IOCTL_AFD_WINE_ACCEPT_INTO)
+    {
+        const struct afd_accept_into_params *into = in_buffer;
+
+        /* waiting for the first data is left to the server */
+        if (in_size != sizeof(*into) || into->recv_len) return STATUS_BAD_DEVICE_TYPE;
+        params.accept_handle = into->accept_handle;
+        params.local_len = into->local_len;
+    }
+
+    if (server_get_unix_fd( handle, 0, &fd, &needs_close, NULL, NULL )) return STATUS_BAD_DEVICE_TYPE;
+#ifdef HAVE_ACCEPT4
+    while ((acceptfd = accept4( fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC )) < 0 && errno == EINTR);
+#else
+    while ((acceptfd = accept( fd, NULL, NULL )) < 0 && errno == EINTR);
+    if (acceptfd != -1) fcntl( acceptfd, F_SETFL, O_NONBLOCK );
+#endif
+    if (needs_close) close( fd );
+    /* nothing waiting, or an error the server will report */
+    if (acceptfd == -1) return STATUS_BAD_DEVICE_TYPE;
+
+    TRACE( "accepted fd %d on %p\n", acceptfd, handle );
+    params.fd = acceptfd;
+    wine_server_send_fd( acceptfd );
+    status = NtDeviceIoControlFile( handle, event, apc, apc_user, io, IOCTL_AFD_WINE_ACCEPT_FD,
+                                    &params, sizeof(params), out_buffer, out_size );
+    close( acceptfd );
+    return status;
+}
+
 NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user, IO_STATUS_BLOCK *io,
                      UINT code, void *in_buffer, UINT in_size, void *out_buffer, UINT out_size )
 {
@@ -1786,6 +2538,35 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
             return STATUS_SUCCESS;
         }
 
+        case IOCTL_AFD_WINE_RIO_RECV:
+        case IOCTL_AFD_WINE_RIO_SEND:
+        {
+            const struct afd_rio_params *params = in_buffer;
+            ULONG_PTR size = 0;
+
+            if (in_size < sizeof(*params))
+            {
+                status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            if ((status = server_get_unix_fd( handle, 0, &fd, &needs_close, NULL, NULL )))
+                return status;
+
+            if (code == IOCTL_AFD_WINE_RIO_RECV)
+                status = try_rio_recv( fd, params, &size );
+            else
+                status = try_rio_send( fd, params, &size );
+
+            if (!NT_ERROR(status))
+            {
+                io->Information = size;
+                server_record_io( handle, code == IOCTL_AFD_WINE_RIO_RECV ? IO_STAT_READ : IO_STAT_WRITE,
+                                  size, 0, FALSE );
+            }
+            break;
+        }
+
         case IOCTL_AFD_WINE_SIOCATMARK:
         {
             int value, ret;
@@ -2520,6 +3301,31 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
         }
 #endif
 
+        case IOCTL_AFD_WINE_ACCEPT:
+        case IOCTL_AFD_WINE_ACCEPT_INTO:
+            status = try_direct_accept( handle, event, apc, apc_user, io, code, in_buffer, in_size,
+                                        out_buffer, out_size );
+            if (status != STATUS_BAD_DEVICE_TYPE) return status;
+            break;
+
+#ifdef SO_REUSEPORT
+        case IOCTL_AFD_WINE_SET_SO_REUSEADDR:
+            /* Let the kernel balance connections between listeners sharing the port, in this
+             * or other processes. Winsock semantics are still enforced by the server. */
+            if (do_reuseport() && in_size >= sizeof(int) &&
+                !server_get_unix_fd( handle, 0, &fd, &needs_close, NULL, NULL ))
+            {
+                int type, reuse = !!*(int *)in_buffer;
+                socklen_t len = sizeof(type);
+
+                if (!getsockopt( fd, SOL_SOCKET, SO_TYPE, &type, &len ) && type == SOCK_STREAM &&
+                    setsockopt( fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse) ))
+                    WARN( "failed to set SO_REUSEPORT: %s\n", strerror( errno ) );
+            }
+            status = STATUS_BAD_DEVICE_TYPE;
+            break;
+#endif
+
         case IOCTL_AFD_WINE_GET_TCP_NODELAY:
             return do_getsockopt( handle, io, IPPROTO_TCP, TCP_NODELAY, out_buffer, out_size );
 
@@ -2545,6 +3351,9 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
 
     if (needs_close) close( fd );
 
+    /* anything but polling may change what the server would do with receives */
+    if (status == STATUS_BAD_DEVICE_TYPE && code != IOCTL_AFD_POLL) sock_release_direct_recv( handle );
+
     if (status != STATUS_PENDING && !NT_ERROR(status)) io->Status = status;
 
     return status;
@@ -106,6 +106,47 @@ static inline ULONGLONG monotonic_counter(void)
 }
 
 
+/* adaptive spinning before blocking on esync/fsync objects, in the spirit of the
+ * glibc adaptive mutexes: each object (hashed by the address of its shared state)
+ * remembers how long a spin had to last to succeed */
+
+#define SPIN_HISTORY_SIZE 1024
+#define DEFAULT_SPIN_COUNT 100
+
+static unsigned short spin_history[SPIN_HISTORY_SIZE];
+static int max_spin_count = -1;
+
+static inline unsigned short *get_spin_history( const void *obj )
+{
+    return &spin_history[((UINT_PTR)obj >> 4) % SPIN_HISTORY_SIZE];
+}
+
+/* return how many times to poll an object before blocking on it, 0 to block right away */
+unsigned int get_sync_spin_count( const void *obj )
+{
+    if (max_spin_count == -1)
+    {
+        const char *env = getenv( "WINE_SYNC_SPINCOUNT" );
+
+        if (env) max_spin_count = max( atoi( env ), 0 );
+        else max_spin_count = sysconf( _SC_NPROCESSORS_ONLN ) > 1 ? DEFAULT_SPIN_COUNT : 0;
+        TRACE( "spinning up to %d times before blocking\n", max_spin_count );
+    }
+    if (!max_spin_count) return 0;
+    return min( max_spin_count, *get_spin_history( obj ) * 2 + 10 );
+}
+
+/* record the outcome of a spin; unsuccessful spins make the next ones shorter */
+void update_sync_spin_count( const void *obj, unsigned int spins, BOOL success )
+{
+    unsigned short *history = get_spin_history( obj );
+    int count = *history;
+
+    if (success) count += ((int)spins - count) / 8;
+    else count -= count / 8 + 1;
+    *history = max( count, 0 );
+}
+
 #ifdef __linux__
 
 #define FUTEX_WAIT 0
@@ -1431,6 +1472,9 @@ NTSTATUS WINAPI NtCreateTimer( HANDLE *handle, ACCESS_MASK access, const OBJECT_
     }
     SERVER_END_REQ;
 
+    if (!ret && do_fsync() && !(attr && (attr->ObjectName || (attr->Attributes & OBJ_INHERIT))))
+        fsync_register_timer( *handle, type == NotificationTimer );
+
     free( objattr );
     return ret;
 
@@ -1472,6 +1516,12 @@ NTSTATUS WINAPI NtSetTimer( HANDLE handle, const LARGE_INTEGER *when, PTIMER_APC
 
     TRACE( "(%p,%p,%p,%p,%08x,0x%08x,%p)\n", handle, when, callback, arg, resume, (int)period, state );
 
+    if (do_fsync() && (ret = fsync_set_timer( handle, when, callback, period, state )) != STATUS_NOT_IMPLEMENTED)
+    {
+        if (resume && ret == STATUS_SUCCESS) return STATUS_TIMER_RESUME_IGNORED;
+        return ret;
+    }
+
     SERVER_START_REQ( set_timer )
     {
         req->handle   = wine_server_obj_handle( handle );
@@ -1497,6 +1547,9 @@ NTSTATUS WINAPI NtCancelTimer( HANDLE handle, BOOLEAN *state )
 {
     unsigned int ret;
 
+    if (do_fsync() && (ret = fsync_cancel_timer( handle, state )) != STATUS_NOT_IMPLEMENTED)
+        return ret;
+
     SERVER_START_REQ( cancel_timer )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -1525,6 +1578,12 @@ NTSTATUS WINAPI NtQueryTimer( HANDLE handle, TIMER_INFORMATION_CLASS class,
     case TimerBasicInformation:
         if (len < sizeof(TIMER_BASIC_INFORMATION)) return STATUS_INFO_LENGTH_MISMATCH;
 
+        if (do_fsync() && !fsync_query_timer( handle, basic_info ))
+        {
+            if (ret_len) *ret_len = sizeof(TIMER_BASIC_INFORMATION);
+            return STATUS_SUCCESS;
+        }
+
         SERVER_START_REQ( get_timer_info )
         {
             req->handle = wine_server_obj_handle( handle );
@@ -2027,6 +2086,7 @@ NTSTATUS WINAPI NtSetIoCompletion( HANDLE handle, ULONG_PTR key, ULONG_PTR value
 NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE handle, ULONG_PTR *key, ULONG_PTR *value,
                                       IO_STATUS_BLOCK *io, LARGE_INTEGER *timeout )
 {
+    struct completion_msg msg;
     unsigned int status;
     int waited = 0;
 
@@ -2038,12 +2098,13 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE handle, ULONG_PTR *key, ULONG_PTR *
         {
             req->handle = wine_server_obj_handle( handle );
             req->waited = waited;
+            wine_server_set_reply( req, &msg, sizeof(msg) );
             if (!(status = wine_server_call( req )))
             {
-                *key            = reply->ckey;
-                *value          = reply->cvalue;
-                io->Information = reply->information;
-                io->Status      = reply->status;
+                *key            = msg.ckey;
+                *value          = msg.cvalue;
+                io->Information = msg.information;
+                io->Status      = msg.status;
             }
         }
         SERVER_END_REQ;
@@ -2061,31 +2122,38 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE handle, ULONG_PTR *key, ULONG_PTR *
 NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
                                         ULONG *written, LARGE_INTEGER *timeout, BOOLEAN alertable )
 {
+    struct completion_msg msgs[64];
     unsigned int status;
     int waited = 0;
-    ULONG i = 0;
+    ULONG i = 0, j, ret_count;
 
     TRACE( "%p %p %u %p %p %u\n", handle, info, (int)count, written, timeout, alertable );
 
     for (;;)
     {
+        /* fetch as many completions as are queued, up to the buffer size, in one call */
         while (i < count)
         {
+            ret_count = 0;
             SERVER_START_REQ( remove_completion )
             {
                 req->handle = wine_server_obj_handle( handle );
                 req->waited = waited;
+                wine_server_set_reply( req, msgs, min( count - i, ARRAY_SIZE(msgs) ) * sizeof(*msgs) );
                 if (!(status = wine_server_call( req )))
-                {
-                    info[i].CompletionKey             = reply->ckey;
-                    info[i].CompletionValue           = reply->cvalue;
-                    info[i].IoStatusBlock.Information = reply->information;
-                    info[i].IoStatusBlock.Status      = reply->status;
-                }
+                    ret_count = wine_server_reply_size( reply ) / sizeof(*msgs);
             }
             SERVER_END_REQ;
+            for (j = 0; j < ret_count; j++, i++)
+            {
+                info[i].CompletionKey             = msgs[j].ckey;
+                info[i].CompletionValue           = msgs[j].cvalue;
+                info[i].IoStatusBlock.Information = msgs[j].information;
+                info[i].IoStatusBlock.Status      = msgs[j].status;
+            }
             if (status != STATUS_SUCCESS) break;
-            ++i;
+            /* the queue is empty now */
+            if (ret_count < ARRAY_SIZE(msgs)) break;
         }
         if (i || status != STATUS_PENDING)
         {
@@ -2218,6 +2286,24 @@ NTSTATUS WINAPI NtOpenSection( HANDLE *handle, ACCESS_MASK access, const OBJECT_
 }
 
 
+/***********************************************************************
+ *             NtExtendSection (NTDLL.@)
+ */
+NTSTATUS WINAPI NtExtendSection( HANDLE handle, LARGE_INTEGER *size )
+{
+    unsigned int ret;
+
+    SERVER_START_REQ( extend_mapping )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        req->size   = size->QuadPart;
+        if (!(ret = wine_server_call( req ))) size->QuadPart = reply->size;
+    }
+    SERVER_END_REQ;
+    return ret;
+}
+
+
 /***********************************************************************
  *             NtCreatePort (NTDLL.@)
  */
@@ -2322,6 +2408,236 @@ NTSTATUS WINAPI NtReplyWaitReceivePort( HANDLE handle, ULONG *id, LPC_MESSAGE *r
 }
 
 
+#define ALPC_MAX_MESSAGE_SIZE 0xffff  /* including the PORT_MESSAGE header */
+
+static void set_port_message( PORT_MESSAGE *msg, USHORT type, ULONG id, process_id_t pid,
+                              thread_id_t tid, data_size_t size )
+{
+    msg->DataSize               = size;
+    msg->MessageSize            = sizeof(*msg) + size;
+    msg->MessageType            = type;
+    msg->VirtualRangesOffset    = 0;
+    msg->ClientId.UniqueProcess = ULongToHandle( pid );
+    msg->ClientId.UniqueThread  = ULongToHandle( tid );
+    msg->MessageId              = id;
+    msg->SectionSize            = 0;
+}
+
+static unsigned int check_port_message( const PORT_MESSAGE *msg )
+{
+    if (msg->MessageSize < sizeof(*msg) + msg->DataSize) return STATUS_INVALID_PARAMETER;
+    if (msg->MessageSize > ALPC_MAX_MESSAGE_SIZE) return STATUS_PORT_MESSAGE_TOO_LONG;
+    return STATUS_SUCCESS;
+}
+
+/* wait for the reply to a sync request or a connection request, and close its wait handle */
+static unsigned int wait_alpc_reply( HANDLE wait, PORT_MESSAGE *msg, SIZE_T size, SIZE_T *ret_size,
+                                     LARGE_INTEGER *timeout )
+{
+    unsigned int status = NtWaitForSingleObject( wait, FALSE, timeout );
+
+    if (status == WAIT_OBJECT_0)
+    {
+        SERVER_START_REQ( get_alpc_reply )
+        {
+            req->wait = wine_server_obj_handle( wait );
+            if (msg) wine_server_set_reply( req, msg + 1, size - sizeof(*msg) );
+            status = wine_server_call( req );
+            if (msg && (!status || status == STATUS_PORT_CONNECTION_REFUSED))
+                set_port_message( msg, LPC_REPLY, reply->id, reply->pid, reply->tid, wine_server_reply_size( reply ));
+            if (ret_size) *ret_size = sizeof(*msg) + reply->size;
+        }
+        SERVER_END_REQ;
+    }
+    NtClose( wait );
+    return status;
+}
+
+
+/***********************************************************************
+ *             NtAlpcCreatePort (NTDLL.@)
+ */
+NTSTATUS WINAPI NtAlpcCreatePort( HANDLE *handle, OBJECT_ATTRIBUTES *attr, ALPC_PORT_ATTRIBUTES *port_attr )
+{
+    SIZE_T max_size = ALPC_MAX_MESSAGE_SIZE;
+    unsigned int status;
+    data_size_t len;
+    struct object_attributes *objattr;
+
+    TRACE( "(%p,%p,%p)\n", handle, attr, port_attr );
+
+    if (port_attr && port_attr->MaxMessageLength) max_size = min( max_size, port_attr->MaxMessageLength );
+    if (max_size < sizeof(PORT_MESSAGE)) return STATUS_INVALID_PARAMETER;
+
+    *handle = 0;
+    if ((status = alloc_object_attributes( attr, &objattr, &len ))) return status;
+
+    SERVER_START_REQ( create_alpc_port )
+    {
+        req->access   = STANDARD_RIGHTS_REQUIRED | SYNCHRONIZE | 0x0001 /* PORT_CONNECT */;
+        req->max_size = max_size - sizeof(PORT_MESSAGE);
+        wine_server_add_data( req, objattr, len );
+        if (!(status = wine_server_call( req ))) *handle = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+
+    free( objattr );
+    return status;
+}
+
+
+/***********************************************************************
+ *             NtAlpcConnectPort (NTDLL.@)
+ */
+NTSTATUS WINAPI NtAlpcConnectPort( HANDLE *handle, UNICODE_STRING *name, OBJECT_ATTRIBUTES *attr,
+                                   ALPC_PORT_ATTRIBUTES *port_attr, ULONG flags, PSID sid,
+                                   PORT_MESSAGE *msg, SIZE_T *size, ALPC_MESSAGE_ATTRIBUTES *out_attr,
+                                   ALPC_MESSAGE_ATTRIBUTES *in_attr, LARGE_INTEGER *timeout )
+{
+    HANDLE port, wait;
+    unsigned int status;
+
+    TRACE( "(%p,%s,%p,%p,%#x,%p,%p,%p,%p,%p,%p)\n", handle, debugstr_us(name), attr, port_attr,
+           (int)flags, sid, msg, size, out_attr, in_attr, timeout );
+
+    if (!name) return STATUS_INVALID_PARAMETER;
+    if (msg && (status = check_port_message( msg ))) return status;
+    if (msg && size && *size < sizeof(*msg)) return STATUS_BUFFER_TOO_SMALL;
+    if (sid || out_attr || in_attr) FIXME( "server sid and message attributes not supported\n" );
+    if (in_attr) in_attr->ValidAttributes = 0;
+
+    *handle = 0;
+    SERVER_START_REQ( connect_alpc_port )
+    {
+        req->namelen = name->Length;
+        wine_server_add_data( req, name->Buffer, name->Length );
+        if (msg) wine_server_add_data( req, msg + 1, msg->DataSize );
+        status = wine_server_call( req );
+        port = wine_server_ptr_handle( reply->handle );
+        wait = wine_server_ptr_handle( reply->wait );
+    }
+    SERVER_END_REQ;
+    if (status) return status;
+
+    status = wait_alpc_reply( wait, msg, size ? *size : msg ? msg->MessageSize : 0, size, timeout );
+    if (status) NtClose( port );
+    else *handle = port;
+    return status;
+}
+
+
+/***********************************************************************
+ *             NtAlpcAcceptConnectPort (NTDLL.@)
+ */
+NTSTATUS WINAPI NtAlpcAcceptConnectPort( HANDLE *handle, HANDLE port, ULONG flags, OBJECT_ATTRIBUTES *attr,
+                                         ALPC_PORT_ATTRIBUTES *port_attr, void *context, PORT_MESSAGE *msg,
+                                         ALPC_MESSAGE_ATTRIBUTES *msg_attr, BOOLEAN accept )
+{
+    unsigned int status;
+
+    TRACE( "(%p,%p,%#x,%p,%p,%p,%p,%p,%d)\n", handle, port, (int)flags, attr, port_attr,
+           context, msg, msg_attr, accept );
+
+    if (!msg) return STATUS_INVALID_PARAMETER;
+    if ((status = check_port_message( msg ))) return status;
+
+    *handle = 0;
+    SERVER_START_REQ( accept_alpc_port )
+    {
+        req->port   = wine_server_obj_handle( port );
+        req->id     = msg->MessageId;
+        req->accept = accept;
+        wine_server_add_data( req, msg + 1, msg->DataSize );
+        if (!(status = wine_server_call( req ))) *handle = wine_server_ptr_handle( reply->handle );
+    }
+    SERVER_END_REQ;
+    return status;
+}
+
+
+/***********************************************************************
+ *             NtAlpcSendWaitReceivePort (NTDLL.@)
+ */
+NTSTATUS WINAPI NtAlpcSendWaitReceivePort( HANDLE port, ULONG flags, PORT_MESSAGE *send,
+                                           ALPC_MESSAGE_ATTRIBUTES *send_attr, PORT_MESSAGE *recv,
+                                           SIZE_T *size, ALPC_MESSAGE_ATTRIBUTES *recv_attr,
+                                           LARGE_INTEGER *timeout )
+{
+    SIZE_T recv_size = size ? *size : ALPC_MAX_MESSAGE_SIZE;
+    unsigned int status = STATUS_SUCCESS;
+    HANDLE wait = 0;
+
+    TRACE( "(%p,%#x,%p,%p,%p,%p,%p,%p)\n", port, (int)flags, send, send_attr, recv, size, recv_attr, timeout );
+
+    if (send_attr || (recv_attr && recv_attr->AllocatedAttributes))
+        FIXME( "message attributes not supported\n" );
+    if (recv_attr) recv_attr->ValidAttributes = 0;
+    if (recv && recv_size < sizeof(*recv)) return STATUS_BUFFER_TOO_SMALL;
+
+    if (send)
+    {
+        BOOL sync = (flags & ALPC_MSGFLG_SYNC_REQUEST) && !send->MessageId;
+
+        if ((status = check_port_message( send ))) return status;
+        if (sync && !recv) return STATUS_INVALID_PARAMETER;
+
+        SERVER_START_REQ( send_alpc_message )
+        {
+            req->port = wine_server_obj_handle( port );
+            req->id   = send->MessageId;
+            req->sync = sync;
+            wine_server_add_data( req, send + 1, send->DataSize );
+            if (!(status = wine_server_call( req )))
+            {
+                send->MessageId = reply->id;
+                wait = wine_server_ptr_handle( reply->wait );
+            }
+        }
+        SERVER_END_REQ;
+        if (status) return status;
+        if (wait) return wait_alpc_reply( wait, recv, recv_size, size, timeout );
+    }
+
+    if (!recv) return status;
+
+    for (;;)
+    {
+        SERVER_START_REQ( receive_alpc_message )
+        {
+            req->port = wine_server_obj_handle( port );
+            wine_server_set_reply( req, recv + 1, recv_size - sizeof(*recv) );
+            status = wine_server_call( req );
+            if (!status)
+                set_port_message( recv, reply->type, reply->id, reply->pid, reply->tid, wine_server_reply_size( reply ));
+            if ((!status || status == STATUS_BUFFER_TOO_SMALL) && size) *size = sizeof(*recv) + reply->size;
+        }
+        SERVER_END_REQ;
+        if (status != STATUS_PENDING) return status;
+        status = NtWaitForSingleObject( port, (flags & ALPC_MSGFLG_WAIT_ALERTABLE) != 0, timeout );
+        if (status != WAIT_OBJECT_0) return status;
+    }
+}
+
+
+/***********************************************************************
+ *             NtAlpcDisconnectPort (NTDLL.@)
+ */
+NTSTATUS WINAPI NtAlpcDisconnectPort( HANDLE port, ULONG flags )
+{
+    unsigned int status;
+
+    TRACE( "(%p,%#x)\n", port, (int)flags );
+
+    SERVER_START_REQ( disconnect_alpc_port )
+    {
+        req->port = wine_server_obj_handle( port );
+        status = wine_server_call( req );
+    }
+    SERVER_END_REQ;
+    return status;
+}
+
+
 #define MAX_ATOM_LEN  255
 #define IS_INTATOM(x) (((ULONG_PTR)(x) >> 16) == 0)
 
@@ -2859,6 +2859,48 @@ static void read_dev_urandom( void *buf, ULONG len )
     else WARN( "can't open /dev/urandom\n" );
 }
 
+/* The per-process and per-thread /proc data is cached for a short time, so that
+ * the usual query-size-then-query sequence and frequent polling don't reread
+ * and reparse every stat and status file on each call. */
+#define PROC_CACHE_SIZE 1024
+#define PROC_CACHE_TTL  100  /* ms */
+
+struct proc_cache_entry
+{
+    int            unix_pid;
+    int            unix_tid;    /* -1 for the process itself */
+    ULONG          time;
+    LARGE_INTEGER  kernel_time;
+    LARGE_INTEGER  user_time;
+    VM_COUNTERS_EX vm_counters; /* only set for processes */
+};
+
+static struct proc_cache_entry proc_cache[PROC_CACHE_SIZE];
+static pthread_mutex_t proc_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void get_proc_info( int unix_pid, int unix_tid, LARGE_INTEGER *kernel_time,
+                           LARGE_INTEGER *user_time, VM_COUNTERS_EX *vm_counters )
+{
+    struct proc_cache_entry *entry = &proc_cache[((unsigned int)unix_pid * 31 + unix_tid) % PROC_CACHE_SIZE];
+    ULONG now = NtGetTickCount();
+
+    mutex_lock( &proc_cache_mutex );
+    if (!entry->unix_pid || entry->unix_pid != unix_pid || entry->unix_tid != unix_tid ||
+        now - entry->time >= PROC_CACHE_TTL)
+    {
+        memset( entry, 0, sizeof(*entry) );
+        entry->unix_pid = unix_pid;
+        entry->unix_tid = unix_tid;
+        entry->time = now;
+        get_thread_times( unix_pid, unix_tid, &entry->kernel_time, &entry->user_time );
+        if (unix_tid == -1) fill_vm_counters( &entry->vm_counters, unix_pid );
+    }
+    *kernel_time = entry->kernel_time;
+    *user_time = entry->user_time;
+    if (vm_counters) *vm_counters = entry->vm_counters;
+    mutex_unlock( &proc_cache_mutex );
+}
+
 static unsigned int get_system_process_info( SYSTEM_INFORMATION_CLASS class, void *info, ULONG size, ULONG *len )
 {
     unsigned int process_count, total_thread_count, total_name_len, i, j;
@@ -2936,8 +2978,8 @@ C_ASSERT( sizeof(struct process_info) <= sizeof(SYSTEM_PROCESS_INFORMATION) );
             nt_process->ParentProcessId = UlongToHandle(server_process->parent_pid);
             nt_process->SessionId = server_process->session_id;
             nt_process->HandleCount = server_process->handle_count;
-            get_thread_times( server_process->unix_pid, -1, &nt_process->KernelTime, &nt_process->UserTime );
-            fill_vm_counters( &nt_process->vmCounters, server_process->unix_pid );
+            get_proc_info( server_process->unix_pid, -1, &nt_process->KernelTime, &nt_process->UserTime,
+                           &nt_process->vmCounters );
         }
 
         pos = (pos + 7) & ~7;
@@ -2954,8 +2996,8 @@ C_ASSERT( sizeof(struct process_info) <= sizeof(SYSTEM_PROCESS_INFORMATION) );
                 ti->ThreadInfo.ClientId.UniqueThread = UlongToHandle(server_thread->tid);
                 ti->ThreadInfo.dwCurrentPriority = server_thread->current_priority;
                 ti->ThreadInfo.dwBasePriority = server_thread->base_priority;
-                get_thread_times( server_process->unix_pid, server_thread->unix_tid,
-                                  &ti->ThreadInfo.KernelTime, &ti->ThreadInfo.UserTime );
+                get_proc_info( server_process->unix_pid, server_thread->unix_tid,
+                               &ti->ThreadInfo.KernelTime, &ti->ThreadInfo.UserTime, NULL );
                 if (class == SystemExtendedProcessInformation)
                 {
                     ti->Win32StartAddress = wine_server_get_ptr( server_thread->entry_point );
@@ -3962,6 +4004,81 @@ static ULONG mhz_from_cpuinfo(void)
     return cmz;
 }
 
+/* the frequency limits only change on CPU hotplug or policy changes, and reading them
+ * costs two sysfs files per CPU, so keep them until the number of online CPUs changes */
+static PROCESSOR_POWER_INFORMATION *cpu_power_cache;
+static int cpu_power_cache_count;
+static long cpu_power_cache_online;
+static pthread_mutex_t cpu_power_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void read_cpu_power_info( PROCESSOR_POWER_INFORMATION *cpu_power, int out_cpus, int cannedMHz )
+{
+    unsigned int val;
+    char filename[128];
+    FILE* f;
+    int i;
+
+    for(i = 0; i < out_cpus; i++) {
+        snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+        f = fopen(filename, "r");
+        if (f && (fscanf(f, "%u", &val) == 1)) {
+            cpu_power[i].MaxMhz = val / 1000;
+            fclose(f);
+            cpu_power[i].CurrentMhz = cpu_power[i].MaxMhz;
+        }
+        else {
+            if(i == 0) {
+                cpu_power[0].CurrentMhz = mhz_from_cpuinfo();
+                if(cpu_power[0].CurrentMhz == 0)
+                    cpu_power[0].CurrentMhz = cannedMHz;
+            }
+            else
+                cpu_power[i].CurrentMhz = cpu_power[0].CurrentMhz;
+            cpu_power[i].MaxMhz = cpu_power[i].CurrentMhz;
+            if(f) fclose(f);
+        }
+
+        snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_max_freq", i);
+        f = fopen(filename, "r");
+        if(f && (fscanf(f, "%u", &val) == 1)) {
+            cpu_power[i].MhzLimit = val / 1000;
+            fclose(f);
+        }
+        else
+        {
+            cpu_power[i].MhzLimit = cpu_power[i].MaxMhz;
+            if(f) fclose(f);
+        }
+
+        cpu_power[i].Number = i;
+        cpu_power[i].MaxIdleState = 0;     /* FIXME */
+        cpu_power[i].CurrentIdleState = 0; /* FIXME */
+    }
+}
+
+static void get_cpu_power_info( PROCESSOR_POWER_INFORMATION *cpu_power, int out_cpus, int cannedMHz )
+{
+    PROCESSOR_POWER_INFORMATION *cache;
+    long online = sysconf( _SC_NPROCESSORS_ONLN );
+
+    mutex_lock( &cpu_power_mutex );
+    if (cpu_power_cache_count != out_cpus || cpu_power_cache_online != online)
+    {
+        if ((cache = realloc( cpu_power_cache, out_cpus * sizeof(*cache) )))
+        {
+            read_cpu_power_info( cache, out_cpus, cannedMHz );
+            cpu_power_cache = cache;
+            cpu_power_cache_count = out_cpus;
+            cpu_power_cache_online = online;
+        }
+    }
+    if (cpu_power_cache_count == out_cpus)
+        memcpy( cpu_power, cpu_power_cache, out_cpus * sizeof(*cpu_power) );
+    else
+        read_cpu_power_info( cpu_power, out_cpus, cannedMHz );
+    mutex_unlock( &cpu_power_mutex );
+}
+
 static const char * get_sys_str(const char *dirname, const char *basename, char *s)
 {
     char path[64];
@@ -4280,48 +4397,7 @@ NTSTATUS WINAPI NtPowerInformation( POWER_INFORMATION_LEVEL level, void *input,
         out_cpus = peb->NumberOfProcessors;
         if ((out_size / sizeof(PROCESSOR_POWER_INFORMATION)) < out_cpus) return STATUS_BUFFER_TOO_SMALL;
 #if defined(linux)
-        {
-            unsigned int val;
-            char filename[128];
-            FILE* f;
-
-            for(i = 0; i < out_cpus; i++) {
-                snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
-                f = fopen(filename, "r");
-                if (f && (fscanf(f, "%u", &val) == 1)) {
-                    cpu_power[i].MaxMhz = val / 1000;
-                    fclose(f);
-                    cpu_power[i].CurrentMhz = cpu_power[i].MaxMhz;
-                }
-                else {
-                    if(i == 0) {
-                        cpu_power[0].CurrentMhz = mhz_from_cpuinfo();
-                        if(cpu_power[0].CurrentMhz == 0)
-                            cpu_power[0].CurrentMhz = cannedMHz;
-                    }
-                    else
-                        cpu_power[i].CurrentMhz = cpu_power[0].CurrentMhz;
-                    cpu_power[i].MaxMhz = cpu_power[i].CurrentMhz;
-                    if(f) fclose(f);
-                }
-
-                snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_max_freq", i);
-                f = fopen(filename, "r");
-                if(f && (fscanf(f, "%u", &val) == 1)) {
-                    cpu_power[i].MhzLimit = val / 1000;
-                    fclose(f);
-                }
-                else
-                {
-                    cpu_power[i].MhzLimit = cpu_power[i].MaxMhz;
-                    if(f) fclose(f);
-                }
-
-                cpu_power[i].Number = i;
-                cpu_power[i].MaxIdleState = 0;     /* FIXME */
-                cpu_power[i].CurrentIdleState = 0; /* FIXME */
-            }
-        }
+        get_cpu_power_info( cpu_power, out_cpus, cannedMHz );
 #elif defined(__FreeBSD__) || defined (__FreeBSD_kernel__) || defined(__DragonFly__)
         {
             int num;
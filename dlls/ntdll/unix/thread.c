@@ -1443,6 +1443,7 @@ void abort_thread( int status )
  */
 void abort_process( int status )
 {
+    dbg_flush_ring_buffer();
     _exit( get_unix_exit_code( status ));
 }
 
@@ -1479,6 +1480,7 @@ static DECLSPEC_NORETURN void exit_thread( int status )
 void exit_process( int status )
 {
     pthread_sigmask( SIG_BLOCK, &server_block_set, NULL );
+    dbg_flush_ring_buffer();
     process_exit_wrapper( get_unix_exit_code( status ));
 }
 
@@ -74,4 +74,8 @@ struct pm_scan_arg {
 };
 #endif
 
+#ifndef PAGE_IS_SOFT_DIRTY
+#define PAGE_IS_SOFT_DIRTY	(1 << 7)
+#endif
+
 #endif
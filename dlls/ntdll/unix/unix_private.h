@@ -120,8 +120,24 @@ struct async_fileio
     async_callback_t    *callback;
     struct async_fileio *next;
     HANDLE               handle;
+    ULONGLONG            start;     /* submission time, for the I/O statistics */
 };
 
+enum io_stat_type
+{
+    IO_STAT_READ,
+    IO_STAT_WRITE,
+    IO_STAT_OTHER,
+    IO_STAT_ZEROCOPY  /* bytes is the number of zero-copy sends */
+};
+
+/* client-side state of a socket handle, stored alongside the fd cache */
+#define SOCK_STATE_QUEUED      0x000fffff  /* receives currently queued on the server */
+#define SOCK_STATE_DIRECT      0x00100000  /* receives may bypass the server while none is queued */
+#define SOCK_STATE_COMPLETION  0x00200000  /* direct receives still need to queue a completion */
+#define SOCK_STATE_GEN_SHIFT   22          /* generation of the handle, bumped when it is closed */
+#define SOCK_STATE_GEN_MASK    (~0u << SOCK_STATE_GEN_SHIFT)
+
 static const SIZE_T page_size = 0x1000;
 static const SIZE_T teb_size = 0x3800;  /* TEB64 + TEB32 + debug info */
 static const SIZE_T signal_stack_mask = 0xffff;
@@ -208,6 +224,7 @@ extern NTSTATUS load_start_exe( WCHAR **image, void **module );
 extern void start_server( BOOL debug );
 
 extern unsigned int server_call_unlocked( void *req_ptr );
+extern unsigned int server_call_batch( struct __server_request_info **reqs, unsigned int count );
 extern void server_enter_uninterrupted_section( pthread_mutex_t *mutex, sigset_t *sigset );
 extern void server_leave_uninterrupted_section( pthread_mutex_t *mutex, sigset_t *sigset );
 extern unsigned int server_select( const select_op_t *select_op, data_size_t size, UINT flags,
@@ -218,6 +235,12 @@ extern unsigned int server_queue_process_apc( HANDLE process, const apc_call_t *
                                               apc_result_t *result );
 extern int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                                int *needs_close, enum server_fd_type *type, unsigned int *options );
+extern BOOL server_get_cached_fd_info( HANDLE handle, unsigned int *access, unsigned int *sharing );
+extern void server_record_io( HANDLE handle, enum io_stat_type type, ULONG_PTR bytes, ULONGLONG start, BOOL async );
+extern void server_get_io_counters( IO_COUNTERS *counters );
+extern BOOL server_get_handle_io( HANDLE prev, PROCESS_WINE_HANDLE_IO_INFORMATION *info );
+extern LONG *server_get_sock_state( HANDLE handle, BOOL create );
+extern void server_clear_sock_states( LONG mask );
 extern void wine_server_send_fd( int fd );
 extern void process_exit_wrapper( int status ) DECLSPEC_NORETURN;
 extern size_t server_init_process(void);
@@ -341,6 +364,7 @@ extern NTSTATUS sock_read( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE
                            IO_STATUS_BLOCK *io, void *buffer, ULONG length );
 extern NTSTATUS sock_write( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
                             IO_STATUS_BLOCK *io, const void *buffer, ULONG length );
+extern void sock_release_direct_recv( HANDLE handle );
 extern NTSTATUS tape_DeviceIoControl( HANDLE device, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
                                       IO_STATUS_BLOCK *io, UINT code, void *in_buffer,
                                       UINT in_size, void *out_buffer, UINT out_size );
@@ -360,6 +384,8 @@ extern void init_files(void);
 extern void init_cpu_info(void);
 extern void add_completion( HANDLE handle, ULONG_PTR value, NTSTATUS status, ULONG info, BOOL async );
 extern void set_async_direct_result( HANDLE *async_handle, NTSTATUS status, ULONG_PTR information, BOOL mark_pending );
+extern unsigned int get_sync_spin_count( const void *obj );
+extern void update_sync_spin_count( const void *obj, unsigned int spins, BOOL success );
 extern struct cpu_topology_override *get_cpu_topology_override(void);
 
 extern NTSTATUS unixcall_wine_dbg_write( void *args );
@@ -376,6 +402,7 @@ extern NTSTATUS wow64_wine_spawnvp( void *args );
 #endif
 
 extern void dbg_init(void);
+extern void dbg_flush_ring_buffer(void);
 
 extern NTSTATUS call_user_apc_dispatcher( CONTEXT *context_ptr, ULONG_PTR arg1, ULONG_PTR arg2, ULONG_PTR arg3,
                                           PNTAPCFUNC func, NTSTATUS status );
@@ -455,6 +482,14 @@ static inline NTSTATUS wait_async( HANDLE handle, BOOL alertable )
     return NtWaitForSingleObject( handle, alertable, NULL );
 }
 
+/* timestamp for the I/O statistics, in 100ns units */
+static inline ULONGLONG get_io_time(void)
+{
+    LARGE_INTEGER now;
+    NtQueryPerformanceCounter( &now, NULL );
+    return now.QuadPart;
+}
+
 static inline BOOL in_wow64_call(void)
 {
     return is_win64 && is_wow64();
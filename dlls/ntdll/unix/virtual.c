@@ -32,6 +32,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <sched.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -84,6 +85,7 @@
 #include "ddk/wdm.h"
 #include "wine/list.h"
 #include "wine/rbtree.h"
+#include "wine/sdt.h"
 #include "unix_private.h"
 #include "wine/debug.h"
 
@@ -281,6 +283,41 @@ static const BYTE VIRTUAL_Win32Flags[16] =
 
 static struct wine_rb_tree views_tree;
 static pthread_mutex_t virtual_mutex;
+static LONG virtual_shared_count;  /* number of threads inside a shared section */
+
+/* wait for shared sections to complete, virtual_mutex must be held by caller */
+static inline void wait_shared_sections(void)
+{
+    /* shared sections are only doing lookups and never block, spinning is fine */
+    while (!process_exiting && ReadAcquire( &virtual_shared_count )) sched_yield();
+}
+
+/* enter a section modifying views or page protections, excluding all other sections */
+static inline void virtual_enter_exclusive( sigset_t *sigset )
+{
+    server_enter_uninterrupted_section( &virtual_mutex, sigset );
+    wait_shared_sections();
+}
+
+static inline void virtual_leave_exclusive( sigset_t *sigset )
+{
+    server_leave_uninterrupted_section( &virtual_mutex, sigset );
+}
+
+/* enter a read-only section, which may run concurrently with other shared sections.
+ * shared sections must not modify any state, nor enter an exclusive section or fault. */
+static inline void virtual_enter_shared( sigset_t *sigset )
+{
+    server_enter_uninterrupted_section( &virtual_mutex, sigset );
+    InterlockedIncrement( &virtual_shared_count );
+    mutex_unlock( &virtual_mutex );
+}
+
+static inline void virtual_leave_shared( sigset_t *sigset )
+{
+    InterlockedDecrement( &virtual_shared_count );
+    pthread_sigmask( SIG_SETMASK, sigset, NULL );
+}
 
 static const UINT page_shift = 12;
 static const UINT_PTR page_mask = 0xfff;
@@ -337,6 +374,9 @@ static BYTE *pages_vprot;
 #endif
 
 static int use_kernel_writewatch;
+
+static const SIZE_T large_page_size = 0x200000;  /* must match GetLargePageMinimum */
+static SIZE_T thp_min_size;  /* committed allocations advised for huge pages from this size, 0 if disabled */
 static int uffd_fd, pagemap_fd;
 static int pagemap_reset_fd, clear_refs_fd;
 #define PAGE_FLAGS_BUFFER_LENGTH 1024
@@ -361,6 +401,12 @@ struct range_entry
 static struct range_entry *free_ranges;
 static struct range_entry *free_ranges_end;
 
+/* implicit binary tree of the largest free range size in each subtree, leaves are the free ranges */
+#define FREE_RANGES_MAX_COUNT (view_block_size / sizeof(struct range_entry))
+static size_t *free_ranges_tree;
+static size_t free_ranges_tree_count;  /* number of free ranges when the tree was last updated */
+static size_t free_ranges_dirty;       /* index of the first free range that changed since then */
+
 
 static inline BOOL is_beyond_limit( const void *addr, size_t size, const void *limit )
 {
@@ -493,8 +539,54 @@ static void kernel_writewatch_register_range( struct file_view *view, void *base
     }
 }
 
+/* gather the pages matching category from a range with PAGEMAP_SCAN, in batches of regions */
+static int pagemap_scan_pages( void *base, SIZE_T size, void **buffer, ULONG_PTR *count,
+                               UINT64 category, UINT64 flags )
+{
+    SIZE_T buffer_len = count ? *count : 0;
+    struct pm_scan_arg arg = { 0 };
+    char *addr = base, *next_addr;
+    struct page_region rgns[256];
+    int rgn_count, i;
+    size_t c_addr;
+
+    arg.size = sizeof(arg);
+    arg.vec = (UINT_PTR)rgns;
+    arg.vec_len = ARRAY_SIZE(rgns);
+    arg.flags = flags;
+    arg.category_mask = category;
+    arg.return_mask = category;
+
+    *count = 0;
+    while (1)
+    {
+        arg.start = (UINT_PTR)addr;
+        arg.end = arg.start + size;
+        arg.max_pages = buffer_len;
+
+        if ((rgn_count = ioctl( pagemap_fd, PAGEMAP_SCAN, &arg )) < 0) return -1;
+        if (!rgn_count) break;
+
+        assert( rgn_count <= ARRAY_SIZE(rgns) );
+        for (i = 0; i < rgn_count; ++i)
+        {
+            assert( rgns[i].categories == category );
+            assert( !buffer || buffer_len >= ((rgns[i].end - rgns[i].start) >> page_shift) );
+            for (c_addr = rgns[i].start; buffer_len && c_addr != rgns[i].end; c_addr += page_size, --buffer_len)
+                buffer[(*count)++] = (void *)c_addr;
+        }
+        if (!buffer_len || rgn_count < arg.vec_len) break;
+        next_addr = (void *)(UINT_PTR)arg.walk_end;
+        assert( size >= next_addr - addr );
+        if (!(size -= next_addr - addr)) break;
+        addr = next_addr;
+    }
+    return 0;
+}
+
 static NTSTATUS kernel_soft_dirty_get_write_watches( void *base, SIZE_T size, void **addresses, ULONG_PTR *count, BOOL reset )
 {
+    static BOOL no_soft_dirty_scan;
     static UINT64 buffer[PAGE_FLAGS_BUFFER_LENGTH];
     char *addr = base;
     char *end = addr + size;
@@ -542,6 +634,19 @@ static NTSTATUS kernel_soft_dirty_get_write_watches( void *base, SIZE_T size, vo
         return STATUS_SUCCESS;
     }
 
+    /* PAGEMAP_SCAN reports soft dirty ranges since Linux 6.8, fall back to reading pagemap otherwise */
+    if (!no_soft_dirty_scan)
+    {
+        ULONG_PTR scan_count = *count;
+        if (!pagemap_scan_pages( base, size, addresses, &scan_count, PAGE_IS_SOFT_DIRTY, 0 ))
+        {
+            *count = scan_count;
+            return STATUS_SUCCESS;
+        }
+        WARN( "ioctl( PAGEMAP_SCAN ) failed, error %s, falling back to pagemap reads.\n", strerror(errno) );
+        no_soft_dirty_scan = TRUE;
+    }
+
     while (pos < *count && addr < end)
     {
         length = min(PAGE_FLAGS_BUFFER_LENGTH, (end - addr) >> page_shift);
@@ -566,52 +671,14 @@ static NTSTATUS kernel_soft_dirty_get_write_watches( void *base, SIZE_T size, vo
 
 static NTSTATUS kernel_get_write_watches( void *base, SIZE_T size, void **buffer, ULONG_PTR *count, BOOL reset )
 {
-    SIZE_T buffer_len = count ? *count : 0;
-    struct pm_scan_arg arg = { 0 };
-    char *addr = base, *next_addr;
-    struct page_region rgns[256];
-    int rgn_count, i;
-    size_t c_addr;
-
     assert( !(size & page_mask) );
 
     if (use_kernel_writewatch == 2) return kernel_soft_dirty_get_write_watches( base, size, buffer, count, reset );
 
-    arg.size = sizeof(arg);
-    arg.vec = (UINT_PTR)rgns;
-    arg.vec_len = ARRAY_SIZE(rgns);
-    if (reset)
-        arg.flags |= PM_SCAN_WP_MATCHING;
-    arg.category_mask = PAGE_IS_WRITTEN;
-    arg.return_mask = PAGE_IS_WRITTEN;
-
-    *count = 0;
-    while (1)
+    if (pagemap_scan_pages( base, size, buffer, count, PAGE_IS_WRITTEN, reset ? PM_SCAN_WP_MATCHING : 0 ))
     {
-        arg.start = (UINT_PTR)addr;
-        arg.end = arg.start + size;
-        arg.max_pages = buffer_len;
-
-        if ((rgn_count = ioctl( pagemap_fd, PAGEMAP_SCAN, &arg )) < 0)
-        {
-            ERR( "ioctl( PAGEMAP_SCAN ) failed, error %s.\n", strerror(errno) );
-            return STATUS_INTERNAL_ERROR;
-        }
-        if (!rgn_count) break;
-
-        assert( rgn_count <= ARRAY_SIZE(rgns) );
-        for (i = 0; i < rgn_count; ++i)
-        {
-            assert( rgns[i].categories == PAGE_IS_WRITTEN );
-            assert( !buffer || buffer_len >= ((rgns[i].end - rgns[i].start) >> page_shift) );
-            for (c_addr = rgns[i].start; buffer_len && c_addr != rgns[i].end; c_addr += page_size, --buffer_len)
-                buffer[(*count)++] = (void *)c_addr;
-        }
-        if (!buffer_len || rgn_count < arg.vec_len) break;
-        next_addr = (void *)(UINT_PTR)arg.walk_end;
-        assert( size >= next_addr - addr );
-        if (!(size -= next_addr - addr)) break;
-        addr = next_addr;
+        ERR( "ioctl( PAGEMAP_SCAN ) failed, error %s.\n", strerror(errno) );
+        return STATUS_INTERNAL_ERROR;
     }
     return STATUS_SUCCESS;
 }
@@ -998,7 +1065,7 @@ void *get_builtin_so_handle( void *module )
     void *ret = NULL;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -1006,7 +1073,7 @@ void *get_builtin_so_handle( void *module )
         if (ret) builtin->refcount++;
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return ret;
 }
 
@@ -1021,7 +1088,7 @@ static NTSTATUS get_builtin_unix_funcs( void *module, BOOL wow, const void **fun
     NTSTATUS status = STATUS_DLL_NOT_FOUND;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -1034,7 +1101,7 @@ static NTSTATUS get_builtin_unix_funcs( void *module, BOOL wow, const void **fun
         }
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -1048,7 +1115,7 @@ NTSTATUS load_builtin_unixlib( void *module, const char *name )
     NTSTATUS status = STATUS_SUCCESS;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -1057,7 +1124,7 @@ NTSTATUS load_builtin_unixlib( void *module, const char *name )
         if (!builtin->unix_handle) builtin->unix_handle = dlopen( builtin->unix_path, RTLD_NOW );
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -1085,6 +1152,88 @@ static struct range_entry *free_ranges_lower_bound( void *addr )
     return begin;
 }
 
+/***********************************************************************
+ *           free_ranges_invalidate
+ *
+ * Mark the free ranges starting at range as changed.
+ */
+static inline void free_ranges_invalidate( struct range_entry *range )
+{
+    free_ranges_dirty = min( free_ranges_dirty, range - free_ranges );
+}
+
+/***********************************************************************
+ *           free_ranges_update_tree
+ *
+ * Update the tree of the largest free range sizes for the changed ranges.
+ */
+static void free_ranges_update_tree(void)
+{
+    size_t count = free_ranges_end - free_ranges;
+    size_t lo = free_ranges_dirty, hi = max( count, free_ranges_tree_count ), i;
+
+    if (lo < hi)
+    {
+        for (i = lo; i < hi; i++)
+            free_ranges_tree[FREE_RANGES_MAX_COUNT + i] = i < count ?
+                (char *)free_ranges[i].end - (char *)free_ranges[i].base : 0;
+
+        for (lo += FREE_RANGES_MAX_COUNT, hi += FREE_RANGES_MAX_COUNT - 1; lo > 1; lo /= 2, hi /= 2)
+            for (i = lo / 2; i <= hi / 2; i++)
+                free_ranges_tree[i] = max( free_ranges_tree[2 * i], free_ranges_tree[2 * i + 1] );
+    }
+    free_ranges_tree_count = count;
+    free_ranges_dirty = FREE_RANGES_MAX_COUNT;
+}
+
+/***********************************************************************
+ *           free_ranges_next_fit
+ *
+ * Returns the first range starting from range which is at least size large, or end if there's none.
+ * The tree must be up to date.
+ */
+static struct range_entry *free_ranges_next_fit( struct range_entry *range, size_t size )
+{
+    size_t i;
+
+    if (range >= free_ranges_end) return free_ranges_end;
+    i = FREE_RANGES_MAX_COUNT + (range - free_ranges);
+
+    while (free_ranges_tree[i] < size)
+    {
+        /* move up to the closest subtree on the right */
+        while (i > 1 && (i & 1)) i /= 2;
+        if (i == 1) return free_ranges_end;
+        i++;
+    }
+    while (i < FREE_RANGES_MAX_COUNT) i = free_ranges_tree[2 * i] >= size ? 2 * i : 2 * i + 1;
+    return free_ranges + (i - FREE_RANGES_MAX_COUNT);
+}
+
+/***********************************************************************
+ *           free_ranges_prev_fit
+ *
+ * Returns the last range up to range which is at least size large, or free_ranges - 1 if there's none.
+ * The tree must be up to date.
+ */
+static struct range_entry *free_ranges_prev_fit( struct range_entry *range, size_t size )
+{
+    size_t i;
+
+    if (range < free_ranges) return free_ranges - 1;
+    i = FREE_RANGES_MAX_COUNT + (range - free_ranges);
+
+    while (free_ranges_tree[i] < size)
+    {
+        /* move up to the closest subtree on the left */
+        while (i > 1 && !(i & 1)) i /= 2;
+        if (i == 1) return free_ranges - 1;
+        i--;
+    }
+    while (i < FREE_RANGES_MAX_COUNT) i = free_ranges_tree[2 * i + 1] >= size ? 2 * i + 1 : 2 * i;
+    return free_ranges + (i - FREE_RANGES_MAX_COUNT);
+}
+
 static void dump_free_ranges(void)
 {
     struct range_entry *r;
@@ -1130,6 +1279,7 @@ static void free_ranges_insert_view( struct file_view *view )
     if (range->base > view_base || range->end < view_end)
         ERR( "range %p - %p is already partially mapped\n", view_base, view_end );
     assert( range->base <= view_base && range->end >= view_end );
+    free_ranges_invalidate( range );
 
     /* need to split the range in two */
     if (range->base < view_base && range->end > view_end)
@@ -1213,6 +1363,7 @@ static void free_ranges_remove_view( struct file_view *view )
     if (range->base < view_end && range->end > view_base)
         ERR( "range %p - %p is already partially unmapped\n", view_base, view_end );
     assert( range->end <= view_base || range->base >= view_end );
+    free_ranges_invalidate( range );
 
     /* merge with next if possible */
     if (range->end == view_base && next->base == view_end)
@@ -1547,12 +1698,12 @@ static void VIRTUAL_Dump(void)
     struct file_view *view;
 
     TRACE( "Dump of all virtual memory views:\n" );
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     WINE_RB_FOR_EACH_ENTRY( view, &views_tree, struct file_view, entry )
     {
         dump_view( view );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 }
 #endif
 
@@ -2241,28 +2392,17 @@ static void *alloc_free_area_in_range( struct alloc_area *area, char *base, char
 
 static void *alloc_free_area( char *limit_low, char *limit_high, size_t size, BOOL top_down, int unix_prot, UINT_PTR align_mask )
 {
-    struct range_entry *range, *ranges_start, *ranges_end;
+    struct range_entry *range;
     char *reserve_start, *reserve_end;
     struct alloc_area area;
     char *result = NULL;
     char *base, *end;
-    int ranges_inc;
     UINT status;
 
     TRACE("limit %p-%p, size %p, top_down %#x.\n", limit_low, limit_high, (void *)size, top_down);
 
-    if (top_down)
-    {
-        ranges_start = free_ranges_end - 1;
-        ranges_end = free_ranges - 1;
-        ranges_inc = -1;
-    }
-    else
-    {
-        ranges_start = free_ranges;
-        ranges_end = free_ranges_end;
-        ranges_inc = 1;
-    }
+    free_ranges_update_tree();
+    range = free_ranges_lower_bound( top_down ? limit_high : limit_low );
 
     memset( &area, 0, sizeof(area) );
     area.step = top_down ? -(align_mask + 1) : (align_mask + 1);
@@ -2274,13 +2414,24 @@ static void *alloc_free_area( char *limit_low, char *limit_high, size_t size, BO
     reserve_start = preload_reserve_start;
     reserve_end = preload_reserve_end;
 
-    for (range = ranges_start; range != ranges_end; range += ranges_inc)
+    /* only visit the ranges that are large enough, the tree lets us skip the others */
+    if (top_down)
+    {
+        if (range == free_ranges_end) range--;
+        range = free_ranges_prev_fit( range, size );
+    }
+    else range = free_ranges_next_fit( range, size );
+
+    for (; range >= free_ranges && range < free_ranges_end;
+         range = top_down ? free_ranges_prev_fit( range - 1, size ) : free_ranges_next_fit( range + 1, size ))
     {
         base = range->base;
         end = range->end;
 
         TRACE("range %p-%p.\n", base, end);
 
+        if (top_down ? (char *)end <= limit_low : (char *)base >= limit_high) break;
+
         if (base < limit_low) base = limit_low;
         if (end > limit_high) end = limit_high;
         if (base > end || end - base < size) continue;
@@ -2426,6 +2577,20 @@ static void clear_native_views(void)
     }
 }
 
+/***********************************************************************
+ *           madvise_huge_pages
+ *
+ * Advise the kernel to back an anonymous range with transparent huge pages.
+ */
+static void madvise_huge_pages( void *base, size_t size )
+{
+#ifdef MADV_HUGEPAGE
+    if (madvise( base, size, MADV_HUGEPAGE ))
+        WARN( "madvise(MADV_HUGEPAGE) failed for %p-%p, err %s.\n", base, (char *)base + size, strerror(errno) );
+#endif
+}
+
+
 /***********************************************************************
  *           map_view
  *
@@ -3076,6 +3241,108 @@ static IMAGE_DATA_DIRECTORY *get_data_dir( IMAGE_NT_HEADERS *nt, SIZE_T total_si
 }
 
 
+/* perf(1) symbol map integration, see tools/perf/Documentation/jit-interface.txt */
+static int perf_map_fd = -1;
+
+struct perf_map_export
+{
+    DWORD       rva;
+    const char *name;
+};
+
+static int compare_perf_map_exports( const void *a, const void *b )
+{
+    const struct perf_map_export *e1 = a, *e2 = b;
+    return e1->rva < e2->rva ? -1 : e1->rva > e2->rva;
+}
+
+static void perf_map_write( const char *base, DWORD start, DWORD end, const char *module, const char *name )
+{
+    char buffer[512];
+    int len;
+
+    if (start >= end) return;
+    if (name) len = snprintf( buffer, sizeof(buffer), "%lx %x %s!%s\n",
+                              (unsigned long)(base + start), (unsigned int)(end - start), module, name );
+    else len = snprintf( buffer, sizeof(buffer), "%lx %x %s+0x%x\n",
+                         (unsigned long)(base + start), (unsigned int)(end - start), module, (unsigned int)start );
+    if (len > 0) write( perf_map_fd, buffer, min( len, sizeof(buffer) - 1 ));
+}
+
+/***********************************************************************
+ *           perf_map_add_module
+ *
+ * Describe the code sections of a PE module in /tmp/perf-<pid>.map, using its exports as
+ * symbols, so that perf can resolve addresses in PE code.
+ */
+static void perf_map_add_module( char *base, SIZE_T total_size, IMAGE_NT_HEADERS *nt,
+                                 const IMAGE_SECTION_HEADER *sections, const WCHAR *filename )
+{
+    const IMAGE_DATA_DIRECTORY *dir = get_data_dir( nt, total_size, IMAGE_DIRECTORY_ENTRY_EXPORT );
+    const IMAGE_EXPORT_DIRECTORY *exports = NULL;
+    struct perf_map_export *syms = NULL;
+    const WCHAR *p;
+    char module[64];
+    DWORD i, j, count = 0, pos, end;
+
+    if (perf_map_fd == -1) return;
+
+    if ((p = wcsrchr( filename, '\\' ))) filename = p + 1;
+    for (i = 0; filename[i] && i < sizeof(module) - 1; i++) module[i] = filename[i] < 0x80 ? filename[i] : '?';
+    module[i] = 0;
+
+    if (dir && dir->Size >= sizeof(*exports)) exports = (const IMAGE_EXPORT_DIRECTORY *)(base + dir->VirtualAddress);
+    if (exports && exports->NumberOfNames && exports->NumberOfNames <= total_size / sizeof(DWORD) &&
+        exports->AddressOfNames < total_size - exports->NumberOfNames * sizeof(DWORD) &&
+        exports->AddressOfNameOrdinals < total_size - exports->NumberOfNames * sizeof(WORD) &&
+        exports->NumberOfFunctions <= total_size / sizeof(DWORD) &&
+        exports->AddressOfFunctions < total_size - exports->NumberOfFunctions * sizeof(DWORD) &&
+        (syms = malloc( exports->NumberOfNames * sizeof(*syms) )))
+    {
+        const DWORD *functions = (const DWORD *)(base + exports->AddressOfFunctions);
+        const DWORD *names = (const DWORD *)(base + exports->AddressOfNames);
+        const WORD *ordinals = (const WORD *)(base + exports->AddressOfNameOrdinals);
+
+        for (i = 0; i < exports->NumberOfNames; i++)
+        {
+            DWORD rva;
+
+            if (ordinals[i] >= exports->NumberOfFunctions || names[i] >= total_size) continue;
+            if (!(rva = functions[ordinals[i]]) || rva >= total_size) continue;
+            /* skip forwarded exports */
+            if (rva >= dir->VirtualAddress && rva < dir->VirtualAddress + dir->Size) continue;
+            syms[count].rva = rva;
+            syms[count].name = base + names[i];
+            count++;
+        }
+        qsort( syms, count, sizeof(*syms), compare_perf_map_exports );
+    }
+
+    for (i = j = 0; i < nt->FileHeader.NumberOfSections; i++)
+    {
+        if (!(sections[i].Characteristics & IMAGE_SCN_MEM_EXECUTE)) continue;
+        pos = sections[i].VirtualAddress;
+        end = pos + max( sections[i].Misc.VirtualSize, sections[i].SizeOfRawData );
+        if (pos >= total_size) continue;
+        end = min( end, total_size );
+
+        while (j < count && syms[j].rva < pos) j++;
+        for (; j < count && syms[j].rva < end; j++)
+        {
+            /* aliases share the address of the first name */
+            if (syms[j].rva < pos) continue;
+            perf_map_write( base, pos, syms[j].rva, module, NULL );
+            pos = syms[j].rva;
+            while (j + 1 < count && syms[j + 1].rva == pos) j++;
+            perf_map_write( base, pos, j + 1 < count ? min( syms[j + 1].rva, end ) : end, module, syms[j].name );
+            pos = j + 1 < count ? min( syms[j + 1].rva, end ) : end;
+        }
+        perf_map_write( base, pos, end, module, NULL );
+    }
+    free( syms );
+}
+
+
 /***********************************************************************
  *           process_relocation_block
  *
@@ -3137,10 +3404,12 @@ static IMAGE_BASE_RELOCATION *process_relocation_block( char *page, IMAGE_BASE_R
  *
  * Map an executable (PE format) image into an existing view.
  * virtual_mutex must be held by caller.
+ * If cache_fd is valid and *cache_ready is set, the relocated image is mapped from cache_fd;
+ * otherwise the relocated image is written to cache_fd and *cache_ready is set on success.
  */
 static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filename, int fd,
                                      pe_image_info_t *image_info, USHORT machine,
-                                     int shared_fd, BOOL removable )
+                                     int shared_fd, BOOL removable, int cache_fd, BOOL *cache_ready )
 {
     IMAGE_DOS_HEADER *dos;
     IMAGE_NT_HEADERS *nt;
@@ -3154,6 +3423,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     char *header_end;
     char *ptr = view->base;
     SIZE_T header_size, total_size = view->size;
+    client_ptr_t reloc_base = image_info->map_addr;
     INT_PTR delta;
 
     TRACE_(module)( "mapping PE file %s at %p-%p\n", debugstr_w(filename), ptr, ptr + total_size );
@@ -3206,6 +3476,26 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     }
 
 
+    /* the address assigned to the image is taken in this process, so relocate it once to where it
+     * actually is instead of leaving a second relocation pass to the loader; the result can't be
+     * shared with the other processes */
+    if (reloc_base && reloc_base != (ULONG_PTR)ptr)
+    {
+        reloc_base = (ULONG_PTR)ptr;
+        cache_fd = -1;
+    }
+
+#ifndef __aarch64__
+    if (cache_fd != -1 && *cache_ready)
+    {
+        if (machine && machine != nt->FileHeader.Machine) return STATUS_NOT_SUPPORTED;
+        TRACE_(module)( "mapping %s from image cache\n", debugstr_w(filename) );
+        if (map_file_into_view( view, cache_fd, 0, total_size, 0, VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY,
+                                FALSE ) != STATUS_SUCCESS) return status;
+        goto set_protections;
+    }
+#endif
+
     /* map all the sections */
 
     for (i = pos = 0; i < nt->FileHeader.NumberOfSections; i++, sec++)
@@ -3315,15 +3605,15 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
 
     /* relocate to dynamic base */
 
-    if (image_info->map_addr && (delta = image_info->map_addr - image_info->base))
+    if (reloc_base && (delta = reloc_base - image_info->base))
     {
         TRACE_(module)( "relocating %s dynamic base %lx -> %lx mapped at %p\n", debugstr_w(filename),
-                        (ULONG_PTR)image_info->base, (ULONG_PTR)image_info->map_addr, ptr );
+                        (ULONG_PTR)image_info->base, (ULONG_PTR)reloc_base, ptr );
 
         if (nt->OptionalHeader.Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC)
-            ((IMAGE_NT_HEADERS64 *)nt)->OptionalHeader.ImageBase = image_info->map_addr;
+            ((IMAGE_NT_HEADERS64 *)nt)->OptionalHeader.ImageBase = reloc_base;
         else
-            ((IMAGE_NT_HEADERS32 *)nt)->OptionalHeader.ImageBase = image_info->map_addr;
+            ((IMAGE_NT_HEADERS32 *)nt)->OptionalHeader.ImageBase = reloc_base;
 
         if ((dir = get_data_dir( nt, total_size, IMAGE_DIRECTORY_ENTRY_BASERELOC )))
         {
@@ -3332,9 +3622,17 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
 
             while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
                 rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+
+#ifndef __aarch64__
+            /* save the relocated image for the other processes mapping it at the same address */
+            if (cache_fd != -1 && pwrite( cache_fd, ptr, total_size, 0 ) == total_size) *cache_ready = TRUE;
+#endif
         }
     }
 
+#ifndef __aarch64__
+set_protections:
+#endif
     /* set the image protections */
 
     set_vprot( view, ptr, ROUND_SIZE( 0, header_size ), VPROT_COMMITTED | VPROT_READ );
@@ -3363,6 +3661,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     VALGRIND_LOAD_PDB_DEBUGINFO(fd, ptr, total_size, ptr - (char *)wine_server_get_ptr( image_info->base ));
 #endif
     r_debug_add_module( ptr, fd, ptr - (char *)wine_server_get_ptr( image_info->base ) );
+    perf_map_add_module( ptr, total_size, nt, sections, filename );
     return STATUS_SUCCESS;
 }
 
@@ -3475,6 +3774,55 @@ static NTSTATUS map_image_view( struct file_view **view_ret, pe_image_info_t *im
 }
 
 
+/***********************************************************************
+ *             get_image_cache_fd
+ *
+ * Get the file caching the relocated contents of an image mapping.
+ * If it is not ready yet, the caller is expected to fill it.
+ */
+static int get_image_cache_fd( HANDLE mapping, client_ptr_t base, SIZE_T size, BOOL *ready )
+{
+    HANDLE file = 0;
+    int fd = -1, needs_close;
+    struct stat st;
+
+    SERVER_START_REQ( get_image_cache )
+    {
+        req->mapping = wine_server_obj_handle( mapping );
+        req->base    = base;
+        if (!wine_server_call( req ))
+        {
+            file = wine_server_ptr_handle( reply->file );
+            *ready = reply->ready;
+        }
+    }
+    SERVER_END_REQ;
+
+    if (!file) return -1;
+    if (!server_get_unix_fd( file, 0, &fd, &needs_close, NULL, NULL ) && !needs_close) fd = dup( fd );
+    NtClose( file );
+    if (fd != -1 && (fstat( fd, &st ) == -1 || st.st_size < size))
+    {
+        close( fd );
+        fd = -1;
+    }
+    if (fd == -1 && !*ready)
+    {
+        /* discard the cache entry we were supposed to fill */
+        SERVER_START_REQ( set_image_cache_ready )
+        {
+            req->mapping = wine_server_obj_handle( mapping );
+            req->base    = base;
+            req->success = FALSE;
+            wine_server_call( req );
+        }
+        SERVER_END_REQ;
+    }
+    if (fd == -1) *ready = FALSE;
+    return fd;
+}
+
+
 /***********************************************************************
  *             virtual_map_image
  *
@@ -3487,6 +3835,8 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
 {
     int unix_fd = -1, needs_close;
     int shared_fd = -1, shared_needs_close = 0;
+    int cache_fd = -1;
+    BOOL cache_ready = FALSE, is_cached;
     SIZE_T size = image_info->map_size;
     struct file_view *view;
     unsigned int status;
@@ -3514,12 +3864,18 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
         SERVER_END_REQ;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    /* only relocated images differ from the file contents, and those are identical in all processes */
+    if (image_info->map_addr && image_info->map_addr != image_info->base && !shared_file && !needs_close)
+        cache_fd = get_image_cache_fd( mapping, image_info->map_addr, size, &cache_ready );
+    is_cached = cache_ready;
+
+    virtual_enter_exclusive( &sigset );
 
     status = map_image_view( &view, image_info, size, limit_low, limit_high, alloc_type );
     if (status) goto done;
 
-    status = map_image_into_view( view, filename, unix_fd, image_info, machine, shared_fd, needs_close );
+    status = map_image_into_view( view, filename, unix_fd, image_info, machine, shared_fd, needs_close,
+                                  cache_fd, &cache_ready );
     if (status == STATUS_SUCCESS)
     {
         SERVER_START_REQ( map_image_view )
@@ -3543,7 +3899,22 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
     else delete_view( view );
 
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
+    if (cache_fd != -1)
+    {
+        if (!is_cached)
+        {
+            SERVER_START_REQ( set_image_cache_ready )
+            {
+                req->mapping = wine_server_obj_handle( mapping );
+                req->base    = image_info->map_addr;
+                req->success = NT_SUCCESS(status) && cache_ready;
+                wine_server_call( req );
+            }
+            SERVER_END_REQ;
+        }
+        close( cache_fd );
+    }
     if (needs_close) close( unix_fd );
     if (shared_needs_close) close( shared_fd );
     return status;
@@ -3602,11 +3973,13 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
     if (image_info)
     {
         filename = (WCHAR *)(image_info + 1);
+        WINE_PROBE1( wine, image_map_start, filename );
         /* check if we can replace that mapping with the builtin */
         res = load_builtin( image_info, filename, machine, addr_ptr, size_ptr, limit_low, limit_high );
         if (res == STATUS_IMAGE_ALREADY_LOADED)
             res = virtual_map_image( handle, addr_ptr, size_ptr, shared_file, limit_low, limit_high,
                                      alloc_type, machine, image_info, filename, FALSE );
+        WINE_PROBE3( wine, image_map_end, filename, res, *addr_ptr );
         if (shared_file) NtClose( shared_file );
         free( image_info );
         return res;
@@ -3638,7 +4011,7 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
 
     if ((res = server_get_unix_fd( handle, 0, &unix_handle, &needs_close, NULL, NULL ))) return res;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     res = map_view( &view, base, size, alloc_type, vprot, limit_low, limit_high, 0 );
     if (res) goto done;
@@ -3647,6 +4020,8 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
     res = map_file_into_view( view, unix_handle, 0, size, offset.QuadPart, vprot, needs_close );
     if (res == STATUS_SUCCESS)
     {
+        if ((sec_flags & (SEC_LARGE_PAGES | SEC_FILE)) == SEC_LARGE_PAGES) madvise_huge_pages( view->base, size );
+
         SERVER_START_REQ( map_view )
         {
             req->mapping = wine_server_obj_handle( handle );
@@ -3669,7 +4044,7 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
     else delete_view( view );
 
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     if (needs_close) close( unix_handle );
     TRACE("status %#x.\n", res);
     return res;
@@ -3743,6 +4118,19 @@ void virtual_init(void)
     if (use_kernel_writewatch)
         MESSAGE( "wine: using kernel write watches, use_kernel_writewatch %d.\n", use_kernel_writewatch );
 
+    /* WINETHP=<size in MiB>, advise large committed allocations for transparent huge pages */
+    if ((env_var = getenv( "WINEPERFMAP" )) && atoi( env_var ))
+    {
+        char path[64];
+
+        sprintf( path, "/tmp/perf-%d.map", (int)getpid() );
+        if ((perf_map_fd = open( path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 )) == -1)
+            WARN( "failed to open %s, errno %d\n", path, errno );
+    }
+
+    if ((env_var = getenv( "WINETHP" )) && atoi( env_var ) > 0)
+        thp_min_size = max( (SIZE_T)atoi( env_var ) << 20, large_page_size );
+
     if (preload_info && *preload_info)
         for (i = 0; (*preload_info)[i].size; i++)
             mmap_add_reserved_area( (*preload_info)[i].addr, (*preload_info)[i].size );
@@ -3765,15 +4153,16 @@ void virtual_init(void)
     /* try to find space in a reserved area for the views and pages protection table */
 #ifdef _WIN64
     pages_vprot_size = ((size_t)host_addr_space_limit >> page_shift >> pages_vprot_shift) + 1;
-    size = 2 * view_block_size + pages_vprot_size * sizeof(*pages_vprot);
+    size = 3 * view_block_size + pages_vprot_size * sizeof(*pages_vprot);
 #else
-    size = 2 * view_block_size + (1U << (32 - page_shift));
+    size = 3 * view_block_size + (1U << (32 - page_shift));
 #endif
     view_block_start = alloc_virtual_heap( size );
     assert( view_block_start != MAP_FAILED );
     view_block_end = view_block_start + view_block_size / sizeof(*view_block_start);
     free_ranges = (void *)((char *)view_block_start + view_block_size);
-    pages_vprot = (void *)((char *)view_block_start + 2 * view_block_size);
+    free_ranges_tree = (void *)((char *)view_block_start + 2 * view_block_size);
+    pages_vprot = (void *)((char *)view_block_start + 3 * view_block_size);
     wine_rb_init( &views_tree, compare_view );
 
     free_ranges[0].base = (void *)0;
@@ -3942,7 +4331,7 @@ NTSTATUS virtual_create_builtin_view( void *module, const UNICODE_STRING *nt_nam
     void *base = wine_server_get_ptr( info->base );
     int i;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     status = create_view( &view, base, size, SEC_IMAGE | SEC_FILE | VPROT_SYSTEM |
                           VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY | VPROT_EXEC );
     if (!status)
@@ -3979,7 +4368,7 @@ NTSTATUS virtual_create_builtin_view( void *module, const UNICODE_STRING *nt_nam
         }
         else delete_view( view );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 
     return status;
 }
@@ -4150,7 +4539,7 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
     NTSTATUS status = STATUS_SUCCESS;
     SIZE_T block_size = signal_stack_mask + 1;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (next_free_teb)
     {
         ptr = next_free_teb;
@@ -4166,7 +4555,7 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
             if ((status = NtAllocateVirtualMemory( NtCurrentProcess(), &ptr, user_space_wow_limit,
                                                    &total, MEM_RESERVE, PAGE_READWRITE )))
             {
-                server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+                virtual_leave_exclusive( &sigset );
                 return status;
             }
             teb_block = ptr;
@@ -4177,14 +4566,14 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
                                  MEM_COMMIT, PAGE_READWRITE );
     }
     *ret_teb = teb = init_teb( ptr, is_wow64() );
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 
     if ((status = signal_alloc_thread( teb )))
     {
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_enter_exclusive( &sigset );
         *(void **)ptr = next_free_teb;
         next_free_teb = ptr;
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_leave_exclusive( &sigset );
     }
     return status;
 }
@@ -4218,13 +4607,13 @@ void virtual_free_teb( TEB *teb )
         NtFreeVirtualMemory( GetCurrentProcess(), &ptr, &size, MEM_RELEASE );
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     list_remove( &thread_data->entry );
     ptr = teb;
     if (!is_win64) ptr = (char *)ptr - teb_offset;
     *(void **)ptr = next_free_teb;
     next_free_teb = ptr;
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 }
 
 
@@ -4238,7 +4627,7 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 
     if (index < TLS_MINIMUM_AVAILABLE)
     {
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_enter_exclusive( &sigset );
         LIST_FOR_EACH_ENTRY( thread_data, &teb_list, struct ntdll_thread_data, entry )
         {
             TEB *teb = CONTAINING_RECORD( thread_data, TEB, GdiTebBatch );
@@ -4249,14 +4638,14 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 #endif
             teb->TlsSlots[index] = 0;
         }
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_leave_exclusive( &sigset );
     }
     else
     {
         index -= TLS_MINIMUM_AVAILABLE;
         if (index >= 8 * sizeof(peb->TlsExpansionBitmapBits)) return STATUS_INVALID_PARAMETER;
 
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_enter_exclusive( &sigset );
         LIST_FOR_EACH_ENTRY( thread_data, &teb_list, struct ntdll_thread_data, entry )
         {
             TEB *teb = CONTAINING_RECORD( thread_data, TEB, GdiTebBatch );
@@ -4271,7 +4660,7 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 #endif
             if (teb->TlsExpansionSlots) teb->TlsExpansionSlots[index] = 0;
         }
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_leave_exclusive( &sigset );
     }
     return STATUS_SUCCESS;
 }
@@ -4295,7 +4684,7 @@ NTSTATUS virtual_alloc_thread_stack( INITIAL_TEB *stack, ULONG_PTR limit_low, UL
     if (size < 1024 * 1024) size = 1024 * 1024;  /* Xlib needs a large stack */
     size = (size + 0xffff) & ~0xffff;  /* round to 64K boundary */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     status = map_view( &view, NULL, size, 0, VPROT_READ | VPROT_WRITE | VPROT_COMMITTED,
                        limit_low, limit_high, 0 );
@@ -4328,7 +4717,7 @@ NTSTATUS virtual_alloc_thread_stack( INITIAL_TEB *stack, ULONG_PTR limit_low, UL
     stack->StackBase = (char *)view->base + view->size;
     stack->StackLimit = (char *)view->base + (guard_page ? 2 * page_size : 0);
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -4446,7 +4835,9 @@ NTSTATUS virtual_handle_fault( void *addr, DWORD err, void *stack )
     char *page = ROUND_ADDR( addr, page_mask );
     BYTE vprot;
 
+    WINE_PROBE2( wine, page_fault_start, addr, err );
     mutex_lock( &virtual_mutex );  /* no need for signal masking inside signal handler */
+    wait_shared_sections();
     vprot = get_page_vprot( page );
 
 #ifdef __APPLE__
@@ -4499,6 +4890,7 @@ NTSTATUS virtual_handle_fault( void *addr, DWORD err, void *stack )
             set_page_vprot_bits( page, page_size, 0, VPROT_READ | VPROT_EXEC );
     }
     mutex_unlock( &virtual_mutex );
+    WINE_PROBE2( wine, page_fault_end, addr, ret );
     return ret;
 }
 
@@ -4537,6 +4929,7 @@ void *virtual_setup_exception( void *stack_ptr, size_t size, EXCEPTION_RECORD *r
     else if (stack < stack_info.limit)
     {
         mutex_lock( &virtual_mutex );  /* no need for signal masking inside signal handler */
+        wait_shared_sections();
         if ((get_page_vprot( stack ) & VPROT_GUARD) &&
             grow_thread_stack( ROUND_ADDR( stack, page_mask ), &stack_info ))
         {
@@ -4592,14 +4985,14 @@ unsigned int virtual_locked_server_call( void *req_ptr )
 
     if (!size) return wine_server_call( req_ptr );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!(ret = check_write_access( addr, size, &has_write_watch )))
     {
         ret = server_call_unlocked( req );
         if (has_write_watch) update_write_watches( addr, size, wine_server_reply_size( req ));
     }
     else memset( &req->u.reply, 0, sizeof(req->u.reply) );
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return ret;
 }
 
@@ -4616,14 +5009,14 @@ ssize_t virtual_locked_read( int fd, void *addr, size_t size )
     ssize_t ret = read( fd, addr, size );
     if (ret != -1 || use_kernel_writewatch || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!check_write_access( addr, size, &has_write_watch ))
     {
         ret = read( fd, addr, size );
         err = errno;
         if (has_write_watch) update_write_watches( addr, size, max( 0, ret ));
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     errno = err;
     return ret;
 }
@@ -4641,14 +5034,14 @@ ssize_t virtual_locked_pread( int fd, void *addr, size_t size, off_t offset )
     ssize_t ret = pread( fd, addr, size, offset );
     if (ret != -1 || use_kernel_writewatch || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!check_write_access( addr, size, &has_write_watch ))
     {
         ret = pread( fd, addr, size, offset );
         err = errno;
         if (has_write_watch) update_write_watches( addr, size, max( 0, ret ));
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     errno = err;
     return ret;
 }
@@ -4667,7 +5060,7 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
     ssize_t ret = recvmsg( fd, hdr, flags );
     if (ret != -1 || use_kernel_writewatch || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     for (i = 0; i < hdr->msg_iovlen; i++)
         if (check_write_access( hdr->msg_iov[i].iov_base, hdr->msg_iov[i].iov_len, &has_write_watch ))
             break;
@@ -4679,7 +5072,7 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
     if (has_write_watch)
         while (i--) update_write_watches( hdr->msg_iov[i].iov_base, hdr->msg_iov[i].iov_len, 0 );
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     errno = err;
     return ret;
 }
@@ -4694,10 +5087,10 @@ BOOL virtual_is_valid_code_address( const void *addr, SIZE_T size )
     BOOL ret = FALSE;
     sigset_t sigset;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_shared( &sigset );
     if ((view = find_view( addr, size )))
         ret = !(view->protect & VPROT_SYSTEM);  /* system views are not visible to the app */
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_shared( &sigset );
     return ret;
 }
 
@@ -4784,7 +5177,7 @@ SIZE_T virtual_uninterrupted_read_memory( const void *addr, void *buffer, SIZE_T
 
     if (!size) return 0;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if ((view = find_view( addr, size )))
     {
         if (!(view->protect & VPROT_SYSTEM))
@@ -4800,7 +5193,7 @@ SIZE_T virtual_uninterrupted_read_memory( const void *addr, void *buffer, SIZE_T
             }
         }
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return bytes_read;
 }
 
@@ -4820,13 +5213,13 @@ NTSTATUS virtual_uninterrupted_write_memory( void *addr, const void *buffer, SIZ
 
     if (!size) return STATUS_SUCCESS;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!(ret = check_write_access( addr, size, &has_write_watch )))
     {
         memcpy( addr, buffer, size );
         if (has_write_watch) update_write_watches( addr, size, size );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return ret;
 }
 
@@ -4841,7 +5234,7 @@ void virtual_set_force_exec( BOOL enable )
     struct file_view *view;
     sigset_t sigset;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!force_exec_prot != !enable)  /* change all existing views */
     {
         force_exec_prot = enable;
@@ -4859,7 +5252,7 @@ void virtual_set_force_exec( BOOL enable )
             mprotect_range( view->base, view->size, commit, 0 );
         }
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 }
 
 /* free reserved areas within a given range */
@@ -4961,7 +5354,7 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 {
     void *base;
     unsigned int vprot;
-    BOOL is_dos_memory = FALSE;
+    BOOL is_dos_memory = FALSE, huge_pages = FALSE;
     struct file_view *view;
     sigset_t sigset;
     SIZE_T size = *size_ptr;
@@ -5007,9 +5400,24 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
     if (type & MEM_RESERVE_PLACEHOLDER && (protect != PAGE_NOACCESS)) return STATUS_INVALID_PARAMETER;
     if (!arm64ec_view && (attributes & MEM_EXTENDED_PARAMETER_EC_CODE)) return STATUS_INVALID_PARAMETER;
 
+    if (type & MEM_LARGE_PAGES)
+    {
+        /* large pages are reserved and committed at once, with large page granularity */
+        if ((type & (MEM_RESERVE | MEM_COMMIT)) != (MEM_RESERVE | MEM_COMMIT)) return STATUS_INVALID_PARAMETER;
+        if (type & (MEM_WRITE_WATCH | MEM_RESERVE_PLACEHOLDER)) return STATUS_INVALID_PARAMETER;
+        if ((size | (UINT_PTR)base) & (large_page_size - 1)) return STATUS_INVALID_PARAMETER;
+        if (!align) align = large_page_size;
+        huge_pages = TRUE;
+    }
+    else if (thp_min_size && !base && (type & MEM_COMMIT) && !(type & MEM_WRITE_WATCH) && size >= thp_min_size)
+    {
+        if (!align) align = large_page_size;
+        huge_pages = TRUE;
+    }
+
     /* Reserve the memory */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     if ((type & MEM_RESERVE) || !base)
     {
@@ -5025,7 +5433,11 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
             else status = map_view( &view, base, size, type, vprot, limit_low, limit_high,
                                     align ? align - 1 : granularity_mask );
 
-            if (status == STATUS_SUCCESS) base = view->base;
+            if (status == STATUS_SUCCESS)
+            {
+                base = view->base;
+                if (huge_pages) madvise_huge_pages( base, size );
+            }
         }
     }
     else if (type & MEM_RESET)
@@ -5063,7 +5475,7 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
         dump_memory_statistics();
     }
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 
     if (status == STATUS_SUCCESS)
     {
@@ -5084,7 +5496,8 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 NTSTATUS WINAPI NtAllocateVirtualMemory( HANDLE process, PVOID *ret, ULONG_PTR zero_bits,
                                          SIZE_T *size_ptr, ULONG type, ULONG protect )
 {
-    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH | MEM_RESET;
+    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH | MEM_RESET
+                                   | MEM_LARGE_PAGES;
     ULONG_PTR limit;
 
     TRACE("%p %p %08lx %x %08x\n", process, *ret, *size_ptr, (int)type, (int)protect );
@@ -5136,9 +5549,30 @@ NTSTATUS WINAPI NtAllocateVirtualMemory( HANDLE process, PVOID *ret, ULONG_PTR z
 }
 
 
+/* set the preferred NUMA node of a newly allocated range, the pages are not populated yet */
+static void set_numa_node( void *base, SIZE_T size, ULONG node )
+{
+#if defined(__linux__) && defined(__NR_mbind)
+    static const int mpol_preferred = 1;  /* MPOL_PREFERRED from numaif.h */
+    unsigned long mask[2] = { 0 };
+
+    if (node >= sizeof(mask) * 8)
+    {
+        WARN( "node %u out of range\n", (int)node );
+        return;
+    }
+    mask[node / (sizeof(mask[0]) * 8)] = 1ul << (node % (sizeof(mask[0]) * 8));
+    if (syscall( __NR_mbind, base, size, mpol_preferred, mask, sizeof(mask) * 8, 0 ))
+        WARN( "mbind %p-%p node %u failed: %s\n", base, (char *)base + size, (int)node, strerror(errno) );
+#else
+    static int once;
+    if (!once++) FIXME( "NUMA node %u ignored\n", (int)node );
+#endif
+}
+
 static NTSTATUS get_extended_params( const MEM_EXTENDED_PARAMETER *parameters, ULONG count,
                                      ULONG_PTR *limit_low, ULONG_PTR *limit_high, ULONG_PTR *align,
-                                     ULONG *attributes, USHORT *machine )
+                                     ULONG *attributes, USHORT *machine, ULONG *numa_node )
 {
     ULONG i, present = 0;
 
@@ -5201,6 +5635,9 @@ static NTSTATUS get_extended_params( const MEM_EXTENDED_PARAMETER *parameters, U
             break;
 
         case MemExtendedParameterNumaNode:
+            *numa_node = parameters[i].ULong;
+            break;
+
         case MemExtendedParameterPartitionHandle:
         case MemExtendedParameterUserPhysicalHandle:
             FIXME( "Parameter type %d is not supported.\n", parameters[i].Type );
@@ -5224,11 +5661,12 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
                                            ULONG count )
 {
     static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH
-                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER;
+                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER
+                                   | MEM_LARGE_PAGES;
     ULONG_PTR limit_low = 0;
     ULONG_PTR limit_high = 0;
     ULONG_PTR align = 0;
-    ULONG attributes = 0;
+    ULONG attributes = 0, numa_node = NUMA_NO_PREFERRED_NODE;
     USHORT machine = 0;
     unsigned int status;
 
@@ -5236,7 +5674,7 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
           process, *ret, *size_ptr, (int)type, (int)protect, parameters, (int)count );
 
     status = get_extended_params( parameters, count, &limit_low, &limit_high,
-                                  &align, &attributes, &machine );
+                                  &align, &attributes, &machine, &numa_node );
     if (status) return status;
 
     if (type & ~type_mask) return STATUS_INVALID_PARAMETER;
@@ -5259,6 +5697,7 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
         call.virtual_alloc_ex.op_type      = type;
         call.virtual_alloc_ex.prot         = protect;
         call.virtual_alloc_ex.attributes   = attributes;
+        if (numa_node != NUMA_NO_PREFERRED_NODE) FIXME( "NUMA node ignored for other processes\n" );
         status = server_queue_process_apc( process, &call, &result );
         if (status != STATUS_SUCCESS) return status;
 
@@ -5270,8 +5709,10 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
         return result.virtual_alloc_ex.status;
     }
 
-    return allocate_virtual_memory( ret, size_ptr, type, protect,
-                                    limit_low, limit_high, align, attributes );
+    status = allocate_virtual_memory( ret, size_ptr, type, protect,
+                                      limit_low, limit_high, align, attributes );
+    if (!status && numa_node != NUMA_NO_PREFERRED_NODE) set_numa_node( *ret, *size_ptr, numa_node );
+    return status;
 }
 
 
@@ -5317,7 +5758,7 @@ NTSTATUS WINAPI NtFreeVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T *si
     if (size) size = ROUND_SIZE( addr, size );
     base = ROUND_ADDR( addr, page_mask );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     /* avoid freeing the DOS area when a broken app passes a NULL pointer */
     if (!base)
@@ -5364,7 +5805,7 @@ NTSTATUS WINAPI NtFreeVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T *si
     }
 
     dump_memory_statistics();
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -5418,7 +5859,7 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
     size = ROUND_SIZE( addr, size );
     base = ROUND_ADDR( addr, page_mask );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     if ((view = find_view( base, size )))
     {
@@ -5461,7 +5902,7 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
 
     if (!status) VIRTUAL_DEBUG_DUMP_VIEW( view );
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 
     if (status == STATUS_SUCCESS)
     {
@@ -5475,9 +5916,10 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
 
 static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFORMATION *info )
 {
-    char *base, *alloc_base = 0, *alloc_end = working_set_limit;
+    char *base, *alloc_base, *alloc_end;
     struct wine_rb_entry *ptr;
     struct file_view *view;
+    BOOL exclusive = FALSE;
     sigset_t sigset;
 
     base = ROUND_ADDR( addr, page_mask );
@@ -5486,7 +5928,10 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
 
     /* Find the view containing the address */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_shared( &sigset );
+retry:
+    alloc_base = 0;
+    alloc_end = working_set_limit;
     ptr = views_tree.root;
     while (ptr)
     {
@@ -5509,6 +5954,15 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
         }
     }
 
+    /* querying SEC_RESERVE views may update the committed page bits */
+    if (ptr && (view->protect & SEC_RESERVE) && !exclusive)
+    {
+        virtual_leave_shared( &sigset );
+        virtual_enter_exclusive( &sigset );
+        exclusive = TRUE;
+        goto retry;
+    }
+
     /* Fill the info structure */
 
     info->BaseAddress = base;
@@ -5586,7 +6040,8 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
         else if (view->protect & (SEC_FILE | SEC_RESERVE | SEC_COMMIT)) info->Type = MEM_MAPPED;
         else info->Type = MEM_PRIVATE;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    if (exclusive) virtual_leave_exclusive( &sigset );
+    else virtual_leave_shared( &sigset );
 
     return STATUS_SUCCESS;
 }
@@ -5734,6 +6189,20 @@ static void fill_working_set_info( struct fill_working_set_info_data *d, struct
             p->VirtualAttributes.Win32Protection = get_win32_prot( vprot, view->protect );
     }
 }
+
+static SIZE_T get_resident_size( struct fill_working_set_info_data *d, char *base, SIZE_T size )
+{
+    unsigned char vec[256];
+    SIZE_T i, len, count = 0;
+
+    for (; size; base += len, size -= len)
+    {
+        len = min( size, sizeof(vec) << page_shift );
+        if (mincore( base, len, (void *)vec )) break;
+        for (i = 0; i < len >> page_shift; i++) if (vec[i] & 1) count++;
+    }
+    return count << page_shift;
+}
 #else
 static int pagemap_fd = -2;
 
@@ -5807,6 +6276,23 @@ static void fill_working_set_info( struct fill_working_set_info_data *d, struct
             p->VirtualAttributes.Win32Protection = get_win32_prot( vprot, view->protect );
     }
 }
+
+static SIZE_T get_resident_size( struct fill_working_set_info_data *d, char *base, SIZE_T size )
+{
+    SIZE_T page = (UINT_PTR)base >> page_shift, end = page + (size >> page_shift), i, count = 0;
+    ssize_t len;
+
+    if (pagemap_fd == -1) return 0;
+    while (page < end)
+    {
+        len = min( ARRAY_SIZE(d->pm_buffer), end - page ) * sizeof(d->pm_buffer[0]);
+        if ((len = pread( pagemap_fd, d->pm_buffer, len, page * sizeof(d->pm_buffer[0]) )) <= 0) break;
+        len /= sizeof(d->pm_buffer[0]);
+        for (i = 0; i < len; i++) if (d->pm_buffer[i] >> 63) count++;
+        page += len;
+    }
+    return count << page_shift;
+}
 #endif
 
 static int compare_working_set_info_ref( const void *a, const void *b )
@@ -5850,7 +6336,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
     start = ref[0].addr;
     end = ref[count - 1].addr + page_size;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     init_fill_working_set_info_data( &data, end );
 
     view = find_view_range( start, end - start );
@@ -5881,7 +6367,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
 
     free_fill_working_set_info_data( &data );
     if (ref != ref_buffer) free( ref );
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
 
     if (res_len)
         *res_len = len;
@@ -6035,6 +6521,132 @@ static unsigned int get_memory_image_info( HANDLE process, LPCVOID addr, MEMORY_
 }
 
 
+/* check if a private view is a thread stack; virtual_mutex must be held by caller */
+static BOOL is_thread_stack_view( struct file_view *view )
+{
+    struct ntdll_thread_data *thread_data;
+    char *end = (char *)view->base + view->size;
+
+    LIST_FOR_EACH_ENTRY( thread_data, &teb_list, struct ntdll_thread_data, entry )
+    {
+        TEB *teb = CONTAINING_RECORD( thread_data, TEB, GdiTebBatch );
+#ifdef _WIN64
+        WOW_TEB *wow_teb = get_wow_teb( teb );
+        if (wow_teb && ULongToPtr( wow_teb->DeallocationStack ) == view->base) return TRUE;
+#endif
+        if (teb->DeallocationStack == view->base) return TRUE;
+        if ((char *)thread_data->kernel_stack >= (char *)view->base && (char *)thread_data->kernel_stack < end)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* check if a private view starts with a heap header; virtual_mutex must be held by caller */
+static BOOL is_heap_view( struct file_view *view )
+{
+    const DWORD *header = view->base;
+    BYTE vprot = get_page_vprot( view->base );
+
+    if ((vprot & (VPROT_COMMITTED | VPROT_READ | VPROT_GUARD)) != (VPROT_COMMITTED | VPROT_READ)) return FALSE;
+    /* the heap signature is at offset 0x8 in 32-bit heaps and 0x10 in 64-bit heaps */
+    return header[2] == 0xffeeffee || header[4] == 0xffeeffee;
+}
+
+static ULONG get_view_usage_type( struct file_view *view )
+{
+    if (view->protect & VPROT_NATIVE) return MemoryWineUsageUnix;
+    if (view->protect & VPROT_SYSTEM) return MemoryWineUsageSystem;
+    if (view->protect & SEC_IMAGE) return MemoryWineUsageImage;
+    if (view->protect & SEC_FILE) return MemoryWineUsageFile;
+    if (view->protect & (SEC_RESERVE | SEC_COMMIT)) return MemoryWineUsageSection;
+    if (is_thread_stack_view( view )) return MemoryWineUsageStack;
+    if (is_heap_view( view )) return MemoryWineUsageHeap;
+    return MemoryWineUsagePrivate;
+}
+
+/* get the memory usage of the first view ending above addr */
+static NTSTATUS get_memory_usage_info( HANDLE process, LPCVOID addr, MEMORY_WINE_USAGE_INFORMATION *info,
+                                       SIZE_T len, SIZE_T *res_len )
+{
+    struct fill_working_set_info_data data;
+    struct wine_rb_entry *ptr;
+    struct file_view *view = NULL;
+    SIZE_T size;
+    char *base, *end;
+    sigset_t sigset;
+    BYTE vprot;
+
+    if (len < sizeof(*info)) return STATUS_INFO_LENGTH_MISMATCH;
+
+    if (process != NtCurrentProcess())
+    {
+        NTSTATUS status;
+        apc_call_t call;
+        apc_result_t result;
+
+        memset( &call, 0, sizeof(call) );
+
+        call.virtual_usage.type = APC_VIRTUAL_USAGE;
+        call.virtual_usage.addr = wine_server_client_ptr( addr );
+        status = server_queue_process_apc( process, &call, &result );
+        if (status != STATUS_SUCCESS) return status;
+
+        if (result.virtual_usage.status == STATUS_SUCCESS)
+        {
+            info->BaseAddress  = result.virtual_usage.base;
+            info->RegionSize   = result.virtual_usage.size;
+            info->CommitSize   = result.virtual_usage.commit;
+            info->ResidentSize = result.virtual_usage.resident;
+            info->UsageType    = result.virtual_usage.usage;
+            info->Reserved     = 0;
+            if (res_len) *res_len = sizeof(*info);
+        }
+        return result.virtual_usage.status;
+    }
+
+    virtual_enter_shared( &sigset );
+
+    for (ptr = views_tree.root; ptr; )
+    {
+        struct file_view *v = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+        if ((const char *)v->base + v->size > (const char *)addr)
+        {
+            view = v;
+            ptr = ptr->left;
+        }
+        else ptr = ptr->right;
+    }
+
+    if (!view)
+    {
+        virtual_leave_shared( &sigset );
+        return STATUS_NO_MORE_ENTRIES;
+    }
+
+    memset( info, 0, sizeof(*info) );
+    info->BaseAddress = (ULONG_PTR)view->base;
+    info->RegionSize  = view->size;
+    info->UsageType   = get_view_usage_type( view );
+
+    end = (char *)view->base + view->size;
+    init_fill_working_set_info_data( &data, end );
+    for (base = view->base; base != end; base += size)
+    {
+        size = get_vprot_range_size( base, end - base, VPROT_COMMITTED, &vprot );
+        if (!(vprot & VPROT_COMMITTED) && !(view->protect & VPROT_NATIVE)) continue;
+        info->CommitSize += size;
+        info->ResidentSize += get_resident_size( &data, base, size );
+    }
+    free_fill_working_set_info_data( &data );
+
+    virtual_leave_shared( &sigset );
+
+    if (res_len) *res_len = sizeof(*info);
+    return STATUS_SUCCESS;
+}
+
+
 /***********************************************************************
  *             NtQueryVirtualMemory   (NTDLL.@)
  *             ZwQueryVirtualMemory   (NTDLL.@)
@@ -6065,6 +6677,9 @@ NTSTATUS WINAPI NtQueryVirtualMemory( HANDLE process, LPCVOID addr,
         case MemoryImageInformation:
             return get_memory_image_info( process, addr, buffer, len, res_len );
 
+        case MemoryWineUsageInformation:
+            return get_memory_usage_info( process, addr, buffer, len, res_len );
+
         case MemoryWineUnixFuncs:
         case MemoryWineUnixWow64Funcs:
             if (len != sizeof(unixlib_handle_t)) return STATUS_INFO_LENGTH_MISMATCH;
@@ -6245,7 +6860,7 @@ NTSTATUS WINAPI NtMapViewOfSectionEx( HANDLE handle, HANDLE process, PVOID *addr
                                       MEM_EXTENDED_PARAMETER *parameters, ULONG count )
 {
     ULONG_PTR limit_low = 0, limit_high = 0, align = 0;
-    ULONG attributes = 0;
+    ULONG attributes = 0, numa_node = NUMA_NO_PREFERRED_NODE;
     USHORT machine = 0;
     unsigned int status;
     SIZE_T mask = granularity_mask;
@@ -6257,10 +6872,11 @@ NTSTATUS WINAPI NtMapViewOfSectionEx( HANDLE handle, HANDLE process, PVOID *addr
            handle, process, *addr_ptr, wine_dbgstr_longlong(offset.QuadPart), *size_ptr, (int)protect );
 
     status = get_extended_params( parameters, count, &limit_low, &limit_high,
-                                  &align, &attributes, &machine );
+                                  &align, &attributes, &machine, &numa_node );
     if (status) return status;
 
     if (align) return STATUS_INVALID_PARAMETER;
+    if (numa_node != NUMA_NO_PREFERRED_NODE) FIXME( "NUMA node %u ignored for views\n", (int)numa_node );
     if (*addr_ptr && (limit_low || limit_high)) return STATUS_INVALID_PARAMETER;
 
 #ifndef _WIN64
@@ -6333,7 +6949,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
         return status;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!(view = find_view( addr, 0 )) || is_view_valloc( view )) goto done;
 
     if (flags & MEM_PRESERVE_PLACEHOLDER && !(view->protect & VPROT_PLACEHOLDER))
@@ -6352,7 +6968,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
             {
                 TRACE( "not freeing in-use builtin %p\n", view->base );
                 builtin->refcount--;
-                server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+                virtual_leave_exclusive( &sigset );
                 return STATUS_SUCCESS;
             }
         }
@@ -6376,7 +6992,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
     }
     else FIXME( "failed to unmap %p %x\n", view->base, status );
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -6528,7 +7144,7 @@ NTSTATUS WINAPI NtFlushVirtualMemory( HANDLE process, LPCVOID *addr_ptr,
         return result.virtual_flush.status;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
     if (!(view = find_view( addr, *size_ptr ))) status = STATUS_INVALID_PARAMETER;
     else
     {
@@ -6538,7 +7154,7 @@ NTSTATUS WINAPI NtFlushVirtualMemory( HANDLE process, LPCVOID *addr_ptr,
         if (msync( addr, *size_ptr, MS_ASYNC )) status = STATUS_NOT_MAPPED_DATA;
 #endif
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -6565,7 +7181,7 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
     TRACE( "%p %x %p-%p %p %lu\n", process, (int)flags, base, (char *)base + size,
            addresses, *count );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     if (is_write_watch_range( base, size ))
     {
@@ -6582,8 +7198,12 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
 
         while (pos < *count && addr < end)
         {
-            if (!(get_page_vprot( addr ) & VPROT_WRITEWATCH)) addresses[pos++] = addr;
-            addr += page_size;
+            /* skip over whole runs of still watched pages */
+            BYTE vprot;
+            char *run_end = addr + get_vprot_range_size( addr, end - addr, VPROT_WRITEWATCH, &vprot );
+
+            if (vprot & VPROT_WRITEWATCH) addr = run_end;
+            else for (; pos < *count && addr < run_end; addr += page_size) addresses[pos++] = addr;
         }
         if (flags & WRITE_WATCH_FLAG_RESET) reset_write_watches( base, addr - (char *)base );
         *count = pos;
@@ -6592,7 +7212,7 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
     else status = STATUS_INVALID_PARAMETER;
 
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -6613,14 +7233,14 @@ NTSTATUS WINAPI NtResetWriteWatch( HANDLE process, PVOID base, SIZE_T size )
 
     if (!size) return STATUS_INVALID_PARAMETER;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     if (is_write_watch_range( base, size ))
         reset_write_watches( base, size );
     else
         status = STATUS_INVALID_PARAMETER;
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -6749,7 +7369,7 @@ NTSTATUS WINAPI NtAreMappedFilesTheSame(PVOID addr1, PVOID addr2)
 
     TRACE("%p %p\n", addr1, addr2);
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_enter_exclusive( &sigset );
 
     view1 = find_view( addr1, 0 );
     view2 = find_view( addr2, 0 );
@@ -6773,7 +7393,7 @@ NTSTATUS WINAPI NtAreMappedFilesTheSame(PVOID addr1, PVOID addr2)
         SERVER_END_REQ;
     }
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_leave_exclusive( &sigset );
     return status;
 }
 
@@ -20,6 +20,7 @@
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -32,4 +33,45 @@ extern const void *extension_procs[];
 
 extern int WINAPI wglDescribePixelFormat( HDC hdc, int ipfd, UINT cjpfd, PIXELFORMATDESCRIPTOR *ppfd );
 
+/* Calls that don't return anything can be queued in a per-thread batch, which
+ * is sent to the unix side as a whole before any other call is made. */
+struct call_batch
+{
+    UINT used;
+    BOOL flushing;
+    char DECLSPEC_ALIGN(8) data[16384];
+};
+
+extern BOOL batch_calls;
+extern struct call_batch *alloc_call_batch(void);
+extern void flush_call_batch( struct call_batch *batch );
+
+static inline NTSTATUS unix_call( unsigned int code, void *params )
+{
+    struct call_batch *batch = NtCurrentTeb()->glReserved2;
+
+    if (batch && batch->used && !batch->flushing) flush_call_batch( batch );
+    return WINE_UNIX_CALL( code, params );
+}
+
+static inline NTSTATUS batch_call( unsigned int code, void *params, UINT size )
+{
+    UINT call_size = sizeof(struct batched_call) + ((size + 7) & ~7);
+    struct call_batch *batch;
+    struct batched_call *call;
+
+    if (!batch_calls) return WINE_UNIX_CALL( code, params );
+    if (!(batch = NtCurrentTeb()->glReserved2) && !(batch = alloc_call_batch()))
+        return WINE_UNIX_CALL( code, params );
+    if (batch->flushing) return WINE_UNIX_CALL( code, params );
+
+    if (sizeof(batch->data) - batch->used < call_size) flush_call_batch( batch );
+    call = (struct batched_call *)(batch->data + batch->used);
+    call->code = code;
+    call->size = call_size - sizeof(*call);
+    memcpy( call + 1, params, size );
+    batch->used += call_size;
+    return STATUS_SUCCESS;
+}
+
 #endif /* __WINE_OPENGL32_PRIVATE_H */
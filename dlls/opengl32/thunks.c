@@ -84,7 +84,7 @@ void WINAPI glAccum( GLenum op, GLfloat value )
     struct glAccum_params args = { .teb = NtCurrentTeb(), .op = op, .value = value };
     NTSTATUS status;
     TRACE( "op %d, value %f\n", op, value );
-    if ((status = UNIX_CALL( glAccum, &args ))) WARN( "glAccum returned %#lx\n", status );
+    if ((status = BATCH_CALL( glAccum, &args ))) WARN( "glAccum returned %#lx\n", status );
 }
 
 void WINAPI glAlphaFunc( GLenum func, GLfloat ref )
@@ -92,7 +92,7 @@ void WINAPI glAlphaFunc( GLenum func, GLfloat ref )
     struct glAlphaFunc_params args = { .teb = NtCurrentTeb(), .func = func, .ref = ref };
     NTSTATUS status;
     TRACE( "func %d, ref %f\n", func, ref );
-    if ((status = UNIX_CALL( glAlphaFunc, &args ))) WARN( "glAlphaFunc returned %#lx\n", status );
+    if ((status = BATCH_CALL( glAlphaFunc, &args ))) WARN( "glAlphaFunc returned %#lx\n", status );
 }
 
 GLboolean WINAPI glAreTexturesResident( GLsizei n, const GLuint *textures, GLboolean *residences )
@@ -117,7 +117,7 @@ void WINAPI glBegin( GLenum mode )
     struct glBegin_params args = { .teb = NtCurrentTeb(), .mode = mode };
     NTSTATUS status;
     TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glBegin, &args ))) WARN( "glBegin returned %#lx\n", status );
+    if ((status = BATCH_CALL( glBegin, &args ))) WARN( "glBegin returned %#lx\n", status );
 }
 
 void WINAPI glBindTexture( GLenum target, GLuint texture )
@@ -125,7 +125,7 @@ void WINAPI glBindTexture( GLenum target, GLuint texture )
     struct glBindTexture_params args = { .teb = NtCurrentTeb(), .target = target, .texture = texture };
     NTSTATUS status;
     TRACE( "target %d, texture %d\n", target, texture );
-    if ((status = UNIX_CALL( glBindTexture, &args ))) WARN( "glBindTexture returned %#lx\n", status );
+    if ((status = BATCH_CALL( glBindTexture, &args ))) WARN( "glBindTexture returned %#lx\n", status );
 }
 
 void WINAPI glBitmap( GLsizei width, GLsizei height, GLfloat xorig, GLfloat yorig, GLfloat xmove, GLfloat ymove, const GLubyte *bitmap )
@@ -141,7 +141,7 @@ void WINAPI glBlendFunc( GLenum sfactor, GLenum dfactor )
     struct glBlendFunc_params args = { .teb = NtCurrentTeb(), .sfactor = sfactor, .dfactor = dfactor };
     NTSTATUS status;
     TRACE( "sfactor %d, dfactor %d\n", sfactor, dfactor );
-    if ((status = UNIX_CALL( glBlendFunc, &args ))) WARN( "glBlendFunc returned %#lx\n", status );
+    if ((status = BATCH_CALL( glBlendFunc, &args ))) WARN( "glBlendFunc returned %#lx\n", status );
 }
 
 void WINAPI glCallList( GLuint list )
@@ -149,7 +149,7 @@ void WINAPI glCallList( GLuint list )
     struct glCallList_params args = { .teb = NtCurrentTeb(), .list = list };
     NTSTATUS status;
     TRACE( "list %d\n", list );
-    if ((status = UNIX_CALL( glCallList, &args ))) WARN( "glCallList returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCallList, &args ))) WARN( "glCallList returned %#lx\n", status );
 }
 
 void WINAPI glCallLists( GLsizei n, GLenum type, const void *lists )
@@ -165,7 +165,7 @@ void WINAPI glClear( GLbitfield mask )
     struct glClear_params args = { .teb = NtCurrentTeb(), .mask = mask };
     NTSTATUS status;
     TRACE( "mask %d\n", mask );
-    if ((status = UNIX_CALL( glClear, &args ))) WARN( "glClear returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClear, &args ))) WARN( "glClear returned %#lx\n", status );
 }
 
 void WINAPI glClearAccum( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
@@ -173,7 +173,7 @@ void WINAPI glClearAccum( GLfloat red, GLfloat green, GLfloat blue, GLfloat alph
     struct glClearAccum_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glClearAccum, &args ))) WARN( "glClearAccum returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClearAccum, &args ))) WARN( "glClearAccum returned %#lx\n", status );
 }
 
 void WINAPI glClearColor( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
@@ -181,7 +181,7 @@ void WINAPI glClearColor( GLfloat red, GLfloat green, GLfloat blue, GLfloat alph
     struct glClearColor_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glClearColor, &args ))) WARN( "glClearColor returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClearColor, &args ))) WARN( "glClearColor returned %#lx\n", status );
 }
 
 void WINAPI glClearDepth( GLdouble depth )
@@ -189,7 +189,7 @@ void WINAPI glClearDepth( GLdouble depth )
     struct glClearDepth_params args = { .teb = NtCurrentTeb(), .depth = depth };
     NTSTATUS status;
     TRACE( "depth %f\n", depth );
-    if ((status = UNIX_CALL( glClearDepth, &args ))) WARN( "glClearDepth returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClearDepth, &args ))) WARN( "glClearDepth returned %#lx\n", status );
 }
 
 void WINAPI glClearIndex( GLfloat c )
@@ -197,7 +197,7 @@ void WINAPI glClearIndex( GLfloat c )
     struct glClearIndex_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %f\n", c );
-    if ((status = UNIX_CALL( glClearIndex, &args ))) WARN( "glClearIndex returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClearIndex, &args ))) WARN( "glClearIndex returned %#lx\n", status );
 }
 
 void WINAPI glClearStencil( GLint s )
@@ -205,7 +205,7 @@ void WINAPI glClearStencil( GLint s )
     struct glClearStencil_params args = { .teb = NtCurrentTeb(), .s = s };
     NTSTATUS status;
     TRACE( "s %d\n", s );
-    if ((status = UNIX_CALL( glClearStencil, &args ))) WARN( "glClearStencil returned %#lx\n", status );
+    if ((status = BATCH_CALL( glClearStencil, &args ))) WARN( "glClearStencil returned %#lx\n", status );
 }
 
 void WINAPI glClipPlane( GLenum plane, const GLdouble *equation )
@@ -221,7 +221,7 @@ void WINAPI glColor3b( GLbyte red, GLbyte green, GLbyte blue )
     struct glColor3b_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3b, &args ))) WARN( "glColor3b returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3b, &args ))) WARN( "glColor3b returned %#lx\n", status );
 }
 
 void WINAPI glColor3bv( const GLbyte *v )
@@ -237,7 +237,7 @@ void WINAPI glColor3d( GLdouble red, GLdouble green, GLdouble blue )
     struct glColor3d_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3d, &args ))) WARN( "glColor3d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3d, &args ))) WARN( "glColor3d returned %#lx\n", status );
 }
 
 void WINAPI glColor3dv( const GLdouble *v )
@@ -253,7 +253,7 @@ void WINAPI glColor3f( GLfloat red, GLfloat green, GLfloat blue )
     struct glColor3f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3f, &args ))) WARN( "glColor3f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3f, &args ))) WARN( "glColor3f returned %#lx\n", status );
 }
 
 void WINAPI glColor3fv( const GLfloat *v )
@@ -269,7 +269,7 @@ void WINAPI glColor3i( GLint red, GLint green, GLint blue )
     struct glColor3i_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3i, &args ))) WARN( "glColor3i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3i, &args ))) WARN( "glColor3i returned %#lx\n", status );
 }
 
 void WINAPI glColor3iv( const GLint *v )
@@ -285,7 +285,7 @@ void WINAPI glColor3s( GLshort red, GLshort green, GLshort blue )
     struct glColor3s_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3s, &args ))) WARN( "glColor3s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3s, &args ))) WARN( "glColor3s returned %#lx\n", status );
 }
 
 void WINAPI glColor3sv( const GLshort *v )
@@ -301,7 +301,7 @@ void WINAPI glColor3ub( GLubyte red, GLubyte green, GLubyte blue )
     struct glColor3ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3ub, &args ))) WARN( "glColor3ub returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3ub, &args ))) WARN( "glColor3ub returned %#lx\n", status );
 }
 
 void WINAPI glColor3ubv( const GLubyte *v )
@@ -317,7 +317,7 @@ void WINAPI glColor3ui( GLuint red, GLuint green, GLuint blue )
     struct glColor3ui_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3ui, &args ))) WARN( "glColor3ui returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3ui, &args ))) WARN( "glColor3ui returned %#lx\n", status );
 }
 
 void WINAPI glColor3uiv( const GLuint *v )
@@ -333,7 +333,7 @@ void WINAPI glColor3us( GLushort red, GLushort green, GLushort blue )
     struct glColor3us_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3us, &args ))) WARN( "glColor3us returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor3us, &args ))) WARN( "glColor3us returned %#lx\n", status );
 }
 
 void WINAPI glColor3usv( const GLushort *v )
@@ -349,7 +349,7 @@ void WINAPI glColor4b( GLbyte red, GLbyte green, GLbyte blue, GLbyte alpha )
     struct glColor4b_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4b, &args ))) WARN( "glColor4b returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4b, &args ))) WARN( "glColor4b returned %#lx\n", status );
 }
 
 void WINAPI glColor4bv( const GLbyte *v )
@@ -365,7 +365,7 @@ void WINAPI glColor4d( GLdouble red, GLdouble green, GLdouble blue, GLdouble alp
     struct glColor4d_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4d, &args ))) WARN( "glColor4d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4d, &args ))) WARN( "glColor4d returned %#lx\n", status );
 }
 
 void WINAPI glColor4dv( const GLdouble *v )
@@ -381,7 +381,7 @@ void WINAPI glColor4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
     struct glColor4f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4f, &args ))) WARN( "glColor4f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4f, &args ))) WARN( "glColor4f returned %#lx\n", status );
 }
 
 void WINAPI glColor4fv( const GLfloat *v )
@@ -397,7 +397,7 @@ void WINAPI glColor4i( GLint red, GLint green, GLint blue, GLint alpha )
     struct glColor4i_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4i, &args ))) WARN( "glColor4i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4i, &args ))) WARN( "glColor4i returned %#lx\n", status );
 }
 
 void WINAPI glColor4iv( const GLint *v )
@@ -413,7 +413,7 @@ void WINAPI glColor4s( GLshort red, GLshort green, GLshort blue, GLshort alpha )
     struct glColor4s_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4s, &args ))) WARN( "glColor4s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4s, &args ))) WARN( "glColor4s returned %#lx\n", status );
 }
 
 void WINAPI glColor4sv( const GLshort *v )
@@ -429,7 +429,7 @@ void WINAPI glColor4ub( GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha
     struct glColor4ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4ub, &args ))) WARN( "glColor4ub returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4ub, &args ))) WARN( "glColor4ub returned %#lx\n", status );
 }
 
 void WINAPI glColor4ubv( const GLubyte *v )
@@ -445,7 +445,7 @@ void WINAPI glColor4ui( GLuint red, GLuint green, GLuint blue, GLuint alpha )
     struct glColor4ui_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4ui, &args ))) WARN( "glColor4ui returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4ui, &args ))) WARN( "glColor4ui returned %#lx\n", status );
 }
 
 void WINAPI glColor4uiv( const GLuint *v )
@@ -461,7 +461,7 @@ void WINAPI glColor4us( GLushort red, GLushort green, GLushort blue, GLushort al
     struct glColor4us_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4us, &args ))) WARN( "glColor4us returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColor4us, &args ))) WARN( "glColor4us returned %#lx\n", status );
 }
 
 void WINAPI glColor4usv( const GLushort *v )
@@ -477,7 +477,7 @@ void WINAPI glColorMask( GLboolean red, GLboolean green, GLboolean blue, GLboole
     struct glColorMask_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
     NTSTATUS status;
     TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColorMask, &args ))) WARN( "glColorMask returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColorMask, &args ))) WARN( "glColorMask returned %#lx\n", status );
 }
 
 void WINAPI glColorMaterial( GLenum face, GLenum mode )
@@ -485,7 +485,7 @@ void WINAPI glColorMaterial( GLenum face, GLenum mode )
     struct glColorMaterial_params args = { .teb = NtCurrentTeb(), .face = face, .mode = mode };
     NTSTATUS status;
     TRACE( "face %d, mode %d\n", face, mode );
-    if ((status = UNIX_CALL( glColorMaterial, &args ))) WARN( "glColorMaterial returned %#lx\n", status );
+    if ((status = BATCH_CALL( glColorMaterial, &args ))) WARN( "glColorMaterial returned %#lx\n", status );
 }
 
 void WINAPI glColorPointer( GLint size, GLenum type, GLsizei stride, const void *pointer )
@@ -501,7 +501,7 @@ void WINAPI glCopyPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenu
     struct glCopyPixels_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .width = width, .height = height, .type = type };
     NTSTATUS status;
     TRACE( "x %d, y %d, width %d, height %d, type %d\n", x, y, width, height, type );
-    if ((status = UNIX_CALL( glCopyPixels, &args ))) WARN( "glCopyPixels returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCopyPixels, &args ))) WARN( "glCopyPixels returned %#lx\n", status );
 }
 
 void WINAPI glCopyTexImage1D( GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border )
@@ -509,7 +509,7 @@ void WINAPI glCopyTexImage1D( GLenum target, GLint level, GLenum internalformat,
     struct glCopyTexImage1D_params args = { .teb = NtCurrentTeb(), .target = target, .level = level, .internalformat = internalformat, .x = x, .y = y, .width = width, .border = border };
     NTSTATUS status;
     TRACE( "target %d, level %d, internalformat %d, x %d, y %d, width %d, border %d\n", target, level, internalformat, x, y, width, border );
-    if ((status = UNIX_CALL( glCopyTexImage1D, &args ))) WARN( "glCopyTexImage1D returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCopyTexImage1D, &args ))) WARN( "glCopyTexImage1D returned %#lx\n", status );
 }
 
 void WINAPI glCopyTexImage2D( GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border )
@@ -517,7 +517,7 @@ void WINAPI glCopyTexImage2D( GLenum target, GLint level, GLenum internalformat,
     struct glCopyTexImage2D_params args = { .teb = NtCurrentTeb(), .target = target, .level = level, .internalformat = internalformat, .x = x, .y = y, .width = width, .height = height, .border = border };
     NTSTATUS status;
     TRACE( "target %d, level %d, internalformat %d, x %d, y %d, width %d, height %d, border %d\n", target, level, internalformat, x, y, width, height, border );
-    if ((status = UNIX_CALL( glCopyTexImage2D, &args ))) WARN( "glCopyTexImage2D returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCopyTexImage2D, &args ))) WARN( "glCopyTexImage2D returned %#lx\n", status );
 }
 
 void WINAPI glCopyTexSubImage1D( GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width )
@@ -525,7 +525,7 @@ void WINAPI glCopyTexSubImage1D( GLenum target, GLint level, GLint xoffset, GLin
     struct glCopyTexSubImage1D_params args = { .teb = NtCurrentTeb(), .target = target, .level = level, .xoffset = xoffset, .x = x, .y = y, .width = width };
     NTSTATUS status;
     TRACE( "target %d, level %d, xoffset %d, x %d, y %d, width %d\n", target, level, xoffset, x, y, width );
-    if ((status = UNIX_CALL( glCopyTexSubImage1D, &args ))) WARN( "glCopyTexSubImage1D returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCopyTexSubImage1D, &args ))) WARN( "glCopyTexSubImage1D returned %#lx\n", status );
 }
 
 void WINAPI glCopyTexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height )
@@ -533,7 +533,7 @@ void WINAPI glCopyTexSubImage2D( GLenum target, GLint level, GLint xoffset, GLin
     struct glCopyTexSubImage2D_params args = { .teb = NtCurrentTeb(), .target = target, .level = level, .xoffset = xoffset, .yoffset = yoffset, .x = x, .y = y, .width = width, .height = height };
     NTSTATUS status;
     TRACE( "target %d, level %d, xoffset %d, yoffset %d, x %d, y %d, width %d, height %d\n", target, level, xoffset, yoffset, x, y, width, height );
-    if ((status = UNIX_CALL( glCopyTexSubImage2D, &args ))) WARN( "glCopyTexSubImage2D returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCopyTexSubImage2D, &args ))) WARN( "glCopyTexSubImage2D returned %#lx\n", status );
 }
 
 void WINAPI glCullFace( GLenum mode )
@@ -541,7 +541,7 @@ void WINAPI glCullFace( GLenum mode )
     struct glCullFace_params args = { .teb = NtCurrentTeb(), .mode = mode };
     NTSTATUS status;
     TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glCullFace, &args ))) WARN( "glCullFace returned %#lx\n", status );
+    if ((status = BATCH_CALL( glCullFace, &args ))) WARN( "glCullFace returned %#lx\n", status );
 }
 
 void WINAPI glDeleteLists( GLuint list, GLsizei range )
@@ -549,7 +549,7 @@ void WINAPI glDeleteLists( GLuint list, GLsizei range )
     struct glDeleteLists_params args = { .teb = NtCurrentTeb(), .list = list, .range = range };
     NTSTATUS status;
     TRACE( "list %d, range %d\n", list, range );
-    if ((status = UNIX_CALL( glDeleteLists, &args ))) WARN( "glDeleteLists returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDeleteLists, &args ))) WARN( "glDeleteLists returned %#lx\n", status );
 }
 
 void WINAPI glDeleteTextures( GLsizei n, const GLuint *textures )
@@ -565,7 +565,7 @@ void WINAPI glDepthFunc( GLenum func )
     struct glDepthFunc_params args = { .teb = NtCurrentTeb(), .func = func };
     NTSTATUS status;
     TRACE( "func %d\n", func );
-    if ((status = UNIX_CALL( glDepthFunc, &args ))) WARN( "glDepthFunc returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDepthFunc, &args ))) WARN( "glDepthFunc returned %#lx\n", status );
 }
 
 void WINAPI glDepthMask( GLboolean flag )
@@ -573,7 +573,7 @@ void WINAPI glDepthMask( GLboolean flag )
     struct glDepthMask_params args = { .teb = NtCurrentTeb(), .flag = flag };
     NTSTATUS status;
     TRACE( "flag %d\n", flag );
-    if ((status = UNIX_CALL( glDepthMask, &args ))) WARN( "glDepthMask returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDepthMask, &args ))) WARN( "glDepthMask returned %#lx\n", status );
 }
 
 void WINAPI glDepthRange( GLdouble n, GLdouble f )
@@ -581,7 +581,7 @@ void WINAPI glDepthRange( GLdouble n, GLdouble f )
     struct glDepthRange_params args = { .teb = NtCurrentTeb(), .n = n, .f = f };
     NTSTATUS status;
     TRACE( "n %f, f %f\n", n, f );
-    if ((status = UNIX_CALL( glDepthRange, &args ))) WARN( "glDepthRange returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDepthRange, &args ))) WARN( "glDepthRange returned %#lx\n", status );
 }
 
 void WINAPI glDisable( GLenum cap )
@@ -589,7 +589,7 @@ void WINAPI glDisable( GLenum cap )
     struct glDisable_params args = { .teb = NtCurrentTeb(), .cap = cap };
     NTSTATUS status;
     TRACE( "cap %d\n", cap );
-    if ((status = UNIX_CALL( glDisable, &args ))) WARN( "glDisable returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDisable, &args ))) WARN( "glDisable returned %#lx\n", status );
 }
 
 void WINAPI glDisableClientState( GLenum array )
@@ -597,7 +597,7 @@ void WINAPI glDisableClientState( GLenum array )
     struct glDisableClientState_params args = { .teb = NtCurrentTeb(), .array = array };
     NTSTATUS status;
     TRACE( "array %d\n", array );
-    if ((status = UNIX_CALL( glDisableClientState, &args ))) WARN( "glDisableClientState returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDisableClientState, &args ))) WARN( "glDisableClientState returned %#lx\n", status );
 }
 
 void WINAPI glDrawArrays( GLenum mode, GLint first, GLsizei count )
@@ -613,7 +613,7 @@ void WINAPI glDrawBuffer( GLenum buf )
     struct glDrawBuffer_params args = { .teb = NtCurrentTeb(), .buf = buf };
     NTSTATUS status;
     TRACE( "buf %d\n", buf );
-    if ((status = UNIX_CALL( glDrawBuffer, &args ))) WARN( "glDrawBuffer returned %#lx\n", status );
+    if ((status = BATCH_CALL( glDrawBuffer, &args ))) WARN( "glDrawBuffer returned %#lx\n", status );
 }
 
 void WINAPI glDrawElements( GLenum mode, GLsizei count, GLenum type, const void *indices )
@@ -637,7 +637,7 @@ void WINAPI glEdgeFlag( GLboolean flag )
     struct glEdgeFlag_params args = { .teb = NtCurrentTeb(), .flag = flag };
     NTSTATUS status;
     TRACE( "flag %d\n", flag );
-    if ((status = UNIX_CALL( glEdgeFlag, &args ))) WARN( "glEdgeFlag returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEdgeFlag, &args ))) WARN( "glEdgeFlag returned %#lx\n", status );
 }
 
 void WINAPI glEdgeFlagPointer( GLsizei stride, const void *pointer )
@@ -661,7 +661,7 @@ void WINAPI glEnable( GLenum cap )
     struct glEnable_params args = { .teb = NtCurrentTeb(), .cap = cap };
     NTSTATUS status;
     TRACE( "cap %d\n", cap );
-    if ((status = UNIX_CALL( glEnable, &args ))) WARN( "glEnable returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEnable, &args ))) WARN( "glEnable returned %#lx\n", status );
 }
 
 void WINAPI glEnableClientState( GLenum array )
@@ -669,7 +669,7 @@ void WINAPI glEnableClientState( GLenum array )
     struct glEnableClientState_params args = { .teb = NtCurrentTeb(), .array = array };
     NTSTATUS status;
     TRACE( "array %d\n", array );
-    if ((status = UNIX_CALL( glEnableClientState, &args ))) WARN( "glEnableClientState returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEnableClientState, &args ))) WARN( "glEnableClientState returned %#lx\n", status );
 }
 
 void WINAPI glEnd(void)
@@ -677,7 +677,7 @@ void WINAPI glEnd(void)
     struct glEnd_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glEnd, &args ))) WARN( "glEnd returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEnd, &args ))) WARN( "glEnd returned %#lx\n", status );
 }
 
 void WINAPI glEndList(void)
@@ -685,7 +685,7 @@ void WINAPI glEndList(void)
     struct glEndList_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glEndList, &args ))) WARN( "glEndList returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEndList, &args ))) WARN( "glEndList returned %#lx\n", status );
 }
 
 void WINAPI glEvalCoord1d( GLdouble u )
@@ -693,7 +693,7 @@ void WINAPI glEvalCoord1d( GLdouble u )
     struct glEvalCoord1d_params args = { .teb = NtCurrentTeb(), .u = u };
     NTSTATUS status;
     TRACE( "u %f\n", u );
-    if ((status = UNIX_CALL( glEvalCoord1d, &args ))) WARN( "glEvalCoord1d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalCoord1d, &args ))) WARN( "glEvalCoord1d returned %#lx\n", status );
 }
 
 void WINAPI glEvalCoord1dv( const GLdouble *u )
@@ -709,7 +709,7 @@ void WINAPI glEvalCoord1f( GLfloat u )
     struct glEvalCoord1f_params args = { .teb = NtCurrentTeb(), .u = u };
     NTSTATUS status;
     TRACE( "u %f\n", u );
-    if ((status = UNIX_CALL( glEvalCoord1f, &args ))) WARN( "glEvalCoord1f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalCoord1f, &args ))) WARN( "glEvalCoord1f returned %#lx\n", status );
 }
 
 void WINAPI glEvalCoord1fv( const GLfloat *u )
@@ -725,7 +725,7 @@ void WINAPI glEvalCoord2d( GLdouble u, GLdouble v )
     struct glEvalCoord2d_params args = { .teb = NtCurrentTeb(), .u = u, .v = v };
     NTSTATUS status;
     TRACE( "u %f, v %f\n", u, v );
-    if ((status = UNIX_CALL( glEvalCoord2d, &args ))) WARN( "glEvalCoord2d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalCoord2d, &args ))) WARN( "glEvalCoord2d returned %#lx\n", status );
 }
 
 void WINAPI glEvalCoord2dv( const GLdouble *u )
@@ -741,7 +741,7 @@ void WINAPI glEvalCoord2f( GLfloat u, GLfloat v )
     struct glEvalCoord2f_params args = { .teb = NtCurrentTeb(), .u = u, .v = v };
     NTSTATUS status;
     TRACE( "u %f, v %f\n", u, v );
-    if ((status = UNIX_CALL( glEvalCoord2f, &args ))) WARN( "glEvalCoord2f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalCoord2f, &args ))) WARN( "glEvalCoord2f returned %#lx\n", status );
 }
 
 void WINAPI glEvalCoord2fv( const GLfloat *u )
@@ -757,7 +757,7 @@ void WINAPI glEvalMesh1( GLenum mode, GLint i1, GLint i2 )
     struct glEvalMesh1_params args = { .teb = NtCurrentTeb(), .mode = mode, .i1 = i1, .i2 = i2 };
     NTSTATUS status;
     TRACE( "mode %d, i1 %d, i2 %d\n", mode, i1, i2 );
-    if ((status = UNIX_CALL( glEvalMesh1, &args ))) WARN( "glEvalMesh1 returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalMesh1, &args ))) WARN( "glEvalMesh1 returned %#lx\n", status );
 }
 
 void WINAPI glEvalMesh2( GLenum mode, GLint i1, GLint i2, GLint j1, GLint j2 )
@@ -765,7 +765,7 @@ void WINAPI glEvalMesh2( GLenum mode, GLint i1, GLint i2, GLint j1, GLint j2 )
     struct glEvalMesh2_params args = { .teb = NtCurrentTeb(), .mode = mode, .i1 = i1, .i2 = i2, .j1 = j1, .j2 = j2 };
     NTSTATUS status;
     TRACE( "mode %d, i1 %d, i2 %d, j1 %d, j2 %d\n", mode, i1, i2, j1, j2 );
-    if ((status = UNIX_CALL( glEvalMesh2, &args ))) WARN( "glEvalMesh2 returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalMesh2, &args ))) WARN( "glEvalMesh2 returned %#lx\n", status );
 }
 
 void WINAPI glEvalPoint1( GLint i )
@@ -773,7 +773,7 @@ void WINAPI glEvalPoint1( GLint i )
     struct glEvalPoint1_params args = { .teb = NtCurrentTeb(), .i = i };
     NTSTATUS status;
     TRACE( "i %d\n", i );
-    if ((status = UNIX_CALL( glEvalPoint1, &args ))) WARN( "glEvalPoint1 returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalPoint1, &args ))) WARN( "glEvalPoint1 returned %#lx\n", status );
 }
 
 void WINAPI glEvalPoint2( GLint i, GLint j )
@@ -781,7 +781,7 @@ void WINAPI glEvalPoint2( GLint i, GLint j )
     struct glEvalPoint2_params args = { .teb = NtCurrentTeb(), .i = i, .j = j };
     NTSTATUS status;
     TRACE( "i %d, j %d\n", i, j );
-    if ((status = UNIX_CALL( glEvalPoint2, &args ))) WARN( "glEvalPoint2 returned %#lx\n", status );
+    if ((status = BATCH_CALL( glEvalPoint2, &args ))) WARN( "glEvalPoint2 returned %#lx\n", status );
 }
 
 void WINAPI glFeedbackBuffer( GLsizei size, GLenum type, GLfloat *buffer )
@@ -813,7 +813,7 @@ void WINAPI glFogf( GLenum pname, GLfloat param )
     struct glFogf_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %f\n", pname, param );
-    if ((status = UNIX_CALL( glFogf, &args ))) WARN( "glFogf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glFogf, &args ))) WARN( "glFogf returned %#lx\n", status );
 }
 
 void WINAPI glFogfv( GLenum pname, const GLfloat *params )
@@ -829,7 +829,7 @@ void WINAPI glFogi( GLenum pname, GLint param )
     struct glFogi_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %d\n", pname, param );
-    if ((status = UNIX_CALL( glFogi, &args ))) WARN( "glFogi returned %#lx\n", status );
+    if ((status = BATCH_CALL( glFogi, &args ))) WARN( "glFogi returned %#lx\n", status );
 }
 
 void WINAPI glFogiv( GLenum pname, const GLint *params )
@@ -845,7 +845,7 @@ void WINAPI glFrontFace( GLenum mode )
     struct glFrontFace_params args = { .teb = NtCurrentTeb(), .mode = mode };
     NTSTATUS status;
     TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glFrontFace, &args ))) WARN( "glFrontFace returned %#lx\n", status );
+    if ((status = BATCH_CALL( glFrontFace, &args ))) WARN( "glFrontFace returned %#lx\n", status );
 }
 
 void WINAPI glFrustum( GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar )
@@ -853,7 +853,7 @@ void WINAPI glFrustum( GLdouble left, GLdouble right, GLdouble bottom, GLdouble
     struct glFrustum_params args = { .teb = NtCurrentTeb(), .left = left, .right = right, .bottom = bottom, .top = top, .zNear = zNear, .zFar = zFar };
     NTSTATUS status;
     TRACE( "left %f, right %f, bottom %f, top %f, zNear %f, zFar %f\n", left, right, bottom, top, zNear, zFar );
-    if ((status = UNIX_CALL( glFrustum, &args ))) WARN( "glFrustum returned %#lx\n", status );
+    if ((status = BATCH_CALL( glFrustum, &args ))) WARN( "glFrustum returned %#lx\n", status );
 }
 
 GLuint WINAPI glGenLists( GLsizei range )
@@ -1103,7 +1103,7 @@ void WINAPI glHint( GLenum target, GLenum mode )
     struct glHint_params args = { .teb = NtCurrentTeb(), .target = target, .mode = mode };
     NTSTATUS status;
     TRACE( "target %d, mode %d\n", target, mode );
-    if ((status = UNIX_CALL( glHint, &args ))) WARN( "glHint returned %#lx\n", status );
+    if ((status = BATCH_CALL( glHint, &args ))) WARN( "glHint returned %#lx\n", status );
 }
 
 void WINAPI glIndexMask( GLuint mask )
@@ -1111,7 +1111,7 @@ void WINAPI glIndexMask( GLuint mask )
     struct glIndexMask_params args = { .teb = NtCurrentTeb(), .mask = mask };
     NTSTATUS status;
     TRACE( "mask %d\n", mask );
-    if ((status = UNIX_CALL( glIndexMask, &args ))) WARN( "glIndexMask returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexMask, &args ))) WARN( "glIndexMask returned %#lx\n", status );
 }
 
 void WINAPI glIndexPointer( GLenum type, GLsizei stride, const void *pointer )
@@ -1127,7 +1127,7 @@ void WINAPI glIndexd( GLdouble c )
     struct glIndexd_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %f\n", c );
-    if ((status = UNIX_CALL( glIndexd, &args ))) WARN( "glIndexd returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexd, &args ))) WARN( "glIndexd returned %#lx\n", status );
 }
 
 void WINAPI glIndexdv( const GLdouble *c )
@@ -1143,7 +1143,7 @@ void WINAPI glIndexf( GLfloat c )
     struct glIndexf_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %f\n", c );
-    if ((status = UNIX_CALL( glIndexf, &args ))) WARN( "glIndexf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexf, &args ))) WARN( "glIndexf returned %#lx\n", status );
 }
 
 void WINAPI glIndexfv( const GLfloat *c )
@@ -1159,7 +1159,7 @@ void WINAPI glIndexi( GLint c )
     struct glIndexi_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %d\n", c );
-    if ((status = UNIX_CALL( glIndexi, &args ))) WARN( "glIndexi returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexi, &args ))) WARN( "glIndexi returned %#lx\n", status );
 }
 
 void WINAPI glIndexiv( const GLint *c )
@@ -1175,7 +1175,7 @@ void WINAPI glIndexs( GLshort c )
     struct glIndexs_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %d\n", c );
-    if ((status = UNIX_CALL( glIndexs, &args ))) WARN( "glIndexs returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexs, &args ))) WARN( "glIndexs returned %#lx\n", status );
 }
 
 void WINAPI glIndexsv( const GLshort *c )
@@ -1191,7 +1191,7 @@ void WINAPI glIndexub( GLubyte c )
     struct glIndexub_params args = { .teb = NtCurrentTeb(), .c = c };
     NTSTATUS status;
     TRACE( "c %d\n", c );
-    if ((status = UNIX_CALL( glIndexub, &args ))) WARN( "glIndexub returned %#lx\n", status );
+    if ((status = BATCH_CALL( glIndexub, &args ))) WARN( "glIndexub returned %#lx\n", status );
 }
 
 void WINAPI glIndexubv( const GLubyte *c )
@@ -1207,7 +1207,7 @@ void WINAPI glInitNames(void)
     struct glInitNames_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glInitNames, &args ))) WARN( "glInitNames returned %#lx\n", status );
+    if ((status = BATCH_CALL( glInitNames, &args ))) WARN( "glInitNames returned %#lx\n", status );
 }
 
 void WINAPI glInterleavedArrays( GLenum format, GLsizei stride, const void *pointer )
@@ -1250,7 +1250,7 @@ void WINAPI glLightModelf( GLenum pname, GLfloat param )
     struct glLightModelf_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %f\n", pname, param );
-    if ((status = UNIX_CALL( glLightModelf, &args ))) WARN( "glLightModelf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLightModelf, &args ))) WARN( "glLightModelf returned %#lx\n", status );
 }
 
 void WINAPI glLightModelfv( GLenum pname, const GLfloat *params )
@@ -1266,7 +1266,7 @@ void WINAPI glLightModeli( GLenum pname, GLint param )
     struct glLightModeli_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %d\n", pname, param );
-    if ((status = UNIX_CALL( glLightModeli, &args ))) WARN( "glLightModeli returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLightModeli, &args ))) WARN( "glLightModeli returned %#lx\n", status );
 }
 
 void WINAPI glLightModeliv( GLenum pname, const GLint *params )
@@ -1282,7 +1282,7 @@ void WINAPI glLightf( GLenum light, GLenum pname, GLfloat param )
     struct glLightf_params args = { .teb = NtCurrentTeb(), .light = light, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "light %d, pname %d, param %f\n", light, pname, param );
-    if ((status = UNIX_CALL( glLightf, &args ))) WARN( "glLightf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLightf, &args ))) WARN( "glLightf returned %#lx\n", status );
 }
 
 void WINAPI glLightfv( GLenum light, GLenum pname, const GLfloat *params )
@@ -1298,7 +1298,7 @@ void WINAPI glLighti( GLenum light, GLenum pname, GLint param )
     struct glLighti_params args = { .teb = NtCurrentTeb(), .light = light, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "light %d, pname %d, param %d\n", light, pname, param );
-    if ((status = UNIX_CALL( glLighti, &args ))) WARN( "glLighti returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLighti, &args ))) WARN( "glLighti returned %#lx\n", status );
 }
 
 void WINAPI glLightiv( GLenum light, GLenum pname, const GLint *params )
@@ -1314,7 +1314,7 @@ void WINAPI glLineStipple( GLint factor, GLushort pattern )
     struct glLineStipple_params args = { .teb = NtCurrentTeb(), .factor = factor, .pattern = pattern };
     NTSTATUS status;
     TRACE( "factor %d, pattern %d\n", factor, pattern );
-    if ((status = UNIX_CALL( glLineStipple, &args ))) WARN( "glLineStipple returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLineStipple, &args ))) WARN( "glLineStipple returned %#lx\n", status );
 }
 
 void WINAPI glLineWidth( GLfloat width )
@@ -1322,7 +1322,7 @@ void WINAPI glLineWidth( GLfloat width )
     struct glLineWidth_params args = { .teb = NtCurrentTeb(), .width = width };
     NTSTATUS status;
     TRACE( "width %f\n", width );
-    if ((status = UNIX_CALL( glLineWidth, &args ))) WARN( "glLineWidth returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLineWidth, &args ))) WARN( "glLineWidth returned %#lx\n", status );
 }
 
 void WINAPI glListBase( GLuint base )
@@ -1330,7 +1330,7 @@ void WINAPI glListBase( GLuint base )
     struct glListBase_params args = { .teb = NtCurrentTeb(), .base = base };
     NTSTATUS status;
     TRACE( "base %d\n", base );
-    if ((status = UNIX_CALL( glListBase, &args ))) WARN( "glListBase returned %#lx\n", status );
+    if ((status = BATCH_CALL( glListBase, &args ))) WARN( "glListBase returned %#lx\n", status );
 }
 
 void WINAPI glLoadIdentity(void)
@@ -1338,7 +1338,7 @@ void WINAPI glLoadIdentity(void)
     struct glLoadIdentity_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glLoadIdentity, &args ))) WARN( "glLoadIdentity returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLoadIdentity, &args ))) WARN( "glLoadIdentity returned %#lx\n", status );
 }
 
 void WINAPI glLoadMatrixd( const GLdouble *m )
@@ -1362,7 +1362,7 @@ void WINAPI glLoadName( GLuint name )
     struct glLoadName_params args = { .teb = NtCurrentTeb(), .name = name };
     NTSTATUS status;
     TRACE( "name %d\n", name );
-    if ((status = UNIX_CALL( glLoadName, &args ))) WARN( "glLoadName returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLoadName, &args ))) WARN( "glLoadName returned %#lx\n", status );
 }
 
 void WINAPI glLogicOp( GLenum opcode )
@@ -1370,7 +1370,7 @@ void WINAPI glLogicOp( GLenum opcode )
     struct glLogicOp_params args = { .teb = NtCurrentTeb(), .opcode = opcode };
     NTSTATUS status;
     TRACE( "opcode %d\n", opcode );
-    if ((status = UNIX_CALL( glLogicOp, &args ))) WARN( "glLogicOp returned %#lx\n", status );
+    if ((status = BATCH_CALL( glLogicOp, &args ))) WARN( "glLogicOp returned %#lx\n", status );
 }
 
 void WINAPI glMap1d( GLenum target, GLdouble u1, GLdouble u2, GLint stride, GLint order, const GLdouble *points )
@@ -1410,7 +1410,7 @@ void WINAPI glMapGrid1d( GLint un, GLdouble u1, GLdouble u2 )
     struct glMapGrid1d_params args = { .teb = NtCurrentTeb(), .un = un, .u1 = u1, .u2 = u2 };
     NTSTATUS status;
     TRACE( "un %d, u1 %f, u2 %f\n", un, u1, u2 );
-    if ((status = UNIX_CALL( glMapGrid1d, &args ))) WARN( "glMapGrid1d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMapGrid1d, &args ))) WARN( "glMapGrid1d returned %#lx\n", status );
 }
 
 void WINAPI glMapGrid1f( GLint un, GLfloat u1, GLfloat u2 )
@@ -1418,7 +1418,7 @@ void WINAPI glMapGrid1f( GLint un, GLfloat u1, GLfloat u2 )
     struct glMapGrid1f_params args = { .teb = NtCurrentTeb(), .un = un, .u1 = u1, .u2 = u2 };
     NTSTATUS status;
     TRACE( "un %d, u1 %f, u2 %f\n", un, u1, u2 );
-    if ((status = UNIX_CALL( glMapGrid1f, &args ))) WARN( "glMapGrid1f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMapGrid1f, &args ))) WARN( "glMapGrid1f returned %#lx\n", status );
 }
 
 void WINAPI glMapGrid2d( GLint un, GLdouble u1, GLdouble u2, GLint vn, GLdouble v1, GLdouble v2 )
@@ -1426,7 +1426,7 @@ void WINAPI glMapGrid2d( GLint un, GLdouble u1, GLdouble u2, GLint vn, GLdouble
     struct glMapGrid2d_params args = { .teb = NtCurrentTeb(), .un = un, .u1 = u1, .u2 = u2, .vn = vn, .v1 = v1, .v2 = v2 };
     NTSTATUS status;
     TRACE( "un %d, u1 %f, u2 %f, vn %d, v1 %f, v2 %f\n", un, u1, u2, vn, v1, v2 );
-    if ((status = UNIX_CALL( glMapGrid2d, &args ))) WARN( "glMapGrid2d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMapGrid2d, &args ))) WARN( "glMapGrid2d returned %#lx\n", status );
 }
 
 void WINAPI glMapGrid2f( GLint un, GLfloat u1, GLfloat u2, GLint vn, GLfloat v1, GLfloat v2 )
@@ -1434,7 +1434,7 @@ void WINAPI glMapGrid2f( GLint un, GLfloat u1, GLfloat u2, GLint vn, GLfloat v1,
     struct glMapGrid2f_params args = { .teb = NtCurrentTeb(), .un = un, .u1 = u1, .u2 = u2, .vn = vn, .v1 = v1, .v2 = v2 };
     NTSTATUS status;
     TRACE( "un %d, u1 %f, u2 %f, vn %d, v1 %f, v2 %f\n", un, u1, u2, vn, v1, v2 );
-    if ((status = UNIX_CALL( glMapGrid2f, &args ))) WARN( "glMapGrid2f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMapGrid2f, &args ))) WARN( "glMapGrid2f returned %#lx\n", status );
 }
 
 void WINAPI glMaterialf( GLenum face, GLenum pname, GLfloat param )
@@ -1442,7 +1442,7 @@ void WINAPI glMaterialf( GLenum face, GLenum pname, GLfloat param )
     struct glMaterialf_params args = { .teb = NtCurrentTeb(), .face = face, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "face %d, pname %d, param %f\n", face, pname, param );
-    if ((status = UNIX_CALL( glMaterialf, &args ))) WARN( "glMaterialf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMaterialf, &args ))) WARN( "glMaterialf returned %#lx\n", status );
 }
 
 void WINAPI glMaterialfv( GLenum face, GLenum pname, const GLfloat *params )
@@ -1458,7 +1458,7 @@ void WINAPI glMateriali( GLenum face, GLenum pname, GLint param )
     struct glMateriali_params args = { .teb = NtCurrentTeb(), .face = face, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "face %d, pname %d, param %d\n", face, pname, param );
-    if ((status = UNIX_CALL( glMateriali, &args ))) WARN( "glMateriali returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMateriali, &args ))) WARN( "glMateriali returned %#lx\n", status );
 }
 
 void WINAPI glMaterialiv( GLenum face, GLenum pname, const GLint *params )
@@ -1474,7 +1474,7 @@ void WINAPI glMatrixMode( GLenum mode )
     struct glMatrixMode_params args = { .teb = NtCurrentTeb(), .mode = mode };
     NTSTATUS status;
     TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glMatrixMode, &args ))) WARN( "glMatrixMode returned %#lx\n", status );
+    if ((status = BATCH_CALL( glMatrixMode, &args ))) WARN( "glMatrixMode returned %#lx\n", status );
 }
 
 void WINAPI glMultMatrixd( const GLdouble *m )
@@ -1498,7 +1498,7 @@ void WINAPI glNewList( GLuint list, GLenum mode )
     struct glNewList_params args = { .teb = NtCurrentTeb(), .list = list, .mode = mode };
     NTSTATUS status;
     TRACE( "list %d, mode %d\n", list, mode );
-    if ((status = UNIX_CALL( glNewList, &args ))) WARN( "glNewList returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNewList, &args ))) WARN( "glNewList returned %#lx\n", status );
 }
 
 void WINAPI glNormal3b( GLbyte nx, GLbyte ny, GLbyte nz )
@@ -1506,7 +1506,7 @@ void WINAPI glNormal3b( GLbyte nx, GLbyte ny, GLbyte nz )
     struct glNormal3b_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
     NTSTATUS status;
     TRACE( "nx %d, ny %d, nz %d\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3b, &args ))) WARN( "glNormal3b returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNormal3b, &args ))) WARN( "glNormal3b returned %#lx\n", status );
 }
 
 void WINAPI glNormal3bv( const GLbyte *v )
@@ -1522,7 +1522,7 @@ void WINAPI glNormal3d( GLdouble nx, GLdouble ny, GLdouble nz )
     struct glNormal3d_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
     NTSTATUS status;
     TRACE( "nx %f, ny %f, nz %f\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3d, &args ))) WARN( "glNormal3d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNormal3d, &args ))) WARN( "glNormal3d returned %#lx\n", status );
 }
 
 void WINAPI glNormal3dv( const GLdouble *v )
@@ -1538,7 +1538,7 @@ void WINAPI glNormal3f( GLfloat nx, GLfloat ny, GLfloat nz )
     struct glNormal3f_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
     NTSTATUS status;
     TRACE( "nx %f, ny %f, nz %f\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3f, &args ))) WARN( "glNormal3f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNormal3f, &args ))) WARN( "glNormal3f returned %#lx\n", status );
 }
 
 void WINAPI glNormal3fv( const GLfloat *v )
@@ -1554,7 +1554,7 @@ void WINAPI glNormal3i( GLint nx, GLint ny, GLint nz )
     struct glNormal3i_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
     NTSTATUS status;
     TRACE( "nx %d, ny %d, nz %d\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3i, &args ))) WARN( "glNormal3i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNormal3i, &args ))) WARN( "glNormal3i returned %#lx\n", status );
 }
 
 void WINAPI glNormal3iv( const GLint *v )
@@ -1570,7 +1570,7 @@ void WINAPI glNormal3s( GLshort nx, GLshort ny, GLshort nz )
     struct glNormal3s_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
     NTSTATUS status;
     TRACE( "nx %d, ny %d, nz %d\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3s, &args ))) WARN( "glNormal3s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glNormal3s, &args ))) WARN( "glNormal3s returned %#lx\n", status );
 }
 
 void WINAPI glNormal3sv( const GLshort *v )
@@ -1594,7 +1594,7 @@ void WINAPI glOrtho( GLdouble left, GLdouble right, GLdouble bottom, GLdouble to
     struct glOrtho_params args = { .teb = NtCurrentTeb(), .left = left, .right = right, .bottom = bottom, .top = top, .zNear = zNear, .zFar = zFar };
     NTSTATUS status;
     TRACE( "left %f, right %f, bottom %f, top %f, zNear %f, zFar %f\n", left, right, bottom, top, zNear, zFar );
-    if ((status = UNIX_CALL( glOrtho, &args ))) WARN( "glOrtho returned %#lx\n", status );
+    if ((status = BATCH_CALL( glOrtho, &args ))) WARN( "glOrtho returned %#lx\n", status );
 }
 
 void WINAPI glPassThrough( GLfloat token )
@@ -1602,7 +1602,7 @@ void WINAPI glPassThrough( GLfloat token )
     struct glPassThrough_params args = { .teb = NtCurrentTeb(), .token = token };
     NTSTATUS status;
     TRACE( "token %f\n", token );
-    if ((status = UNIX_CALL( glPassThrough, &args ))) WARN( "glPassThrough returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPassThrough, &args ))) WARN( "glPassThrough returned %#lx\n", status );
 }
 
 void WINAPI glPixelMapfv( GLenum map, GLsizei mapsize, const GLfloat *values )
@@ -1634,7 +1634,7 @@ void WINAPI glPixelStoref( GLenum pname, GLfloat param )
     struct glPixelStoref_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %f\n", pname, param );
-    if ((status = UNIX_CALL( glPixelStoref, &args ))) WARN( "glPixelStoref returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPixelStoref, &args ))) WARN( "glPixelStoref returned %#lx\n", status );
 }
 
 void WINAPI glPixelStorei( GLenum pname, GLint param )
@@ -1642,7 +1642,7 @@ void WINAPI glPixelStorei( GLenum pname, GLint param )
     struct glPixelStorei_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %d\n", pname, param );
-    if ((status = UNIX_CALL( glPixelStorei, &args ))) WARN( "glPixelStorei returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPixelStorei, &args ))) WARN( "glPixelStorei returned %#lx\n", status );
 }
 
 void WINAPI glPixelTransferf( GLenum pname, GLfloat param )
@@ -1650,7 +1650,7 @@ void WINAPI glPixelTransferf( GLenum pname, GLfloat param )
     struct glPixelTransferf_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %f\n", pname, param );
-    if ((status = UNIX_CALL( glPixelTransferf, &args ))) WARN( "glPixelTransferf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPixelTransferf, &args ))) WARN( "glPixelTransferf returned %#lx\n", status );
 }
 
 void WINAPI glPixelTransferi( GLenum pname, GLint param )
@@ -1658,7 +1658,7 @@ void WINAPI glPixelTransferi( GLenum pname, GLint param )
     struct glPixelTransferi_params args = { .teb = NtCurrentTeb(), .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "pname %d, param %d\n", pname, param );
-    if ((status = UNIX_CALL( glPixelTransferi, &args ))) WARN( "glPixelTransferi returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPixelTransferi, &args ))) WARN( "glPixelTransferi returned %#lx\n", status );
 }
 
 void WINAPI glPixelZoom( GLfloat xfactor, GLfloat yfactor )
@@ -1666,7 +1666,7 @@ void WINAPI glPixelZoom( GLfloat xfactor, GLfloat yfactor )
     struct glPixelZoom_params args = { .teb = NtCurrentTeb(), .xfactor = xfactor, .yfactor = yfactor };
     NTSTATUS status;
     TRACE( "xfactor %f, yfactor %f\n", xfactor, yfactor );
-    if ((status = UNIX_CALL( glPixelZoom, &args ))) WARN( "glPixelZoom returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPixelZoom, &args ))) WARN( "glPixelZoom returned %#lx\n", status );
 }
 
 void WINAPI glPointSize( GLfloat size )
@@ -1674,7 +1674,7 @@ void WINAPI glPointSize( GLfloat size )
     struct glPointSize_params args = { .teb = NtCurrentTeb(), .size = size };
     NTSTATUS status;
     TRACE( "size %f\n", size );
-    if ((status = UNIX_CALL( glPointSize, &args ))) WARN( "glPointSize returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPointSize, &args ))) WARN( "glPointSize returned %#lx\n", status );
 }
 
 void WINAPI glPolygonMode( GLenum face, GLenum mode )
@@ -1682,7 +1682,7 @@ void WINAPI glPolygonMode( GLenum face, GLenum mode )
     struct glPolygonMode_params args = { .teb = NtCurrentTeb(), .face = face, .mode = mode };
     NTSTATUS status;
     TRACE( "face %d, mode %d\n", face, mode );
-    if ((status = UNIX_CALL( glPolygonMode, &args ))) WARN( "glPolygonMode returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPolygonMode, &args ))) WARN( "glPolygonMode returned %#lx\n", status );
 }
 
 void WINAPI glPolygonOffset( GLfloat factor, GLfloat units )
@@ -1690,7 +1690,7 @@ void WINAPI glPolygonOffset( GLfloat factor, GLfloat units )
     struct glPolygonOffset_params args = { .teb = NtCurrentTeb(), .factor = factor, .units = units };
     NTSTATUS status;
     TRACE( "factor %f, units %f\n", factor, units );
-    if ((status = UNIX_CALL( glPolygonOffset, &args ))) WARN( "glPolygonOffset returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPolygonOffset, &args ))) WARN( "glPolygonOffset returned %#lx\n", status );
 }
 
 void WINAPI glPolygonStipple( const GLubyte *mask )
@@ -1706,7 +1706,7 @@ void WINAPI glPopAttrib(void)
     struct glPopAttrib_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glPopAttrib, &args ))) WARN( "glPopAttrib returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPopAttrib, &args ))) WARN( "glPopAttrib returned %#lx\n", status );
 }
 
 void WINAPI glPopClientAttrib(void)
@@ -1714,7 +1714,7 @@ void WINAPI glPopClientAttrib(void)
     struct glPopClientAttrib_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glPopClientAttrib, &args ))) WARN( "glPopClientAttrib returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPopClientAttrib, &args ))) WARN( "glPopClientAttrib returned %#lx\n", status );
 }
 
 void WINAPI glPopMatrix(void)
@@ -1722,7 +1722,7 @@ void WINAPI glPopMatrix(void)
     struct glPopMatrix_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glPopMatrix, &args ))) WARN( "glPopMatrix returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPopMatrix, &args ))) WARN( "glPopMatrix returned %#lx\n", status );
 }
 
 void WINAPI glPopName(void)
@@ -1730,7 +1730,7 @@ void WINAPI glPopName(void)
     struct glPopName_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glPopName, &args ))) WARN( "glPopName returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPopName, &args ))) WARN( "glPopName returned %#lx\n", status );
 }
 
 void WINAPI glPrioritizeTextures( GLsizei n, const GLuint *textures, const GLfloat *priorities )
@@ -1746,7 +1746,7 @@ void WINAPI glPushAttrib( GLbitfield mask )
     struct glPushAttrib_params args = { .teb = NtCurrentTeb(), .mask = mask };
     NTSTATUS status;
     TRACE( "mask %d\n", mask );
-    if ((status = UNIX_CALL( glPushAttrib, &args ))) WARN( "glPushAttrib returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPushAttrib, &args ))) WARN( "glPushAttrib returned %#lx\n", status );
 }
 
 void WINAPI glPushClientAttrib( GLbitfield mask )
@@ -1754,7 +1754,7 @@ void WINAPI glPushClientAttrib( GLbitfield mask )
     struct glPushClientAttrib_params args = { .teb = NtCurrentTeb(), .mask = mask };
     NTSTATUS status;
     TRACE( "mask %d\n", mask );
-    if ((status = UNIX_CALL( glPushClientAttrib, &args ))) WARN( "glPushClientAttrib returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPushClientAttrib, &args ))) WARN( "glPushClientAttrib returned %#lx\n", status );
 }
 
 void WINAPI glPushMatrix(void)
@@ -1762,7 +1762,7 @@ void WINAPI glPushMatrix(void)
     struct glPushMatrix_params args = { .teb = NtCurrentTeb() };
     NTSTATUS status;
     TRACE( "\n" );
-    if ((status = UNIX_CALL( glPushMatrix, &args ))) WARN( "glPushMatrix returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPushMatrix, &args ))) WARN( "glPushMatrix returned %#lx\n", status );
 }
 
 void WINAPI glPushName( GLuint name )
@@ -1770,7 +1770,7 @@ void WINAPI glPushName( GLuint name )
     struct glPushName_params args = { .teb = NtCurrentTeb(), .name = name };
     NTSTATUS status;
     TRACE( "name %d\n", name );
-    if ((status = UNIX_CALL( glPushName, &args ))) WARN( "glPushName returned %#lx\n", status );
+    if ((status = BATCH_CALL( glPushName, &args ))) WARN( "glPushName returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos2d( GLdouble x, GLdouble y )
@@ -1778,7 +1778,7 @@ void WINAPI glRasterPos2d( GLdouble x, GLdouble y )
     struct glRasterPos2d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %f, y %f\n", x, y );
-    if ((status = UNIX_CALL( glRasterPos2d, &args ))) WARN( "glRasterPos2d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos2d, &args ))) WARN( "glRasterPos2d returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos2dv( const GLdouble *v )
@@ -1794,7 +1794,7 @@ void WINAPI glRasterPos2f( GLfloat x, GLfloat y )
     struct glRasterPos2f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %f, y %f\n", x, y );
-    if ((status = UNIX_CALL( glRasterPos2f, &args ))) WARN( "glRasterPos2f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos2f, &args ))) WARN( "glRasterPos2f returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos2fv( const GLfloat *v )
@@ -1810,7 +1810,7 @@ void WINAPI glRasterPos2i( GLint x, GLint y )
     struct glRasterPos2i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %d, y %d\n", x, y );
-    if ((status = UNIX_CALL( glRasterPos2i, &args ))) WARN( "glRasterPos2i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos2i, &args ))) WARN( "glRasterPos2i returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos2iv( const GLint *v )
@@ -1826,7 +1826,7 @@ void WINAPI glRasterPos2s( GLshort x, GLshort y )
     struct glRasterPos2s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %d, y %d\n", x, y );
-    if ((status = UNIX_CALL( glRasterPos2s, &args ))) WARN( "glRasterPos2s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos2s, &args ))) WARN( "glRasterPos2s returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos2sv( const GLshort *v )
@@ -1842,7 +1842,7 @@ void WINAPI glRasterPos3d( GLdouble x, GLdouble y, GLdouble z )
     struct glRasterPos3d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glRasterPos3d, &args ))) WARN( "glRasterPos3d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos3d, &args ))) WARN( "glRasterPos3d returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos3dv( const GLdouble *v )
@@ -1858,7 +1858,7 @@ void WINAPI glRasterPos3f( GLfloat x, GLfloat y, GLfloat z )
     struct glRasterPos3f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glRasterPos3f, &args ))) WARN( "glRasterPos3f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos3f, &args ))) WARN( "glRasterPos3f returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos3fv( const GLfloat *v )
@@ -1874,7 +1874,7 @@ void WINAPI glRasterPos3i( GLint x, GLint y, GLint z )
     struct glRasterPos3i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d\n", x, y, z );
-    if ((status = UNIX_CALL( glRasterPos3i, &args ))) WARN( "glRasterPos3i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos3i, &args ))) WARN( "glRasterPos3i returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos3iv( const GLint *v )
@@ -1890,7 +1890,7 @@ void WINAPI glRasterPos3s( GLshort x, GLshort y, GLshort z )
     struct glRasterPos3s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d\n", x, y, z );
-    if ((status = UNIX_CALL( glRasterPos3s, &args ))) WARN( "glRasterPos3s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos3s, &args ))) WARN( "glRasterPos3s returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos3sv( const GLshort *v )
@@ -1906,7 +1906,7 @@ void WINAPI glRasterPos4d( GLdouble x, GLdouble y, GLdouble z, GLdouble w )
     struct glRasterPos4d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f, w %f\n", x, y, z, w );
-    if ((status = UNIX_CALL( glRasterPos4d, &args ))) WARN( "glRasterPos4d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos4d, &args ))) WARN( "glRasterPos4d returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos4dv( const GLdouble *v )
@@ -1922,7 +1922,7 @@ void WINAPI glRasterPos4f( GLfloat x, GLfloat y, GLfloat z, GLfloat w )
     struct glRasterPos4f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f, w %f\n", x, y, z, w );
-    if ((status = UNIX_CALL( glRasterPos4f, &args ))) WARN( "glRasterPos4f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos4f, &args ))) WARN( "glRasterPos4f returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos4fv( const GLfloat *v )
@@ -1938,7 +1938,7 @@ void WINAPI glRasterPos4i( GLint x, GLint y, GLint z, GLint w )
     struct glRasterPos4i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d, w %d\n", x, y, z, w );
-    if ((status = UNIX_CALL( glRasterPos4i, &args ))) WARN( "glRasterPos4i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos4i, &args ))) WARN( "glRasterPos4i returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos4iv( const GLint *v )
@@ -1954,7 +1954,7 @@ void WINAPI glRasterPos4s( GLshort x, GLshort y, GLshort z, GLshort w )
     struct glRasterPos4s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d, w %d\n", x, y, z, w );
-    if ((status = UNIX_CALL( glRasterPos4s, &args ))) WARN( "glRasterPos4s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRasterPos4s, &args ))) WARN( "glRasterPos4s returned %#lx\n", status );
 }
 
 void WINAPI glRasterPos4sv( const GLshort *v )
@@ -1970,7 +1970,7 @@ void WINAPI glReadBuffer( GLenum src )
     struct glReadBuffer_params args = { .teb = NtCurrentTeb(), .src = src };
     NTSTATUS status;
     TRACE( "src %d\n", src );
-    if ((status = UNIX_CALL( glReadBuffer, &args ))) WARN( "glReadBuffer returned %#lx\n", status );
+    if ((status = BATCH_CALL( glReadBuffer, &args ))) WARN( "glReadBuffer returned %#lx\n", status );
 }
 
 void WINAPI glReadPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels )
@@ -1986,7 +1986,7 @@ void WINAPI glRectd( GLdouble x1, GLdouble y1, GLdouble x2, GLdouble y2 )
     struct glRectd_params args = { .teb = NtCurrentTeb(), .x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2 };
     NTSTATUS status;
     TRACE( "x1 %f, y1 %f, x2 %f, y2 %f\n", x1, y1, x2, y2 );
-    if ((status = UNIX_CALL( glRectd, &args ))) WARN( "glRectd returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRectd, &args ))) WARN( "glRectd returned %#lx\n", status );
 }
 
 void WINAPI glRectdv( const GLdouble *v1, const GLdouble *v2 )
@@ -2002,7 +2002,7 @@ void WINAPI glRectf( GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2 )
     struct glRectf_params args = { .teb = NtCurrentTeb(), .x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2 };
     NTSTATUS status;
     TRACE( "x1 %f, y1 %f, x2 %f, y2 %f\n", x1, y1, x2, y2 );
-    if ((status = UNIX_CALL( glRectf, &args ))) WARN( "glRectf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRectf, &args ))) WARN( "glRectf returned %#lx\n", status );
 }
 
 void WINAPI glRectfv( const GLfloat *v1, const GLfloat *v2 )
@@ -2018,7 +2018,7 @@ void WINAPI glRecti( GLint x1, GLint y1, GLint x2, GLint y2 )
     struct glRecti_params args = { .teb = NtCurrentTeb(), .x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2 };
     NTSTATUS status;
     TRACE( "x1 %d, y1 %d, x2 %d, y2 %d\n", x1, y1, x2, y2 );
-    if ((status = UNIX_CALL( glRecti, &args ))) WARN( "glRecti returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRecti, &args ))) WARN( "glRecti returned %#lx\n", status );
 }
 
 void WINAPI glRectiv( const GLint *v1, const GLint *v2 )
@@ -2034,7 +2034,7 @@ void WINAPI glRects( GLshort x1, GLshort y1, GLshort x2, GLshort y2 )
     struct glRects_params args = { .teb = NtCurrentTeb(), .x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2 };
     NTSTATUS status;
     TRACE( "x1 %d, y1 %d, x2 %d, y2 %d\n", x1, y1, x2, y2 );
-    if ((status = UNIX_CALL( glRects, &args ))) WARN( "glRects returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRects, &args ))) WARN( "glRects returned %#lx\n", status );
 }
 
 void WINAPI glRectsv( const GLshort *v1, const GLshort *v2 )
@@ -2059,7 +2059,7 @@ void WINAPI glRotated( GLdouble angle, GLdouble x, GLdouble y, GLdouble z )
     struct glRotated_params args = { .teb = NtCurrentTeb(), .angle = angle, .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "angle %f, x %f, y %f, z %f\n", angle, x, y, z );
-    if ((status = UNIX_CALL( glRotated, &args ))) WARN( "glRotated returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRotated, &args ))) WARN( "glRotated returned %#lx\n", status );
 }
 
 void WINAPI glRotatef( GLfloat angle, GLfloat x, GLfloat y, GLfloat z )
@@ -2067,7 +2067,7 @@ void WINAPI glRotatef( GLfloat angle, GLfloat x, GLfloat y, GLfloat z )
     struct glRotatef_params args = { .teb = NtCurrentTeb(), .angle = angle, .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "angle %f, x %f, y %f, z %f\n", angle, x, y, z );
-    if ((status = UNIX_CALL( glRotatef, &args ))) WARN( "glRotatef returned %#lx\n", status );
+    if ((status = BATCH_CALL( glRotatef, &args ))) WARN( "glRotatef returned %#lx\n", status );
 }
 
 void WINAPI glScaled( GLdouble x, GLdouble y, GLdouble z )
@@ -2075,7 +2075,7 @@ void WINAPI glScaled( GLdouble x, GLdouble y, GLdouble z )
     struct glScaled_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glScaled, &args ))) WARN( "glScaled returned %#lx\n", status );
+    if ((status = BATCH_CALL( glScaled, &args ))) WARN( "glScaled returned %#lx\n", status );
 }
 
 void WINAPI glScalef( GLfloat x, GLfloat y, GLfloat z )
@@ -2083,7 +2083,7 @@ void WINAPI glScalef( GLfloat x, GLfloat y, GLfloat z )
     struct glScalef_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glScalef, &args ))) WARN( "glScalef returned %#lx\n", status );
+    if ((status = BATCH_CALL( glScalef, &args ))) WARN( "glScalef returned %#lx\n", status );
 }
 
 void WINAPI glScissor( GLint x, GLint y, GLsizei width, GLsizei height )
@@ -2091,7 +2091,7 @@ void WINAPI glScissor( GLint x, GLint y, GLsizei width, GLsizei height )
     struct glScissor_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .width = width, .height = height };
     NTSTATUS status;
     TRACE( "x %d, y %d, width %d, height %d\n", x, y, width, height );
-    if ((status = UNIX_CALL( glScissor, &args ))) WARN( "glScissor returned %#lx\n", status );
+    if ((status = BATCH_CALL( glScissor, &args ))) WARN( "glScissor returned %#lx\n", status );
 }
 
 void WINAPI glSelectBuffer( GLsizei size, GLuint *buffer )
@@ -2107,7 +2107,7 @@ void WINAPI glShadeModel( GLenum mode )
     struct glShadeModel_params args = { .teb = NtCurrentTeb(), .mode = mode };
     NTSTATUS status;
     TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glShadeModel, &args ))) WARN( "glShadeModel returned %#lx\n", status );
+    if ((status = BATCH_CALL( glShadeModel, &args ))) WARN( "glShadeModel returned %#lx\n", status );
 }
 
 void WINAPI glStencilFunc( GLenum func, GLint ref, GLuint mask )
@@ -2115,7 +2115,7 @@ void WINAPI glStencilFunc( GLenum func, GLint ref, GLuint mask )
     struct glStencilFunc_params args = { .teb = NtCurrentTeb(), .func = func, .ref = ref, .mask = mask };
     NTSTATUS status;
     TRACE( "func %d, ref %d, mask %d\n", func, ref, mask );
-    if ((status = UNIX_CALL( glStencilFunc, &args ))) WARN( "glStencilFunc returned %#lx\n", status );
+    if ((status = BATCH_CALL( glStencilFunc, &args ))) WARN( "glStencilFunc returned %#lx\n", status );
 }
 
 void WINAPI glStencilMask( GLuint mask )
@@ -2123,7 +2123,7 @@ void WINAPI glStencilMask( GLuint mask )
     struct glStencilMask_params args = { .teb = NtCurrentTeb(), .mask = mask };
     NTSTATUS status;
     TRACE( "mask %d\n", mask );
-    if ((status = UNIX_CALL( glStencilMask, &args ))) WARN( "glStencilMask returned %#lx\n", status );
+    if ((status = BATCH_CALL( glStencilMask, &args ))) WARN( "glStencilMask returned %#lx\n", status );
 }
 
 void WINAPI glStencilOp( GLenum fail, GLenum zfail, GLenum zpass )
@@ -2131,7 +2131,7 @@ void WINAPI glStencilOp( GLenum fail, GLenum zfail, GLenum zpass )
     struct glStencilOp_params args = { .teb = NtCurrentTeb(), .fail = fail, .zfail = zfail, .zpass = zpass };
     NTSTATUS status;
     TRACE( "fail %d, zfail %d, zpass %d\n", fail, zfail, zpass );
-    if ((status = UNIX_CALL( glStencilOp, &args ))) WARN( "glStencilOp returned %#lx\n", status );
+    if ((status = BATCH_CALL( glStencilOp, &args ))) WARN( "glStencilOp returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord1d( GLdouble s )
@@ -2139,7 +2139,7 @@ void WINAPI glTexCoord1d( GLdouble s )
     struct glTexCoord1d_params args = { .teb = NtCurrentTeb(), .s = s };
     NTSTATUS status;
     TRACE( "s %f\n", s );
-    if ((status = UNIX_CALL( glTexCoord1d, &args ))) WARN( "glTexCoord1d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord1d, &args ))) WARN( "glTexCoord1d returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord1dv( const GLdouble *v )
@@ -2155,7 +2155,7 @@ void WINAPI glTexCoord1f( GLfloat s )
     struct glTexCoord1f_params args = { .teb = NtCurrentTeb(), .s = s };
     NTSTATUS status;
     TRACE( "s %f\n", s );
-    if ((status = UNIX_CALL( glTexCoord1f, &args ))) WARN( "glTexCoord1f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord1f, &args ))) WARN( "glTexCoord1f returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord1fv( const GLfloat *v )
@@ -2171,7 +2171,7 @@ void WINAPI glTexCoord1i( GLint s )
     struct glTexCoord1i_params args = { .teb = NtCurrentTeb(), .s = s };
     NTSTATUS status;
     TRACE( "s %d\n", s );
-    if ((status = UNIX_CALL( glTexCoord1i, &args ))) WARN( "glTexCoord1i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord1i, &args ))) WARN( "glTexCoord1i returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord1iv( const GLint *v )
@@ -2187,7 +2187,7 @@ void WINAPI glTexCoord1s( GLshort s )
     struct glTexCoord1s_params args = { .teb = NtCurrentTeb(), .s = s };
     NTSTATUS status;
     TRACE( "s %d\n", s );
-    if ((status = UNIX_CALL( glTexCoord1s, &args ))) WARN( "glTexCoord1s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord1s, &args ))) WARN( "glTexCoord1s returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord1sv( const GLshort *v )
@@ -2203,7 +2203,7 @@ void WINAPI glTexCoord2d( GLdouble s, GLdouble t )
     struct glTexCoord2d_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
     NTSTATUS status;
     TRACE( "s %f, t %f\n", s, t );
-    if ((status = UNIX_CALL( glTexCoord2d, &args ))) WARN( "glTexCoord2d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord2d, &args ))) WARN( "glTexCoord2d returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord2dv( const GLdouble *v )
@@ -2219,7 +2219,7 @@ void WINAPI glTexCoord2f( GLfloat s, GLfloat t )
     struct glTexCoord2f_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
     NTSTATUS status;
     TRACE( "s %f, t %f\n", s, t );
-    if ((status = UNIX_CALL( glTexCoord2f, &args ))) WARN( "glTexCoord2f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord2f, &args ))) WARN( "glTexCoord2f returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord2fv( const GLfloat *v )
@@ -2235,7 +2235,7 @@ void WINAPI glTexCoord2i( GLint s, GLint t )
     struct glTexCoord2i_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
     NTSTATUS status;
     TRACE( "s %d, t %d\n", s, t );
-    if ((status = UNIX_CALL( glTexCoord2i, &args ))) WARN( "glTexCoord2i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord2i, &args ))) WARN( "glTexCoord2i returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord2iv( const GLint *v )
@@ -2251,7 +2251,7 @@ void WINAPI glTexCoord2s( GLshort s, GLshort t )
     struct glTexCoord2s_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
     NTSTATUS status;
     TRACE( "s %d, t %d\n", s, t );
-    if ((status = UNIX_CALL( glTexCoord2s, &args ))) WARN( "glTexCoord2s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord2s, &args ))) WARN( "glTexCoord2s returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord2sv( const GLshort *v )
@@ -2267,7 +2267,7 @@ void WINAPI glTexCoord3d( GLdouble s, GLdouble t, GLdouble r )
     struct glTexCoord3d_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r };
     NTSTATUS status;
     TRACE( "s %f, t %f, r %f\n", s, t, r );
-    if ((status = UNIX_CALL( glTexCoord3d, &args ))) WARN( "glTexCoord3d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord3d, &args ))) WARN( "glTexCoord3d returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord3dv( const GLdouble *v )
@@ -2283,7 +2283,7 @@ void WINAPI glTexCoord3f( GLfloat s, GLfloat t, GLfloat r )
     struct glTexCoord3f_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r };
     NTSTATUS status;
     TRACE( "s %f, t %f, r %f\n", s, t, r );
-    if ((status = UNIX_CALL( glTexCoord3f, &args ))) WARN( "glTexCoord3f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord3f, &args ))) WARN( "glTexCoord3f returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord3fv( const GLfloat *v )
@@ -2299,7 +2299,7 @@ void WINAPI glTexCoord3i( GLint s, GLint t, GLint r )
     struct glTexCoord3i_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r };
     NTSTATUS status;
     TRACE( "s %d, t %d, r %d\n", s, t, r );
-    if ((status = UNIX_CALL( glTexCoord3i, &args ))) WARN( "glTexCoord3i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord3i, &args ))) WARN( "glTexCoord3i returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord3iv( const GLint *v )
@@ -2315,7 +2315,7 @@ void WINAPI glTexCoord3s( GLshort s, GLshort t, GLshort r )
     struct glTexCoord3s_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r };
     NTSTATUS status;
     TRACE( "s %d, t %d, r %d\n", s, t, r );
-    if ((status = UNIX_CALL( glTexCoord3s, &args ))) WARN( "glTexCoord3s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord3s, &args ))) WARN( "glTexCoord3s returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord3sv( const GLshort *v )
@@ -2331,7 +2331,7 @@ void WINAPI glTexCoord4d( GLdouble s, GLdouble t, GLdouble r, GLdouble q )
     struct glTexCoord4d_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r, .q = q };
     NTSTATUS status;
     TRACE( "s %f, t %f, r %f, q %f\n", s, t, r, q );
-    if ((status = UNIX_CALL( glTexCoord4d, &args ))) WARN( "glTexCoord4d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord4d, &args ))) WARN( "glTexCoord4d returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord4dv( const GLdouble *v )
@@ -2347,7 +2347,7 @@ void WINAPI glTexCoord4f( GLfloat s, GLfloat t, GLfloat r, GLfloat q )
     struct glTexCoord4f_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r, .q = q };
     NTSTATUS status;
     TRACE( "s %f, t %f, r %f, q %f\n", s, t, r, q );
-    if ((status = UNIX_CALL( glTexCoord4f, &args ))) WARN( "glTexCoord4f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord4f, &args ))) WARN( "glTexCoord4f returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord4fv( const GLfloat *v )
@@ -2363,7 +2363,7 @@ void WINAPI glTexCoord4i( GLint s, GLint t, GLint r, GLint q )
     struct glTexCoord4i_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r, .q = q };
     NTSTATUS status;
     TRACE( "s %d, t %d, r %d, q %d\n", s, t, r, q );
-    if ((status = UNIX_CALL( glTexCoord4i, &args ))) WARN( "glTexCoord4i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord4i, &args ))) WARN( "glTexCoord4i returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord4iv( const GLint *v )
@@ -2379,7 +2379,7 @@ void WINAPI glTexCoord4s( GLshort s, GLshort t, GLshort r, GLshort q )
     struct glTexCoord4s_params args = { .teb = NtCurrentTeb(), .s = s, .t = t, .r = r, .q = q };
     NTSTATUS status;
     TRACE( "s %d, t %d, r %d, q %d\n", s, t, r, q );
-    if ((status = UNIX_CALL( glTexCoord4s, &args ))) WARN( "glTexCoord4s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexCoord4s, &args ))) WARN( "glTexCoord4s returned %#lx\n", status );
 }
 
 void WINAPI glTexCoord4sv( const GLshort *v )
@@ -2403,7 +2403,7 @@ void WINAPI glTexEnvf( GLenum target, GLenum pname, GLfloat param )
     struct glTexEnvf_params args = { .teb = NtCurrentTeb(), .target = target, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "target %d, pname %d, param %f\n", target, pname, param );
-    if ((status = UNIX_CALL( glTexEnvf, &args ))) WARN( "glTexEnvf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexEnvf, &args ))) WARN( "glTexEnvf returned %#lx\n", status );
 }
 
 void WINAPI glTexEnvfv( GLenum target, GLenum pname, const GLfloat *params )
@@ -2419,7 +2419,7 @@ void WINAPI glTexEnvi( GLenum target, GLenum pname, GLint param )
     struct glTexEnvi_params args = { .teb = NtCurrentTeb(), .target = target, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "target %d, pname %d, param %d\n", target, pname, param );
-    if ((status = UNIX_CALL( glTexEnvi, &args ))) WARN( "glTexEnvi returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexEnvi, &args ))) WARN( "glTexEnvi returned %#lx\n", status );
 }
 
 void WINAPI glTexEnviv( GLenum target, GLenum pname, const GLint *params )
@@ -2435,7 +2435,7 @@ void WINAPI glTexGend( GLenum coord, GLenum pname, GLdouble param )
     struct glTexGend_params args = { .teb = NtCurrentTeb(), .coord = coord, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "coord %d, pname %d, param %f\n", coord, pname, param );
-    if ((status = UNIX_CALL( glTexGend, &args ))) WARN( "glTexGend returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexGend, &args ))) WARN( "glTexGend returned %#lx\n", status );
 }
 
 void WINAPI glTexGendv( GLenum coord, GLenum pname, const GLdouble *params )
@@ -2451,7 +2451,7 @@ void WINAPI glTexGenf( GLenum coord, GLenum pname, GLfloat param )
     struct glTexGenf_params args = { .teb = NtCurrentTeb(), .coord = coord, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "coord %d, pname %d, param %f\n", coord, pname, param );
-    if ((status = UNIX_CALL( glTexGenf, &args ))) WARN( "glTexGenf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexGenf, &args ))) WARN( "glTexGenf returned %#lx\n", status );
 }
 
 void WINAPI glTexGenfv( GLenum coord, GLenum pname, const GLfloat *params )
@@ -2467,7 +2467,7 @@ void WINAPI glTexGeni( GLenum coord, GLenum pname, GLint param )
     struct glTexGeni_params args = { .teb = NtCurrentTeb(), .coord = coord, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "coord %d, pname %d, param %d\n", coord, pname, param );
-    if ((status = UNIX_CALL( glTexGeni, &args ))) WARN( "glTexGeni returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexGeni, &args ))) WARN( "glTexGeni returned %#lx\n", status );
 }
 
 void WINAPI glTexGeniv( GLenum coord, GLenum pname, const GLint *params )
@@ -2499,7 +2499,7 @@ void WINAPI glTexParameterf( GLenum target, GLenum pname, GLfloat param )
     struct glTexParameterf_params args = { .teb = NtCurrentTeb(), .target = target, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "target %d, pname %d, param %f\n", target, pname, param );
-    if ((status = UNIX_CALL( glTexParameterf, &args ))) WARN( "glTexParameterf returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexParameterf, &args ))) WARN( "glTexParameterf returned %#lx\n", status );
 }
 
 void WINAPI glTexParameterfv( GLenum target, GLenum pname, const GLfloat *params )
@@ -2515,7 +2515,7 @@ void WINAPI glTexParameteri( GLenum target, GLenum pname, GLint param )
     struct glTexParameteri_params args = { .teb = NtCurrentTeb(), .target = target, .pname = pname, .param = param };
     NTSTATUS status;
     TRACE( "target %d, pname %d, param %d\n", target, pname, param );
-    if ((status = UNIX_CALL( glTexParameteri, &args ))) WARN( "glTexParameteri returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTexParameteri, &args ))) WARN( "glTexParameteri returned %#lx\n", status );
 }
 
 void WINAPI glTexParameteriv( GLenum target, GLenum pname, const GLint *params )
@@ -2547,7 +2547,7 @@ void WINAPI glTranslated( GLdouble x, GLdouble y, GLdouble z )
     struct glTranslated_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glTranslated, &args ))) WARN( "glTranslated returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTranslated, &args ))) WARN( "glTranslated returned %#lx\n", status );
 }
 
 void WINAPI glTranslatef( GLfloat x, GLfloat y, GLfloat z )
@@ -2555,7 +2555,7 @@ void WINAPI glTranslatef( GLfloat x, GLfloat y, GLfloat z )
     struct glTranslatef_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glTranslatef, &args ))) WARN( "glTranslatef returned %#lx\n", status );
+    if ((status = BATCH_CALL( glTranslatef, &args ))) WARN( "glTranslatef returned %#lx\n", status );
 }
 
 void WINAPI glVertex2d( GLdouble x, GLdouble y )
@@ -2563,7 +2563,7 @@ void WINAPI glVertex2d( GLdouble x, GLdouble y )
     struct glVertex2d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %f, y %f\n", x, y );
-    if ((status = UNIX_CALL( glVertex2d, &args ))) WARN( "glVertex2d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex2d, &args ))) WARN( "glVertex2d returned %#lx\n", status );
 }
 
 void WINAPI glVertex2dv( const GLdouble *v )
@@ -2579,7 +2579,7 @@ void WINAPI glVertex2f( GLfloat x, GLfloat y )
     struct glVertex2f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %f, y %f\n", x, y );
-    if ((status = UNIX_CALL( glVertex2f, &args ))) WARN( "glVertex2f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex2f, &args ))) WARN( "glVertex2f returned %#lx\n", status );
 }
 
 void WINAPI glVertex2fv( const GLfloat *v )
@@ -2595,7 +2595,7 @@ void WINAPI glVertex2i( GLint x, GLint y )
     struct glVertex2i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %d, y %d\n", x, y );
-    if ((status = UNIX_CALL( glVertex2i, &args ))) WARN( "glVertex2i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex2i, &args ))) WARN( "glVertex2i returned %#lx\n", status );
 }
 
 void WINAPI glVertex2iv( const GLint *v )
@@ -2611,7 +2611,7 @@ void WINAPI glVertex2s( GLshort x, GLshort y )
     struct glVertex2s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
     NTSTATUS status;
     TRACE( "x %d, y %d\n", x, y );
-    if ((status = UNIX_CALL( glVertex2s, &args ))) WARN( "glVertex2s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex2s, &args ))) WARN( "glVertex2s returned %#lx\n", status );
 }
 
 void WINAPI glVertex2sv( const GLshort *v )
@@ -2627,7 +2627,7 @@ void WINAPI glVertex3d( GLdouble x, GLdouble y, GLdouble z )
     struct glVertex3d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3d, &args ))) WARN( "glVertex3d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex3d, &args ))) WARN( "glVertex3d returned %#lx\n", status );
 }
 
 void WINAPI glVertex3dv( const GLdouble *v )
@@ -2643,7 +2643,7 @@ void WINAPI glVertex3f( GLfloat x, GLfloat y, GLfloat z )
     struct glVertex3f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3f, &args ))) WARN( "glVertex3f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex3f, &args ))) WARN( "glVertex3f returned %#lx\n", status );
 }
 
 void WINAPI glVertex3fv( const GLfloat *v )
@@ -2659,7 +2659,7 @@ void WINAPI glVertex3i( GLint x, GLint y, GLint z )
     struct glVertex3i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3i, &args ))) WARN( "glVertex3i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex3i, &args ))) WARN( "glVertex3i returned %#lx\n", status );
 }
 
 void WINAPI glVertex3iv( const GLint *v )
@@ -2675,7 +2675,7 @@ void WINAPI glVertex3s( GLshort x, GLshort y, GLshort z )
     struct glVertex3s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3s, &args ))) WARN( "glVertex3s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex3s, &args ))) WARN( "glVertex3s returned %#lx\n", status );
 }
 
 void WINAPI glVertex3sv( const GLshort *v )
@@ -2691,7 +2691,7 @@ void WINAPI glVertex4d( GLdouble x, GLdouble y, GLdouble z, GLdouble w )
     struct glVertex4d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f, w %f\n", x, y, z, w );
-    if ((status = UNIX_CALL( glVertex4d, &args ))) WARN( "glVertex4d returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex4d, &args ))) WARN( "glVertex4d returned %#lx\n", status );
 }
 
 void WINAPI glVertex4dv( const GLdouble *v )
@@ -2707,7 +2707,7 @@ void WINAPI glVertex4f( GLfloat x, GLfloat y, GLfloat z, GLfloat w )
     struct glVertex4f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %f, y %f, z %f, w %f\n", x, y, z, w );
-    if ((status = UNIX_CALL( glVertex4f, &args ))) WARN( "glVertex4f returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex4f, &args ))) WARN( "glVertex4f returned %#lx\n", status );
 }
 
 void WINAPI glVertex4fv( const GLfloat *v )
@@ -2723,7 +2723,7 @@ void WINAPI glVertex4i( GLint x, GLint y, GLint z, GLint w )
     struct glVertex4i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d, w %d\n", x, y, z, w );
-    if ((status = UNIX_CALL( glVertex4i, &args ))) WARN( "glVertex4i returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex4i, &args ))) WARN( "glVertex4i returned %#lx\n", status );
 }
 
 void WINAPI glVertex4iv( const GLint *v )
@@ -2739,7 +2739,7 @@ void WINAPI glVertex4s( GLshort x, GLshort y, GLshort z, GLshort w )
     struct glVertex4s_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z, .w = w };
     NTSTATUS status;
     TRACE( "x %d, y %d, z %d, w %d\n", x, y, z, w );
-    if ((status = UNIX_CALL( glVertex4s, &args ))) WARN( "glVertex4s returned %#lx\n", status );
+    if ((status = BATCH_CALL( glVertex4s, &args ))) WARN( "glVertex4s returned %#lx\n", status );
 }
 
 void WINAPI glVertex4sv( const GLshort *v )
@@ -2763,7 +2763,7 @@ void WINAPI glViewport( GLint x, GLint y, GLsizei width, GLsizei height )
     struct glViewport_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .width = width, .height = height };
     NTSTATUS status;
     TRACE( "x %d, y %d, width %d, height %d\n", x, y, width, height );
-    if ((status = UNIX_CALL( glViewport, &args ))) WARN( "glViewport returned %#lx\n", status );
+    if ((status = BATCH_CALL( glViewport, &args ))) WARN( "glViewport returned %#lx\n", status );
 }
 
 static void WINAPI glAccumxOES( GLenum op, GLfixed value )
@@ -1157,6 +1157,21 @@ NTSTATUS process_detach( void *args )
     return STATUS_SUCCESS;
 }
 
+/* execute the calls queued by the PE side, in order */
+NTSTATUS call_batch( void *args )
+{
+    struct call_batch_params *params = args;
+    char *ptr = params->data, *end = ptr + params->size;
+
+    while (ptr < end)
+    {
+        struct batched_call *call = (struct batched_call *)ptr;
+        __wine_unix_call_funcs[call->code]( call + 1 );
+        ptr += sizeof(*call) + call->size;
+    }
+    return STATUS_SUCCESS;
+}
+
 #ifdef _WIN64
 
 typedef ULONG PTR32;
@@ -2221,6 +2236,24 @@ NTSTATUS wow64_thread_attach( void *args )
     return thread_attach( get_teb64( (ULONG_PTR)args ));
 }
 
+NTSTATUS wow64_call_batch( void *args )
+{
+    struct
+    {
+        PTR32 data;
+        UINT size;
+    } *params32 = args;
+    char *ptr = UlongToPtr( params32->data ), *end = ptr + params32->size;
+
+    while (ptr < end)
+    {
+        struct batched_call *call = (struct batched_call *)ptr;
+        __wine_unix_call_wow64_funcs[call->code]( call + 1 );
+        ptr += sizeof(*call) + call->size;
+    }
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS wow64_process_detach( void *args )
 {
     NTSTATUS status;
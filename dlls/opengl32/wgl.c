@@ -1092,13 +1092,13 @@ static void *gl_map_buffer( enum unix_funcs code, GLenum target, GLenum access )
 
     TRACE( "target %d, access %d\n", target, access );
 
-    if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+    if (!(status = unix_call( code, &args ))) return args.ret;
 #ifndef _WIN64
     if (status == STATUS_INVALID_ADDRESS)
     {
         TRACE( "Unable to map wow64 buffer directly, using copy buffer!\n" );
         if (!(args.ret = _aligned_malloc( (size_t)args.ret, 16 ))) status = STATUS_NO_MEMORY;
-        else if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+        else if (!(status = unix_call( code, &args ))) return args.ret;
         _aligned_free( args.ret );
     }
 #endif
@@ -1156,13 +1156,13 @@ static void *gl_map_named_buffer( enum unix_funcs code, GLuint buffer, GLenum ac
 
     TRACE( "(%d, %d)\n", buffer, access );
 
-    if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+    if (!(status = unix_call( code, &args ))) return args.ret;
 #ifndef _WIN64
     if (status == STATUS_INVALID_ADDRESS)
     {
         TRACE( "Unable to map wow64 buffer directly, using copy buffer!\n" );
         if (!(args.ret = _aligned_malloc( (size_t)args.ret, 16 ))) status = STATUS_NO_MEMORY;
-        else if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+        else if (!(status = unix_call( code, &args ))) return args.ret;
         _aligned_free( args.ret );
     }
 #endif
@@ -1194,13 +1194,13 @@ static void *gl_map_named_buffer_range( enum unix_funcs code, GLuint buffer, GLi
 
     TRACE( "buffer %d, offset %Id, length %Id, access %d\n", buffer, offset, length, access );
 
-    if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+    if (!(status = unix_call( code, &args ))) return args.ret;
 #ifndef _WIN64
     if (status == STATUS_INVALID_ADDRESS)
     {
         TRACE( "Unable to map wow64 buffer directly, using copy buffer!\n" );
         if (!(args.ret = _aligned_malloc( length, 16 ))) status = STATUS_NO_MEMORY;
-        else if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+        else if (!(status = unix_call( code, &args ))) return args.ret;
         _aligned_free( args.ret );
     }
 #endif
@@ -1232,7 +1232,7 @@ static GLboolean gl_unmap_buffer( enum unix_funcs code, GLenum target )
 
     TRACE( "target %d\n", target );
 
-    if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+    if (!(status = unix_call( code, &args ))) return args.ret;
 #ifndef _WIN64
     if (status == STATUS_INVALID_ADDRESS)
     {
@@ -1269,7 +1269,7 @@ static GLboolean gl_unmap_named_buffer( enum unix_funcs code, GLuint buffer )
 
     TRACE( "buffer %d\n", buffer );
 
-    if (!(status = WINE_UNIX_CALL( code, &args ))) return args.ret;
+    if (!(status = unix_call( code, &args ))) return args.ret;
 #ifndef _WIN64
     if (status == STATUS_INVALID_ADDRESS)
     {
@@ -1442,6 +1442,52 @@ void WINAPI glShaderSourceARB( GLhandleARB shaderObj, GLsizei count, const GLcha
 }
 
 
+BOOL batch_calls;
+
+struct call_batch *alloc_call_batch(void)
+{
+    struct call_batch *batch;
+
+    if (!(batch = malloc( sizeof(*batch) ))) return NULL;
+    batch->used = 0;
+    batch->flushing = FALSE;
+    NtCurrentTeb()->glReserved2 = batch;
+    return batch;
+}
+
+void flush_call_batch( struct call_batch *batch )
+{
+    struct call_batch_params args = { .data = batch->data, .size = batch->used };
+    NTSTATUS status;
+
+    /* the unix side may call back into the application, e.g. for debug messages */
+    batch->flushing = TRUE;
+    if ((status = WINE_UNIX_CALL( unix_call_batch, &args ))) WARN( "call_batch returned %#lx\n", status );
+    batch->used = 0;
+    batch->flushing = FALSE;
+}
+
+static void free_call_batch(void)
+{
+    struct call_batch *batch = NtCurrentTeb()->glReserved2;
+
+    if (!batch) return;
+    if (batch->used) flush_call_batch( batch );
+    NtCurrentTeb()->glReserved2 = NULL;
+    free( batch );
+}
+
+static void init_call_batching(void)
+{
+    DWORD value, size = sizeof(value);
+
+    /* @@ Wine registry key: HKCU\Software\Wine\OpenGL */
+    if (!RegGetValueA( HKEY_CURRENT_USER, "Software\\Wine\\OpenGL", "BatchCalls", RRF_RT_REG_DWORD,
+                       NULL, &value, &size ))
+        batch_calls = !!value;
+    TRACE( "call batching %s\n", batch_calls ? "enabled" : "disabled" );
+}
+
 /***********************************************************************
  *           OpenGL initialisation routine
  */
@@ -1461,6 +1507,7 @@ BOOL WINAPI DllMain( HINSTANCE hinst, DWORD reason, LPVOID reserved )
 
         kernel_callback_table = NtCurrentTeb()->Peb->KernelCallbackTable;
         kernel_callback_table[NtUserCallOpenGLDebugMessageCallback] = call_opengl_debug_message_callback;
+        init_call_batching();
         /* fallthrough */
     case DLL_THREAD_ATTACH:
         if ((status = UNIX_CALL( thread_attach, NtCurrentTeb() )))
@@ -1470,8 +1517,13 @@ BOOL WINAPI DllMain( HINSTANCE hinst, DWORD reason, LPVOID reserved )
         }
         break;
 
+    case DLL_THREAD_DETACH:
+        free_call_batch();
+        break;
+
     case DLL_PROCESS_DETACH:
         if (reserved) break;
+        free_call_batch();
         UNIX_CALL( process_detach, NULL );
 #ifndef _WIN64
         cleanup_wow64_strings();
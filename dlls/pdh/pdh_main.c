@@ -25,6 +25,7 @@
 
 #include "windef.h"
 #include "winbase.h"
+#include "psapi.h"
 
 #include "pdh.h"
 #include "pdhmsg.h"
@@ -79,6 +80,8 @@ struct counter
     void (CALLBACK *collect)( struct counter * );   /* collect callback */
     union value     one;                            /* first value */
     union value     two;                            /* second value */
+    ULONGLONG       last_idle;                      /* idle time at previous collection */
+    ULONGLONG       last_total;                     /* total time at previous collection */
 };
 
 #define PDH_MAGIC_COUNTER   0x50444831 /* 'PDH1' */
@@ -146,9 +149,72 @@ struct source
     LONGLONG        base;                           /* samples per second */
 };
 
+static inline ULONGLONG filetime_to_ull( const FILETIME *ft )
+{
+    return ((ULONGLONG)ft->dwHighDateTime << 32) | ft->dwLowDateTime;
+}
+
+/* busy time over the interval since the previous collection, in 1/10^7 */
 static void CALLBACK collect_processor_time( struct counter *counter )
 {
-    counter->two.largevalue = 500000; /* FIXME */
+    FILETIME idle, kernel, user;
+    ULONGLONG total, delta_total, delta_idle;
+
+    if (!GetSystemTimes( &idle, &kernel, &user ))
+    {
+        counter->status = PDH_CSTATUS_INVALID_DATA;
+        return;
+    }
+
+    /* kernel time includes the idle time */
+    total = filetime_to_ull( &kernel ) + filetime_to_ull( &user );
+    delta_total = total - counter->last_total;
+    delta_idle = filetime_to_ull( &idle ) - counter->last_idle;
+    counter->last_total = total;
+    counter->last_idle = filetime_to_ull( &idle );
+
+    counter->one.largevalue = counter->last_idle;
+    if (!delta_total || delta_idle > delta_total) counter->two.largevalue = 0;
+    else counter->two.largevalue = (delta_total - delta_idle) * 10000000 / delta_total;
+    counter->status = PDH_CSTATUS_VALID_DATA;
+}
+
+static void CALLBACK collect_available_bytes( struct counter *counter )
+{
+    PERFORMANCE_INFORMATION info;
+
+    if (!GetPerformanceInfo( &info, sizeof(info) ))
+    {
+        counter->status = PDH_CSTATUS_INVALID_DATA;
+        return;
+    }
+    counter->two.largevalue = (ULONGLONG)info.PhysicalAvailable * info.PageSize;
+    counter->status = PDH_CSTATUS_VALID_DATA;
+}
+
+static void CALLBACK collect_processes( struct counter *counter )
+{
+    PERFORMANCE_INFORMATION info;
+
+    if (!GetPerformanceInfo( &info, sizeof(info) ))
+    {
+        counter->status = PDH_CSTATUS_INVALID_DATA;
+        return;
+    }
+    counter->two.largevalue = info.ProcessCount;
+    counter->status = PDH_CSTATUS_VALID_DATA;
+}
+
+static void CALLBACK collect_threads( struct counter *counter )
+{
+    PERFORMANCE_INFORMATION info;
+
+    if (!GetPerformanceInfo( &info, sizeof(info) ))
+    {
+        counter->status = PDH_CSTATUS_INVALID_DATA;
+        return;
+    }
+    counter->two.largevalue = info.ThreadCount;
     counter->status = PDH_CSTATUS_VALID_DATA;
 }
 
@@ -165,11 +231,17 @@ static void CALLBACK collect_uptime( struct counter *counter )
 #define TYPE_UPTIME \
     (PERF_SIZE_LARGE | PERF_TYPE_COUNTER | PERF_COUNTER_ELAPSED | PERF_OBJECT_TIMER | PERF_DISPLAY_SECONDS)
 
+#define TYPE_RAWCOUNT \
+    (PERF_SIZE_LARGE | PERF_TYPE_NUMBER | PERF_NUMBER_DECIMAL | PERF_DISPLAY_NO_SUFFIX)
+
 /* counter source registry */
 static const struct source counter_sources[] =
 {
-    { 6,   L"\\Processor(_Total)\\% Processor Time", collect_processor_time, TYPE_PROCESSOR_TIME, -5, 10000000 },
-    { 674, L"\\System\\System Up Time",              collect_uptime,         TYPE_UPTIME,         -3, 1000 }
+    { 6,   L"\\Processor(_Total)\\% Processor Time", collect_processor_time,  TYPE_PROCESSOR_TIME, -5, 10000000 },
+    { 24,  L"\\Memory\\Available Bytes",             collect_available_bytes, TYPE_RAWCOUNT,        0, 0 },
+    { 248, L"\\System\\Processes",                   collect_processes,       TYPE_RAWCOUNT,        0, 0 },
+    { 250, L"\\System\\Threads",                     collect_threads,         TYPE_RAWCOUNT,        0, 0 },
+    { 674, L"\\System\\System Up Time",              collect_uptime,          TYPE_UPTIME,         -3, 1000 }
 };
 
 static BOOL is_local_machine( const WCHAR *name, DWORD len )
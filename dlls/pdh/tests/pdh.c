@@ -392,6 +392,52 @@ static void test_PdhGetFormattedCounterValue( void )
     ok(ret == ERROR_SUCCESS, "PdhCloseQuery failed 0x%08lx\n", ret);
 }
 
+static void test_counter_values( void )
+{
+    static const char * const paths[] =
+    {
+        "\\Memory\\Available Bytes",
+        "\\System\\Processes",
+        "\\System\\Threads",
+    };
+    PDH_HCOUNTER counter, counters[ARRAY_SIZE(paths)];
+    PDH_FMT_COUNTERVALUE value;
+    PDH_HQUERY query;
+    PDH_STATUS ret;
+    unsigned int i;
+
+    ret = PdhOpenQueryA( NULL, 0, &query );
+    ok(ret == ERROR_SUCCESS, "PdhOpenQueryA failed 0x%08lx\n", ret);
+
+    ret = PdhAddCounterA( query, "\\Processor(_Total)\\% Processor Time", 0, &counter );
+    ok(ret == ERROR_SUCCESS, "PdhAddCounterA failed 0x%08lx\n", ret);
+    for (i = 0; i < ARRAY_SIZE(paths); i++)
+    {
+        ret = PdhAddCounterA( query, paths[i], 0, &counters[i] );
+        ok(ret == ERROR_SUCCESS, "%s: PdhAddCounterA failed 0x%08lx\n", paths[i], ret);
+    }
+
+    ret = PdhCollectQueryData( query );
+    ok(ret == ERROR_SUCCESS, "PdhCollectQueryData failed 0x%08lx\n", ret);
+    Sleep( 100 );
+    ret = PdhCollectQueryData( query );
+    ok(ret == ERROR_SUCCESS, "PdhCollectQueryData failed 0x%08lx\n", ret);
+
+    ret = PdhGetFormattedCounterValue( counter, PDH_FMT_DOUBLE, NULL, &value );
+    ok(ret == ERROR_SUCCESS, "PdhGetFormattedCounterValue failed 0x%08lx\n", ret);
+    ok(value.doubleValue >= 0.0 && value.doubleValue <= 100.0, "got processor time %f\n", value.doubleValue);
+
+    for (i = 0; i < ARRAY_SIZE(paths); i++)
+    {
+        ret = PdhGetFormattedCounterValue( counters[i], PDH_FMT_LARGE, NULL, &value );
+        ok(ret == ERROR_SUCCESS, "%s: PdhGetFormattedCounterValue failed 0x%08lx\n", paths[i], ret);
+        ok(value.largeValue > 0, "%s: got %s\n", paths[i], wine_dbgstr_longlong(value.largeValue));
+    }
+
+    ret = PdhCloseQuery( query );
+    ok(ret == ERROR_SUCCESS, "PdhCloseQuery failed 0x%08lx\n", ret);
+}
+
 static void test_PdhGetRawCounterValue( void )
 {
     PDH_STATUS ret;
@@ -1036,6 +1082,7 @@ START_TEST(pdh)
     if (pPdhCollectQueryDataWithTime) test_PdhCollectQueryDataWithTime();
 
     test_PdhGetFormattedCounterValue();
+    test_counter_values();
     test_PdhGetRawCounterValue();
     test_PdhSetCounterScaleFactor();
     test_PdhGetCounterTimeBase();
@@ -55,7 +55,7 @@ typedef struct BaseMemAllocator
     HRESULT (* fnBufferPrepare)(IMemAllocator *, StdMediaSample2 *, DWORD flags);
     HRESULT (* fnBufferReleased)(IMemAllocator *, StdMediaSample2 *);
     void (* fnDestroyed)(IMemAllocator *);
-    HANDLE hSemWaiting;
+    CONDITION_VARIABLE free_cv;
     BOOL bDecommitQueued;
     BOOL bCommitted;
     LONG lWaiting;
@@ -100,7 +100,7 @@ static HRESULT BaseMemAllocator_Init(HRESULT (* fnAlloc)(IMemAllocator *),
     pMemAlloc->fnDestroyed = fnDestroyed;
     pMemAlloc->bDecommitQueued = FALSE;
     pMemAlloc->bCommitted = FALSE;
-    pMemAlloc->hSemWaiting = NULL;
+    InitializeConditionVariable(&pMemAlloc->free_cv);
     pMemAlloc->lWaiting = 0;
     pMemAlloc->pCritSect = pCritSect;
 
@@ -149,7 +149,6 @@ static ULONG WINAPI BaseMemAllocator_Release(IMemAllocator * iface)
 
     if (!ref)
     {
-        CloseHandle(This->hSemWaiting);
         if (This->bCommitted)
             This->fnFree(iface);
 
@@ -239,19 +238,11 @@ static HRESULT WINAPI BaseMemAllocator_Commit(IMemAllocator * iface)
             hr = S_OK;
         else
         {
-            if (!(This->hSemWaiting = CreateSemaphoreW(NULL, This->props.cBuffers, This->props.cBuffers, NULL)))
-            {
-                ERR("Failed to create semaphore, error %lu.\n", GetLastError());
-                hr = HRESULT_FROM_WIN32(GetLastError());
-            }
+            hr = This->fnAlloc(iface);
+            if (SUCCEEDED(hr))
+                This->bCommitted = TRUE;
             else
-            {
-                hr = This->fnAlloc(iface);
-                if (SUCCEEDED(hr))
-                    This->bCommitted = TRUE;
-                else
-                    ERR("Failed to allocate, hr %#lx.\n", hr);
-            }
+                ERR("Failed to allocate, hr %#lx.\n", hr);
         }
     }
     LeaveCriticalSection(This->pCritSect);
@@ -276,8 +267,8 @@ static HRESULT WINAPI BaseMemAllocator_Decommit(IMemAllocator * iface)
             {
                 This->bDecommitQueued = TRUE;
                 /* notify ALL waiting threads that they cannot be allocated a buffer any more */
-                ReleaseSemaphore(This->hSemWaiting, This->lWaiting, NULL);
-                
+                WakeAllConditionVariable(&This->free_cv);
+
                 hr = S_OK;
             }
             else
@@ -286,8 +277,6 @@ static HRESULT WINAPI BaseMemAllocator_Decommit(IMemAllocator * iface)
                     ERR("Waiting: %ld\n", This->lWaiting);
 
                 This->bCommitted = FALSE;
-                CloseHandle(This->hSemWaiting);
-                This->hSemWaiting = NULL;
 
                 hr = This->fnFree(iface);
             }
@@ -311,30 +300,30 @@ static HRESULT WINAPI BaseMemAllocator_GetBuffer(IMemAllocator * iface, IMediaSa
 
     *pSample = NULL;
 
+    /* Waiting on a condition variable instead of a semaphore keeps the common case,
+     * where a buffer is free, from going through the server. */
     EnterCriticalSection(This->pCritSect);
     if (!This->bCommitted || This->bDecommitQueued)
     {
         WARN("Not committed\n");
-        hr = VFW_E_NOT_COMMITTED;
+        LeaveCriticalSection(This->pCritSect);
+        return VFW_E_NOT_COMMITTED;
     }
-    else
-        ++This->lWaiting;
-    LeaveCriticalSection(This->pCritSect);
-    if (FAILED(hr))
-        return hr;
 
-    if (WaitForSingleObject(This->hSemWaiting, (dwFlags & AM_GBF_NOWAIT) ? 0 : INFINITE) != WAIT_OBJECT_0)
+    while (list_empty(&This->free_list) && This->bCommitted && !This->bDecommitQueued)
     {
-        EnterCriticalSection(This->pCritSect);
+        if (dwFlags & AM_GBF_NOWAIT)
+        {
+            LeaveCriticalSection(This->pCritSect);
+            WARN("Timed out\n");
+            return VFW_E_TIMEOUT;
+        }
+        ++This->lWaiting;
+        SleepConditionVariableCS(&This->free_cv, This->pCritSect, INFINITE);
         --This->lWaiting;
-        LeaveCriticalSection(This->pCritSect);
-        WARN("Timed out\n");
-        return VFW_E_TIMEOUT;
     }
 
-    EnterCriticalSection(This->pCritSect);
     {
-        --This->lWaiting;
         if (!This->bCommitted)
             hr = VFW_E_NOT_COMMITTED;
         else if (This->bDecommitQueued)
@@ -389,21 +378,17 @@ static HRESULT WINAPI BaseMemAllocator_ReleaseBuffer(IMemAllocator * iface, IMed
             This->bCommitted = FALSE;
             This->bDecommitQueued = FALSE;
 
-            CloseHandle(This->hSemWaiting);
-            This->hSemWaiting = NULL;
-            
             This->fnFree(iface);
+            WakeAllConditionVariable(&This->free_cv);
+        }
+        else
+        {
+            /* notify a waiting thread that there is now a free buffer */
+            WakeConditionVariable(&This->free_cv);
         }
     }
     LeaveCriticalSection(This->pCritSect);
 
-    /* notify a waiting thread that there is now a free buffer */
-    if (This->hSemWaiting && !ReleaseSemaphore(This->hSemWaiting, 1, NULL))
-    {
-        ERR("Failed to release semaphore, error %lu.\n", GetLastError());
-        hr = HRESULT_FROM_WIN32(GetLastError());
-    }
-
     return hr;
 }
 
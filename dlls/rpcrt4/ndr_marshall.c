@@ -1772,7 +1772,11 @@ unsigned char * WINAPI NdrSimpleStructUnmarshall(PMIDL_STUB_MESSAGE pStubMsg,
   align_pointer(&pStubMsg->Buffer, pFormat[1] + 1);
 
   if (fMustAlloc)
-    *ppMemory = NdrAllocateZero(pStubMsg, size);
+  {
+    /* without pointers, the whole struct is overwritten by the copy below */
+    if (pFormat[0] == FC_PSTRUCT) *ppMemory = NdrAllocateZero(pStubMsg, size);
+    else *ppMemory = NdrAllocate(pStubMsg, size);
+  }
   else
   {
     if (!pStubMsg->IsClient && !*ppMemory)
@@ -2162,7 +2166,10 @@ static inline ULONG array_read_variance_and_unmarshall(
 
     if (fUnmarshall)
     {
-      if (fMustAlloc)
+      /* without pointers, the whole array is overwritten by the copy below */
+      if (fMustAlloc && *pFormat != FC_PP)
+        *ppMemory = NdrAllocate(pStubMsg, memsize);
+      else if (fMustAlloc)
         *ppMemory = NdrAllocateZero(pStubMsg, memsize);
       else
       {
@@ -4801,7 +4808,10 @@ unsigned char *  WINAPI NdrConformantStructUnmarshall(PMIDL_STUB_MESSAGE pStubMs
     if (fMustAlloc)
     {
         SIZE_T size = pCStructFormat->memory_size + bufsize;
-        *ppMemory = NdrAllocateZero(pStubMsg, size);
+
+        /* without pointers, the whole struct is overwritten by the copy below */
+        if (pCStructFormat->type == FC_CPSTRUCT) *ppMemory = NdrAllocateZero(pStubMsg, size);
+        else *ppMemory = NdrAllocate(pStubMsg, size);
     }
     else
     {
@@ -831,6 +831,88 @@ static RPC_STATUS rpcrt4_ncalrpc_parse_top_of_tower(const unsigned char *tower_d
     return RPC_S_OK;
 }
 
+static RPC_STATUS rpcrt4_ncalrpc_receive_fragment(RpcConnection *conn, RpcPktHdr **Header, void **Payload)
+{
+    RpcPktCommonHdr *common_hdr;
+    DWORD hdr_length, size = max(conn->MaxTransmissionSize, RPC_MAX_PACKET_SIZE);
+    RPC_STATUS status;
+    char *buffer, *new_buffer;
+    int count, len;
+
+    *Header = NULL;
+    *Payload = NULL;
+
+    TRACE("(%p, %p, %p)\n", conn, Header, Payload);
+
+    /* the peer is always rpcrt4 writing one fragment per message, so read
+     * the whole fragment at once instead of the headers and payload separately */
+    if (!(buffer = malloc(size))) return RPC_S_OUT_OF_RESOURCES;
+
+    count = rpcrt4_conn_np_read(conn, buffer, size);
+    if (count < (int)sizeof(*common_hdr))
+    {
+        WARN("Short read of header, %d bytes\n", count);
+        status = RPC_S_CALL_FAILED;
+        goto fail;
+    }
+    common_hdr = (RpcPktCommonHdr *)buffer;
+
+    status = RPCRT4_ValidateCommonHeader(common_hdr);
+    if (status != RPC_S_OK) goto fail;
+
+    hdr_length = RPCRT4_GetHeaderSize((RpcPktHdr *)common_hdr);
+    if (hdr_length == 0 || hdr_length > common_hdr->frag_len || count > common_hdr->frag_len)
+    {
+        WARN("bad header length %ld, frag_len %u, read %d bytes\n", hdr_length, common_hdr->frag_len, count);
+        status = RPC_S_PROTOCOL_ERROR;
+        goto fail;
+    }
+
+    if (count < common_hdr->frag_len)
+    {
+        size = common_hdr->frag_len;
+        if (!(new_buffer = realloc(buffer, size)))
+        {
+            status = RPC_S_OUT_OF_RESOURCES;
+            goto fail;
+        }
+        buffer = new_buffer;
+        common_hdr = (RpcPktCommonHdr *)buffer;
+
+        while (count < size)
+        {
+            if ((len = rpcrt4_conn_np_read(conn, buffer + count, size - count)) <= 0)
+            {
+                WARN("bad data length, %d/%ld\n", count, size);
+                status = RPC_S_CALL_FAILED;
+                goto fail;
+            }
+            count += len;
+        }
+    }
+
+    if (!(*Header = malloc(hdr_length)))
+    {
+        status = RPC_S_OUT_OF_RESOURCES;
+        goto fail;
+    }
+    memcpy(*Header, buffer, hdr_length);
+
+    if (count > hdr_length)
+    {
+        /* reuse the buffer for the payload */
+        memmove(buffer, buffer + hdr_length, count - hdr_length);
+        *Payload = buffer;
+    }
+    else free(buffer);
+
+    return RPC_S_OK;
+
+fail:
+    free(buffer);
+    return status;
+}
+
 static BOOL rpcrt4_ncalrpc_is_authorized(RpcConnection *conn)
 {
     return FALSE;
@@ -3154,7 +3236,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
     rpcrt4_ncalrpc_parse_top_of_tower,
-    NULL,
+    rpcrt4_ncalrpc_receive_fragment,
     rpcrt4_ncalrpc_is_authorized,
     rpcrt4_ncalrpc_authorize,
     rpcrt4_ncalrpc_secure_packet,
@@ -56,6 +56,7 @@ static struct queue_handle *next_free_user_queue;
 static struct queue_handle *next_unused_user_queue = user_queues;
 static WORD queue_generation;
 static DWORD shared_mt_queue;
+static LONG next_mmcss_taskid;
 
 static CRITICAL_SECTION queues_section;
 static CRITICAL_SECTION_DEBUG queues_critsect_debug =
@@ -135,6 +136,7 @@ struct work_item
     struct queue *queue;
     RTWQWORKITEM_KEY key;
     LONG priority;
+    int thread_priority;
     DWORD flags;
     PTP_SIMPLE_CALLBACK finalization_callback;
     enum work_item_type type;
@@ -184,6 +186,11 @@ struct queue
     CRITICAL_SECTION cs;
     struct list pending_items;
     DWORD id;
+    /* Data used for shared queues, locked by usage class. */
+    WCHAR *mmcss_class;
+    DWORD mmcss_taskid;
+    LONG mmcss_priority;
+    int thread_priority;
     /* Data used for serial queues only. */
     PTP_SIMPLE_CALLBACK finalization_callback;
     DWORD target_queue;
@@ -357,6 +364,8 @@ static BOOL pool_queue_shutdown(struct queue *queue)
     CloseThreadpoolCleanupGroupMembers(queue->envs[0].CleanupGroup, TRUE, NULL);
     CloseThreadpool(queue->pool);
     queue->pool = NULL;
+    free(queue->mmcss_class);
+    queue->mmcss_class = NULL;
 
     return TRUE;
 }
@@ -368,6 +377,11 @@ static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void
 
     TRACE("result object %p.\n", result);
 
+    /* Pool threads are never shared with other queues, items of MMCSS queues keep them
+       at the priority of their usage class. */
+    if (item->thread_priority != THREAD_PRIORITY_NORMAL)
+        SetThreadPriority(GetCurrentThread(), item->thread_priority);
+
     /* Submitting from serial queue in reply mode, use different result object acting as receipt token.
        It's submitted to user callback still, but when invoked, special serial queue callback will be used
        to ensure correct destination queue. */
@@ -390,6 +404,7 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
         callback_priority = TP_CALLBACK_PRIORITY_HIGH;
 
     env = queue->envs[callback_priority];
+    item->thread_priority = queue->thread_priority;
     env.FinalizationCallback = item->finalization_callback;
     /* Worker pool callback will release one reference. Grab one more to keep object alive when
        we need finalization callback. */
@@ -1512,9 +1527,70 @@ HRESULT WINAPI RtwqSetLongRunning(DWORD queue_id, BOOL enable)
     return hr;
 }
 
+static int get_mmcss_thread_priority(const WCHAR *usageclass, LONG priority)
+{
+    if (!wcsicmp(usageclass, L"Pro Audio"))
+        return THREAD_PRIORITY_TIME_CRITICAL;
+    if (!wcsicmp(usageclass, L"Audio") || !wcsicmp(usageclass, L"Capture") || !wcsicmp(usageclass, L"Playback"))
+        return THREAD_PRIORITY_HIGHEST;
+    return max(THREAD_PRIORITY_LOWEST, min(THREAD_PRIORITY_HIGHEST, priority));
+}
+
+static DWORD find_shared_class_queue(const WCHAR *usageclass)
+{
+    struct queue_handle *entry;
+    struct queue *queue;
+
+    for (entry = user_queues; entry < next_unused_user_queue; ++entry)
+    {
+        if (!entry->refcount) continue;
+        queue = entry->obj;
+        if (queue->mmcss_class && !wcsicmp(queue->mmcss_class, usageclass))
+            return ((entry - user_queues + FIRST_USER_QUEUE_HANDLE) << 16) | entry->generation;
+    }
+
+    return 0;
+}
+
+static HRESULT alloc_shared_class_queue(const WCHAR *usageclass, LONG priority, DWORD *queue_id)
+{
+    struct queue_desc desc;
+    struct queue *queue;
+    SYSTEM_INFO info;
+    HRESULT hr;
+
+    desc.queue_type = RTWQ_MULTITHREADED_WORKQUEUE;
+    desc.ops = &pool_queue_ops;
+    desc.target_queue = 0;
+    if (FAILED(hr = alloc_user_queue(&desc, queue_id)))
+        return hr;
+
+    grab_queue(*queue_id, &queue);
+    if (!(queue->mmcss_class = wcsdup(usageclass)))
+    {
+        unlock_user_queue(*queue_id);
+        *queue_id = RTWQ_CALLBACK_QUEUE_UNDEFINED;
+        return E_OUTOFMEMORY;
+    }
+    queue->mmcss_taskid = InterlockedIncrement(&next_mmcss_taskid);
+    queue->mmcss_priority = priority;
+    queue->thread_priority = get_mmcss_thread_priority(usageclass, priority);
+
+    /* Class queues are not limited to the default multithreaded pool size, so that a busy
+       class doesn't have to wait for threads on many-core machines. */
+    GetSystemInfo(&info);
+    SetThreadpoolThreadMaximum(queue->pool, max(4, info.dwNumberOfProcessors));
+
+    TRACE("Created queue %#lx for class %s, task id %lu, thread priority %d.\n", *queue_id,
+            debugstr_w(usageclass), queue->mmcss_taskid, queue->thread_priority);
+
+    return S_OK;
+}
+
 HRESULT WINAPI RtwqLockSharedWorkQueue(const WCHAR *usageclass, LONG priority, DWORD *taskid, DWORD *queue)
 {
     struct queue_desc desc;
+    struct queue *obj;
     HRESULT hr;
 
     TRACE("%s, %ld, %p, %p.\n", debugstr_w(usageclass), priority, taskid, queue);
@@ -1525,10 +1601,21 @@ HRESULT WINAPI RtwqLockSharedWorkQueue(const WCHAR *usageclass, LONG priority, D
     if (!*usageclass && taskid)
         return E_INVALIDARG;
 
+    EnterCriticalSection(&queues_section);
+
     if (*usageclass)
-        FIXME("Class name is ignored.\n");
+    {
+        if ((*queue = find_shared_class_queue(usageclass)))
+            hr = lock_user_queue(*queue);
+        else
+            hr = alloc_shared_class_queue(usageclass, priority, queue);
 
-    EnterCriticalSection(&queues_section);
+        if (SUCCEEDED(hr) && taskid && SUCCEEDED(grab_queue(*queue, &obj)))
+            *taskid = obj->mmcss_taskid;
+
+        LeaveCriticalSection(&queues_section);
+        return hr;
+    }
 
     if (shared_mt_queue)
         hr = lock_user_queue(shared_mt_queue);
@@ -1594,25 +1681,70 @@ HRESULT WINAPI RtwqUnjoinWorkQueue(DWORD queue, HANDLE cookie)
     return E_NOTIMPL;
 }
 
-HRESULT WINAPI RtwqGetWorkQueueMMCSSClass(DWORD queue, WCHAR *class, DWORD *length)
+HRESULT WINAPI RtwqGetWorkQueueMMCSSClass(DWORD queue_id, WCHAR *class, DWORD *length)
 {
-    FIXME("%#lx, %p, %p.\n", queue, class, length);
+    struct queue *queue;
+    DWORD size;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%#lx, %p, %p.\n", queue_id, class, length);
+
+    if (!length)
+        return E_POINTER;
+
+    EnterCriticalSection(&queues_section);
+
+    if (SUCCEEDED(hr = grab_queue(queue_id, &queue)))
+    {
+        size = queue->mmcss_class ? wcslen(queue->mmcss_class) + 1 : 1;
+        if (!class || *length < size)
+            hr = class ? RTWQ_E_BUFFERTOOSMALL : S_OK;
+        else if (queue->mmcss_class)
+            memcpy(class, queue->mmcss_class, size * sizeof(*class));
+        else
+            *class = 0;
+        *length = size;
+    }
+
+    LeaveCriticalSection(&queues_section);
+
+    return hr;
 }
 
-HRESULT WINAPI RtwqGetWorkQueueMMCSSTaskId(DWORD queue, DWORD *taskid)
+HRESULT WINAPI RtwqGetWorkQueueMMCSSTaskId(DWORD queue_id, DWORD *taskid)
 {
-    FIXME("%#lx, %p.\n", queue, taskid);
+    struct queue *queue;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%#lx, %p.\n", queue_id, taskid);
+
+    if (!taskid)
+        return E_POINTER;
+
+    EnterCriticalSection(&queues_section);
+    if (SUCCEEDED(hr = grab_queue(queue_id, &queue)))
+        *taskid = queue->mmcss_taskid;
+    LeaveCriticalSection(&queues_section);
+
+    return hr;
 }
 
-HRESULT WINAPI RtwqGetWorkQueueMMCSSPriority(DWORD queue, LONG *priority)
+HRESULT WINAPI RtwqGetWorkQueueMMCSSPriority(DWORD queue_id, LONG *priority)
 {
-    FIXME("%#lx, %p.\n", queue, priority);
+    struct queue *queue;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("%#lx, %p.\n", queue_id, priority);
+
+    if (!priority)
+        return E_POINTER;
+
+    EnterCriticalSection(&queues_section);
+    if (SUCCEEDED(hr = grab_queue(queue_id, &queue)))
+        *priority = queue->mmcss_priority;
+    LeaveCriticalSection(&queues_section);
+
+    return hr;
 }
 
 HRESULT WINAPI RtwqRegisterPlatformWithMMCSS(const WCHAR *class, DWORD *taskid, LONG priority)
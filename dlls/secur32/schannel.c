@@ -263,6 +263,23 @@ static void read_config(void)
 
     RegCloseKey(protocols_key);
 
+    res = RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\SecurityProviders\\SCHANNEL",
+                        0, KEY_READ, &key);
+    if(res == ERROR_SUCCESS) {
+        struct set_session_cache_params params = { 20000, 36000000 };
+        DWORD type, size, value;
+
+        size = sizeof(value);
+        if(!RegQueryValueExW(key, L"MaximumCacheSize", NULL, &type, (BYTE *)&value, &size) && type == REG_DWORD)
+            params.max_entries = value;
+        size = sizeof(value);
+        if(!RegQueryValueExW(key, L"ClientCacheTime", NULL, &type, (BYTE *)&value, &size) && type == REG_DWORD)
+            params.lifetime = value;
+        RegCloseKey(key);
+
+        GNUTLS_CALL( set_session_cache, &params );
+    }
+
     config_enabled_protocols = enabled & GNUTLS_CALL( get_enabled_protocols, NULL );
     config_default_disabled_protocols = default_disabled;
     config_read = TRUE;
@@ -1236,6 +1253,15 @@ static SECURITY_STATUS SEC_ENTRY schan_QueryContextAttributesW(
         struct get_connection_info_params params = { ctx->session, info };
         return GNUTLS_CALL( get_connection_info, &params );
     }
+    case SECPKG_ATTR_SESSION_INFO:
+    {
+        SecPkgContext_SessionInfo *info = buffer;
+        struct session_params params = { ctx->session };
+
+        memset( info, 0, sizeof(*info) );
+        if (GNUTLS_CALL( get_session_resumed, &params )) info->dwFlags |= SSL_SESSION_RECONNECT;
+        return SEC_E_OK;
+    }
     case SECPKG_ATTR_ENDPOINT_BINDINGS:
     {
         static const char prefix[] = "tls-server-end-point:";
@@ -1335,6 +1361,7 @@ static SECURITY_STATUS SEC_ENTRY schan_QueryContextAttributesA(
     case SECPKG_ATTR_STREAM_SIZES:
     case SECPKG_ATTR_REMOTE_CERT_CONTEXT:
     case SECPKG_ATTR_CONNECTION_INFO:
+    case SECPKG_ATTR_SESSION_INFO:
     case SECPKG_ATTR_ENDPOINT_BINDINGS:
     case SECPKG_ATTR_UNIQUE_BINDINGS:
     case SECPKG_ATTR_APPLICATION_PROTOCOL:
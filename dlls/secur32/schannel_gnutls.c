@@ -30,7 +30,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
+#include <string.h>
 #include <sys/types.h>
+#include <time.h>
 #include <dlfcn.h>
 #ifdef SONAME_LIBGNUTLS
 #include <gnutls/gnutls.h>
@@ -48,6 +51,7 @@
 
 #include "wine/unixlib.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 
 #if defined(SONAME_LIBGNUTLS)
 
@@ -112,6 +116,9 @@ MAKE_FUNCPTR(gnutls_record_recv);
 MAKE_FUNCPTR(gnutls_record_send);
 MAKE_FUNCPTR(gnutls_server_name_set);
 MAKE_FUNCPTR(gnutls_session_channel_binding);
+MAKE_FUNCPTR(gnutls_session_get_data);
+MAKE_FUNCPTR(gnutls_session_is_resumed);
+MAKE_FUNCPTR(gnutls_session_set_data);
 MAKE_FUNCPTR(gnutls_set_default_priority);
 MAKE_FUNCPTR(gnutls_transport_get_ptr);
 MAKE_FUNCPTR(gnutls_transport_set_errno);
@@ -169,8 +176,137 @@ struct schan_transport
     gnutls_session_t session;
     struct schan_buffers in;
     struct schan_buffers out;
+    UINT64 credentials;      /* credentials of a client session */
+    char *target;            /* server name of a client session */
+    BOOL established;        /* the handshake has completed */
 };
 
+/* client sessions are kept to resume them on the next connection to the same
+ * server with the same credentials, like the Windows session cache */
+struct session_cache_entry
+{
+    struct list entry;
+    UINT64 credentials;
+    char *target;
+    void *data;
+    size_t size;
+    UINT64 expires;          /* in ms */
+};
+
+static struct list session_cache = LIST_INIT( session_cache );
+static unsigned int session_cache_count;
+static unsigned int session_cache_max = 20000;      /* MaximumCacheSize */
+static unsigned int session_cache_time = 36000000;  /* ClientCacheTime */
+static unsigned int handshakes, resumed_handshakes;
+static pthread_mutex_t session_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static UINT64 monotonic_time(void)
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * (UINT64)1000 + ts.tv_nsec / 1000000;
+}
+
+static void free_cached_session( struct session_cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    session_cache_count--;
+    free( entry->target );
+    free( entry->data );
+    free( entry );
+}
+
+static struct session_cache_entry *find_cached_session( UINT64 credentials, const char *target )
+{
+    struct session_cache_entry *entry;
+    UINT64 now = monotonic_time();
+
+    LIST_FOR_EACH_ENTRY( entry, &session_cache, struct session_cache_entry, entry )
+    {
+        if (entry->credentials != credentials || strcmp( entry->target, target )) continue;
+        if (entry->expires > now) return entry;
+        free_cached_session( entry );
+        break;
+    }
+    return NULL;
+}
+
+static void resume_cached_session( struct schan_transport *t )
+{
+    struct session_cache_entry *entry;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    if ((entry = find_cached_session( t->credentials, t->target )))
+    {
+        TRACE( "resuming session to %s\n", debugstr_a(t->target) );
+        pgnutls_session_set_data( t->session, entry->data, entry->size );
+    }
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+/* called when the handshake completes, and again when the session is disposed
+ * of, since TLS 1.3 servers send their tickets after the handshake */
+static void cache_session( struct schan_transport *t )
+{
+    struct session_cache_entry *entry;
+    size_t size = 0;
+    void *data;
+
+    if (!session_cache_max || !session_cache_time) return;
+
+    if (pgnutls_session_get_data( t->session, NULL, &size ) != GNUTLS_E_SUCCESS || !size) return;
+    if (!(data = malloc( size ))) return;
+    if (pgnutls_session_get_data( t->session, data, &size ) != GNUTLS_E_SUCCESS)
+    {
+        free( data );
+        return;
+    }
+
+    pthread_mutex_lock( &session_cache_mutex );
+    if ((entry = find_cached_session( t->credentials, t->target )))
+    {
+        free( entry->data );
+        list_remove( &entry->entry );
+    }
+    else if ((entry = calloc( 1, sizeof(*entry) )) && !(entry->target = strdup( t->target )))
+    {
+        free( entry );
+        entry = NULL;
+    }
+    else if (entry)
+    {
+        entry->credentials = t->credentials;
+        session_cache_count++;
+    }
+
+    if (entry)
+    {
+        entry->data = data;
+        entry->size = size;
+        entry->expires = monotonic_time() + session_cache_time;
+        list_add_head( &session_cache, &entry->entry );
+        while (session_cache_count > session_cache_max)
+            free_cached_session( LIST_ENTRY( list_tail( &session_cache ), struct session_cache_entry, entry ));
+    }
+    else free( data );
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+static NTSTATUS schan_set_session_cache( void *args )
+{
+    const struct set_session_cache_params *params = args;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    session_cache_max = params->max_entries;
+    session_cache_time = params->lifetime;
+    while (session_cache_count > session_cache_max)
+        free_cached_session( LIST_ENTRY( list_tail( &session_cache ), struct session_cache_entry, entry ));
+    pthread_mutex_unlock( &session_cache_mutex );
+
+    TRACE( "%u entries, %u ms\n", session_cache_max, session_cache_time );
+    return STATUS_SUCCESS;
+}
+
 static int compat_cipher_get_block_size(gnutls_cipher_algorithm_t cipher)
 {
     switch(cipher) {
@@ -521,6 +657,7 @@ static NTSTATUS schan_create_session( void *args )
         return STATUS_INTERNAL_ERROR;
     }
     transport->session = s;
+    if (!(flags & GNUTLS_SERVER)) transport->credentials = cred->credentials;
 
     if ((status = set_priority(cred, s)))
     {
@@ -552,8 +689,10 @@ static NTSTATUS schan_dispose_session( void *args )
     const struct session_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
     struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+    if (t->target && t->established) cache_session(t);
     pgnutls_transport_set_ptr(s, NULL);
     pgnutls_deinit(s);
+    free(t->target);
     free(t);
     return STATUS_SUCCESS;
 }
@@ -562,10 +701,20 @@ static NTSTATUS schan_set_session_target( void *args )
 {
     const struct set_session_target_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
+    struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+
     pgnutls_server_name_set( s, GNUTLS_NAME_DNS, params->target, strlen(params->target) );
+    if (t->credentials && !t->target && (t->target = strdup( params->target ))) resume_cached_session(t);
     return STATUS_SUCCESS;
 }
 
+static NTSTATUS schan_get_session_resumed( void *args )
+{
+    const struct session_params *params = args;
+    gnutls_session_t s = session_from_handle(params->session);
+    return pgnutls_session_is_resumed(s);
+}
+
 static gnutls_alert_level_t map_alert_type(unsigned int type)
 {
     switch (type)
@@ -657,7 +806,21 @@ static NTSTATUS schan_handshake( void *args )
         err = pgnutls_handshake(s);
         if (err == GNUTLS_E_SUCCESS)
         {
-            TRACE("Handshake completed\n");
+            TRACE("Handshake completed%s\n", pgnutls_session_is_resumed(s) ? ", session resumed" : "");
+            t->established = TRUE;
+            if (t->target)
+            {
+                unsigned int total = __atomic_add_fetch( &handshakes, 1, __ATOMIC_RELAXED ), resumed;
+
+                if (pgnutls_session_is_resumed(s))
+                    resumed = __atomic_add_fetch( &resumed_handshakes, 1, __ATOMIC_RELAXED );
+                else
+                {
+                    resumed = __atomic_load_n( &resumed_handshakes, __ATOMIC_RELAXED );
+                    cache_session(t);
+                }
+                TRACE("%u of %u client handshakes resumed\n", resumed, total);
+            }
             status = SEC_E_OK;
         }
         else if (err == GNUTLS_E_AGAIN)
@@ -1447,6 +1610,13 @@ static NTSTATUS schan_allocate_certificate_credentials( void *args )
 static NTSTATUS schan_free_certificate_credentials( void *args )
 {
     const struct free_certificate_credentials_params *params = args;
+    struct session_cache_entry *entry, *next;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &session_cache, struct session_cache_entry, entry )
+        if (entry->credentials == params->c->credentials) free_cached_session( entry );
+    pthread_mutex_unlock( &session_cache_mutex );
+
     pgnutls_certificate_free_credentials(certificate_creds_from_handle(params->c->credentials));
     return STATUS_SUCCESS;
 }
@@ -1514,6 +1684,9 @@ static NTSTATUS process_attach( void *args )
     LOAD_FUNCPTR(gnutls_record_send);
     LOAD_FUNCPTR(gnutls_server_name_set)
     LOAD_FUNCPTR(gnutls_session_channel_binding)
+    LOAD_FUNCPTR(gnutls_session_get_data)
+    LOAD_FUNCPTR(gnutls_session_is_resumed)
+    LOAD_FUNCPTR(gnutls_session_set_data)
     LOAD_FUNCPTR(gnutls_set_default_priority)
     LOAD_FUNCPTR(gnutls_transport_get_ptr)
     LOAD_FUNCPTR(gnutls_transport_set_errno)
@@ -1614,6 +1787,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     schan_get_max_message_size,
     schan_get_session_cipher_block_size,
     schan_get_session_peer_certificate,
+    schan_get_session_resumed,
     schan_get_unique_channel_binding,
     schan_handshake,
     schan_recv,
@@ -1622,6 +1796,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     schan_set_dtls_mtu,
     schan_set_session_target,
     schan_set_dtls_timeouts,
+    schan_set_session_cache,
 };
 
 #ifdef _WIN64
@@ -1947,6 +2122,7 @@ const unixlib_entry_t __wine_unix_call_wow64_funcs[] =
     schan_get_max_message_size,
     schan_get_session_cipher_block_size,
     wow64_schan_get_session_peer_certificate,
+    schan_get_session_resumed,
     wow64_schan_get_unique_channel_binding,
     wow64_schan_handshake,
     wow64_schan_recv,
@@ -1955,6 +2131,7 @@ const unixlib_entry_t __wine_unix_call_wow64_funcs[] =
     schan_set_dtls_mtu,
     wow64_schan_set_session_target,
     schan_set_dtls_timeouts,
+    schan_set_session_cache,
 };
 
 #endif /* _WIN64 */
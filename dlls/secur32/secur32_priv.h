@@ -215,6 +215,12 @@ struct set_dtls_timeouts_params
     unsigned int total_timeout;
 };
 
+struct set_session_cache_params
+{
+    unsigned int max_entries;
+    unsigned int lifetime;
+};
+
 enum schan_funcs
 {
     unix_process_attach,
@@ -231,6 +237,7 @@ enum schan_funcs
     unix_get_max_message_size,
     unix_get_session_cipher_block_size,
     unix_get_session_peer_certificate,
+    unix_get_session_resumed,
     unix_get_unique_channel_binding,
     unix_handshake,
     unix_recv,
@@ -239,6 +246,7 @@ enum schan_funcs
     unix_set_dtls_mtu,
     unix_set_session_target,
     unix_set_dtls_timeouts,
+    unix_set_session_cache,
 };
 
 #endif /* __SECUR32_PRIV_H__ */
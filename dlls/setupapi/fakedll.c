@@ -31,6 +31,7 @@
 #include "windef.h"
 #include "winbase.h"
 #include "winuser.h"
+#include "winreg.h"
 #include "winnt.h"
 #include "winternl.h"
 #include "wine/debug.h"
@@ -70,6 +71,8 @@ static unsigned int handled_count;
 static unsigned int handled_total;
 static WCHAR **handled_dlls;
 static IRegistrar *registrar;
+static HKEY hash_key;
+static int dry_run = -1;
 
 struct dll_info
 {
@@ -564,6 +567,63 @@ static BOOL fake_dll_matches( const WCHAR *source, const WCHAR *dest )
     return result;
 }
 
+/* WINE_FAKEDLL_DRY_RUN only reports the files that an update would change */
+BOOL is_fake_dll_dry_run(void)
+{
+    if (dry_run == -1) dry_run = !!_wgetenv( L"WINE_FAKEDLL_DRY_RUN" );
+    return dry_run;
+}
+
+/* the hashes of the installed fake dlls are kept in the prefix, so that an update
+ * can skip rewriting and registering again the dlls that didn't change */
+static HKEY get_hash_key(void)
+{
+    static const WCHAR keyW[] = L"Software\\Wine\\FakeDlls";
+    LSTATUS status;
+
+    if (hash_key) return hash_key;
+    if (is_fake_dll_dry_run())
+        status = RegOpenKeyExW( HKEY_LOCAL_MACHINE, keyW, 0, KEY_QUERY_VALUE, &hash_key );
+    else
+        status = RegCreateKeyExW( HKEY_LOCAL_MACHINE, keyW, 0, NULL, 0, KEY_QUERY_VALUE | KEY_SET_VALUE,
+                                  NULL, &hash_key, NULL );
+    if (status) hash_key = NULL;
+    return hash_key;
+}
+
+static ULONGLONG hash_fake_dll( const void *data, SIZE_T size )
+{
+    const unsigned char *p = data, *end = p + size;
+    ULONGLONG hash = 0xcbf29ce484222325ull;  /* 64-bit FNV-1a */
+
+    while (p < end) hash = (hash ^ *p++) * 0x100000001b3ull;
+    return hash ^ size;
+}
+
+/* check if dest still holds the file that was installed with this hash */
+static BOOL fake_dll_is_current( const WCHAR *dest, SIZE_T size, ULONGLONG hash )
+{
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    DWORD len = sizeof(ULONGLONG);
+    ULONGLONG stored;
+
+    if (!get_hash_key()) return FALSE;
+    if (RegQueryValueExW( hash_key, dest, NULL, NULL, (BYTE *)&stored, &len ) || stored != hash) return FALSE;
+    if (!GetFileAttributesExW( dest, GetFileExInfoStandard, &attr )) return FALSE;
+    return !attr.nFileSizeHigh && attr.nFileSizeLow == size;
+}
+
+static void set_fake_dll_hash( const WCHAR *dest, ULONGLONG hash )
+{
+    if (!get_hash_key()) return;
+    RegSetValueExW( hash_key, dest, 0, REG_QWORD, (const BYTE *)&hash, sizeof(hash) );
+}
+
+static void delete_fake_dll_hash( const WCHAR *dest )
+{
+    if (get_hash_key()) RegDeleteValueW( hash_key, dest );
+}
+
 /* create the fake dll destination file */
 static HANDLE create_dest_file( const WCHAR *name, BOOL delete )
 {
@@ -974,6 +1034,7 @@ static int install_fake_dll( WCHAR *dest, WCHAR *file, BOOL delete, struct list
     SIZE_T size;
     void *data;
     DWORD written;
+    ULONGLONG hash = 0;
     WCHAR *destname = dest + lstrlenW(dest);
     WCHAR *name = wcsrchr( file, '\\' ) + 1;
     WCHAR *end = name + lstrlenW(name);
@@ -989,10 +1050,21 @@ static int install_fake_dll( WCHAR *dest, WCHAR *file, BOOL delete, struct list
     memcpy( destname, name, len * sizeof(WCHAR) );
     destname[len] = 0;
     if (!add_handled_dll( destname )) ret = -1;
+    else hash = hash_fake_dll( data, size );
 
-    if (ret != -1 && fake_dll_matches( file, dest ))
+    if (ret != -1 && !delete && fake_dll_is_current( dest, size, hash ))
+    {
+        TRACE( "%s is up to date\n", debugstr_w(dest) );
+    }
+    else if (ret != -1 && is_fake_dll_dry_run())
+    {
+        if (!delete || GetFileAttributesW( dest ) != INVALID_FILE_ATTRIBUTES)
+            MESSAGE( "wine: would %s %s\n", delete ? "delete" : "update", debugstr_w(dest) );
+    }
+    else if (ret != -1 && fake_dll_matches( file, dest ))
     {
         register_fake_dll( dest, data, size, delay_copy );
+        set_fake_dll_hash( dest, hash );
     }
     else if (ret != -1)
     {
@@ -1005,9 +1077,14 @@ static int install_fake_dll( WCHAR *dest, WCHAR *file, BOOL delete, struct list
             ret = (WriteFile( h, data, size, &written, NULL ) && written == size);
             if (!ret) ERR( "failed to write to %s (error=%lu)\n", debugstr_w(dest), GetLastError() );
             CloseHandle( h );
-            if (ret) register_fake_dll( dest, data, size, delay_copy );
+            if (ret)
+            {
+                register_fake_dll( dest, data, size, delay_copy );
+                set_fake_dll_hash( dest, hash );
+            }
             else DeleteFileW( dest );
         }
+        else if (h == INVALID_HANDLE_VALUE) delete_fake_dll_hash( dest );
     }
     *destname = 0;  /* restore it for next file */
     *end = 0;
@@ -1164,6 +1241,12 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
 
     if (delete)
     {
+        if (is_fake_dll_dry_run())
+        {
+            if (GetFileAttributesW( name ) != INVALID_FILE_ATTRIBUTES)
+                MESSAGE( "wine: would delete %s\n", debugstr_w(name) );
+            return TRUE;
+        }
         if (!(h = create_dest_file( name, delete ))) return TRUE;  /* not a fake dll */
         if (h == INVALID_HANDLE_VALUE) return FALSE;
 
@@ -1173,14 +1256,30 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
 
         CloseHandle( h );
         DeleteFileW( name );
+        delete_fake_dll_hash( name );
     }
     else if ((buffer = load_fake_dll( source, &size, &source_filename )))
     {
+        ULONGLONG hash = hash_fake_dll( buffer, size );
+
+        if (fake_dll_is_current( name, size, hash ))
+        {
+            TRACE( "%s is up to date\n", debugstr_w(name) );
+            free( source_filename );
+            return TRUE;
+        }
+        if (is_fake_dll_dry_run())
+        {
+            MESSAGE( "wine: would update %s\n", debugstr_w(name) );
+            free( source_filename );
+            return TRUE;
+        }
         if (fake_dll_matches( source_filename, name ))
         {
             free( source_filename );
 
             register_fake_dll( name, buffer, size, &delay_copy );
+            set_fake_dll_hash( name, hash );
             ret = TRUE;
         }
         else
@@ -1193,13 +1292,23 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
             if (h == INVALID_HANDLE_VALUE) return FALSE;
 
             ret = (WriteFile( h, buffer, size, &written, NULL ) && written == size);
-            if (ret) register_fake_dll( name, buffer, size, &delay_copy );
+            if (ret)
+            {
+                register_fake_dll( name, buffer, size, &delay_copy );
+                set_fake_dll_hash( name, hash );
+            }
             else ERR( "failed to write to %s (error=%lu)\n", debugstr_w(name), GetLastError() );
 
             CloseHandle( h );
             if (!ret) DeleteFileW( name );
         }
     }
+    else if (is_fake_dll_dry_run())
+    {
+        if (GetFileAttributesW( name ) == INVALID_FILE_ATTRIBUTES)
+            MESSAGE( "wine: would create %s\n", debugstr_w(name) );
+        return TRUE;
+    }
     else
     {
         if (!(h = create_dest_file( name, FALSE ))) return TRUE;  /* not a fake dll */
@@ -1229,4 +1338,6 @@ void cleanup_fake_dlls(void)
     handled_count = handled_total = 0;
     if (registrar) IRegistrar_Release( registrar );
     registrar = NULL;
+    if (hash_key) RegCloseKey( hash_key );
+    hash_key = NULL;
 }
@@ -1280,6 +1280,15 @@ void WINAPI InstallHinfSectionW( HWND hwnd, HINSTANCE handle, LPCWSTR cmdline, I
         if (*s) TRACE( "using section %s instead\n", debugstr_w(section) );
     }
 
+    if (is_fake_dll_dry_run())
+    {
+        /* only report the fake dlls that would change, don't touch anything else */
+        iterate_section_fields( hinf, section, L"WineFakeDlls", fake_dlls_callback, NULL );
+        cleanup_fake_dlls();
+        SetupCloseInfFile( hinf );
+        return;
+    }
+
     callback_context = SetupInitDefaultQueueCallback( hwnd );
     SetupInstallFromInfSectionW( hwnd, hinf, section, SPINST_ALL, NULL, NULL, SP_COPY_NEWER,
                                  SetupDefaultQueueCallbackW, callback_context,
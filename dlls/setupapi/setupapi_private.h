@@ -100,5 +100,6 @@ extern OSVERSIONINFOW OsVersionInfo;
 
 extern BOOL create_fake_dll( const WCHAR *name, const WCHAR *source );
 extern void cleanup_fake_dlls(void);
+extern BOOL is_fake_dll_dry_run(void);
 
 #endif /* __SETUPAPI_PRIVATE_H */
@@ -830,6 +830,30 @@ static void test_math_errors(void)
     ok(d == -1.0, "failed to change log10 return value: %e\n", d);
 }
 
+static void test_fma(void)
+{
+    volatile double a = 1 + 0x1p-52, b = 1 - 0x1p-52;
+    volatile float af = 1 + 0x1p-23f, bf = 1 - 0x1p-23f;
+    double d;
+    float f;
+
+    /* the product is 1 - 2^-104, it's only visible if it's not rounded before the addition */
+    d = fma(a, b, -1);
+    ok(d == -0x1p-104, "fma returned %a\n", d);
+    f = fmaf(af, bf, -1);
+    ok(f == -0x1p-46f, "fmaf returned %a\n", f);
+
+    errno = -1;
+    d = fma(INFINITY, 0, 1);
+    ok(isnan(d), "fma returned %a\n", d);
+    ok(errno == EDOM, "errno = %d\n", errno);
+
+    errno = -1;
+    f = fmaf(0, INFINITY, 1);
+    ok(isnan(f), "fmaf returned %a\n", f);
+    ok(errno == EDOM, "errno = %d\n", errno);
+}
+
 static void test_asctime(void)
 {
     const struct tm epoch = { 0, 0, 0, 1, 0, 70, 4, 0, 0 };
@@ -1664,6 +1688,7 @@ START_TEST(misc)
     test_lldiv();
     test_isblank();
     test_math_errors();
+    test_fma();
     test_asctime();
     test_strftime();
     test_exit(arg_v[0]);
@@ -1621,9 +1621,9 @@
 @ cdecl _o_fgetws(ptr long ptr) fgetws
 @ cdecl _o_floor(double) floor
 @ cdecl -arch=!i386 _o_floorf(float) floorf
-@ cdecl _o_fma(double double double) fma
-@ cdecl _o_fmaf(float float float) fmaf
-@ cdecl _o_fmal(double double double) fma
+@ cdecl _o_fma(double double double) MSVCRT_fma
+@ cdecl _o_fmaf(float float float) MSVCRT_fmaf
+@ cdecl _o_fmal(double double double) MSVCRT_fma
 @ cdecl _o_fmod(double double) fmod
 @ cdecl -arch=!i386 _o_fmodf(float float) fmodf
 @ cdecl _o_fopen(str str) fopen
@@ -2308,9 +2308,9 @@
 @ cdecl fgetws(ptr long ptr)
 @ cdecl floor(double)
 @ cdecl -arch=!i386 floorf(float)
-@ cdecl fma(double double double)
-@ cdecl fmaf(float float float)
-@ cdecl fmal(double double double) fma
+@ cdecl fma(double double double) MSVCRT_fma
+@ cdecl fmaf(float float float) MSVCRT_fmaf
+@ cdecl fmal(double double double) MSVCRT_fma
 @ cdecl fmax(double double)
 @ cdecl fmaxf(float float)
 @ cdecl fmaxl(double double) fmax
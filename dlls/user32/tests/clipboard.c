@@ -2365,6 +2365,62 @@ static void test_string_data_process( int i )
     winetest_pop_context();
 }
 
+#define LARGE_DATA_SIZE (3 * 1024 * 1024 + 13)
+
+static void test_large_data(void)
+{
+    UINT format = RegisterClipboardFormatA( "my_large_clipboard_format" );
+    HANDLE data, h;
+    BYTE *ptr;
+    UINT i;
+    BOOL r;
+
+    data = GlobalAlloc( GMEM_MOVEABLE, LARGE_DATA_SIZE );
+    ptr = GlobalLock( data );
+    for (i = 0; i < LARGE_DATA_SIZE; i++) ptr[i] = i * 7 + (i >> 12);
+    GlobalUnlock( data );
+
+    r = open_clipboard( 0 );
+    ok( r, "gle %ld\n", GetLastError() );
+    r = EmptyClipboard();
+    ok( r, "gle %ld\n", GetLastError() );
+    h = SetClipboardData( format, data );
+    ok( h == data, "SetClipboardData() returned %p != %p\n", h, data );
+    r = CloseClipboard();
+    ok( r, "gle %ld\n", GetLastError() );
+
+    run_process( "large_data" );
+
+    r = open_clipboard( 0 );
+    ok( r, "gle %ld\n", GetLastError() );
+    r = EmptyClipboard();
+    ok( r, "gle %ld\n", GetLastError() );
+    r = CloseClipboard();
+    ok( r, "gle %ld\n", GetLastError() );
+}
+
+static void test_large_data_process(void)
+{
+    UINT format = RegisterClipboardFormatA( "my_large_clipboard_format" );
+    HANDLE data;
+    BYTE *ptr;
+    UINT i, len;
+    BOOL r;
+
+    r = open_clipboard( 0 );
+    ok( r, "gle %ld\n", GetLastError() );
+    data = GetClipboardData( format );
+    ok( data != 0, "could not get data\n" );
+    len = GlobalSize( data );
+    ok( len == LARGE_DATA_SIZE, "wrong size %u\n", len );
+    ptr = GlobalLock( data );
+    for (i = 0; i < len; i++) if (ptr[i] != (BYTE)(i * 7 + (i >> 12))) break;
+    ok( i == len, "wrong data at %u\n", i );
+    GlobalUnlock( data );
+    r = CloseClipboard();
+    ok( r, "gle %ld\n", GetLastError() );
+}
+
 START_TEST(clipboard)
 {
     char **argv;
@@ -2412,6 +2468,11 @@ START_TEST(clipboard)
         get_clipboard_data_process( );
         return;
     }
+    if (argc == 3 && !strcmp( argv[2], "large_data" ))
+    {
+        test_large_data_process();
+        return;
+    }
 
     test_RegisterClipboardFormatA();
     test_ClipboardOwner();
@@ -2420,4 +2481,5 @@ START_TEST(clipboard)
     test_data_handles();
     test_GetUpdatedClipboardFormats();
     test_string_data();
+    test_large_data();
 }
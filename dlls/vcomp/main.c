@@ -35,6 +35,10 @@ WINE_DEFAULT_DEBUG_CHANNEL(vcomp);
 
 #define MAX_VECT_PARALLEL_CALLBACK_ARGS 128
 
+/* how long to spin before blocking, depending on OMP_WAIT_POLICY */
+#define VCOMP_SPIN_DEFAULT  4000
+#define VCOMP_SPIN_ACTIVE   (1 << 22)
+
 typedef CRITICAL_SECTION *omp_lock_t;
 typedef CRITICAL_SECTION *omp_nest_lock_t;
 
@@ -45,6 +49,7 @@ static int     vcomp_max_threads;
 static int     vcomp_num_threads;
 static int     vcomp_num_procs;
 static BOOL    vcomp_nested_fork = FALSE;
+static int     vcomp_spin_count = VCOMP_SPIN_DEFAULT;
 
 static RTL_CRITICAL_SECTION vcomp_section;
 static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
@@ -97,8 +102,8 @@ struct vcomp_team_data
     va_list                 valist;
 
     /* barrier */
-    unsigned int            barrier;
-    int                     barrier_count;
+    LONG                    barrier;
+    LONG                    barrier_count;
 };
 
 struct vcomp_task_data
@@ -118,6 +123,7 @@ struct vcomp_task_data
     unsigned int            dynamic_iterations;
     int                     dynamic_step;
     unsigned int            dynamic_chunksize;
+    LONG64                  dynamic_next;   /* generation << 32 | iterations handed out */
 };
 
 static void **ptr_from_va_list(va_list valist)
@@ -1060,26 +1066,37 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    LONG barrier;
+    int spin;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    /* the generation can't change before we arrive, so the last thread
+     * flipping it releases everybody waiting on the value read here */
+    barrier = ReadNoFence(&team_data->barrier);
+    if (InterlockedIncrement(&team_data->barrier_count) >= team_data->num_threads)
     {
-        team_data->barrier++;
         team_data->barrier_count = 0;
+        EnterCriticalSection(&vcomp_section);
+        InterlockedIncrement(&team_data->barrier);
         WakeAllConditionVariable(&team_data->cond);
+        LeaveCriticalSection(&vcomp_section);
+        return;
     }
-    else
+
+    for (spin = vcomp_spin_count; spin && ReadNoFence(&team_data->barrier) == barrier; spin--)
+        YieldProcessor();
+
+    if (ReadNoFence(&team_data->barrier) == barrier)
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
+        EnterCriticalSection(&vcomp_section);
+        while (ReadNoFence(&team_data->barrier) == barrier)
             SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        LeaveCriticalSection(&vcomp_section);
     }
-    LeaveCriticalSection(&vcomp_section);
 }
 
 void CDECL _vcomp_set_num_threads(int num_threads)
@@ -1422,6 +1439,7 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
     struct vcomp_thread_data *thread_data = vcomp_init_thread_data();
     struct vcomp_team_data *team_data = thread_data->team;
     struct vcomp_task_data *task_data = thread_data->task;
+    LONG64 next;
     int num_threads = team_data ? team_data->num_threads : 1;
     int thread_num = thread_data->thread_num;
     unsigned int type = flags & ~VCOMP_DYNAMIC_FLAGS_INCREMENT;
@@ -1481,6 +1499,9 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
             task_data->dynamic_iterations   = iterations;
             task_data->dynamic_step         = step;
             task_data->dynamic_chunksize    = chunksize;
+            do next = task_data->dynamic_next;
+            while (InterlockedCompareExchange64(&task_data->dynamic_next,
+                                                (LONG64)thread_data->dynamic << 32, next) != next);
         }
         LeaveCriticalSection(&vcomp_section);
     }
@@ -1505,26 +1526,33 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int iterations, remaining, done;
+        LONG64 next;
+
+        /* chunks are handed out with a compare-and-swap on the generation and
+         * the count of dispatched iterations; the loop parameters can only be
+         * replaced once all iterations are gone, which always fails the swap */
+        do
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            next = *(volatile LONG64 *)&task_data->dynamic_next;
+            if ((unsigned int)(next >> 32) != thread_data->dynamic) return 0;
+            done = (unsigned int)next;
+            if (!(remaining = task_data->dynamic_iterations - done)) return 0;
+
+            iterations = min(remaining, task_data->dynamic_chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * task_data->dynamic_chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
+            if (!iterations) return 0;
+            *begin = task_data->dynamic_first + done * task_data->dynamic_step;
+            *end   = *begin + (iterations - 1) * task_data->dynamic_step;
+            if (iterations == remaining)
                 *end = task_data->dynamic_last;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+        while (InterlockedCompareExchange64(&task_data->dynamic_next, next + iterations, next) != next);
+        return 1;
     }
 
     return 0;
@@ -1558,6 +1586,18 @@ static DWORD WINAPI _vcomp_fork_worker(void *param)
             list_add_tail(&vcomp_idle_threads, &thread_data->entry);
             if (++team->finished_threads >= team->num_threads)
                 WakeAllConditionVariable(&team->cond);
+
+            /* keep the thread hot for a while, back-to-back parallel regions
+             * are common and a wakeup costs far more than a short spin */
+            if (vcomp_spin_count)
+            {
+                int spin = vcomp_spin_count;
+                LeaveCriticalSection(&vcomp_section);
+                while (spin-- && !*(struct vcomp_team_data * volatile *)&thread_data->team)
+                    YieldProcessor();
+                EnterCriticalSection(&vcomp_section);
+                if (thread_data->team) continue;
+            }
         }
 
         if (!SleepConditionVariableCS(&thread_data->cond, &vcomp_section, 5000) &&
@@ -1609,6 +1649,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
     task_data.single            = 0;
     task_data.section           = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_next      = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -1690,6 +1731,10 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
 
     if (team_data.num_threads > 1)
     {
+        int spin = vcomp_spin_count;
+        while (spin-- && *(volatile int *)&team_data.finished_threads + 1 < team_data.num_threads)
+            YieldProcessor();
+
         EnterCriticalSection(&vcomp_section);
 
         team_data.finished_threads++;
@@ -1961,6 +2006,7 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
         case DLL_PROCESS_ATTACH:
         {
             SYSTEM_INFO sysinfo;
+            char policy[16];
 
             if ((vcomp_context_tls = TlsAlloc()) == TLS_OUT_OF_INDEXES)
             {
@@ -1973,6 +2019,12 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
             vcomp_max_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_procs   = sysinfo.dwNumberOfProcessors;
+
+            if (GetEnvironmentVariableA("OMP_WAIT_POLICY", policy, sizeof(policy)) < sizeof(policy))
+            {
+                if (!lstrcmpiA(policy, "ACTIVE")) vcomp_spin_count = VCOMP_SPIN_ACTIVE;
+                else if (!lstrcmpiA(policy, "PASSIVE")) vcomp_spin_count = 0;
+            }
             break;
         }
 
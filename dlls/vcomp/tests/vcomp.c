@@ -1718,6 +1718,41 @@ static void test_vcomp_for_dynamic_init(void)
     pomp_set_num_threads(max_threads);
 }
 
+static void CDECL barrier_cb(LONG *count)
+{
+    int num_threads = pomp_get_num_threads();
+    LONG value;
+    int i;
+
+    for (i = 0; i < 1000; i++)
+    {
+        InterlockedIncrement(count);
+        p_vcomp_barrier();
+        value = *count;
+        ok(value == (i + 1) * num_threads, "iteration %d: expected %d, got %ld\n",
+           i, (i + 1) * num_threads, value);
+        p_vcomp_barrier();
+    }
+}
+
+static void test_vcomp_barrier(void)
+{
+    int max_threads = pomp_get_max_threads();
+    LONG count;
+    int i;
+
+    for (i = 1; i <= 4; i++)
+    {
+        pomp_set_num_threads(i);
+
+        count = 0;
+        p_vcomp_fork(TRUE, 1, barrier_cb, &count);
+        ok(count == 1000 * i, "expected %d, got %ld\n", 1000 * i, count);
+    }
+
+    pomp_set_num_threads(max_threads);
+}
+
 static void CDECL master_cb(HANDLE semaphore)
 {
     int num_threads = pomp_get_num_threads();
@@ -2637,6 +2672,7 @@ START_TEST(vcomp)
     test_vcomp_for_static_simple_init();
     test_vcomp_for_static_init();
     test_vcomp_for_dynamic_init();
+    test_vcomp_barrier();
     test_vcomp_master_begin();
     test_vcomp_single_begin();
     test_vcomp_enter_critsect();
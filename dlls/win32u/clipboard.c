@@ -51,6 +51,9 @@ struct cached_format
 static struct list cached_formats = LIST_INIT( cached_formats );
 static struct list formats_to_free = LIST_INIT( formats_to_free );
 
+/* formats larger than this are passed to the server in a section */
+#define CLIPBOARD_MAPPING_SIZE (1024 * 1024)
+
 
 /* get a debug string for a format id */
 static const char *debugstr_format( UINT id )
@@ -564,12 +567,51 @@ void release_clipboard_owner( HWND hwnd )
                            0, NtUserSendNotifyMessage, FALSE );
 }
 
+/* create a section holding the data of a large format */
+static HANDLE create_clipboard_mapping( const void *data, data_size_t size )
+{
+    LARGE_INTEGER section_size = { .QuadPart = size };
+    SIZE_T view_size = 0;
+    HANDLE handle;
+    void *ptr = NULL;
+
+    if (NtCreateSection( &handle, SECTION_MAP_READ | SECTION_MAP_WRITE | SECTION_QUERY, NULL,
+                         &section_size, PAGE_READWRITE, SEC_COMMIT, 0 ))
+        return 0;
+    if (NtMapViewOfSection( handle, GetCurrentProcess(), &ptr, 0, 0, NULL, &view_size,
+                            ViewShare, 0, PAGE_READWRITE ))
+    {
+        NtClose( handle );
+        return 0;
+    }
+    memcpy( ptr, data, size );
+    NtUnmapViewOfSection( GetCurrentProcess(), ptr );
+    return handle;
+}
+
+/* copy the data of a large format from its section */
+static NTSTATUS read_clipboard_mapping( HANDLE handle, void *data, data_size_t size )
+{
+    SIZE_T view_size = size;
+    NTSTATUS status;
+    void *ptr = NULL;
+
+    status = NtMapViewOfSection( handle, GetCurrentProcess(), &ptr, 0, 0, NULL, &view_size,
+                                 ViewShare, 0, PAGE_READONLY );
+    NtClose( handle );
+    if (status) return status;
+    memcpy( data, ptr, size );
+    NtUnmapViewOfSection( GetCurrentProcess(), ptr );
+    return STATUS_SUCCESS;
+}
+
 /**************************************************************************
  *           NtUserSetClipboardData    (win32u.@)
  */
 NTSTATUS WINAPI NtUserSetClipboardData( UINT format, HANDLE data, struct set_clipboard_params *params )
 {
     struct cached_format *cache = NULL, *prev = NULL;
+    HANDLE mapping = 0;
     LCID lcid;
     void *ptr = NULL;
     data_size_t size = 0;
@@ -603,6 +645,7 @@ NTSTATUS WINAPI NtUserSetClipboardData( UINT format, HANDLE data, struct set_cli
         {
             make_gdi_object_system( cache->handle, TRUE );
         }
+        if (size >= CLIPBOARD_MAPPING_SIZE) mapping = create_clipboard_mapping( ptr, size );
     }
     NtQueryDefaultLocale( TRUE, &lcid );
 
@@ -612,7 +655,9 @@ NTSTATUS WINAPI NtUserSetClipboardData( UINT format, HANDLE data, struct set_cli
     {
         req->format = format;
         req->lcid = lcid;
-        wine_server_add_data( req, ptr, size );
+        req->mapping = wine_server_obj_handle( mapping );
+        req->size = size;
+        if (!mapping) wine_server_add_data( req, ptr, size );
         if (!(status = wine_server_call( req )))
         {
             if (cache) cache->seqno = reply->seqno;
@@ -629,6 +674,7 @@ NTSTATUS WINAPI NtUserSetClipboardData( UINT format, HANDLE data, struct set_cli
     else free( cache );
 
     pthread_mutex_unlock( &clipboard_mutex );
+    if (mapping) NtClose( mapping );
     if (prev) free_cached_data( prev );
 
 done:
@@ -644,6 +690,7 @@ HANDLE WINAPI NtUserGetClipboardData( UINT format, struct get_clipboard_params *
     unsigned int status;
     UINT from, data_seqno;
     size_t size;
+    HANDLE mapping;
     HWND owner;
     BOOL render = TRUE;
 
@@ -668,9 +715,12 @@ HANDLE WINAPI NtUserGetClipboardData( UINT format, struct get_clipboard_params *
             size = reply->total;
             data_seqno = reply->seqno;
             owner = wine_server_ptr_handle( reply->owner );
+            mapping = wine_server_ptr_handle( reply->mapping );
         }
         SERVER_END_REQ;
 
+        if (!status && mapping) status = read_clipboard_mapping( mapping, params->data, size );
+
         params->size = size;
 
         if (!status && size)
@@ -23,6 +23,10 @@
 #endif
 
 #include <assert.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -585,17 +589,184 @@ static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
     }
 }
 
+/* Large operations whose pixels can be computed independently are split into bands
+ * of rows, processed by a few worker threads together with the calling thread. */
+
+#define MAX_BAND_WORKERS 7
+
+struct band_job
+{
+    BOOL (*process)( struct band_job *job, const RECT *rect );
+    const struct clipped_rects *clipped_rects;
+    int   top;
+    int   bottom;
+    int   band_height;
+    LONG  next_band;
+    LONG  failed;
+};
+
+static pthread_mutex_t band_job_mutex = PTHREAD_MUTEX_INITIALIZER;  /* serializes the jobs */
+static pthread_mutex_t band_mutex = PTHREAD_MUTEX_INITIALIZER;      /* protects the fields below */
+static pthread_cond_t band_job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t band_done_cond = PTHREAD_COND_INITIALIZER;
+static struct band_job *current_band_job;
+static unsigned int band_job_serial;
+static unsigned int band_workers_busy;
+static unsigned int band_worker_count;
+static unsigned int band_pixel_threshold = 512 * 512;
+
+static void process_bands( struct band_job *job )
+{
+    const struct clipped_rects *clipped_rects = job->clipped_rects;
+    int i, top;
+    RECT rc;
+
+    while ((top = job->top + (InterlockedIncrement( &job->next_band ) - 1) * job->band_height) < job->bottom)
+    {
+        for (i = 0; i < clipped_rects->count; i++)
+        {
+            rc = clipped_rects->rects[i];
+            rc.top = max( rc.top, top );
+            rc.bottom = min( rc.bottom, top + job->band_height );
+            if (rc.top >= rc.bottom) continue;
+            if (!job->process( job, &rc )) InterlockedExchange( &job->failed, TRUE );
+        }
+    }
+}
+
+static void *band_worker( void *arg )
+{
+    unsigned int serial = 0;
+    struct band_job *job;
+
+    pthread_mutex_lock( &band_mutex );
+    for (;;)
+    {
+        while (serial == band_job_serial) pthread_cond_wait( &band_job_cond, &band_mutex );
+        serial = band_job_serial;
+        if (!(job = current_band_job)) continue;  /* already finished */
+        band_workers_busy++;
+        pthread_mutex_unlock( &band_mutex );
+
+        process_bands( job );
+
+        pthread_mutex_lock( &band_mutex );
+        if (!--band_workers_busy) pthread_cond_signal( &band_done_cond );
+    }
+    return NULL;
+}
+
+static void init_band_workers(void)
+{
+    const char *env;
+    long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    unsigned int i, count = cpus > 1 ? min( cpus - 1, MAX_BAND_WORKERS ) : 0;
+    sigset_t sigset, old_sigset;
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if ((env = getenv( "WINE_DIB_PARALLEL_THRESHOLD" ))) band_pixel_threshold = atoi( env );
+    if (!band_pixel_threshold) count = 0;
+
+    /* the workers only touch bitmap bits, keep them out of the way of signals */
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &old_sigset );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    for (i = 0; i < count; i++)
+    {
+        if (pthread_create( &thread, &attr, band_worker, NULL )) break;
+        band_worker_count++;
+    }
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old_sigset, NULL );
+
+    TRACE( "%u workers, threshold %u pixels\n", band_worker_count, band_pixel_threshold );
+}
+
+/* returns FALSE if the job is too small to be worth splitting, in which case nothing is done */
+static BOOL run_band_job( struct band_job *job, const struct clipped_rects *clipped_rects )
+{
+    static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+    ULONGLONG pixels = 0;
+    int i;
+
+    pthread_once( &init_once, init_band_workers );
+    if (!band_worker_count) return FALSE;
+
+    job->top = INT_MAX;
+    job->bottom = INT_MIN;
+    for (i = 0; i < clipped_rects->count; i++)
+    {
+        const RECT *rc = &clipped_rects->rects[i];
+        pixels += (ULONGLONG)(rc->right - rc->left) * (rc->bottom - rc->top);
+        job->top = min( job->top, rc->top );
+        job->bottom = max( job->bottom, rc->bottom );
+    }
+    if (pixels < band_pixel_threshold) return FALSE;
+    /* another thread is using the workers */
+    if (pthread_mutex_trylock( &band_job_mutex )) return FALSE;
+
+    job->clipped_rects = clipped_rects;
+    job->band_height = max( 16, (job->bottom - job->top) / ((band_worker_count + 1) * 4) );
+    job->next_band = 0;
+    job->failed = FALSE;
+
+    pthread_mutex_lock( &band_mutex );
+    current_band_job = job;
+    band_job_serial++;
+    pthread_cond_broadcast( &band_job_cond );
+    pthread_mutex_unlock( &band_mutex );
+
+    process_bands( job );
+
+    pthread_mutex_lock( &band_mutex );
+    current_band_job = NULL;
+    while (band_workers_busy) pthread_cond_wait( &band_done_cond, &band_mutex );
+    pthread_mutex_unlock( &band_mutex );
+
+    pthread_mutex_unlock( &band_job_mutex );
+    return TRUE;
+}
+
+struct blend_job
+{
+    struct band_job   job;
+    dib_info         *dst;
+    const dib_info   *src;
+    POINT             offset;
+    BLENDFUNCTION     blend;
+};
+
+static BOOL blend_band( struct band_job *job, const RECT *rect )
+{
+    struct blend_job *blend = CONTAINING_RECORD( job, struct blend_job, job );
+
+    blend->dst->funcs->blend_rects( blend->dst, 1, rect, blend->src, &blend->offset, blend->blend );
+    return TRUE;
+}
+
 static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                          HRGN clip, BLENDFUNCTION blend )
 {
     POINT offset;
     struct clipped_rects clipped_rects;
+    struct blend_job job;
 
     if (!get_clipped_rects( dst, dst_rect, clip, &clipped_rects )) return ERROR_SUCCESS;
 
     offset.x = src_rect->left - dst_rect->left;
     offset.y = src_rect->top  - dst_rect->top;
-    dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
+
+    job.job.process = blend_band;
+    job.dst    = dst;
+    job.src    = src;
+    job.offset = offset;
+    job.blend  = blend;
+
+    /* rows must be processed in order when blending a bitmap onto itself */
+    if (src->bits.ptr == dst->bits.ptr || !run_band_job( &job.job, &clipped_rects ))
+        dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
 
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
@@ -680,16 +851,42 @@ static void get_gradient_triangle_vertices( const GRADIENT_TRIANGLE *tri, const
     bounds->bottom = v[2].y;
 }
 
+struct gradient_job
+{
+    struct band_job   job;
+    dib_info         *dib;
+    const TRIVERTEX  *v;
+    int               mode;
+};
+
+static BOOL gradient_band( struct band_job *job, const RECT *rect )
+{
+    struct gradient_job *gradient = CONTAINING_RECORD( job, struct gradient_job, job );
+
+    return gradient->dib->funcs->gradient_rect( gradient->dib, rect, gradient->v, gradient->mode );
+}
+
 static BOOL gradient_rect( dib_info *dib, TRIVERTEX *v, int mode, HRGN clip, const RECT *bounds )
 {
     int i;
     struct clipped_rects clipped_rects;
+    struct gradient_job job;
     BOOL ret = TRUE;
 
     if (!get_clipped_rects( dib, bounds, clip, &clipped_rects )) return TRUE;
-    for (i = 0; i < clipped_rects.count; i++)
+
+    job.job.process = gradient_band;
+    job.dib  = dib;
+    job.v    = v;
+    job.mode = mode;
+
+    if (run_band_job( &job.job, &clipped_rects )) ret = !job.job.failed;
+    else
     {
-        if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
+        for (i = 0; i < clipped_rects.count; i++)
+        {
+            if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
+        }
     }
     free_clipped_rects( &clipped_rects );
     return ret;
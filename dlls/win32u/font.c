@@ -98,6 +98,8 @@ struct gdi_font_face
 
 static const struct font_backend_funcs *font_funcs;
 
+static void init_font_list(void);
+
 static const MAT2 identity = { {0,1}, {0,0}, {0,0}, {0,1} };
 
 static const WCHAR nt_prefixW[] = {'\\','?','?','\\'};
@@ -3551,6 +3553,7 @@ static BOOL font_EnumFonts( PHYSDEV dev, LOGFONTW *lf, font_enum_proc proc, LPAR
 
     count = create_enum_charset_list( charset, enum_charsets );
 
+    init_font_list();
     pthread_mutex_lock( &font_lock );
 
     if (lf && lf->lfFaceName[0])
@@ -4679,6 +4682,7 @@ static HFONT font_SelectFont( PHYSDEV dev, HFONT hfont, UINT *aa_flags )
         }
         TRACE( "DC transform %f %f %f %f\n", dcmat.eM11, dcmat.eM12, dcmat.eM21, dcmat.eM22 );
 
+        init_font_list();
         pthread_mutex_lock( &font_lock );
 
         font = select_font( &lf, dcmat, can_use_bitmap );
@@ -6827,18 +6831,10 @@ static HKEY open_hkcu(void)
  */
 UINT font_init(void)
 {
-    OBJECT_ATTRIBUTES attr = { sizeof(attr) };
-    UNICODE_STRING name;
-    HANDLE mutex;
-    DWORD disposition;
     UINT dpi = 0;
 
-    static WCHAR wine_font_mutexW[] =
-        {'\\','B','a','s','e','N','a','m','e','d','O','b','j','e','c','t','s',
-         '\\','_','_','W','I','N','E','_','F','O','N','T','_','M','U','T','E','X','_','_'};
     static const WCHAR wine_fonts_keyW[] =
         {'S','o','f','t','w','a','r','e','\\','W','i','n','e','\\','F','o','n','t','s'};
-    static const WCHAR cacheW[] = {'C','a','c','h','e'};
 
     if (!(hkcu_key = open_hkcu())) return 0;
     wine_fonts_key = reg_create_key( hkcu_key, wine_fonts_keyW, sizeof(wine_fonts_keyW), 0, NULL );
@@ -6846,8 +6842,25 @@ UINT font_init(void)
     if (!dpi) return 96;
     update_codepage( dpi );
 
-    if (!(font_funcs = init_freetype_lib()))
-        return dpi;
+    font_funcs = init_freetype_lib();
+    return dpi;
+}
+
+/* the font list is only loaded the first time a font is realized, enumerated or added,
+ * so that processes that never draw text don't have to scan the system fonts */
+static void load_font_list(void)
+{
+    OBJECT_ATTRIBUTES attr = { sizeof(attr) };
+    UNICODE_STRING name;
+    HANDLE mutex;
+    DWORD disposition;
+
+    static WCHAR wine_font_mutexW[] =
+        {'\\','B','a','s','e','N','a','m','e','d','O','b','j','e','c','t','s',
+         '\\','_','_','W','I','N','E','_','F','O','N','T','_','M','U','T','E','X','_','_'};
+    static const WCHAR cacheW[] = {'C','a','c','h','e'};
+
+    TRACE( "loading fonts\n" );
 
     load_system_bitmap_fonts();
     load_file_system_fonts();
@@ -6858,7 +6871,7 @@ UINT font_init(void)
     name.Buffer = wine_font_mutexW;
     name.Length = name.MaximumLength = sizeof(wine_font_mutexW);
 
-    if (NtCreateMutant( &mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0) return dpi;
+    if (NtCreateMutant( &mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0) return;
     NtWaitForSingleObject( mutex, FALSE, NULL );
 
     wine_fonts_cache_key = reg_create_key( wine_fonts_key, cacheW, sizeof(cacheW),
@@ -6884,7 +6897,13 @@ UINT font_init(void)
     load_system_links();
     dump_gdi_font_list();
     dump_gdi_font_subst();
-    return dpi;
+}
+
+static void init_font_list(void)
+{
+    static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+    if (font_funcs) pthread_once( &init_once, load_font_list );
 }
 
 /***********************************************************************
@@ -6894,6 +6913,7 @@ INT WINAPI NtGdiAddFontResourceW( const WCHAR *str, ULONG size, ULONG files, DWO
                                   DWORD tid, void *dv )
 {
     if (!font_funcs) return 1;
+    init_font_list();
     return add_font_resource( str, flags );
 }
 
@@ -6916,6 +6936,7 @@ HANDLE WINAPI NtGdiAddFontMemResourceEx( void *ptr, DWORD size, void *dv, ULONG
     if (!(copy = malloc( size ))) return NULL;
     memcpy( copy, ptr, size );
 
+    init_font_list();
     pthread_mutex_lock( &font_lock );
     num_fonts = font_funcs->add_mem_font( copy, size, ADDFONT_ALLOW_BITMAP | ADDFONT_ADD_RESOURCE );
     pthread_mutex_unlock( &font_lock );
@@ -6962,6 +6983,7 @@ BOOL WINAPI NtGdiRemoveFontResourceW( const WCHAR *str, ULONG size, ULONG files,
                                       DWORD tid, void *dv )
 {
     if (!font_funcs) return TRUE;
+    init_font_list();
     return remove_font_resource( str, flags );
 }
 
@@ -1320,6 +1320,107 @@ static void unix_face_destroy( struct unix_face *This )
     free( This );
 }
 
+/* The faces found through fontconfig are kept in a volatile registry value, so that
+ * only the first process of a session has to open every system font file. */
+
+#define FONT_CACHE_MAGIC  0x31435446  /* "FTC1" */
+
+enum font_cache_record_type
+{
+    FONT_CACHE_DIR,
+    FONT_CACHE_FACE
+};
+
+struct font_cache_record
+{
+    DWORD size;  /* size of the record, including the header */
+    DWORD type;
+};
+
+struct font_cache_dir
+{
+    struct font_cache_record record;
+    DWORD                    mtime;
+    char                     path[1];
+};
+
+struct font_cache_face
+{
+    struct font_cache_record record;
+    DWORD                    face_index;
+    DWORD                    flags;
+    DWORD                    ntm_flags;
+    DWORD                    weight;
+    DWORD                    version;
+    DWORD                    scalable;
+    FONTSIGNATURE            fs;
+    struct bitmap_font_size  size;
+    WCHAR                    names[1];  /* family, second, style, full and file names */
+};
+
+static BOOL font_cache_recording;
+static BYTE *font_cache_data;
+static SIZE_T font_cache_size, font_cache_capacity;
+
+static void *font_cache_add_record( DWORD type, SIZE_T size )
+{
+    struct font_cache_record *record;
+
+    size = (size + 3) & ~3;
+    if (font_cache_size + size > font_cache_capacity)
+    {
+        SIZE_T capacity = max( font_cache_capacity * 2, font_cache_size + size + 0x10000 );
+        BYTE *data;
+
+        if (!(data = realloc( font_cache_data, capacity )))
+        {
+            font_cache_recording = FALSE;
+            return NULL;
+        }
+        font_cache_data = data;
+        font_cache_capacity = capacity;
+    }
+    record = (struct font_cache_record *)(font_cache_data + font_cache_size);
+    memset( record, 0, size );
+    record->size = size;
+    record->type = type;
+    font_cache_size += size;
+    return record;
+}
+
+static WCHAR *font_cache_add_name( WCHAR *ptr, const WCHAR *name )
+{
+    UINT len = name ? lstrlenW( name ) : 0;
+
+    if (len) memcpy( ptr, name, len * sizeof(WCHAR) );
+    ptr[len] = 0;
+    return ptr + len + 1;
+}
+
+static void font_cache_add_face( const struct unix_face *unix_face, const WCHAR *file,
+                                 DWORD face_index, DWORD flags )
+{
+    const WCHAR *names[] = { unix_face->family_name, unix_face->second_name, unix_face->style_name,
+                             unix_face->full_name, file };
+    struct font_cache_face *face;
+    UINT i, len = 0;
+    WCHAR *ptr;
+
+    for (i = 0; i < ARRAY_SIZE(names); i++) len += (names[i] ? lstrlenW( names[i] ) : 0) + 1;
+    if (!(face = font_cache_add_record( FONT_CACHE_FACE, offsetof( struct font_cache_face, names[len] ))))
+        return;
+
+    face->face_index = face_index;
+    face->flags      = flags;
+    face->ntm_flags  = unix_face->ntm_flags;
+    face->weight     = unix_face->weight;
+    face->version    = unix_face->font_version;
+    face->scalable   = unix_face->scalable;
+    face->fs         = unix_face->fs;
+    face->size       = unix_face->size;
+    for (i = 0, ptr = face->names; i < ARRAY_SIZE(names); i++) ptr = font_cache_add_name( ptr, names[i] );
+}
+
 static int add_unix_face( const char *unix_name, const WCHAR *file, void *data_ptr, SIZE_T data_size,
                           DWORD face_index, DWORD flags, DWORD *num_faces )
 {
@@ -1339,6 +1440,7 @@ static int add_unix_face( const char *unix_name, const WCHAR *file, void *data_p
     }
 
     if (!HIWORD( flags )) flags |= ADDFONT_AA_FLAGS( default_aa_flags );
+    if (font_cache_recording) font_cache_add_face( unix_face, file, face_index, flags );
 
     ret = add_gdi_face( unix_face->family_name, unix_face->second_name, unix_face->style_name, unix_face->full_name,
                         file, data_ptr, data_size, face_index, unix_face->fs, unix_face->ntm_flags, unix_face->weight,
@@ -1656,6 +1758,147 @@ static void init_fontconfig(void)
     }
 }
 
+static const char font_cache_keyA[] = "Software\\Wine\\Fonts\\Fontconfig Cache";
+
+static DWORD get_dir_mtime( const char *dir )
+{
+    struct stat st;
+
+    if (stat( dir, &st )) return 0;
+    return st.st_mtime;
+}
+
+static void font_cache_add_dir( const char *dir )
+{
+    struct font_cache_dir *record;
+    SIZE_T len = strlen( dir ) + 1;
+
+    if (!(record = font_cache_add_record( FONT_CACHE_DIR, offsetof( struct font_cache_dir, path[len] ))))
+        return;
+    record->mtime = get_dir_mtime( dir );
+    memcpy( record->path, dir, len );
+}
+
+static const struct font_cache_record *font_cache_next( const struct font_cache_record *record,
+                                                        const BYTE *end )
+{
+    record = (const struct font_cache_record *)((const BYTE *)record + record->size);
+    if ((const BYTE *)end - (const BYTE *)record < sizeof(*record)) return NULL;
+    if (record->size < sizeof(*record) || record->size > (const BYTE *)end - (const BYTE *)record) return NULL;
+    return record;
+}
+
+static BOOL font_cache_has_dir( const BYTE *data, const BYTE *end, const char *dir )
+{
+    const struct font_cache_record *record;
+
+    for (record = font_cache_next( (const struct font_cache_record *)data, end ); record;
+         record = font_cache_next( record, end ))
+    {
+        if (record->type == FONT_CACHE_DIR && !strcmp( ((const struct font_cache_dir *)record)->path, dir ))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* the first record is a header containing the magic */
+static BOOL load_fontconfig_cache( FcConfig *config )
+{
+    static const struct font_cache_record header = { sizeof(header), FONT_CACHE_MAGIC };
+    KEY_VALUE_PARTIAL_INFORMATION *info = NULL;
+    const struct font_cache_record *record;
+    UNICODE_STRING nameW = { 0 };
+    FcStrList *dir_list;
+    const FcChar8 *dir;
+    const BYTE *data, *end;
+    BOOL ret = FALSE;
+    NTSTATUS status;
+    ULONG size = 0;
+    HKEY hkey;
+
+    if (!(hkey = reg_open_hkcu_key( font_cache_keyA ))) return FALSE;
+    status = NtQueryValueKey( hkey, &nameW, KeyValuePartialInformation, NULL, 0, &size );
+    if ((status == STATUS_BUFFER_TOO_SMALL || status == STATUS_BUFFER_OVERFLOW) && (info = malloc( size )))
+        status = NtQueryValueKey( hkey, &nameW, KeyValuePartialInformation, info, size, &size );
+    NtClose( hkey );
+    if (!info) return FALSE;
+    if (status || info->Type != REG_BINARY || info->DataLength < sizeof(header) ||
+        memcmp( info->Data, &header, sizeof(header) ))
+        goto done;
+
+    data = info->Data;
+    end = data + info->DataLength;
+
+    /* every directory has to be unchanged, and the configuration can't have new ones */
+    for (record = font_cache_next( (const struct font_cache_record *)data, end ); record;
+         record = font_cache_next( record, end ))
+    {
+        const struct font_cache_dir *cached_dir = (const struct font_cache_dir *)record;
+
+        if (record->type != FONT_CACHE_DIR) continue;
+        if (record->size < sizeof(*cached_dir) || ((const char *)record)[record->size - 1]) goto done;
+        if (get_dir_mtime( cached_dir->path ) != cached_dir->mtime)
+        {
+            TRACE( "%s changed\n", debugstr_a(cached_dir->path) );
+            goto done;
+        }
+    }
+    if (!(dir_list = pFcConfigGetFontDirs( config ))) goto done;
+    while ((dir = pFcStrListNext( dir_list )))
+        if (!font_cache_has_dir( data, end, (const char *)dir )) break;
+    pFcStrListDone( dir_list );
+    if (dir)
+    {
+        TRACE( "%s isn't cached\n", debugstr_a((const char *)dir) );
+        goto done;
+    }
+
+    for (record = font_cache_next( (const struct font_cache_record *)data, end ); record;
+         record = font_cache_next( record, end ))
+    {
+        const struct font_cache_face *face = (const struct font_cache_face *)record;
+        const WCHAR *names[5], *ptr = face->names, *names_end;
+        UINT i;
+
+        if (record->type != FONT_CACHE_FACE) continue;
+        if (record->size < sizeof(*face)) goto done;
+        names_end = (const WCHAR *)((const BYTE *)record + record->size);
+        for (i = 0; i < ARRAY_SIZE(names); i++)
+        {
+            names[i] = ptr;
+            while (ptr < names_end && *ptr) ptr++;
+            if (ptr++ >= names_end) goto done;
+        }
+        add_gdi_face( names[0], names[1], names[2], names[3], names[4][0] ? names[4] : NULL, NULL, 0,
+                      face->face_index, face->fs, face->ntm_flags, face->weight, face->version,
+                      face->flags, face->scalable ? NULL : &face->size );
+    }
+    TRACE( "loaded fonts from cache\n" );
+    ret = TRUE;
+
+done:
+    free( info );
+    return ret;
+}
+
+static void store_fontconfig_cache(void)
+{
+    WCHAR nameW[64];
+    HKEY hkey;
+
+    if (font_cache_recording &&
+        (hkey = reg_create_key( hkcu_key, nameW, asciiz_to_unicode( nameW, font_cache_keyA ) - sizeof(WCHAR),
+                                REG_OPTION_VOLATILE, NULL )))
+    {
+        set_reg_value( hkey, NULL, REG_BINARY, font_cache_data, font_cache_size );
+        NtClose( hkey );
+    }
+    font_cache_recording = FALSE;
+    free( font_cache_data );
+    font_cache_data = NULL;
+    font_cache_size = font_cache_capacity = 0;
+}
+
 static void fontconfig_add_fonts_from_dir_list( FcConfig *config, FcStrList *dir_list, FcStrSet *done_set, UINT flags )
 {
     const FcChar8 *dir;
@@ -1672,6 +1915,8 @@ static void fontconfig_add_fonts_from_dir_list( FcConfig *config, FcStrList *dir
         if (pFcStrSetMember( done_set, dir )) continue;
 
         TRACE( "adding fonts from %s\n", dir );
+        /* missing directories are recorded too, the cache gets invalid if they appear */
+        if (font_cache_recording) font_cache_add_dir( (const char *)dir );
         if (!(cache = pFcDirCacheRead( dir, FcFalse, config ))) continue;
 
         if (!(font_set = pFcCacheCopySet( cache ))) goto done;
@@ -1709,10 +1954,14 @@ static void load_fontconfig_fonts( void )
 
     if (!fontconfig_enabled) return;
     if (!(config = pFcConfigGetCurrent())) goto done;
+    if (load_fontconfig_cache( config )) goto done;
     if (!(done_set = pFcStrSetCreate())) goto done;
     if (!(dir_list = pFcConfigGetFontDirs( config ))) goto done;
 
+    font_cache_recording = TRUE;
+    font_cache_add_record( FONT_CACHE_MAGIC, sizeof(struct font_cache_record) );
     fontconfig_add_fonts_from_dir_list( config, dir_list, done_set, ADDFONT_EXTERNAL_FONT );
+    store_fontconfig_cache();
 
 done:
     if (dir_list) pFcStrListDone( dir_list );
@@ -813,11 +813,17 @@ static void check_for_events( UINT flags )
 SHORT WINAPI NtUserGetAsyncKeyState( INT key )
 {
     const desktop_shm_t *shared = get_desktop_shared_memory();
+    struct user_thread_info *thread_info = get_user_thread_info();
     BYTE state;
 
     if (key < 0 || key >= 256 || !shared) return 0;
 
-    check_for_events( QS_INPUT );
+    /* applications poll many keys in a row, process driver events only once per tick */
+    if (thread_info->last_driver_time != NtGetTickCount())
+    {
+        check_for_events( QS_INPUT );
+        thread_info->last_driver_time = NtGetTickCount();
+    }
 
     SHARED_READ_BEGIN( shared, desktop_shm_t )
     {
@@ -833,6 +839,8 @@ SHORT WINAPI NtUserGetAsyncKeyState( INT key )
  */
 DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 {
+    const queue_shm_t *shared;
+    BOOL skip = FALSE;
     DWORD ret;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
@@ -843,6 +851,18 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    if ((shared = get_queue_shared_memory()))
+    {
+        SHARED_READ_BEGIN( shared, queue_shm_t )
+        {
+            /* the server only needs to be involved if there are changed bits to clear */
+            skip = shared->created && !(shared->changed_bits & flags);
+            ret = MAKELONG( shared->changed_bits & flags, shared->wake_bits & flags );
+        }
+        SHARED_READ_END
+    }
+    if (skip) return ret;
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -858,10 +878,23 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
  */
 DWORD get_input_state(void)
 {
+    const queue_shm_t *shared;
+    BOOL skip = FALSE;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    if ((shared = get_queue_shared_memory()))
+    {
+        SHARED_READ_BEGIN( shared, queue_shm_t )
+        {
+            skip = shared->created;
+            ret = shared->wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+        }
+        SHARED_READ_END
+    }
+    if (skip) return ret;
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
@@ -955,8 +988,11 @@ SHORT WINAPI NtUserGetKeyState( INT vkey )
             if (!desktop_shared) skip = FALSE;
             else SHARED_READ_BEGIN( desktop_shared, desktop_shm_t )
             {
-                if (shared->sync_serial != desktop_shared->update_serial)
-                    skip = FALSE; /* server needs to call sync_input_keystate */
+                /* server needs to call sync_input_keystate, unless it wouldn't change anything */
+                if (shared->sync_serial != desktop_shared->update_serial &&
+                    memcmp( (const void *)shared->desktop_keystate, (const void *)desktop_shared->keystate,
+                            sizeof(shared->desktop_keystate) ))
+                    skip = FALSE;
             }
             SHARED_READ_END
         }
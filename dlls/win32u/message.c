@@ -3513,8 +3513,20 @@ static void wait_message_reply( UINT flags )
 
     for (;;)
     {
+        const queue_shm_t *shared = get_queue_shared_memory();
         unsigned int wake_bits = 0;
 
+        /* the reply is usually ready when we wake up, no need to ask the server */
+        if (shared)
+        {
+            SHARED_READ_BEGIN( shared, queue_shm_t )
+            {
+                if (shared->created) wake_bits = shared->wake_bits & QS_SMRESULT;
+            }
+            SHARED_READ_END
+        }
+        if (wake_bits) return;
+
         SERVER_START_REQ( set_queue_mask )
         {
             req->wake_mask    = wake_mask;
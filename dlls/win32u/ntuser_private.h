@@ -280,6 +280,7 @@ extern const desktop_shm_t *get_desktop_shared_memory(void);
 extern const queue_shm_t *get_queue_shared_memory(void);
 extern const input_shm_t *get_input_shared_memory(void);
 extern const input_shm_t *get_foreground_shared_memory(void);
+extern const window_shm_t *get_window_shared_memory( HWND hwnd );
 
 static inline UINT win_get_flags( HWND hwnd )
 {
@@ -607,6 +607,24 @@ UINT WINAPI NtUserGetRawInputDeviceInfo( HANDLE handle, UINT command, void *data
     return *data_size;
 }
 
+/* the server sets QS_RAWINPUT whenever it queues raw input for the thread
+ * and clears it once get_rawinput_buffer drained everything */
+static BOOL rawinput_pending(void)
+{
+    const queue_shm_t *shared;
+    BOOL ret = TRUE;
+
+    if ((shared = get_queue_shared_memory()))
+    {
+        SHARED_READ_BEGIN( shared, queue_shm_t )
+        {
+            if (shared->created) ret = !!(shared->wake_bits & QS_RAWINPUT);
+        }
+        SHARED_READ_END
+    }
+    return ret;
+}
+
 /**********************************************************************
  *         NtUserGetRawInputBuffer   (win32u.@)
  */
@@ -639,6 +657,14 @@ UINT WINAPI NtUserGetRawInputBuffer( RAWINPUT *data, UINT *data_size, UINT heade
         return ~0u;
     }
 
+    if (!rawinput_pending())
+    {
+        TRACE( "data %p, data_size %p (%u), header_size %u, no pending input\n",
+               data, data_size, *data_size, header_size );
+        *data_size = 0;
+        return 0;
+    }
+
     if (!data)
     {
         TRACE( "data %p, data_size %p (%u), header_size %u\n", data, data_size, *data_size, header_size );
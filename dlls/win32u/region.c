@@ -1608,7 +1608,16 @@ static BOOL REGION_RegionOp(
      * have to worry about using too much memory. I hope to be able to
      * nuke the Xrealloc() at the end of this function eventually.
      */
-    if (!init_region( &newReg, max(reg1->numRects,reg2->numRects) * 2 )) return FALSE;
+    if (destReg != reg1 && destReg != reg2 && destReg->rects != destReg->rects_buf &&
+        destReg->size >= max(reg1->numRects,reg2->numRects) * 2)
+    {
+        /* reuse the rectangles array of the destination, its contents are overwritten anyway */
+        newReg.rects = destReg->rects;
+        newReg.size = destReg->size;
+        empty_region( &newReg );
+        init_region( destReg, 0 );
+    }
+    else if (!init_region( &newReg, max(reg1->numRects,reg2->numRects) * 2 )) return FALSE;
 
     /*
      * Initialize ybot and ytop.
@@ -1677,7 +1686,7 @@ static BOOL REGION_RegionOp(
 
             if ((top != bot) && (nonOverlap1Func != NULL))
 	    {
-		if (!nonOverlap1Func(&newReg, r1, r1BandEnd, top, bot)) return FALSE;
+		if (!nonOverlap1Func(&newReg, r1, r1BandEnd, top, bot)) goto failed;
 	    }
 
 	    ytop = r2->top;
@@ -1689,7 +1698,7 @@ static BOOL REGION_RegionOp(
 
             if ((top != bot) && (nonOverlap2Func != NULL))
 	    {
-		if (!nonOverlap2Func(&newReg, r2, r2BandEnd, top, bot)) return FALSE;
+		if (!nonOverlap2Func(&newReg, r2, r2BandEnd, top, bot)) goto failed;
 	    }
 
 	    ytop = r1->top;
@@ -1718,7 +1727,7 @@ static BOOL REGION_RegionOp(
 	curBand = newReg.numRects;
 	if (ybot > ytop)
 	{
-	    if (!overlapFunc(&newReg, r1, r1BandEnd, r2, r2BandEnd, ytop, ybot)) return FALSE;
+	    if (!overlapFunc(&newReg, r1, r1BandEnd, r2, r2BandEnd, ytop, ybot)) goto failed;
 	}
 
 	if (newReg.numRects != curBand)
@@ -1756,7 +1765,7 @@ static BOOL REGION_RegionOp(
 		    r1BandEnd++;
 		}
 		if (!nonOverlap1Func(&newReg, r1, r1BandEnd, max(r1->top,ybot), r1->bottom))
-                    return FALSE;
+                    goto failed;
 		r1 = r1BandEnd;
 	    } while (r1 != r1End);
 	}
@@ -1771,7 +1780,7 @@ static BOOL REGION_RegionOp(
 		 r2BandEnd++;
 	    }
 	    if (!nonOverlap2Func(&newReg, r2, r2BandEnd, max(r2->top,ybot), r2->bottom))
-                return FALSE;
+                goto failed;
 	    r2 = r2BandEnd;
 	} while (r2 != r2End);
     }
@@ -1784,6 +1793,10 @@ static BOOL REGION_RegionOp(
     REGION_compact( &newReg );
     move_rects( destReg, &newReg );
     return TRUE;
+
+failed:
+    destroy_region( &newReg );
+    return FALSE;
 }
 
 /***********************************************************************
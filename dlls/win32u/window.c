@@ -175,6 +175,34 @@ HWND get_hwnd_message_parent(void)
     return UlongToHandle( thread_info->msg_window );
 }
 
+/***********************************************************************
+ *           get_shared_window_info
+ *
+ * Read the state the server publishes for a window, which avoids a server
+ * call for windows of other processes. Fails if the handle isn't valid.
+ */
+static BOOL get_shared_window_info( HWND hwnd, struct window_shared_memory *info )
+{
+    const window_shm_t *shm;
+
+    if (!(shm = get_window_shared_memory( hwnd ))) return FALSE;
+
+    SHARED_READ_BEGIN( shm, window_shm_t )
+    {
+        info->handle   = shm->handle;
+        info->tid      = shm->tid;
+        info->pid      = shm->pid;
+        info->parent   = shm->parent;
+        info->owner    = shm->owner;
+        info->style    = shm->style;
+        info->ex_style = shm->ex_style;
+    }
+    SHARED_READ_END
+
+    if (!info->handle) return FALSE;
+    return !HIWORD(hwnd) || HIWORD(hwnd) == 0xffff || info->handle == HandleToUlong( hwnd );
+}
+
 /***********************************************************************
  *           get_full_window_handle
  *
@@ -204,6 +232,10 @@ HWND get_full_window_handle( HWND hwnd )
     }
     else  /* may belong to another process */
     {
+        struct window_shared_memory info;
+
+        if (get_shared_window_info( hwnd, &info )) return UlongToHandle( info.handle );
+
         SERVER_START_REQ( get_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -289,6 +321,7 @@ HWND is_current_process_window( HWND hwnd )
 /* see IsWindow */
 BOOL is_window( HWND hwnd )
 {
+    struct window_shared_memory info;
     WND *win;
     BOOL ret;
 
@@ -302,6 +335,8 @@ BOOL is_window( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_shared_window_info( hwnd, &info )) return TRUE;
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -314,6 +349,7 @@ BOOL is_window( HWND hwnd )
 /* see GetWindowThreadProcessId */
 DWORD get_window_thread( HWND hwnd, DWORD *process )
 {
+    struct window_shared_memory info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -333,6 +369,12 @@ DWORD get_window_thread( HWND hwnd, DWORD *process )
     }
 
     /* check other processes */
+    if (get_shared_window_info( hwnd, &info ))
+    {
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -360,7 +402,17 @@ HWND get_parent( HWND hwnd )
     if (win == WND_DESKTOP) return 0;
     if (win == WND_OTHER_PROCESS)
     {
-        LONG style = get_window_long( hwnd, GWL_STYLE );
+        struct window_shared_memory info;
+        LONG style;
+
+        if (get_shared_window_info( hwnd, &info ))
+        {
+            if (info.style & WS_POPUP) return UlongToHandle( info.owner );
+            if (info.style & WS_CHILD) return UlongToHandle( info.parent );
+            return 0;
+        }
+
+        style = get_window_long( hwnd, GWL_STYLE );
         if (style & (WS_POPUP | WS_CHILD))
         {
             SERVER_START_REQ( get_window_tree )
@@ -719,6 +771,10 @@ HWND WINAPI NtUserGetAncestor( HWND hwnd, UINT type )
         }
         else /* need to query the server */
         {
+            struct window_shared_memory info;
+
+            if (get_shared_window_info( hwnd, &info )) return UlongToHandle( info.parent );
+
             SERVER_START_REQ( get_window_tree )
             {
                 req->handle = wine_server_user_handle( hwnd );
@@ -1067,6 +1123,13 @@ static LONG_PTR get_window_long_size( HWND hwnd, INT offset, UINT size, BOOL ans
             RtlSetLastWin32Error( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if (offset == GWL_STYLE || offset == GWL_EXSTYLE)
+        {
+            struct window_shared_memory info;
+
+            if (get_shared_window_info( hwnd, &info ))
+                return offset == GWL_STYLE ? info.style : info.ex_style;
+        }
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
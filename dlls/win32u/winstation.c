@@ -806,6 +806,28 @@ const input_shm_t *get_foreground_shared_memory(void)
     return thread_info->foreground_shm;
 }
 
+const window_shm_t *get_window_shared_memory( HWND hwnd )
+{
+    static const WCHAR nameW[] =
+    {
+        '\\','K','e','r','n','e','l','O','b','j','e','c','t','s','\\',
+        '_','_','w','i','n','e','_','t','h','r','e','a','d','_','m','a','p','p','i','n','g','s','\\',
+        'w','i','n','d','o','w','s',0
+    };
+    static const window_shm_t *window_shm;
+    UINT index = (LOWORD(hwnd) - FIRST_USER_HANDLE) >> 1;
+    const window_shm_t *ptr;
+
+    if (index >= WINDOW_SHM_ENTRIES) return NULL;
+    if (!window_shm)
+    {
+        if (!(ptr = map_shared_memory_section( nameW, WINDOW_SHM_ENTRIES * sizeof(*ptr), NULL ))) return NULL;
+        if (InterlockedCompareExchangePointer( (void **)&window_shm, (void *)ptr, NULL ))
+            NtUnmapViewOfSection( GetCurrentProcess(), (void *)ptr );
+    }
+    return &window_shm[index];
+}
+
 /***********************************************************************
  *           winstation_init
  *
@@ -89,6 +89,65 @@ static inline float to_sRGB_component(float f)
     return 1.055f * powf(f, 1.0f/2.4f) - 0.055f;
 }
 
+static inline BYTE to_sRGB_byte_slow(float f)
+{
+    return (BYTE)floorf(to_sRGB_component(f) * 255.0f + 0.51f);
+}
+
+/* smallest value in [0,1] that to_sRGB_byte_slow() maps to each byte */
+static float sRGB_thresholds[256];
+/* 2^24 / alpha, rounded up, which is exact for dividing anything up to 255 * 255 */
+static UINT unpremultiply_factors[256];
+static INIT_ONCE init_tables_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL WINAPI init_tables(INIT_ONCE *once, void *param, void **context)
+{
+    union { float f; UINT u; } value;
+    UINT low, high, mid, i;
+
+    for (i = 1; i < 256; i++)
+    {
+        /* positive floats are ordered like their bit patterns */
+        low = 0;
+        value.f = 1.0f;
+        high = value.u;
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            value.u = mid;
+            if (to_sRGB_byte_slow(value.f) >= i) high = mid;
+            else low = mid + 1;
+        }
+        value.u = low;
+        sRGB_thresholds[i] = value.f;
+    }
+
+    for (i = 1; i < 256; i++)
+        unpremultiply_factors[i] = ((1 << 24) + i - 1) / i;
+    return TRUE;
+}
+
+/* same result as to_sRGB_byte_slow(), without a powf() call for each component */
+static inline BYTE to_sRGB_byte(float f)
+{
+    UINT low = 0, high = 255, mid;
+
+    if (!(f >= 0.0f && f <= 1.0f)) return to_sRGB_byte_slow(f);
+
+    while (low < high)
+    {
+        mid = (low + high + 1) / 2;
+        if (sRGB_thresholds[mid] <= f) low = mid;
+        else high = mid - 1;
+    }
+    return low;
+}
+
+static inline BYTE unpremultiply(BYTE value, BYTE alpha)
+{
+    return ((ULONGLONG)value * 255 * unpremultiply_factors[alpha]) >> 24;
+}
+
 #if 0 /* FIXME: enable once needed */
 static inline float from_sRGB_component(float f)
 {
@@ -748,9 +807,9 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
                     BYTE alpha = pbBuffer[cbStride*y+4*x+3];
                     if (alpha != 0 && alpha != 255)
                     {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
+                        pbBuffer[cbStride*y+4*x] = unpremultiply(pbBuffer[cbStride*y+4*x], alpha);
+                        pbBuffer[cbStride*y+4*x+1] = unpremultiply(pbBuffer[cbStride*y+4*x+1], alpha);
+                        pbBuffer[cbStride*y+4*x+2] = unpremultiply(pbBuffer[cbStride*y+4*x+2], alpha);
                     }
                 }
         }
@@ -912,9 +971,9 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
                     BYTE alpha = pbBuffer[cbStride*y+4*x+3];
                     if (alpha != 0 && alpha != 255)
                     {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
+                        pbBuffer[cbStride*y+4*x] = unpremultiply(pbBuffer[cbStride*y+4*x], alpha);
+                        pbBuffer[cbStride*y+4*x+1] = unpremultiply(pbBuffer[cbStride*y+4*x+1], alpha);
+                        pbBuffer[cbStride*y+4*x+2] = unpremultiply(pbBuffer[cbStride*y+4*x+2], alpha);
                     }
                 }
         }
@@ -1137,7 +1196,7 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
 
                     for (x = 0; x < prc->Width; x++)
                     {
-                        BYTE gray = (BYTE)floorf(to_sRGB_component(gray_float[x]) * 255.0f + 0.51f);
+                        BYTE gray = to_sRGB_byte(gray_float[x]);
                         *bgr++ = gray;
                         *bgr++ = gray;
                         *bgr++ = gray;
@@ -1356,7 +1415,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
                     BYTE *dstpixel = dst;
 
                     for (x=0; x < prc->Width; x++)
-                        *dstpixel++ = (BYTE)floorf(to_sRGB_component(*srcpixel++) * 255.0f + 0.51f);
+                        *dstpixel++ = to_sRGB_byte(*srcpixel++);
 
                     src += srcstride;
                     dst += cbStride;
@@ -1392,8 +1451,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
             {
                 float gray = (bgr[2] * 0.2126f + bgr[1] * 0.7152f + bgr[0] * 0.0722f) / 255.0f;
 
-                gray = to_sRGB_component(gray) * 255.0f;
-                dst[x] = (BYTE)floorf(gray + 0.51f);
+                dst[x] = to_sRGB_byte(gray);
                 bgr += 3;
             }
             src += srcstride;
@@ -1899,6 +1957,8 @@ HRESULT FormatConverter_CreateInstance(REFIID iid, void** ppv)
 
     *ppv = NULL;
 
+    InitOnceExecuteOnce(&init_tables_once, init_tables, NULL, NULL);
+
     This = malloc(sizeof(FormatConverter));
     if (!This) return E_OUTOFMEMORY;
 
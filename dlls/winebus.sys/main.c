@@ -53,6 +53,9 @@ static DEVICE_OBJECT *bus_fdo;
 
 static HANDLE driver_key;
 
+/* oldest reports are dropped past that, like hidclass.sys does with its ring buffer */
+#define MAX_QUEUED_REPORTS 64
+
 struct hid_report
 {
     struct list entry;
@@ -85,8 +88,14 @@ struct device_extension
 
     struct hid_report *last_reports[256];
     struct list reports;
+    UINT report_count;
     IRP *pending_read;
 
+    /* statistics */
+    UINT reports_delivered;
+    UINT reports_dropped;
+    UINT reports_max_queued;
+
     UINT64 unix_device;
 };
 
@@ -414,33 +423,40 @@ static DWORD check_bus_option(const WCHAR *option, DWORD default_value)
     return default_value;
 }
 
-static BOOL deliver_next_report(struct device_extension *ext, IRP *irp)
+static void complete_read_irp(struct device_extension *ext, IRP *irp, const BYTE *report_buf, ULONG report_len)
 {
-    struct hid_report *report;
-    struct list *entry;
     ULONG i;
 
-    if (!(entry = list_head(&ext->reports))) return FALSE;
-    report = LIST_ENTRY(entry, struct hid_report, entry);
-    list_remove(&report->entry);
-
-    memcpy(irp->UserBuffer, report->buffer, report->length);
-    irp->IoStatus.Information = report->length;
+    memcpy(irp->UserBuffer, report_buf, report_len);
+    irp->IoStatus.Information = report_len;
     irp->IoStatus.Status = STATUS_SUCCESS;
+    ext->reports_delivered++;
 
     if (TRACE_ON(hid))
     {
-        TRACE("device %p/%#I64x input report length %lu:\n", ext->device, ext->unix_device, report->length);
-        for (i = 0; i < report->length;)
+        TRACE("device %p/%#I64x input report length %lu:\n", ext->device, ext->unix_device, report_len);
+        for (i = 0; i < report_len;)
         {
             char buffer[256], *buf = buffer;
             buf += sprintf(buf, "%08lx ", i);
-            do { buf += sprintf(buf, " %02x", report->buffer[i]); }
-            while (++i % 16 && i < report->length);
+            do { buf += sprintf(buf, " %02x", report_buf[i]); }
+            while (++i % 16 && i < report_len);
             TRACE("%s\n", buffer);
         }
     }
+}
+
+static BOOL deliver_next_report(struct device_extension *ext, IRP *irp)
+{
+    struct hid_report *report;
+    struct list *entry;
 
+    if (!(entry = list_head(&ext->reports))) return FALSE;
+    report = LIST_ENTRY(entry, struct hid_report, entry);
+    list_remove(&report->entry);
+    ext->report_count--;
+
+    complete_read_irp(ext, irp, report->buffer, report->length);
     RtlFreeHeap(GetProcessHeap(), 0, report);
     return TRUE;
 }
@@ -450,25 +466,46 @@ static void process_hid_report(DEVICE_OBJECT *device, BYTE *report_buf, DWORD re
     struct device_extension *ext = (struct device_extension *)device->DeviceExtension;
     ULONG size = offsetof(struct hid_report, buffer[report_len]);
     struct hid_report *report, *last_report;
+    struct list *entry;
     IRP *irp;
 
-    if (!(report = RtlAllocateHeap(GetProcessHeap(), 0, size))) return;
-    memcpy(report->buffer, report_buf, report_len);
-    report->length = report_len;
-
     RtlEnterCriticalSection(&ext->cs);
-    list_add_tail(&ext->reports, &report->entry);
 
     if (!ext->collection_desc.ReportIDs[0].ReportID) last_report = ext->last_reports[0];
     else last_report = ext->last_reports[report_buf[0]];
     memcpy(last_report->buffer, report_buf, report_len);
 
-    if ((irp = pop_pending_read(ext)))
+    /* hand the report directly to a waiting reader, it only gets queued if there's none */
+    if (list_empty(&ext->reports) && (irp = pop_pending_read(ext)))
     {
-        deliver_next_report(ext, irp);
+        complete_read_irp(ext, irp, report_buf, report_len);
+        RtlLeaveCriticalSection(&ext->cs);
         IoCompleteRequest(irp, IO_NO_INCREMENT);
+        return;
     }
+
+    if (ext->report_count >= MAX_QUEUED_REPORTS && (entry = list_head(&ext->reports)))
+    {
+        if (!ext->reports_dropped++) WARN("device %p input reports are not read fast enough, dropping\n", device);
+        report = LIST_ENTRY(entry, struct hid_report, entry);
+        list_remove(&report->entry);
+        ext->report_count--;
+        RtlFreeHeap(GetProcessHeap(), 0, report);
+    }
+
+    if ((report = RtlAllocateHeap(GetProcessHeap(), 0, size)))
+    {
+        memcpy(report->buffer, report_buf, report_len);
+        report->length = report_len;
+        list_add_tail(&ext->reports, &report->entry);
+        if (++ext->report_count > ext->reports_max_queued) ext->reports_max_queued = ext->report_count;
+    }
+
+    if ((irp = pop_pending_read(ext)) && !deliver_next_report(ext, irp)) ext->pending_read = irp;
+    else irp = NULL;
     RtlLeaveCriticalSection(&ext->cs);
+
+    if (irp) IoCompleteRequest(irp, IO_NO_INCREMENT);
 }
 
 static NTSTATUS handle_IRP_MN_QUERY_DEVICE_RELATIONS(IRP *irp)
@@ -927,6 +964,8 @@ static NTSTATUS pdo_pnp_dispatch(DEVICE_OBJECT *device, IRP *irp)
             irp->IoStatus.Status = STATUS_SUCCESS;
             IoCompleteRequest(irp, IO_NO_INCREMENT);
 
+            TRACE("device %p delivered %u input reports, dropped %u, at most %u queued\n", device,
+                  ext->reports_delivered, ext->reports_dropped, ext->reports_max_queued);
             LIST_FOR_EACH_ENTRY_SAFE(report, next, &ext->reports, struct hid_report, entry)
                 RtlFreeHeap(GetProcessHeap(), 0, report);
 
@@ -20,6 +20,24 @@
 #include "wined3d_vk.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+
+#define WINED3D_PIPELINE_CACHE_MAGIC    0x43505657u /* "WVPC" */
+#define WINED3D_PIPELINE_CACHE_VERSION  1
+
+/* Header of the pipeline cache files. The driver validates its own data as
+ * well, but we don't want to hand it data for a different driver or GPU. */
+struct wined3d_pipeline_cache_header_vk
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint32_t data_size;
+    uint32_t checksum;
+};
 
 static const struct wined3d_state_entry_template misc_state_template_vk[] =
 {
@@ -370,6 +388,201 @@ static void get_physical_device_info(const struct wined3d_adapter_vk *adapter_vk
         VK_CALL(vkGetPhysicalDeviceFeatures(physical_device, &features2->features));
 }
 
+static uint32_t wined3d_pipeline_cache_checksum(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 0x811c9dc5u;
+    size_t i;
+
+    for (i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 0x01000193u;
+    return hash;
+}
+
+static bool wined3d_pipeline_cache_get_path(const VkPhysicalDeviceProperties *properties,
+        char *path, unsigned int size)
+{
+    char name[16];
+
+    sprintf(name, "%04x-%04x.vkcache", properties->vendorID, properties->deviceID);
+    return wined3d_get_cache_path(name, path, size);
+}
+
+static void *wined3d_pipeline_cache_load(const VkPhysicalDeviceProperties *properties, const char *path, size_t *size)
+{
+    struct wined3d_pipeline_cache_header_vk header;
+    void *data = NULL;
+    LARGE_INTEGER file_size;
+    DWORD read;
+    HANDLE file;
+
+    if ((file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < sizeof(header)
+            || !ReadFile(file, &header, sizeof(header), &read, NULL) || read != sizeof(header))
+        goto done;
+
+    if (header.magic != WINED3D_PIPELINE_CACHE_MAGIC || header.version != WINED3D_PIPELINE_CACHE_VERSION
+            || header.vendor_id != properties->vendorID || header.device_id != properties->deviceID
+            || header.driver_version != properties->driverVersion
+            || memcmp(header.uuid, properties->pipelineCacheUUID, VK_UUID_SIZE)
+            || header.data_size != file_size.QuadPart - sizeof(header))
+    {
+        TRACE("Ignoring stale pipeline cache %s.\n", debugstr_a(path));
+        goto done;
+    }
+
+    if (!(data = heap_alloc(header.data_size)))
+        goto done;
+    if (!ReadFile(file, data, header.data_size, &read, NULL) || read != header.data_size
+            || wined3d_pipeline_cache_checksum(data, header.data_size) != header.checksum)
+    {
+        WARN("Failed to read pipeline cache %s.\n", debugstr_a(path));
+        heap_free(data);
+        data = NULL;
+        goto done;
+    }
+    *size = header.data_size;
+
+done:
+    CloseHandle(file);
+    return data;
+}
+
+static void wined3d_device_vk_create_pipeline_cache(struct wined3d_device_vk *device_vk,
+        const struct wined3d_adapter_vk *adapter_vk)
+{
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
+    VkPipelineCacheCreateInfo cache_info;
+    VkPhysicalDeviceProperties properties;
+    char path[MAX_PATH];
+    void *data = NULL;
+    size_t size = 0;
+    VkResult vr;
+
+    if (!wined3d_settings.vk_pipeline_cache)
+        return;
+
+    VK_CALL(vkGetPhysicalDeviceProperties(adapter_vk->physical_device, &properties));
+    if (wined3d_pipeline_cache_get_path(&properties, path, ARRAY_SIZE(path)))
+        data = wined3d_pipeline_cache_load(&properties, path, &size);
+
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.pNext = NULL;
+    cache_info.flags = 0;
+    cache_info.initialDataSize = size;
+    cache_info.pInitialData = data;
+    if ((vr = VK_CALL(vkCreatePipelineCache(device_vk->vk_device, &cache_info, NULL,
+            &device_vk->vk_pipeline_cache))) < 0 && data)
+    {
+        WARN("Failed to create pipeline cache from %s, vr %s.\n", debugstr_a(path), wined3d_debug_vkresult(vr));
+        cache_info.initialDataSize = size = 0;
+        cache_info.pInitialData = NULL;
+        vr = VK_CALL(vkCreatePipelineCache(device_vk->vk_device, &cache_info, NULL, &device_vk->vk_pipeline_cache));
+    }
+    heap_free(data);
+
+    if (vr < 0)
+    {
+        WARN("Failed to create pipeline cache, vr %s.\n", wined3d_debug_vkresult(vr));
+        device_vk->vk_pipeline_cache = VK_NULL_HANDLE;
+        return;
+    }
+    device_vk->pipeline_cache_size = size;
+    TRACE_(d3d_perf)("Loaded %Iu bytes of pipeline cache data.\n", size);
+}
+
+static void wined3d_device_vk_destroy_pipeline_cache(struct wined3d_device_vk *device_vk,
+        const struct wined3d_adapter_vk *adapter_vk)
+{
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
+    struct wined3d_pipeline_cache_header_vk header;
+    VkPhysicalDeviceProperties properties;
+    size_t size, max_size;
+    char path[MAX_PATH];
+    void *data = NULL;
+    DWORD written;
+    HANDLE file;
+    VkResult vr;
+
+    if (!device_vk->vk_pipeline_cache)
+        return;
+
+    TRACE_(d3d_perf)("Pipeline cache hits %u, misses %u.\n",
+            device_vk->pipeline_cache_hits, device_vk->pipeline_cache_misses);
+
+    /* Nothing new was compiled, so there's no point in rewriting the file. */
+    if (vk_info->supported[WINED3D_VK_EXT_PIPELINE_CREATION_FEEDBACK] && !device_vk->pipeline_cache_misses)
+        goto done;
+
+    max_size = (size_t)wined3d_settings.vk_pipeline_cache_size * 1024 * 1024;
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device_vk->vk_device, device_vk->vk_pipeline_cache, &size, NULL))) < 0
+            || !size || size == device_vk->pipeline_cache_size)
+        goto done;
+    /* A truncated cache is still valid; vkGetPipelineCacheData() returns
+     * VK_INCOMPLETE and as many complete entries as fit. */
+    size = min(size, max_size);
+    if (size <= sizeof(VkPipelineCacheHeaderVersionOne) || !(data = heap_alloc(size)))
+        goto done;
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device_vk->vk_device, device_vk->vk_pipeline_cache, &size, data))) < 0)
+    {
+        WARN("Failed to get pipeline cache data, vr %s.\n", wined3d_debug_vkresult(vr));
+        goto done;
+    }
+
+    VK_CALL(vkGetPhysicalDeviceProperties(adapter_vk->physical_device, &properties));
+    if (!wined3d_pipeline_cache_get_path(&properties, path, ARRAY_SIZE(path)))
+        goto done;
+
+    header.magic = WINED3D_PIPELINE_CACHE_MAGIC;
+    header.version = WINED3D_PIPELINE_CACHE_VERSION;
+    header.vendor_id = properties.vendorID;
+    header.device_id = properties.deviceID;
+    header.driver_version = properties.driverVersion;
+    memcpy(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.data_size = size;
+    header.checksum = wined3d_pipeline_cache_checksum(data, size);
+
+    if ((file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create pipeline cache file %s, error %lu.\n", debugstr_a(path), GetLastError());
+        goto done;
+    }
+    if (!WriteFile(file, &header, sizeof(header), &written, NULL) || written != sizeof(header)
+            || !WriteFile(file, data, size, &written, NULL) || written != size)
+    {
+        WARN("Failed to write pipeline cache file %s, error %lu.\n", debugstr_a(path), GetLastError());
+        CloseHandle(file);
+        DeleteFileA(path);
+        goto done;
+    }
+    CloseHandle(file);
+    TRACE_(d3d_perf)("Saved %Iu bytes of pipeline cache data to %s.\n", size, debugstr_a(path));
+
+done:
+    heap_free(data);
+    VK_CALL(vkDestroyPipelineCache(device_vk->vk_device, device_vk->vk_pipeline_cache, NULL));
+}
+
+void wined3d_device_vk_pipeline_feedback(struct wined3d_device_vk *device_vk,
+        const VkPipelineCreationFeedbackEXT *feedback)
+{
+    if (!(feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+        return;
+
+    if (feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+        ++device_vk->pipeline_cache_hits;
+    else
+        ++device_vk->pipeline_cache_misses;
+
+    if (TRACE_ON(d3d_perf) && !((device_vk->pipeline_cache_hits + device_vk->pipeline_cache_misses) % 256))
+        TRACE_(d3d_perf)("Pipeline cache hits %u, misses %u, last pipeline took %s ns.\n",
+                device_vk->pipeline_cache_hits, device_vk->pipeline_cache_misses,
+                wine_dbgstr_longlong(feedback->duration));
+}
+
 static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wined3d_adapter *adapter,
         enum wined3d_device_type device_type, HWND focus_window, unsigned int flags, BYTE surface_alignment,
         const enum wined3d_feature_level *levels, unsigned int level_count,
@@ -453,10 +666,13 @@ static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wi
         goto fail;
     }
 
+    wined3d_device_vk_create_pipeline_cache(device_vk, adapter_vk);
+
     if (FAILED(hr = wined3d_device_init(&device_vk->d, wined3d, adapter->ordinal, device_type, focus_window,
             flags, surface_alignment, levels, level_count, vk_info->supported, device_parent)))
     {
         WARN("Failed to initialize device, hr %#lx.\n", hr);
+        wined3d_device_vk_destroy_pipeline_cache(device_vk, adapter_vk);
         wined3d_allocator_cleanup(&device_vk->allocator);
         goto fail;
     }
@@ -479,6 +695,7 @@ static void adapter_vk_destroy_device(struct wined3d_device *device)
     const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
 
     wined3d_device_cleanup(&device_vk->d);
+    wined3d_device_vk_destroy_pipeline_cache(device_vk, wined3d_adapter_vk(device->adapter));
     wined3d_allocator_cleanup(&device_vk->allocator);
 
     wined3d_lock_cleanup(&device_vk->allocator_cs);
@@ -2362,6 +2579,8 @@ static bool wined3d_adapter_vk_init_device_extensions(struct wined3d_adapter_vk
         {VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME,      VK_API_VERSION_1_1},
         {VK_KHR_SWAPCHAIN_EXTENSION_NAME,                   ~0u,                true},
         {VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME,            VK_API_VERSION_1_2},
+        {VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,  VK_API_VERSION_1_3},
+        {VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,             ~0u},
     };
 
     static const struct
@@ -2375,6 +2594,8 @@ static bool wined3d_adapter_vk_init_device_extensions(struct wined3d_adapter_vk
         {VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME, WINED3D_VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE},
         {VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME,       WINED3D_VK_KHR_SHADER_DRAW_PARAMETERS},
         {VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME,             WINED3D_VK_EXT_HOST_QUERY_RESET},
+        {VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,   WINED3D_VK_EXT_PIPELINE_CREATION_FEEDBACK},
+        {VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,              WINED3D_VK_KHR_PUSH_DESCRIPTOR},
     };
 
     if ((vr = VK_CALL(vkEnumerateDeviceExtensionProperties(physical_device, NULL, &count, NULL))) < 0)
@@ -2465,6 +2686,7 @@ static BOOL wined3d_adapter_vk_init(struct wined3d_adapter_vk *adapter_vk,
 {
     struct wined3d_vk_info *vk_info = &adapter_vk->vk_info;
     struct wined3d_adapter *adapter = &adapter_vk->a;
+    VkPhysicalDevicePushDescriptorPropertiesKHR push_properties;
     VkPhysicalDeviceIDProperties id_properties;
     VkPhysicalDeviceProperties2 properties2;
     LUID primary_luid, *luid = NULL;
@@ -2489,11 +2711,18 @@ static BOOL wined3d_adapter_vk_init(struct wined3d_adapter_vk *adapter_vk,
     properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
     properties2.pNext = &id_properties;
 
+    memset(&push_properties, 0, sizeof(push_properties));
+    push_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+    if (vk_info->supported[WINED3D_VK_KHR_PUSH_DESCRIPTOR])
+        id_properties.pNext = &push_properties;
+
     if (vk_info->vk_ops.vkGetPhysicalDeviceProperties2)
         VK_CALL(vkGetPhysicalDeviceProperties2(adapter_vk->physical_device, &properties2));
     else
         VK_CALL(vkGetPhysicalDeviceProperties(adapter_vk->physical_device, &properties2.properties));
     adapter_vk->device_limits = properties2.properties.limits;
+    adapter_vk->max_push_descriptors = push_properties.maxPushDescriptors;
+    TRACE("Max push descriptors %u.\n", adapter_vk->max_push_descriptors);
 
     VK_CALL(vkGetPhysicalDeviceMemoryProperties(adapter_vk->physical_device, &adapter_vk->memory_properties));
 
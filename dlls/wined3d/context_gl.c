@@ -2319,6 +2319,12 @@ HRESULT wined3d_context_gl_init(struct wined3d_context_gl *context_gl, struct wi
     }
     if (gl_info->supported[ARB_CLIP_CONTROL])
         GL_EXTCALL(glPointParameteri(GL_POINT_SPRITE_COORD_ORIGIN, GL_LOWER_LEFT));
+    if (gl_info->supported[ARB_PARALLEL_SHADER_COMPILE])
+    {
+        /* Let the driver compile and link in as many threads as it likes. */
+        GL_EXTCALL(glMaxShaderCompilerThreadsARB(~0u));
+        checkGLcall("glMaxShaderCompilerThreadsARB");
+    }
 
     /* If this happens to be the first context for the device, dummy textures
      * are not created yet. In that case, they will be created (and bound) by
@@ -4388,8 +4394,17 @@ static BOOL context_apply_draw_state(struct wined3d_context *context,
 
     if (context->shader_update_mask & ~(1u << WINED3D_SHADER_TYPE_COMPUTE))
     {
+        uint32_t update_mask = context->shader_update_mask;
+
         device->shader_backend->shader_select(device->shader_priv, context, state);
         context->shader_update_mask &= 1u << WINED3D_SHADER_TYPE_COMPUTE;
+        if (context->shaders_pending)
+        {
+            /* The shaders are still being compiled in the background; skip
+             * the draw and select them again next time. */
+            context->shader_update_mask |= update_mask;
+            return FALSE;
+        }
     }
 
     if (context->update_shader_resource_bindings)
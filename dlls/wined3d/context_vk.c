@@ -26,6 +26,7 @@
 #include "wined3d_vk.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
 VkCompareOp vk_compare_op_from_wined3d(enum wined3d_cmp_func op)
 {
@@ -923,6 +924,30 @@ void wined3d_context_vk_destroy_vk_buffer_view(struct wined3d_context_vk *contex
     o->command_buffer_id = command_buffer_id;
 }
 
+static void wined3d_context_vk_evict_framebuffers(struct wined3d_context_vk *context_vk, VkImageView vk_view)
+{
+    struct wined3d_framebuffer_vk *fb;
+    unsigned int i, j;
+
+    for (i = 0; i < ARRAY_SIZE(context_vk->framebuffers); ++i)
+    {
+        fb = &context_vk->framebuffers[i];
+        if (!fb->vk_framebuffer)
+            continue;
+
+        for (j = 0; j < fb->view_count; ++j)
+        {
+            if (fb->vk_views[j] == vk_view)
+                break;
+        }
+        if (j == fb->view_count)
+            continue;
+
+        wined3d_context_vk_destroy_vk_framebuffer(context_vk, fb->vk_framebuffer, fb->command_buffer_id);
+        fb->vk_framebuffer = VK_NULL_HANDLE;
+    }
+}
+
 void wined3d_context_vk_destroy_vk_image_view(struct wined3d_context_vk *context_vk,
         VkImageView vk_view, uint64_t command_buffer_id)
 {
@@ -930,6 +955,10 @@ void wined3d_context_vk_destroy_vk_image_view(struct wined3d_context_vk *context
     const struct wined3d_vk_info *vk_info = context_vk->vk_info;
     struct wined3d_retired_object_vk *o;
 
+    /* Framebuffers can't be used once one of their attachments is gone, and
+     * the handle may be reused by a new view. */
+    wined3d_context_vk_evict_framebuffers(context_vk, vk_view);
+
     if (context_vk->completed_command_buffer_id >= command_buffer_id)
     {
         VK_CALL(vkDestroyImageView(device_vk->vk_device, vk_view, NULL));
@@ -1557,12 +1586,8 @@ void wined3d_context_vk_end_current_render_pass(struct wined3d_context_vk *conte
         }
     }
 
-    if (context_vk->vk_framebuffer)
-    {
-        wined3d_context_vk_destroy_vk_framebuffer(context_vk,
-                context_vk->vk_framebuffer, context_vk->current_command_buffer.id);
-        context_vk->vk_framebuffer = VK_NULL_HANDLE;
-    }
+    /* The framebuffer itself stays in the cache. */
+    context_vk->vk_framebuffer = VK_NULL_HANDLE;
 }
 
 static void wined3d_context_vk_destroy_render_pass(struct wine_rb_entry *entry, void *ctx)
@@ -1715,8 +1740,11 @@ void wined3d_context_vk_cleanup(struct wined3d_context_vk *context_vk)
     for (i = 0; i < context_vk->vk_descriptor_pool_count; ++i)
         VK_CALL(vkDestroyDescriptorPool(device_vk->vk_device, context_vk->vk_descriptor_pools[i], NULL));
     heap_free(context_vk->vk_descriptor_pools);
-    if (context_vk->vk_framebuffer)
-        VK_CALL(vkDestroyFramebuffer(device_vk->vk_device, context_vk->vk_framebuffer, NULL));
+    for (i = 0; i < ARRAY_SIZE(context_vk->framebuffers); ++i)
+    {
+        if (context_vk->framebuffers[i].vk_framebuffer)
+            VK_CALL(vkDestroyFramebuffer(device_vk->vk_device, context_vk->framebuffers[i].vk_framebuffer, NULL));
+    }
     if (context_vk->vk_so_counter_bo.vk_buffer)
         wined3d_context_vk_destroy_bo(context_vk, &context_vk->vk_so_counter_bo);
     wined3d_context_vk_cleanup_resources(context_vk, VK_NULL_HANDLE);
@@ -2608,6 +2636,63 @@ static bool wined3d_context_vk_update_graphics_pipeline_key(struct wined3d_conte
     return update;
 }
 
+static VkFramebuffer wined3d_context_vk_get_framebuffer(struct wined3d_context_vk *context_vk,
+        const VkImageView *vk_views, unsigned int view_count, uint32_t width, uint32_t height, uint32_t layer_count)
+{
+    struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
+    const struct wined3d_vk_info *vk_info = context_vk->vk_info;
+    VkRenderPass vk_render_pass = context_vk->vk_render_pass;
+    struct wined3d_framebuffer_vk *fb;
+    VkFramebufferCreateInfo fb_desc;
+    unsigned int i;
+    VkResult vr;
+
+    for (i = 0; i < ARRAY_SIZE(context_vk->framebuffers); ++i)
+    {
+        fb = &context_vk->framebuffers[i];
+        if (fb->vk_framebuffer && fb->vk_render_pass == vk_render_pass && fb->view_count == view_count
+                && fb->width == width && fb->height == height && fb->layer_count == layer_count
+                && !memcmp(fb->vk_views, vk_views, view_count * sizeof(*vk_views)))
+        {
+            fb->command_buffer_id = context_vk->current_command_buffer.id;
+            return fb->vk_framebuffer;
+        }
+    }
+
+    fb = &context_vk->framebuffers[context_vk->next_framebuffer];
+    context_vk->next_framebuffer = (context_vk->next_framebuffer + 1) % ARRAY_SIZE(context_vk->framebuffers);
+    if (fb->vk_framebuffer)
+        wined3d_context_vk_destroy_vk_framebuffer(context_vk, fb->vk_framebuffer, fb->command_buffer_id);
+
+    fb_desc.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    fb_desc.pNext = NULL;
+    fb_desc.flags = 0;
+    fb_desc.renderPass = vk_render_pass;
+    fb_desc.attachmentCount = view_count;
+    fb_desc.pAttachments = vk_views;
+    fb_desc.width = width;
+    fb_desc.height = height;
+    fb_desc.layers = layer_count;
+
+    if ((vr = VK_CALL(vkCreateFramebuffer(device_vk->vk_device, &fb_desc, NULL, &fb->vk_framebuffer))) < 0)
+    {
+        WARN("Failed to create Vulkan framebuffer, vr %s.\n", wined3d_debug_vkresult(vr));
+        fb->vk_framebuffer = VK_NULL_HANDLE;
+        return VK_NULL_HANDLE;
+    }
+    TRACE_(d3d_perf)("Created framebuffer 0x%s.\n", wine_dbgstr_longlong(fb->vk_framebuffer));
+
+    fb->vk_render_pass = vk_render_pass;
+    memcpy(fb->vk_views, vk_views, view_count * sizeof(*vk_views));
+    fb->view_count = view_count;
+    fb->width = width;
+    fb->height = height;
+    fb->layer_count = layer_count;
+    fb->command_buffer_id = context_vk->current_command_buffer.id;
+
+    return fb->vk_framebuffer;
+}
+
 static bool wined3d_context_vk_begin_render_pass(struct wined3d_context_vk *context_vk,
         VkCommandBuffer vk_command_buffer, const struct wined3d_state *state, const struct wined3d_vk_info *vk_info)
 {
@@ -2622,8 +2707,6 @@ static bool wined3d_context_vk_begin_render_pass(struct wined3d_context_vk *cont
     VkRenderPassBeginInfo begin_info;
     unsigned int attachment_count, i;
     struct wined3d_texture *texture;
-    VkFramebufferCreateInfo fb_desc;
-    VkResult vr;
 
     if (context_vk->vk_render_pass)
         return true;
@@ -2731,19 +2814,10 @@ static bool wined3d_context_vk_begin_render_pass(struct wined3d_context_vk *cont
         return false;
     }
 
-    fb_desc.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    fb_desc.pNext = NULL;
-    fb_desc.flags = 0;
-    fb_desc.renderPass = context_vk->vk_render_pass;
-    fb_desc.attachmentCount = attachment_count;
-    fb_desc.pAttachments = vk_views;
-    fb_desc.width = fb_width;
-    fb_desc.height = fb_height;
-    fb_desc.layers = fb_layer_count;
-
-    if ((vr = VK_CALL(vkCreateFramebuffer(device_vk->vk_device, &fb_desc, NULL, &context_vk->vk_framebuffer))) < 0)
+    if (!(context_vk->vk_framebuffer = wined3d_context_vk_get_framebuffer(context_vk,
+            vk_views, attachment_count, fb_width, fb_height, fb_layer_count)))
     {
-        WARN("Failed to create Vulkan framebuffer, vr %s.\n", wined3d_debug_vkresult(vr));
+        context_vk->vk_render_pass = VK_NULL_HANDLE;
         return false;
     }
 
@@ -3211,6 +3285,7 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
     VkPipelineLayout vk_pipeline_layout;
     VkPipelineBindPoint vk_bind_point;
     VkDescriptorSet vk_descriptor_set;
+    bool push_descriptors;
     size_t i;
 
     switch (pipeline)
@@ -3220,6 +3295,7 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
             vk_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
             vk_set_layout = context_vk->graphics.vk_set_layout;
             vk_pipeline_layout = context_vk->graphics.vk_pipeline_layout;
+            push_descriptors = context_vk->graphics.push_descriptors;
             break;
 
         case WINED3D_PIPELINE_COMPUTE:
@@ -3227,6 +3303,7 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
             vk_bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
             vk_set_layout = context_vk->compute.vk_set_layout;
             vk_pipeline_layout = context_vk->compute.vk_pipeline_layout;
+            push_descriptors = context_vk->compute.push_descriptors;
             break;
 
         default:
@@ -3234,7 +3311,11 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
             return false;
     }
 
-    if (!(vk_descriptor_set = wined3d_context_vk_create_vk_descriptor_set(context_vk, vk_set_layout)))
+    if (push_descriptors)
+    {
+        vk_descriptor_set = VK_NULL_HANDLE;
+    }
+    else if (!(vk_descriptor_set = wined3d_context_vk_create_vk_descriptor_set(context_vk, vk_set_layout)))
     {
         WARN("Failed to create descriptor set.\n");
         return false;
@@ -3283,6 +3364,13 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
         }
     }
 
+    if (push_descriptors)
+    {
+        VK_CALL(vkCmdPushDescriptorSetKHR(vk_command_buffer, vk_bind_point,
+                vk_pipeline_layout, 0, writes->count, writes->writes));
+        return true;
+    }
+
     VK_CALL(vkUpdateDescriptorSets(device_vk->vk_device, writes->count, writes->writes, 0, NULL));
     VK_CALL(vkCmdBindDescriptorSets(vk_command_buffer, vk_bind_point,
             vk_pipeline_layout, 0, 1, &vk_descriptor_set, 0, NULL));
@@ -3292,14 +3380,14 @@ static bool wined3d_context_vk_update_descriptors(struct wined3d_context_vk *con
 
 static VkResult wined3d_context_vk_create_vk_descriptor_set_layout(struct wined3d_device_vk *device_vk,
         const struct wined3d_vk_info *vk_info, const struct wined3d_pipeline_layout_key_vk *key,
-        VkDescriptorSetLayout *vk_set_layout)
+        bool push_descriptors, VkDescriptorSetLayout *vk_set_layout)
 {
     VkDescriptorSetLayoutCreateInfo layout_desc;
     VkResult vr;
 
     layout_desc.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layout_desc.pNext = NULL;
-    layout_desc.flags = 0;
+    layout_desc.flags = push_descriptors ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0;
     layout_desc.bindingCount = key->binding_count;
     layout_desc.pBindings = key->bindings;
 
@@ -3312,6 +3400,7 @@ static VkResult wined3d_context_vk_create_vk_descriptor_set_layout(struct wined3
 struct wined3d_pipeline_layout_vk *wined3d_context_vk_get_pipeline_layout(
         struct wined3d_context_vk *context_vk, VkDescriptorSetLayoutBinding *bindings, SIZE_T binding_count)
 {
+    struct wined3d_adapter_vk *adapter_vk = wined3d_adapter_vk(context_vk->c.device->adapter);
     struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     const struct wined3d_vk_info *vk_info = context_vk->vk_info;
     struct wined3d_pipeline_layout_key_vk key;
@@ -3336,7 +3425,13 @@ struct wined3d_pipeline_layout_vk *wined3d_context_vk_get_pipeline_layout(
     memcpy(layout->key.bindings, key.bindings, sizeof(*layout->key.bindings) * key.binding_count);
     layout->key.binding_count = key.binding_count;
 
-    if ((vr = wined3d_context_vk_create_vk_descriptor_set_layout(device_vk, vk_info, &key, &layout->vk_set_layout)))
+    /* Push descriptors avoid allocating and updating a descriptor set for
+     * every draw, as long as the layout fits in the driver's limit. */
+    layout->push_descriptors = vk_info->supported[WINED3D_VK_KHR_PUSH_DESCRIPTOR]
+            && key.binding_count <= adapter_vk->max_push_descriptors;
+
+    if ((vr = wined3d_context_vk_create_vk_descriptor_set_layout(device_vk, vk_info,
+            &key, layout->push_descriptors, &layout->vk_set_layout)))
     {
         WARN("Failed to create descriptor set layout, vr %s.\n", wined3d_debug_vkresult(vr));
         goto fail;
@@ -3379,7 +3474,10 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
     struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     const struct wined3d_vk_info *vk_info = context_vk->vk_info;
     struct wined3d_graphics_pipeline_vk *pipeline_vk;
+    VkPipelineCreationFeedbackCreateInfoEXT feedback_info;
     struct wined3d_graphics_pipeline_key_vk *key;
+    VkPipelineCreationFeedbackEXT feedback;
+    VkGraphicsPipelineCreateInfo pipeline_desc;
     struct wine_rb_entry *entry;
     VkResult vr;
 
@@ -3391,8 +3489,20 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
         return VK_NULL_HANDLE;
     pipeline_vk->key = *key;
 
+    pipeline_desc = key->pipeline_desc;
+    if (vk_info->supported[WINED3D_VK_EXT_PIPELINE_CREATION_FEEDBACK])
+    {
+        feedback_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        feedback_info.pNext = pipeline_desc.pNext;
+        feedback_info.pPipelineCreationFeedback = &feedback;
+        feedback_info.pipelineStageCreationFeedbackCount = 0;
+        feedback_info.pPipelineStageCreationFeedbacks = NULL;
+        feedback.flags = 0;
+        pipeline_desc.pNext = &feedback_info;
+    }
+
     if ((vr = VK_CALL(vkCreateGraphicsPipelines(device_vk->vk_device,
-            VK_NULL_HANDLE, 1, &key->pipeline_desc, NULL, &pipeline_vk->vk_pipeline))) < 0)
+            device_vk->vk_pipeline_cache, 1, &pipeline_desc, NULL, &pipeline_vk->vk_pipeline))) < 0)
     {
         WARN("Failed to create graphics pipeline, vr %s.\n", wined3d_debug_vkresult(vr));
         heap_free(pipeline_vk);
@@ -3402,6 +3512,9 @@ static VkPipeline wined3d_context_vk_get_graphics_pipeline(struct wined3d_contex
     if (wine_rb_put(&context_vk->graphics_pipelines, &pipeline_vk->key, &pipeline_vk->entry) == -1)
         ERR("Failed to insert pipeline.\n");
 
+    if (vk_info->supported[WINED3D_VK_EXT_PIPELINE_CREATION_FEEDBACK])
+        wined3d_device_vk_pipeline_feedback(device_vk, &feedback);
+
     return pipeline_vk->vk_pipeline;
 }
 
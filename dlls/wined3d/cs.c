@@ -164,6 +164,8 @@ struct wined3d_cs_present
     RECT dst_rect;
     unsigned int swap_interval;
     uint32_t flags;
+    LONG64 present_time;
+    UINT64 gpu_frame_time;
 };
 
 struct wined3d_cs_clear
@@ -629,6 +631,202 @@ static const char *debug_cs_op(enum wined3d_cs_op op)
     return wine_dbg_sprintf("UNKNOWN_OP(%#x)", op);
 }
 
+/* Command stream statistics, collected with +d3d_perf or when a frame
+ * statistics log is configured. The "finish", queue and map fields are
+ * updated by the application thread, the rest by the CS thread, which also
+ * reports them. */
+struct wined3d_cs_stats
+{
+    LONG queue_full_waits;
+    LONG finishes;
+    LONG64 finish_time;
+    LONG upload_bos;
+    LONG64 upload_bytes;
+    LONG maps;
+
+    LONG reported_queue_full_waits;
+    LONG reported_finishes;
+    LONG64 reported_finish_time;
+    LONG reported_upload_bos;
+    LONG64 reported_upload_bytes;
+    LONG reported_maps;
+
+    LARGE_INTEGER freq;
+    LONG64 idle_start;
+    LONG64 idle_time;
+    DWORD report_time;
+    unsigned int frames;
+    unsigned int packets[WINED3D_CS_OP_STOP];
+    /* Frame timings in ms, summed up since the last report. */
+    double app_time, busy_time, gpu_time, present_latency;
+
+    LONG64 frame_start;
+    LONG64 frame_idle_time;
+    LONG64 last_present_time;
+    LONG frame_maps;
+    unsigned int frame_draws, frame_dispatches, frame_packets;
+    unsigned int frame_id;
+    HANDLE log;
+};
+
+static LONG64 wined3d_cs_stats_time(void)
+{
+    LARGE_INTEGER time;
+
+    QueryPerformanceCounter(&time);
+    return time.QuadPart;
+}
+
+static void wined3d_cs_count_upload_bo(struct wined3d_cs *cs,
+        struct wined3d_resource *resource, unsigned int sub_resource_idx)
+{
+    size_t size;
+
+    if (!cs->stats)
+        return;
+
+    if (resource->type == WINED3D_RTYPE_BUFFER)
+        size = resource->size;
+    else
+        size = texture_from_resource(resource)->sub_resources[sub_resource_idx].size;
+
+    InterlockedIncrement(&cs->stats->upload_bos);
+    InterlockedAdd64(&cs->stats->upload_bytes, size);
+}
+
+static struct wined3d_cs_stats *wined3d_cs_stats_create(void)
+{
+    static const char header[] = "frame,app_ms,cs_busy_ms,gpu_ms,present_latency_ms,draws,dispatches,maps,packets\n";
+    struct wined3d_cs_stats *stats;
+    DWORD written;
+
+    if (!(stats = heap_alloc_zero(sizeof(*stats))))
+        return NULL;
+
+    QueryPerformanceFrequency(&stats->freq);
+    stats->report_time = GetTickCount();
+    stats->log = INVALID_HANDLE_VALUE;
+    if (wined3d_settings.frame_stats_log)
+    {
+        if ((stats->log = CreateFileA(wined3d_settings.frame_stats_log, GENERIC_WRITE,
+                FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+            ERR("Failed to open frame statistics log %s, error %lu.\n",
+                    debugstr_a(wined3d_settings.frame_stats_log), GetLastError());
+        else
+            WriteFile(stats->log, header, sizeof(header) - 1, &written, NULL);
+    }
+
+    return stats;
+}
+
+static void wined3d_cs_stats_destroy(struct wined3d_cs_stats *stats)
+{
+    if (!stats)
+        return;
+
+    if (stats->log != INVALID_HANDLE_VALUE)
+        CloseHandle(stats->log);
+    heap_free(stats);
+}
+
+static void wined3d_cs_report_stats(struct wined3d_cs_stats *stats)
+{
+    LONG queue_full_waits, finishes, upload_bos, maps;
+    LONG64 finish_time, upload_bytes;
+    unsigned int i, frames, packets;
+    double ms;
+    DWORD time;
+
+    time = GetTickCount();
+    /* Every 1.5 seconds, like the fps channel. */
+    if (time - stats->report_time <= 1500)
+        return;
+
+    queue_full_waits = ReadNoFence(&stats->queue_full_waits);
+    finishes = ReadNoFence(&stats->finishes);
+    finish_time = InterlockedCompareExchange64(&stats->finish_time, 0, 0);
+    upload_bos = ReadNoFence(&stats->upload_bos);
+    upload_bytes = InterlockedCompareExchange64(&stats->upload_bytes, 0, 0);
+    maps = ReadNoFence(&stats->maps);
+    for (i = 0, packets = 0; i < ARRAY_SIZE(stats->packets); ++i)
+        packets += stats->packets[i];
+
+    frames = stats->frames;
+    ms = 1000.0 / stats->freq.QuadPart / frames;
+    TRACE_(d3d_perf)("Per frame over %u frames: app %.3f ms, CS thread busy %.3f ms, GPU %.3f ms, "
+            "present latency %.3f ms, %.1f maps.\n", frames, stats->app_time / frames,
+            stats->busy_time / frames, stats->gpu_time / frames, stats->present_latency / frames,
+            (double)(maps - stats->reported_maps) / frames);
+    TRACE_(d3d_perf)("Per frame: %.1f packets, %.2f queue full waits, "
+            "%.2f finishes taking %.3f ms, CS thread idle %.3f ms.\n", (double)packets / frames,
+            (double)(queue_full_waits - stats->reported_queue_full_waits) / frames,
+            (double)(finishes - stats->reported_finishes) / frames,
+            (finish_time - stats->reported_finish_time) * ms, stats->idle_time * ms);
+    TRACE_(d3d_perf)("Per frame: %.1f upload BOs, %.1f KiB.\n",
+            (double)(upload_bos - stats->reported_upload_bos) / frames,
+            (upload_bytes - stats->reported_upload_bytes) / 1024.0 / frames);
+    for (i = 0; i < ARRAY_SIZE(stats->packets); ++i)
+    {
+        if (stats->packets[i])
+            TRACE_(d3d_perf)("    %s: %.1f.\n", debug_cs_op(i), (double)stats->packets[i] / frames);
+    }
+
+    stats->reported_queue_full_waits = queue_full_waits;
+    stats->reported_finishes = finishes;
+    stats->reported_finish_time = finish_time;
+    stats->reported_upload_bos = upload_bos;
+    stats->reported_upload_bytes = upload_bytes;
+    stats->reported_maps = maps;
+    stats->idle_time = 0;
+    stats->app_time = stats->busy_time = stats->gpu_time = stats->present_latency = 0.0;
+    stats->report_time = time;
+    stats->frames = 0;
+    memset(stats->packets, 0, sizeof(stats->packets));
+}
+
+/* Called by the CS thread after presenting a frame. "present_time" is the
+ * time at which the application called Present(). */
+static void wined3d_cs_end_stats_frame(struct wined3d_cs_stats *stats, LONG64 present_time, UINT64 gpu_frame_time)
+{
+    double ms = 1000.0 / stats->freq.QuadPart;
+    double app_time, busy_time, gpu_time, latency;
+    LONG64 time = wined3d_cs_stats_time();
+    LONG maps = ReadNoFence(&stats->maps);
+    char buffer[160];
+    DWORD written;
+    int len;
+
+    app_time = stats->last_present_time ? (present_time - stats->last_present_time) * ms : 0.0;
+    busy_time = stats->frame_start ? (time - stats->frame_start - stats->frame_idle_time) * ms : 0.0;
+    gpu_time = gpu_frame_time / 1000000.0;
+    latency = (time - present_time) * ms;
+
+    if (stats->log != INVALID_HANDLE_VALUE)
+    {
+        len = snprintf(buffer, sizeof(buffer), "%u,%.3f,%.3f,%.3f,%.3f,%u,%u,%ld,%u\n", stats->frame_id,
+                app_time, busy_time, gpu_time, latency, stats->frame_draws, stats->frame_dispatches,
+                maps - stats->frame_maps, stats->frame_packets);
+        WriteFile(stats->log, buffer, len, &written, NULL);
+    }
+
+    stats->app_time += app_time;
+    stats->busy_time += busy_time;
+    stats->gpu_time += gpu_time;
+    stats->present_latency += latency;
+    stats->idle_time += stats->frame_idle_time;
+    ++stats->frames;
+
+    stats->frame_start = time;
+    stats->frame_idle_time = 0;
+    stats->last_present_time = present_time;
+    stats->frame_maps = maps;
+    stats->frame_draws = stats->frame_dispatches = stats->frame_packets = 0;
+    ++stats->frame_id;
+
+    if (TRACE_ON(d3d_perf))
+        wined3d_cs_report_stats(stats);
+}
+
 static struct wined3d_cs_packet *wined3d_next_cs_packet(const uint8_t *data, SIZE_T *offset, SIZE_T mask)
 {
     struct wined3d_cs_packet *packet = (struct wined3d_cs_packet *)&data[*offset & mask];
@@ -736,6 +934,9 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
         }
     }
 
+    if (cs->stats)
+        wined3d_cs_end_stats_frame(cs->stats, op->present_time, op->gpu_frame_time);
+
     InterlockedDecrement(&cs->pending_presents);
     if (InterlockedCompareExchange(&cs->waiting_for_present, FALSE, TRUE))
         SetEvent(cs->present_event);
@@ -751,6 +952,9 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
 
     wined3d_not_from_cs(cs);
 
+    if (cs->stats)
+        wined3d_swapchain_update_gpu_time(swapchain);
+
     op = wined3d_device_context_require_space(&cs->c, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
     op->opcode = WINED3D_CS_OP_PRESENT;
     op->dst_window_override = dst_window_override;
@@ -759,6 +963,11 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
     op->dst_rect = *dst_rect;
     op->swap_interval = swap_interval;
     op->flags = flags;
+    if (cs->stats)
+    {
+        op->present_time = wined3d_cs_stats_time();
+        op->gpu_frame_time = swapchain->gpu_frame_time;
+    }
 
     pending = InterlockedIncrement(&cs->pending_presents);
 
@@ -2478,6 +2687,9 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
      * increasing the map count would be visible to applications. */
     wined3d_not_from_cs(context->device->cs);
 
+    if (context == &context->device->cs->c && context->device->cs->stats)
+        InterlockedIncrement(&context->device->cs->stats->maps);
+
     if ((flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_NOOVERWRITE))
             && context->ops->map_upload_bo(context, resource, sub_resource_idx, map_desc, box, flags))
     {
@@ -3083,6 +3295,7 @@ static bool wined3d_cs_map_upload_bo(struct wined3d_device_context *context, str
         {
             if (!device->adapter->adapter_ops->adapter_alloc_bo(device, resource, sub_resource_idx, &addr))
                 return false;
+            wined3d_cs_count_upload_bo(device->cs, resource, sub_resource_idx);
 
             /* Limit NOOVERWRITE maps to buffers for now; there are too many
              * ways that a texture can be invalidated to even count. */
@@ -3242,6 +3455,23 @@ static void wined3d_cs_mt_submit(struct wined3d_device_context *context, enum wi
     wined3d_cs_queue_submit(&cs->queue[queue_id], cs);
 }
 
+static BOOL wined3d_cs_queue_has_space(ULONG head, ULONG tail, size_t packet_size)
+{
+    ULONG new_pos;
+
+    /* Empty. */
+    if (head == tail)
+        return TRUE;
+    new_pos = (head + packet_size) & WINED3D_CS_QUEUE_MASK;
+    /* Head ahead of tail. We checked the remaining size above, so we only
+     * need to make sure we don't make head equal to tail. */
+    if (head > tail && (new_pos != tail))
+        return TRUE;
+    /* Tail ahead of head. Make sure the new head is before the tail as
+     * well. Note that new_pos is 0 when it's at the end of the queue. */
+    return new_pos < tail && new_pos;
+}
+
 static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size_t size, struct wined3d_cs *cs)
 {
     size_t queue_size = ARRAY_SIZE(queue->data);
@@ -3276,26 +3506,26 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
         assert(!head);
     }
 
-    for (;;)
+    /* The tail only moves forward, so a stale cached tail may make the queue
+     * look fuller than it is, but never emptier. */
+    if (!wined3d_cs_queue_has_space(head, queue->cached_tail & WINED3D_CS_QUEUE_MASK, packet_size))
     {
-        ULONG tail = (*(volatile ULONG *)&queue->tail) & WINED3D_CS_QUEUE_MASK;
-        ULONG new_pos;
+        unsigned int spin_count = 0;
+        ULONG tail;
 
-        /* Empty. */
-        if (head == tail)
-            break;
-        new_pos = (head + packet_size) & WINED3D_CS_QUEUE_MASK;
-        /* Head ahead of tail. We checked the remaining size above, so we only
-         * need to make sure we don't make head equal to tail. */
-        if (head > tail && (new_pos != tail))
-            break;
-        /* Tail ahead of head. Make sure the new head is before the tail as
-         * well. Note that new_pos is 0 when it's at the end of the queue. */
-        if (new_pos < tail && new_pos)
-            break;
+        for (;;)
+        {
+            tail = *(volatile ULONG *)&queue->tail;
+            queue->cached_tail = tail;
+            if (wined3d_cs_queue_has_space(head, tail & WINED3D_CS_QUEUE_MASK, packet_size))
+                break;
 
-        TRACE_(d3d_perf)("Waiting for free space. Head %lu, tail %lu, packet size %Iu.\n",
-                head, tail, packet_size);
+            if (!spin_count && cs->stats)
+                InterlockedIncrement(&cs->stats->queue_full_waits);
+            TRACE_(d3d_perf)("Waiting for free space. Head %lu, tail %lu, packet size %Iu.\n",
+                    head, tail & WINED3D_CS_QUEUE_MASK, packet_size);
+            wined3d_pause(&spin_count);
+        }
     }
 
     packet = (struct wined3d_cs_packet *)&queue->data[head];
@@ -3322,9 +3552,25 @@ static void wined3d_cs_mt_finish(struct wined3d_device_context *context, enum wi
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(context, queue_id);
 
+#ifdef __GNUC__
+    TRACE_(d3d_perf)("Waiting for queue %u to be empty, caller %p.\n", queue_id, __builtin_return_address(0));
+#else
     TRACE_(d3d_perf)("Waiting for queue %u to be empty.\n", queue_id);
-    while (cs->queue[queue_id].head != *(volatile ULONG *)&cs->queue[queue_id].tail)
-        wined3d_pause(&spin_count);
+#endif
+    if (cs->stats)
+    {
+        LONG64 start = wined3d_cs_stats_time();
+
+        while (cs->queue[queue_id].head != *(volatile ULONG *)&cs->queue[queue_id].tail)
+            wined3d_pause(&spin_count);
+        InterlockedIncrement(&cs->stats->finishes);
+        InterlockedAdd64(&cs->stats->finish_time, wined3d_cs_stats_time() - start);
+    }
+    else
+    {
+        while (cs->queue[queue_id].head != *(volatile ULONG *)&cs->queue[queue_id].tail)
+            wined3d_pause(&spin_count);
+    }
     TRACE_(d3d_perf)("Queue is now empty.\n");
 }
 
@@ -3417,6 +3663,16 @@ static inline bool wined3d_cs_execute_next(struct wined3d_cs *cs, struct wined3d
             return false;
         }
 
+        if (cs->stats)
+        {
+            ++cs->stats->packets[opcode];
+            ++cs->stats->frame_packets;
+            if (opcode == WINED3D_CS_OP_DRAW)
+                ++cs->stats->frame_draws;
+            else if (opcode == WINED3D_CS_OP_DISPATCH)
+                ++cs->stats->frame_dispatches;
+        }
+
         wined3d_cs_command_lock(cs);
         wined3d_cs_op_handlers[opcode](cs, packet->data);
         wined3d_cs_command_unlock(cs);
@@ -3490,6 +3746,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             queue = &cs->queue[WINED3D_CS_QUEUE_DEFAULT];
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
+                if (!spin_count && cs->stats)
+                    cs->stats->idle_start = wined3d_cs_stats_time();
                 YieldProcessor();
                 if (++spin_count >= WINED3D_CS_SPIN_COUNT)
                 {
@@ -3501,6 +3759,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
                 continue;
             }
         }
+        if (spin_count && cs->stats)
+            cs->stats->frame_idle_time += wined3d_cs_stats_time() - cs->stats->idle_start;
         spin_count = 0;
 
         run = wined3d_cs_execute_next(cs, queue);
@@ -3582,6 +3842,9 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     {
         cs->c.ops = &wined3d_cs_mt_ops;
 
+        if (TRACE_ON(d3d_perf) || wined3d_settings.frame_stats_log)
+            cs->stats = wined3d_cs_stats_create();
+
         if (!pNtAlertThreadByThreadId)
         {
             HANDLE ntdll = GetModuleHandleW(L"ntdll.dll");
@@ -3630,6 +3893,7 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     return cs;
 
 fail:
+    wined3d_cs_stats_destroy(cs->stats);
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
     heap_free(cs);
@@ -3650,6 +3914,7 @@ void wined3d_cs_destroy(struct wined3d_cs *cs)
 
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
+    wined3d_cs_stats_destroy(cs->stats);
     heap_free(cs->data);
     heap_free(cs);
 }
@@ -4274,6 +4539,7 @@ static bool wined3d_deferred_context_map_upload_bo(struct wined3d_device_context
     {
         upload->bo = addr.buffer_object;
         upload->sysmem = NULL;
+        wined3d_cs_count_upload_bo(device->cs, resource, sub_resource_idx);
 
         TRACE("Allocated BO %s.\n", debug_bo_address(&addr));
 
@@ -4488,6 +4754,134 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
     heap_free(deferred);
 }
 
+/* Returns whether executing "later" makes the state set by "earlier" dead.
+ * Only packets that just replace CS state are considered. */
+static bool wined3d_cs_packet_supersedes(const void *later, const void *earlier)
+{
+    enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)later;
+
+    if (earlier && opcode != *(const enum wined3d_cs_op *)earlier)
+        return false;
+
+    switch (opcode)
+    {
+        case WINED3D_CS_OP_SET_BLEND_STATE:
+        case WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE:
+        case WINED3D_CS_OP_SET_RASTERIZER_STATE:
+            return true;
+
+        case WINED3D_CS_OP_SET_VIEWPORTS:
+        {
+            const struct wined3d_cs_set_viewports *l = later, *e = earlier;
+
+            return !e || l->viewport_count >= e->viewport_count;
+        }
+
+        case WINED3D_CS_OP_SET_SCISSOR_RECTS:
+        {
+            const struct wined3d_cs_set_scissor_rects *l = later, *e = earlier;
+
+            return !e || l->rect_count >= e->rect_count;
+        }
+
+        case WINED3D_CS_OP_SET_SHADER:
+        {
+            const struct wined3d_cs_set_shader *l = later, *e = earlier;
+
+            return !e || l->type == e->type;
+        }
+
+        case WINED3D_CS_OP_SET_CONSTANT_BUFFERS:
+        {
+            const struct wined3d_cs_set_constant_buffers *l = later, *e = earlier;
+
+            return !e || (l->type == e->type && l->start_idx <= e->start_idx
+                    && l->start_idx + l->count >= e->start_idx + e->count);
+        }
+
+        case WINED3D_CS_OP_SET_SHADER_RESOURCE_VIEWS:
+        {
+            const struct wined3d_cs_set_shader_resource_views *l = later, *e = earlier;
+
+            return !e || (l->type == e->type && l->start_idx <= e->start_idx
+                    && l->start_idx + l->count >= e->start_idx + e->count);
+        }
+
+        case WINED3D_CS_OP_SET_SAMPLERS:
+        {
+            const struct wined3d_cs_set_samplers *l = later, *e = earlier;
+
+            return !e || (l->type == e->type && l->start_idx <= e->start_idx
+                    && l->start_idx + l->count >= e->start_idx + e->count);
+        }
+
+        default:
+            return false;
+    }
+}
+
+/* Drop state packets that are overwritten before any draw, dispatch or other
+ * operation can observe them. Applications tend to rebind state between draws
+ * much more often than necessary, and doing this once while recording on the
+ * application's thread saves the CS thread from replaying it every time the
+ * command list is executed. */
+static void wined3d_deferred_context_drop_dead_state(struct wined3d_deferred_context *deferred)
+{
+    SIZE_T pending[64], pending_count = 0, offset = 0, dst = 0, size, i;
+    unsigned int dropped = 0;
+    struct wined3d_cs_packet *packet;
+    uint8_t *data = deferred->data;
+
+    while (offset < deferred->data_size)
+    {
+        SIZE_T packet_offset = offset;
+
+        packet = wined3d_next_cs_packet(data, &offset, ~(SIZE_T)0);
+
+        if (!wined3d_cs_packet_supersedes(packet->data, NULL))
+        {
+            pending_count = 0;
+            continue;
+        }
+
+        for (i = 0; i < pending_count; ++i)
+        {
+            struct wined3d_cs_packet *prev = (struct wined3d_cs_packet *)&data[pending[i]];
+
+            if (!wined3d_cs_packet_supersedes(packet->data, prev->data))
+                continue;
+
+            wined3d_cs_packet_decref_objects(prev);
+            *(enum wined3d_cs_op *)prev->data = WINED3D_CS_OP_NOP;
+            pending[i--] = pending[--pending_count];
+            ++dropped;
+        }
+
+        if (pending_count < ARRAY_SIZE(pending))
+            pending[pending_count++] = packet_offset;
+    }
+
+    if (!dropped)
+        return;
+
+    for (offset = 0; offset < deferred->data_size;)
+    {
+        SIZE_T packet_offset = offset;
+
+        packet = wined3d_next_cs_packet(data, &offset, ~(SIZE_T)0);
+        if (*(const enum wined3d_cs_op *)packet->data == WINED3D_CS_OP_NOP)
+            continue;
+
+        size = offset - packet_offset;
+        if (dst != packet_offset)
+            memmove(&data[dst], packet, size);
+        dst += size;
+    }
+
+    TRACE("Dropped %u dead state packets, %Iu bytes.\n", dropped, deferred->data_size - dst);
+    deferred->data_size = dst;
+}
+
 HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device_context *context,
         bool restore, struct wined3d_command_list **list)
 {
@@ -4498,6 +4892,7 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     TRACE("context %p, list %p.\n", context, list);
 
     wined3d_device_context_lock(context);
+    wined3d_deferred_context_drop_dead_state(deferred);
     memory = heap_alloc(sizeof(*object) + deferred->resource_count * sizeof(*object->resources)
             + deferred->upload_count * sizeof(*object->uploads)
             + deferred->command_list_count * sizeof(*object->command_lists)
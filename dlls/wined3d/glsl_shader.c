@@ -138,6 +138,13 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_vertex_shaders;
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL legacy_lighting;
+
+    struct wine_rb_tree program_binaries;
+    size_t program_binaries_size;
+    uint64_t program_binaries_driver;
+    BOOL program_binaries_loaded;
+    BOOL program_binaries_enabled;
+    BOOL program_binaries_dirty;
 };
 
 struct glsl_vs_program
@@ -252,7 +259,19 @@ struct glsl_shader_prog_link
     unsigned int constant_version;
     DWORD shader_controlled_clip_distances : 1;
     DWORD clip_distance_mask : 8; /* WINED3D_MAX_CLIP_DISTANCES, 8 */
-    DWORD padding : 23;
+    DWORD pending : 1;
+    DWORD padding : 22;
+    uint64_t binary_hash;
+    struct wined3d_shader *shaders[WINED3D_SHADER_TYPE_GRAPHICS_COUNT];
+};
+
+struct glsl_program_binary
+{
+    struct wine_rb_entry entry;
+    uint64_t hash;
+    GLenum format;
+    GLsizei size;
+    BYTE data[1];
 };
 
 struct glsl_program_key
@@ -10151,7 +10170,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
     struct glsl_shader_prog_link *entry;
     GLuint shader_id, program_id;
 
-    if (!(entry = heap_alloc(sizeof(*entry))))
+    if (!(entry = heap_alloc_zero(sizeof(*entry))))
     {
         ERR("Out of memory.\n");
         return E_OUTOFMEMORY;
@@ -10264,13 +10283,456 @@ static void set_glsl_compute_shader_program(const struct wined3d_context_gl *con
     ctx_data->glsl_program = entry;
 }
 
+#define WINED3D_GLSL_PROGRAM_CACHE_MAGIC    0x50475747u /* "GWGP" */
+#define WINED3D_GLSL_PROGRAM_CACHE_VERSION  1
+#define WINED3D_GLSL_PROGRAM_CACHE_MAX_SIZE (256 * 1024 * 1024)
+
+struct glsl_program_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t driver;
+    uint32_t count;
+    uint32_t padding;
+};
+
+struct glsl_program_cache_record
+{
+    uint64_t hash;
+    uint32_t format;
+    uint32_t size;
+};
+
+static uint64_t glsl_hash_data(uint64_t hash, const void *data, size_t size)
+{
+    const BYTE *ptr = data;
+    size_t i;
+
+    for (i = 0; i < size; ++i)
+        hash = (hash ^ ptr[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+static int glsl_program_binary_compare(const void *key, const struct wine_rb_entry *entry)
+{
+    return wined3d_uint64_compare(*(const uint64_t *)key,
+            WINE_RB_ENTRY_VALUE(entry, struct glsl_program_binary, entry)->hash);
+}
+
+static void glsl_program_binary_free(struct wine_rb_entry *entry, void *context)
+{
+    heap_free(WINE_RB_ENTRY_VALUE(entry, struct glsl_program_binary, entry));
+}
+
+static void shader_glsl_add_program_binary(struct shader_glsl_priv *priv, struct glsl_program_binary *binary)
+{
+    if (wine_rb_put(&priv->program_binaries, &binary->hash, &binary->entry) == -1)
+    {
+        heap_free(binary);
+        return;
+    }
+    priv->program_binaries_size += binary->size;
+}
+
+static void shader_glsl_remove_program_binary(struct shader_glsl_priv *priv, struct glsl_program_binary *binary)
+{
+    wine_rb_remove(&priv->program_binaries, &binary->entry);
+    priv->program_binaries_size -= binary->size;
+    heap_free(binary);
+}
+
+/* The program binaries of previous runs are stored in a single file per
+ * application, and are only valid for the same driver. */
+static void shader_glsl_load_program_binaries(struct shader_glsl_priv *priv, const struct wined3d_gl_info *gl_info)
+{
+    const struct glsl_program_cache_header *header;
+    struct glsl_program_cache_record record;
+    struct glsl_program_binary *binary;
+    const char *str[3];
+    GLint format_count;
+    LARGE_INTEGER size;
+    char path[MAX_PATH];
+    BYTE *data = NULL;
+    unsigned int i;
+    uint64_t hash;
+    size_t offset;
+    HANDLE file;
+    DWORD read;
+
+    priv->program_binaries_loaded = TRUE;
+
+    if (!wined3d_settings.gl_program_cache || !gl_info->supported[ARB_GET_PROGRAM_BINARY])
+        return;
+    gl_info->gl_ops.gl.p_glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    if (format_count <= 0)
+        return;
+
+    hash = 0xcbf29ce484222325ull;
+    str[0] = (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VENDOR);
+    str[1] = (const char *)gl_info->gl_ops.gl.p_glGetString(GL_RENDERER);
+    str[2] = (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VERSION);
+    for (i = 0; i < ARRAY_SIZE(str); ++i)
+    {
+        if (!str[i])
+            return;
+        hash = glsl_hash_data(hash, str[i], strlen(str[i]) + 1);
+    }
+    priv->program_binaries_driver = hash;
+    priv->program_binaries_enabled = TRUE;
+
+    if (!wined3d_get_cache_path("glcache", path, ARRAY_SIZE(path)))
+        return;
+    if ((file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+        return;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < sizeof(*header)
+            || size.QuadPart > WINED3D_GLSL_PROGRAM_CACHE_MAX_SIZE || !(data = heap_alloc(size.QuadPart))
+            || !ReadFile(file, data, size.QuadPart, &read, NULL) || read != size.QuadPart)
+        goto done;
+
+    header = (const struct glsl_program_cache_header *)data;
+    if (header->magic != WINED3D_GLSL_PROGRAM_CACHE_MAGIC || header->version != WINED3D_GLSL_PROGRAM_CACHE_VERSION
+            || header->driver != priv->program_binaries_driver)
+    {
+        TRACE("Ignoring stale program cache %s.\n", debugstr_a(path));
+        goto done;
+    }
+
+    for (i = 0, offset = sizeof(*header); i < header->count; ++i)
+    {
+        if (size.QuadPart - offset < sizeof(record))
+            break;
+        memcpy(&record, data + offset, sizeof(record));
+        offset += sizeof(record);
+        if (!record.size || size.QuadPart - offset < record.size)
+            break;
+
+        if (!(binary = heap_alloc(offsetof(struct glsl_program_binary, data[record.size]))))
+            break;
+        binary->hash = record.hash;
+        binary->format = record.format;
+        binary->size = record.size;
+        memcpy(binary->data, data + offset, record.size);
+        offset += record.size;
+        shader_glsl_add_program_binary(priv, binary);
+    }
+    TRACE("Loaded %u program binaries from %s.\n", i, debugstr_a(path));
+
+done:
+    heap_free(data);
+    CloseHandle(file);
+}
+
+static void shader_glsl_save_program_binaries(struct shader_glsl_priv *priv)
+{
+    struct glsl_program_cache_header header;
+    struct glsl_program_cache_record record;
+    struct glsl_program_binary *binary;
+    char path[MAX_PATH];
+    DWORD written;
+    HANDLE file;
+    BOOL ret;
+
+    if (!priv->program_binaries_dirty || !wined3d_get_cache_path("glcache", path, ARRAY_SIZE(path)))
+        return;
+
+    if ((file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create program cache file %s, error %lu.\n", debugstr_a(path), GetLastError());
+        return;
+    }
+
+    header.magic = WINED3D_GLSL_PROGRAM_CACHE_MAGIC;
+    header.version = WINED3D_GLSL_PROGRAM_CACHE_VERSION;
+    header.driver = priv->program_binaries_driver;
+    header.count = 0;
+    header.padding = 0;
+    RB_FOR_EACH_ENTRY(binary, &priv->program_binaries, struct glsl_program_binary, entry)
+        ++header.count;
+
+    ret = WriteFile(file, &header, sizeof(header), &written, NULL);
+    RB_FOR_EACH_ENTRY(binary, &priv->program_binaries, struct glsl_program_binary, entry)
+    {
+        if (!ret)
+            break;
+        record.hash = binary->hash;
+        record.format = binary->format;
+        record.size = binary->size;
+        ret = WriteFile(file, &record, sizeof(record), &written, NULL)
+                && WriteFile(file, binary->data, binary->size, &written, NULL);
+    }
+    CloseHandle(file);
+
+    if (!ret)
+    {
+        WARN("Failed to write program cache file %s, error %lu.\n", debugstr_a(path), GetLastError());
+        DeleteFileA(path);
+        return;
+    }
+    TRACE("Saved %u program binaries to %s.\n", header.count, debugstr_a(path));
+}
+
+/* Context activation is done by the caller. */
+static uint64_t shader_glsl_get_program_hash(const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t flags)
+{
+    GLuint shaders[WINED3D_SHADER_TYPE_GRAPHICS_COUNT + 1];
+    GLint count, length, type;
+    uint64_t hash = 0;
+    char *source;
+    GLint i;
+
+    GL_EXTCALL(glGetAttachedShaders(program_id, ARRAY_SIZE(shaders), &count, shaders));
+    /* Attachment order isn't necessarily stable, so combine the hashes of the
+     * individual shaders in an order independent way. */
+    for (i = 0; i < count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type));
+        if (length <= 0 || !(source = heap_alloc(length)))
+            return 0;
+        GL_EXTCALL(glGetShaderSource(shaders[i], length, NULL, source));
+        hash += glsl_hash_data(glsl_hash_data(0xcbf29ce484222325ull, &type, sizeof(type)), source, length);
+        heap_free(source);
+    }
+    checkGLcall("get program sources");
+
+    hash = glsl_hash_data(hash, &flags, sizeof(flags));
+    return hash ? hash : 1;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_load_program_binary(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t hash)
+{
+    struct glsl_program_binary *binary;
+    struct wine_rb_entry *entry;
+    GLint status;
+
+    if (!(entry = wine_rb_get(&priv->program_binaries, &hash)))
+        return FALSE;
+    binary = WINE_RB_ENTRY_VALUE(entry, struct glsl_program_binary, entry);
+
+    GL_EXTCALL(glProgramBinary(program_id, binary->format, binary->data, binary->size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    if (status)
+        return TRUE;
+
+    /* The driver may reject binaries at any time, e.g. after an update that
+     * didn't change the version string. */
+    TRACE("Discarding program binary %s.\n", wine_dbgstr_longlong(hash));
+    shader_glsl_remove_program_binary(priv, binary);
+    priv->program_binaries_dirty = TRUE;
+    return FALSE;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_store_program_binary(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t hash)
+{
+    struct glsl_program_binary *binary;
+    GLint status, size;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &size));
+    if (!status || size <= 0 || priv->program_binaries_size + size > WINED3D_GLSL_PROGRAM_CACHE_MAX_SIZE)
+        return;
+
+    if (!(binary = heap_alloc(offsetof(struct glsl_program_binary, data[size]))))
+        return;
+    binary->hash = hash;
+    GL_EXTCALL(glGetProgramBinary(program_id, size, &binary->size, &binary->format, binary->data));
+    checkGLcall("glGetProgramBinary");
+    if (binary->size <= 0)
+    {
+        heap_free(binary);
+        return;
+    }
+
+    shader_glsl_add_program_binary(priv, binary);
+    priv->program_binaries_dirty = TRUE;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_init_program(const struct wined3d_context_gl *context_gl,
+        struct shader_glsl_priv *priv, struct glsl_shader_prog_link *entry)
+{
+    struct wined3d_shader *vshader = entry->shaders[WINED3D_SHADER_TYPE_VERTEX];
+    struct wined3d_shader *hshader = entry->shaders[WINED3D_SHADER_TYPE_HULL];
+    struct wined3d_shader *dshader = entry->shaders[WINED3D_SHADER_TYPE_DOMAIN];
+    struct wined3d_shader *gshader = entry->shaders[WINED3D_SHADER_TYPE_GEOMETRY];
+    struct wined3d_shader *pshader = entry->shaders[WINED3D_SHADER_TYPE_PIXEL];
+    const struct wined3d_gl_info *gl_info = context_gl->gl_info;
+    const struct wined3d_shader *pre_rasterization_shader;
+    GLuint program_id = entry->id;
+    GLuint ps_id = entry->ps.id;
+    unsigned int i;
+
+    shader_glsl_validate_link(gl_info, program_id);
+    if (entry->binary_hash)
+        shader_glsl_store_program_binary(priv, gl_info, program_id, entry->binary_hash);
+    entry->pending = 0;
+
+    shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
+            vshader ? vshader->limits->constant_float : 0);
+    shader_glsl_init_ds_uniform_locations(gl_info, priv, program_id, &entry->ds);
+    shader_glsl_init_gs_uniform_locations(gl_info, priv, program_id, &entry->gs);
+    shader_glsl_init_ps_uniform_locations(gl_info, priv, program_id, &entry->ps,
+            pshader ? pshader->limits->constant_float : 0);
+    checkGLcall("find glsl program uniform locations");
+
+    pre_rasterization_shader = gshader ? gshader : dshader ? dshader : vshader;
+    if (pre_rasterization_shader && pre_rasterization_shader->reg_maps.shader_version.major >= 4)
+    {
+        unsigned int clip_distance_count = wined3d_popcount(pre_rasterization_shader->reg_maps.clip_distance_mask);
+        entry->shader_controlled_clip_distances = 1;
+        entry->clip_distance_mask = wined3d_mask_from_size(clip_distance_count);
+    }
+
+    if (needs_legacy_glsl_syntax(gl_info))
+    {
+        if (pshader && pshader->reg_maps.shader_version.major >= 3
+                && pshader->u.ps.declared_in_count > vec4_varyings(3, gl_info))
+        {
+            TRACE("Shader %d needs vertex color clamping disabled.\n", program_id);
+            entry->vs.vertex_color_clamp = GL_FALSE;
+        }
+        else
+        {
+            entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
+        }
+    }
+    else
+    {
+        /* With core profile we never change vertex_color_clamp from
+         * GL_FIXED_ONLY_MODE (which is also the initial value) so we never call
+         * glClampColorARB(). */
+        entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
+    }
+
+    /* Set the shader to allow uniform loading on it */
+    GL_EXTCALL(glUseProgram(program_id));
+    checkGLcall("glUseProgram");
+
+    entry->constant_update_mask = 0;
+    if (vshader)
+    {
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_F;
+        if (vshader->reg_maps.integer_constants)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_I;
+        if (vshader->reg_maps.boolean_constants)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_B;
+        if (entry->vs.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+        if (entry->vs.base_vertex_id_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_BASE_VERTEX_ID;
+
+        shader_glsl_load_program_resources(context_gl, priv, program_id, vshader);
+    }
+    else
+    {
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MODELVIEW
+                | WINED3D_SHADER_CONST_FFP_PROJ;
+
+        for (i = 1; i < MAX_VERTEX_BLENDS; ++i)
+        {
+            if (entry->vs.modelview_matrix_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_VERTEXBLEND;
+                break;
+            }
+        }
+
+        for (i = 0; i < WINED3D_MAX_FFP_TEXTURES; ++i)
+        {
+            if (entry->vs.texture_matrix_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_TEXMATRIX;
+                break;
+            }
+        }
+        if (entry->vs.material_ambient_location != -1 || entry->vs.material_diffuse_location != -1
+                || entry->vs.material_specular_location != -1
+                || entry->vs.material_emissive_location != -1
+                || entry->vs.material_shininess_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MATERIAL;
+        if (entry->vs.light_ambient_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_LIGHTS;
+    }
+    if (entry->vs.clip_planes_location != -1)
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_CLIP_PLANES;
+    if (entry->vs.pointsize_min_location != -1)
+        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_POINTSIZE;
+
+    if (hshader)
+        shader_glsl_load_program_resources(context_gl, priv, program_id, hshader);
+
+    if (dshader)
+    {
+        if (entry->ds.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+
+        shader_glsl_load_program_resources(context_gl, priv, program_id, dshader);
+    }
+
+    if (gshader)
+    {
+        if (entry->gs.pos_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
+
+        shader_glsl_load_program_resources(context_gl, priv, program_id, gshader);
+    }
+
+    if (ps_id)
+    {
+        if (pshader)
+        {
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_F;
+            if (pshader->reg_maps.integer_constants)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_I;
+            if (pshader->reg_maps.boolean_constants)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_B;
+            if (entry->ps.ycorrection_location != -1)
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_Y_CORR;
+
+            shader_glsl_load_program_resources(context_gl, priv, program_id, pshader);
+            shader_glsl_load_images(gl_info, priv, program_id, &pshader->reg_maps);
+        }
+        else
+        {
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_PS;
+
+            shader_glsl_load_samplers(&context_gl->c, priv, program_id, NULL);
+        }
+
+        for (i = 0; i < WINED3D_MAX_FFP_TEXTURES; ++i)
+        {
+            if (entry->ps.bumpenv_mat_location[i] != -1)
+            {
+                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_BUMP_ENV;
+                break;
+            }
+        }
+
+        if (entry->ps.fog_color_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_FOG;
+        if (entry->ps.alpha_test_ref_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_ALPHA_TEST;
+        if (entry->ps.np2_fixup_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_NP2_FIXUP;
+        if (entry->ps.color_key_location != -1)
+            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_COLOR_KEY;
+    }
+}
+
 /* Context activation is done by the caller. */
 static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl, const struct wined3d_state *state,
         struct shader_glsl_priv *priv, struct glsl_context_data *ctx_data)
 {
     const struct wined3d_d3d_info *d3d_info = context_gl->c.d3d_info;
     const struct wined3d_gl_info *gl_info = context_gl->gl_info;
-    const struct wined3d_shader *pre_rasterization_shader;
     const struct ps_np2fixup_info *np2fixup_info = NULL;
     struct wined3d_shader *hshader, *dshader, *gshader;
     struct glsl_shader_prog_link *entry = NULL;
@@ -10414,6 +10876,12 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     entry->constant_version = 0;
     entry->shader_controlled_clip_distances = 0;
     entry->ps.np2_fixup_info = np2fixup_info;
+    entry->pending = 0;
+    entry->shaders[WINED3D_SHADER_TYPE_VERTEX] = vshader;
+    entry->shaders[WINED3D_SHADER_TYPE_HULL] = hshader;
+    entry->shaders[WINED3D_SHADER_TYPE_DOMAIN] = dshader;
+    entry->shaders[WINED3D_SHADER_TYPE_GEOMETRY] = gshader;
+    entry->shaders[WINED3D_SHADER_TYPE_PIXEL] = pshader;
     /* Add the hash table entry */
     add_glsl_program_entry(priv, entry);
 
@@ -10533,161 +11001,39 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
-
-    shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
-            vshader ? vshader->limits->constant_float : 0);
-    shader_glsl_init_ds_uniform_locations(gl_info, priv, program_id, &entry->ds);
-    shader_glsl_init_gs_uniform_locations(gl_info, priv, program_id, &entry->gs);
-    shader_glsl_init_ps_uniform_locations(gl_info, priv, program_id, &entry->ps,
-            pshader ? pshader->limits->constant_float : 0);
-    checkGLcall("find glsl program uniform locations");
-
-    pre_rasterization_shader = gshader ? gshader : dshader ? dshader : vshader;
-    if (pre_rasterization_shader && pre_rasterization_shader->reg_maps.shader_version.major >= 4)
+    if (!priv->program_binaries_loaded)
+        shader_glsl_load_program_binaries(priv, gl_info);
+    entry->binary_hash = 0;
+    if (priv->program_binaries_enabled && !(gshader && gshader->u.gs.so_desc))
     {
-        unsigned int clip_distance_count = wined3d_popcount(pre_rasterization_shader->reg_maps.clip_distance_mask);
-        entry->shader_controlled_clip_distances = 1;
-        entry->clip_distance_mask = wined3d_mask_from_size(clip_distance_count);
-    }
+        bool dual_source = state->blend_state && state->blend_state->dual_source;
 
-    if (needs_legacy_glsl_syntax(gl_info))
-    {
-        if (pshader && pshader->reg_maps.shader_version.major >= 3
-                && pshader->u.ps.declared_in_count > vec4_varyings(3, gl_info))
-        {
-            TRACE("Shader %d needs vertex color clamping disabled.\n", program_id);
-            entry->vs.vertex_color_clamp = GL_FALSE;
-        }
-        else
-        {
-            entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
-        }
-    }
-    else
-    {
-        /* With core profile we never change vertex_color_clamp from
-         * GL_FIXED_ONLY_MODE (which is also the initial value) so we never call
-         * glClampColorARB(). */
-        entry->vs.vertex_color_clamp = GL_FIXED_ONLY_ARB;
+        entry->binary_hash = shader_glsl_get_program_hash(gl_info, program_id, dual_source);
     }
 
-    /* Set the shader to allow uniform loading on it */
-    GL_EXTCALL(glUseProgram(program_id));
-    checkGLcall("glUseProgram");
-
-    entry->constant_update_mask = 0;
-    if (vshader)
+    if (entry->binary_hash && shader_glsl_load_program_binary(priv, gl_info, program_id, entry->binary_hash))
     {
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_F;
-        if (vshader->reg_maps.integer_constants)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_I;
-        if (vshader->reg_maps.boolean_constants)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_B;
-        if (entry->vs.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-        if (entry->vs.base_vertex_id_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_BASE_VERTEX_ID;
-
-        shader_glsl_load_program_resources(context_gl, priv, program_id, vshader);
+        TRACE("Loaded GLSL shader program %u from the program cache.\n", program_id);
+        entry->binary_hash = 0;
     }
     else
     {
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MODELVIEW
-                | WINED3D_SHADER_CONST_FFP_PROJ;
-
-        for (i = 1; i < MAX_VERTEX_BLENDS; ++i)
-        {
-            if (entry->vs.modelview_matrix_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_VERTEXBLEND;
-                break;
-            }
-        }
+        /* Link the program */
+        TRACE("Linking GLSL shader program %u.\n", program_id);
+        if (entry->binary_hash)
+            GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        GL_EXTCALL(glLinkProgram(program_id));
 
-        for (i = 0; i < WINED3D_MAX_FFP_TEXTURES; ++i)
+        /* Don't wait for the driver to finish linking; shader_glsl_select()
+         * polls the program and skips draws until it's done. */
+        if (wined3d_settings.async_shader_compile && gl_info->supported[ARB_PARALLEL_SHADER_COMPILE])
         {
-            if (entry->vs.texture_matrix_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_TEXMATRIX;
-                break;
-            }
+            entry->pending = 1;
+            return;
         }
-        if (entry->vs.material_ambient_location != -1 || entry->vs.material_diffuse_location != -1
-                || entry->vs.material_specular_location != -1
-                || entry->vs.material_emissive_location != -1
-                || entry->vs.material_shininess_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_MATERIAL;
-        if (entry->vs.light_ambient_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_LIGHTS;
-    }
-    if (entry->vs.clip_planes_location != -1)
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_CLIP_PLANES;
-    if (entry->vs.pointsize_min_location != -1)
-        entry->constant_update_mask |= WINED3D_SHADER_CONST_VS_POINTSIZE;
-
-    if (hshader)
-        shader_glsl_load_program_resources(context_gl, priv, program_id, hshader);
-
-    if (dshader)
-    {
-        if (entry->ds.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-
-        shader_glsl_load_program_resources(context_gl, priv, program_id, dshader);
-    }
-
-    if (gshader)
-    {
-        if (entry->gs.pos_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_POS_FIXUP;
-
-        shader_glsl_load_program_resources(context_gl, priv, program_id, gshader);
     }
 
-    if (ps_id)
-    {
-        if (pshader)
-        {
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_F;
-            if (pshader->reg_maps.integer_constants)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_I;
-            if (pshader->reg_maps.boolean_constants)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_B;
-            if (entry->ps.ycorrection_location != -1)
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_Y_CORR;
-
-            shader_glsl_load_program_resources(context_gl, priv, program_id, pshader);
-            shader_glsl_load_images(gl_info, priv, program_id, &pshader->reg_maps);
-        }
-        else
-        {
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_PS;
-
-            shader_glsl_load_samplers(&context_gl->c, priv, program_id, NULL);
-        }
-
-        for (i = 0; i < WINED3D_MAX_FFP_TEXTURES; ++i)
-        {
-            if (entry->ps.bumpenv_mat_location[i] != -1)
-            {
-                entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_BUMP_ENV;
-                break;
-            }
-        }
-
-        if (entry->ps.fog_color_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_FOG;
-        if (entry->ps.alpha_test_ref_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_ALPHA_TEST;
-        if (entry->ps.np2_fixup_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_PS_NP2_FIXUP;
-        if (entry->ps.color_key_location != -1)
-            entry->constant_update_mask |= WINED3D_SHADER_CONST_FFP_COLOR_KEY;
-    }
+    shader_glsl_init_program(context_gl, priv, entry);
 }
 
 static void shader_glsl_precompile(void *shader_priv, struct wined3d_shader *shader)
@@ -10722,6 +11068,33 @@ static void shader_glsl_select(void *shader_priv, struct wined3d_context *contex
     set_glsl_shader_program(context_gl, state, priv, ctx_data);
     glsl_program = ctx_data->glsl_program;
 
+    context->shaders_pending = 0;
+    if (glsl_program && glsl_program->pending)
+    {
+        GLint complete;
+
+        GL_EXTCALL(glGetProgramiv(glsl_program->id, GL_COMPLETION_STATUS_ARB, &complete));
+        if (!complete)
+        {
+            TRACE("GLSL program %u is still being linked.\n", glsl_program->id);
+            /* Don't keep a program that can't be used yet current; the
+             * draw is skipped and the program selected again. */
+            ctx_data->glsl_program = NULL;
+            if (prev_id)
+            {
+                GL_EXTCALL(glUseProgram(0));
+                checkGLcall("glUseProgram");
+            }
+            context->shaders_pending = 1;
+            context->shader_update_mask |= (1u << WINED3D_SHADER_TYPE_COMPUTE);
+            return;
+        }
+        shader_glsl_init_program(context_gl, priv, glsl_program);
+        /* shader_glsl_init_program() makes the program current. */
+        prev_id = glsl_program->id;
+        context->constant_update_mask |= glsl_program->constant_update_mask;
+    }
+
     if (glsl_program)
     {
         program_id = glsl_program->id;
@@ -11121,6 +11494,7 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     }
 
     wine_rb_init(&priv->program_lookup, glsl_program_key_compare);
+    wine_rb_init(&priv->program_binaries, glsl_program_binary_compare);
 
     priv->next_constant_version = 1;
     priv->vertex_pipe = vertex_pipe;
@@ -11150,6 +11524,8 @@ static void shader_glsl_free(struct wined3d_device *device, struct wined3d_conte
     struct shader_glsl_priv *priv = device->shader_priv;
 
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
+    shader_glsl_save_program_binaries(priv);
+    wine_rb_destroy(&priv->program_binaries, glsl_program_binary_free, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
     heap_free(priv->stack);
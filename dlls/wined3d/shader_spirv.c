@@ -89,6 +89,7 @@ struct shader_spirv_compute_program_vk
     VkPipeline vk_pipeline;
     VkPipelineLayout vk_pipeline_layout;
     VkDescriptorSetLayout vk_set_layout;
+    bool push_descriptors;
 
     struct vkd3d_shader_scan_descriptor_info descriptor_info;
 };
@@ -383,6 +384,7 @@ static struct shader_spirv_compute_program_vk *shader_spirv_find_compute_program
     }
     program->vk_set_layout = layout->vk_set_layout;
     program->vk_pipeline_layout = layout->vk_pipeline_layout;
+    program->push_descriptors = layout->push_descriptors;
 
     pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipeline_info.pNext = NULL;
@@ -398,7 +400,7 @@ static struct shader_spirv_compute_program_vk *shader_spirv_find_compute_program
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
     pipeline_info.basePipelineIndex = -1;
     if ((vr = VK_CALL(vkCreateComputePipelines(device_vk->vk_device,
-            VK_NULL_HANDLE, 1, &pipeline_info, NULL, &program->vk_pipeline))) < 0)
+            device_vk->vk_pipeline_cache, 1, &pipeline_info, NULL, &program->vk_pipeline))) < 0)
     {
         ERR("Failed to create Vulkan compute pipeline, vr %s.\n", wined3d_debug_vkresult(vr));
         VK_CALL(vkDestroyShaderModule(device_vk->vk_device, program->vk_module, NULL));
@@ -782,6 +784,7 @@ static void shader_spirv_select(void *shader_priv, struct wined3d_context *conte
     layout_vk = wined3d_context_vk_get_pipeline_layout(context_vk, bindings->vk_bindings, bindings->vk_binding_count);
     context_vk->graphics.vk_set_layout = layout_vk->vk_set_layout;
     context_vk->graphics.vk_pipeline_layout = layout_vk->vk_pipeline_layout;
+    context_vk->graphics.push_descriptors = layout_vk->push_descriptors;
 
     for (shader_type = 0; shader_type < ARRAY_SIZE(context_vk->graphics.vk_modules); ++shader_type)
     {
@@ -829,6 +832,7 @@ static void shader_spirv_select_compute(void *shader_priv,
         context_vk->compute.vk_pipeline = program->vk_pipeline;
         context_vk->compute.vk_set_layout = program->vk_set_layout;
         context_vk->compute.vk_pipeline_layout = program->vk_pipeline_layout;
+        context_vk->compute.push_descriptors = program->push_descriptors;
     }
     else
     {
@@ -69,6 +69,7 @@ struct wined3d_stateblock
 {
     LONG ref;
     struct wined3d_device *device;
+    enum wined3d_stateblock_type type;
 
     struct wined3d_saved_states changed;
 
@@ -85,6 +86,15 @@ struct wined3d_stateblock
     unsigned int num_contained_sampler_states;
 };
 
+/* The primary stateblock only differs from the device state where its
+ * changed flags are set, so setting a state to the value it already has
+ * there doesn't need to be flagged. Other stateblocks record which states
+ * were set, whatever their value. */
+static bool wined3d_stateblock_is_primary(const struct wined3d_stateblock *stateblock)
+{
+    return stateblock->type == WINED3D_SBT_PRIMARY;
+}
+
 static const DWORD pixel_states_render[] =
 {
     WINED3D_RS_ALPHABLENDENABLE,
@@ -1470,6 +1480,11 @@ void CDECL wined3d_stateblock_set_render_state(struct wined3d_stateblock *stateb
         return;
     }
 
+    /* Setting WINED3D_RS_POINTSIZE to the RESZ code triggers a resolve every time. */
+    if (wined3d_stateblock_is_primary(stateblock) && state != WINED3D_RS_POINTSIZE
+            && stateblock->stateblock_state.rs[state] == value)
+        return;
+
     stateblock->stateblock_state.rs[state] = value;
     stateblock->changed.renderState[state >> 5] |= 1u << (state & 0x1f);
 
@@ -1493,6 +1508,10 @@ void CDECL wined3d_stateblock_set_sampler_state(struct wined3d_stateblock *state
         return;
     }
 
+    if (wined3d_stateblock_is_primary(stateblock)
+            && stateblock->stateblock_state.sampler_states[sampler_idx][state] == value)
+        return;
+
     stateblock->stateblock_state.sampler_states[sampler_idx][state] = value;
     stateblock->changed.samplerState[sampler_idx] |= 1u << state;
 }
@@ -1516,6 +1535,9 @@ void CDECL wined3d_stateblock_set_texture_stage_state(struct wined3d_stateblock
         return;
     }
 
+    if (wined3d_stateblock_is_primary(stateblock) && stateblock->stateblock_state.texture_states[stage][state] == value)
+        return;
+
     stateblock->stateblock_state.texture_states[stage][state] = value;
     stateblock->changed.textureState[stage] |= 1u << state;
 }
@@ -1531,6 +1553,9 @@ void CDECL wined3d_stateblock_set_texture(struct wined3d_stateblock *stateblock,
         return;
     }
 
+    if (wined3d_stateblock_is_primary(stateblock) && stateblock->stateblock_state.textures[stage] == texture)
+        return;
+
     if (texture)
         wined3d_texture_incref(texture);
     if (stateblock->stateblock_state.textures[stage])
@@ -1548,6 +1573,10 @@ void CDECL wined3d_stateblock_set_transform(struct wined3d_stateblock *statebloc
     TRACE("%.8e %.8e %.8e %.8e\n", matrix->_31, matrix->_32, matrix->_33, matrix->_34);
     TRACE("%.8e %.8e %.8e %.8e\n", matrix->_41, matrix->_42, matrix->_43, matrix->_44);
 
+    if (wined3d_stateblock_is_primary(stateblock)
+            && !memcmp(&stateblock->stateblock_state.transforms[d3dts], matrix, sizeof(*matrix)))
+        return;
+
     stateblock->stateblock_state.transforms[d3dts] = *matrix;
     stateblock->changed.transform[d3dts >> 5] |= 1u << (d3dts & 0x1f);
     stateblock->changed.transforms = 1;
@@ -2127,6 +2156,7 @@ static HRESULT stateblock_init(struct wined3d_stateblock *stateblock, const stru
 
     stateblock->ref = 1;
     stateblock->device = device;
+    stateblock->type = type;
     stateblock->stateblock_state.light_state = &stateblock->light_state;
     wined3d_stateblock_state_init(&stateblock->stateblock_state, device,
             type == WINED3D_SBT_PRIMARY ? WINED3D_STATE_INIT_DEFAULT : 0);
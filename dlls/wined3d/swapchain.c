@@ -27,6 +27,21 @@
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
+static void wined3d_swapchain_destroy_timestamp_queries(struct wined3d_swapchain *swapchain)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(swapchain->timestamp_queries); ++i)
+    {
+        if (swapchain->timestamp_queries[i])
+            wined3d_query_decref(swapchain->timestamp_queries[i]);
+        swapchain->timestamp_queries[i] = NULL;
+    }
+    if (swapchain->timestamp_disjoint_query)
+        wined3d_query_decref(swapchain->timestamp_disjoint_query);
+    swapchain->timestamp_disjoint_query = NULL;
+}
+
 void wined3d_swapchain_cleanup(struct wined3d_swapchain *swapchain)
 {
     HRESULT hr;
@@ -34,6 +49,7 @@ void wined3d_swapchain_cleanup(struct wined3d_swapchain *swapchain)
 
     TRACE("Destroying swapchain %p.\n", swapchain);
 
+    wined3d_swapchain_destroy_timestamp_queries(swapchain);
     wined3d_swapchain_state_cleanup(&swapchain->state);
     wined3d_swapchain_set_gamma_ramp(swapchain, 0, &swapchain->orig_gamma);
 
@@ -189,6 +205,73 @@ void CDECL wined3d_swapchain_set_window(struct wined3d_swapchain *swapchain, HWN
     swapchain->win_handle = window;
 }
 
+static bool wined3d_swapchain_create_timestamp_queries(struct wined3d_swapchain *swapchain)
+{
+    struct wined3d_device *device = swapchain->device;
+    unsigned int i;
+
+    if (FAILED(wined3d_query_create(device, WINED3D_QUERY_TYPE_TIMESTAMP_DISJOINT,
+            NULL, &wined3d_null_parent_ops, &swapchain->timestamp_disjoint_query)))
+        return false;
+
+    for (i = 0; i < ARRAY_SIZE(swapchain->timestamp_queries); ++i)
+    {
+        if (FAILED(wined3d_query_create(device, WINED3D_QUERY_TYPE_TIMESTAMP,
+                NULL, &wined3d_null_parent_ops, &swapchain->timestamp_queries[i])))
+        {
+            wined3d_swapchain_destroy_timestamp_queries(swapchain);
+            return false;
+        }
+    }
+
+    wined3d_query_issue(swapchain->timestamp_disjoint_query, WINED3DISSUE_BEGIN);
+    wined3d_query_issue(swapchain->timestamp_disjoint_query, WINED3DISSUE_END);
+
+    return true;
+}
+
+/* Measure the GPU time between consecutive presents with a ring of timestamp
+ * queries. Results are only collected when we get back to a query, so the
+ * reported time lags behind the current frame. This is only used for frame
+ * statistics. */
+void wined3d_swapchain_update_gpu_time(struct wined3d_swapchain *swapchain)
+{
+    struct wined3d_query_data_timestamp_disjoint disjoint;
+    struct wined3d_query *query;
+    UINT64 timestamp;
+
+    if (swapchain->no_timestamps)
+        return;
+
+    if (!swapchain->timestamp_disjoint_query && !wined3d_swapchain_create_timestamp_queries(swapchain))
+    {
+        WARN("Failed to create timestamp queries, not measuring GPU time.\n");
+        swapchain->no_timestamps = true;
+        return;
+    }
+
+    if (!swapchain->timestamp_frequency && wined3d_query_get_data(swapchain->timestamp_disjoint_query,
+            &disjoint, sizeof(disjoint), WINED3DGETDATA_FLUSH) == S_OK)
+        swapchain->timestamp_frequency = disjoint.frequency;
+
+    query = swapchain->timestamp_queries[swapchain->timestamp_query_idx];
+    if (swapchain->timestamp_frequency && wined3d_query_get_data(query, &timestamp, sizeof(timestamp), 0) == S_OK)
+    {
+        if (swapchain->last_timestamp && timestamp > swapchain->last_timestamp)
+            swapchain->gpu_frame_time = (timestamp - swapchain->last_timestamp)
+                    * 1000000000 / swapchain->timestamp_frequency;
+        swapchain->last_timestamp = timestamp;
+    }
+    else
+    {
+        /* The next result wouldn't belong to the frame after this one. */
+        swapchain->last_timestamp = 0;
+    }
+
+    wined3d_query_issue(query, WINED3DISSUE_END);
+    swapchain->timestamp_query_idx = (swapchain->timestamp_query_idx + 1) % ARRAY_SIZE(swapchain->timestamp_queries);
+}
+
 HRESULT CDECL wined3d_swapchain_present(struct wined3d_swapchain *swapchain,
         const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
         unsigned int swap_interval, uint32_t flags)
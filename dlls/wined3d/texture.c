@@ -71,9 +71,19 @@ static BOOL wined3d_texture_use_pbo(const struct wined3d_texture *texture, const
         return FALSE;
 
     /* Use a PBO for dynamic textures and read-only staging textures. */
-    return (!(texture->resource.access & WINED3D_RESOURCE_ACCESS_CPU)
+    if ((!(texture->resource.access & WINED3D_RESOURCE_ACCESS_CPU)
                 && texture->resource.usage & WINED3DUSAGE_DYNAMIC)
-            || texture->resource.access == (WINED3D_RESOURCE_ACCESS_CPU | WINED3D_RESOURCE_ACCESS_MAP_R);
+            || texture->resource.access == (WINED3D_RESOURCE_ACCESS_CPU | WINED3D_RESOURCE_ACCESS_MAP_R))
+        return TRUE;
+
+    /* With persistently mapped buffers, mapping a PBO is as cheap as mapping
+     * system memory, so use one for CPU-only textures as well. Uploads from
+     * them (e.g. UpdateTexture()) then come straight out of the staging
+     * buffer, and readbacks into them (e.g. GetRenderTargetData()) are
+     * queued to the GPU instead of stalling until the map. */
+    return d3d_info->persistent_map && !(texture->flags & WINED3D_TEXTURE_GET_DC)
+            && (texture->resource.access & (WINED3D_RESOURCE_ACCESS_GPU | WINED3D_RESOURCE_ACCESS_CPU
+            | WINED3D_RESOURCE_ACCESS_MAP_R)) == (WINED3D_RESOURCE_ACCESS_CPU | WINED3D_RESOURCE_ACCESS_MAP_R);
 }
 
 static BOOL wined3d_texture_use_immutable_storage(const struct wined3d_texture *texture,
@@ -1988,6 +1998,13 @@ HRESULT CDECL wined3d_texture_update_desc(struct wined3d_texture *texture,
 
     texture->sub_resources[sub_resource_idx].user_memory = mem;
 
+    /* The application owns user memory; it has to stay the map location. */
+    if (mem && texture->resource.map_binding == WINED3D_LOCATION_BUFFER)
+    {
+        texture->resource.pin_sysmem = 1;
+        texture->resource.map_binding = WINED3D_LOCATION_SYSMEM;
+    }
+
     if (update_memory_only)
     {
         for (i = 0; i < sub_resource_count; ++i)
@@ -1867,6 +1867,7 @@ static VkPipeline create_uav_pipeline(struct wined3d_context_vk *context_vk,
     VkComputePipelineCreateInfo pipeline_info;
     struct wined3d_shader_desc shader_desc;
     const struct wined3d_vk_info *vk_info;
+    struct wined3d_device_vk *device_vk;
     struct wined3d_context *context;
     VkShaderModule shader_module;
     VkDevice vk_device;
@@ -1901,9 +1902,11 @@ static VkPipeline create_uav_pipeline(struct wined3d_context_vk *context_vk,
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
     pipeline_info.basePipelineIndex = -1;
 
-    vk_device = wined3d_device_vk(context->device)->vk_device;
+    device_vk = wined3d_device_vk(context->device);
+    vk_device = device_vk->vk_device;
 
-    if ((vr = VK_CALL(vkCreateComputePipelines(vk_device, VK_NULL_HANDLE, 1, &pipeline_info, NULL, &result))) < 0)
+    if ((vr = VK_CALL(vkCreateComputePipelines(vk_device, device_vk->vk_pipeline_cache,
+            1, &pipeline_info, NULL, &result))) < 0)
     {
         ERR("Failed to create Vulkan compute pipeline, vr %s.\n", wined3d_debug_vkresult(vr));
         return VK_NULL_HANDLE;
@@ -2268,7 +2271,11 @@ void wined3d_unordered_access_view_vk_clear(struct wined3d_unordered_access_view
 
     vk_info = context_vk->vk_info;
 
-    if (!(vk_writes[0].dstSet = wined3d_context_vk_create_vk_descriptor_set(context_vk, layout->vk_set_layout)))
+    if (layout->push_descriptors)
+    {
+        vk_writes[0].dstSet = VK_NULL_HANDLE;
+    }
+    else if (!(vk_writes[0].dstSet = wined3d_context_vk_create_vk_descriptor_set(context_vk, layout->vk_set_layout)))
     {
         ERR("Failed to create descriptor set.\n");
         wined3d_context_vk_destroy_bo(context_vk, &constants_bo);
@@ -2277,7 +2284,8 @@ void wined3d_unordered_access_view_vk_clear(struct wined3d_unordered_access_view
 
     vk_writes[1].dstSet = vk_writes[0].dstSet;
 
-    VK_CALL(vkUpdateDescriptorSets(device_vk->vk_device, 2, vk_writes, 0, NULL));
+    if (!layout->push_descriptors)
+        VK_CALL(vkUpdateDescriptorSets(device_vk->vk_device, 2, vk_writes, 0, NULL));
 
     vk_command_buffer = wined3d_context_vk_get_command_buffer(context_vk);
     wined3d_context_vk_end_current_render_pass(context_vk);
@@ -2296,8 +2304,12 @@ void wined3d_unordered_access_view_vk_clear(struct wined3d_unordered_access_view
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
             0, 1, &vk_barrier, 0, NULL, 0, NULL));
     VK_CALL(vkCmdBindPipeline(vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_pipeline));
-    VK_CALL(vkCmdBindDescriptorSets(vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-            layout->vk_pipeline_layout, 0, 1, &vk_writes[0].dstSet, 0, NULL));
+    if (layout->push_descriptors)
+        VK_CALL(vkCmdPushDescriptorSetKHR(vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                layout->vk_pipeline_layout, 0, 2, vk_writes));
+    else
+        VK_CALL(vkCmdBindDescriptorSets(vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                layout->vk_pipeline_layout, 0, 1, &vk_writes[0].dstSet, 0, NULL));
     VK_CALL(vkCmdDispatch(vk_command_buffer, group_count.x, group_count.y, group_count.z));
 
     vk_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
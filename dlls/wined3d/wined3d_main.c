@@ -132,6 +132,9 @@ struct wined3d_settings wined3d_settings =
     .max_sm_cs = UINT_MAX,
     .renderer = WINED3D_RENDERER_AUTO,
     .shader_backend = WINED3D_SHADER_BACKEND_AUTO,
+    .gl_program_cache = TRUE,
+    .vk_pipeline_cache = TRUE,
+    .vk_pipeline_cache_size = 256,
 };
 
 enum wined3d_renderer CDECL wined3d_get_renderer(void)
@@ -265,6 +268,30 @@ BOOL wined3d_get_app_name(char *app_name, unsigned int app_name_size)
     return TRUE;
 }
 
+/* Shader and pipeline caches are stored per application under the local
+ * application data directory, e.g. "%LOCALAPPDATA%\wine\wined3d\app.exe.name". */
+BOOL wined3d_get_cache_path(const char *name, char *path, unsigned int size)
+{
+    char app_name[MAX_PATH];
+    unsigned int len;
+
+    if (!wined3d_get_app_name(app_name, ARRAY_SIZE(app_name)))
+        return FALSE;
+
+    if (!(len = GetEnvironmentVariableA("LOCALAPPDATA", path, size)) || len >= size)
+        return FALSE;
+    if (snprintf(path + len, size - len, "\\wine") >= size - len)
+        return FALSE;
+    CreateDirectoryA(path, NULL);
+    len = strlen(path);
+    if (snprintf(path + len, size - len, "\\wined3d") >= size - len)
+        return FALSE;
+    CreateDirectoryA(path, NULL);
+    len = strlen(path);
+
+    return snprintf(path + len, size - len, "\\%s.%s", app_name, name) < size - len;
+}
+
 static void vkd3d_log_callback(const char *fmt, va_list args)
 {
     char buffer[1024];
@@ -480,6 +507,32 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             TRACE("Forcing all constant buffers to be write-mappable.\n");
             wined3d_settings.cb_access_map_w = TRUE;
         }
+        if (!get_config_key_dword(hkey, appkey, env, "AsyncShaderCompile", &tmpvalue))
+        {
+            TRACE("Setting asynchronous shader compilation to %#x.\n", tmpvalue);
+            wined3d_settings.async_shader_compile = !!tmpvalue;
+        }
+        if (!get_config_key_dword(hkey, appkey, env, "GLProgramCache", &tmpvalue))
+        {
+            TRACE("Setting GL program cache to %#x.\n", tmpvalue);
+            wined3d_settings.gl_program_cache = !!tmpvalue;
+        }
+        if (!get_config_key_dword(hkey, appkey, env, "VulkanPipelineCache", &tmpvalue))
+        {
+            TRACE("Setting Vulkan pipeline cache to %#x.\n", tmpvalue);
+            wined3d_settings.vk_pipeline_cache = !!tmpvalue;
+        }
+        if (!get_config_key_dword(hkey, appkey, env, "VulkanPipelineCacheSize", &wined3d_settings.vk_pipeline_cache_size))
+            TRACE("Limiting Vulkan pipeline cache size to %u MiB.\n", wined3d_settings.vk_pipeline_cache_size);
+        if (!get_config_key(hkey, appkey, env, "FrameStatsLog", buffer, size))
+        {
+            size_t len = strlen(buffer) + 1;
+
+            if (!(wined3d_settings.frame_stats_log = heap_alloc(len)))
+                ERR("Failed to allocate frame statistics log path memory.\n");
+            else
+                memcpy(wined3d_settings.frame_stats_log, buffer, len);
+        }
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -539,6 +592,7 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     heap_free(swapchain_state_table.hooks);
 
     heap_free(wined3d_settings.logo);
+    heap_free(wined3d_settings.frame_stats_log);
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
     DeleteCriticalSection(&wined3d_command_cs);
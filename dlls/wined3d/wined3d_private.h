@@ -485,6 +485,11 @@ struct wined3d_settings
     enum wined3d_renderer renderer;
     enum wined3d_shader_backend shader_backend;
     BOOL cb_access_map_w;
+    BOOL async_shader_compile;
+    BOOL gl_program_cache;
+    BOOL vk_pipeline_cache;
+    unsigned int vk_pipeline_cache_size;
+    char *frame_stats_log;
 };
 
 extern struct wined3d_settings wined3d_settings;
@@ -1955,7 +1960,8 @@ struct wined3d_context
     DWORD destroyed : 1;
     DWORD destroy_delayed : 1;
     DWORD namedArraysLoaded : 1;
-    DWORD padding : 5;
+    DWORD shaders_pending : 1;
+    DWORD padding : 4;
 
     DWORD clip_distance_mask : 8; /* WINED3D_MAX_CLIP_DISTANCES, 8 */
 
@@ -2791,6 +2797,7 @@ BOOL wined3d_get_inside_mode_change(HWND window);
 BOOL wined3d_set_inside_mode_change(HWND window, BOOL inside_mode_change);
 
 BOOL wined3d_get_app_name(char *app_name, unsigned int app_name_size);
+BOOL wined3d_get_cache_path(const char *name, char *path, unsigned int size);
 
 enum wined3d_push_constants
 {
@@ -3579,7 +3586,13 @@ C_ASSERT(!(WINED3D_CS_QUEUE_SIZE & (WINED3D_CS_QUEUE_SIZE - 1)));
 
 struct wined3d_cs_queue
 {
-    ULONG head, tail;
+    ULONG head;
+    /* The producer's copy of "tail". It's only refreshed when the queue looks
+     * full, so that the common case doesn't touch the consumer's cache line. */
+    ULONG cached_tail;
+    BYTE head_padding[64 - 2 * sizeof(ULONG)];
+    ULONG tail;
+    BYTE tail_padding[64 - sizeof(ULONG)];
     BYTE data[WINED3D_CS_QUEUE_SIZE];
 };
 
@@ -3626,6 +3639,8 @@ struct wined3d_cs
     LONG waiting_for_event;
     LONG waiting_for_present;
     LONG pending_presents;
+
+    struct wined3d_cs_stats *stats;
 };
 
 static inline void wined3d_device_context_lock(struct wined3d_device_context *context)
@@ -4009,6 +4024,8 @@ void wined3d_swapchain_state_restore_from_fullscreen(struct wined3d_swapchain_st
 HRESULT wined3d_swapchain_state_setup_fullscreen(struct wined3d_swapchain_state *state,
         HWND window, int x, int y, int width, int height);
 
+#define WINED3D_SWAPCHAIN_TIMESTAMP_QUERY_COUNT 8
+
 struct wined3d_swapchain_ops
 {
     void (*swapchain_present)(struct wined3d_swapchain *swapchain,
@@ -4037,6 +4054,13 @@ struct wined3d_swapchain
     /* Performance tracking */
     LARGE_INTEGER last_present_time;
     LONG prev_time, frames;
+    struct wined3d_query *timestamp_queries[WINED3D_SWAPCHAIN_TIMESTAMP_QUERY_COUNT];
+    struct wined3d_query *timestamp_disjoint_query;
+    unsigned int timestamp_query_idx;
+    UINT64 timestamp_frequency;
+    UINT64 last_timestamp;
+    UINT64 gpu_frame_time; /* In ns, trails behind by a few frames. */
+    bool no_timestamps;
 
     struct wined3d_swapchain_state state;
     HWND win_handle;
@@ -4045,6 +4069,7 @@ struct wined3d_swapchain
 void wined3d_swapchain_activate(struct wined3d_swapchain *swapchain, BOOL activate);
 void wined3d_swapchain_cleanup(struct wined3d_swapchain *swapchain);
 struct wined3d_output * wined3d_swapchain_get_output(const struct wined3d_swapchain *swapchain);
+void wined3d_swapchain_update_gpu_time(struct wined3d_swapchain *swapchain);
 void swapchain_update_draw_bindings(struct wined3d_swapchain *swapchain);
 void swapchain_set_max_frame_latency(struct wined3d_swapchain *swapchain,
         const struct wined3d_device *device);
@@ -185,6 +185,8 @@ struct wined3d_device_vk;
     VK_DEVICE_EXT_PFN(vkCmdBindTransformFeedbackBuffersEXT) \
     VK_DEVICE_EXT_PFN(vkCmdEndQueryIndexedEXT) \
     VK_DEVICE_EXT_PFN(vkCmdEndTransformFeedbackEXT) \
+    /* VK_KHR_push_descriptor */ \
+    VK_DEVICE_EXT_PFN(vkCmdPushDescriptorSetKHR) \
     /* VK_KHR_swapchain */ \
     VK_DEVICE_PFN(vkAcquireNextImageKHR) \
     VK_DEVICE_PFN(vkCreateSwapchainKHR) \
@@ -219,6 +221,8 @@ enum wined3d_vk_extension
     WINED3D_VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE,
     WINED3D_VK_KHR_SHADER_DRAW_PARAMETERS,
     WINED3D_VK_EXT_HOST_QUERY_RESET,
+    WINED3D_VK_EXT_PIPELINE_CREATION_FEEDBACK,
+    WINED3D_VK_KHR_PUSH_DESCRIPTOR,
 
     WINED3D_VK_EXT_COUNT,
 };
@@ -475,6 +479,18 @@ struct wined3d_render_pass_vk
     VkRenderPass vk_render_pass;
 };
 
+#define WINED3D_FRAMEBUFFER_CACHE_SIZE_VK 16
+
+struct wined3d_framebuffer_vk
+{
+    VkFramebuffer vk_framebuffer;
+    VkRenderPass vk_render_pass;
+    VkImageView vk_views[WINED3D_MAX_RENDER_TARGETS + 1];
+    unsigned int view_count;
+    uint32_t width, height, layer_count;
+    uint64_t command_buffer_id;
+};
+
 struct wined3d_pipeline_layout_key_vk
 {
     VkDescriptorSetLayoutBinding *bindings;
@@ -487,6 +503,7 @@ struct wined3d_pipeline_layout_vk
     struct wined3d_pipeline_layout_key_vk key;
     VkPipelineLayout vk_pipeline_layout;
     VkDescriptorSetLayout vk_set_layout;
+    bool push_descriptors;
 };
 
 struct wined3d_graphics_pipeline_key_vk
@@ -569,6 +586,7 @@ struct wined3d_context_vk
         VkPipeline vk_pipeline;
         VkPipelineLayout vk_pipeline_layout;
         VkDescriptorSetLayout vk_set_layout;
+        bool push_descriptors;
         struct wined3d_shader_resource_bindings bindings;
     } graphics;
 
@@ -577,6 +595,7 @@ struct wined3d_context_vk
         VkPipeline vk_pipeline;
         VkPipelineLayout vk_pipeline_layout;
         VkDescriptorSetLayout vk_set_layout;
+        bool push_descriptors;
         struct wined3d_shader_resource_bindings bindings;
     } compute;
 
@@ -596,6 +615,8 @@ struct wined3d_context_vk
 
     VkFramebuffer vk_framebuffer;
     VkRenderPass vk_render_pass;
+    struct wined3d_framebuffer_vk framebuffers[WINED3D_FRAMEBUFFER_CACHE_SIZE_VK];
+    unsigned int next_framebuffer;
 
     SIZE_T vk_descriptor_pools_size;
     SIZE_T vk_descriptor_pool_count;
@@ -696,6 +717,7 @@ struct wined3d_adapter_vk
 
     VkPhysicalDeviceLimits device_limits;
     VkPhysicalDeviceMemoryProperties memory_properties;
+    unsigned int max_push_descriptors;
 };
 
 static inline struct wined3d_adapter_vk *wined3d_adapter_vk(struct wined3d_adapter *adapter)
@@ -800,6 +822,11 @@ struct wined3d_device_vk
     struct wined3d_allocator allocator;
 
     struct wined3d_uav_clear_state_vk uav_clear_state;
+
+    VkPipelineCache vk_pipeline_cache;
+    size_t pipeline_cache_size;
+    unsigned int pipeline_cache_hits;
+    unsigned int pipeline_cache_misses;
 };
 
 static inline struct wined3d_device_vk *wined3d_device_vk(struct wined3d_device *device)
@@ -830,6 +857,8 @@ void wined3d_device_vk_destroy_null_resources(struct wined3d_device_vk *device_v
         struct wined3d_context_vk *context_vk);
 void wined3d_device_vk_destroy_null_views(struct wined3d_device_vk *device_vk,
         struct wined3d_context_vk *context_vk);
+void wined3d_device_vk_pipeline_feedback(struct wined3d_device_vk *device_vk,
+        const VkPipelineCreationFeedbackEXT *feedback);
 
 void wined3d_device_vk_uav_clear_state_init(struct wined3d_device_vk *device_vk);
 void wined3d_device_vk_uav_clear_state_cleanup(struct wined3d_device_vk *device_vk);
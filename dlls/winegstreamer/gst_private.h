@@ -93,6 +93,7 @@ bool wg_parser_stream_get_buffer(wg_parser_t parser, wg_parser_stream_t stream,
 bool wg_parser_stream_copy_buffer(wg_parser_stream_t stream,
         void *data, uint32_t offset, uint32_t size);
 void wg_parser_stream_release_buffer(wg_parser_stream_t stream);
+HRESULT wg_parser_stream_provide_sample(wg_parser_stream_t stream, struct wg_sample *sample);
 void wg_parser_stream_notify_qos(wg_parser_stream_t stream,
         bool underflow, double proportion, int64_t diff, uint64_t timestamp);
 
@@ -262,6 +262,22 @@ void wg_parser_stream_release_buffer(wg_parser_stream_t stream)
     WINE_UNIX_CALL(unix_wg_parser_stream_release_buffer, &stream);
 }
 
+HRESULT wg_parser_stream_provide_sample(wg_parser_stream_t stream, struct wg_sample *sample)
+{
+    struct wg_parser_stream_provide_sample_params params =
+    {
+        .stream = stream,
+        .sample = sample,
+    };
+    NTSTATUS status;
+
+    TRACE("stream %#I64x, sample %p.\n", stream, sample);
+
+    if ((status = WINE_UNIX_CALL(unix_wg_parser_stream_provide_sample, &params)))
+        return HRESULT_FROM_NT(status);
+    return S_OK;
+}
+
 void wg_parser_stream_notify_qos(wg_parser_stream_t stream,
         bool underflow, double proportion, int64_t diff, uint64_t timestamp)
 {
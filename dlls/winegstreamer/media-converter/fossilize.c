@@ -34,6 +34,8 @@
 
 #include "media-converter.h"
 
+#include <sys/mman.h>
+
 /* Fossilize StreamArchive database format version 6:
  *
  * The file consists of a header, followed by an unlimited series of "entries".
@@ -63,6 +65,33 @@
  * The flags field may contain:
  *     0x1: No compression.
  *     0x2: Deflate compression.
+ *
+ *
+ * To avoid reading every entry header on startup, the location of the entries is also kept in
+ * a side index, stored next to the database with an ".idx" suffix. The index is private to this
+ * implementation and is rebuilt from the database whenever it doesn't match it. It consists of a
+ * header, followed by "count" records, in native byte order:
+ *
+ * Field           Type                    Description
+ * -----           ----                    -----------
+ * magic_number    uint8_t[8]              Constant value: "FOZINDEX"
+ * version         uint32_t                Index version: 1
+ * num_tags        uint32_t                Number of tags of the database.
+ * inode           uint64_t                Inode of the database file.
+ * db_size         uint64_t                Size of the database covered by the index.
+ * count           uint64_t                Number of records.
+ *
+ * Each record is:
+ *
+ * Field           Type                    Description
+ * -----           ----                    -----------
+ * tag             uint32_t                Entry tag.
+ * hash            uint32_t[4]             Entry hash.
+ * header          uint32_t[4]             Entry payload header, as in the database.
+ * offset          uint64_t                Offset of the payload in the database.
+ *
+ * Entries found in the database beyond db_size, which were written by someone else, are scanned
+ * and appended to the index when the database is opened.
  */
 
 #define FOZDB_MIN_COMPAT_VERSION  5
@@ -77,6 +106,10 @@
 
 static const uint8_t FOZDB_MAGIC[] = {0x81, 'F', 'O', 'S', 'S', 'I', 'L', 'I', 'Z', 'E', 'D', 'B'};
 
+#define FOZDB_INDEX_VERSION 1
+
+static const uint8_t FOZDB_INDEX_MAGIC[] = {'F', 'O', 'Z', 'I', 'N', 'D', 'E', 'X'};
+
 struct file_header
 {
     uint8_t magic[12];
@@ -101,6 +134,24 @@ struct payload_entry
     uint64_t offset;
 };
 
+struct index_header
+{
+    uint8_t magic[8];
+    uint32_t version;
+    uint32_t num_tags;
+    uint64_t inode;
+    uint64_t db_size;
+    uint64_t count;
+} __attribute__((packed));
+
+struct index_record
+{
+    uint32_t tag;
+    struct payload_hash hash;
+    struct payload_header header;
+    uint64_t offset;
+} __attribute__((packed));
+
 static guint hash_func(gconstpointer key)
 {
     const struct payload_hash *payload_hash = key;
@@ -254,6 +305,138 @@ static bool fozdb_seek_to_next_entry(struct fozdb *db, struct payload_header *he
     return true;
 }
 
+static void fozdb_open_index(struct fozdb *db)
+{
+    size_t len = strlen(db->file_name);
+    char *index_name;
+
+    db->index_file = -1;
+    if (!(index_name = malloc(len + sizeof(".idx"))))
+        return;
+    memcpy(index_name, db->file_name, len);
+    strcpy(index_name + len, ".idx");
+
+    /* The database may be read-only while its directory isn't; if neither is writable,
+     * a valid index can still be used, it just won't be updated. */
+    if ((db->index_file = open(index_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) >= 0)
+        db->index_writable = true;
+    else if ((db->index_file = open(index_name, O_RDONLY)) < 0)
+        GST_INFO("Not using an index for %s. %s.", db->file_name, strerror(errno));
+
+    free(index_name);
+}
+
+static bool fozdb_index_write_header(struct fozdb *db)
+{
+    struct index_header header;
+    struct stat st;
+
+    if (fstat(db->file, &st) < 0)
+        return false;
+
+    memcpy(header.magic, FOZDB_INDEX_MAGIC, sizeof(FOZDB_INDEX_MAGIC));
+    header.version = FOZDB_INDEX_VERSION;
+    header.num_tags = db->num_tags;
+    header.inode = st.st_ino;
+    header.db_size = db->write_pos;
+    header.count = db->index_count;
+
+    return pwrite(db->index_file, &header, sizeof(header), 0) == sizeof(header);
+}
+
+/* Record an entry; takes effect with the next fozdb_index_write_header(). */
+static void fozdb_index_add(struct fozdb *db, uint32_t tag, const struct payload_entry *entry)
+{
+    struct index_record record;
+
+    if (!db->index_writable)
+        return;
+
+    record.tag = tag;
+    record.hash = entry->hash;
+    record.header = entry->header;
+    record.offset = entry->offset;
+
+    if (pwrite(db->index_file, &record, sizeof(record),
+            sizeof(struct index_header) + db->index_count * sizeof(record)) != sizeof(record))
+    {
+        GST_WARNING("Failed to write index of %s. %s.", db->file_name, strerror(errno));
+        db->index_writable = false;
+        return;
+    }
+    db->index_count++;
+}
+
+static bool fozdb_index_check_record(struct fozdb *db, const struct index_record *record)
+{
+    uint8_t entry_name_and_header[ENTRY_NAME_SIZE + sizeof(struct payload_header)];
+    struct payload_header header;
+    struct payload_hash hash;
+    uint32_t tag;
+
+    if (record->offset < sizeof(entry_name_and_header)
+            || pread(db->file, entry_name_and_header, sizeof(entry_name_and_header),
+            record->offset - sizeof(entry_name_and_header)) != sizeof(entry_name_and_header))
+        return false;
+    if (!tag_from_ascii_bytes(&tag, entry_name_and_header)
+            || !hash_from_ascii_bytes(&hash, entry_name_and_header + sizeof(tag) * 2))
+        return false;
+    payload_header_from_bytes(&header, entry_name_and_header + ENTRY_NAME_SIZE);
+
+    return tag == record->tag && !memcmp(&hash, &record->hash, sizeof(hash))
+            && !memcmp(&header, &record->header, sizeof(header));
+}
+
+/* Fill seen_blobs from the index, if it matches the database. */
+static bool fozdb_load_index(struct fozdb *db, uint64_t file_size)
+{
+    const struct index_header *header;
+    const struct index_record *records;
+    uint64_t index_size, i;
+    struct stat st;
+    bool ret = false;
+    void *map;
+
+    if (db->index_file < 0 || !get_file_size(db->index_file, &index_size)
+            || index_size < sizeof(*header) || fstat(db->file, &st) < 0)
+        return false;
+
+    if ((map = mmap(NULL, index_size, PROT_READ, MAP_PRIVATE, db->index_file, 0)) == MAP_FAILED)
+        return false;
+    header = map;
+    records = (const struct index_record *)(header + 1);
+
+    if (memcmp(header->magic, FOZDB_INDEX_MAGIC, sizeof(FOZDB_INDEX_MAGIC))
+            || header->version != FOZDB_INDEX_VERSION || header->num_tags != db->num_tags
+            || header->inode != st.st_ino || !header->count
+            || header->db_size < db->write_pos || header->db_size > file_size
+            || header->count > (index_size - sizeof(*header)) / sizeof(*records)
+            || !fozdb_index_check_record(db, &records[header->count - 1]))
+        goto done;
+
+    for (i = 0; i < header->count; ++i)
+    {
+        struct payload_entry *entry;
+
+        if (records[i].tag >= db->num_tags)
+            continue;
+        entry = calloc(1, sizeof(*entry));
+        entry->hash = records[i].hash;
+        entry->header = records[i].header;
+        entry->offset = records[i].offset;
+        g_hash_table_insert(db->seen_blobs[records[i].tag], &entry->hash, entry);
+    }
+
+    GST_INFO("Loaded %"PRIu64" entries of %s from its index.", header->count, db->file_name);
+    db->index_count = header->count;
+    db->write_pos = header->db_size;
+    ret = true;
+
+done:
+    munmap(map, index_size);
+    return ret;
+}
+
 static bool fozdb_write_entry_name(struct fozdb *db, uint32_t tag, struct payload_hash *hash)
 {
     uint8_t entry_name[ENTRY_NAME_SIZE];
@@ -365,6 +548,7 @@ int fozdb_create(const char *file_name, int open_flags, bool read_only, uint32_t
     db->file_name = file_name;
     db->num_tags = num_tags;
     db->read_only = read_only;
+    fozdb_open_index(db);
 
     /* Create entry hash tables. */
     db->seen_blobs = calloc(num_tags, sizeof(*db->seen_blobs));
@@ -394,6 +578,8 @@ void fozdb_release(struct fozdb *db)
     for (i = 0; i < db->num_tags; ++i)
         g_hash_table_destroy(db->seen_blobs[i]);
     free(db->seen_blobs);
+    if (db->index_file >= 0)
+        close(db->index_file);
     close(db->file);
     free(db);
 }
@@ -428,6 +614,9 @@ int fozdb_prepare(struct fozdb *db)
         }
         db->write_pos = sizeof(file_header);
 
+        db->index_count = 0;
+        if (db->index_writable)
+            fozdb_index_write_header(db);
         return CONV_OK;
     }
 
@@ -436,6 +625,11 @@ int fozdb_prepare(struct fozdb *db)
         return ret;
     db->write_pos = lseek(db->file, 0, SEEK_CUR);
 
+    /* Only scan what the index doesn't cover. */
+    db->index_count = 0;
+    if (fozdb_load_index(db, file_size) && lseek(db->file, db->write_pos, SEEK_SET) < 0)
+        return CONV_ERROR_SEEK_FAILED;
+
     /* Read entries to seen_blobs. */
     while (db->write_pos < file_size)
     {
@@ -468,8 +662,12 @@ int fozdb_prepare(struct fozdb *db)
         table_entry = calloc(1, sizeof(*table_entry));
         *table_entry = entry;
         g_hash_table_insert(db->seen_blobs[tag], &table_entry->hash, table_entry);
+        fozdb_index_add(db, tag, &entry);
     }
 
+    if (db->index_writable && !fozdb_index_write_header(db))
+        GST_WARNING("Failed to write index header of %s.", db->file_name);
+
     return CONV_OK;
 }
 
@@ -524,11 +722,8 @@ int fozdb_read_entry_data(struct fozdb *db, uint32_t tag, struct payload_hash *h
     if (offset >= entry->header.full_size)
         return CONV_OK;
 
-    if (lseek(db->file, entry->offset + offset, SEEK_SET) < 0)
-        return CONV_ERROR_SEEK_FAILED;
-
     to_copy = min(entry->header.full_size - offset, size);
-    if (!complete_read(db->file, buffer, to_copy))
+    if (pread(db->file, buffer, to_copy, entry->offset + offset) != to_copy)
     {
         GST_ERROR("Failed to read entry data.");
         return CONV_ERROR_READ_FAILED;
@@ -641,6 +836,10 @@ int fozdb_write_entry(struct fozdb *db, uint32_t tag, struct payload_hash *hash,
     entry->offset = offset;
     g_hash_table_insert(db->seen_blobs[tag], &entry->hash, entry);
 
+    fozdb_index_add(db, tag, entry);
+    if (db->index_writable)
+        fozdb_index_write_header(db);
+
     GST_INFO("Wrote entry: tag %u, hash %s, offset %#"PRIx64", size %#x, crc %#x.",
             tag, format_hash(&entry->hash), entry->offset, entry->header.size, entry->header.crc);
 
@@ -718,5 +917,10 @@ int fozdb_discard_entries(struct fozdb *db, GList *to_discard_names)
         return CONV_ERROR;
     }
 
+    /* Entries have moved, rebuild the index from scratch. */
+    db->index_count = 0;
+    if (db->index_writable)
+        fozdb_index_write_header(db);
+
     return fozdb_prepare(db);
 }
@@ -113,6 +113,9 @@ struct fozdb
     uint64_t write_pos;
     GHashTable **seen_blobs;
     uint32_t num_tags;
+    int index_file;
+    bool index_writable;
+    uint64_t index_count;
 };
 
 /* lib.c. */
@@ -142,6 +142,10 @@ struct media_stream
 
     DWORD busy;
     CONDITION_VARIABLE cond;
+
+    /* samples lent to the parser, for it to decode into */
+    IMFSample *samples[2];
+    struct wg_sample *wg_samples[2];
 };
 
 enum source_async_op
@@ -745,35 +749,125 @@ static HRESULT media_source_stop(struct media_source *source)
     return IMFMediaEventQueue_QueueEventParamVar(source->event_queue, MESourceStopped, &GUID_NULL, S_OK, NULL);
 }
 
+static void media_stream_free_sample(struct media_stream *stream, unsigned int i)
+{
+    wg_sample_release(stream->wg_samples[i]);
+    stream->wg_samples[i] = NULL;
+    IMFSample_Release(stream->samples[i]);
+    stream->samples[i] = NULL;
+}
+
+/* Make sure the parser has samples of the given size to decode the next buffers into. */
+static void media_stream_provide_samples(struct media_stream *stream, DWORD size)
+{
+    IMFMediaBuffer *buffer;
+    IMFSample *sample;
+    unsigned int i;
+    HRESULT hr;
+
+    for (i = 0; i < ARRAY_SIZE(stream->samples); i++)
+    {
+        if (stream->wg_samples[i])
+        {
+            /* the parser is still holding it */
+            if (InterlockedOr(&stream->wg_samples[i]->refcount, 0))
+                continue;
+            if (stream->wg_samples[i]->max_size >= size)
+            {
+                if (FAILED(hr = wg_parser_stream_provide_sample(stream->wg_stream, stream->wg_samples[i])))
+                    WARN("Failed to provide sample, hr %#lx\n", hr);
+                continue;
+            }
+            media_stream_free_sample(stream, i);
+        }
+
+        if (FAILED(hr = MFCreateMemoryBuffer(size, &buffer)))
+            return;
+        if (FAILED(hr = MFCreateSample(&sample)))
+        {
+            IMFMediaBuffer_Release(buffer);
+            return;
+        }
+        hr = IMFSample_AddBuffer(sample, buffer);
+        IMFMediaBuffer_Release(buffer);
+        if (FAILED(hr) || FAILED(hr = wg_sample_create_mf(sample, &stream->wg_samples[i])))
+        {
+            IMFSample_Release(sample);
+            return;
+        }
+        stream->samples[i] = sample;
+
+        if (FAILED(hr = wg_parser_stream_provide_sample(stream->wg_stream, stream->wg_samples[i])))
+            WARN("Failed to provide sample, hr %#lx\n", hr);
+    }
+}
+
+static void media_stream_release_samples(struct media_stream *stream)
+{
+    unsigned int i;
+
+    wg_parser_stream_provide_sample(stream->wg_stream, NULL);
+    for (i = 0; i < ARRAY_SIZE(stream->samples); i++)
+        if (stream->samples[i])
+            media_stream_free_sample(stream, i);
+}
+
 static HRESULT media_stream_send_sample(struct media_stream *stream, const struct wg_parser_buffer *wg_buffer, IUnknown *token)
 {
     IMFSample *sample = NULL;
     IMFMediaBuffer *buffer;
+    unsigned int i;
     HRESULT hr;
     BYTE *data;
 
-    if (FAILED(hr = MFCreateMemoryBuffer(wg_buffer->size, &buffer)))
-        return hr;
-    if (FAILED(hr = IMFMediaBuffer_SetCurrentLength(buffer, wg_buffer->size)))
-        goto out;
-    if (FAILED(hr = IMFMediaBuffer_Lock(buffer, &data, NULL, NULL)))
-        goto out;
+    for (i = 0; i < ARRAY_SIZE(stream->samples); i++)
+        if (stream->wg_samples[i] && wg_buffer->sample == (UINT_PTR)stream->wg_samples[i])
+            break;
 
-    if (!wg_parser_stream_copy_buffer(stream->wg_stream, data, 0, wg_buffer->size))
+    if (i < ARRAY_SIZE(stream->samples))
     {
+        /* the parser decoded the buffer straight into one of our samples */
         wg_parser_stream_release_buffer(stream->wg_stream);
-        IMFMediaBuffer_Unlock(buffer);
-        goto out;
+
+        IMFSample_AddRef((sample = stream->samples[i]));
+        media_stream_free_sample(stream, i);
+
+        if (FAILED(hr = IMFSample_GetBufferByIndex(sample, 0, &buffer)))
+            goto out;
+        hr = IMFMediaBuffer_SetCurrentLength(buffer, wg_buffer->size);
+        IMFMediaBuffer_Release(buffer);
+        if (FAILED(hr))
+            goto out;
     }
-    wg_parser_stream_release_buffer(stream->wg_stream);
+    else
+    {
+        if (FAILED(hr = MFCreateMemoryBuffer(wg_buffer->size, &buffer)))
+            return hr;
+        if (FAILED(hr = IMFMediaBuffer_SetCurrentLength(buffer, wg_buffer->size)))
+            goto out_buffer;
+        if (FAILED(hr = IMFMediaBuffer_Lock(buffer, &data, NULL, NULL)))
+            goto out_buffer;
 
-    if (FAILED(hr = IMFMediaBuffer_Unlock(buffer)))
-        goto out;
+        if (!wg_parser_stream_copy_buffer(stream->wg_stream, data, 0, wg_buffer->size))
+        {
+            wg_parser_stream_release_buffer(stream->wg_stream);
+            IMFMediaBuffer_Unlock(buffer);
+            IMFMediaBuffer_Release(buffer);
+            return hr;
+        }
+        wg_parser_stream_release_buffer(stream->wg_stream);
+
+        if (FAILED(hr = IMFMediaBuffer_Unlock(buffer)))
+            goto out_buffer;
+
+        if (SUCCEEDED(hr = MFCreateSample(&sample)))
+            hr = IMFSample_AddBuffer(sample, buffer);
+out_buffer:
+        IMFMediaBuffer_Release(buffer);
+        if (FAILED(hr))
+            goto out;
+    }
 
-    if (FAILED(hr = MFCreateSample(&sample)))
-        goto out;
-    if (FAILED(hr = IMFSample_AddBuffer(sample, buffer)))
-        goto out;
     if (FAILED(hr = IMFSample_SetSampleTime(sample, wg_buffer->pts)))
         goto out;
     if (FAILED(hr = IMFSample_SetSampleDuration(sample, wg_buffer->duration)))
@@ -781,13 +875,13 @@ static HRESULT media_stream_send_sample(struct media_stream *stream, const struc
     if (token && FAILED(hr = IMFSample_SetUnknown(sample, &MFSampleExtension_Token, token)))
         goto out;
 
-    hr = IMFMediaEventQueue_QueueEventParamUnk(stream->event_queue, MEMediaSample,
-            &GUID_NULL, S_OK, (IUnknown *)sample);
+    if (SUCCEEDED(hr = IMFMediaEventQueue_QueueEventParamUnk(stream->event_queue, MEMediaSample,
+            &GUID_NULL, S_OK, (IUnknown *)sample)))
+        media_stream_provide_samples(stream, wg_buffer->size);
 
 out:
     if (sample)
         IMFSample_Release(sample);
-    IMFMediaBuffer_Release(buffer);
     return hr;
 }
 
@@ -1620,6 +1714,7 @@ static HRESULT WINAPI media_source_Shutdown(IMFMediaSource *iface)
         wg_parser_stream_disable(stream->wg_stream);
         while (stream->busy)
             SleepConditionVariableCS(&stream->cond, &source->cs, INFINITE);
+        media_stream_release_samples(stream);
     }
 
     wg_parser_disconnect(source->wg_parser);
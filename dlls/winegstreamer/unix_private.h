@@ -92,6 +92,9 @@ typedef struct wg_sample *(*wg_allocator_request_sample_cb)(gsize size, void *co
 extern GstAllocator *wg_allocator_create(void);
 extern void wg_allocator_destroy(GstAllocator *allocator);
 extern void wg_allocator_provide_sample(GstAllocator *allocator, struct wg_sample *sample);
+extern bool wg_allocator_queue_sample(GstAllocator *allocator, struct wg_sample *sample);
+extern struct wg_sample *wg_allocator_get_buffer_sample(GstAllocator *allocator, GstBuffer *buffer);
+extern void wg_allocator_release_samples(GstAllocator *allocator);
 extern void wg_allocator_release_sample(GstAllocator *allocator, struct wg_sample *sample,
         bool discard_data);
 
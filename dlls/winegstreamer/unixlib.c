@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #define GLIB_VERSION_MIN_REQUIRED GLIB_VERSION_2_30
 #include <gst/gst.h>
@@ -130,19 +131,61 @@ done:
     return factories;
 }
 
+static bool factory_is_hardware(GstElementFactory *factory)
+{
+    const gchar *klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+    return klass && strstr(klass, "Hardware");
+}
+
+static gint hardware_rank_compare(gconstpointer a, gconstpointer b)
+{
+    bool hardware_a = factory_is_hardware(GST_ELEMENT_FACTORY(a));
+    bool hardware_b = factory_is_hardware(GST_ELEMENT_FACTORY(b));
+
+    if (hardware_a != hardware_b)
+        return hardware_a ? -1 : 1;
+    return gst_plugin_feature_rank_compare_func(a, b);
+}
+
+/* Hardware decoders (VA-API, V4L2, NVDEC...) are usually registered with no rank and are never
+ * autoplugged. WINE_GST_HW_DECODE=1 lets decoders pick them first, whatever their rank. */
+static bool use_hardware_decoders(void)
+{
+    static int enabled = -1;
+    const char *e;
+
+    if (enabled == -1)
+        enabled = (e = getenv("WINE_GST_HW_DECODE")) && *e == '1';
+    return enabled;
+}
+
 GstElement *find_element(GstElementFactoryListType type, GstCaps *element_sink_caps, GstCaps *element_src_caps)
 {
+    GstRank min_rank = GST_RANK_MARGINAL;
+    bool hardware = false;
     GstElement *element = NULL;
     GList *tmp, *transforms;
     const gchar *name;
 
-    if (!(transforms = find_element_factories(type, GST_RANK_MARGINAL, element_sink_caps, element_src_caps)))
+    if ((type & GST_ELEMENT_FACTORY_TYPE_DECODER) && use_hardware_decoders())
+    {
+        hardware = true;
+        min_rank = GST_RANK_NONE;
+    }
+
+    if (!(transforms = find_element_factories(type, min_rank, element_sink_caps, element_src_caps)))
         return NULL;
+    if (hardware)
+        transforms = g_list_sort(transforms, hardware_rank_compare);
 
     for (tmp = transforms; tmp != NULL && element == NULL; tmp = tmp->next)
     {
         name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(tmp->data));
 
+        if (hardware && !factory_is_hardware(GST_ELEMENT_FACTORY(tmp->data))
+                && gst_plugin_feature_get_rank(GST_PLUGIN_FEATURE(tmp->data)) < GST_RANK_MARGINAL)
+            continue;
+
         if (!strcmp(name, "vaapidecodebin"))
         {
             /* vaapidecodebin adds asynchronicity which breaks wg_transform synchronous drain / flush
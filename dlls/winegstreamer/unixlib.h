@@ -201,11 +201,12 @@ struct wg_parser_buffer
 {
     /* pts and duration are in 100-nanosecond units. */
     UINT64 pts, duration;
+    UINT64 sample; /* provided sample the data was decoded into, if any */
     UINT32 size;
     UINT32 stream;
     UINT8 discontinuity, preroll, delta, has_pts, has_duration;
 };
-C_ASSERT(sizeof(struct wg_parser_buffer) == 32);
+C_ASSERT(sizeof(struct wg_parser_buffer) == 40);
 
 typedef UINT32 wg_parser_type;
 enum wg_parser_type
@@ -308,6 +309,12 @@ struct wg_parser_stream_copy_buffer_params
     UINT32 size;
 };
 
+struct wg_parser_stream_provide_sample_params
+{
+    wg_parser_stream_t stream;
+    struct wg_sample *sample;
+};
+
 struct wg_parser_stream_notify_qos_params
 {
     wg_parser_stream_t stream;
@@ -450,6 +457,7 @@ enum unix_funcs
     unix_wg_parser_stream_get_buffer,
     unix_wg_parser_stream_copy_buffer,
     unix_wg_parser_stream_release_buffer,
+    unix_wg_parser_stream_provide_sample,
     unix_wg_parser_stream_notify_qos,
 
     unix_wg_parser_stream_get_duration,
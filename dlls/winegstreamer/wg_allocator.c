@@ -56,7 +56,9 @@ typedef struct
     pthread_cond_t release_cond;
     struct list memory_list;
 
-    struct wg_sample *next_sample;
+    /* samples to use for the next allocations, in order */
+    struct wg_sample *next_samples[4];
+    unsigned int next_sample_count;
 } WgAllocator;
 
 typedef struct
@@ -195,8 +197,12 @@ static GstMemory *wg_allocator_alloc(GstAllocator *gst_allocator, gsize size,
 
     pthread_mutex_lock(&allocator->mutex);
 
-    memory->sample = allocator->next_sample;
-    allocator->next_sample = NULL;
+    if (allocator->next_sample_count)
+    {
+        memory->sample = allocator->next_samples[0];
+        memmove(allocator->next_samples, allocator->next_samples + 1,
+                --allocator->next_sample_count * sizeof(*allocator->next_samples));
+    }
 
     if (memory->sample && memory->sample->max_size < size)
         release_memory_sample(allocator, memory, true);
@@ -266,6 +272,8 @@ void wg_allocator_destroy(GstAllocator *gst_allocator)
     pthread_mutex_lock(&allocator->mutex);
     LIST_FOR_EACH_ENTRY(memory, &allocator->memory_list, WgMemory, entry)
         release_memory_sample(allocator, memory, true);
+    while (allocator->next_sample_count)
+        InterlockedDecrement(&allocator->next_samples[--allocator->next_sample_count]->refcount);
     pthread_mutex_unlock(&allocator->mutex);
 
     g_object_unref(allocator);
@@ -287,7 +295,6 @@ static WgMemory *find_sample_memory(WgAllocator *allocator, struct wg_sample *sa
 void wg_allocator_provide_sample(GstAllocator *gst_allocator, struct wg_sample *sample)
 {
     WgAllocator *allocator = (WgAllocator *)gst_allocator;
-    struct wg_sample *previous;
 
     GST_LOG("allocator %p, sample %p", allocator, sample);
 
@@ -295,12 +302,66 @@ void wg_allocator_provide_sample(GstAllocator *gst_allocator, struct wg_sample *
         InterlockedIncrement(&sample->refcount);
 
     pthread_mutex_lock(&allocator->mutex);
-    previous = allocator->next_sample;
-    allocator->next_sample = sample;
+    while (allocator->next_sample_count)
+        InterlockedDecrement(&allocator->next_samples[--allocator->next_sample_count]->refcount);
+    if (sample)
+        allocator->next_samples[allocator->next_sample_count++] = sample;
     pthread_mutex_unlock(&allocator->mutex);
+}
+
+bool wg_allocator_queue_sample(GstAllocator *gst_allocator, struct wg_sample *sample)
+{
+    WgAllocator *allocator = (WgAllocator *)gst_allocator;
+    bool ret = false;
 
-    if (previous)
-        InterlockedDecrement(&previous->refcount);
+    GST_LOG("allocator %p, sample %p", allocator, sample);
+
+    pthread_mutex_lock(&allocator->mutex);
+    if (allocator->next_sample_count < ARRAY_SIZE(allocator->next_samples))
+    {
+        InterlockedIncrement(&sample->refcount);
+        allocator->next_samples[allocator->next_sample_count++] = sample;
+        ret = true;
+    }
+    pthread_mutex_unlock(&allocator->mutex);
+
+    return ret;
+}
+
+struct wg_sample *wg_allocator_get_buffer_sample(GstAllocator *gst_allocator, GstBuffer *buffer)
+{
+    WgAllocator *allocator = (WgAllocator *)gst_allocator;
+    struct wg_sample *sample = NULL;
+    GstMemory *gst_memory;
+
+    if (gst_buffer_n_memory(buffer) != 1)
+        return NULL;
+    gst_memory = gst_buffer_peek_memory(buffer, 0);
+    while (gst_memory->parent)
+        gst_memory = gst_memory->parent;
+    if (gst_memory->allocator != gst_allocator)
+        return NULL;
+
+    pthread_mutex_lock(&allocator->mutex);
+    sample = ((WgMemory *)gst_memory)->sample;
+    pthread_mutex_unlock(&allocator->mutex);
+
+    return sample;
+}
+
+void wg_allocator_release_samples(GstAllocator *gst_allocator)
+{
+    WgAllocator *allocator = (WgAllocator *)gst_allocator;
+    WgMemory *memory;
+
+    GST_LOG("allocator %p", allocator);
+
+    pthread_mutex_lock(&allocator->mutex);
+    while (allocator->next_sample_count)
+        InterlockedDecrement(&allocator->next_samples[--allocator->next_sample_count]->refcount);
+    LIST_FOR_EACH_ENTRY(memory, &allocator->memory_list, WgMemory, entry)
+        release_memory_sample(allocator, memory, false);
+    pthread_mutex_unlock(&allocator->mutex);
 }
 
 void wg_allocator_release_sample(GstAllocator *gst_allocator, struct wg_sample *sample,
@@ -125,6 +125,11 @@ struct wg_parser_stream
     GstBuffer *buffer;
     GstMapInfo map_info;
 
+    /* Raw output is allocated from PE samples lent with
+     * wg_parser_stream_provide_sample(), whenever there is one to use. */
+    GstAllocator *allocator;
+    bool samples_provided;
+
     bool flushing, eos, enabled, has_caps, has_tags, has_buffer, no_more_pads;
 
     uint64_t duration;
@@ -309,6 +314,7 @@ static NTSTATUS wg_parser_stream_get_buffer(void *args)
     struct wg_parser_buffer *wg_buffer = params->buffer;
     struct wg_parser_stream *stream = get_stream(params->stream);
     struct wg_parser *parser = get_parser(params->parser);
+    struct wg_sample *sample;
     GstBuffer *buffer;
     unsigned int i;
 
@@ -370,6 +376,11 @@ static NTSTATUS wg_parser_stream_get_buffer(void *args)
     wg_buffer->delta = GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
     wg_buffer->size = gst_buffer_get_size(buffer);
     wg_buffer->stream = stream->number;
+    if ((sample = wg_allocator_get_buffer_sample(stream->allocator, buffer))
+            && stream->map_info.data == wg_sample_data(sample))
+        wg_buffer->sample = (UINT_PTR)sample;
+    else
+        wg_buffer->sample = 0;
 
     pthread_mutex_unlock(&parser->mutex);
     return S_OK;
@@ -393,7 +404,9 @@ static NTSTATUS wg_parser_stream_copy_buffer(void *args)
 
     assert(offset < stream->map_info.size);
     assert(offset + size <= stream->map_info.size);
-    memcpy(params->data, stream->map_info.data + offset, size);
+    /* the data was already decoded into the caller's sample */
+    if (params->data != stream->map_info.data + offset)
+        memcpy(params->data, stream->map_info.data + offset, size);
 
     pthread_mutex_unlock(&parser->mutex);
     return S_OK;
@@ -403,18 +416,66 @@ static NTSTATUS wg_parser_stream_release_buffer(void *args)
 {
     struct wg_parser_stream *stream = get_stream(*(wg_parser_stream_t *)args);
     struct wg_parser *parser = stream->parser;
+    struct wg_sample *sample;
+    GstBuffer *buffer;
+    bool discard_data;
 
     pthread_mutex_lock(&parser->mutex);
 
     assert(stream->buffer);
 
-    gst_buffer_unmap(stream->buffer, &stream->map_info);
-    gst_buffer_unref(stream->buffer);
+    buffer = stream->buffer;
+    gst_buffer_unmap(buffer, &stream->map_info);
     stream->buffer = NULL;
 
     pthread_mutex_unlock(&parser->mutex);
     pthread_cond_signal(&stream->event_empty_cond);
 
+    sample = wg_allocator_get_buffer_sample(stream->allocator, buffer);
+
+    /* As in wg_transform_read_data(), taint the memory so that the buffer pool
+     * doesn't recycle it and allocates the next buffers from the provided samples.
+     * If someone else still holds the buffer, give it its data back instead. */
+    if ((discard_data = stream->samples_provided && gst_buffer_is_writable(buffer)
+            && gst_buffer_n_memory(buffer) == 1
+            && gst_buffer_peek_memory(buffer, 0)->allocator == stream->allocator))
+        gst_buffer_replace_all_memory(buffer, gst_allocator_alloc(NULL, 0, NULL));
+    if (sample)
+        wg_allocator_release_sample(stream->allocator, sample, discard_data);
+
+    gst_buffer_unref(buffer);
+    return S_OK;
+}
+
+static NTSTATUS wg_parser_stream_provide_sample(void *args)
+{
+    const struct wg_parser_stream_provide_sample_params *params = args;
+    struct wg_parser_stream *stream = get_stream(params->stream);
+    struct wg_parser *parser = stream->parser;
+    GstBuffer *buffer;
+
+    if (params->sample)
+    {
+        stream->samples_provided = true;
+        if (!wg_allocator_queue_sample(stream->allocator, params->sample))
+            return STATUS_BUFFER_OVERFLOW;
+        return S_OK;
+    }
+
+    /* Take every sample back, which means giving up on the pending buffer too. */
+    pthread_mutex_lock(&parser->mutex);
+    stream->samples_provided = false;
+    if ((buffer = stream->buffer))
+    {
+        gst_buffer_unmap(buffer, &stream->map_info);
+        stream->buffer = NULL;
+    }
+    pthread_mutex_unlock(&parser->mutex);
+    pthread_cond_signal(&stream->event_empty_cond);
+
+    if (buffer)
+        gst_buffer_unref(buffer);
+    wg_allocator_release_samples(stream->allocator);
     return S_OK;
 }
 
@@ -901,6 +962,25 @@ static gboolean sink_query_cb(GstPad *pad, GstObject *parent, GstQuery *query)
             return TRUE;
         }
 
+        case GST_QUERY_ALLOCATION:
+        {
+            struct wg_format format;
+            gboolean need_pool;
+            GstCaps *caps;
+
+            gst_query_parse_allocation(query, &caps, &need_pool);
+            if (!caps)
+                return FALSE;
+
+            wg_format_from_caps(&format, caps);
+            if (format.major_type != WG_MAJOR_TYPE_VIDEO && format.major_type != WG_MAJOR_TYPE_AUDIO)
+                return FALSE;
+
+            gst_query_add_allocation_param(query, stream->allocator, NULL);
+            GST_INFO("Proposing allocator %p for query %p.", stream->allocator, query);
+            return TRUE;
+        }
+
         default:
             return gst_pad_query_default (pad, parent, query);
     }
@@ -917,6 +997,11 @@ static struct wg_parser_stream *create_stream(struct wg_parser *parser, char *id
 
     if (!(stream = calloc(1, sizeof(*stream))))
         return NULL;
+    if (!(stream->allocator = wg_allocator_create()))
+    {
+        free(stream);
+        return NULL;
+    }
 
     gst_segment_init(&stream->segment, GST_FORMAT_UNDEFINED);
 
@@ -959,6 +1044,8 @@ static void free_stream(struct wg_parser_stream *stream)
         stream->buffer = NULL;
     }
 
+    wg_allocator_destroy(stream->allocator);
+
     pthread_cond_destroy(&stream->event_cond);
     pthread_cond_destroy(&stream->event_empty_cond);
 
@@ -2203,6 +2290,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     X(wg_parser_stream_get_buffer),
     X(wg_parser_stream_copy_buffer),
     X(wg_parser_stream_release_buffer),
+    X(wg_parser_stream_provide_sample),
     X(wg_parser_stream_notify_qos),
 
     X(wg_parser_stream_get_duration),
@@ -2336,6 +2424,21 @@ static NTSTATUS wow64_wg_parser_stream_copy_buffer(void *args)
     return wg_parser_stream_copy_buffer(&params);
 }
 
+static NTSTATUS wow64_wg_parser_stream_provide_sample(void *args)
+{
+    struct
+    {
+        wg_parser_stream_t stream;
+        PTR32 sample;
+    } *params32 = args;
+    struct wg_parser_stream_provide_sample_params params =
+    {
+        .stream = params32->stream,
+        .sample = ULongToPtr(params32->sample),
+    };
+    return wg_parser_stream_provide_sample(&params);
+}
+
 static NTSTATUS wow64_wg_parser_stream_get_tag(void *args)
 {
     struct
@@ -2536,6 +2639,7 @@ const unixlib_entry_t __wine_unix_call_wow64_funcs[] =
     X64(wg_parser_stream_get_buffer),
     X64(wg_parser_stream_copy_buffer),
     X(wg_parser_stream_release_buffer),
+    X64(wg_parser_stream_provide_sample),
     X(wg_parser_stream_notify_qos),
 
     X(wg_parser_stream_get_duration),
@@ -61,6 +61,10 @@ struct wg_transform
     GstSample *output_sample;
     bool output_caps_changed;
     GstCaps *output_caps;
+
+    /* statistics, traced when the transform is destroyed */
+    guint64 input_count, output_count, pending_count, max_delay;
+    GstClockTime process_time;
 };
 
 static struct wg_transform *get_transform(wg_transform_t trans)
@@ -102,9 +106,27 @@ static GstFlowReturn transform_sink_chain_cb(GstPad *pad, GstObject *parent, Gst
 
     gst_atomic_queue_push(transform->output_queue, sample);
     gst_buffer_unref(buffer);
+    transform->output_count++;
+    if (transform->pending_count)
+        transform->pending_count--;
     return GST_FLOW_OK;
 }
 
+static GstFlowReturn push_transform_input(struct wg_transform *transform, GstBuffer *buffer)
+{
+    GstClockTime start = gst_util_get_timestamp();
+    GstFlowReturn ret;
+
+    transform->input_count++;
+    transform->pending_count++;
+    ret = gst_pad_push(transform->my_src, buffer);
+    transform->process_time += gst_util_get_timestamp() - start;
+
+    /* how many buffers the pipeline holds on to before producing output */
+    transform->max_delay = max(transform->max_delay, transform->pending_count);
+    return ret;
+}
+
 static gboolean transform_src_query_latency(struct wg_transform *transform, GstQuery *query)
 {
     GST_LOG("transform %p, query %p", transform, query);
@@ -259,6 +281,11 @@ NTSTATUS wg_transform_destroy(void *args)
     GstSample *sample;
     GstBuffer *buffer;
 
+    GST_INFO("transform %p, %" G_GUINT64_FORMAT " input buffers, %" G_GUINT64_FORMAT " output buffers, "
+            "at most %" G_GUINT64_FORMAT " buffers delay, %" GST_TIME_FORMAT " processing.", transform,
+            transform->input_count, transform->output_count, transform->max_delay,
+            GST_TIME_ARGS(transform->process_time));
+
     while ((buffer = gst_atomic_queue_pop(transform->input_queue)))
         gst_buffer_unref(buffer);
     gst_atomic_queue_unref(transform->input_queue);
@@ -795,7 +822,7 @@ static bool get_transform_output(struct wg_transform *transform, struct wg_sampl
     while (!(transform->output_sample = gst_atomic_queue_pop(transform->output_queue))
             && (input_buffer = gst_atomic_queue_pop(transform->input_queue)))
     {
-        if ((ret = gst_pad_push(transform->my_src, input_buffer)))
+        if ((ret = push_transform_input(transform, input_buffer)))
             GST_WARNING("Failed to push transform input, error %d", ret);
     }
 
@@ -920,7 +947,7 @@ NTSTATUS wg_transform_drain(void *args)
 
     while ((input_buffer = gst_atomic_queue_pop(transform->input_queue)))
     {
-        if ((ret = gst_pad_push(transform->my_src, input_buffer)))
+        if ((ret = push_transform_input(transform, input_buffer)))
             GST_WARNING("Failed to push transform input, error %d", ret);
     }
 
@@ -965,6 +992,9 @@ NTSTATUS wg_transform_flush(void *args)
         gst_sample_unref(sample);
     transform->output_sample = NULL;
 
+    /* whatever was still held has been dropped */
+    transform->pending_count = 0;
+
     return STATUS_SUCCESS;
 }
 
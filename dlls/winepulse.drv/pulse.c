@@ -24,9 +24,11 @@
 #endif
 
 #include <stdarg.h>
+#include <errno.h>
 #include <pthread.h>
 #include <math.h>
 #include <poll.h>
+#include <time.h>
 
 #include <pulse/pulseaudio.h>
 
@@ -77,8 +79,9 @@ struct pulse_stream
     SIZE_T tmp_buffer_bytes, held_bytes, peek_len, peek_buffer_len, pa_held_bytes;
     BYTE *local_buffer, *tmp_buffer, *peek_buffer;
     void *locked_ptr;
-    BOOL please_quit, just_started, just_underran;
+    BOOL please_quit, just_started, just_underran, wake_timer;
     pa_usec_t mmdev_period_usec;
+    UINT32 underruns;
 
     INT64 clock_lastpos, clock_written;
 
@@ -118,6 +121,7 @@ static const REFERENCE_TIME DefaultPeriod = 100000;
 
 static pthread_mutex_t pulse_mutex;
 static pthread_cond_t pulse_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t timer_cond;
 
 static ULONG_PTR zero_bits = 0;
 
@@ -146,6 +150,35 @@ static void pulse_broadcast(void)
     pthread_cond_broadcast(&pulse_cond);
 }
 
+static void get_timer_deadline(const LARGE_INTEGER *delay, struct timespec *deadline)
+{
+    ULONGLONG nsec = -delay->QuadPart * 100;
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    nsec += deadline->tv_nsec;
+    deadline->tv_sec += nsec / 1000000000;
+    deadline->tv_nsec = nsec % 1000000000;
+}
+
+/* Sleep until the deadline of the timer loop, returns TRUE if woken up earlier because
+ * the stream needs attention. Called with the lock held. */
+static BOOL pulse_timer_wait(struct pulse_stream *stream, const struct timespec *deadline)
+{
+    BOOL woken;
+
+    while (!stream->wake_timer && !stream->please_quit)
+        if (pthread_cond_timedwait(&timer_cond, &pulse_mutex, deadline) == ETIMEDOUT) break;
+    woken = stream->wake_timer || stream->please_quit;
+    stream->wake_timer = FALSE;
+    return woken;
+}
+
+static void pulse_wake_timer(struct pulse_stream *stream)
+{
+    stream->wake_timer = TRUE;
+    pthread_cond_broadcast(&timer_cond);
+}
+
 static struct pulse_stream *handle_get_stream(stream_handle h)
 {
     return (struct pulse_stream *)(UINT_PTR)h;
@@ -241,6 +274,7 @@ static int pulse_poll_func(struct pollfd *ufds, unsigned long nfds, int timeout,
 
 static NTSTATUS pulse_process_attach(void *args)
 {
+    pthread_condattr_t cond_attr;
     pthread_mutexattr_t attr;
 
     pthread_mutexattr_init(&attr);
@@ -249,6 +283,11 @@ static NTSTATUS pulse_process_attach(void *args)
     if (pthread_mutex_init(&pulse_mutex, &attr) != 0)
         pthread_mutex_init(&pulse_mutex, NULL);
 
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&timer_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
 #ifdef _WIN64
     if (NtCurrentTeb()->WowTebOffset)
     {
@@ -369,8 +408,10 @@ static void pulse_attr_update(pa_stream *s, void *user) {
 static void pulse_underflow_callback(pa_stream *s, void *userdata)
 {
     struct pulse_stream *stream = userdata;
-    WARN("%p: Underflow\n", userdata);
+    WARN("%p: Underflow, %u so far\n", userdata, ++stream->underruns);
     stream->just_underran = TRUE;
+    /* refill right away instead of leaving the device on silence until the next period */
+    pulse_wake_timer(stream);
 }
 
 static void pulse_started_callback(pa_stream *s, void *userdata)
@@ -1255,7 +1296,10 @@ static NTSTATUS pulse_release_stream(void *args)
     SIZE_T size;
 
     if(params->timer_thread) {
+        pulse_lock();
         stream->please_quit = TRUE;
+        pulse_wake_timer(stream);
+        pulse_unlock();
         NtWaitForSingleObject(params->timer_thread, FALSE, NULL);
         NtClose(params->timer_thread);
     }
@@ -1269,6 +1313,9 @@ static NTSTATUS pulse_release_stream(void *args)
     pa_stream_unref(stream->stream);
     pulse_unlock();
 
+    if (stream->underruns)
+        TRACE("%p: %u underruns\n", stream, stream->underruns);
+
     if (stream->tmp_buffer) {
         size = 0;
         NtFreeVirtualMemory(GetCurrentProcess(), (void **)&stream->tmp_buffer,
@@ -1434,12 +1481,26 @@ static void pulse_write(struct pulse_stream *stream)
     {
         /* prebuffer with silence if needed */
         if(stream->pa_held_bytes < bytes){
+            size_t frame_size = pa_frame_size(&stream->ss), len;
+            void *data;
+
             to_write = bytes - stream->pa_held_bytes;
-            TRACE("prebuffering %u frames of silence\n",
-                    (int)(to_write / pa_frame_size(&stream->ss)));
-            buf = calloc(1, to_write);
-            pa_stream_write(stream->stream, buf, to_write, NULL, 0, PA_SEEK_RELATIVE);
-            free(buf);
+            TRACE("prebuffering %u frames of silence\n", (int)(to_write / frame_size));
+            /* fill the server's own memory block instead of copying from a temporary one */
+            while (to_write)
+            {
+                len = to_write;
+                if (pa_stream_begin_write(stream->stream, &data, &len) < 0)
+                    break;
+                if (!(len = min(len, to_write) / frame_size * frame_size))
+                {
+                    pa_stream_cancel_write(stream->stream);
+                    break;
+                }
+                silence_buffer(stream->ss.format, data, len);
+                pa_stream_write(stream->stream, data, len, NULL, 0, PA_SEEK_RELATIVE);
+                to_write -= len;
+            }
         }
 
         stream->just_underran = FALSE;
@@ -1573,6 +1634,7 @@ static NTSTATUS pulse_timer_loop(void *args)
 {
     struct timer_loop_params *params = args;
     struct pulse_stream *stream = handle_get_stream(params->stream);
+    struct timespec deadline;
     LARGE_INTEGER delay;
     pa_usec_t last_time;
     UINT32 adv_bytes;
@@ -1581,16 +1643,24 @@ static NTSTATUS pulse_timer_loop(void *args)
     pulse_lock();
     delay.QuadPart = -stream->mmdev_period_usec * 10;
     pa_stream_get_time(stream->stream, &last_time);
-    pulse_unlock();
 
     while (!stream->please_quit)
     {
         pa_usec_t now, adv_usec = 0;
+        BOOL resync = FALSE;
         int err;
 
-        NtDelayExecution(FALSE, &delay);
-
-        pulse_lock();
+        get_timer_deadline(&delay, &deadline);
+        while (pulse_timer_wait(stream, &deadline) && !stream->please_quit)
+        {
+            /* PA ran dry, refill it now and restart the period timing on the next tick */
+            if (stream->started && stream->dataflow == eRender)
+            {
+                pulse_write(stream);
+                resync = TRUE;
+            }
+        }
+        if (stream->please_quit) break;
 
         delay.QuadPart = -stream->mmdev_period_usec * 10;
 
@@ -1601,7 +1671,7 @@ static NTSTATUS pulse_timer_loop(void *args)
             TRACE("got now: %s, last time: %s\n", wine_dbgstr_longlong(now), wine_dbgstr_longlong(last_time));
             if (stream->started && (stream->dataflow == eCapture || stream->held_bytes))
             {
-                if(stream->just_underran)
+                if(stream->just_underran || resync)
                 {
                     last_time = now;
                     stream->just_started = TRUE;
@@ -1663,9 +1733,8 @@ static NTSTATUS pulse_timer_loop(void *args)
                 stream, (int)adv_usec,
                 (int)(stream->held_bytes/ pa_frame_size(&stream->ss)),
                 (unsigned int)(-delay.QuadPart / 10));
-
-        pulse_unlock();
     }
+    pulse_unlock();
 
     return STATUS_SUCCESS;
 }
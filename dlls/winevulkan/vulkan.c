@@ -102,6 +102,18 @@ static uint32_t wine_vk_count_struct_(void *s, VkStructureType t)
 
 static const struct vulkan_funcs *vk_funcs;
 
+static int wine_vk_mapping_compare(const void *key, const struct rb_entry *entry)
+{
+    const struct wine_vk_mapping *a = key, *b = RB_ENTRY_VALUE(entry, struct wine_vk_mapping, entry);
+
+    /* Non-dispatchable host handles aren't necessarily unique. */
+    if (a->host_handle != b->host_handle)
+        return a->host_handle < b->host_handle ? -1 : 1;
+    if (a != b)
+        return a < b ? -1 : 1;
+    return 0;
+}
+
 #define WINE_VK_ADD_DISPATCHABLE_MAPPING(instance, client_handle, host_handle, object) \
     wine_vk_add_handle_mapping((instance), (uintptr_t)(client_handle), (uintptr_t)(host_handle), &(object)->mapping)
 #define WINE_VK_ADD_NON_DISPATCHABLE_MAPPING(instance, client_handle, host_handle, object) \
@@ -114,7 +126,7 @@ static void wine_vk_add_handle_mapping(struct wine_instance *instance, uint64_t
         mapping->host_handle = host_handle;
         mapping->wine_wrapped_handle = wrapped_handle;
         pthread_rwlock_wrlock(&instance->wrapper_lock);
-        list_add_tail(&instance->wrappers, &mapping->link);
+        rb_put(&instance->wrappers, mapping, &mapping->entry);
         pthread_rwlock_unlock(&instance->wrapper_lock);
     }
 }
@@ -126,7 +138,7 @@ static void wine_vk_remove_handle_mapping(struct wine_instance *instance, struct
     if (instance->enable_wrapper_list)
     {
         pthread_rwlock_wrlock(&instance->wrapper_lock);
-        list_remove(&mapping->link);
+        rb_remove(&instance->wrappers, &mapping->entry);
         pthread_rwlock_unlock(&instance->wrapper_lock);
     }
 }
@@ -134,12 +146,21 @@ static void wine_vk_remove_handle_mapping(struct wine_instance *instance, struct
 static uint64_t wine_vk_get_wrapper(struct wine_instance *instance, uint64_t host_handle)
 {
     struct wine_vk_mapping *mapping;
+    struct rb_entry *entry;
     uint64_t result = 0;
 
+    /* Mappings are sorted by host handle first; any of them will do if
+     * several objects share the same host handle. */
     pthread_rwlock_rdlock(&instance->wrapper_lock);
-    LIST_FOR_EACH_ENTRY(mapping, &instance->wrappers, struct wine_vk_mapping, link)
-    {
-        if (mapping->host_handle == host_handle)
+    entry = instance->wrappers.root;
+    while (entry)
+    {
+        mapping = RB_ENTRY_VALUE(entry, struct wine_vk_mapping, entry);
+        if (host_handle < mapping->host_handle)
+            entry = entry->left;
+        else if (host_handle > mapping->host_handle)
+            entry = entry->right;
+        else
         {
             result = mapping->wine_wrapped_handle;
             break;
@@ -1132,7 +1153,7 @@ VkResult wine_vkCreateInstance(const VkInstanceCreateInfo *create_info,
         ERR("Failed to allocate memory for instance\n");
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
-    list_init(&object->wrappers);
+    rb_init(&object->wrappers, wine_vk_mapping_compare);
     pthread_rwlock_init(&object->wrapper_lock, NULL);
 
     init_conversion_context(&ctx);
@@ -26,6 +26,8 @@
 #include <pthread.h>
 #include <stdbool.h>
 
+#include "wine/rbtree.h"
+
 #include "vulkan_loader.h"
 #include "vulkan_thunks.h"
 
@@ -34,7 +36,7 @@
  */
 struct wine_vk_mapping
 {
-    struct list link;
+    struct rb_entry entry;
     uint64_t host_handle;
     uint64_t wine_wrapped_handle;
 };
@@ -179,7 +181,7 @@ struct wine_instance
     uint32_t api_version;
 
     VkBool32 enable_wrapper_list;
-    struct list wrappers;
+    struct rb_tree wrappers;
     pthread_rwlock_t wrapper_lock;
 
     struct wine_debug_utils_messenger *utils_messengers;
@@ -354,6 +356,19 @@ NTSTATUS vk_is_available_device_function(void *arg);
 NTSTATUS vk_is_available_instance_function32(void *arg);
 NTSTATUS vk_is_available_device_function32(void *arg);
 
+/* Allocations that don't fit in the inline buffer are carved out of heap
+ * chunks of at least this size, so that large conversions (e.g. descriptor
+ * updates with many writes) don't need one malloc() per structure. */
+#define CONVERSION_CHUNK_SIZE 16384
+
+struct conversion_chunk
+{
+    struct list entry;
+    size_t size;
+    size_t used;
+    char DECLSPEC_ALIGN(8) data[];
+};
+
 struct conversion_context
 {
     char buffer[2048];
@@ -369,9 +384,9 @@ static inline void init_conversion_context(struct conversion_context *pool)
 
 static inline void free_conversion_context(struct conversion_context *pool)
 {
-    struct list *entry, *next;
-    LIST_FOR_EACH_SAFE(entry, next, &pool->alloc_entries)
-        free(entry);
+    struct conversion_chunk *chunk, *next;
+    LIST_FOR_EACH_ENTRY_SAFE(chunk, next, &pool->alloc_entries, struct conversion_chunk, entry)
+        free(chunk);
 }
 
 struct wine_semaphore
@@ -434,11 +449,28 @@ static inline void *conversion_context_alloc(struct conversion_context *pool, si
     }
     else
     {
-        struct list *entry;
-        if (!(entry = malloc(sizeof(*entry) + size)))
+        struct conversion_chunk *chunk;
+        struct list *tail;
+        void *ret;
+
+        size = (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
+        if ((tail = list_tail(&pool->alloc_entries)))
+        {
+            chunk = LIST_ENTRY(tail, struct conversion_chunk, entry);
+            if (chunk->size - chunk->used >= size)
+            {
+                ret = chunk->data + chunk->used;
+                chunk->used += size;
+                return ret;
+            }
+        }
+
+        if (!(chunk = malloc(offsetof(struct conversion_chunk, data[max(size, CONVERSION_CHUNK_SIZE)]))))
             return NULL;
-        list_add_tail(&pool->alloc_entries, entry);
-        return entry + 1;
+        chunk->size = max(size, CONVERSION_CHUNK_SIZE);
+        chunk->used = size;
+        list_add_tail(&pool->alloc_entries, &chunk->entry);
+        return chunk->data;
     }
 }
 
@@ -137,14 +137,16 @@ err:
 /**********************************************************************
  *          wayland_buffer_queue_get_free_buffer
  *
- * Gets a free buffer from the buffer queue. If no free buffers
- * are available this function blocks until it can provide one.
+ * Gets a free buffer from the buffer queue, preferring the specified
+ * buffer if it's part of the queue and has already been released. If no
+ * free buffers are available this function blocks until it can provide one.
  */
-static struct wayland_shm_buffer *wayland_buffer_queue_get_free_buffer(struct wayland_buffer_queue *queue)
+static struct wayland_shm_buffer *wayland_buffer_queue_get_free_buffer(struct wayland_buffer_queue *queue,
+                                                                       struct wayland_shm_buffer *preferred)
 {
-    struct wayland_shm_buffer *shm_buffer;
+    struct wayland_shm_buffer *shm_buffer, *free_buffer;
 
-    TRACE("queue=%p\n", queue);
+    TRACE("queue=%p preferred=%p\n", queue, preferred);
 
     while (TRUE)
     {
@@ -154,12 +156,20 @@ static struct wayland_shm_buffer *wayland_buffer_queue_get_free_buffer(struct wa
         wl_display_dispatch_queue_pending(process_wayland.wl_display,
                                           queue->wl_event_queue);
 
-        /* Search through our buffers to find an available one. */
+        /* Search through our buffers to find an available one. Reusing the
+         * preferred buffer, which holds the latest window contents, saves
+         * us from copying the contents of a previous buffer. */
+        free_buffer = NULL;
         wl_list_for_each(shm_buffer, &queue->buffer_list, link)
         {
-            if (!shm_buffer->busy) goto out;
+            if (!shm_buffer->busy)
+            {
+                if (shm_buffer == preferred) goto out;
+                if (!free_buffer) free_buffer = shm_buffer;
+            }
             nbuffers++;
         }
+        if ((shm_buffer = free_buffer)) goto out;
 
         /* Dynamically create up to 3 buffers. */
         if (nbuffers < 3)
@@ -403,7 +413,8 @@ static void wayland_window_surface_flush(struct window_surface *window_surface)
 
     wayland_buffer_queue_add_damage(wws->wayland_buffer_queue, surface_damage_region);
 
-    shm_buffer = wayland_buffer_queue_get_free_buffer(wws->wayland_buffer_queue);
+    shm_buffer = wayland_buffer_queue_get_free_buffer(wws->wayland_buffer_queue,
+                                                      wws->wayland_surface->latest_window_buffer);
     if (!shm_buffer)
     {
         ERR("failed to acquire Wayland SHM buffer, returning\n");
@@ -1808,9 +1808,11 @@ static int xshm_error_handler( Display *display, XErrorEvent *event, void *arg )
 
 static XImage *create_shm_image( const XVisualInfo *vis, int width, int height, XShmSegmentInfo *shminfo )
 {
+    static BOOL attach_failed;  /* don't retry a server round trip for every new surface */
     XImage *image;
 
     shminfo->shmid = -1;
+    if (attach_failed) return NULL;
     image = XShmCreateImage( gdi_display, vis->visual, vis->depth, ZPixmap, NULL, shminfo, width, height );
     if (!image) return NULL;
     if (image->bytes_per_line & 3) goto failed;  /* we need 32-bit alignment */
@@ -1833,6 +1835,8 @@ static XImage *create_shm_image( const XVisualInfo *vis, int width, int height,
             shmctl( shminfo->shmid, IPC_RMID, 0 );
             return image;
         }
+        WARN( "XShmAttach failed, disabling MIT-SHM for window surfaces\n" );
+        attach_failed = TRUE;
         shmdt( shminfo->shmaddr );
     }
     shmctl( shminfo->shmid, IPC_RMID, 0 );
@@ -1916,6 +1920,55 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     window_surface->funcs->unlock( window_surface );
 }
 
+/* copy the damaged part of the surface bits to the image, converting as needed */
+static void copy_surface_rect( struct x11drv_window_surface *surface, const RECT *rect, const int *mapping )
+{
+    int x, y, stride = surface->image->bytes_per_line, height = rect->bottom - rect->top;
+    const unsigned char *src = (const unsigned char *)surface->bits + rect->top * stride;
+    unsigned char *dst = (unsigned char *)surface->image->data + rect->top * stride;
+
+    switch (surface->info.bmiHeader.biBitCount)
+    {
+    case 8:
+        if (!mapping) break;
+        for (y = 0; y < height; y++, src += stride, dst += stride)
+            for (x = rect->left; x < rect->right; x++) dst[x] = mapping[src[x]];
+        return;
+    case 16:
+        if (!surface->byteswap) break;
+        for (y = 0; y < height; y++, src += stride, dst += stride)
+            for (x = rect->left; x < rect->right; x++)
+                ((USHORT *)dst)[x] = RtlUshortByteSwap( ((const USHORT *)src)[x] );
+        return;
+    case 24:
+        if (!surface->byteswap) break;
+        for (y = 0; y < height; y++, src += stride, dst += stride)
+            for (x = rect->left; x < rect->right; x++)
+            {
+                unsigned char tmp = src[3 * x];
+                dst[3 * x]     = src[3 * x + 2];
+                dst[3 * x + 1] = src[3 * x + 1];
+                dst[3 * x + 2] = tmp;
+            }
+        return;
+    case 32:
+        if (!surface->byteswap) break;
+        for (y = 0; y < height; y++, src += stride, dst += stride)
+            for (x = rect->left; x < rect->right; x++)
+                ((ULONG *)dst)[x] = RtlUlongByteSwap( ((const ULONG *)src)[x] | surface->alpha_bits );
+        return;
+    default:
+        /* sub-byte formats, copy whole rows */
+        copy_image_byteswap( &surface->info, src, dst, stride, stride, height,
+                             surface->byteswap, mapping, ~0u, surface->alpha_bits );
+        return;
+    }
+
+    x = rect->left * surface->info.bmiHeader.biBitCount / 8;
+    for (y = 0; y < height; y++, src += stride, dst += stride)
+        memcpy( dst + x, src + x, (rect->right - rect->left) * surface->info.bmiHeader.biBitCount / 8 );
+}
+
 /***********************************************************************
  *           x11drv_surface_flush
  */
@@ -1951,13 +2004,8 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
         if (src != dst)
         {
             int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
-            int width_bytes = surface->image->bytes_per_line;
 
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u, surface->alpha_bits );
+            copy_surface_rect( surface, &coords.visrect, mapping );
         }
         else if (surface->alpha_bits)
         {
@@ -445,15 +445,17 @@ static BOOL process_events( Display *display, Bool (*filter)(Display*, XEvent*,X
     ULONG_PTR keyboard_filter = QS_MOUSEBUTTON | QS_MOUSEMOVE;
     LARGE_INTEGER timeout = {0};
 
-    if (NtWaitForSingleObject(steam_overlay_event, FALSE, &timeout) == WAIT_OBJECT_0)
-        overlay_enabled = TRUE;
-    if (NtWaitForSingleObject(steam_keyboard_event, FALSE, &timeout) == WAIT_OBJECT_0)
-        steam_keyboard_opened = TRUE;
-
     prev_event.type = 0;
     while (XCheckIfEvent( display, &event, filter, (char *)arg ))
     {
-        count++;
+        /* this is called for every input poll, only query the overlay state when there are events */
+        if (!count++)
+        {
+            if (NtWaitForSingleObject(steam_overlay_event, FALSE, &timeout) == WAIT_OBJECT_0)
+                overlay_enabled = TRUE;
+            if (NtWaitForSingleObject(steam_keyboard_event, FALSE, &timeout) == WAIT_OBJECT_0)
+                steam_keyboard_opened = TRUE;
+        }
         if (overlay_enabled && filter_event( display, &event, (char *)overlay_filter )) continue;
         if (steam_keyboard_opened && filter_event( display, &event, (char *)keyboard_filter )) continue;
         if (XFilterEvent( &event, None ))
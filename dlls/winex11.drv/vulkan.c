@@ -1049,21 +1049,28 @@ static VkResult X11DRV_vkAcquireNextImage2KHR( VkDevice device, const VkAcquireN
 static VkResult X11DRV_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *present_info)
 {
     static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    struct wine_vk_surface *buffer[4], **surfaces = buffer;
     VkResult res;
     UINT i;
 
     TRACE("%p, %p\n", queue, present_info);
 
+    /* look up the surfaces once, this is called for every frame */
+    if (present_info->swapchainCount > ARRAY_SIZE(buffer) &&
+        !(surfaces = malloc( present_info->swapchainCount * sizeof(*surfaces) )))
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
     for (i = 0; i < present_info->swapchainCount; i++)
     {
         VkSwapchainKHR swapchain = present_info->pSwapchains[i];
-        struct wine_vk_surface *surface;
         struct x11drv_win_data *data;
 
-        if (!XFindContext( gdi_display, (XID)swapchain, swapchain_context, (char **)&surface ) &&
-            !surface->gdi_blit_source && !surface->offscreen && (data = get_win_data( surface->hwnd )))
+        if (XFindContext( gdi_display, (XID)swapchain, swapchain_context, (char **)&surfaces[i] ))
+            surfaces[i] = NULL;
+        else if (!surfaces[i]->gdi_blit_source && !surfaces[i]->offscreen &&
+                 (data = get_win_data( surfaces[i]->hwnd )))
         {
-            attach_client_window( data, surface->window );
+            attach_client_window( data, surfaces[i]->window );
             release_win_data( data );
         }
     }
@@ -1095,15 +1102,12 @@ static VkResult X11DRV_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *
 
     if (res == VK_SUCCESS)
     {
-        struct wine_vk_surface *surface;
         BOOL invalidated = FALSE;
-        unsigned int i;
 
         pthread_mutex_lock(&vulkan_mutex);
         for (i = 0; i < present_info->swapchainCount; ++i)
         {
-            if (!XFindContext(gdi_display, (XID)present_info->pSwapchains[i], swapchain_context, (char **)&surface)
-                && surface->invalidated)
+            if (surfaces[i] && surfaces[i]->invalidated)
             {
                 invalidated = TRUE;
                 break;
@@ -1112,6 +1116,8 @@ static VkResult X11DRV_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *
         pthread_mutex_unlock(&vulkan_mutex);
         if (invalidated) res = VK_SUBOPTIMAL_KHR;
     }
+
+    if (surfaces != buffer) free( surfaces );
     return res;
 }
 
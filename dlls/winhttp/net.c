@@ -300,7 +300,7 @@ void netconn_release( struct netconn *conn )
     }
     if (conn->socket != -1)
         closesocket( conn->socket );
-    release_host( conn->host );
+    close_host_connection( conn->host );
     if (conn->port)
         CloseHandle( conn->port );
     free(conn);
@@ -396,6 +396,7 @@ static DWORD netconn_negotiate( struct netconn *conn, WCHAR *hostname, CredHandl
 DWORD netconn_secure_connect( struct netconn *conn, WCHAR *hostname, DWORD security_flags, CredHandle *cred_handle,
                               BOOL check_revocation )
 {
+    SecPkgContext_SessionInfo session_info;
     CtxtHandle ctx = {0};
     const CERT_CONTEXT *cert;
     SECURITY_STATUS status;
@@ -435,7 +436,10 @@ DWORD netconn_secure_connect( struct netconn *conn, WCHAR *hostname, DWORD secur
         goto failed;
     }
 
-    TRACE("established SSL connection\n");
+    if (QueryContextAttributesW(&ctx, SECPKG_ATTR_SESSION_INFO, &session_info) == SEC_E_OK)
+        conn->resumed = !!(session_info.dwFlags & SSL_SESSION_RECONNECT);
+
+    TRACE("established SSL connection%s\n", conn->resumed ? ", session resumed" : "");
     conn->secure = TRUE;
     conn->ssl_ctx = ctx;
     return ERROR_SUCCESS;
@@ -1456,13 +1456,47 @@ void release_host( struct hostdata *host )
     free( host );
 }
 
+/* account for a closed connection, and hand its slot to a request waiting for one */
+void close_host_connection( struct hostdata *host )
+{
+    EnterCriticalSection( &connection_pool_cs );
+    host->open--;
+    WakeConditionVariable( &host->cond );
+    LeaveCriticalSection( &connection_pool_cs );
+    release_host( host );
+}
+
+/* close the idle connections of a session being destroyed */
+void close_session_connections( struct session *session )
+{
+    struct netconn *netconn, *next_netconn;
+    struct list idle = LIST_INIT( idle );
+    struct hostdata *host;
+
+    EnterCriticalSection( &connection_pool_cs );
+    LIST_FOR_EACH_ENTRY( host, &connection_pool, struct hostdata, entry )
+    {
+        if (host->session != session) continue;
+        host->session = NULL;
+        list_move_tail( &idle, &host->connections );
+    }
+    LeaveCriticalSection( &connection_pool_cs );
+
+    LIST_FOR_EACH_ENTRY_SAFE( netconn, next_netconn, &idle, struct netconn, entry )
+    {
+        list_remove( &netconn->entry );
+        netconn_release( netconn );
+    }
+}
+
 static BOOL connection_collector_running;
 
 static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void *ctx )
 {
     unsigned int remaining_connections;
     struct netconn *netconn, *next_netconn;
-    struct hostdata *host, *next_host;
+    struct hostdata *host;
+    struct list expired;
     ULONGLONG now;
 
     do
@@ -1471,18 +1505,18 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
         Sleep(5000);
         remaining_connections = 0;
         now = GetTickCount64();
+        list_init( &expired );
 
         EnterCriticalSection(&connection_pool_cs);
 
-        LIST_FOR_EACH_ENTRY_SAFE(host, next_host, &connection_pool, struct hostdata, entry)
+        LIST_FOR_EACH_ENTRY(host, &connection_pool, struct hostdata, entry)
         {
             LIST_FOR_EACH_ENTRY_SAFE(netconn, next_netconn, &host->connections, struct netconn, entry)
             {
                 if (netconn->keep_until < now)
                 {
-                    TRACE("freeing %p\n", netconn);
                     list_remove(&netconn->entry);
-                    netconn_release(netconn);
+                    list_add_tail(&expired, &netconn->entry);
                 }
                 else remaining_connections++;
             }
@@ -1491,6 +1525,14 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
         if (!remaining_connections) connection_collector_running = FALSE;
 
         LeaveCriticalSection(&connection_pool_cs);
+
+        /* closing them may free their host */
+        LIST_FOR_EACH_ENTRY_SAFE(netconn, next_netconn, &expired, struct netconn, entry)
+        {
+            TRACE("freeing %p\n", netconn);
+            list_remove(&netconn->entry);
+            netconn_release(netconn);
+        }
     } while(remaining_connections);
 
     FreeLibraryWhenCallbackReturns( instance, winhttp_instance );
@@ -1502,8 +1544,16 @@ static void cache_connection( struct netconn *netconn )
 
     EnterCriticalSection( &connection_pool_cs );
 
+    if (!netconn->host->session)  /* the session is gone */
+    {
+        LeaveCriticalSection( &connection_pool_cs );
+        netconn_release( netconn );
+        return;
+    }
+
     netconn->keep_until = GetTickCount64() + DEFAULT_KEEP_ALIVE_TIMEOUT;
     list_add_head( &netconn->host->connections, &netconn->entry );
+    WakeConditionVariable( &netconn->host->cond );
 
     if (!connection_collector_running)
     {
@@ -1529,34 +1579,57 @@ static DWORD map_secure_protocols( DWORD mask )
     return ret;
 }
 
-static DWORD ensure_cred_handle( struct request *request )
+static SECURITY_STATUS acquire_cred_handle( DWORD protocols, const CERT_CONTEXT **client_cert, CredHandle *handle )
 {
-    SECURITY_STATUS status = SEC_E_OK;
+    SECURITY_STATUS status;
+    SCHANNEL_CRED cred;
+
+    memset( &cred, 0, sizeof(cred) );
+    cred.dwVersion             = SCHANNEL_CRED_VERSION;
+    cred.grbitEnabledProtocols = map_secure_protocols( protocols );
+    if (*client_cert)
+    {
+        cred.paCred = client_cert;
+        cred.cCreds = 1;
+    }
+    status = AcquireCredentialsHandleW( NULL, (WCHAR *)UNISP_NAME_W, SECPKG_CRED_OUTBOUND, NULL,
+                                        &cred, NULL, NULL, handle, NULL );
+    if (status != SEC_E_OK) WARN( "AcquireCredentialsHandleW failed: %#lx\n", status );
+    return status;
+}
 
-    if (request->cred_handle_initialized) return ERROR_SUCCESS;
+/* Requests without a client certificate share the credentials of their session,
+ * which lets schannel resume the TLS sessions of their earlier connections. */
+static DWORD ensure_cred_handle( struct request *request, CredHandle **ret_handle )
+{
+    struct session *session = request->connect->session;
+    DWORD protocols = session->secure_protocols;
+    SECURITY_STATUS status;
 
-    if (!request->cred_handle_initialized)
+    if (!request->client_cert)
     {
-        SCHANNEL_CRED cred;
-        memset( &cred, 0, sizeof(cred) );
-        cred.dwVersion             = SCHANNEL_CRED_VERSION;
-        cred.grbitEnabledProtocols = map_secure_protocols( request->connect->session->secure_protocols );
-        if (request->client_cert)
+        EnterCriticalSection( &session->cs );
+        if (!session->cred_handle_initialized &&
+            !acquire_cred_handle( protocols, &request->client_cert, &session->cred_handle ))
         {
-            cred.paCred = &request->client_cert;
-            cred.cCreds = 1;
+            session->cred_protocols = protocols;
+            session->cred_handle_initialized = TRUE;
         }
-        status = AcquireCredentialsHandleW( NULL, (WCHAR *)UNISP_NAME_W, SECPKG_CRED_OUTBOUND, NULL,
-                                            &cred, NULL, NULL, &request->cred_handle, NULL );
-        if (status == SEC_E_OK)
-            request->cred_handle_initialized = TRUE;
+        if (session->cred_handle_initialized && session->cred_protocols == protocols)
+            *ret_handle = &session->cred_handle;
+        else
+            *ret_handle = NULL;
+        LeaveCriticalSection( &session->cs );
+        if (*ret_handle) return ERROR_SUCCESS;
     }
 
-    if (status != SEC_E_OK)
+    if (!request->cred_handle_initialized)
     {
-        WARN( "AcquireCredentialsHandleW failed: %#lx\n", status );
-        return status;
+        if ((status = acquire_cred_handle( protocols, &request->client_cert, &request->cred_handle )))
+            return status;
+        request->cred_handle_initialized = TRUE;
     }
+    *ret_handle = &request->cred_handle;
     return ERROR_SUCCESS;
 }
 
@@ -1566,9 +1639,10 @@ static DWORD open_connection( struct request *request )
     struct hostdata *host = NULL, *iter;
     struct netconn *netconn = NULL;
     struct connect *connect;
+    CredHandle *cred_handle;
     WCHAR *addressW = NULL;
     INTERNET_PORT port;
-    DWORD ret, len;
+    DWORD ret, len, wait;
 
     if (request->netconn) goto done;
 
@@ -1579,7 +1653,8 @@ static DWORD open_connection( struct request *request )
 
     LIST_FOR_EACH_ENTRY( iter, &connection_pool, struct hostdata, entry )
     {
-        if (iter->port == port && !wcscmp( connect->servername, iter->hostname ) && !is_secure == !iter->secure)
+        if (iter->session == connect->session && iter->port == port &&
+            !wcscmp( connect->servername, iter->hostname ) && !is_secure == !iter->secure)
         {
             host = iter;
             host->ref++;
@@ -1592,9 +1667,12 @@ static DWORD open_connection( struct request *request )
         if ((host = malloc( sizeof(*host) )))
         {
             host->ref = 1;
+            host->session = connect->session;
             host->secure = is_secure;
             host->port = port;
+            host->open = 0;
             list_init( &host->connections );
+            InitializeConditionVariable( &host->cond );
             if ((host->hostname = wcsdup( connect->servername )))
             {
                 list_add_head( &connection_pool, &host->entry );
@@ -1611,21 +1689,41 @@ static DWORD open_connection( struct request *request )
 
     if (!host) return ERROR_OUTOFMEMORY;
 
+    /* take an idle connection, or a slot for a new one once the host is below the limit */
+    wait = request->connect_timeout > 0 ? request->connect_timeout : INFINITE;
+    EnterCriticalSection( &connection_pool_cs );
     for (;;)
     {
-        EnterCriticalSection( &connection_pool_cs );
         if (!list_empty( &host->connections ))
         {
             netconn = LIST_ENTRY( list_head( &host->connections ), struct netconn, entry );
             list_remove( &netconn->entry );
-        }
-        LeaveCriticalSection( &connection_pool_cs );
-        if (!netconn) break;
+            LeaveCriticalSection( &connection_pool_cs );
 
-        if (netconn_is_alive( netconn )) break;
-        TRACE("connection %p no longer alive, closing\n", netconn);
-        netconn_release( netconn );
-        netconn = NULL;
+            if (netconn_is_alive( netconn ))
+            {
+                release_host( host );  /* the connection holds its own reference */
+                InterlockedIncrement( &connect->session->connections_reused );
+                break;
+            }
+            TRACE("connection %p no longer alive, closing\n", netconn);
+            netconn_release( netconn );
+            netconn = NULL;
+            EnterCriticalSection( &connection_pool_cs );
+        }
+        else if (host->open < connect->session->max_conns_per_server)
+        {
+            host->open++;
+            LeaveCriticalSection( &connection_pool_cs );
+            break;
+        }
+        else if (!SleepConditionVariableCS( &host->cond, &connection_pool_cs, wait ))
+        {
+            LeaveCriticalSection( &connection_pool_cs );
+            TRACE("timed out waiting for a connection to %s\n", debugstr_w(host->hostname));
+            release_host( host );
+            return ERROR_WINHTTP_TIMEOUT;
+        }
     }
 
     if (!connect->resolved && netconn)
@@ -1641,14 +1739,14 @@ static DWORD open_connection( struct request *request )
 
         if ((ret = netconn_resolve( host->hostname, port, &connect->sockaddr, request->resolve_timeout )))
         {
-            release_host( host );
+            close_host_connection( host );
             return ret;
         }
         connect->resolved = TRUE;
 
         if (!(addressW = addr_to_str( &connect->sockaddr )))
         {
-            release_host( host );
+            close_host_connection( host );
             return ERROR_OUTOFMEMORY;
         }
         len = lstrlenW( addressW ) + 1;
@@ -1659,7 +1757,7 @@ static DWORD open_connection( struct request *request )
     {
         if (!addressW && !(addressW = addr_to_str( &connect->sockaddr )))
         {
-            release_host( host );
+            close_host_connection( host );
             return ERROR_OUTOFMEMORY;
         }
 
@@ -1670,10 +1768,12 @@ static DWORD open_connection( struct request *request )
 
         if ((ret = netconn_create( host, &connect->sockaddr, request->connect_timeout, &netconn )))
         {
+            request->stats[WinHttpConnectFailureCount]++;
             free( addressW );
-            release_host( host );
+            close_host_connection( host );
             return ret;
         }
+        InterlockedIncrement( &connect->session->connections_opened );
         netconn_set_timeout( netconn, TRUE, request->send_timeout );
         netconn_set_timeout( netconn, FALSE, request_receive_response_timeout( request ));
 
@@ -1695,9 +1795,9 @@ static DWORD open_connection( struct request *request )
             CertFreeCertificateContext( request->server_cert );
             request->server_cert = NULL;
 
-            if ((ret = ensure_cred_handle( request )) ||
+            if ((ret = ensure_cred_handle( request, &cred_handle )) ||
                 (ret = netconn_secure_connect( netconn, connect->hostname, request->security_flags,
-                                               &request->cred_handle, request->check_revocation )))
+                                               cred_handle, request->check_revocation )))
             {
                 request->netconn = NULL;
                 free( addressW );
@@ -1724,6 +1824,11 @@ static DWORD open_connection( struct request *request )
         return ERROR_WINHTTP_SECURE_FAILURE;
     }
 
+    request->stats_index = netconn->requests++;
+    request->stats_flags = 0;
+    if (!request->stats_index) request->stats_flags |= WINHTTP_REQUEST_STAT_FLAG_FIRST_REQUEST;
+    if (netconn->resumed) request->stats_flags |= WINHTTP_REQUEST_STAT_FLAG_TLS_SESSION_RESUMPTION;
+
 done:
     request->read_pos = request->read_size = 0;
     request->read_chunked = FALSE;
@@ -2006,6 +2111,7 @@ static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD
         size -= count;
         bytes_read += count;
         request->content_read += count;
+        request->stats[WinHttpResponseBodySize] += count;
         if (end_of_read_data( request )) goto done;
     }
     if (request->read_chunked && !request->read_chunked_size) ret = refill_buffer( request, async );
@@ -2262,6 +2368,7 @@ static DWORD send_request( struct request *request, const WCHAR *headers, DWORD
 
     drain_content( request );
     clear_response_headers( request );
+    memset( request->stats, 0, sizeof(request->stats) );
 
     if (session->agent)
         process_header( request, L"User-Agent", session->agent, WINHTTP_ADDREQ_FLAG_ADD_IF_NEW, TRUE );
@@ -2327,6 +2434,7 @@ static DWORD send_request( struct request *request, const WCHAR *headers, DWORD
     ret = netconn_send( request->netconn, wire_req, len, &bytes_sent, NULL );
     free( wire_req );
     if (ret) goto end;
+    request->stats[WinHttpRequestHeadersSize] = len;
 
     if (optional_len)
     {
@@ -2632,6 +2740,7 @@ static DWORD read_reply( struct request *request )
     {
         buflen = MAX_REPLY_LEN;
         if ((ret = read_line( request, buffer, &buflen ))) return ret;
+        request->stats[WinHttpResponseHeadersSize] += buflen + 1;
 
         /* first line should look like 'HTTP/1.x nnn OK' where nnn is the status code */
         if (!(status_code = strchr( buffer, ' ' ))) return ERROR_WINHTTP_INVALID_SERVER_RESPONSE;
@@ -2684,6 +2793,7 @@ static DWORD read_reply( struct request *request )
 
         buflen = MAX_REPLY_LEN;
         if (read_line( request, buffer, &buflen )) return ERROR_SUCCESS;
+        request->stats[WinHttpResponseHeadersSize] += buflen + 1;
         if (!*buffer) buflen = 1;
 
         while (len - offset < buflen + crlf_len)
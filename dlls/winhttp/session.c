@@ -69,7 +69,11 @@ static void session_destroy( struct object_header *hdr )
 {
     struct session *session = (struct session *)hdr;
 
-    TRACE("%p\n", session);
+    TRACE("%p, %ld connections opened, %ld reused\n", session, session->connections_opened,
+          session->connections_reused);
+
+    close_session_connections( session );
+    if (session->cred_handle_initialized) FreeCredentialsHandle( &session->cred_handle );
 
     if (session->unload_event) SetEvent( session->unload_event );
     destroy_cookies( session );
@@ -123,6 +127,13 @@ static BOOL session_query_option( struct object_header *hdr, DWORD option, void
         *buflen = sizeof(DWORD);
         return TRUE;
 
+    case WINHTTP_OPTION_MAX_CONNS_PER_SERVER:
+        if (!validate_buffer( buffer, buflen, sizeof(DWORD) )) return FALSE;
+
+        *(DWORD *)buffer = session->max_conns_per_server;
+        *buflen = sizeof(DWORD);
+        return TRUE;
+
     case WINHTTP_OPTION_SEND_TIMEOUT:
         if (!validate_buffer( buffer, buflen, sizeof(DWORD) )) return FALSE;
 
@@ -240,7 +251,13 @@ static BOOL session_set_option( struct object_header *hdr, DWORD option, void *b
         return TRUE;
 
     case WINHTTP_OPTION_MAX_CONNS_PER_SERVER:
-        FIXME( "WINHTTP_OPTION_MAX_CONNS_PER_SERVER: %lu\n", *(DWORD *)buffer );
+        if (!*(DWORD *)buffer)
+        {
+            SetLastError( ERROR_INVALID_PARAMETER );
+            return FALSE;
+        }
+        TRACE( "WINHTTP_OPTION_MAX_CONNS_PER_SERVER: %lu\n", *(DWORD *)buffer );
+        session->max_conns_per_server = *(DWORD *)buffer;
         return TRUE;
 
     case WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER:
@@ -318,6 +335,7 @@ HINTERNET WINAPI WinHttpOpen( LPCWSTR agent, DWORD access, LPCWSTR proxy, LPCWST
     session->receive_response_timeout = DEFAULT_RECEIVE_RESPONSE_TIMEOUT;
     session->websocket_receive_buffer_size = 32768;
     session->websocket_send_buffer_size = 32768;
+    session->max_conns_per_server = ~0u;
     list_init( &session->cookie_cache );
     InitializeCriticalSection( &session->cs );
     session->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": session.cs");
@@ -898,6 +916,21 @@ static BOOL request_query_option( struct object_header *hdr, DWORD option, void
         *buflen = sizeof(DWORD);
         return TRUE;
 
+    case WINHTTP_OPTION_REQUEST_STATS:
+    {
+        WINHTTP_REQUEST_STATS *stats = buffer;
+
+        if (!validate_buffer( buffer, buflen, sizeof(*stats) )) return FALSE;
+
+        stats->ullFlags = request->stats_flags;
+        stats->ulIndex  = request->stats_index;
+        stats->cStats   = WinHttpRequestStatLast;
+        memset( stats->rgullStats, 0, sizeof(stats->rgullStats) );
+        memcpy( stats->rgullStats, request->stats, sizeof(request->stats) );
+        *buflen = sizeof(*stats);
+        return TRUE;
+    }
+
     case WINHTTP_OPTION_WEB_SOCKET_RECEIVE_BUFFER_SIZE:
         if (!validate_buffer( buffer, buflen, sizeof(DWORD) )) return FALSE;
 
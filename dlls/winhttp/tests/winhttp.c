@@ -5888,6 +5888,7 @@ static void test_client_cert_authentication(void)
 
 static void test_connection_cache(int port)
 {
+    WINHTTP_REQUEST_STATS stats;
     HINTERNET ses, con, req;
     DWORD status, size;
     char buffer[256];
@@ -5912,6 +5913,17 @@ static void test_connection_cache(int port)
     ret = WinHttpReadData(req, buffer, sizeof buffer, &size);
     ok(ret, "failed to read data %lu\n", GetLastError());
     ok(!size, "got size %lu.\n", size);
+    size = sizeof(stats);
+    ret = WinHttpQueryOption(req, WINHTTP_OPTION_REQUEST_STATS, &stats, &size);
+    if (!ret) win_skip("WINHTTP_OPTION_REQUEST_STATS is not supported\n");
+    else
+    {
+        ok(size == sizeof(stats), "got size %lu\n", size);
+        ok(!stats.ulIndex, "got index %lu\n", stats.ulIndex);
+        ok(stats.ullFlags & WINHTTP_REQUEST_STAT_FLAG_FIRST_REQUEST, "got flags %#I64x\n", stats.ullFlags);
+        ok(stats.rgullStats[WinHttpRequestHeadersSize], "got no request headers size\n");
+        ok(stats.rgullStats[WinHttpResponseHeadersSize], "got no response headers size\n");
+    }
     WinHttpCloseHandle(req);
 
     req = WinHttpOpenRequest(con, L"GET", L"/cached", NULL, NULL, NULL, 0);
@@ -5927,6 +5939,13 @@ static void test_connection_cache(int port)
     ret = WinHttpReadData(req, buffer, sizeof buffer, &size);
     ok(ret, "failed to read data %lu\n", GetLastError());
     ok(!size, "got size %lu.\n", size);
+    size = sizeof(stats);
+    ret = WinHttpQueryOption(req, WINHTTP_OPTION_REQUEST_STATS, &stats, &size);
+    if (ret)
+    {
+        ok(stats.ulIndex == 1, "got index %lu\n", stats.ulIndex);
+        ok(!(stats.ullFlags & WINHTTP_REQUEST_STAT_FLAG_FIRST_REQUEST), "got flags %#I64x\n", stats.ullFlags);
+    }
     WinHttpCloseHandle(req);
 
     req = WinHttpOpenRequest(con, L"GET", L"/notcached", NULL, NULL, NULL, 0);
@@ -60,10 +60,13 @@ struct hostdata
 {
     struct list entry;
     LONG ref;
+    struct session *session;    /* session owning the connections, not referenced */
     WCHAR *hostname;
     INTERNET_PORT port;
     BOOL secure;
-    struct list connections;
+    struct list connections;    /* idle connections */
+    unsigned int open;          /* connections open or being opened, idle or not */
+    CONDITION_VARIABLE cond;    /* signaled when a connection becomes idle or is closed */
 };
 
 struct session
@@ -87,6 +90,12 @@ struct session
     DWORD passport_flags;
     unsigned int websocket_receive_buffer_size;
     unsigned int websocket_send_buffer_size;
+    DWORD max_conns_per_server;
+    CredHandle cred_handle;      /* shared by requests without client certificate */
+    DWORD cred_protocols;        /* protocols cred_handle was acquired for */
+    BOOL cred_handle_initialized;
+    LONG connections_opened;
+    LONG connections_reused;
 };
 
 struct connect
@@ -121,6 +130,8 @@ struct netconn
     char *peek_msg_mem;
     size_t peek_len;
     HANDLE port;
+    unsigned int requests;      /* number of requests sent on the connection */
+    BOOL resumed;               /* TLS session was resumed */
 };
 
 struct header
@@ -236,6 +247,9 @@ struct request
     int read_reply_len;
     DWORD read_reply_status;
     enum request_response_state state;
+    ULONGLONG stats_flags; /* WINHTTP_REQUEST_STAT_FLAG_* */
+    ULONG stats_index;     /* index of the request on its connection */
+    ULONGLONG stats[WinHttpRequestStatLast];
 };
 
 enum socket_state
@@ -426,6 +440,8 @@ BOOL set_server_for_hostname( struct connect *, const WCHAR *, INTERNET_PORT );
 void destroy_authinfo( struct authinfo * );
 
 void release_host( struct hostdata * );
+void close_host_connection( struct hostdata * );
+void close_session_connections( struct session * );
 DWORD process_header( struct request *, const WCHAR *, const WCHAR *, DWORD, BOOL );
 
 extern HRESULT WinHttpRequest_create( void ** );
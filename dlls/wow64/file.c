@@ -432,6 +432,26 @@ NTSTATUS WINAPI wow64_NtFsControlFile( UINT *args )
     IO_STATUS_BLOCK io;
     NTSTATUS status;
 
+    switch (code)
+    {
+    case FSCTL_DUPLICATE_EXTENTS_TO_FILE:
+        if (in_len >= sizeof(DUPLICATE_EXTENTS_DATA32))
+        {
+            DUPLICATE_EXTENTS_DATA32 *data32 = in_buf;
+            DUPLICATE_EXTENTS_DATA data;
+
+            data.FileHandle       = LongToHandle( data32->FileHandle );
+            data.SourceFileOffset = data32->SourceFileOffset;
+            data.TargetFileOffset = data32->TargetFileOffset;
+            data.ByteCount        = data32->ByteCount;
+            status = NtFsControlFile( handle, event, apc_32to64( apc ), apc_param_32to64( apc, apc_param ),
+                                      iosb_32to64( &io, io32 ), code, &data, sizeof(data), out_buf, out_len );
+            put_iosb( io32, &io );
+            return status;
+        }
+        break;
+    }
+
     status = NtFsControlFile( handle, event, apc_32to64( apc ), apc_param_32to64( apc, apc_param ),
                               iosb_32to64( &io, io32 ), code, in_buf, in_len, out_buf, out_len );
     put_iosb( io32, &io );
@@ -729,7 +749,10 @@ NTSTATUS WINAPI wow64_NtRemoveIoCompletionEx( UINT *args )
 
     NTSTATUS status;
     ULONG i;
-    FILE_IO_COMPLETION_INFORMATION *info = Wow64AllocateTemp( count * sizeof(*info) );
+    FILE_IO_COMPLETION_INFORMATION buffer[64], *info = buffer;
+
+    /* this is called in a loop by I/O heavy applications, avoid the allocation for small counts */
+    if (count > ARRAY_SIZE(buffer)) info = Wow64AllocateTemp( count * sizeof(*info) );
 
     status = NtRemoveIoCompletionEx( handle, info, count, written, timeout, alertable );
     for (i = 0; i < *written; i++)
@@ -562,6 +562,7 @@ NTSTATUS WINAPI wow64_NtQueryInformationProcess( UINT *args )
     case ProcessExecuteFlags:  /* ULONG */
     case ProcessCookie:  /* ULONG */
     case ProcessCycleTime:  /* PROCESS_CYCLE_TIME_INFORMATION */
+    case ProcessWineIoStatistics:  /* PROCESS_WINE_IO_STATISTICS */
         /* FIXME: check buffer alignment */
         return NtQueryInformationProcess( handle, class, ptr, len, retlen );
 
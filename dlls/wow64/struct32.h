@@ -111,6 +111,14 @@ typedef struct
     WCHAR   FileName[1];
 } FILE_RENAME_INFORMATION32;
 
+typedef struct
+{
+    ULONG         FileHandle;
+    LARGE_INTEGER SourceFileOffset;
+    LARGE_INTEGER TargetFileOffset;
+    LARGE_INTEGER ByteCount;
+} DUPLICATE_EXTENTS_DATA32;
+
 typedef struct
 {
     ULONG Mask;
@@ -218,6 +226,30 @@ typedef struct
     };
 } MEMORY_IMAGE_INFORMATION32;
 
+typedef struct
+{
+    USHORT      DataSize;
+    USHORT      MessageSize;
+    USHORT      MessageType;
+    USHORT      VirtualRangesOffset;
+    CLIENT_ID32 ClientId;
+    ULONG       MessageId;
+    ULONG       SectionSize;
+} PORT_MESSAGE32;
+
+typedef struct
+{
+    ULONG                       Flags;
+    SECURITY_QUALITY_OF_SERVICE SecurityQos;
+    ULONG                       MaxMessageLength;
+    ULONG                       MemoryBandwidth;
+    ULONG                       MaxPoolUsage;
+    ULONG                       MaxSectionSize;
+    ULONG                       MaxViewSize;
+    ULONG                       MaxTotalSectionSize;
+    ULONG                       DupObjectTypes;
+} ALPC_PORT_ATTRIBUTES32;
+
 typedef struct
 {
     NTSTATUS  ExitStatus;
@@ -146,6 +146,201 @@ NTSTATUS WINAPI wow64_NtAcceptConnectPort( UINT *args )
 }
 
 
+static ALPC_PORT_ATTRIBUTES *alpc_port_attr_32to64( ALPC_PORT_ATTRIBUTES *attr,
+                                                    const ALPC_PORT_ATTRIBUTES32 *attr32 )
+{
+    if (!attr32) return NULL;
+    attr->Flags               = attr32->Flags;
+    attr->SecurityQos         = attr32->SecurityQos;
+    attr->MaxMessageLength    = attr32->MaxMessageLength;
+    if (attr->MaxMessageLength)
+        attr->MaxMessageLength += sizeof(PORT_MESSAGE) - sizeof(PORT_MESSAGE32);
+    attr->MemoryBandwidth     = attr32->MemoryBandwidth;
+    attr->MaxPoolUsage        = attr32->MaxPoolUsage;
+    attr->MaxSectionSize      = attr32->MaxSectionSize;
+    attr->MaxViewSize         = attr32->MaxViewSize;
+    attr->MaxTotalSectionSize = attr32->MaxTotalSectionSize;
+    attr->DupObjectTypes      = attr32->DupObjectTypes;
+    return attr;
+}
+
+/* allocate a 64-bit message buffer for a 32-bit one of the given size, copying its contents */
+static PORT_MESSAGE *port_message_32to64( const PORT_MESSAGE32 *msg32, SIZE_T size32 )
+{
+    SIZE_T size = max( size32, sizeof(*msg32) ) - sizeof(*msg32) + sizeof(PORT_MESSAGE);
+    PORT_MESSAGE *msg;
+
+    if (!msg32) return NULL;
+    msg = Wow64AllocateTemp( size );
+    msg->DataSize            = msg32->DataSize;
+    msg->MessageSize         = msg32->MessageSize - sizeof(*msg32) + sizeof(*msg);
+    msg->MessageType         = msg32->MessageType;
+    msg->VirtualRangesOffset = msg32->VirtualRangesOffset;
+    client_id_32to64( &msg->ClientId, &msg32->ClientId );
+    msg->MessageId           = msg32->MessageId;
+    msg->SectionSize         = msg32->SectionSize;
+    memcpy( msg + 1, msg32 + 1, min( msg32->DataSize, size - sizeof(*msg) ));
+    return msg;
+}
+
+static void put_port_message( PORT_MESSAGE32 *msg32, const PORT_MESSAGE *msg )
+{
+    if (!msg32) return;
+    msg32->DataSize            = msg->DataSize;
+    msg32->MessageSize         = msg->MessageSize - sizeof(*msg) + sizeof(*msg32);
+    msg32->MessageType         = msg->MessageType;
+    msg32->VirtualRangesOffset = msg->VirtualRangesOffset;
+    put_client_id( &msg32->ClientId, &msg->ClientId );
+    msg32->MessageId           = msg->MessageId;
+    msg32->SectionSize         = msg->SectionSize;
+    memcpy( msg32 + 1, msg + 1, msg->DataSize );
+}
+
+static SIZE_T *port_message_size_32to64( SIZE_T *size, ULONG *size32 )
+{
+    if (!size32) return NULL;
+    *size = max( *size32, sizeof(PORT_MESSAGE32) ) - sizeof(PORT_MESSAGE32) + sizeof(PORT_MESSAGE);
+    return size;
+}
+
+static void put_port_message_size( ULONG *size32, SIZE_T size )
+{
+    if (size32) *size32 = size - sizeof(PORT_MESSAGE) + sizeof(PORT_MESSAGE32);
+}
+
+
+/**********************************************************************
+ *           wow64_NtAlpcAcceptConnectPort
+ */
+NTSTATUS WINAPI wow64_NtAlpcAcceptConnectPort( UINT *args )
+{
+    ULONG *handle_ptr = get_ptr( &args );
+    HANDLE port = get_handle( &args );
+    ULONG flags = get_ulong( &args );
+    OBJECT_ATTRIBUTES32 *attr32 = get_ptr( &args );
+    ALPC_PORT_ATTRIBUTES32 *port_attr32 = get_ptr( &args );
+    void *context = get_ptr( &args );
+    PORT_MESSAGE32 *msg32 = get_ptr( &args );
+    ALPC_MESSAGE_ATTRIBUTES *msg_attr = get_ptr( &args );
+    BOOLEAN accept = get_ulong( &args );
+
+    struct object_attr64 attr;
+    ALPC_PORT_ATTRIBUTES port_attr;
+    HANDLE handle = 0;
+    NTSTATUS status;
+
+    status = NtAlpcAcceptConnectPort( &handle, port, flags, objattr_32to64( &attr, attr32 ),
+                                      alpc_port_attr_32to64( &port_attr, port_attr32 ), context,
+                                      port_message_32to64( msg32, msg32 ? msg32->MessageSize : 0 ),
+                                      msg_attr, accept );
+    put_handle( handle_ptr, handle );
+    return status;
+}
+
+
+/**********************************************************************
+ *           wow64_NtAlpcConnectPort
+ */
+NTSTATUS WINAPI wow64_NtAlpcConnectPort( UINT *args )
+{
+    ULONG *handle_ptr = get_ptr( &args );
+    UNICODE_STRING32 *name32 = get_ptr( &args );
+    OBJECT_ATTRIBUTES32 *attr32 = get_ptr( &args );
+    ALPC_PORT_ATTRIBUTES32 *port_attr32 = get_ptr( &args );
+    ULONG flags = get_ulong( &args );
+    PSID sid = get_ptr( &args );
+    PORT_MESSAGE32 *msg32 = get_ptr( &args );
+    ULONG *size32 = get_ptr( &args );
+    ALPC_MESSAGE_ATTRIBUTES *out_attr = get_ptr( &args );
+    ALPC_MESSAGE_ATTRIBUTES *in_attr = get_ptr( &args );
+    LARGE_INTEGER *timeout = get_ptr( &args );
+
+    struct object_attr64 attr;
+    ALPC_PORT_ATTRIBUTES port_attr;
+    UNICODE_STRING name;
+    PORT_MESSAGE *msg;
+    HANDLE handle = 0;
+    SIZE_T size, *size_ptr;
+    NTSTATUS status;
+
+    size_ptr = port_message_size_32to64( &size, size32 );
+    msg = port_message_32to64( msg32, size32 ? *size32 : msg32 ? msg32->MessageSize : 0 );
+    status = NtAlpcConnectPort( &handle, unicode_str_32to64( &name, name32 ), objattr_32to64( &attr, attr32 ),
+                                alpc_port_attr_32to64( &port_attr, port_attr32 ), flags, sid, msg,
+                                size_ptr, out_attr, in_attr, timeout );
+    if (msg && (!status || status == STATUS_PORT_CONNECTION_REFUSED)) put_port_message( msg32, msg );
+    if (size_ptr) put_port_message_size( size32, size );
+    put_handle( handle_ptr, handle );
+    return status;
+}
+
+
+/**********************************************************************
+ *           wow64_NtAlpcCreatePort
+ */
+NTSTATUS WINAPI wow64_NtAlpcCreatePort( UINT *args )
+{
+    ULONG *handle_ptr = get_ptr( &args );
+    OBJECT_ATTRIBUTES32 *attr32 = get_ptr( &args );
+    ALPC_PORT_ATTRIBUTES32 *port_attr32 = get_ptr( &args );
+
+    struct object_attr64 attr;
+    ALPC_PORT_ATTRIBUTES port_attr;
+    HANDLE handle = 0;
+    NTSTATUS status;
+
+    status = NtAlpcCreatePort( &handle, objattr_32to64( &attr, attr32 ),
+                               alpc_port_attr_32to64( &port_attr, port_attr32 ));
+    put_handle( handle_ptr, handle );
+    return status;
+}
+
+
+/**********************************************************************
+ *           wow64_NtAlpcDisconnectPort
+ */
+NTSTATUS WINAPI wow64_NtAlpcDisconnectPort( UINT *args )
+{
+    HANDLE port = get_handle( &args );
+    ULONG flags = get_ulong( &args );
+
+    return NtAlpcDisconnectPort( port, flags );
+}
+
+
+/**********************************************************************
+ *           wow64_NtAlpcSendWaitReceivePort
+ */
+NTSTATUS WINAPI wow64_NtAlpcSendWaitReceivePort( UINT *args )
+{
+    HANDLE port = get_handle( &args );
+    ULONG flags = get_ulong( &args );
+    PORT_MESSAGE32 *send32 = get_ptr( &args );
+    ALPC_MESSAGE_ATTRIBUTES *send_attr = get_ptr( &args );
+    PORT_MESSAGE32 *recv32 = get_ptr( &args );
+    ULONG *size32 = get_ptr( &args );
+    ALPC_MESSAGE_ATTRIBUTES *recv_attr = get_ptr( &args );
+    LARGE_INTEGER *timeout = get_ptr( &args );
+
+    PORT_MESSAGE *send, *recv = NULL;
+    SIZE_T size, *size_ptr;
+    NTSTATUS status;
+
+    size_ptr = port_message_size_32to64( &size, size32 );
+    send = port_message_32to64( send32, send32 ? send32->MessageSize : 0 );
+    if (recv32)
+    {
+        recv = Wow64AllocateTemp( size_ptr ? size : 0xffff );
+        memset( recv, 0, sizeof(*recv) );
+    }
+    status = NtAlpcSendWaitReceivePort( port, flags, send, send_attr, recv, size_ptr, recv_attr, timeout );
+    if (send && !status) send32->MessageId = send->MessageId;
+    if (recv && !status) put_port_message( recv32, recv );
+    if (size_ptr && (!status || status == STATUS_BUFFER_TOO_SMALL)) put_port_message_size( size32, size );
+    return status;
+}
+
+
 /**********************************************************************
  *           wow64_NtCancelTimer
  */
@@ -521,6 +716,18 @@ NTSTATUS WINAPI wow64_NtDuplicateObject( UINT *args )
 }
 
 
+/**********************************************************************
+ *           wow64_NtExtendSection
+ */
+NTSTATUS WINAPI wow64_NtExtendSection( UINT *args )
+{
+    HANDLE handle = get_handle( &args );
+    LARGE_INTEGER *size = get_ptr( &args );
+
+    return NtExtendSection( handle, size );
+}
+
+
 /**********************************************************************
  *           wow64_NtListenPort
  */
@@ -659,6 +659,10 @@ NTSTATUS WINAPI wow64_NtQueryVirtualMemory( UINT *args )
     case MemoryWineUnixWow64Funcs:
         return STATUS_INVALID_INFO_CLASS;
 
+    case MemoryWineUsageInformation:  /* MEMORY_WINE_USAGE_INFORMATION */
+        status = NtQueryVirtualMemory( handle, addr, class, ptr, len, &res_len );
+        break;
+
     case MemoryWineUnixFuncs:
         status = NtQueryVirtualMemory( handle, addr, MemoryWineUnixWow64Funcs, ptr, len, &res_len );
         break;
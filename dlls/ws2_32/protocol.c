@@ -23,6 +23,7 @@
  */
 
 #include "ws2_32_private.h"
+#include "wine/list.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(winsock);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
@@ -45,6 +46,154 @@ static char *get_fqdn(void)
     return ret;
 }
 
+/* The host resolver doesn't tell us the TTL of its results, so they are only
+ * kept for a short time. DnsFlushResolverCache() flushes them as well. */
+#define ADDRINFO_CACHE_TIMEOUT           30000
+#define ADDRINFO_CACHE_NEGATIVE_TIMEOUT  5000
+#define ADDRINFO_CACHE_MAX_ENTRIES       256
+
+struct addrinfo_cache_entry
+{
+    struct list      entry;
+    char            *node;
+    char            *service;
+    struct addrinfo  hints;
+    BOOL             has_hints;
+    int              ret;
+    struct addrinfo *info;
+    unsigned int     size;
+    ULONGLONG        expires;
+};
+
+DECLARE_CRITICAL_SECTION(addrinfo_cache_cs);
+static struct list addrinfo_cache = LIST_INIT( addrinfo_cache );
+static unsigned int addrinfo_cache_count;
+static LONG addrinfo_cache_hits, addrinfo_cache_misses;
+
+/* the results of the Unix side are a single block, which only needs its pointers rebased */
+static struct addrinfo *copy_addrinfo( const struct addrinfo *src, unsigned int size )
+{
+    struct addrinfo *dst, *ai;
+    INT_PTR offset;
+
+    if (!(dst = malloc( size ))) return NULL;
+    memcpy( dst, src, size );
+    offset = (char *)dst - (char *)src;
+    for (ai = dst; ai; ai = ai->ai_next)
+    {
+        if (ai->ai_next) ai->ai_next = (struct addrinfo *)((char *)ai->ai_next + offset);
+        if (ai->ai_addr) ai->ai_addr = (struct sockaddr *)((char *)ai->ai_addr + offset);
+        if (ai->ai_canonname) ai->ai_canonname += offset;
+    }
+    return dst;
+}
+
+static void free_addrinfo_cache_entry( struct addrinfo_cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    addrinfo_cache_count--;
+    free( entry->node );
+    free( entry->service );
+    free( entry->info );
+    free( entry );
+}
+
+static BOOL addrinfo_cache_match( const struct addrinfo_cache_entry *entry, const char *node,
+                                  const char *service, const struct addrinfo *hints )
+{
+    if (_stricmp( entry->node, node )) return FALSE;
+    if (!entry->service != !service || (service && strcmp( entry->service, service ))) return FALSE;
+    if (!entry->has_hints != !hints) return FALSE;
+    return !hints || (entry->hints.ai_flags == hints->ai_flags && entry->hints.ai_family == hints->ai_family &&
+                      entry->hints.ai_socktype == hints->ai_socktype &&
+                      entry->hints.ai_protocol == hints->ai_protocol);
+}
+
+static BOOL addrinfo_cache_lookup( const char *node, const char *service, const struct addrinfo *hints,
+                                   struct addrinfo **info, int *ret )
+{
+    struct addrinfo_cache_entry *entry, *next;
+    ULONGLONG now = GetTickCount64();
+    BOOL found = FALSE;
+
+    EnterCriticalSection( &addrinfo_cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &addrinfo_cache, struct addrinfo_cache_entry, entry )
+    {
+        if (!addrinfo_cache_match( entry, node, service, hints )) continue;
+        if (entry->expires <= now)
+        {
+            free_addrinfo_cache_entry( entry );
+            break;
+        }
+        if (!(*ret = entry->ret) && !(*info = copy_addrinfo( entry->info, entry->size )))
+            *ret = WSA_NOT_ENOUGH_MEMORY;
+        found = TRUE;
+        break;
+    }
+    LeaveCriticalSection( &addrinfo_cache_cs );
+
+    InterlockedIncrement( found ? &addrinfo_cache_hits : &addrinfo_cache_misses );
+    if (found) TRACE( "found %s in cache, ret %d\n", debugstr_a(node), *ret );
+    return found;
+}
+
+static void addrinfo_cache_store( const char *node, const char *service, const struct addrinfo *hints,
+                                  const struct addrinfo *info, unsigned int size, int ret )
+{
+    struct addrinfo_cache_entry *entry;
+    ULONG timeout;
+
+    if (!ret) timeout = ADDRINFO_CACHE_TIMEOUT;
+    else if (ret == WSAHOST_NOT_FOUND || ret == WSANO_DATA) timeout = ADDRINFO_CACHE_NEGATIVE_TIMEOUT;
+    else return;
+
+    if (!(entry = calloc( 1, sizeof(*entry) ))) return;
+    entry->node = strdup( node );
+    entry->service = service ? strdup( service ) : NULL;
+    entry->info = info ? copy_addrinfo( info, size ) : NULL;
+    if (!entry->node || (service && !entry->service) || (info && !entry->info))
+    {
+        free( entry->node );
+        free( entry->service );
+        free( entry->info );
+        free( entry );
+        return;
+    }
+    if ((entry->has_hints = !!hints))
+    {
+        entry->hints.ai_flags    = hints->ai_flags;
+        entry->hints.ai_family   = hints->ai_family;
+        entry->hints.ai_socktype = hints->ai_socktype;
+        entry->hints.ai_protocol = hints->ai_protocol;
+    }
+    entry->ret = ret;
+    entry->size = size;
+    entry->expires = GetTickCount64() + timeout;
+
+    EnterCriticalSection( &addrinfo_cache_cs );
+    list_add_head( &addrinfo_cache, &entry->entry );
+    if (++addrinfo_cache_count > ADDRINFO_CACHE_MAX_ENTRIES)
+        free_addrinfo_cache_entry( LIST_ENTRY( list_tail( &addrinfo_cache ), struct addrinfo_cache_entry, entry ));
+    LeaveCriticalSection( &addrinfo_cache_cs );
+}
+
+/***********************************************************************
+ *      __wine_flush_addrinfo_cache   (ws2_32.@)
+ *
+ * Called by dnsapi when the resolver cache is flushed.
+ */
+void WINAPI __wine_flush_addrinfo_cache(void)
+{
+    struct addrinfo_cache_entry *entry, *next;
+
+    EnterCriticalSection( &addrinfo_cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &addrinfo_cache, struct addrinfo_cache_entry, entry )
+        free_addrinfo_cache_entry( entry );
+    LeaveCriticalSection( &addrinfo_cache_cs );
+
+    TRACE( "%ld hits, %ld misses\n", addrinfo_cache_hits, addrinfo_cache_misses );
+}
+
 /* call Unix getaddrinfo, allocating a large enough buffer */
 static int do_getaddrinfo( const char *node, const char *service,
                            const struct addrinfo *hints, struct addrinfo **info )
@@ -53,18 +202,23 @@ static int do_getaddrinfo( const char *node, const char *service,
     struct getaddrinfo_params params = { node, service, hints, NULL, &size };
     int ret;
 
+    if (node && addrinfo_cache_lookup( node, service, hints, info, &ret )) return ret;
+
     for (;;)
     {
         if (!(params.info = malloc( size )))
             return WSA_NOT_ENOUGH_MEMORY;
         if (!(ret = WS_CALL( getaddrinfo, &params )))
         {
+            if (node) addrinfo_cache_store( node, service, hints, params.info, size, ret );
             *info = params.info;
             return ret;
         }
         free( params.info );
-        if (ret != ERROR_INSUFFICIENT_BUFFER) return ret;
+        if (ret != ERROR_INSUFFICIENT_BUFFER) break;
     }
+    if (node) addrinfo_cache_store( node, service, hints, NULL, 0, ret );
+    return ret;
 }
 
 static int dns_only_query( const char *node, const struct addrinfo *hints, struct addrinfo **result )
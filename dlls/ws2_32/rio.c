@@ -0,0 +1,775 @@
+/*
+ * Registered I/O extension functions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ *
+ * Requests and completions are kept in process memory. The transfers
+ * themselves are nonblocking calls on the unix socket done by ntdll, so
+ * they never involve the server. The server is only used to wait for
+ * sockets to become ready when a notification is requested through
+ * RIONotify().
+ */
+
+#include "ws2_32_private.h"
+#include "wine/list.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(winsock);
+
+struct rio_buffer
+{
+    char *base;
+    DWORD len;
+};
+
+struct rio_request
+{
+    char *buffer;
+    ULONG len;
+    struct sockaddr *addr;      /* remote address for RIOReceiveEx() and RIOSendEx() */
+    ULONG addr_len;
+    DWORD flags;
+    void *context;
+};
+
+/* circular list of the outstanding requests of one direction of a request queue */
+struct rio_ring
+{
+    struct rio_request *requests;
+    ULONG size;
+    ULONG head;
+    ULONG count;
+    ULONG committed;            /* requests at the head which are not deferred */
+};
+
+struct rio_cq
+{
+    CRITICAL_SECTION cs;
+    RIORESULT *results;
+    ULONG size;
+    ULONG head;
+    ULONG count;
+    struct list recv_queues;    /* request queues receiving into this queue */
+    struct list send_queues;    /* request queues sending into this queue */
+    RIO_NOTIFICATION_COMPLETION notify;
+    BOOL has_notify;
+    BOOL armed;                 /* RIONotify() was called and no notification was sent yet */
+    BOOL closing;
+    HANDLE thread;              /* thread waiting for the sockets while armed */
+    HANDLE wake_event;
+    HANDLE poll_event;
+};
+
+struct rio_rq
+{
+    struct list entry;          /* entry in rio_queues */
+    struct list recv_entry;     /* entry in the recv_queues list of recv_cq */
+    struct list send_entry;     /* entry in the send_queues list of send_cq */
+    SOCKET socket;
+    void *context;
+    struct rio_cq *recv_cq;
+    struct rio_cq *send_cq;
+    struct rio_ring recvs;      /* protected by recv_cq->cs */
+    struct rio_ring sends;      /* protected by send_cq->cs */
+};
+
+static struct list rio_queues = LIST_INIT( rio_queues );
+DECLARE_CRITICAL_SECTION(rio_cs);
+
+static struct rio_cq *rio_cq_from_handle( RIO_CQ handle )
+{
+    return (struct rio_cq *)handle;
+}
+
+static struct rio_rq *rio_rq_from_handle( RIO_RQ handle )
+{
+    return (struct rio_rq *)handle;
+}
+
+static BOOL rio_buf_get( const RIO_BUF *buf, char **ptr )
+{
+    const struct rio_buffer *buffer = (const struct rio_buffer *)buf->BufferId;
+
+    if (!buffer || buf->BufferId == RIO_INVALID_BUFFERID) return FALSE;
+    if (buf->Offset > buffer->len || buf->Length > buffer->len - buf->Offset) return FALSE;
+    *ptr = buffer->base + buf->Offset;
+    return TRUE;
+}
+
+static BOOL rio_ring_init( struct rio_ring *ring, ULONG size )
+{
+    memset( ring, 0, sizeof(*ring) );
+    ring->size = size;
+    return !size || (ring->requests = calloc( size, sizeof(*ring->requests) ));
+}
+
+static BOOL rio_ring_resize( struct rio_ring *ring, ULONG size )
+{
+    struct rio_request *requests;
+    ULONG i;
+
+    if (size < ring->count) return FALSE;
+    if (!(requests = calloc( max( size, 1 ), sizeof(*requests) ))) return FALSE;
+    for (i = 0; i < ring->count; i++) requests[i] = ring->requests[(ring->head + i) % ring->size];
+    free( ring->requests );
+    ring->requests = requests;
+    ring->size = size;
+    ring->head = 0;
+    return TRUE;
+}
+
+static void rio_cq_notify( struct rio_cq *cq )
+{
+    TRACE( "cq %p\n", cq );
+
+    if (cq->notify.Type == RIO_EVENT_COMPLETION)
+        SetEvent( cq->notify.Event.EventHandle );
+    else
+        PostQueuedCompletionStatus( cq->notify.Iocp.IocpHandle, 0, (ULONG_PTR)cq->notify.Iocp.CompletionKey,
+                                    cq->notify.Iocp.Overlapped );
+}
+
+/* run the committed requests of a ring in order, until one of them would block;
+ * returns TRUE if a completion which asks for a notification was queued */
+static BOOL rio_ring_process( struct rio_rq *rq, struct rio_ring *ring, struct rio_cq *cq, BOOL send )
+{
+    BOOL notify = FALSE;
+
+    while (ring->committed && cq->count < cq->size)
+    {
+        struct rio_request *req = &ring->requests[ring->head];
+        struct afd_rio_params params;
+        IO_STATUS_BLOCK io;
+        RIORESULT *result;
+        NTSTATUS status;
+
+        params.buffer_ptr = u64_from_user_ptr( req->buffer );
+        params.addr_ptr = u64_from_user_ptr( req->addr );
+        params.len = req->len;
+        params.addr_len = req->addr_len;
+        status = NtDeviceIoControlFile( (HANDLE)rq->socket, NULL, NULL, NULL, &io,
+                                        send ? IOCTL_AFD_WINE_RIO_SEND : IOCTL_AFD_WINE_RIO_RECV,
+                                        &params, sizeof(params), NULL, 0 );
+        if (status == STATUS_DEVICE_NOT_READY) break;
+
+        result = &cq->results[(cq->head + cq->count++) % cq->size];
+        result->Status = status ? NtStatusToWSAError( status ) : 0;
+        result->BytesTransferred = NT_ERROR(status) ? 0 : io.Information;
+        result->SocketContext = (ULONG_PTR)rq->context;
+        result->RequestContext = (ULONG_PTR)req->context;
+        if (!(req->flags & RIO_MSG_DONT_NOTIFY)) notify = TRUE;
+
+        TRACE( "rq %p, %s completed with status %#lx, %lu bytes\n", rq, send ? "send" : "recv",
+               result->Status, result->BytesTransferred );
+
+        ring->head = (ring->head + 1) % ring->size;
+        ring->count--;
+        ring->committed--;
+    }
+    return notify;
+}
+
+/* run the pending requests of every request queue using a completion queue */
+static BOOL rio_cq_process( struct rio_cq *cq )
+{
+    struct rio_rq *rq;
+    BOOL notify = FALSE;
+
+    LIST_FOR_EACH_ENTRY( rq, &cq->recv_queues, struct rio_rq, recv_entry )
+        notify |= rio_ring_process( rq, &rq->recvs, cq, FALSE );
+    LIST_FOR_EACH_ENTRY( rq, &cq->send_queues, struct rio_rq, send_entry )
+        notify |= rio_ring_process( rq, &rq->sends, cq, TRUE );
+    return notify;
+}
+
+/* disarm the queue if a notification is due; the caller sends it once the lock is released */
+static BOOL rio_cq_disarm( struct rio_cq *cq, BOOL notify )
+{
+    if (!cq->armed || !notify) return FALSE;
+    cq->armed = FALSE;
+    return TRUE;
+}
+
+static struct afd_poll_params *rio_cq_get_poll_params( struct rio_cq *cq, struct afd_poll_params *params,
+                                                       ULONG *size )
+{
+    const unsigned int flags = AFD_POLL_HUP | AFD_POLL_RESET | AFD_POLL_CONNECT_ERR;
+    ULONG count = 0, needed;
+    struct rio_rq *rq;
+
+    LIST_FOR_EACH_ENTRY( rq, &cq->recv_queues, struct rio_rq, recv_entry )
+        if (rq->recvs.committed) count++;
+    LIST_FOR_EACH_ENTRY( rq, &cq->send_queues, struct rio_rq, send_entry )
+        if (rq->sends.committed) count++;
+
+    needed = offsetof( struct afd_poll_params, sockets[count] );
+    if (needed > *size)
+    {
+        free( params );
+        *size = 0;
+        if (!(params = malloc( needed ))) return NULL;
+        *size = needed;
+    }
+    memset( params, 0, needed );
+    params->timeout = _I64_MAX;
+
+    LIST_FOR_EACH_ENTRY( rq, &cq->recv_queues, struct rio_rq, recv_entry )
+    {
+        if (!rq->recvs.committed) continue;
+        params->sockets[params->count].socket = rq->socket;
+        params->sockets[params->count++].flags = flags | AFD_POLL_READ;
+    }
+    LIST_FOR_EACH_ENTRY( rq, &cq->send_queues, struct rio_rq, send_entry )
+    {
+        if (!rq->sends.committed) continue;
+        params->sockets[params->count].socket = rq->socket;
+        params->sockets[params->count++].flags = flags | AFD_POLL_WRITE;
+    }
+    return params;
+}
+
+/* waits for the sockets with pending requests while a notification is armed */
+static DWORD WINAPI rio_cq_thread( void *arg )
+{
+    struct rio_cq *cq = arg;
+    struct afd_poll_params *params = NULL;
+    IO_STATUS_BLOCK io, cancel_io;
+    ULONG params_size = 0;
+    NTSTATUS status;
+    BOOL notify;
+
+    SetThreadDescription( GetCurrentThread(), L"wine_rio_notify" );
+
+    EnterCriticalSection( &cq->cs );
+    while (!cq->closing)
+    {
+        HANDLE handles[2] = { cq->poll_event, cq->wake_event };
+
+        notify = rio_cq_disarm( cq, rio_cq_process( cq ) );
+        if (notify || !cq->armed || !(params = rio_cq_get_poll_params( cq, params, &params_size ))
+            || !params->count)
+        {
+            LeaveCriticalSection( &cq->cs );
+            if (notify) rio_cq_notify( cq );
+            else WaitForSingleObject( cq->wake_event, INFINITE );
+            EnterCriticalSection( &cq->cs );
+            continue;
+        }
+        LeaveCriticalSection( &cq->cs );
+
+        status = NtDeviceIoControlFile( (HANDLE)params->sockets[0].socket, cq->poll_event, NULL, NULL, &io,
+                                        IOCTL_AFD_POLL, params, params_size, params, params_size );
+        if (status == STATUS_PENDING
+            && WaitForMultipleObjects( ARRAY_SIZE(handles), handles, FALSE, INFINITE ) != WAIT_OBJECT_0)
+        {
+            /* the sockets to wait for have changed */
+            NtCancelIoFileEx( (HANDLE)params->sockets[0].socket, &io, &cancel_io );
+            WaitForSingleObject( cq->poll_event, INFINITE );
+        }
+        else if (NT_ERROR(status))
+        {
+            /* most likely a socket was closed under us; don't spin on it */
+            WaitForSingleObject( cq->wake_event, 10 );
+        }
+
+        EnterCriticalSection( &cq->cs );
+    }
+    LeaveCriticalSection( &cq->cs );
+
+    free( params );
+    return 0;
+}
+
+static BOOL rio_cq_start_thread( struct rio_cq *cq )
+{
+    if ((cq->wake_event = CreateEventW( NULL, FALSE, FALSE, NULL ))
+        && (cq->poll_event = CreateEventW( NULL, FALSE, FALSE, NULL ))
+        && (cq->thread = CreateThread( NULL, 0, rio_cq_thread, cq, 0, NULL )))
+        return TRUE;
+
+    if (cq->wake_event) CloseHandle( cq->wake_event );
+    if (cq->poll_event) CloseHandle( cq->poll_event );
+    cq->wake_event = cq->poll_event = NULL;
+    return FALSE;
+}
+
+static BOOL rio_post( struct rio_rq *rq, BOOL send, const RIO_BUF *data, ULONG count,
+                      const RIO_BUF *remote_addr, DWORD flags, void *context )
+{
+    struct rio_cq *cq = send ? rq->send_cq : rq->recv_cq;
+    struct rio_ring *ring = send ? &rq->sends : &rq->recvs;
+    struct rio_request new_req = { .flags = flags, .context = context };
+    BOOL notify = FALSE, wake = FALSE;
+    DWORD err = 0;
+
+    if (flags & ~(RIO_MSG_DONT_NOTIFY | RIO_MSG_DEFER | RIO_MSG_WAITALL | RIO_MSG_COMMIT_ONLY))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (flags & RIO_MSG_WAITALL) FIXME( "RIO_MSG_WAITALL is not supported\n" );
+
+    if (flags & RIO_MSG_COMMIT_ONLY)
+    {
+        if (count || data || (flags & RIO_MSG_DEFER))
+        {
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+    }
+    else
+    {
+        if (count > 1 || (count && !rio_buf_get( data, &new_req.buffer )))
+        {
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        if (count) new_req.len = data->Length;
+        if (remote_addr)
+        {
+            char *addr;
+
+            if (!rio_buf_get( remote_addr, &addr ) || remote_addr->Length < sizeof(SOCKADDR_INET))
+            {
+                SetLastError( WSAEINVAL );
+                return FALSE;
+            }
+            new_req.addr = (struct sockaddr *)addr;
+            new_req.addr_len = remote_addr->Length;
+        }
+    }
+
+    EnterCriticalSection( &cq->cs );
+
+    if (!(flags & RIO_MSG_COMMIT_ONLY))
+    {
+        if (ring->count == ring->size)
+            err = WSAENOBUFS;
+        else
+            ring->requests[(ring->head + ring->count++) % ring->size] = new_req;
+    }
+
+    if (!err && !(flags & RIO_MSG_DEFER))
+    {
+        ring->committed = ring->count;
+        notify = rio_cq_disarm( cq, rio_ring_process( rq, ring, cq, send ) );
+        /* let the notification thread wait for this socket too */
+        wake = !notify && cq->armed && ring->committed;
+    }
+
+    LeaveCriticalSection( &cq->cs );
+
+    if (notify) rio_cq_notify( cq );
+    if (wake) SetEvent( cq->wake_event );
+
+    if (err)
+    {
+        SetLastError( err );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL WINAPI RIOReceive( RIO_RQ handle, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    struct rio_rq *rq = rio_rq_from_handle( handle );
+
+    TRACE( "rq %p, data %p, count %lu, flags %#lx, context %p\n", rq, data, count, flags, context );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    return rio_post( rq, FALSE, data, count, NULL, flags, context );
+}
+
+static int WINAPI RIOReceiveEx( RIO_RQ handle, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                                DWORD flags, void *context )
+{
+    struct rio_rq *rq = rio_rq_from_handle( handle );
+
+    TRACE( "rq %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", rq, data, count, local_addr, remote_addr, control, msg_flags, flags, context );
+
+    if (local_addr || control || msg_flags)
+        FIXME( "ignoring local address %p, control %p, flags %p\n", local_addr, control, msg_flags );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    return rio_post( rq, FALSE, data, count, remote_addr, flags, context );
+}
+
+static BOOL WINAPI RIOSend( RIO_RQ handle, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    struct rio_rq *rq = rio_rq_from_handle( handle );
+
+    TRACE( "rq %p, data %p, count %lu, flags %#lx, context %p\n", rq, data, count, flags, context );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    return rio_post( rq, TRUE, data, count, NULL, flags, context );
+}
+
+static BOOL WINAPI RIOSendEx( RIO_RQ handle, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                              RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                              DWORD flags, void *context )
+{
+    struct rio_rq *rq = rio_rq_from_handle( handle );
+
+    TRACE( "rq %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", rq, data, count, local_addr, remote_addr, control, msg_flags, flags, context );
+
+    if (local_addr || control || msg_flags)
+        FIXME( "ignoring local address %p, control %p, flags %p\n", local_addr, control, msg_flags );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    return rio_post( rq, TRUE, data, count, remote_addr, flags, context );
+}
+
+static RIO_CQ WINAPI RIOCreateCompletionQueue( DWORD size, RIO_NOTIFICATION_COMPLETION *notify )
+{
+    struct rio_cq *cq;
+
+    TRACE( "size %lu, notify %p\n", size, notify );
+
+    if (!size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (notify && !(notify->Type == RIO_EVENT_COMPLETION && notify->Event.EventHandle)
+        && !(notify->Type == RIO_IOCP_COMPLETION && notify->Iocp.IocpHandle))
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+
+    if (!(cq = calloc( 1, sizeof(*cq) )) || !(cq->results = calloc( size, sizeof(*cq->results) )))
+    {
+        free( cq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_CQ;
+    }
+    cq->size = size;
+    list_init( &cq->recv_queues );
+    list_init( &cq->send_queues );
+    if (notify)
+    {
+        cq->notify = *notify;
+        cq->has_notify = TRUE;
+    }
+    InitializeCriticalSectionEx( &cq->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
+    cq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_cq.cs");
+
+    TRACE( "returning %p\n", cq );
+    return (RIO_CQ)cq;
+}
+
+static void WINAPI RIOCloseCompletionQueue( RIO_CQ handle )
+{
+    struct rio_cq *cq = rio_cq_from_handle( handle );
+
+    TRACE( "cq %p\n", cq );
+
+    if (!cq) return;
+
+    EnterCriticalSection( &cq->cs );
+    if (!list_empty( &cq->recv_queues ) || !list_empty( &cq->send_queues ))
+        WARN( "closing cq %p while request queues still use it\n", cq );
+    cq->closing = TRUE;
+    LeaveCriticalSection( &cq->cs );
+
+    if (cq->thread)
+    {
+        SetEvent( cq->wake_event );
+        WaitForSingleObject( cq->thread, INFINITE );
+        CloseHandle( cq->thread );
+        CloseHandle( cq->wake_event );
+        CloseHandle( cq->poll_event );
+    }
+
+    cq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cq->cs );
+    free( cq->results );
+    free( cq );
+}
+
+static BOOL WINAPI RIOResizeCompletionQueue( RIO_CQ handle, DWORD size )
+{
+    struct rio_cq *cq = rio_cq_from_handle( handle );
+    RIORESULT *results;
+    ULONG i;
+
+    TRACE( "cq %p, size %lu\n", cq, size );
+
+    if (!cq || !size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (size < cq->count)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (!(results = calloc( size, sizeof(*results) )))
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    for (i = 0; i < cq->count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    free( cq->results );
+    cq->results = results;
+    cq->size = size;
+    cq->head = 0;
+    LeaveCriticalSection( &cq->cs );
+    return TRUE;
+}
+
+static ULONG WINAPI RIODequeueCompletion( RIO_CQ handle, RIORESULT *results, ULONG size )
+{
+    struct rio_cq *cq = rio_cq_from_handle( handle );
+    ULONG i, count;
+    BOOL notify;
+
+    TRACE( "cq %p, results %p, size %lu\n", cq, results, size );
+
+    if (!cq || !results) return RIO_CORRUPT_CQ;
+
+    EnterCriticalSection( &cq->cs );
+    notify = rio_cq_disarm( cq, rio_cq_process( cq ) );
+    count = min( size, cq->count );
+    for (i = 0; i < count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    cq->head = (cq->head + count) % cq->size;
+    cq->count -= count;
+    LeaveCriticalSection( &cq->cs );
+
+    if (notify) rio_cq_notify( cq );
+
+    TRACE( "returning %lu results\n", count );
+    return count;
+}
+
+static int WINAPI RIONotify( RIO_CQ handle )
+{
+    struct rio_cq *cq = rio_cq_from_handle( handle );
+    BOOL notify = FALSE, wake = FALSE;
+    DWORD err = 0;
+
+    TRACE( "cq %p\n", cq );
+
+    if (!cq || !cq->has_notify) return WSAEINVAL;
+
+    if (cq->notify.Type == RIO_EVENT_COMPLETION && cq->notify.Event.NotifyReset)
+        ResetEvent( cq->notify.Event.EventHandle );
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->armed)
+        err = WSAEALREADY;
+    else
+    {
+        rio_cq_process( cq );
+        if (cq->count)
+            notify = TRUE;
+        else if (!cq->thread && !rio_cq_start_thread( cq ))
+            err = WSAENOBUFS;
+        else
+        {
+            cq->armed = TRUE;
+            wake = TRUE;
+        }
+    }
+    LeaveCriticalSection( &cq->cs );
+
+    if (notify) rio_cq_notify( cq );
+    if (wake) SetEvent( cq->wake_event );
+    return err;
+}
+
+static RIO_RQ WINAPI RIOCreateRequestQueue( SOCKET s, ULONG max_recvs, ULONG max_recv_buffers,
+                                            ULONG max_sends, ULONG max_send_buffers,
+                                            RIO_CQ recv_handle, RIO_CQ send_handle, void *context )
+{
+    struct rio_cq *recv_cq = rio_cq_from_handle( recv_handle ), *send_cq = rio_cq_from_handle( send_handle );
+    struct rio_rq *rq, *other;
+    int type, len = sizeof(type);
+
+    TRACE( "socket %#Ix, recvs %lu/%lu, sends %lu/%lu, recv_cq %p, send_cq %p, context %p\n",
+           s, max_recvs, max_recv_buffers, max_sends, max_send_buffers, recv_cq, send_cq, context );
+
+    if (!recv_cq || !send_cq || max_recv_buffers > 1 || max_send_buffers > 1)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    if (getsockopt( s, SOL_SOCKET, SO_TYPE, (char *)&type, &len )) return RIO_INVALID_RQ;
+
+    if (!(rq = calloc( 1, sizeof(*rq) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    rq->socket = s;
+    rq->context = context;
+    rq->recv_cq = recv_cq;
+    rq->send_cq = send_cq;
+    if (!rio_ring_init( &rq->recvs, max_recvs ) || !rio_ring_init( &rq->sends, max_sends ))
+    {
+        free( rq->recvs.requests );
+        free( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+
+    EnterCriticalSection( &rio_cs );
+    LIST_FOR_EACH_ENTRY( other, &rio_queues, struct rio_rq, entry )
+    {
+        if (other->socket != s) continue;
+        LeaveCriticalSection( &rio_cs );
+        free( rq->recvs.requests );
+        free( rq->sends.requests );
+        free( rq );
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    list_add_tail( &rio_queues, &rq->entry );
+
+    EnterCriticalSection( &recv_cq->cs );
+    list_add_tail( &recv_cq->recv_queues, &rq->recv_entry );
+    LeaveCriticalSection( &recv_cq->cs );
+    EnterCriticalSection( &send_cq->cs );
+    list_add_tail( &send_cq->send_queues, &rq->send_entry );
+    LeaveCriticalSection( &send_cq->cs );
+    LeaveCriticalSection( &rio_cs );
+
+    TRACE( "returning %p\n", rq );
+    return (RIO_RQ)rq;
+}
+
+static BOOL WINAPI RIOResizeRequestQueue( RIO_RQ handle, DWORD max_recvs, DWORD max_sends )
+{
+    struct rio_rq *rq = rio_rq_from_handle( handle );
+    BOOL ret;
+
+    TRACE( "rq %p, recvs %lu, sends %lu\n", rq, max_recvs, max_sends );
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->recv_cq->cs );
+    ret = rio_ring_resize( &rq->recvs, max_recvs );
+    LeaveCriticalSection( &rq->recv_cq->cs );
+    if (ret)
+    {
+        EnterCriticalSection( &rq->send_cq->cs );
+        ret = rio_ring_resize( &rq->sends, max_sends );
+        LeaveCriticalSection( &rq->send_cq->cs );
+    }
+    if (!ret) SetLastError( WSAEINVAL );
+    return ret;
+}
+
+static RIO_BUFFERID WINAPI RIORegisterBuffer( char *ptr, DWORD len )
+{
+    struct rio_buffer *buffer;
+
+    TRACE( "ptr %p, len %lu\n", ptr, len );
+
+    if (!ptr || !len)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_BUFFERID;
+    }
+    if (!(buffer = malloc( sizeof(*buffer) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_BUFFERID;
+    }
+    buffer->base = ptr;
+    buffer->len = len;
+    return (RIO_BUFFERID)buffer;
+}
+
+static void WINAPI RIODeregisterBuffer( RIO_BUFFERID id )
+{
+    TRACE( "id %p\n", id );
+
+    if (id == RIO_INVALID_BUFFERID) return;
+    free( id );
+}
+
+const RIO_EXTENSION_FUNCTION_TABLE rio_function_table =
+{
+    sizeof(RIO_EXTENSION_FUNCTION_TABLE),
+    RIOReceive,
+    RIOReceiveEx,
+    RIOSend,
+    RIOSendEx,
+    RIOCloseCompletionQueue,
+    RIOCreateCompletionQueue,
+    RIOCreateRequestQueue,
+    RIODequeueCompletion,
+    RIODeregisterBuffer,
+    RIONotify,
+    RIORegisterBuffer,
+    RIOResizeCompletionQueue,
+    RIOResizeRequestQueue,
+};
+
+/* the request queue of a socket goes away when the socket is closed */
+void rio_close_socket( SOCKET s )
+{
+    struct rio_rq *rq;
+
+    EnterCriticalSection( &rio_cs );
+    LIST_FOR_EACH_ENTRY( rq, &rio_queues, struct rio_rq, entry )
+    {
+        if (rq->socket != s) continue;
+
+        TRACE( "closing rq %p\n", rq );
+        list_remove( &rq->entry );
+        EnterCriticalSection( &rq->recv_cq->cs );
+        list_remove( &rq->recv_entry );
+        LeaveCriticalSection( &rq->recv_cq->cs );
+        EnterCriticalSection( &rq->send_cq->cs );
+        list_remove( &rq->send_entry );
+        LeaveCriticalSection( &rq->send_cq->cs );
+        LeaveCriticalSection( &rio_cs );
+
+        free( rq->recvs.requests );
+        free( rq->sends.requests );
+        free( rq );
+        return;
+    }
+    LeaveCriticalSection( &rio_cs );
+}
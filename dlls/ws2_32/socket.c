@@ -35,8 +35,6 @@ WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define TIMEOUT_INFINITE _I64_MAX
 
-#define u64_from_user_ptr(ptr) ((ULONGLONG)(uintptr_t)(ptr))
-
 static const WSAPROTOCOL_INFOW supported_protocols[] =
 {
     {
@@ -169,10 +167,12 @@ static const WSAPROTOCOL_INFOW supported_protocols[] =
     },
 };
 
-DECLARE_CRITICAL_SECTION(cs_socket_list);
+/* our sockets are tracked in a bitmap indexed by handle, allocated in blocks as
+ * needed. Blocks are never freed, so lookups and updates don't need a lock. */
+#define SOCKET_BLOCK_BITS  (4096 * 32)
+#define SOCKET_BLOCKS      (0x04000000 / 4 / SOCKET_BLOCK_BITS)
 
-static SOCKET *socket_list;
-static unsigned int socket_list_size;
+static LONG *socket_blocks[SOCKET_BLOCKS];
 
 const char *debugstr_sockaddr( const struct sockaddr *a )
 {
@@ -366,74 +366,55 @@ static inline const char *debugstr_optval(const char *optval, int optlenval)
 #define SOCKET2HANDLE(s) ((HANDLE)(s))
 #define HANDLE2SOCKET(h) ((SOCKET)(h))
 
+static BOOL socket_to_index( SOCKET socket, unsigned int *block, unsigned int *bit )
+{
+    UINT_PTR index = socket >> 2;
+
+    if (!socket || (socket & 3) || index >= SOCKET_BLOCKS * SOCKET_BLOCK_BITS) return FALSE;
+    *block = index / SOCKET_BLOCK_BITS;
+    *bit = index % SOCKET_BLOCK_BITS;
+    return TRUE;
+}
+
+
 static BOOL socket_list_add(SOCKET socket)
 {
-    unsigned int i, new_size;
-    SOCKET *new_array;
+    unsigned int block, bit;
+    LONG *bits;
 
-    EnterCriticalSection(&cs_socket_list);
-    for (i = 0; i < socket_list_size; ++i)
+    if (!socket_to_index( socket, &block, &bit )) return FALSE;
+
+    if (!(bits = socket_blocks[block]))
     {
-        if (!socket_list[i])
+        if (!(bits = calloc( SOCKET_BLOCK_BITS / 32, sizeof(*bits) ))) return FALSE;
+        if (InterlockedCompareExchangePointer( (void **)&socket_blocks[block], bits, NULL ))
         {
-            socket_list[i] = socket;
-            LeaveCriticalSection(&cs_socket_list);
-            return TRUE;
+            free( bits );
+            bits = socket_blocks[block];
         }
     }
-    new_size = max(socket_list_size * 2, 8);
-    if (!(new_array = realloc( socket_list, new_size * sizeof(*socket_list) )))
-    {
-        LeaveCriticalSection(&cs_socket_list);
-        return FALSE;
-    }
-    socket_list = new_array;
-    memset(socket_list + socket_list_size, 0, (new_size - socket_list_size) * sizeof(*socket_list));
-    socket_list[socket_list_size] = socket;
-    socket_list_size = new_size;
-    LeaveCriticalSection(&cs_socket_list);
+    InterlockedOr( &bits[bit / 32], 1u << (bit % 32) );
     return TRUE;
 }
 
 
 static BOOL socket_list_find( SOCKET socket )
 {
-    unsigned int i;
-
-    if (!socket) return FALSE;
+    unsigned int block, bit;
+    LONG *bits;
 
-    EnterCriticalSection( &cs_socket_list );
-    for (i = 0; i < socket_list_size; ++i)
-    {
-        if (socket_list[i] == socket)
-        {
-            LeaveCriticalSection( &cs_socket_list );
-            return TRUE;
-        }
-    }
-    LeaveCriticalSection( &cs_socket_list );
-    return FALSE;
+    if (!socket_to_index( socket, &block, &bit ) || !(bits = socket_blocks[block])) return FALSE;
+    return !!(ReadNoFence( &bits[bit / 32] ) & (1u << (bit % 32)));
 }
 
 
 static BOOL socket_list_remove( SOCKET socket )
 {
-    unsigned int i;
+    unsigned int block, bit;
+    LONG *bits;
 
-    if (!socket) return FALSE;
-
-    EnterCriticalSection(&cs_socket_list);
-    for (i = 0; i < socket_list_size; ++i)
-    {
-        if (socket_list[i] == socket)
-        {
-            socket_list[i] = 0;
-            LeaveCriticalSection( &cs_socket_list );
-            return TRUE;
-        }
-    }
-    LeaveCriticalSection(&cs_socket_list);
-    return FALSE;
+    if (!socket_to_index( socket, &block, &bit ) || !(bits = socket_blocks[block])) return FALSE;
+    return !!(InterlockedAnd( &bits[bit / 32], ~(1u << (bit % 32)) ) & (1u << (bit % 32)));
 }
 
 static INT WINAPI WSA_DefaultBlockingHook( FARPROC x );
@@ -444,7 +425,7 @@ static FARPROC blocking_hook = (FARPROC)WSA_DefaultBlockingHook;
 /* function prototypes */
 static int ws_protocol_info(SOCKET s, int unicode, WSAPROTOCOL_INFOW *buffer, int *size);
 
-static DWORD NtStatusToWSAError( NTSTATUS status )
+DWORD NtStatusToWSAError( NTSTATUS status )
 {
     static const struct
     {
@@ -636,11 +617,22 @@ INT WINAPI WSACleanup(void)
     {
         if (!--num_startup)
         {
-            unsigned int i;
+            unsigned int block, i, bit;
+            LONG bits;
 
-            for (i = 0; i < socket_list_size; ++i)
-                CloseHandle(SOCKET2HANDLE(socket_list[i]));
-            memset(socket_list, 0, socket_list_size * sizeof(*socket_list));
+            for (block = 0; block < SOCKET_BLOCKS; ++block)
+            {
+                if (!socket_blocks[block]) continue;
+                for (i = 0; i < SOCKET_BLOCK_BITS / 32; ++i)
+                {
+                    if (!(bits = InterlockedExchange( &socket_blocks[block][i], 0 ))) continue;
+                    for (bit = 0; bit < 32; ++bit)
+                    {
+                        if (bits & (1u << bit))
+                            CloseHandle( SOCKET2HANDLE(((UINT_PTR)block * SOCKET_BLOCK_BITS + i * 32 + bit) << 2) );
+                    }
+                }
+            }
         }
         return 0;
     }
@@ -1207,6 +1199,7 @@ int WINAPI closesocket( SOCKET s )
         return -1;
     }
 
+    rio_close_socket( s );
     CloseHandle( (HANDLE)s );
     return 0;
 }
@@ -2139,6 +2132,7 @@ static const char *debugstr_wsaioctl(DWORD code)
         IOCTL_NAME(SIO_FLUSH);
         IOCTL_NAME(SIO_GET_BROADCAST_ADDRESS);
         IOCTL_NAME(SIO_GET_EXTENSION_FUNCTION_POINTER);
+        IOCTL_NAME(SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER);
         IOCTL_NAME(SIO_GET_GROUP_QOS);
         IOCTL_NAME(SIO_GET_INTERFACE_LIST);
         /* IOCTL_NAME(SIO_GET_INTERFACE_LIST_EX); */
@@ -2514,6 +2508,35 @@ INT WINAPI WSAIoctl(SOCKET s, DWORD code, LPVOID in_buff, DWORD in_size, LPVOID
         return -1;
     }
 
+    case SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER:
+    {
+        static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+        NTSTATUS status = STATUS_SUCCESS;
+        DWORD ret;
+
+        if (in_size < sizeof(GUID) || !IsEqualGUID( &rio_guid, in_buff ))
+        {
+            FIXME( "SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER %s: stub\n",
+                   in_size < sizeof(GUID) ? "(null)" : debugstr_guid(in_buff) );
+            SetLastError( WSAEINVAL );
+            return -1;
+        }
+        if (out_size < sizeof(rio_function_table))
+        {
+            SetLastError( WSAEFAULT );
+            return -1;
+        }
+
+        TRACE( "returning the registered I/O functions\n" );
+        memcpy( out_buff, &rio_function_table, sizeof(rio_function_table) );
+
+        ret = server_ioctl_sock( s, IOCTL_AFD_WINE_COMPLETE_ASYNC, &status, sizeof(status),
+                                 NULL, 0, ret_size, overlapped, completion );
+        *ret_size = sizeof(rio_function_table);
+        SetLastError( ret );
+        return ret ? -1 : 0;
+    }
+
     case SIO_KEEPALIVE_VALS:
     {
         DWORD ret;
@@ -14067,6 +14067,273 @@ static void test_connect_udp(void)
     closesocket(client);
 }
 
+static void test_udp_overlapped_burst(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    struct
+    {
+        WSAOVERLAPPED overlapped;
+        struct sockaddr_in addr;
+        int addr_len;
+        DWORD flags;
+        WSABUF wsabuf;
+        char buffer[16];
+    } recvs[16];
+    WSAOVERLAPPED send_overlapped[ARRAY_SIZE(recvs)];
+    char send_data[ARRAY_SIZE(recvs)][16];
+    WSABUF send_bufs[ARRAY_SIZE(recvs)];
+    struct sockaddr_in addr, client_addr;
+    SOCKET client, server;
+    DWORD size, flags;
+    unsigned int i;
+    int ret, len;
+    BOOL bret;
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    ret = bind(server, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = bind(client, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(client_addr);
+    ret = getsockname(client, (struct sockaddr *)&client_addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < ARRAY_SIZE(recvs); ++i)
+    {
+        memset(&recvs[i], 0, sizeof(recvs[i]));
+        recvs[i].overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        recvs[i].addr_len = sizeof(recvs[i].addr);
+        recvs[i].wsabuf.buf = recvs[i].buffer;
+        recvs[i].wsabuf.len = sizeof(recvs[i].buffer);
+        ret = WSARecvFrom(server, &recvs[i].wsabuf, 1, NULL, &recvs[i].flags, (struct sockaddr *)&recvs[i].addr,
+                          &recvs[i].addr_len, &recvs[i].overlapped, NULL);
+        ok(ret == -1, "recv %u: got %d\n", i, ret);
+        ok(WSAGetLastError() == ERROR_IO_PENDING, "recv %u: got error %u\n", i, WSAGetLastError());
+    }
+
+    /* send datagrams of different sizes, all of them at once */
+    for (i = 0; i < ARRAY_SIZE(send_bufs); ++i)
+    {
+        sprintf(send_data[i], "datagram %u", i * 37);
+        send_bufs[i].buf = send_data[i];
+        send_bufs[i].len = strlen(send_data[i]) + 1;
+        memset(&send_overlapped[i], 0, sizeof(send_overlapped[i]));
+        send_overlapped[i].hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        ret = WSASendTo(client, &send_bufs[i], 1, NULL, 0, (struct sockaddr *)&addr, sizeof(addr),
+                        &send_overlapped[i], NULL);
+        ok(!ret || WSAGetLastError() == ERROR_IO_PENDING, "send %u: got error %u\n", i, WSAGetLastError());
+    }
+
+    for (i = 0; i < ARRAY_SIZE(send_bufs); ++i)
+    {
+        ret = WaitForSingleObject(send_overlapped[i].hEvent, 1000);
+        ok(!ret, "send %u: wait returned %d\n", i, ret);
+        bret = WSAGetOverlappedResult(client, &send_overlapped[i], &size, FALSE, &flags);
+        ok(bret, "send %u: got error %u\n", i, WSAGetLastError());
+        ok(size == send_bufs[i].len, "send %u: got size %lu\n", i, size);
+        CloseHandle(send_overlapped[i].hEvent);
+    }
+
+    /* the receives complete in order, each with its own datagram */
+    for (i = 0; i < ARRAY_SIZE(recvs); ++i)
+    {
+        ret = WaitForSingleObject(recvs[i].overlapped.hEvent, 1000);
+        ok(!ret, "recv %u: wait returned %d\n", i, ret);
+        bret = WSAGetOverlappedResult(server, &recvs[i].overlapped, &size, FALSE, &flags);
+        ok(bret, "recv %u: got error %u\n", i, WSAGetLastError());
+        ok(size == send_bufs[i].len, "recv %u: got size %lu\n", i, size);
+        ok(!strcmp(recvs[i].buffer, send_data[i]), "recv %u: got %s\n", i, debugstr_a(recvs[i].buffer));
+        ok(recvs[i].addr_len == sizeof(client_addr), "recv %u: got address length %d\n", i, recvs[i].addr_len);
+        ok(!memcmp(&recvs[i].addr, &client_addr, sizeof(client_addr)), "recv %u: addresses didn't match\n", i);
+        CloseHandle(recvs[i].overlapped.hEvent);
+    }
+
+    closesocket(server);
+    closesocket(client);
+}
+
+static void test_rio(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+    RIO_NOTIFICATION_COMPLETION notify;
+    RIO_EXTENSION_FUNCTION_TABLE rio;
+    struct sockaddr_in addr, client_addr;
+    RIO_BUF bufs[4], addr_buf, send_buf;
+    RIORESULT results[8];
+    SOCKADDR_INET *remote;
+    RIO_BUFFERID buffer_id;
+    RIO_CQ recv_cq, send_cq;
+    SOCKET client, server;
+    unsigned int i, seen;
+    char buffer[512];
+    HANDLE event;
+    DWORD size;
+    RIO_RQ rq;
+    ULONG count;
+    int ret, len;
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    server = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+    ok(server != INVALID_SOCKET, "got error %u\n", WSAGetLastError());
+
+    memset(&rio, 0, sizeof(rio));
+    ret = WSAIoctl(server, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, (void *)&rio_guid, sizeof(rio_guid),
+                   &rio, sizeof(rio), &size, NULL, NULL);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    if (ret)
+    {
+        closesocket(server);
+        closesocket(client);
+        return;
+    }
+    ok(size == sizeof(rio), "got size %lu\n", size);
+    ok(rio.cbSize == sizeof(rio), "got cbSize %lu\n", rio.cbSize);
+
+    ret = bind(server, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = bind(client, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(client_addr);
+    ret = getsockname(client, (struct sockaddr *)&client_addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    buffer_id = rio.RIORegisterBuffer(buffer, sizeof(buffer));
+    ok(buffer_id != RIO_INVALID_BUFFERID, "got error %u\n", WSAGetLastError());
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    memset(&notify, 0, sizeof(notify));
+    notify.Type = RIO_EVENT_COMPLETION;
+    notify.Event.EventHandle = event;
+    recv_cq = rio.RIOCreateCompletionQueue(ARRAY_SIZE(results), &notify);
+    ok(recv_cq != RIO_INVALID_CQ, "got error %u\n", WSAGetLastError());
+    send_cq = rio.RIOCreateCompletionQueue(ARRAY_SIZE(results), NULL);
+    ok(send_cq != RIO_INVALID_CQ, "got error %u\n", WSAGetLastError());
+    ret = rio.RIONotify(send_cq);
+    ok(ret == WSAEINVAL, "got %d\n", ret);
+
+    rq = rio.RIOCreateRequestQueue(server, ARRAY_SIZE(bufs), 1, 1, 1, recv_cq, send_cq, (void *)0xdead);
+    ok(rq != RIO_INVALID_RQ, "got error %u\n", WSAGetLastError());
+
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(!count, "got %lu completions\n", count);
+
+    for (i = 0; i < ARRAY_SIZE(bufs); ++i)
+    {
+        bufs[i].BufferId = buffer_id;
+        bufs[i].Offset = i * 64;
+        bufs[i].Length = 64;
+        ret = rio.RIOReceive(rq, &bufs[i], 1, 0, (void *)(ULONG_PTR)(i + 1));
+        ok(ret, "recv %u: got error %u\n", i, WSAGetLastError());
+    }
+    ret = rio.RIOReceive(rq, &bufs[0], 1, 0, NULL);
+    ok(!ret, "expected failure\n");
+    ok(WSAGetLastError() == WSAENOBUFS, "got error %u\n", WSAGetLastError());
+
+    ret = rio.RIONotify(recv_cq);
+    ok(!ret, "got %d\n", ret);
+    ret = rio.RIONotify(recv_cq);
+    ok(ret == WSAEALREADY, "got %d\n", ret);
+
+    for (i = 0; i < ARRAY_SIZE(bufs); ++i)
+    {
+        char data[16];
+
+        sprintf(data, "datagram %u", i);
+        ret = sendto(client, data, strlen(data) + 1, 0, (struct sockaddr *)&addr, sizeof(addr));
+        ok(ret == strlen(data) + 1, "got %d\n", ret);
+    }
+
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait returned %d\n", ret);
+
+    for (seen = 0; seen < ARRAY_SIZE(bufs); seen += count)
+    {
+        count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+        ok(count != RIO_CORRUPT_CQ, "got corrupt queue\n");
+        for (i = 0; i < count; ++i)
+        {
+            unsigned int index = seen + i;
+            char expect[16];
+
+            sprintf(expect, "datagram %u", index);
+            ok(!results[i].Status, "result %u: got status %ld\n", index, results[i].Status);
+            ok(results[i].BytesTransferred == strlen(expect) + 1, "result %u: got %lu bytes\n",
+               index, results[i].BytesTransferred);
+            ok(results[i].SocketContext == 0xdead, "result %u: got socket context %#I64x\n",
+               index, results[i].SocketContext);
+            ok(results[i].RequestContext == index + 1, "result %u: got request context %#I64x\n",
+               index, results[i].RequestContext);
+            ok(!strcmp(buffer + index * 64, expect), "result %u: got %s\n", index, debugstr_a(buffer + index * 64));
+        }
+        if (!count)
+        {
+            ret = rio.RIONotify(recv_cq);
+            ok(!ret, "got %d\n", ret);
+            if (WaitForSingleObject(event, 1000)) break;
+        }
+    }
+    ok(seen == ARRAY_SIZE(bufs), "got %u completions\n", seen);
+
+    /* receive with the sender address */
+    addr_buf.BufferId = buffer_id;
+    addr_buf.Offset = 256;
+    addr_buf.Length = sizeof(SOCKADDR_INET);
+    ret = rio.RIOReceiveEx(rq, &bufs[0], 1, NULL, &addr_buf, NULL, NULL, 0, NULL);
+    ok(ret, "got error %u\n", WSAGetLastError());
+    ret = sendto(client, "data", 4, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 4, "got %d\n", ret);
+    ret = rio.RIONotify(recv_cq);
+    ok(!ret, "got %d\n", ret);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "wait returned %d\n", ret);
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(count == 1, "got %lu completions\n", count);
+    ok(results[0].BytesTransferred == 4, "got %lu bytes\n", results[0].BytesTransferred);
+    remote = (SOCKADDR_INET *)(buffer + 256);
+    ok(remote->si_family == AF_INET, "got family %u\n", remote->si_family);
+    ok(remote->Ipv4.sin_port == client_addr.sin_port, "got port %u\n", ntohs(remote->Ipv4.sin_port));
+
+    /* send back to the client */
+    memcpy(buffer + 300, "reply", 5);
+    send_buf.BufferId = buffer_id;
+    send_buf.Offset = 300;
+    send_buf.Length = 5;
+    memcpy(buffer + 256, &client_addr, sizeof(client_addr));
+    ret = rio.RIOSendEx(rq, &send_buf, 1, NULL, &addr_buf, NULL, NULL, 0, (void *)0xbeef);
+    ok(ret, "got error %u\n", WSAGetLastError());
+    for (i = 0; i < 100; ++i)
+    {
+        if ((count = rio.RIODequeueCompletion(send_cq, results, ARRAY_SIZE(results)))) break;
+        Sleep(10);
+    }
+    ok(count == 1, "got %lu completions\n", count);
+    ok(!results[0].Status, "got status %ld\n", results[0].Status);
+    ok(results[0].BytesTransferred == 5, "got %lu bytes\n", results[0].BytesTransferred);
+    ok(results[0].RequestContext == 0xbeef, "got request context %#I64x\n", results[0].RequestContext);
+
+    memset(buffer, 0, 16);
+    set_blocking(client, FALSE);
+    ret = recv(client, buffer, 16, 0);
+    ok(ret == 5, "got %d\n", ret);
+    ok(!memcmp(buffer, "reply", 5), "got %s\n", debugstr_an(buffer, 5));
+
+    closesocket(server);
+    closesocket(client);
+    rio.RIOCloseCompletionQueue(recv_cq);
+    rio.RIOCloseCompletionQueue(send_cq);
+    rio.RIODeregisterBuffer(buffer_id);
+    CloseHandle(event);
+}
+
 static void test_tcp_sendto_recvfrom(void)
 {
     SOCKET client, server = 0;
@@ -14211,6 +14478,8 @@ START_TEST( sock )
     test_tcp_reset();
     test_icmp();
     test_connect_udp();
+    test_udp_overlapped_burst();
+    test_rio();
     test_tcp_sendto_recvfrom();
 
     /* There is apparently an obscure interaction between this test and
@@ -135,3 +135,6 @@
 @ stdcall getnameinfo(ptr long ptr long ptr long long)
 @ stdcall inet_ntop(long ptr ptr long)
 @ stdcall inet_pton(long str ptr)
+
+# Wine internal extensions
+@ stdcall __wine_flush_addrinfo_cache()
@@ -71,9 +71,15 @@ static inline char *strdupWtoA( const WCHAR *str )
     return ret;
 }
 
+#define u64_from_user_ptr(ptr) ((ULONGLONG)(uintptr_t)(ptr))
+
 static const char magic_loopback_addr[] = {127, 12, 34, 56};
 
 const char *debugstr_sockaddr( const struct sockaddr *addr );
+DWORD NtStatusToWSAError( NTSTATUS status );
+
+extern const RIO_EXTENSION_FUNCTION_TABLE rio_function_table;
+void rio_close_socket( SOCKET s );
 
 struct per_thread_data
 {
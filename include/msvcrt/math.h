@@ -71,6 +71,7 @@ _ACRTIMP double __cdecl frexp(double, int*);
 _ACRTIMP double __cdecl modf(double, double*);
 _ACRTIMP double __cdecl fdim(double, double);
 _ACRTIMP double __cdecl fmod(double, double);
+_ACRTIMP double __cdecl fma(double, double, double);
 _ACRTIMP double __cdecl fmin(double, double);
 _ACRTIMP double __cdecl fmax(double, double);
 _ACRTIMP double __cdecl erf(double);
@@ -222,6 +223,7 @@ _ACRTIMP float __cdecl asinhf(float);
 _ACRTIMP float __cdecl atanhf(float);
 _ACRTIMP float __cdecl erff(float);
 _ACRTIMP float __cdecl fdimf(float, float);
+_ACRTIMP float __cdecl fmaf(float, float, float);
 _ACRTIMP float __cdecl fmaxf(float, float);
 _ACRTIMP float __cdecl fminf(float, float);
 _ACRTIMP float __cdecl lgammaf(float);
@@ -321,6 +321,15 @@ typedef struct _SecPkgContext_ConnectionInfo
     DWORD dwExchStrength;
 } SecPkgContext_ConnectionInfo, *PSecPkgContext_ConnectionInfo;
 
+#define SSL_SESSION_RECONNECT 1
+
+typedef struct _SecPkgContext_SessionInfo
+{
+    DWORD dwFlags;
+    DWORD cbSessionId;
+    BYTE rgbSessionId[32];
+} SecPkgContext_SessionInfo, *PSecPkgContext_SessionInfo;
+
 #define SECPKGCONTEXT_CIPHERINFO_V1 1
 #define SZ_ALG_MAX_SIZE 64
 
@@ -285,6 +285,9 @@ C_ASSERT( sizeof(struct afd_get_events_params) == 56 );
 #define IOCTL_AFD_WINE_SET_IP_RECVTOS                   WINE_AFD_IOC(296)
 #define IOCTL_AFD_WINE_GET_SO_EXCLUSIVEADDRUSE          WINE_AFD_IOC(297)
 #define IOCTL_AFD_WINE_SET_SO_EXCLUSIVEADDRUSE          WINE_AFD_IOC(298)
+#define IOCTL_AFD_WINE_RIO_RECV                         WINE_AFD_IOC(299)
+#define IOCTL_AFD_WINE_RIO_SEND                         WINE_AFD_IOC(300)
+#define IOCTL_AFD_WINE_ACCEPT_FD                        WINE_AFD_IOC(301)
 
 struct afd_iovec
 {
@@ -306,6 +309,15 @@ struct afd_accept_into_params
 };
 C_ASSERT( sizeof(struct afd_accept_into_params) == 12 );
 
+/* a connection accepted by the client, sent with the request */
+struct afd_accept_fd_params
+{
+    int fd;
+    ULONG accept_handle;    /* socket to accept into, or 0 to create one */
+    unsigned int local_len;
+};
+C_ASSERT( sizeof(struct afd_accept_fd_params) == 12 );
+
 struct afd_connect_params
 {
     int addr_len;
@@ -338,6 +350,15 @@ struct afd_sendmsg_params
 };
 C_ASSERT( sizeof(struct afd_sendmsg_params) == 32 );
 
+struct afd_rio_params
+{
+    ULONGLONG buffer_ptr; /* char[len] */
+    ULONGLONG addr_ptr; /* WS(sockaddr) */
+    unsigned int len;
+    unsigned int addr_len;
+};
+C_ASSERT( sizeof(struct afd_rio_params) == 24 );
+
 struct afd_transmit_params
 {
     LARGE_INTEGER offset;
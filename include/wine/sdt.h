@@ -0,0 +1,47 @@
+/*
+ * Static tracepoints for Unix-side Wine code
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_WINE_SDT_H
+#define __WINE_WINE_SDT_H
+
+/* The probes are USDT/SDT notes that perf and bpftrace can attach to, e.g.
+ *   bpftrace -e 'usdt:/usr/bin/wineserver:wineserver:request_start { ... }'
+ * They compile to a single nop when nothing is attached, and to nothing at all
+ * when sys/sdt.h is not available or for PE code. */
+
+#if defined(HAVE_SYS_SDT_H) && !defined(__WINE_PE_BUILD)
+
+#include <sys/sdt.h>
+
+#define WINE_PROBE0(provider,name)             DTRACE_PROBE(provider,name)
+#define WINE_PROBE1(provider,name,a)           DTRACE_PROBE1(provider,name,a)
+#define WINE_PROBE2(provider,name,a,b)         DTRACE_PROBE2(provider,name,a,b)
+#define WINE_PROBE3(provider,name,a,b,c)       DTRACE_PROBE3(provider,name,a,b,c)
+#define WINE_PROBE4(provider,name,a,b,c,d)     DTRACE_PROBE4(provider,name,a,b,c,d)
+
+#else
+
+#define WINE_PROBE0(provider,name)             do { } while (0)
+#define WINE_PROBE1(provider,name,a)           do { } while (0)
+#define WINE_PROBE2(provider,name,a,b)         do { } while (0)
+#define WINE_PROBE3(provider,name,a,b,c)       do { } while (0)
+#define WINE_PROBE4(provider,name,a,b,c,d)     do { } while (0)
+
+#endif
+
+#endif  /* __WINE_WINE_SDT_H */
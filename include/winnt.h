@@ -806,6 +806,8 @@ typedef struct DECLSPEC_ALIGN(8) MEM_EXTENDED_PARAMETER {
     } DUMMYUNIONNAME;
 } MEM_EXTENDED_PARAMETER, *PMEM_EXTENDED_PARAMETER;
 
+#define NUMA_NO_PREFERRED_NODE ((DWORD)-1)
+
 #define MEM_EXTENDED_PARAMETER_GRAPHICS                 0x00000001
 #define MEM_EXTENDED_PARAMETER_NONPAGED                 0x00000002
 #define MEM_EXTENDED_PARAMETER_ZERO_PAGES_OPTIONAL      0x00000004
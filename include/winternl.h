@@ -1814,9 +1814,33 @@ typedef enum _PROCESSINFOCLASS {
 #ifdef __WINESRC__
     ProcessWineMakeProcessSystem = 1000,
     ProcessWineLdtCopy,
+    ProcessWineIoStatistics,
 #endif
 } PROCESSINFOCLASS;
 
+#ifdef __WINESRC__
+/* same layout for 32-bit and 64-bit callers */
+typedef struct _PROCESS_WINE_HANDLE_IO_INFORMATION
+{
+    ULONG64 Handle;
+    ULONG64 ReadTransferCount;
+    ULONG64 WriteTransferCount;
+    ULONG64 ReadTime;             /* total time spent in reads, in 100ns units */
+    ULONG64 WriteTime;            /* total time spent in writes, in 100ns units */
+    ULONG   ReadOperationCount;
+    ULONG   WriteOperationCount;
+    ULONG   AsyncOperationCount;  /* reads and writes that completed asynchronously */
+    ULONG   ZeroCopyOperationCount; /* sends done without copying the buffers */
+} PROCESS_WINE_HANDLE_IO_INFORMATION, *PPROCESS_WINE_HANDLE_IO_INFORMATION;
+
+typedef struct _PROCESS_WINE_IO_STATISTICS
+{
+    ULONG Count;
+    ULONG Reserved;
+    PROCESS_WINE_HANDLE_IO_INFORMATION Handles[1];
+} PROCESS_WINE_IO_STATISTICS, *PPROCESS_WINE_IO_STATISTICS;
+#endif
+
 #define MEM_EXECUTE_OPTION_DISABLE   0x01
 #define MEM_EXECUTE_OPTION_ENABLE    0x02
 #define MEM_EXECUTE_OPTION_DISABLE_THUNK_EMULATION 0x04
@@ -2208,6 +2232,7 @@ typedef enum _MEMORY_INFORMATION_CLASS {
 #ifdef __WINESRC__
     MemoryWineUnixFuncs = 1000,
     MemoryWineUnixWow64Funcs,
+    MemoryWineUsageInformation,
 #endif
 } MEMORY_INFORMATION_CLASS;
 
@@ -2275,6 +2300,31 @@ typedef struct _MEMORY_IMAGE_INFORMATION
     };
 } MEMORY_IMAGE_INFORMATION, *PMEMORY_IMAGE_INFORMATION;
 
+#ifdef __WINESRC__
+typedef enum _MEMORY_WINE_USAGE_TYPE
+{
+    MemoryWineUsagePrivate,   /* private allocation */
+    MemoryWineUsageHeap,      /* process heap */
+    MemoryWineUsageStack,     /* thread stack */
+    MemoryWineUsageImage,     /* PE module */
+    MemoryWineUsageFile,      /* file mapping */
+    MemoryWineUsageSection,   /* pagefile-backed section */
+    MemoryWineUsageSystem,    /* reserved for system use */
+    MemoryWineUsageUnix,      /* mapped by Unix libraries */
+} MEMORY_WINE_USAGE_TYPE;
+
+/* same layout for 32-bit and 64-bit callers */
+typedef struct _MEMORY_WINE_USAGE_INFORMATION
+{
+    ULONG64 BaseAddress;
+    ULONG64 RegionSize;
+    ULONG64 CommitSize;
+    ULONG64 ResidentSize;
+    ULONG   UsageType;
+    ULONG   Reserved;
+} MEMORY_WINE_USAGE_INFORMATION, *PMEMORY_WINE_USAGE_INFORMATION;
+#endif
+
 typedef enum _MUTANT_INFORMATION_CLASS
 {
     MutantBasicInformation
@@ -2583,6 +2633,32 @@ typedef struct _RTL_HEAP_DEFINITION {
     ULONG Unknown[11];
 } RTL_HEAP_DEFINITION, *PRTL_HEAP_DEFINITION;
 
+/* Wine extension: RtlQueryHeapInformation / HeapQueryInformation statistics class */
+#define HeapWineStatistics ((HEAP_INFORMATION_CLASS)0x1000)
+
+typedef struct _WINE_HEAP_BIN_STATISTICS {
+    SIZE_T BlockSize;    /* maximum block size of the bin, ~0 for the last one */
+    SIZE_T UsedSize;     /* used non-LFH blocks size */
+    SIZE_T FreeSize;     /* free non-LFH blocks size */
+    SIZE_T LfhUsedSize;  /* used LFH blocks size */
+    SIZE_T LfhFreeSize;  /* free LFH blocks size, in groups owned by the bin */
+    ULONG  LfhGroupCount;
+    ULONG  LfhEnabled;
+} WINE_HEAP_BIN_STATISTICS, *PWINE_HEAP_BIN_STATISTICS;
+
+typedef struct _WINE_HEAP_STATISTICS {
+    SIZE_T   CommittedSize;
+    SIZE_T   UsedSize;
+    SIZE_T   FreeSize;
+    ULONG    SubheapCount;
+    ULONG    LargeBlockCount;
+    ULONG64  AllocCount;     /* total number of successful allocations */
+    ULONG64  LfhAllocCount;  /* number of allocations served by the LFH */
+    ULONG64  DecommitCount;  /* number of subheap decommit or release events */
+    ULONG    BinCount;
+    WINE_HEAP_BIN_STATISTICS Bins[1];
+} WINE_HEAP_STATISTICS, *PWINE_HEAP_STATISTICS;
+
 typedef struct _RTL_RWLOCK {
     RTL_CRITICAL_SECTION rtlCS;
 
@@ -3098,9 +3174,52 @@ typedef struct _PORT_MESSAGE_HEADER {
   USHORT VirtualRangesOffset;
   CLIENT_ID ClientId;
   ULONG MessageId;
-  ULONG SectionSize;
+  SIZE_T SectionSize;
 } PORT_MESSAGE_HEADER, *PPORT_MESSAGE_HEADER, PORT_MESSAGE, *PPORT_MESSAGE;
 
+/* Types of LPC messages */
+#define UNUSED_MSG_TYPE                 0
+#define LPC_REQUEST                     1
+#define LPC_REPLY                       2
+#define LPC_DATAGRAM                    3
+#define LPC_LOST_REPLY                  4
+#define LPC_PORT_CLOSED                 5
+#define LPC_CLIENT_DIED                 6
+#define LPC_EXCEPTION                   7
+#define LPC_DEBUG_EVENT                 8
+#define LPC_ERROR_EVENT                 9
+#define LPC_CONNECTION_REQUEST         10
+
+typedef struct _ALPC_PORT_ATTRIBUTES
+{
+  ULONG Flags;
+  SECURITY_QUALITY_OF_SERVICE SecurityQos;
+  SIZE_T MaxMessageLength;
+  SIZE_T MemoryBandwidth;
+  SIZE_T MaxPoolUsage;
+  SIZE_T MaxSectionSize;
+  SIZE_T MaxViewSize;
+  SIZE_T MaxTotalSectionSize;
+  ULONG DupObjectTypes;
+#ifdef _WIN64
+  ULONG Reserved;
+#endif
+} ALPC_PORT_ATTRIBUTES, *PALPC_PORT_ATTRIBUTES;
+
+typedef struct _ALPC_MESSAGE_ATTRIBUTES
+{
+  ULONG AllocatedAttributes;
+  ULONG ValidAttributes;
+} ALPC_MESSAGE_ATTRIBUTES, *PALPC_MESSAGE_ATTRIBUTES;
+
+#define ALPC_MSGFLG_REPLY_MESSAGE       0x00000001
+#define ALPC_MSGFLG_LPC_MODE            0x00000002
+#define ALPC_MSGFLG_RELEASE_MESSAGE     0x00010000
+#define ALPC_MSGFLG_SYNC_REQUEST        0x00020000
+#define ALPC_MSGFLG_WAIT_USER_MODE      0x00100000
+#define ALPC_MSGFLG_WAIT_ALERTABLE      0x00200000
+#define ALPC_MSGFLG_WOW64_CALL          0x80000000
+
 typedef unsigned short RTL_ATOM, *PRTL_ATOM;
 
 typedef enum _ATOM_INFORMATION_CLASS {
@@ -4357,6 +4476,11 @@ NTSYSAPI NTSTATUS  WINAPI NtAdjustPrivilegesToken(HANDLE,BOOLEAN,PTOKEN_PRIVILEG
 NTSYSAPI NTSTATUS  WINAPI NtAlertResumeThread(HANDLE,PULONG);
 NTSYSAPI NTSTATUS  WINAPI NtAlertThread(HANDLE ThreadHandle);
 NTSYSAPI NTSTATUS  WINAPI NtAlertThreadByThreadId(HANDLE);
+NTSYSAPI NTSTATUS  WINAPI NtAlpcAcceptConnectPort(PHANDLE,HANDLE,ULONG,POBJECT_ATTRIBUTES,PALPC_PORT_ATTRIBUTES,PVOID,PPORT_MESSAGE,PALPC_MESSAGE_ATTRIBUTES,BOOLEAN);
+NTSYSAPI NTSTATUS  WINAPI NtAlpcConnectPort(PHANDLE,PUNICODE_STRING,POBJECT_ATTRIBUTES,PALPC_PORT_ATTRIBUTES,ULONG,PSID,PPORT_MESSAGE,PSIZE_T,PALPC_MESSAGE_ATTRIBUTES,PALPC_MESSAGE_ATTRIBUTES,PLARGE_INTEGER);
+NTSYSAPI NTSTATUS  WINAPI NtAlpcCreatePort(PHANDLE,POBJECT_ATTRIBUTES,PALPC_PORT_ATTRIBUTES);
+NTSYSAPI NTSTATUS  WINAPI NtAlpcDisconnectPort(HANDLE,ULONG);
+NTSYSAPI NTSTATUS  WINAPI NtAlpcSendWaitReceivePort(HANDLE,ULONG,PPORT_MESSAGE,PALPC_MESSAGE_ATTRIBUTES,PPORT_MESSAGE,PSIZE_T,PALPC_MESSAGE_ATTRIBUTES,PLARGE_INTEGER);
 NTSYSAPI NTSTATUS  WINAPI NtAllocateLocallyUniqueId(PLUID lpLuid);
 NTSYSAPI NTSTATUS  WINAPI NtAllocateUuids(PULARGE_INTEGER,PULONG,PULONG,PUCHAR);
 NTSYSAPI NTSTATUS  WINAPI NtAllocateVirtualMemory(HANDLE,PVOID*,ULONG_PTR,SIZE_T*,ULONG,ULONG);
@@ -138,6 +138,7 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->callbackLock)
 	(*ppFAudio)->operationLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->operationLock)
+	(*ppFAudio)->lastQueryCycles = FAudio_timecycles();
 	(*ppFAudio)->pMalloc = customMalloc;
 	(*ppFAudio)->pFree = customFree;
 	(*ppFAudio)->pRealloc = customRealloc;
@@ -894,13 +895,26 @@ void FAudio_GetPerformanceData(
 ) {
 	LinkedList *list;
 	FAudioSourceVoice *source;
+	uint64_t now;
 
 	LOG_API_ENTER(audio)
 
 	FAudio_zero(pPerfData, sizeof(FAudioPerformanceData));
 
+	now = FAudio_timecycles();
+
 	FAudio_PlatformLockMutex(audio->sourceLock);
 	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	pPerfData->AudioCyclesSinceLastQuery = audio->audioCycles;
+	pPerfData->TotalCyclesSinceLastQuery = now - audio->lastQueryCycles;
+	pPerfData->MinimumCyclesPerQuantum = audio->minCyclesPerQuantum;
+	pPerfData->MaximumCyclesPerQuantum = audio->maxCyclesPerQuantum;
+	pPerfData->GlitchesSinceEngineStarted = audio->glitches;
+	audio->audioCycles = 0;
+	audio->lastQueryCycles = now;
+	audio->minCyclesPerQuantum = 0;
+	audio->maxCyclesPerQuantum = 0;
+
 	list = audio->sources;
 	while (list != NULL)
 	{
@@ -1420,7 +1420,10 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 
 void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
 {
+	uint64_t start, cycles;
+
 	LOG_FUNC_ENTER(audio)
+	start = FAudio_timecycles();
 	if (audio->pClientEngineProc)
 	{
 		audio->pClientEngineProc(
@@ -1434,6 +1437,25 @@ void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
 	{
 		FAudio_INTERNAL_GenerateOutput(audio, output);
 	}
+	cycles = FAudio_timecycles() - start;
+
+	FAudio_PlatformLockMutex(audio->sourceLock);
+	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	audio->audioCycles += cycles;
+	if (cycles > 0xFFFFFFFF)
+	{
+		cycles = 0xFFFFFFFF;
+	}
+	if (audio->minCyclesPerQuantum == 0 || cycles < audio->minCyclesPerQuantum)
+	{
+		audio->minCyclesPerQuantum = (uint32_t) cycles;
+	}
+	if (cycles > audio->maxCyclesPerQuantum)
+	{
+		audio->maxCyclesPerQuantum = (uint32_t) cycles;
+	}
+	FAudio_PlatformUnlockMutex(audio->sourceLock);
+	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
 	LOG_FUNC_EXIT(audio)
 }
 
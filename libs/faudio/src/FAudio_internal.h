@@ -416,6 +416,13 @@ struct FAudio
 	void *clientEngineUser;
 	FAudioEngineProcedureEXT pClientEngineProc;
 
+	/* Engine timing, protected by sourceLock and reset by GetPerformanceData */
+	uint64_t audioCycles;
+	uint64_t lastQueryCycles;
+	uint32_t minCyclesPerQuantum;
+	uint32_t maxCyclesPerQuantum;
+	uint32_t glitches;
+
 #ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
 	/* Debug Information */
 	FAudioDebugConfiguration debug;
@@ -788,6 +795,7 @@ void FAudio_sleep(uint32_t ms);
 /* Time */
 
 uint32_t FAudio_timems(void);
+uint64_t FAudio_timecycles(void);
 
 /* WaveFormatExtensible Helpers */
 
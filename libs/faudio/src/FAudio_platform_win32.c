@@ -182,6 +182,14 @@ static DWORD WINAPI FAudio_AudioClientThread(void *user)
 		hr = IAudioClient_GetCurrentPadding(args->client, &padding);
 		FAudio_assert(!FAILED(hr) && "Failed to get IAudioClient current padding!");
 
+		/* The device played everything we gave it, count it as a glitch */
+		if (padding == 0 && args->audio->active)
+		{
+			FAudio_PlatformLockMutex(args->audio->sourceLock);
+			args->audio->glitches += 1;
+			FAudio_PlatformUnlockMutex(args->audio->sourceLock);
+		}
+
 		hr = FAudio_FillAudioClientBuffer(args, render_client, frames, padding);
 		FAudio_assert(!FAILED(hr) && "Failed to fill IAudioClient buffer!");
 	}
@@ -605,6 +613,13 @@ uint32_t FAudio_timems()
 	return GetTickCount();
 }
 
+uint64_t FAudio_timecycles()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
 /* FAudio I/O */
 
 static size_t FAUDIOCALL FAudio_FILE_read(
@@ -67,12 +67,117 @@ static void d3d12_descriptor_set_layout_cleanup(
     VK_CALL(vkDestroyDescriptorSetLayout(device->vk_device, layout->vk_layout, NULL));
 }
 
+/* Everything outside the root signature which affects the SPIR-V generated
+ * for a shader. The structure is compared with memcmp(), so it must be zeroed
+ * before being filled in. */
+struct vkd3d_spirv_variant
+{
+    VkShaderStageFlagBits stage;
+    unsigned int sample_count;
+    bool dual_source_blending;
+    unsigned int output_swizzle_count;
+    unsigned int output_swizzles[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
+};
+
+struct vkd3d_spirv_cache_entry
+{
+    struct list entry;
+    struct vkd3d_spirv_variant variant;
+    struct vkd3d_shader_code dxbc;
+    struct vkd3d_shader_code spirv;
+};
+
+static void vkd3d_spirv_cache_init(struct vkd3d_spirv_cache *cache)
+{
+    vkd3d_mutex_init(&cache->mutex);
+    list_init(&cache->entries);
+}
+
+static void vkd3d_spirv_cache_cleanup(struct vkd3d_spirv_cache *cache)
+{
+    struct vkd3d_spirv_cache_entry *entry, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &cache->entries, struct vkd3d_spirv_cache_entry, entry)
+    {
+        vkd3d_shader_free_shader_code(&entry->spirv);
+        vkd3d_free((void *)entry->dxbc.code);
+        vkd3d_free(entry);
+    }
+    vkd3d_mutex_destroy(&cache->mutex);
+}
+
+static struct vkd3d_spirv_cache_entry *vkd3d_spirv_cache_find_locked(struct vkd3d_spirv_cache *cache,
+        const struct vkd3d_shader_code *dxbc, const struct vkd3d_spirv_variant *variant)
+{
+    struct vkd3d_spirv_cache_entry *entry;
+
+    LIST_FOR_EACH_ENTRY(entry, &cache->entries, struct vkd3d_spirv_cache_entry, entry)
+    {
+        if (entry->dxbc.size == dxbc->size && !memcmp(&entry->variant, variant, sizeof(*variant))
+                && !memcmp(entry->dxbc.code, dxbc->code, dxbc->size))
+            return entry;
+    }
+
+    return NULL;
+}
+
+/* Entries are only freed together with the root signature, so the returned
+ * code stays valid for as long as the caller holds a reference to it. */
+static const struct vkd3d_shader_code *vkd3d_spirv_cache_find(struct vkd3d_spirv_cache *cache,
+        const struct vkd3d_shader_code *dxbc, const struct vkd3d_spirv_variant *variant)
+{
+    struct vkd3d_spirv_cache_entry *entry;
+
+    vkd3d_mutex_lock(&cache->mutex);
+    entry = vkd3d_spirv_cache_find_locked(cache, dxbc, variant);
+    vkd3d_mutex_unlock(&cache->mutex);
+
+    return entry ? &entry->spirv : NULL;
+}
+
+/* Takes ownership of the SPIR-V code on success. */
+static bool vkd3d_spirv_cache_add(struct vkd3d_spirv_cache *cache, const struct vkd3d_shader_code *dxbc,
+        const struct vkd3d_spirv_variant *variant, const struct vkd3d_shader_code *spirv)
+{
+    struct vkd3d_spirv_cache_entry *entry;
+    void *code;
+
+    if (!(entry = vkd3d_malloc(sizeof(*entry))))
+        return false;
+    if (!(code = vkd3d_malloc(dxbc->size)))
+    {
+        vkd3d_free(entry);
+        return false;
+    }
+    memcpy(code, dxbc->code, dxbc->size);
+    entry->variant = *variant;
+    entry->dxbc.code = code;
+    entry->dxbc.size = dxbc->size;
+    entry->spirv = *spirv;
+
+    vkd3d_mutex_lock(&cache->mutex);
+    /* Another thread may have translated the same shader in the meantime. */
+    if (vkd3d_spirv_cache_find_locked(cache, dxbc, variant))
+    {
+        vkd3d_mutex_unlock(&cache->mutex);
+        vkd3d_free(code);
+        vkd3d_free(entry);
+        return false;
+    }
+    list_add_tail(&cache->entries, &entry->entry);
+    vkd3d_mutex_unlock(&cache->mutex);
+
+    return true;
+}
+
 static void d3d12_root_signature_cleanup(struct d3d12_root_signature *root_signature,
         struct d3d12_device *device)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     unsigned int i;
 
+    vkd3d_spirv_cache_cleanup(&root_signature->spirv_cache);
+
     if (root_signature->vk_pipeline_layout)
         VK_CALL(vkDestroyPipelineLayout(device->vk_device, root_signature->vk_pipeline_layout, NULL));
     for (i = 0; i < root_signature->vk_set_count; ++i)
@@ -1418,6 +1523,8 @@ static HRESULT d3d12_root_signature_init(struct d3d12_root_signature *root_signa
         return E_INVALIDARG;
     }
 
+    vkd3d_spirv_cache_init(&root_signature->spirv_cache);
+
     root_signature->binding_count = info.binding_count;
     root_signature->uav_mapping_count = info.uav_range_count;
     root_signature->static_sampler_count = desc->NumStaticSamplers;
@@ -2129,11 +2236,16 @@ static inline unsigned int typed_uav_compile_option(const struct d3d12_device *d
             : VKD3D_SHADER_COMPILE_OPTION_TYPED_UAV_READ_FORMAT_R32;
 }
 
+/* If "cache" is not NULL, the shader interface must be fully described by
+ * the root signature owning the cache and by "variant". */
 static HRESULT create_shader_stage(struct d3d12_device *device,
         struct VkPipelineShaderStageCreateInfo *stage_desc, enum VkShaderStageFlagBits stage,
-        const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface)
+        const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
+        struct vkd3d_spirv_cache *cache, const struct vkd3d_spirv_variant *variant)
 {
+    const struct vkd3d_shader_code dxbc = {code->pShaderBytecode, code->BytecodeLength};
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
+    const struct vkd3d_shader_code *cached_spirv = NULL;
     struct vkd3d_shader_compile_info compile_info;
     struct VkShaderModuleCreateInfo shader_desc;
     struct vkd3d_shader_code spirv = {0};
@@ -2158,27 +2270,35 @@ static HRESULT create_shader_stage(struct d3d12_device *device,
     shader_desc.pNext = NULL;
     shader_desc.flags = 0;
 
-    compile_info.type = VKD3D_SHADER_STRUCTURE_TYPE_COMPILE_INFO;
-    compile_info.next = shader_interface;
-    compile_info.source.code = code->pShaderBytecode;
-    compile_info.source.size = code->BytecodeLength;
-    compile_info.target_type = VKD3D_SHADER_TARGET_SPIRV_BINARY;
-    compile_info.options = options;
-    compile_info.option_count = ARRAY_SIZE(options);
-    compile_info.log_level = VKD3D_SHADER_LOG_NONE;
-    compile_info.source_name = NULL;
-
-    if ((ret = vkd3d_shader_parse_dxbc_source_type(&compile_info.source, &compile_info.source_type, NULL)) < 0
-            || (ret = vkd3d_shader_compile(&compile_info, &spirv, NULL)) < 0)
+    if (cache && (cached_spirv = vkd3d_spirv_cache_find(cache, &dxbc, variant)))
     {
-        WARN("Failed to compile shader, vkd3d result %d.\n", ret);
-        return hresult_from_vkd3d_result(ret);
+        TRACE("Using cached SPIR-V for shader %p.\n", code->pShaderBytecode);
+        spirv = *cached_spirv;
+    }
+    else
+    {
+        compile_info.type = VKD3D_SHADER_STRUCTURE_TYPE_COMPILE_INFO;
+        compile_info.next = shader_interface;
+        compile_info.source = dxbc;
+        compile_info.target_type = VKD3D_SHADER_TARGET_SPIRV_BINARY;
+        compile_info.options = options;
+        compile_info.option_count = ARRAY_SIZE(options);
+        compile_info.log_level = VKD3D_SHADER_LOG_NONE;
+        compile_info.source_name = NULL;
+
+        if ((ret = vkd3d_shader_parse_dxbc_source_type(&compile_info.source, &compile_info.source_type, NULL)) < 0
+                || (ret = vkd3d_shader_compile(&compile_info, &spirv, NULL)) < 0)
+        {
+            WARN("Failed to compile shader, vkd3d result %d.\n", ret);
+            return hresult_from_vkd3d_result(ret);
+        }
     }
     shader_desc.codeSize = spirv.size;
     shader_desc.pCode = spirv.code;
 
     vr = VK_CALL(vkCreateShaderModule(device->vk_device, &shader_desc, NULL, &stage_desc->module));
-    vkd3d_shader_free_shader_code(&spirv);
+    if (!cached_spirv && !(cache && vkd3d_spirv_cache_add(cache, &dxbc, variant, &spirv)))
+        vkd3d_shader_free_shader_code(&spirv);
     if (vr < 0)
     {
         WARN("Failed to create Vulkan shader module, vr %d.\n", vr);
@@ -2218,18 +2338,21 @@ static int vkd3d_scan_dxbc(const struct d3d12_device *device, const D3D12_SHADER
 
 static HRESULT vkd3d_create_compute_pipeline(struct d3d12_device *device,
         const D3D12_SHADER_BYTECODE *code, const struct vkd3d_shader_interface_info *shader_interface,
-        VkPipelineLayout vk_pipeline_layout, VkPipeline *vk_pipeline)
+        struct vkd3d_spirv_cache *cache, VkPipelineLayout vk_pipeline_layout, VkPipeline *vk_pipeline)
 {
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     VkComputePipelineCreateInfo pipeline_info;
+    struct vkd3d_spirv_variant variant;
     VkResult vr;
     HRESULT hr;
 
     pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipeline_info.pNext = NULL;
     pipeline_info.flags = 0;
+    memset(&variant, 0, sizeof(variant));
+    variant.stage = VK_SHADER_STAGE_COMPUTE_BIT;
     if (FAILED(hr = create_shader_stage(device, &pipeline_info.stage,
-            VK_SHADER_STAGE_COMPUTE_BIT, code, shader_interface)))
+            VK_SHADER_STAGE_COMPUTE_BIT, code, shader_interface, cache, &variant)))
         return hr;
     pipeline_info.layout = vk_pipeline_layout;
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
@@ -2381,8 +2504,9 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
     const struct vkd3d_vk_device_procs *vk_procs = &device->vk_procs;
     struct vkd3d_shader_interface_info shader_interface;
     struct vkd3d_shader_descriptor_offset_info offset_info;
-    const struct d3d12_root_signature *root_signature;
     struct vkd3d_shader_spirv_target_info target_info;
+    struct d3d12_root_signature *root_signature;
+    struct vkd3d_spirv_cache *spirv_cache;
     VkPipelineLayout vk_pipeline_layout;
     HRESULT hr;
 
@@ -2439,8 +2563,11 @@ static HRESULT d3d12_pipeline_state_init_compute(struct d3d12_pipeline_state *st
 
     vk_pipeline_layout = state->uav_counters.vk_pipeline_layout
             ? state->uav_counters.vk_pipeline_layout : root_signature->vk_pipeline_layout;
+    /* UAV counter bindings allocated for the pipeline state aren't part of the root signature. */
+    spirv_cache = shader_interface.uav_counters == state->uav_counters.bindings
+            && state->uav_counters.binding_count ? NULL : &root_signature->spirv_cache;
     if (FAILED(hr = vkd3d_create_compute_pipeline(device, &desc->cs, &shader_interface,
-            vk_pipeline_layout, &state->u.compute.vk_pipeline)))
+            spirv_cache, vk_pipeline_layout, &state->u.compute.vk_pipeline)))
     {
         WARN("Failed to create Vulkan compute pipeline, hr %#x.\n", hr);
         d3d12_pipeline_uav_counter_state_cleanup(&state->uav_counters, device);
@@ -2941,8 +3068,10 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
     struct vkd3d_shader_spirv_target_info ps_target_info;
     struct vkd3d_shader_interface_info shader_interface;
     struct vkd3d_shader_spirv_target_info target_info;
-    const struct d3d12_root_signature *root_signature;
+    struct d3d12_root_signature *root_signature;
     struct vkd3d_shader_signature input_signature;
+    struct vkd3d_spirv_cache *spirv_cache;
+    struct vkd3d_spirv_variant variant;
     bool have_attachment, is_dsv_format_unknown;
     VkShaderStageFlagBits xfb_stage = 0;
     VkSampleCountFlagBits sample_count;
@@ -3109,7 +3238,7 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         if (!desc->ps.pShaderBytecode)
         {
             if (FAILED(hr = create_shader_stage(device, &graphics->stages[graphics->stage_count],
-                    VK_SHADER_STAGE_FRAGMENT_BIT, &default_ps, NULL)))
+                    VK_SHADER_STAGE_FRAGMENT_BIT, &default_ps, NULL, NULL, NULL)))
                 goto fail;
 
             ++graphics->stage_count;
@@ -3274,8 +3403,27 @@ static HRESULT d3d12_pipeline_state_init_graphics(struct d3d12_pipeline_state *s
         if (root_signature->descriptor_offsets)
             vkd3d_prepend_struct(&shader_interface, &offset_info);
 
+        memset(&variant, 0, sizeof(variant));
+        variant.stage = shader_stages[i].stage;
+        if (stage_target_info == &ps_target_info)
+        {
+            variant.sample_count = sample_count;
+            variant.dual_source_blending = ps_target_info.dual_source_blending;
+            variant.output_swizzle_count = ps_target_info.output_swizzle_count;
+            memcpy(variant.output_swizzles, ps_output_swizzle,
+                    ps_target_info.output_swizzle_count * sizeof(*ps_output_swizzle));
+        }
+        /* Stream output declarations and UAV counter bindings allocated for
+         * the pipeline state aren't part of the root signature. */
+        if (shader_stages[i].stage == xfb_stage
+                || (shader_interface.uav_counters == state->uav_counters.bindings
+                && state->uav_counters.binding_count))
+            spirv_cache = NULL;
+        else
+            spirv_cache = &root_signature->spirv_cache;
+
         if (FAILED(hr = create_shader_stage(device, &graphics->stages[graphics->stage_count],
-                shader_stages[i].stage, b, &shader_interface)))
+                shader_stages[i].stage, b, &shader_interface, spirv_cache, &variant)))
             goto fail;
 
         ++graphics->stage_count;
@@ -4037,7 +4185,7 @@ HRESULT vkd3d_uav_clear_state_init(struct vkd3d_uav_clear_state *state, struct d
             binding.flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
 
         hr = vkd3d_create_compute_pipeline(device, &(D3D12_SHADER_BYTECODE){dxbc.code, dxbc.size},
-                &shader_interface, *pipelines[i].pipeline_layout, pipelines[i].pipeline);
+                &shader_interface, NULL, *pipelines[i].pipeline_layout, pipelines[i].pipeline);
         vkd3d_shader_free_shader_code(&dxbc);
         if (FAILED(hr))
         {
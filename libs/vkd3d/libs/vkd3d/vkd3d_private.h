@@ -124,6 +124,8 @@ struct vkd3d_vulkan_info
     bool KHR_image_format_list;
     bool KHR_maintenance2;
     bool KHR_maintenance3;
+    bool KHR_present_id;
+    bool KHR_present_wait;
     bool KHR_push_descriptor;
     bool KHR_sampler_mirror_clamp_to_edge;
     bool KHR_timeline_semaphore;
@@ -1167,6 +1169,13 @@ struct d3d12_descriptor_set_layout
 };
 
 /* ID3D12RootSignature */
+/* SPIR-V translations of the shaders used with a root signature. */
+struct vkd3d_spirv_cache
+{
+    struct vkd3d_mutex mutex;
+    struct list entries;
+};
+
 struct d3d12_root_signature
 {
     ID3D12RootSignature ID3D12RootSignature_iface;
@@ -1207,6 +1216,8 @@ struct d3d12_root_signature
     unsigned int static_sampler_count;
     VkSampler *static_samplers;
 
+    struct vkd3d_spirv_cache spirv_cache;
+
     struct d3d12_device *device;
 
     struct vkd3d_private_store private_store;
@@ -31,6 +31,8 @@ WINE_DEFAULT_DEBUG_CHANNEL(console);
 
 static const char_info_t empty_char_info = { ' ', 0x0007 };  /* white on black space */
 
+#define TTY_SYNC_INTERVAL 16  /* ms */
+
 static CRITICAL_SECTION console_section;
 static CRITICAL_SECTION_DEBUG critsect_debug =
 {
@@ -314,6 +316,27 @@ static void tty_sync( struct console *console )
     else if (console->tty_cursor_visible)
         hide_tty_cursor( console );
     tty_flush( console );
+    console->tty_sync_pending = 0;
+    console->tty_sync_time = GetTickCount();
+}
+
+/* on a Unix terminal, don't repaint more often than every TTY_SYNC_INTERVAL ms while
+ * output keeps coming; main_loop() does the deferred sync once the writes stop */
+static void tty_sync_deferred( struct console *console )
+{
+    if (!console->tty_output) return;
+    if (console->is_unix && GetTickCount() - console->tty_sync_time < TTY_SYNC_INTERVAL)
+        console->tty_sync_pending = 1;
+    else
+        tty_sync( console );
+}
+
+static DWORD get_tty_sync_timeout( struct console *console )
+{
+    DWORD elapsed = GetTickCount() - console->tty_sync_time;
+
+    if (!console->tty_sync_pending) return INFINITE;
+    return elapsed < TTY_SYNC_INTERVAL ? TTY_SYNC_INTERVAL - elapsed : 0;
 }
 
 static void init_tty_output( struct console *console )
@@ -354,12 +377,24 @@ static void scroll_to_cursor( struct screen_buffer *screen_buffer )
     screen_buffer->win.bottom = screen_buffer->win.top + h - 1;
 }
 
+/* write a run of characters sharing the current attributes, starting at the tty cursor */
+static void tty_write_chars( struct console *console, const WCHAR *str, unsigned int len )
+{
+    char buf[1024];
+    int size;
+
+    if (!len) return;
+    size = WideCharToMultiByte( get_tty_cp( console ), 0, str, len, buf, sizeof(buf), NULL, NULL );
+    tty_write( console, buf, size );
+    console->tty_cursor_x += len;
+}
+
 static void update_output( struct screen_buffer *screen_buffer, RECT *rect )
 {
-    int x, y, size, trailing_spaces;
+    unsigned int len;
+    int x, y, trailing_spaces;
     char_info_t *ch;
-    char buf[8];
-    WCHAR wch;
+    WCHAR wch, run[256];
     const unsigned int mask = (1u << '\0') | (1u << '\b') | (1u << '\t') | (1u << '\n') | (1u << '\a') | (1u << '\r');
 
     if (!is_active( screen_buffer ) || rect->top > rect->bottom || rect->right < rect->left)
@@ -385,25 +420,35 @@ static void update_output( struct screen_buffer *screen_buffer, RECT *rect )
         }
         if (trailing_spaces < 4) trailing_spaces = 0;
 
-        for (x = rect->left; x <= rect->right; x++)
+        for (x = rect->left, len = 0; x <= rect->right; x++)
         {
             ch = &screen_buffer->data[y * screen_buffer->width + x];
-            set_tty_attr( screen_buffer->console, ch->attr );
-            set_tty_cursor( screen_buffer->console, x, y );
+            if (len && (ch->attr != screen_buffer->console->tty_attr || len == ARRAY_SIZE(run)))
+            {
+                tty_write_chars( screen_buffer->console, run, len );
+                len = 0;
+            }
+            if (!len)
+            {
+                set_tty_attr( screen_buffer->console, ch->attr );
+                set_tty_cursor( screen_buffer->console, x, y );
+            }
 
             if (x + trailing_spaces >= screen_buffer->width)
             {
+                tty_write_chars( screen_buffer->console, run, len );
+                len = 0;
+                set_tty_attr( screen_buffer->console, ch->attr );
+                set_tty_cursor( screen_buffer->console, x, y );
                 tty_write( screen_buffer->console, "\x1b[K", 3 );
                 break;
             }
             wch = ch->ch;
             if (screen_buffer->console->is_unix && wch < L' ' && mask & (1u << wch))
                 wch = L'?';
-            size = WideCharToMultiByte( get_tty_cp( screen_buffer->console ), 0,
-                                        &wch, 1, buf, sizeof(buf), NULL, NULL );
-            tty_write( screen_buffer->console, buf, size );
-            screen_buffer->console->tty_cursor_x++;
+            run[len++] = wch;
         }
+        tty_write_chars( screen_buffer->console, run, len );
     }
 
     empty_update_rect( screen_buffer, rect );
@@ -2122,7 +2167,7 @@ static NTSTATUS write_console( struct screen_buffer *screen_buffer, const WCHAR
 
     scroll_to_cursor( screen_buffer );
     update_output( screen_buffer, &update_rect );
-    tty_sync( screen_buffer->console );
+    tty_sync_deferred( screen_buffer->console );
     update_window_config( screen_buffer->console, TRUE );
     return STATUS_SUCCESS;
 }
@@ -2867,10 +2912,12 @@ static int main_loop( struct console *console, HANDLE signal )
 
     for (;;)
     {
+        DWORD timeout = get_tty_sync_timeout( console );
+
         if (console->win)
-            res = MsgWaitForMultipleObjects( wait_cnt, wait_handles, FALSE, INFINITE, QS_ALLINPUT );
+            res = MsgWaitForMultipleObjects( wait_cnt, wait_handles, FALSE, timeout, QS_ALLINPUT );
         else
-            res = WaitForMultipleObjects( wait_cnt, wait_handles, FALSE, INFINITE );
+            res = WaitForMultipleObjects( wait_cnt, wait_handles, FALSE, timeout );
 
         if (res == WAIT_OBJECT_0 + wait_cnt)
         {
@@ -2892,6 +2939,12 @@ static int main_loop( struct console *console, HANDLE signal )
             if (status) return 0;
             break;
 
+        case WAIT_TIMEOUT:
+            EnterCriticalSection( &console_section );
+            if (console->tty_sync_pending) tty_sync( console );
+            LeaveCriticalSection( &console_section );
+            break;
+
         case WAIT_OBJECT_0 + 1:
             if (signal_io.Status || signal_io.Information != sizeof(signal_id))
             {
@@ -2915,6 +2968,7 @@ static int main_loop( struct console *console, HANDLE signal )
 
 static void teardown( struct console *console )
 {
+    if (console->tty_sync_pending) tty_sync( console );
     if (console->is_unix)
     {
         set_tty_attr( console, empty_char_info.attr );
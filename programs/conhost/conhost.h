@@ -111,6 +111,8 @@ struct console
     unsigned int           tty_cursor_y;
     unsigned int           tty_attr;            /* current tty char attributes */
     int                    tty_cursor_visible;  /* tty cursor visibility flag */
+    int                    tty_sync_pending;    /* tty sync has been deferred */
+    DWORD                  tty_sync_time;       /* time of the last tty sync */
 };
 
 struct screen_buffer
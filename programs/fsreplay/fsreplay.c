@@ -0,0 +1,157 @@
+/*
+ * Replay a trace of file opens and measure the time it takes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * The trace is a text file with one operation per line:
+ *
+ *   <path>          open the file or directory
+ *   dir <path>      list the contents of the directory
+ *   # comment       ignored
+ *
+ * Paths are DOS paths in the codepage of the console, relative paths are
+ * resolved against the directory of the trace file. A trace of a real
+ * program can be obtained with WINEDEBUG=trace+file and a grep for the
+ * names passed to NtCreateFile.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "windef.h"
+#include "winbase.h"
+
+struct replay_stats
+{
+    unsigned int opens;
+    unsigned int listings;
+    unsigned int entries;
+    unsigned int failures;
+};
+
+static void usage(void)
+{
+    printf( "Usage: fsreplay [options] <trace file>\n\n" );
+    printf( "Options:\n" );
+    printf( "  -n <count>    replay the trace <count> times (default 1)\n" );
+    printf( "  -v            print the operations that failed\n" );
+    exit( 1 );
+}
+
+static BOOL verbose;
+
+static void replay_open( const char *path, struct replay_stats *stats )
+{
+    HANDLE handle;
+
+    stats->opens++;
+    handle = CreateFileA( path, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                          NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL );
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        stats->failures++;
+        if (verbose) printf( "open %s failed: %lu\n", path, GetLastError() );
+        return;
+    }
+    CloseHandle( handle );
+}
+
+static void replay_dir( const char *path, struct replay_stats *stats )
+{
+    char mask[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    HANDLE handle;
+
+    stats->listings++;
+    if (snprintf( mask, sizeof(mask), "%s\\*", path ) >= (int)sizeof(mask))
+    {
+        stats->failures++;
+        return;
+    }
+    if ((handle = FindFirstFileA( mask, &data )) == INVALID_HANDLE_VALUE)
+    {
+        stats->failures++;
+        if (verbose) printf( "dir %s failed: %lu\n", path, GetLastError() );
+        return;
+    }
+    do stats->entries++; while (FindNextFileA( handle, &data ));
+    FindClose( handle );
+}
+
+static void replay( FILE *trace, struct replay_stats *stats )
+{
+    char line[MAX_PATH + 8];
+    size_t len;
+
+    while (fgets( line, sizeof(line), trace ))
+    {
+        len = strlen( line );
+        while (len && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = 0;
+        if (!len || line[0] == '#') continue;
+        if (!strncmp( line, "dir ", 4 )) replay_dir( line + 4, stats );
+        else replay_open( line, stats );
+    }
+}
+
+int __cdecl main( int argc, char *argv[] )
+{
+    struct replay_stats stats = { 0 };
+    LARGE_INTEGER freq, start, end, pass_start;
+    const char *trace_name = NULL;
+    char dir[MAX_PATH], *p;
+    unsigned int count = 1, i;
+    FILE *trace;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp( argv[i], "-n" ) && i + 1 < argc) count = atoi( argv[++i] );
+        else if (!strcmp( argv[i], "-v" )) verbose = TRUE;
+        else if (argv[i][0] == '-' || trace_name) usage();
+        else trace_name = argv[i];
+    }
+    if (!trace_name || !count) usage();
+
+    if (!(trace = fopen( trace_name, "r" )))
+    {
+        fprintf( stderr, "fsreplay: cannot open %s\n", trace_name );
+        return 1;
+    }
+    if (GetFullPathNameA( trace_name, sizeof(dir), dir, &p ) && p)
+    {
+        *p = 0;
+        SetCurrentDirectoryA( dir );
+    }
+
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < count; i++)
+    {
+        QueryPerformanceCounter( &pass_start );
+        rewind( trace );
+        replay( trace, &stats );
+        QueryPerformanceCounter( &end );
+        printf( "pass %u: %.3f ms\n", i + 1, (end.QuadPart - pass_start.QuadPart) * 1000.0 / freq.QuadPart );
+    }
+    fclose( trace );
+
+    printf( "%u opens, %u listings (%u entries), %u failures in %.3f ms\n",
+            stats.opens, stats.listings, stats.entries, stats.failures,
+            (end.QuadPart - start.QuadPart) * 1000.0 / freq.QuadPart );
+    return 0;
+}
@@ -46,6 +46,7 @@ DWORD service_kill_timeout = 60000;
 static DWORD default_preshutdown_timeout = 180000;
 static DWORD autostart_delay = 120000;
 static void *environment = NULL;
+static SRWLOCK process_create_lock = SRWLOCK_INIT;
 static HKEY service_current_key = NULL;
 static HANDLE job_object, job_completion_port;
 
@@ -441,14 +442,109 @@ static BOOL is_root_pnp_service(HDEVINFO set, const struct service_entry *servic
     return FALSE;
 }
 
+struct autostart_entry
+{
+    struct service_entry *service;
+    TP_WORK *work;
+    BOOL scheduled;
+    BOOL started;
+};
+
+static void autostart_service(struct service_entry *service)
+{
+    DWORD err, start_time = GetTickCount();
+
+    err = service_start(service, 0, NULL);
+    if (err != ERROR_SUCCESS)
+        WINE_FIXME("Auto-start service %s failed to start: %ld\n",
+                   wine_dbgstr_w(service->name), err);
+    else
+        TRACE("%s started in %lu ms\n", wine_dbgstr_w(service->name), GetTickCount() - start_time);
+}
+
+static void CALLBACK autostart_callback(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+    struct autostart_entry *entry = context;
+    autostart_service(entry->service);
+}
+
+static BOOL in_multi_sz(const WCHAR *list, const WCHAR *str)
+{
+    if (!list || !str || !str[0]) return FALSE;
+    for (; *list; list += lstrlenW(list) + 1)
+        if (!wcsicmp(list, str)) return TRUE;
+    return FALSE;
+}
+
+static BOOL autostart_depends_on(const struct service_entry *service, const struct service_entry *dependency)
+{
+    return in_multi_sz(service->dependOnServices, dependency->name) ||
+           in_multi_sz(service->dependOnGroups, dependency->config.lpLoadOrderGroup);
+}
+
+/* start the services in waves: every service whose auto-start dependencies have been
+ * started is started in parallel with the others of its wave */
+static void autostart_services_parallel(struct autostart_entry *services, unsigned int count)
+{
+    unsigned int i, j, remaining = count, wave;
+
+    while (remaining)
+    {
+        for (i = wave = 0; i < count; i++)
+        {
+            if (services[i].started) continue;
+            for (j = 0; j < count; j++)
+                if (j != i && !services[j].started && autostart_depends_on(services[i].service, services[j].service))
+                    break;
+            if (j < count) continue;
+            services[i].scheduled = TRUE;
+            wave++;
+        }
+
+        if (!wave)
+        {
+            for (i = 0; services[i].started; i++);
+            WARN("dependency cycle involving %s\n", wine_dbgstr_w(services[i].service->name));
+            services[i].scheduled = TRUE;
+            wave++;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            if (!services[i].scheduled) continue;
+            if ((services[i].work = CreateThreadpoolWork(autostart_callback, &services[i], NULL)))
+                SubmitThreadpoolWork(services[i].work);
+            else
+                autostart_service(services[i].service);
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            if (!services[i].scheduled) continue;
+            if (services[i].work)
+            {
+                WaitForThreadpoolWorkCallbacks(services[i].work, FALSE);
+                CloseThreadpoolWork(services[i].work);
+                services[i].work = NULL;
+            }
+            release_service(services[i].service);
+            services[i].scheduled = FALSE;
+            services[i].started = TRUE;
+        }
+        remaining -= wave;
+    }
+}
+
 static void scmdatabase_autostart_services(struct scmdatabase *db)
 {
     static const WCHAR rootW[] = {'R','O','O','T',0};
     struct service_entry **services_list;
     unsigned int i = 0;
     unsigned int size = 32;
-    unsigned int delayed_cnt = 0;
+    unsigned int delayed_cnt = 0, autostart_cnt = 0;
+    struct autostart_entry *autostart;
     struct service_entry *service;
+    DWORD start_time;
     HDEVINFO set;
 
     services_list = malloc(size * sizeof(services_list[0]));
@@ -485,9 +581,11 @@ static void scmdatabase_autostart_services(struct scmdatabase *db)
     qsort(services_list, size, sizeof(services_list[0]), compare_tags);
     scmdatabase_lock_startup(db, INFINITE);
 
+    start_time = GetTickCount();
+    autostart = calloc(size, sizeof(*autostart));
+
     for (i = 0; i < size; i++)
     {
-        DWORD err;
         service = services_list[i];
         if (service->delayed_autostart)
         {
@@ -495,13 +593,20 @@ static void scmdatabase_autostart_services(struct scmdatabase *db)
             services_list[delayed_cnt++] = service;
             continue;
         }
-        err = service_start(service, 0, NULL);
-        if (err != ERROR_SUCCESS)
-            WINE_FIXME("Auto-start service %s failed to start: %ld\n",
-                       wine_dbgstr_w(service->name), err);
+        /* drivers share winedevice processes, keep starting them one by one in tag order */
+        if (autostart && !(service->config.dwServiceType & SERVICE_DRIVER))
+        {
+            autostart[autostart_cnt++].service = service;
+            continue;
+        }
+        autostart_service(service);
         release_service(service);
     }
 
+    if (autostart) autostart_services_parallel(autostart, autostart_cnt);
+    free(autostart);
+    TRACE("auto-start services started in %lu ms\n", GetTickCount() - start_time);
+
     scmdatabase_unlock_startup(db);
 
     if (!delayed_cnt || !schedule_delayed_autostart(services_list, delayed_cnt))
@@ -949,6 +1054,26 @@ error:
     return ERROR_NOT_ENOUGH_SERVER_MEMORY;
 }
 
+static void create_service_environment(void)
+{
+    HANDLE token;
+
+    if (!environment && OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY | TOKEN_DUPLICATE, &token))
+    {
+        WCHAR val[16];
+        CreateEnvironmentBlock(&environment, token, FALSE);
+        if (GetEnvironmentVariableW( L"WINEBOOTSTRAPMODE", val, ARRAY_SIZE(val) ))
+        {
+            UNICODE_STRING name = RTL_CONSTANT_STRING(L"WINEBOOTSTRAPMODE");
+            UNICODE_STRING value;
+
+            RtlInitUnicodeString( &value, val );
+            RtlSetEnvironmentVariable( (WCHAR **)&environment, &name, &value );
+        }
+        CloseHandle(token);
+    }
+}
+
 static DWORD service_start_process(struct service_entry *service_entry, struct process_entry **new_process,
                                    BOOL *shared_process)
 {
@@ -956,7 +1081,6 @@ static DWORD service_start_process(struct service_entry *service_entry, struct p
     PROCESS_INFORMATION pi;
     STARTUPINFOW si;
     BOOL is_wow64 = FALSE;
-    HANDLE token;
     WCHAR *path;
     DWORD err;
     BOOL r;
@@ -1052,7 +1176,12 @@ found:
         return ERROR_SUCCESS;
     }
 
-    if ((err = process_create(service_get_pipe_name(), &process)))
+    /* the pipe name counter and the environment are shared by parallel auto-starts */
+    AcquireSRWLockExclusive(&process_create_lock);
+    err = process_create(service_get_pipe_name(), &process);
+    if (!err) create_service_environment();
+    ReleaseSRWLockExclusive(&process_create_lock);
+    if (err)
     {
         WINE_ERR("failed to create process object for %s, error = %lu\n",
                  wine_dbgstr_w(service_entry->name), err);
@@ -1069,21 +1198,6 @@ found:
         si.lpDesktop = desktopW;
     }
 
-    if (!environment && OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY | TOKEN_DUPLICATE, &token))
-    {
-        WCHAR val[16];
-        CreateEnvironmentBlock(&environment, token, FALSE);
-        if (GetEnvironmentVariableW( L"WINEBOOTSTRAPMODE", val, ARRAY_SIZE(val) ))
-        {
-            UNICODE_STRING name = RTL_CONSTANT_STRING(L"WINEBOOTSTRAPMODE");
-            UNICODE_STRING value;
-
-            RtlInitUnicodeString( &value, val );
-            RtlSetEnvironmentVariable( (WCHAR **)&environment, &name, &value );
-        }
-        CloseHandle(token);
-    }
-
     service_entry->status.dwCurrentState = SERVICE_START_PENDING;
     service_entry->status.dwControlsAccepted = 0;
     ResetEvent(service_entry->status_changed_event);
@@ -0,0 +1,591 @@
+/*
+ * Simple microbenchmarks for common Wine code paths
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "winsock2.h"
+#include "ws2tcpip.h"
+#include "windef.h"
+#include "winbase.h"
+#include "winuser.h"
+#include "winternl.h"
+
+#define RUNS           5
+#define MIN_RUN_TIME   0.1   /* in seconds */
+#define FILE_SIZE      (16 * 1024 * 1024)
+#define READ_SIZE      (64 * 1024)
+#define MAX_THREADS    8
+
+struct benchmark
+{
+    const char *name;
+    const char *description;
+    unsigned int bytes_per_op;
+    BOOL (*init)(void);
+    BOOL (*run)(unsigned int count);
+    void (*cleanup)(void);
+};
+
+static WCHAR temp_file[MAX_PATH];
+static char buffer[READ_SIZE];
+static HANDLE event, events[2], file, thread, pipes[2];
+static SOCKET sock;
+static struct sockaddr_in sock_addr;
+static unsigned int thread_count;
+static volatile BOOL thread_stop;
+static WCHAR self_path[MAX_PATH];
+
+static BOOL create_temp_file(DWORD size)
+{
+    WCHAR path[MAX_PATH];
+    HANDLE handle;
+    DWORD written;
+
+    GetTempPathW( ARRAY_SIZE(path), path );
+    if (!GetTempFileNameW( path, L"wb", 0, temp_file )) return FALSE;
+    handle = CreateFileW( temp_file, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL );
+    if (handle == INVALID_HANDLE_VALUE) return FALSE;
+    memset( buffer, 0x55, sizeof(buffer) );
+    for (; size; size -= min( size, sizeof(buffer) ))
+    {
+        if (!WriteFile( handle, buffer, min( size, sizeof(buffer) ), &written, NULL ))
+        {
+            CloseHandle( handle );
+            return FALSE;
+        }
+    }
+    CloseHandle( handle );
+    return TRUE;
+}
+
+static void delete_temp_file(void)
+{
+    DeleteFileW( temp_file );
+}
+
+static BOOL run_server_null(unsigned int count)
+{
+    while (count--) NtClose( (HANDLE)(ULONG_PTR)0xdeadbee0 );
+    return TRUE;
+}
+
+static BOOL run_null_syscall(unsigned int count)
+{
+    LARGE_INTEGER counter;
+
+    while (count--) NtQueryPerformanceCounter( &counter, NULL );
+    return TRUE;
+}
+
+static BOOL init_event(void)
+{
+    return !!(event = CreateEventW( NULL, FALSE, FALSE, NULL ));
+}
+
+static void cleanup_event(void)
+{
+    CloseHandle( event );
+}
+
+static BOOL run_query_object(unsigned int count)
+{
+    OBJECT_BASIC_INFORMATION info;
+
+    while (count--)
+        if (NtQueryObject( event, ObjectBasicInformation, &info, sizeof(info), NULL )) return FALSE;
+    return TRUE;
+}
+
+static BOOL run_event_set_wait(unsigned int count)
+{
+    while (count--)
+    {
+        SetEvent( event );
+        if (WaitForSingleObject( event, INFINITE )) return FALSE;
+    }
+    return TRUE;
+}
+
+static DWORD WINAPI pingpong_thread(void *arg)
+{
+    while (!WaitForSingleObject( events[0], INFINITE ) && !thread_stop) SetEvent( events[1] );
+    return 0;
+}
+
+static BOOL init_event_pingpong(void)
+{
+    if (!(events[0] = CreateEventW( NULL, FALSE, FALSE, NULL ))) return FALSE;
+    if (!(events[1] = CreateEventW( NULL, FALSE, FALSE, NULL ))) return FALSE;
+    thread_stop = FALSE;
+    return !!(thread = CreateThread( NULL, 0, pingpong_thread, NULL, 0, NULL ));
+}
+
+static BOOL run_event_pingpong(unsigned int count)
+{
+    while (count--)
+    {
+        SetEvent( events[0] );
+        if (WaitForSingleObject( events[1], INFINITE )) return FALSE;
+    }
+    return TRUE;
+}
+
+static void cleanup_event_pingpong(void)
+{
+    thread_stop = TRUE;
+    SetEvent( events[0] );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    CloseHandle( events[0] );
+    CloseHandle( events[1] );
+}
+
+static BOOL init_small_file(void)
+{
+    return create_temp_file( 0 );
+}
+
+static BOOL run_create_file(unsigned int count)
+{
+    HANDLE handle;
+
+    while (count--)
+    {
+        handle = CreateFileW( temp_file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL );
+        if (handle == INVALID_HANDLE_VALUE) return FALSE;
+        CloseHandle( handle );
+    }
+    return TRUE;
+}
+
+static BOOL run_file_attributes(unsigned int count)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+
+    while (count--)
+        if (!GetFileAttributesExW( temp_file, GetFileExInfoStandard, &data )) return FALSE;
+    return TRUE;
+}
+
+static BOOL init_read_file(void)
+{
+    if (!create_temp_file( FILE_SIZE )) return FALSE;
+    file = CreateFileW( temp_file, GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, NULL );
+    return file != INVALID_HANDLE_VALUE;
+}
+
+static BOOL run_read_file(unsigned int count)
+{
+    DWORD size;
+
+    while (count--)
+    {
+        if (!ReadFile( file, buffer, sizeof(buffer), &size, NULL )) return FALSE;
+        if (size < sizeof(buffer))
+        {
+            SetFilePointer( file, 0, NULL, FILE_BEGIN );
+            count++;
+        }
+    }
+    return TRUE;
+}
+
+static void cleanup_read_file(void)
+{
+    CloseHandle( file );
+    delete_temp_file();
+}
+
+static BOOL init_io_completion(void)
+{
+    return !!(event = CreateIoCompletionPort( INVALID_HANDLE_VALUE, NULL, 0, 1 ));
+}
+
+static BOOL run_io_completion(unsigned int count)
+{
+    OVERLAPPED_ENTRY entries[4];
+    ULONG removed;
+
+    while (count--)
+    {
+        if (!PostQueuedCompletionStatus( event, 0, 1, NULL )) return FALSE;
+        if (!GetQueuedCompletionStatusEx( event, entries, ARRAY_SIZE(entries), &removed, 0, FALSE ))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL init_peek_message(void)
+{
+    MSG msg;
+
+    /* make sure the thread has a message queue */
+    PeekMessageW( &msg, NULL, 0, 0, PM_NOREMOVE );
+    while (PeekMessageW( &msg, NULL, 0, 0, PM_REMOVE )) DispatchMessageW( &msg );
+    return TRUE;
+}
+
+static BOOL run_peek_message(unsigned int count)
+{
+    MSG msg;
+
+    while (count--) PeekMessageW( &msg, NULL, 0, 0, PM_REMOVE );
+    return TRUE;
+}
+
+static BOOL run_heap_alloc(unsigned int count)
+{
+    HANDLE heap = GetProcessHeap();
+    void *ptr;
+
+    while (count--)
+    {
+        if (!(ptr = HeapAlloc( heap, 0, 64 ))) return FALSE;
+        HeapFree( heap, 0, ptr );
+    }
+    return TRUE;
+}
+
+static BOOL init_heap_threads(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo( &info );
+    thread_count = min( max( info.dwNumberOfProcessors, 2 ), MAX_THREADS );
+    return TRUE;
+}
+
+static DWORD WINAPI heap_thread(void *arg)
+{
+    return !run_heap_alloc( (ULONG_PTR)arg );
+}
+
+/* the same total number of allocations, spread over several threads */
+static BOOL run_heap_alloc_threads(unsigned int count)
+{
+    HANDLE threads[MAX_THREADS];
+    unsigned int i, started = 0;
+    DWORD code;
+    BOOL ret = TRUE;
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if (!(threads[i] = CreateThread( NULL, 0, heap_thread, (void *)(ULONG_PTR)(count / thread_count), 0, NULL )))
+        {
+            ret = FALSE;
+            break;
+        }
+        started++;
+    }
+    WaitForMultipleObjects( started, threads, TRUE, INFINITE );
+    for (i = 0; i < started; i++)
+    {
+        if (!GetExitCodeThread( threads[i], &code ) || code) ret = FALSE;
+        CloseHandle( threads[i] );
+    }
+    return ret;
+}
+
+static BOOL init_udp_loopback(void)
+{
+    int len = sizeof(sock_addr);
+    WSADATA data;
+
+    if (WSAStartup( MAKEWORD(2, 2), &data )) return FALSE;
+    if ((sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP )) == INVALID_SOCKET) return FALSE;
+    memset( &sock_addr, 0, sizeof(sock_addr) );
+    sock_addr.sin_family = AF_INET;
+    sock_addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if (bind( sock, (struct sockaddr *)&sock_addr, sizeof(sock_addr) )) return FALSE;
+    return !getsockname( sock, (struct sockaddr *)&sock_addr, &len );
+}
+
+static BOOL run_udp_loopback(unsigned int count)
+{
+    while (count--)
+    {
+        if (sendto( sock, buffer, 64, 0, (struct sockaddr *)&sock_addr, sizeof(sock_addr) ) != 64) return FALSE;
+        if (recv( sock, buffer, sizeof(buffer), 0 ) != 64) return FALSE;
+    }
+    return TRUE;
+}
+
+static void cleanup_udp_loopback(void)
+{
+    closesocket( sock );
+    WSACleanup();
+}
+
+static BOOL init_pipe_stream(void)
+{
+    pipes[0] = CreateNamedPipeW( L"\\\\.\\pipe\\winebench", PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_WAIT,
+                                 1, READ_SIZE, READ_SIZE, 0, NULL );
+    if (pipes[0] == INVALID_HANDLE_VALUE) return FALSE;
+    pipes[1] = CreateFileW( L"\\\\.\\pipe\\winebench", GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL );
+    return pipes[1] != INVALID_HANDLE_VALUE;
+}
+
+static BOOL run_pipe_stream(unsigned int count)
+{
+    DWORD size;
+    int i;
+
+    while (count--)
+    {
+        for (i = 0; i < 16; i++)
+            if (!WriteFile( pipes[1], buffer, 64, &size, NULL ) || size != 64) return FALSE;
+        if (!ReadFile( pipes[0], buffer, 16 * 64, &size, NULL ) || size != 16 * 64) return FALSE;
+    }
+    return TRUE;
+}
+
+static void cleanup_pipe_stream(void)
+{
+    CloseHandle( pipes[1] );
+    CloseHandle( pipes[0] );
+}
+
+static BOOL init_create_process(void)
+{
+    return !!GetModuleFileNameW( NULL, self_path, ARRAY_SIZE(self_path) );
+}
+
+static BOOL run_create_process(unsigned int count)
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOW si = { sizeof(si) };
+    WCHAR cmdline[] = L"winebench --child";
+
+    while (count--)
+    {
+        if (!CreateProcessW( self_path, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi )) return FALSE;
+        WaitForSingleObject( pi.hProcess, INFINITE );
+        CloseHandle( pi.hThread );
+        CloseHandle( pi.hProcess );
+    }
+    return TRUE;
+}
+
+static BOOL run_process_list(unsigned int count)
+{
+    static ULONG size = 0x10000;
+    static void *info;
+    NTSTATUS status;
+
+    while (count--)
+    {
+        while ((status = NtQuerySystemInformation( SystemProcessInformation, info, size, &size ))
+               == STATUS_INFO_LENGTH_MISMATCH)
+        {
+            free( info );
+            if (!(info = malloc( size ))) return FALSE;
+        }
+        if (status) return FALSE;
+    }
+    return TRUE;
+}
+
+static const struct benchmark benchmarks[] =
+{
+    { "null_syscall", "NtQueryPerformanceCounter, a syscall without server call", 0, NULL, run_null_syscall, NULL },
+    { "server_null", "NtClose on an invalid handle", 0, NULL, run_server_null, NULL },
+    { "query_object", "NtQueryObject(ObjectBasicInformation) on an event", 0,
+      init_event, run_query_object, cleanup_event },
+    { "event_set_wait", "SetEvent and wait on the same thread", 0, init_event, run_event_set_wait, cleanup_event },
+    { "event_pingpong", "event round trip between two threads", 0,
+      init_event_pingpong, run_event_pingpong, cleanup_event_pingpong },
+    { "create_file", "CreateFile and CloseHandle of an existing file", 0,
+      init_small_file, run_create_file, delete_temp_file },
+    { "file_attributes", "GetFileAttributesEx of an existing file", 0,
+      init_small_file, run_file_attributes, delete_temp_file },
+    { "read_file", "sequential 64 KiB ReadFile calls", READ_SIZE, init_read_file, run_read_file, cleanup_read_file },
+    { "io_completion", "completion packet posted and removed with GetQueuedCompletionStatusEx", 0,
+      init_io_completion, run_io_completion, cleanup_event },
+    { "peek_message", "PeekMessage on an empty queue", 0, init_peek_message, run_peek_message, NULL },
+    { "heap_alloc", "HeapAlloc and HeapFree of 64 bytes", 0, NULL, run_heap_alloc, NULL },
+    { "heap_alloc_threads", "HeapAlloc and HeapFree of 64 bytes from several threads", 0,
+      init_heap_threads, run_heap_alloc_threads, NULL },
+    { "udp_loopback", "64 byte UDP packet sent and received over loopback", 64,
+      init_udp_loopback, run_udp_loopback, cleanup_udp_loopback },
+    { "pipe_stream", "16 64 byte writes to a byte mode named pipe, read back at once", 16 * 64,
+      init_pipe_stream, run_pipe_stream, cleanup_pipe_stream },
+    { "process_list", "NtQuerySystemInformation(SystemProcessInformation)", 0, NULL, run_process_list, NULL },
+    { "create_process", "CreateProcess of a process exiting immediately", 0,
+      init_create_process, run_create_process, NULL },
+};
+
+static double get_time(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+
+    if (!freq.QuadPart) QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &counter );
+    return (double)counter.QuadPart / freq.QuadPart;
+}
+
+static int __cdecl compare_double( const void *a, const void *b )
+{
+    const double *x = a, *y = b;
+    return *x < *y ? -1 : *x > *y;
+}
+
+static BOOL run_benchmark( const struct benchmark *bench, BOOL first )
+{
+    double start, elapsed, times[RUNS];
+    unsigned int i, count = 1;
+
+    if (bench->init && !bench->init())
+    {
+        fprintf( stderr, "winebench: failed to initialize %s, error %lu\n", bench->name, GetLastError() );
+        return FALSE;
+    }
+
+    /* find an iteration count that takes long enough to be measured reliably */
+    for (;;)
+    {
+        start = get_time();
+        if (!bench->run( count )) goto failed;
+        elapsed = get_time() - start;
+        if (elapsed >= MIN_RUN_TIME || count >= 0x10000000) break;
+        if (elapsed > MIN_RUN_TIME / 100) count = min( count * MIN_RUN_TIME / elapsed + 1, 0x10000000 );
+        else count *= 10;
+    }
+
+    for (i = 0; i < RUNS; i++)
+    {
+        start = get_time();
+        if (!bench->run( count )) goto failed;
+        times[i] = (get_time() - start) * 1e9 / count;
+    }
+    if (bench->cleanup) bench->cleanup();
+
+    qsort( times, RUNS, sizeof(times[0]), compare_double );
+    printf( "%s    {\n", first ? "" : ",\n" );
+    printf( "      \"name\": \"%s\",\n", bench->name );
+    printf( "      \"description\": \"%s\",\n", bench->description );
+    printf( "      \"iterations\": %u,\n", count );
+    printf( "      \"runs\": %u,\n", RUNS );
+    printf( "      \"ns_per_op_min\": %.1f,\n", times[0] );
+    printf( "      \"ns_per_op_median\": %.1f,\n", times[RUNS / 2] );
+    if (bench->bytes_per_op)
+        printf( "      \"mb_per_sec\": %.1f,\n", bench->bytes_per_op * 1e3 / times[RUNS / 2] );
+    printf( "      \"ops_per_sec\": %.0f\n", 1e9 / times[RUNS / 2] );
+    printf( "    }" );
+    return TRUE;
+
+failed:
+    fprintf( stderr, "winebench: %s failed, error %lu\n", bench->name, GetLastError() );
+    if (bench->cleanup) bench->cleanup();
+    return FALSE;
+}
+
+static void print_json_string( const char *str )
+{
+    if (!str)
+    {
+        printf( "null" );
+        return;
+    }
+    putchar( '"' );
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\') putchar( '\\' );
+        if ((unsigned char)*str >= 0x20) putchar( *str );
+    }
+    putchar( '"' );
+}
+
+static void usage(void)
+{
+    unsigned int i;
+
+    printf( "Usage: winebench [-l] [benchmark...]\n\n" );
+    printf( "Runs the given benchmarks, or all of them, and prints the results as JSON.\n" );
+    printf( "  -l  list the available benchmarks\n\n" );
+    for (i = 0; i < ARRAY_SIZE(benchmarks); i++)
+        printf( "  %-20s %s\n", benchmarks[i].name, benchmarks[i].description );
+}
+
+int __cdecl main( int argc, char *argv[] )
+{
+    const char * (CDECL *pwine_get_version)(void);
+    const char * (CDECL *pwine_get_build_id)(void);
+    unsigned int i, j, failures = 0;
+    BOOL first = TRUE, wow64 = FALSE;
+    SYSTEM_INFO info;
+    HMODULE ntdll;
+
+    if (argc > 1 && !strcmp( argv[1], "--child" )) return 0;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (argv[i][0] != '-') continue;
+        usage();
+        return strcmp( argv[i], "-l" ) ? 1 : 0;
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(benchmarks); j++)
+            if (!strcmp( argv[i], benchmarks[j].name )) break;
+        if (j == ARRAY_SIZE(benchmarks))
+        {
+            fprintf( stderr, "winebench: unknown benchmark %s\n", argv[i] );
+            return 1;
+        }
+    }
+
+    ntdll = GetModuleHandleW( L"ntdll.dll" );
+    pwine_get_version = (void *)GetProcAddress( ntdll, "wine_get_version" );
+    pwine_get_build_id = (void *)GetProcAddress( ntdll, "wine_get_build_id" );
+    GetSystemInfo( &info );
+    IsWow64Process( GetCurrentProcess(), &wow64 );
+
+    printf( "{\n  \"wine_version\": " );
+    print_json_string( pwine_get_version ? pwine_get_version() : NULL );
+    printf( ",\n  \"wine_build\": " );
+    print_json_string( pwine_get_build_id ? pwine_get_build_id() : NULL );
+    printf( ",\n  \"cpus\": %lu,\n  \"wow64\": %s,\n  \"esync\": ",
+            info.dwNumberOfProcessors, wow64 ? "true" : "false" );
+    print_json_string( getenv( "WINEESYNC" ) );
+    printf( ",\n  \"fsync\": " );
+    print_json_string( getenv( "WINEFSYNC" ) );
+    printf( ",\n  \"benchmarks\": [\n" );
+
+    for (i = 0; i < ARRAY_SIZE(benchmarks); i++)
+    {
+        if (argc > 1)
+        {
+            for (j = 1; j < argc; j++)
+                if (!strcmp( argv[j], benchmarks[i].name )) break;
+            if (j == argc) continue;
+        }
+        if (run_benchmark( &benchmarks[i], first )) first = FALSE;
+        else failures++;
+        fflush( stdout );
+    }
+
+    printf( "\n  ]\n}\n" );
+    return failures ? 2 : 0;
+}
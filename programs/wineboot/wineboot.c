@@ -89,9 +89,34 @@ extern BOOL shutdown_all_desktops( BOOL force );
 extern void kill_processes( BOOL kill_desktop );
 
 static WCHAR windowsdir[MAX_PATH];
+static FILE *profile_file;
 static const BOOL is_64bit = sizeof(void *) > sizeof(int);
 
 /* retrieve the path to the wine.inf file */
+/* boot phase timing, reported with +wineboot and as "phase<TAB>milliseconds" lines
+ * in the file named by WINEBOOT_PROFILE */
+static LONGLONG profile_start(void)
+{
+    LARGE_INTEGER counter;
+
+    QueryPerformanceCounter( &counter );
+    return counter.QuadPart;
+}
+
+static void profile_end( const char *phase, LONGLONG start )
+{
+    LARGE_INTEGER counter, freq;
+    double ms;
+
+    QueryPerformanceCounter( &counter );
+    QueryPerformanceFrequency( &freq );
+    ms = (counter.QuadPart - start) * 1000.0 / freq.QuadPart;
+    WINE_TRACE( "%s took %.3f ms\n", phase, ms );
+    if (profile_file) fprintf( profile_file, "%s\t%.3f\n", phase, ms );
+}
+
+#define PROFILE(phase, call) do { LONGLONG start_ = profile_start(); call; profile_end( phase, start_ ); } while (0)
+
 static WCHAR *get_wine_inf_path(void)
 {
     WCHAR *dir, *name = NULL;
@@ -1627,6 +1652,66 @@ static void update_root_certs(void)
     CertCloseStore( store, 0 );
 }
 
+static DWORD WINAPI update_root_certs_thread( void *arg )
+{
+    PROFILE( "update_root_certs", update_root_certs() );
+    return 0;
+}
+
+/* run the PreInstall section, then the install section of each supported architecture */
+static void install_wine_inf( const WCHAR *inf_path )
+{
+    SYSTEM_SUPPORTED_PROCESSOR_ARCHITECTURES_INFORMATION machines[8];
+    HANDLE process = 0;
+    DWORD count = 0;
+    LONGLONG start = profile_start();
+
+    if (NtQuerySystemInformationEx( SystemSupportedProcessorArchitectures, &process, sizeof(process),
+                                    machines, sizeof(machines), NULL )) machines[0].Machine = 0;
+
+    if ((process = start_rundll32( inf_path, L"PreInstall", IMAGE_FILE_MACHINE_TARGET_HOST )))
+    {
+        for (;;)
+        {
+            if (process)
+            {
+                MSG msg;
+                DWORD res = MsgWaitForMultipleObjects( 1, &process, FALSE, INFINITE, QS_ALLINPUT );
+                if (res != WAIT_OBJECT_0)
+                {
+                    while (PeekMessageW( &msg, 0, 0, 0, PM_REMOVE )) DispatchMessageW( &msg );
+                    continue;
+                }
+                CloseHandle( process );
+                profile_end( count ? (machines[count - 1].Native ? "DefaultInstall" : "Wow64Install")
+                             : "PreInstall", start );
+                start = profile_start();
+            }
+            if (!machines[count].Machine) break;
+            if (machines[count].Native)
+                process = start_rundll32( inf_path, L"DefaultInstall", IMAGE_FILE_MACHINE_TARGET_HOST );
+            else
+                process = start_rundll32( inf_path, L"Wow64Install", machines[count].Machine );
+            count++;
+        }
+    }
+}
+
+/* report the fake dlls that updating the prefix would change */
+static void report_wineprefix_update(void)
+{
+    WCHAR *inf_path = get_wine_inf_path();
+
+    if (!inf_path)
+    {
+        WINE_MESSAGE( "wine: wine.inf not found\n" );
+        return;
+    }
+    SetEnvironmentVariableW( L"WINE_FAKEDLL_DRY_RUN", L"1" );
+    install_wine_inf( inf_path );
+    free( inf_path );
+}
+
 /* execute rundll32 on the wine.inf file if necessary */
 static void update_wineprefix( BOOL force )
 {
@@ -1651,40 +1736,20 @@ static void update_wineprefix( BOOL force )
 
     if (update_timestamp( config_dir, st.st_mtime ) || force)
     {
-        SYSTEM_SUPPORTED_PROCESSOR_ARCHITECTURES_INFORMATION machines[8];
-        HANDLE process = 0;
-        DWORD count = 0;
-
-        if (NtQuerySystemInformationEx( SystemSupportedProcessorArchitectures, &process, sizeof(process),
-                                        machines, sizeof(machines), NULL )) machines[0].Machine = 0;
+        HANDLE thread;
 
-        if ((process = start_rundll32( inf_path, L"PreInstall", IMAGE_FILE_MACHINE_TARGET_HOST )))
+        install_wine_inf( inf_path );
+        /* importing the host certificates only depends on the INF having been installed */
+        if (!(thread = CreateThread( NULL, 0, update_root_certs_thread, NULL, 0, NULL )))
+            update_root_certs_thread( NULL );
+        PROFILE( "install_root_pnp_devices", install_root_pnp_devices() );
+        PROFILE( "update_user_profile", update_user_profile() );
+        PROFILE( "update_win_version", update_win_version() );
+        if (thread)
         {
-            for (;;)
-            {
-                if (process)
-                {
-                    MSG msg;
-                    DWORD res = MsgWaitForMultipleObjects( 1, &process, FALSE, INFINITE, QS_ALLINPUT );
-                    if (res != WAIT_OBJECT_0)
-                    {
-                        while (PeekMessageW( &msg, 0, 0, 0, PM_REMOVE )) DispatchMessageW( &msg );
-                        continue;
-                    }
-                    CloseHandle( process );
-                }
-                if (!machines[count].Machine) break;
-                if (machines[count].Native)
-                    process = start_rundll32( inf_path, L"DefaultInstall", IMAGE_FILE_MACHINE_TARGET_HOST );
-                else
-                    process = start_rundll32( inf_path, L"Wow64Install", machines[count].Machine );
-                count++;
-            }
+            WaitForSingleObject( thread, INFINITE );
+            CloseHandle( thread );
         }
-        install_root_pnp_devices();
-        update_user_profile();
-        update_win_version();
-        update_root_certs();
 
         WINE_MESSAGE( "wine: configuration in %s has been updated.\n", debugstr_w(prettyprint_configdir()) );
     }
@@ -1783,6 +1848,7 @@ static void usage( int status )
     WINE_MESSAGE( "    -r,--restart      Restart only, don't do normal startup operations\n" );
     WINE_MESSAGE( "    -s,--shutdown     Shutdown only, don't reboot\n" );
     WINE_MESSAGE( "    -u,--update       Update the wineprefix directory\n" );
+    WINE_MESSAGE( "    -n,--dry-run      Report the fake dlls an update would change, without updating\n" );
     exit( status );
 }
 
@@ -1836,13 +1902,16 @@ int __cdecl main( int argc, char *argv[] )
 {
     /* First, set the current directory to SystemRoot */
     int i, j;
-    BOOL end_session, force, init, kill, restart, shutdown, update;
+    BOOL end_session, force, init, kill, restart, shutdown, update, dry_run;
     HANDLE event;
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING nameW = RTL_CONSTANT_STRING( L"\\KernelObjects\\__wineboot_event" );
+    const char *profile;
+    LONGLONG start;
     BOOL is_wow64;
 
-    end_session = force = init = kill = restart = shutdown = update = FALSE;
+    start = profile_start();
+    end_session = force = init = kill = restart = shutdown = update = dry_run = FALSE;
     GetWindowsDirectoryW( windowsdir, MAX_PATH );
     if( !SetCurrentDirectoryW( windowsdir ) )
         WINE_ERR("Cannot set the dir to %s (%ld)\n", wine_dbgstr_w(windowsdir), GetLastError() );
@@ -1885,6 +1954,7 @@ int __cdecl main( int argc, char *argv[] )
             else if (!strcmp( argv[i], "--restart" )) restart = TRUE;
             else if (!strcmp( argv[i], "--shutdown" )) shutdown = TRUE;
             else if (!strcmp( argv[i], "--update" )) update = TRUE;
+            else if (!strcmp( argv[i], "--dry-run" )) dry_run = TRUE;
             else usage( 1 );
             continue;
         }
@@ -1899,12 +1969,19 @@ int __cdecl main( int argc, char *argv[] )
             case 'r': restart = TRUE; break;
             case 's': shutdown = TRUE; break;
             case 'u': update = TRUE; break;
+            case 'n': dry_run = TRUE; break;
             case 'h': usage(0); break;
             default:  usage(1); break;
             }
         }
     }
 
+    if (dry_run)
+    {
+        report_wineprefix_update();
+        return 0;
+    }
+
     if (end_session)
     {
         if (kill)
@@ -1924,28 +2001,31 @@ int __cdecl main( int argc, char *argv[] )
 
     ResetEvent( event );  /* in case this is a restart */
 
-    create_user_shared_data();
-    create_hardware_registry_keys();
-    create_dynamic_registry_keys();
-    create_environment_registry_keys();
-    create_computer_name_keys();
-    wininit();
-    pendingRename();
+    if ((profile = getenv( "WINEBOOT_PROFILE" )) && *profile && !(profile_file = fopen( profile, "a" )))
+        WINE_ERR( "failed to open %s\n", debugstr_a(profile) );
+
+    PROFILE( "create_user_shared_data", create_user_shared_data() );
+    PROFILE( "create_hardware_registry_keys", create_hardware_registry_keys() );
+    PROFILE( "create_dynamic_registry_keys", create_dynamic_registry_keys() );
+    PROFILE( "create_environment_registry_keys", create_environment_registry_keys() );
+    PROFILE( "create_computer_name_keys", create_computer_name_keys() );
+    PROFILE( "wininit", wininit() );
+    PROFILE( "pendingRename", pendingRename() );
 
-    ProcessWindowsFileProtection();
-    ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServicesOnce", TRUE, FALSE );
+    PROFILE( "ProcessWindowsFileProtection", ProcessWindowsFileProtection() );
+    PROFILE( "RunServicesOnce", ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServicesOnce", TRUE, FALSE ) );
 
     if (init || (kill && !restart))
     {
-        ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServices", FALSE, FALSE );
-        start_services_process();
+        PROFILE( "RunServices", ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunServices", FALSE, FALSE ) );
+        PROFILE( "start_services_process", start_services_process() );
     }
-    if (init || update) update_wineprefix( update );
+    if (init || update) PROFILE( "update_wineprefix", update_wineprefix( update ) );
 
-    create_digitalproductid();
-    create_volatile_environment_registry_key();
+    PROFILE( "create_digitalproductid", create_digitalproductid() );
+    PROFILE( "create_volatile_environment_registry_key", create_volatile_environment_registry_key() );
 
-    ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunOnce", TRUE, TRUE );
+    PROFILE( "RunOnce", ProcessRunKeys( HKEY_LOCAL_MACHINE, L"RunOnce", TRUE, TRUE ) );
 
     if (!init && !restart)
     {
@@ -1956,6 +2036,9 @@ int __cdecl main( int argc, char *argv[] )
 
     WINE_TRACE("Operation done\n");
 
+    profile_end( "total", start );
+    if (profile_file) fclose( profile_file );
+
     SetEvent( event );
     return 0;
 }
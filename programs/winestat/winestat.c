@@ -0,0 +1,564 @@
+/*
+ * Display statistics of the running wineserver
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winbase.h"
+#include "winternl.h"
+#include "wine/server.h"
+
+enum sort_key
+{
+    SORT_TIME,
+    SORT_COUNT,
+    SORT_MAX,
+    SORT_BYTES,
+    SORT_LATENCY,
+};
+
+static enum sort_key sort_key = SORT_TIME;
+
+struct request_entry
+{
+    const struct request_stats *stats;
+    const char                 *name;
+};
+
+static void usage(void)
+{
+    printf( "Usage: winestat [command] [options]\n\n" );
+    printf( "Commands:\n" );
+    printf( "  requests      show the requests handled by the wineserver (default)\n" );
+    printf( "  directories   show the hash table usage of the object directories\n" );
+    printf( "  fsync         show the usage of the fsync shared memory\n" );
+    printf( "  images        show the sharing of relocated image contents\n" );
+    printf( "  scheduler     show the realtime scheduling limits and usage\n" );
+    printf( "  memory <pid>  show the memory usage of a process per view type and module\n" );
+    printf( "  io <pid>      show the handles of a process with the most I/O\n\n" );
+    printf( "Options:\n" );
+    printf( "  -n <count>    only show the first <count> entries (default 20, 0 for all)\n" );
+    printf( "  -s <key>      sort by 'time' (default), 'count', 'max', 'bytes' or 'latency'\n" );
+    printf( "  -r            reset the statistics after displaying them\n" );
+    printf( "  -i <seconds>  for io, show the activity over each interval until interrupted\n" );
+    exit( 1 );
+}
+
+static ULONGLONG entry_sort_value( const struct request_entry *entry )
+{
+    switch (sort_key)
+    {
+    case SORT_COUNT: return entry->stats->count;
+    case SORT_MAX:   return entry->stats->max_time;
+    case SORT_BYTES: return entry->stats->bytes_in + entry->stats->bytes_out;
+    default:         return entry->stats->total_time;
+    }
+}
+
+static int __cdecl compare_entries( const void *a, const void *b )
+{
+    ULONGLONG val_a = entry_sort_value( a ), val_b = entry_sort_value( b );
+
+    if (val_a == val_b) return ((const struct request_entry *)a)->stats->req -
+                               ((const struct request_entry *)b)->stats->req;
+    return val_a < val_b ? 1 : -1;
+}
+
+static int show_requests( unsigned int max_count, BOOL reset )
+{
+    struct request_entry *entries;
+    char *buffer = NULL, *ptr, *end;
+    data_size_t size = 4096;
+    unsigned int i, count = 0;
+    ULONGLONG total_time = 0, total_count = 0;
+    timeout_t uptime = 0;
+    NTSTATUS status;
+
+    for (;;)
+    {
+        if (!(buffer = realloc( buffer, size ))) return 1;
+        SERVER_START_REQ( get_request_stats )
+        {
+            req->reset = reset;
+            wine_server_set_reply( req, buffer, size );
+            status = wine_server_call( req );
+            uptime = reply->uptime;
+            if (status == STATUS_BUFFER_TOO_SMALL) size = reply->total;
+            else size = wine_server_reply_size( reply );
+        }
+        SERVER_END_REQ;
+        if (status != STATUS_BUFFER_TOO_SMALL) break;
+    }
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve request statistics, status %#lx\n", status );
+        free( buffer );
+        return 1;
+    }
+
+    end = buffer + size;
+    for (ptr = buffer; ptr + sizeof(struct request_stats) <= end; count++)
+    {
+        const struct request_stats *stats = (const struct request_stats *)ptr;
+        ptr += (sizeof(*stats) + stats->name_len + 7) & ~7;
+    }
+    if (!(entries = malloc( max( count, 1 ) * sizeof(*entries) ))) return 1;
+
+    for (i = 0, ptr = buffer; i < count; i++)
+    {
+        const struct request_stats *stats = (const struct request_stats *)ptr;
+
+        entries[i].stats = stats;
+        entries[i].name  = (const char *)(stats + 1);
+        total_time  += stats->total_time;
+        total_count += stats->count;
+        ptr += (sizeof(*stats) + stats->name_len + 7) & ~7;
+    }
+    qsort( entries, count, sizeof(*entries), compare_entries );
+
+    printf( "server uptime %.1f s, %I64u requests, %.1f ms in handlers\n\n",
+            uptime / 10000000.0, total_count, total_time / 10000.0 );
+    printf( "%-32s %10s %7s %12s %9s %9s %12s %12s\n",
+            "request", "count", "%time", "total ms", "avg us", "max us", "in KB", "out KB" );
+    for (i = 0; i < count && (!max_count || i < max_count); i++)
+    {
+        const struct request_stats *stats = entries[i].stats;
+
+        printf( "%-32.*s %10u %6.1f%% %12.3f %9.2f %9.1f %12.1f %12.1f\n",
+                (int)min( stats->name_len, 32 ), entries[i].name, stats->count,
+                total_time ? stats->total_time * 100.0 / total_time : 0.0,
+                stats->total_time / 10000.0, stats->total_time / 10.0 / stats->count,
+                stats->max_time / 10.0, stats->bytes_in / 1024.0, stats->bytes_out / 1024.0 );
+    }
+
+    free( entries );
+    free( buffer );
+    return 0;
+}
+
+static int show_directories(void)
+{
+    char *buffer = NULL, *ptr, *end;
+    data_size_t size = 4096;
+    NTSTATUS status;
+
+    for (;;)
+    {
+        if (!(buffer = realloc( buffer, size ))) return 1;
+        SERVER_START_REQ( get_directory_stats )
+        {
+            wine_server_set_reply( req, buffer, size );
+            status = wine_server_call( req );
+            if (status == STATUS_BUFFER_TOO_SMALL) size = reply->total;
+            else size = wine_server_reply_size( reply );
+        }
+        SERVER_END_REQ;
+        if (status != STATUS_BUFFER_TOO_SMALL) break;
+    }
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve directory statistics, status %#lx\n", status );
+        free( buffer );
+        return 1;
+    }
+
+    printf( "%10s %10s %10s  %s\n", "objects", "buckets", "max chain", "directory" );
+    end = buffer + size;
+    for (ptr = buffer; ptr + sizeof(struct directory_stats) <= end; )
+    {
+        const struct directory_stats *stats = (const struct directory_stats *)ptr;
+
+        printf( "%10u %10u %10u  %.*ls\n", stats->count, stats->hash_size, stats->max_chain,
+                (int)(stats->name_len / sizeof(WCHAR)), (const WCHAR *)(stats + 1) );
+        ptr += (sizeof(*stats) + stats->name_len + 7) & ~7;
+    }
+    free( buffer );
+    return 0;
+}
+
+static int show_fsync(void)
+{
+    NTSTATUS status;
+
+    SERVER_START_REQ( get_fsync_stats )
+    {
+        if (!(status = wine_server_call( req )))
+        {
+            printf( "shm indices in use  %u\n", reply->in_use );
+            printf( "peak indices in use %u\n", reply->peak );
+            printf( "server fallbacks    %u\n", reply->fallbacks );
+            printf( "shm section size    %I64u KB\n", (ULONGLONG)reply->size / 1024 );
+        }
+    }
+    SERVER_END_REQ;
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve fsync statistics, status %#lx\n", status );
+        return 1;
+    }
+    return 0;
+}
+
+static int show_scheduler(void)
+{
+    NTSTATUS status;
+
+    SERVER_START_REQ( get_scheduler_stats )
+    {
+        if (!(status = wine_server_call( req )))
+        {
+            if (reply->rt_limit) printf( "SCHED_RR range      [1,%d]\n", reply->rt_limit );
+            else printf( "SCHED_RR range      unavailable\n" );
+            if (reply->nice_limit < 0) printf( "niceness range      [%d,%d]\n", reply->nice_limit, -reply->nice_limit );
+            else printf( "niceness range      unavailable\n" );
+            printf( "realtime threads    %u\n", reply->rt_threads );
+            printf( "realtime failures   %u\n", reply->rt_failures );
+        }
+    }
+    SERVER_END_REQ;
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve scheduler statistics, status %#lx\n", status );
+        return 1;
+    }
+    return 0;
+}
+
+static int show_images(void)
+{
+    NTSTATUS status;
+
+    SERVER_START_REQ( get_image_cache_stats )
+    {
+        if (!(status = wine_server_call( req )))
+        {
+            printf( "cached images       %u\n", reply->count );
+            printf( "cache size          %I64u KB\n", (ULONGLONG)reply->size / 1024 );
+            printf( "shared views        %u\n", reply->hits );
+            printf( "private views       %u\n", reply->misses );
+            printf( "shared view size    %I64u KB\n", (ULONGLONG)reply->shared_size / 1024 );
+            printf( "private view size   %I64u KB\n", (ULONGLONG)reply->private_size / 1024 );
+        }
+    }
+    SERVER_END_REQ;
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve image cache statistics, status %#lx\n", status );
+        return 1;
+    }
+    return 0;
+}
+
+static int show_memory( DWORD pid )
+{
+    static const char * const usage_names[] =
+    {
+        "private", "heap", "stack", "image", "file", "section", "system", "unix"
+    };
+    ULONG64 reserved[ARRAY_SIZE(usage_names)] = {0}, committed[ARRAY_SIZE(usage_names)] = {0};
+    ULONG64 resident[ARRAY_SIZE(usage_names)] = {0};
+    MEMORY_WINE_USAGE_INFORMATION info;
+    char buffer[sizeof(MEMORY_SECTION_NAME) + MAX_PATH * sizeof(WCHAR)];
+    MEMORY_SECTION_NAME *name = (MEMORY_SECTION_NAME *)buffer;
+    ULONG64 addr = 0;
+    NTSTATUS status;
+    HANDLE process;
+    unsigned int i;
+
+    if (!(process = OpenProcess( PROCESS_QUERY_INFORMATION, FALSE, pid )))
+    {
+        fprintf( stderr, "winestat: failed to open process %04lx, error %lu\n", pid, GetLastError() );
+        return 1;
+    }
+
+    printf( "%12s %12s %12s  %s\n", "commit KB", "resident KB", "reserve KB", "module" );
+    while (!(status = NtQueryVirtualMemory( process, (void *)(ULONG_PTR)addr, MemoryWineUsageInformation,
+                                            &info, sizeof(info), NULL )))
+    {
+        i = min( info.UsageType, ARRAY_SIZE(usage_names) - 1 );
+        reserved[i]  += info.RegionSize;
+        committed[i] += info.CommitSize;
+        resident[i]  += info.ResidentSize;
+        if (info.UsageType == MemoryWineUsageImage)
+        {
+            if (NtQueryVirtualMemory( process, (void *)(ULONG_PTR)info.BaseAddress, MemoryMappedFilenameInformation,
+                                      name, sizeof(buffer), NULL ))
+            {
+                name->SectionFileName.Buffer = NULL;
+                name->SectionFileName.Length = 0;
+            }
+            printf( "%12I64u %12I64u %12I64u  %.*ls\n", info.CommitSize / 1024, info.ResidentSize / 1024,
+                    info.RegionSize / 1024, (int)(name->SectionFileName.Length / sizeof(WCHAR)),
+                    name->SectionFileName.Buffer );
+        }
+        if (info.BaseAddress + info.RegionSize <= addr) break;
+        addr = info.BaseAddress + info.RegionSize;
+    }
+    CloseHandle( process );
+    if (status != STATUS_NO_MORE_ENTRIES && status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve memory usage, status %#lx\n", status );
+        return 1;
+    }
+
+    printf( "\n%-10s %12s %12s %12s\n", "type", "reserve KB", "commit KB", "resident KB" );
+    for (i = 0; i < ARRAY_SIZE(usage_names); i++)
+        printf( "%-10s %12I64u %12I64u %12I64u\n", usage_names[i],
+                reserved[i] / 1024, committed[i] / 1024, resident[i] / 1024 );
+    return 0;
+}
+
+static PROCESS_WINE_IO_STATISTICS *get_io_statistics( HANDLE process, IO_COUNTERS *counters )
+{
+    PROCESS_WINE_IO_STATISTICS *stats = NULL;
+    ULONG size = offsetof( PROCESS_WINE_IO_STATISTICS, Handles[64] );
+    NTSTATUS status;
+
+    if ((status = NtQueryInformationProcess( process, ProcessIoCounters, counters, sizeof(*counters), NULL )))
+    {
+        fprintf( stderr, "winestat: failed to retrieve I/O counters, status %#lx\n", status );
+        return NULL;
+    }
+    for (;;)
+    {
+        if (!(stats = realloc( stats, size ))) return NULL;
+        status = NtQueryInformationProcess( process, ProcessWineIoStatistics, stats, size, &size );
+        if (status != STATUS_INFO_LENGTH_MISMATCH) break;
+    }
+    if (status)
+    {
+        fprintf( stderr, "winestat: failed to retrieve I/O statistics, status %#lx\n", status );
+        free( stats );
+        return NULL;
+    }
+    return stats;
+}
+
+/* turn the statistics into the activity since the previous ones; handles are returned in ascending order */
+static void subtract_io_statistics( PROCESS_WINE_IO_STATISTICS *stats, const PROCESS_WINE_IO_STATISTICS *prev )
+{
+    PROCESS_WINE_HANDLE_IO_INFORMATION *cur;
+    const PROCESS_WINE_HANDLE_IO_INFORMATION *old;
+    ULONG i, j = 0;
+
+    for (i = 0; i < stats->Count; i++)
+    {
+        cur = &stats->Handles[i];
+        while (j < prev->Count && prev->Handles[j].Handle < cur->Handle) j++;
+        if (j == prev->Count || prev->Handles[j].Handle != cur->Handle) continue;
+        old = &prev->Handles[j];
+        /* the handle was closed and reused in the meantime */
+        if (cur->ReadOperationCount < old->ReadOperationCount ||
+            cur->WriteOperationCount < old->WriteOperationCount) continue;
+        cur->ReadTransferCount   -= old->ReadTransferCount;
+        cur->WriteTransferCount  -= old->WriteTransferCount;
+        cur->ReadTime            -= old->ReadTime;
+        cur->WriteTime           -= old->WriteTime;
+        cur->ReadOperationCount  -= old->ReadOperationCount;
+        cur->WriteOperationCount -= old->WriteOperationCount;
+        cur->AsyncOperationCount -= old->AsyncOperationCount;
+        cur->ZeroCopyOperationCount -= old->ZeroCopyOperationCount;
+    }
+}
+
+static ULONGLONG handle_io_sort_value( const PROCESS_WINE_HANDLE_IO_INFORMATION *io )
+{
+    ULONG ops = io->ReadOperationCount + io->WriteOperationCount;
+
+    switch (sort_key)
+    {
+    case SORT_COUNT:   return ops;
+    case SORT_BYTES:   return io->ReadTransferCount + io->WriteTransferCount;
+    case SORT_LATENCY: return ops ? (io->ReadTime + io->WriteTime) / ops : 0;
+    default:           return io->ReadTime + io->WriteTime;
+    }
+}
+
+static int __cdecl compare_handle_io( const void *a, const void *b )
+{
+    const PROCESS_WINE_HANDLE_IO_INFORMATION *io_a = a, *io_b = b;
+    ULONGLONG val_a = handle_io_sort_value( io_a ), val_b = handle_io_sort_value( io_b );
+
+    if (val_a == val_b) return io_a->Handle < io_b->Handle ? -1 : io_a->Handle > io_b->Handle;
+    return val_a < val_b ? 1 : -1;
+}
+
+static void print_handle_name( HANDLE process, ULONG64 handle )
+{
+    char buffer[sizeof(OBJECT_NAME_INFORMATION) + MAX_PATH * sizeof(WCHAR)];
+    OBJECT_NAME_INFORMATION *name = (OBJECT_NAME_INFORMATION *)buffer;
+    OBJECT_TYPE_INFORMATION *type = (OBJECT_TYPE_INFORMATION *)buffer;
+    HANDLE dup;
+
+    if (!DuplicateHandle( process, (HANDLE)(ULONG_PTR)handle, GetCurrentProcess(), &dup, 0, FALSE,
+                          DUPLICATE_SAME_ACCESS ))
+    {
+        printf( "\n" );
+        return;
+    }
+    if (!NtQueryObject( dup, ObjectNameInformation, name, sizeof(buffer) - sizeof(WCHAR), NULL ) &&
+        name->Name.Length)
+        printf( "%.*ls\n", (int)(name->Name.Length / sizeof(WCHAR)), name->Name.Buffer );
+    else if (!NtQueryObject( dup, ObjectTypeInformation, type, sizeof(buffer) - sizeof(WCHAR), NULL ))
+        printf( "(%.*ls)\n", (int)(type->TypeName.Length / sizeof(WCHAR)), type->TypeName.Buffer );
+    else
+        printf( "\n" );
+    CloseHandle( dup );
+}
+
+static void print_io_statistics( HANDLE process, PROCESS_WINE_IO_STATISTICS *stats,
+                                 const IO_COUNTERS *counters, unsigned int max_count )
+{
+    ULONG i;
+
+    printf( "%I64u reads (%I64u KB), %I64u writes (%I64u KB), %I64u other operations\n\n",
+            counters->ReadOperationCount, counters->ReadTransferCount / 1024,
+            counters->WriteOperationCount, counters->WriteTransferCount / 1024,
+            counters->OtherOperationCount );
+
+    qsort( stats->Handles, stats->Count, sizeof(stats->Handles[0]), compare_handle_io );
+
+    printf( "%8s %9s %9s %6s %9s %12s %12s %10s %10s  %s\n", "handle", "reads", "writes", "async",
+            "zerocopy", "read KB", "write KB", "read us", "write us", "name" );
+    for (i = 0; i < stats->Count && (!max_count || i < max_count); i++)
+    {
+        const PROCESS_WINE_HANDLE_IO_INFORMATION *io = &stats->Handles[i];
+        ULONG ops = io->ReadOperationCount + io->WriteOperationCount;
+
+        if (!ops) continue;
+        printf( "%8I64x %9lu %9lu %5.1f%% %9lu %12.1f %12.1f %10.1f %10.1f  ", io->Handle,
+                io->ReadOperationCount, io->WriteOperationCount, io->AsyncOperationCount * 100.0 / ops,
+                io->ZeroCopyOperationCount,
+                io->ReadTransferCount / 1024.0, io->WriteTransferCount / 1024.0,
+                io->ReadOperationCount ? io->ReadTime / 10.0 / io->ReadOperationCount : 0.0,
+                io->WriteOperationCount ? io->WriteTime / 10.0 / io->WriteOperationCount : 0.0 );
+        print_handle_name( process, io->Handle );
+    }
+}
+
+static int show_io( DWORD pid, unsigned int max_count, unsigned int interval )
+{
+    PROCESS_WINE_IO_STATISTICS *stats, *prev, *delta;
+    IO_COUNTERS counters, prev_counters, delta_counters;
+    HANDLE process;
+    ULONG size;
+
+    if (!(process = OpenProcess( PROCESS_QUERY_INFORMATION | PROCESS_DUP_HANDLE, FALSE, pid )) &&
+        !(process = OpenProcess( PROCESS_QUERY_INFORMATION, FALSE, pid )))
+    {
+        fprintf( stderr, "winestat: failed to open process %04lx, error %lu\n", pid, GetLastError() );
+        return 1;
+    }
+
+    if (!(prev = get_io_statistics( process, &prev_counters )))
+    {
+        CloseHandle( process );
+        return 1;
+    }
+    if (!interval)
+    {
+        print_io_statistics( process, prev, &prev_counters, max_count );
+        free( prev );
+        CloseHandle( process );
+        return 0;
+    }
+
+    for (;;)
+    {
+        Sleep( interval * 1000 );
+        if (!(stats = get_io_statistics( process, &counters ))) break;
+        size = offsetof( PROCESS_WINE_IO_STATISTICS, Handles[stats->Count] );
+        if (!(delta = malloc( size )))
+        {
+            free( stats );
+            break;
+        }
+        memcpy( delta, stats, size );
+        subtract_io_statistics( delta, prev );
+        delta_counters.ReadOperationCount  = counters.ReadOperationCount - prev_counters.ReadOperationCount;
+        delta_counters.WriteOperationCount = counters.WriteOperationCount - prev_counters.WriteOperationCount;
+        delta_counters.OtherOperationCount = counters.OtherOperationCount - prev_counters.OtherOperationCount;
+        delta_counters.ReadTransferCount   = counters.ReadTransferCount - prev_counters.ReadTransferCount;
+        delta_counters.WriteTransferCount  = counters.WriteTransferCount - prev_counters.WriteTransferCount;
+        delta_counters.OtherTransferCount  = counters.OtherTransferCount - prev_counters.OtherTransferCount;
+        printf( "last %u s: ", interval );
+        print_io_statistics( process, delta, &delta_counters, max_count );
+        printf( "\n" );
+        free( delta );
+        free( prev );
+        prev = stats;
+        prev_counters = counters;
+    }
+    free( prev );
+    CloseHandle( process );
+    return 1;
+}
+
+int __cdecl main( int argc, char *argv[] )
+{
+    unsigned int max_count = 20, interval = 0;
+    BOOL reset = FALSE, directories = FALSE, fsync = FALSE, images = FALSE, memory = FALSE, io = FALSE;
+    BOOL scheduler = FALSE;
+    DWORD pid = 0;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp( argv[i], "requests" )) directories = fsync = images = scheduler = memory = io = FALSE;
+        else if (!strcmp( argv[i], "directories" )) directories = TRUE;
+        else if (!strcmp( argv[i], "fsync" )) fsync = TRUE;
+        else if (!strcmp( argv[i], "images" )) images = TRUE;
+        else if (!strcmp( argv[i], "scheduler" )) scheduler = TRUE;
+        else if (!strcmp( argv[i], "memory" ) && i + 1 < argc)
+        {
+            memory = TRUE;
+            pid = strtoul( argv[++i], NULL, 0 );
+        }
+        else if (!strcmp( argv[i], "io" ) && i + 1 < argc)
+        {
+            io = TRUE;
+            pid = strtoul( argv[++i], NULL, 0 );
+        }
+        else if (!strcmp( argv[i], "-i" ) && i + 1 < argc) interval = atoi( argv[++i] );
+        else if (!strcmp( argv[i], "-r" )) reset = TRUE;
+        else if (!strcmp( argv[i], "-n" ) && i + 1 < argc) max_count = atoi( argv[++i] );
+        else if (!strcmp( argv[i], "-s" ) && i + 1 < argc)
+        {
+            i++;
+            if (!strcmp( argv[i], "time" )) sort_key = SORT_TIME;
+            else if (!strcmp( argv[i], "count" )) sort_key = SORT_COUNT;
+            else if (!strcmp( argv[i], "max" )) sort_key = SORT_MAX;
+            else if (!strcmp( argv[i], "bytes" )) sort_key = SORT_BYTES;
+            else if (!strcmp( argv[i], "latency" )) sort_key = SORT_LATENCY;
+            else usage();
+        }
+        else usage();
+    }
+    if (fsync) return show_fsync();
+    if (images) return show_images();
+    if (scheduler) return show_scheduler();
+    if (memory) return show_memory( pid );
+    if (io) return show_io( pid, max_count, interval );
+    if (directories) return show_directories();
+    return show_requests( max_count, reset );
+}
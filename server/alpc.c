@@ -0,0 +1,577 @@
+/*
+ * Server-side ALPC ports implementation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* FIXMEs:
+ *  - message data is always copied through the server, sections and views aren't supported
+ *  - message attributes and completion lists aren't supported
+ *  - messages for all the clients of a connection port are received on the connection port
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+
+#include "object.h"
+#include "handle.h"
+#include "thread.h"
+#include "process.h"
+#include "request.h"
+
+#define PORT_CONNECT     0x0001
+#define PORT_ALL_ACCESS  (STANDARD_RIGHTS_REQUIRED | SYNCHRONIZE | PORT_CONNECT)
+
+static const WCHAR alpc_port_name[] = {'A','L','P','C',' ','P','o','r','t'};
+
+struct type_descr alpc_port_type =
+{
+    { alpc_port_name, sizeof(alpc_port_name) },     /* name */
+    PORT_ALL_ACCESS,                                /* valid_access */
+    {                                               /* mapping */
+        READ_CONTROL | PORT_CONNECT,
+        DELETE | PORT_CONNECT,
+        0,
+        PORT_ALL_ACCESS
+    },
+};
+
+enum alpc_port_kind
+{
+    ALPC_CONNECTION_PORT,   /* named port the server listens on */
+    ALPC_SERVER_PORT,       /* server end of a connection */
+    ALPC_CLIENT_PORT        /* client end of a connection */
+};
+
+struct alpc_port
+{
+    struct object        obj;        /* object header */
+    enum alpc_port_kind  kind;
+    struct alpc_port    *listener;   /* connection port, for communication ports */
+    struct alpc_port    *peer;       /* other end of the connection */
+    struct list          queue;      /* messages waiting to be received */
+    struct list          pending;    /* received messages waiting for a reply */
+    struct list          sent;       /* messages sent from this port */
+    data_size_t          max_size;   /* maximum message data size */
+    process_id_t         pid;        /* creator of the port */
+    thread_id_t          tid;
+    int                  closed;     /* connection port without handles left */
+};
+
+struct alpc_message
+{
+    struct object        obj;        /* object header, waited upon by the sender */
+    struct list          entry;      /* entry in the queue or pending list of a port */
+    struct list          sent_entry; /* entry in the sent list of the sender */
+    struct alpc_port    *sender;     /* port the message was sent from */
+    unsigned int         id;
+    unsigned short       type;       /* LPC_* message type */
+    process_id_t         pid;        /* sender thread */
+    thread_id_t          tid;
+    data_size_t          size;
+    void                *data;
+    unsigned int         status;     /* STATUS_PENDING until replied to */
+    process_id_t         reply_pid;  /* replying thread */
+    thread_id_t          reply_tid;
+    data_size_t          reply_size;
+    void                *reply;
+};
+
+static void alpc_port_dump( struct object *obj, int verbose );
+static int alpc_port_signaled( struct object *obj, struct wait_queue_entry *entry );
+static int alpc_port_close_handle( struct object *obj, struct process *process, obj_handle_t handle );
+static void alpc_port_destroy( struct object *obj );
+
+static const struct object_ops alpc_port_ops =
+{
+    sizeof(struct alpc_port),  /* size */
+    &alpc_port_type,           /* type */
+    alpc_port_dump,            /* dump */
+    add_queue,                 /* add_queue */
+    remove_queue,              /* remove_queue */
+    alpc_port_signaled,        /* signaled */
+    NULL,                      /* get_esync_fd */
+    NULL,                      /* get_fsync_idx */
+    no_satisfied,              /* satisfied */
+    no_signal,                 /* signal */
+    no_get_fd,                 /* get_fd */
+    default_map_access,        /* map_access */
+    default_get_sd,            /* get_sd */
+    default_set_sd,            /* set_sd */
+    default_get_full_name,     /* get_full_name */
+    no_lookup_name,            /* lookup_name */
+    directory_link_name,       /* link_name */
+    default_unlink_name,       /* unlink_name */
+    no_open_file,              /* open_file */
+    no_kernel_obj_list,        /* get_kernel_obj_list */
+    alpc_port_close_handle,    /* close_handle */
+    alpc_port_destroy          /* destroy */
+};
+
+static void alpc_message_dump( struct object *obj, int verbose );
+static int alpc_message_signaled( struct object *obj, struct wait_queue_entry *entry );
+static void alpc_message_destroy( struct object *obj );
+
+static const struct object_ops alpc_message_ops =
+{
+    sizeof(struct alpc_message), /* size */
+    &no_type,                    /* type */
+    alpc_message_dump,           /* dump */
+    add_queue,                   /* add_queue */
+    remove_queue,                /* remove_queue */
+    alpc_message_signaled,       /* signaled */
+    NULL,                        /* get_esync_fd */
+    NULL,                        /* get_fsync_idx */
+    no_satisfied,                /* satisfied */
+    no_signal,                   /* signal */
+    no_get_fd,                   /* get_fd */
+    default_map_access,          /* map_access */
+    default_get_sd,              /* get_sd */
+    default_set_sd,              /* set_sd */
+    no_get_full_name,            /* get_full_name */
+    no_lookup_name,              /* lookup_name */
+    no_link_name,                /* link_name */
+    NULL,                        /* unlink_name */
+    no_open_file,                /* open_file */
+    no_kernel_obj_list,          /* get_kernel_obj_list */
+    no_close_handle,             /* close_handle */
+    alpc_message_destroy         /* destroy */
+};
+
+static unsigned int last_message_id;
+
+static void alpc_port_dump( struct object *obj, int verbose )
+{
+    struct alpc_port *port = (struct alpc_port *)obj;
+    assert( obj->ops == &alpc_port_ops );
+    fprintf( stderr, "ALPC port kind=%d peer=%p\n", port->kind, port->peer );
+}
+
+/* only the ports that messages are queued to get signaled, i.e. not the server ends */
+static int alpc_port_signaled( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct alpc_port *port = (struct alpc_port *)obj;
+    assert( obj->ops == &alpc_port_ops );
+    return !list_empty( &port->queue );
+}
+
+static void alpc_message_dump( struct object *obj, int verbose )
+{
+    struct alpc_message *msg = (struct alpc_message *)obj;
+    assert( obj->ops == &alpc_message_ops );
+    fprintf( stderr, "ALPC message id=%u type=%u size=%u status=%08x\n", msg->id, msg->type, msg->size, msg->status );
+}
+
+static int alpc_message_signaled( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct alpc_message *msg = (struct alpc_message *)obj;
+    assert( obj->ops == &alpc_message_ops );
+    return msg->status != STATUS_PENDING;
+}
+
+static void alpc_message_destroy( struct object *obj )
+{
+    struct alpc_message *msg = (struct alpc_message *)obj;
+    assert( obj->ops == &alpc_message_ops );
+
+    if (msg->sender) list_remove( &msg->sent_entry );
+    free( msg->data );
+    free( msg->reply );
+}
+
+/* the port that the messages sent to a port end up queued on */
+static struct alpc_port *get_queue_port( struct alpc_port *port )
+{
+    return port->kind == ALPC_SERVER_PORT ? port->listener : port;
+}
+
+static struct alpc_message *create_message( struct alpc_port *sender, unsigned short type,
+                                            const void *data, data_size_t size )
+{
+    struct alpc_message *msg;
+
+    if (!(msg = alloc_object( &alpc_message_ops ))) return NULL;
+    msg->sender     = sender;
+    msg->type       = type;
+    msg->pid        = sender ? get_process_id( current->process ) : 0;
+    msg->tid        = sender ? get_thread_id( current ) : 0;
+    msg->size       = size;
+    msg->data       = NULL;
+    msg->status     = STATUS_PENDING;
+    msg->reply_pid  = 0;
+    msg->reply_tid  = 0;
+    msg->reply_size = 0;
+    msg->reply      = NULL;
+    if (!++last_message_id) last_message_id++;
+    msg->id = last_message_id;
+    if (size && !(msg->data = memdup( data, size )))
+    {
+        msg->sender = NULL;
+        release_object( msg );
+        return NULL;
+    }
+    if (sender) list_add_tail( &sender->sent, &msg->sent_entry );
+    return msg;
+}
+
+static void queue_message( struct alpc_port *port, struct alpc_message *msg )
+{
+    list_add_tail( &port->queue, &msg->entry );
+    if (list_head( &port->queue ) == &msg->entry) wake_up( &port->obj, 0 );
+}
+
+/* complete a message for its sender, and drop it from the port it was queued on */
+static void complete_message( struct alpc_message *msg, unsigned int status, const void *reply, data_size_t size )
+{
+    if (size && !(msg->reply = memdup( reply, size )))
+    {
+        status = STATUS_NO_MEMORY;
+        size = 0;
+    }
+    msg->status     = status;
+    msg->reply_size = size;
+    if (current)
+    {
+        msg->reply_pid = get_process_id( current->process );
+        msg->reply_tid = get_thread_id( current );
+    }
+    list_remove( &msg->entry );
+    wake_up( &msg->obj, 0 );
+    release_object( msg );
+}
+
+static void fail_messages( struct list *list, struct alpc_port *sender, unsigned int status )
+{
+    struct alpc_message *msg, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( msg, next, list, struct alpc_message, entry )
+        if (!sender || msg->sender == sender) complete_message( msg, status, NULL, 0 );
+}
+
+static void post_port_closed( struct alpc_port *port, struct alpc_port *closed )
+{
+    struct alpc_message *msg;
+
+    if (!(msg = create_message( NULL, LPC_PORT_CLOSED, NULL, 0 ))) return;
+    msg->pid = closed->pid;
+    msg->tid = closed->tid;
+    queue_message( port, msg );
+}
+
+/* break a connection, failing the messages still waiting in either direction */
+static void disconnect_port( struct alpc_port *port )
+{
+    struct alpc_port *peer = port->peer, *queue;
+
+    if (!peer) return;
+    port->peer = peer->peer = NULL;
+
+    queue = get_queue_port( peer );
+    fail_messages( &queue->queue, port, STATUS_PORT_DISCONNECTED );
+    fail_messages( &queue->pending, port, STATUS_PORT_DISCONNECTED );
+    if (!queue->closed) post_port_closed( queue, port );
+
+    queue = get_queue_port( port );
+    fail_messages( &queue->queue, peer, STATUS_PORT_DISCONNECTED );
+    fail_messages( &queue->pending, peer, STATUS_PORT_DISCONNECTED );
+}
+
+static void close_connection_port( struct alpc_port *port )
+{
+    port->closed = 1;
+    fail_messages( &port->queue, NULL, STATUS_PORT_DISCONNECTED );
+    fail_messages( &port->pending, NULL, STATUS_PORT_DISCONNECTED );
+    unlink_named_object( &port->obj );
+}
+
+static int alpc_port_close_handle( struct object *obj, struct process *process, obj_handle_t handle )
+{
+    struct alpc_port *port = (struct alpc_port *)obj;
+    assert( obj->ops == &alpc_port_ops );
+
+    if (obj->handle_count == 1)  /* last handle */
+    {
+        if (port->kind == ALPC_CONNECTION_PORT) close_connection_port( port );
+        else disconnect_port( port );
+    }
+    return 1;
+}
+
+static void alpc_port_destroy( struct object *obj )
+{
+    struct alpc_port *port = (struct alpc_port *)obj;
+    struct alpc_message *msg, *next;
+
+    assert( obj->ops == &alpc_port_ops );
+
+    disconnect_port( port );
+    fail_messages( &port->queue, NULL, STATUS_PORT_DISCONNECTED );
+    fail_messages( &port->pending, NULL, STATUS_PORT_DISCONNECTED );
+    LIST_FOR_EACH_ENTRY_SAFE( msg, next, &port->sent, struct alpc_message, sent_entry )
+    {
+        list_remove( &msg->sent_entry );
+        msg->sender = NULL;
+    }
+    if (port->listener) release_object( port->listener );
+}
+
+static struct alpc_port *create_port( struct object *root, const struct unicode_str *name,
+                                      unsigned int attr, const struct security_descriptor *sd,
+                                      enum alpc_port_kind kind, struct alpc_port *listener )
+{
+    struct alpc_port *port;
+
+    if (name) port = create_named_object( root, &alpc_port_ops, name, attr, sd );
+    else port = alloc_object( &alpc_port_ops );
+    if (!port) return NULL;
+    if (name && get_error() == STATUS_OBJECT_NAME_EXISTS)
+    {
+        release_object( port );
+        set_error( STATUS_OBJECT_NAME_COLLISION );
+        return NULL;
+    }
+
+    port->kind     = kind;
+    port->listener = listener ? (struct alpc_port *)grab_object( listener ) : NULL;
+    port->peer     = NULL;
+    port->max_size = listener ? listener->max_size : 0;
+    port->pid      = get_process_id( current->process );
+    port->tid      = get_thread_id( current );
+    port->closed   = 0;
+    list_init( &port->queue );
+    list_init( &port->pending );
+    list_init( &port->sent );
+    return port;
+}
+
+static struct alpc_port *get_port_obj( struct process *process, obj_handle_t handle, unsigned int access )
+{
+    return (struct alpc_port *)get_handle_obj( process, handle, access, &alpc_port_ops );
+}
+
+static struct alpc_message *find_pending( struct alpc_port *port, unsigned int id )
+{
+    struct alpc_message *msg;
+
+    LIST_FOR_EACH_ENTRY( msg, &port->pending, struct alpc_message, entry )
+        if (msg->id == id) return msg;
+    return NULL;
+}
+
+/* create an ALPC connection port */
+DECL_HANDLER(create_alpc_port)
+{
+    struct alpc_port *port;
+    struct unicode_str name;
+    struct object *root;
+    const struct security_descriptor *sd;
+    const struct object_attributes *objattr = get_req_object_attributes( &sd, &name, &root );
+
+    if (!objattr) return;
+
+    if ((port = create_port( root, name.len ? &name : NULL, objattr->attributes, sd,
+                             ALPC_CONNECTION_PORT, NULL )))
+    {
+        port->max_size = req->max_size;
+        reply->handle = alloc_handle( current->process, port, req->access, objattr->attributes );
+        release_object( port );
+    }
+
+    if (root) release_object( root );
+}
+
+/* connect to an ALPC connection port */
+DECL_HANDLER(connect_alpc_port)
+{
+    struct alpc_port *listener, *port;
+    struct alpc_message *msg;
+    struct unicode_str name;
+
+    if (req->namelen > get_req_data_size())
+    {
+        set_error( STATUS_INVALID_PARAMETER );
+        return;
+    }
+    name.str = get_req_data();
+    name.len = (req->namelen / sizeof(WCHAR)) * sizeof(WCHAR);
+
+    if (!(listener = open_named_object( NULL, &alpc_port_ops, &name, OBJ_CASE_INSENSITIVE ))) return;
+
+    if (listener->kind != ALPC_CONNECTION_PORT) set_error( STATUS_OBJECT_TYPE_MISMATCH );
+    else if (listener->closed) set_error( STATUS_PORT_DISCONNECTED );
+    else if (get_req_data_size() - req->namelen > listener->max_size) set_error( STATUS_PORT_MESSAGE_TOO_LONG );
+    else if ((port = create_port( NULL, NULL, 0, NULL, ALPC_CLIENT_PORT, listener )))
+    {
+        if ((msg = create_message( port, LPC_CONNECTION_REQUEST, (const char *)get_req_data() + req->namelen,
+                                   get_req_data_size() - req->namelen )))
+        {
+            if ((reply->wait = alloc_handle( current->process, msg, SYNCHRONIZE, 0 )))
+            {
+                reply->handle = alloc_handle( current->process, port, PORT_ALL_ACCESS, 0 );
+                queue_message( listener, msg );
+            }
+            else release_object( msg );
+        }
+        release_object( port );
+    }
+    release_object( listener );
+}
+
+/* accept or refuse a connection request received on a connection port */
+DECL_HANDLER(accept_alpc_port)
+{
+    struct alpc_port *listener, *port, *client;
+    struct alpc_message *msg;
+
+    if (!(listener = get_port_obj( current->process, req->port, 0 ))) return;
+
+    if (listener->kind != ALPC_CONNECTION_PORT ||
+        !(msg = find_pending( listener, req->id )) || msg->type != LPC_CONNECTION_REQUEST)
+    {
+        set_error( STATUS_REPLY_MESSAGE_MISMATCH );
+    }
+    else if (!(client = msg->sender))
+    {
+        complete_message( msg, STATUS_PORT_DISCONNECTED, NULL, 0 );
+        set_error( STATUS_PORT_DISCONNECTED );
+    }
+    else if (!req->accept)
+    {
+        complete_message( msg, STATUS_PORT_CONNECTION_REFUSED, get_req_data(), get_req_data_size() );
+    }
+    else if ((port = create_port( NULL, NULL, 0, NULL, ALPC_SERVER_PORT, listener )))
+    {
+        if ((reply->handle = alloc_handle( current->process, port, PORT_ALL_ACCESS, 0 )))
+        {
+            port->peer = client;
+            client->peer = port;
+            complete_message( msg, STATUS_SUCCESS, get_req_data(), get_req_data_size() );
+        }
+        release_object( port );
+    }
+    release_object( listener );
+}
+
+/* send a message, or a reply to a received request */
+DECL_HANDLER(send_alpc_message)
+{
+    struct alpc_port *port;
+    struct alpc_message *msg;
+
+    if (!(port = get_port_obj( current->process, req->port, 0 ))) return;
+
+    if (get_req_data_size() > (port->listener ? port->listener->max_size : port->max_size))
+    {
+        set_error( STATUS_PORT_MESSAGE_TOO_LONG );
+    }
+    else if (req->id)
+    {
+        if (!(msg = find_pending( get_queue_port( port ), req->id )) || msg->type != LPC_REQUEST)
+            set_error( STATUS_REPLY_MESSAGE_MISMATCH );
+        else
+        {
+            reply->id = msg->id;
+            complete_message( msg, STATUS_SUCCESS, get_req_data(), get_req_data_size() );
+        }
+    }
+    else if (port->kind == ALPC_CONNECTION_PORT) set_error( STATUS_INVALID_PARAMETER );
+    else if (!port->peer || get_queue_port( port->peer )->closed) set_error( STATUS_PORT_DISCONNECTED );
+    else if ((msg = create_message( port, req->sync ? LPC_REQUEST : LPC_DATAGRAM,
+                                    get_req_data(), get_req_data_size() )))
+    {
+        reply->id = msg->id;
+        if (!req->sync || (reply->wait = alloc_handle( current->process, msg, SYNCHRONIZE, 0 )))
+            queue_message( get_queue_port( port->peer ), msg );
+        else
+            release_object( msg );
+    }
+    release_object( port );
+}
+
+/* receive the next message queued on a port */
+DECL_HANDLER(receive_alpc_message)
+{
+    struct alpc_port *port, *queue;
+    struct alpc_message *msg;
+    struct list *ptr;
+
+    if (!(port = get_port_obj( current->process, req->port, 0 ))) return;
+
+    queue = get_queue_port( port );
+    if (!(ptr = list_head( &queue->queue ))) set_error( STATUS_PENDING );
+    else
+    {
+        msg = LIST_ENTRY( ptr, struct alpc_message, entry );
+        reply->id   = msg->id;
+        reply->type = msg->type;
+        reply->pid  = msg->pid;
+        reply->tid  = msg->tid;
+        reply->size = msg->size;
+        if (msg->size > get_reply_max_size()) set_error( STATUS_BUFFER_TOO_SMALL );
+        else
+        {
+            set_reply_data( msg->data, msg->size );
+            list_remove( &msg->entry );
+            if (msg->type == LPC_REQUEST || msg->type == LPC_CONNECTION_REQUEST)
+                list_add_tail( &queue->pending, &msg->entry );
+            else
+                release_object( msg );
+        }
+    }
+    release_object( port );
+}
+
+/* retrieve the reply to a message once it has been signaled */
+DECL_HANDLER(get_alpc_reply)
+{
+    struct alpc_message *msg;
+
+    if (!(msg = (struct alpc_message *)get_handle_obj( current->process, req->wait, 0, &alpc_message_ops )))
+        return;
+
+    reply->id   = msg->id;
+    reply->pid  = msg->reply_pid;
+    reply->tid  = msg->reply_tid;
+    reply->size = msg->reply_size;
+    if (msg->status == STATUS_PENDING || msg->reply_size > get_reply_max_size())
+        set_error( msg->status == STATUS_PENDING ? STATUS_PENDING : STATUS_BUFFER_TOO_SMALL );
+    else
+    {
+        set_reply_data( msg->reply, msg->reply_size );
+        set_error( msg->status );
+    }
+    release_object( msg );
+}
+
+/* disconnect a communication port */
+DECL_HANDLER(disconnect_alpc_port)
+{
+    struct alpc_port *port;
+
+    if (!(port = get_port_obj( current->process, req->port, 0 ))) return;
+    if (port->kind == ALPC_CONNECTION_PORT) set_error( STATUS_INVALID_PORT_HANDLE );
+    else if (!port->peer) set_error( STATUS_PORT_DISCONNECTED );
+    else disconnect_port( port );
+    release_object( port );
+}
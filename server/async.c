@@ -677,6 +677,52 @@ void async_wake_up( struct async_queue *queue, unsigned int status )
     }
 }
 
+/* alert the asyncs of a process whose I/O was already done by the client on their behalf */
+void async_alert_users( struct async_queue *queue, struct process *process,
+                        const client_ptr_t *users, data_size_t count )
+{
+    struct async *async, *next;
+    data_size_t i;
+
+    LIST_FOR_EACH_ENTRY_SAFE( async, next, &queue->queue, struct async, queue_entry )
+    {
+        if (async->terminated || async->thread->process != process) continue;
+        for (i = 0; i < count; i++)
+        {
+            if (async->data.user != users[i]) continue;
+            async_terminate( async, STATUS_ALERTED );
+            break;
+        }
+    }
+}
+
+/* move an alerted async of a process to another queue of the same fd, until woken by async_wake_parked() */
+struct async *async_park_user( struct async_queue *from, struct async_queue *to,
+                               struct process *process, client_ptr_t user )
+{
+    struct async *async;
+
+    LIST_FOR_EACH_ENTRY( async, &from->queue, struct async, queue_entry )
+    {
+        if (async->thread->process != process || async->data.user != user) continue;
+        if (!async->terminated || !async->alerted) break;
+        list_remove( &async->queue_entry );
+        list_add_tail( &to->queue, &async->queue_entry );
+        async->queue = to;
+        return (struct async *)grab_object( async );
+    }
+    return NULL;
+}
+
+/* alert a parked async again; returns 0 if the client has not restarted it yet */
+int async_wake_parked( struct async *async )
+{
+    if (!async->queue) return 1;  /* completed or cancelled in the meantime */
+    if (async->terminated) return !async->alerted;
+    async_terminate( async, STATUS_ALERTED );
+    return 1;
+}
+
 static void iosb_dump( struct object *obj, int verbose );
 static void iosb_destroy( struct object *obj );
 
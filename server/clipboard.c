@@ -31,6 +31,7 @@
 #include "request.h"
 #include "object.h"
 #include "file.h"
+#include "handle.h"
 #include "process.h"
 #include "user.h"
 #include "winuser.h"
@@ -44,6 +45,7 @@ struct clip_format
     unsigned int   seqno;            /* sequence number when the data was set */
     data_size_t    size;             /* size of the data block */
     void          *data;             /* data contents, or NULL for delay-rendered */
+    struct object *mapping;          /* section holding the data contents instead, for large formats */
 };
 
 struct clipboard
@@ -118,6 +120,7 @@ static struct clip_format *add_format( struct clipboard *clipboard, unsigned int
     format->from = 0;
     format->size = 0;
     format->data = NULL;
+    format->mapping = NULL;
     list_add_tail( &clipboard->formats, &format->entry );
     clipboard->format_count++;
     if (id < CF_MAX) clipboard->format_map |= 1 << id;
@@ -133,6 +136,7 @@ static void free_clipboard_formats( struct clipboard *clipboard )
     {
         list_remove( &format->entry );
         free( format->data );
+        if (format->mapping) release_object( format->mapping );
         free( format );
     }
     clipboard->format_count = 0;
@@ -304,7 +308,7 @@ static user_handle_t release_clipboard( struct clipboard *clipboard )
     /* free the delayed-rendered formats, since we no longer have an owner to render them */
     LIST_FOR_EACH_ENTRY_SAFE( format, next, &clipboard->formats, struct clip_format, entry )
     {
-        if (format->data) continue;
+        if (format->data || format->mapping) continue;
         /* format->from is earlier in the list and thus has already been
          * removed if not available anymore (it is also < CF_MAX)
          */
@@ -404,6 +408,8 @@ DECL_HANDLER(set_clipboard_data)
 {
     struct clip_format *format;
     struct clipboard *clipboard = get_process_clipboard();
+    struct object *mapping = NULL;
+    data_size_t size = get_req_data_size();
     void *data = NULL;
 
     if (!clipboard) return;
@@ -414,22 +420,31 @@ DECL_HANDLER(set_clipboard_data)
         return;
     }
 
-    if (get_req_data_size() && !(data = memdup( get_req_data(), get_req_data_size() ))) return;
+    if (req->mapping)
+    {
+        /* large formats are kept in the client section instead of being copied around */
+        if (!(mapping = get_data_mapping( current->process, req->mapping, req->size ))) return;
+        size = req->size;
+    }
+    else if (size && !(data = memdup( get_req_data(), size ))) return;
 
     if (!(format = get_format( clipboard, req->format )))
     {
         if (!(format = add_format( clipboard, req->format )))
         {
             free( data );
+            if (mapping) release_object( mapping );
             return;
         }
     }
 
     free( format->data );
-    format->from   = 0;
-    format->seqno  = clipboard->seqno;
-    format->size   = get_req_data_size();
-    format->data   = data;
+    if (format->mapping) release_object( format->mapping );
+    format->from    = 0;
+    format->seqno   = clipboard->seqno;
+    format->size    = size;
+    format->data    = data;
+    format->mapping = mapping;
     if (!clipboard->rendering) clipboard->seqno++;
 
     if (req->format == CF_TEXT || req->format == CF_OEMTEXT || req->format == CF_UNICODETEXT)
@@ -462,7 +477,7 @@ DECL_HANDLER(get_clipboard_data)
     reply->seqno  = format->seqno;
     reply->owner  = clipboard->owner;
 
-    if (!format->data && req->render)  /* try rendering it client-side */
+    if (!format->data && !format->mapping && req->render)  /* try rendering it client-side */
     {
         if (format->from || clipboard->owner) clipboard->rendering++;
         return;
@@ -475,7 +490,10 @@ DECL_HANDLER(get_clipboard_data)
         set_error( STATUS_BUFFER_OVERFLOW );
         return;
     }
-    set_reply_data( format->data, format->size );
+    if (format->mapping)
+        reply->mapping = alloc_handle( current->process, format->mapping, SECTION_MAP_READ | SECTION_QUERY, 0 );
+    else
+        set_reply_data( format->data, format->size );
 
 done:
     if (!req->render) clipboard->rendering--;
@@ -364,8 +364,10 @@ DECL_HANDLER(remove_completion)
 {
     struct completion* completion;
     struct completion_wait *wait;
+    struct completion_msg *msgs;
     struct list *entry;
     struct comp_msg *msg;
+    unsigned int i, count;
 
     if (req->waited && (wait = (struct completion_wait *)current->locked_completion))
         current->locked_completion = NULL;
@@ -401,14 +403,26 @@ DECL_HANDLER(remove_completion)
     }
     else
     {
-        list_remove( entry );
-        wait->depth--;
-        msg = LIST_ENTRY( entry, struct comp_msg, queue_entry );
-        reply->ckey = msg->ckey;
-        reply->cvalue = msg->cvalue;
-        reply->status = msg->status;
-        reply->information = msg->information;
-        free( msg );
+        count = max( get_reply_max_size() / sizeof(*msgs), 1 );
+        count = min( count, wait->depth );
+        if (!(msgs = set_reply_data_size( count * sizeof(*msgs) )))
+        {
+            release_object( wait );
+            return;
+        }
+
+        for (i = 0; i < count && (entry = list_head( &wait->queue )); i++)
+        {
+            list_remove( entry );
+            wait->depth--;
+            msg = LIST_ENTRY( entry, struct comp_msg, queue_entry );
+            msgs[i].ckey        = msg->ckey;
+            msgs[i].cvalue      = msg->cvalue;
+            msgs[i].information = msg->information;
+            msgs[i].status      = msg->status;
+            msgs[i].__pad       = 0;
+            free( msg );
+        }
 
         if (!completion_wait_signaled( &wait->obj, NULL ))
         {
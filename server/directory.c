@@ -166,6 +166,7 @@ static struct type_descr *types[] =
     &file_type,
     &mapping_type,
     &key_type,
+    &alpc_port_type,
 };
 
 static void object_type_dump( struct object *obj, int verbose )
@@ -250,7 +251,7 @@ static void directory_destroy( struct object *obj )
 {
     struct directory *dir = (struct directory *)obj;
     assert( obj->ops == &directory_ops );
-    free( dir->entries );
+    free_namespace( dir->entries );
 }
 
 static struct directory *create_directory( struct object *root, const struct unicode_str *name,
@@ -405,12 +406,14 @@ void init_directories( struct fd *intl_fd )
     static const WCHAR dir_objtypeW[] = {'O','b','j','e','c','t','T','y','p','e','s'};
     static const WCHAR dir_kernelW[] = {'K','e','r','n','e','l','O','b','j','e','c','t','s'};
     static const WCHAR dir_nlsW[] = {'N','L','S'};
+    static const WCHAR dir_rpcW[] = {'R','P','C',' ','C','o','n','t','r','o','l'};
     static const struct unicode_str dir_global_str = {dir_globalW, sizeof(dir_globalW)};
     static const struct unicode_str dir_driver_str = {dir_driverW, sizeof(dir_driverW)};
     static const struct unicode_str dir_device_str = {dir_deviceW, sizeof(dir_deviceW)};
     static const struct unicode_str dir_objtype_str = {dir_objtypeW, sizeof(dir_objtypeW)};
     static const struct unicode_str dir_kernel_str = {dir_kernelW, sizeof(dir_kernelW)};
     static const struct unicode_str dir_nls_str = {dir_nlsW, sizeof(dir_nlsW)};
+    static const struct unicode_str dir_rpc_str = {dir_rpcW, sizeof(dir_rpcW)};
 
     /* symlinks */
     static const WCHAR link_dosdevW[] = {'D','o','s','D','e','v','i','c','e','s'};
@@ -478,7 +481,7 @@ void init_directories( struct fd *intl_fd )
     static const struct unicode_str intl_str = {intlW, sizeof(intlW)};
     static const struct unicode_str user_data_str = {user_dataW, sizeof(user_dataW)};
 
-    struct directory *dir_driver, *dir_device, *dir_global, *dir_kernel, *dir_nls;
+    struct directory *dir_driver, *dir_device, *dir_global, *dir_kernel, *dir_nls, *dir_rpc;
     struct object *named_pipe_device, *mailslot_device, *null_device;
     unsigned int i;
 
@@ -489,6 +492,7 @@ void init_directories( struct fd *intl_fd )
     dir_kernel     = create_directory( &root_directory->obj, &dir_kernel_str, OBJ_PERMANENT, HASH_SIZE, NULL );
     dir_global     = create_directory( &root_directory->obj, &dir_global_str, OBJ_PERMANENT, HASH_SIZE, NULL );
     dir_nls        = create_directory( &root_directory->obj, &dir_nls_str, OBJ_PERMANENT, HASH_SIZE, NULL );
+    dir_rpc        = create_directory( &root_directory->obj, &dir_rpc_str, OBJ_PERMANENT, HASH_SIZE, NULL );
 
     /* devices */
     named_pipe_device = create_named_pipe_device( &dir_device->obj, &named_pipe_str, OBJ_PERMANENT, NULL );
@@ -536,6 +540,7 @@ void init_directories( struct fd *intl_fd )
     release_object( dir_objtype );
     release_object( dir_kernel );
     release_object( dir_nls );
+    release_object( dir_rpc );
     release_object( dir_global );
 }
 
@@ -670,3 +675,61 @@ DECL_HANDLER(get_object_types)
     }
     else set_error( STATUS_BUFFER_OVERFLOW );
 }
+
+struct directory_stats_info
+{
+    char        *data;
+    data_size_t  size;
+    data_size_t  alloc;
+};
+
+static void add_directory_stats( struct object *obj, void *arg )
+{
+    struct directory_stats_info *info = arg;
+    struct directory *dir = (struct directory *)obj;
+    struct directory_stats *stats;
+    data_size_t name_len, len;
+    WCHAR *name;
+
+    if (obj->ops != &directory_ops) return;
+
+    if (!(name = obj->ops->get_full_name( obj, &name_len ))) name_len = 0;
+    len = (sizeof(*stats) + name_len + 7) & ~7;
+    if (info->size + len > info->alloc)
+    {
+        data_size_t alloc = max( info->alloc * 2, info->size + len );
+        char *data;
+
+        if (!(data = realloc( info->data, alloc )))
+        {
+            free( name );
+            return;
+        }
+        info->data  = data;
+        info->alloc = alloc;
+    }
+    stats = (struct directory_stats *)(info->data + info->size);
+    memset( stats, 0, len );
+    get_namespace_stats( dir->entries, &stats->count, &stats->hash_size, &stats->max_chain );
+    stats->name_len = name_len;
+    memcpy( stats + 1, name, name_len );
+    info->size += len;
+    free( name );
+
+    enum_namespace( dir->entries, add_directory_stats, info );
+}
+
+/* retrieve the hash table statistics of all the directories */
+DECL_HANDLER(get_directory_stats)
+{
+    struct directory_stats_info info = { NULL, 0, 0 };
+
+    add_directory_stats( &root_directory->obj, &info );
+    reply->total = info.size;
+    if (info.size > get_reply_max_size())
+    {
+        set_error( STATUS_BUFFER_TOO_SMALL );
+        free( info.data );
+    }
+    else set_reply_data_ptr( info.data, info.size );
+}
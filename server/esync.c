@@ -373,7 +373,8 @@ void esync_wake_up( struct object *obj )
     if (obj->ops->get_esync_fd)
     {
         fd = obj->ops->get_esync_fd( obj, &dummy );
-        esync_wake_fd( fd );
+        /* file objects only get an fd once somebody waits on them */
+        if (fd != -1) esync_wake_fd( fd );
     }
 }
 
@@ -561,6 +562,8 @@ DECL_HANDLER(get_esync_fd)
     if (obj->ops->get_esync_fd)
     {
         fd = obj->ops->get_esync_fd( obj, &type );
+        if (fd == -1 && obj->ops->get_esync_fd == default_fd_get_esync_fd)
+            fd = default_fd_create_esync_fd( obj );
         reply->type = type;
         if (obj->ops == &esync_ops)
         {
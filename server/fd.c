@@ -32,6 +32,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <poll.h>
+#include <pthread.h>
 #ifdef HAVE_LINUX_MAJOR_H
 #include <linux/major.h>
 #endif
@@ -106,6 +107,11 @@
 #if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE)
 # include <sys/epoll.h>
 # define USE_EPOLL
+# if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup)
+#  include <sys/mman.h>
+#  include <linux/io_uring.h>
+#  define USE_IO_URING
+# endif /* HAVE_LINUX_IO_URING_H && __NR_io_uring_setup */
 #endif /* HAVE_SYS_EPOLL_H && HAVE_EPOLL_CREATE */
 
 #if defined(HAVE_PORT_H) && defined(HAVE_PORT_CREATE)
@@ -243,7 +249,7 @@ struct inode
     struct device      *device;     /* device containing this inode */
     ino_t               ino;        /* inode number */
     struct list         open;       /* list of open file descriptors */
-    struct list         locks;      /* list of file locks */
+    struct file_lock   *locks;      /* interval tree of file locks */
     struct list         closed;     /* list of file descriptors to close at destroy time */
 };
 
@@ -283,7 +289,10 @@ struct file_lock
     struct object       obj;         /* object header */
     struct fd          *fd;          /* fd owning this lock */
     struct list         fd_entry;    /* entry in list of locks on a given fd */
-    struct list         inode_entry; /* entry in inode list of locks */
+    struct file_lock   *left;        /* children in the inode interval tree, sorted by start */
+    struct file_lock   *right;
+    file_pos_t          max_end;     /* highest end of the locks in this subtree */
+    int                 height;      /* height of this subtree */
     int                 shared;      /* shared lock? */
     file_pos_t          start;       /* locked region is interval [start;end) */
     file_pos_t          end;
@@ -353,6 +362,9 @@ timeout_t monotonic_time;
 
 struct _KUSER_SHARED_DATA *user_shared_data = NULL;
 static const int user_shared_data_timeout = 16;
+static const long user_shared_data_interval = 1000000;  /* updater thread period, in ns */
+static int user_shared_data_thread_started;
+static int user_shared_data_thread_running;
 
 static void atomic_store_ulong(volatile ULONG *ptr, ULONG value)
 {
@@ -376,9 +388,71 @@ static void atomic_store_long(volatile LONG *ptr, LONG value)
 #endif
 }
 
+static timeout_t get_system_time(void)
+{
+    static const timeout_t ticks_1601_to_1970 = (timeout_t)86400 * (369 * 365 + 89) * TICKS_PER_SEC;
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    return (timeout_t)now.tv_sec * TICKS_PER_SEC + now.tv_usec * 10 + ticks_1601_to_1970;
+}
+
+static void set_user_shared_data_clock( timeout_t system_time, timeout_t interrupt_time )
+{
+    timeout_t tick_count = interrupt_time / 10000;
+
+    atomic_store_long(&user_shared_data->SystemTime.High2Time, system_time >> 32);
+    atomic_store_ulong(&user_shared_data->SystemTime.LowPart, system_time);
+    atomic_store_long(&user_shared_data->SystemTime.High1Time, system_time >> 32);
+
+    atomic_store_long(&user_shared_data->InterruptTime.High2Time, interrupt_time >> 32);
+    atomic_store_ulong(&user_shared_data->InterruptTime.LowPart, interrupt_time);
+    atomic_store_long(&user_shared_data->InterruptTime.High1Time, interrupt_time >> 32);
+
+    atomic_store_long(&user_shared_data->TickCount.High2Time, tick_count >> 32);
+    atomic_store_ulong(&user_shared_data->TickCount.LowPart, tick_count);
+    atomic_store_long(&user_shared_data->TickCount.High1Time, tick_count >> 32);
+    atomic_store_ulong(&user_shared_data->TickCountLowDeprecated, tick_count);
+}
+
+/* keep the shared time fields current independently of the main loop wakeups; this thread
+ * is the only writer of these fields once it runs, and it touches nothing else */
+static void *user_shared_data_thread( void *arg )
+{
+    struct timespec interval = { 0, user_shared_data_interval };
+
+    for (;;)
+    {
+        set_user_shared_data_clock( get_system_time(), monotonic_counter() );
+        nanosleep( &interval, NULL );
+    }
+    return NULL;
+}
+
+static void start_user_shared_data_thread(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    sigset_t all, old;
+
+    user_shared_data_thread_started = 1;
+    if (getenv( "WINE_DISABLE_USER_SHARED_DATA_THREAD" )) return;
+
+    /* signals must keep being delivered to the main thread */
+    sigfillset( &all );
+    pthread_sigmask( SIG_SETMASK, &all, &old );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    pthread_attr_setstacksize( &attr, 64 * 1024 );
+    if (!pthread_create( &thread, &attr, user_shared_data_thread, NULL ))
+        user_shared_data_thread_running = 1;
+    else
+        fprintf( stderr, "wineserver: failed to start the shared data time thread\n" );
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old, NULL );
+}
+
 static void set_user_shared_data_time(void)
 {
-    timeout_t tick_count = monotonic_time / 10000;
     static timeout_t last_timezone_update;
     timeout_t timezone_bias;
     struct tm *tm;
@@ -400,26 +474,13 @@ static void set_user_shared_data_time(void)
         last_timezone_update = monotonic_time;
     }
 
-    atomic_store_long(&user_shared_data->SystemTime.High2Time, current_time >> 32);
-    atomic_store_ulong(&user_shared_data->SystemTime.LowPart, current_time);
-    atomic_store_long(&user_shared_data->SystemTime.High1Time, current_time >> 32);
-
-    atomic_store_long(&user_shared_data->InterruptTime.High2Time, monotonic_time >> 32);
-    atomic_store_ulong(&user_shared_data->InterruptTime.LowPart, monotonic_time);
-    atomic_store_long(&user_shared_data->InterruptTime.High1Time, monotonic_time >> 32);
-
-    atomic_store_long(&user_shared_data->TickCount.High2Time, tick_count >> 32);
-    atomic_store_ulong(&user_shared_data->TickCount.LowPart, tick_count);
-    atomic_store_long(&user_shared_data->TickCount.High1Time, tick_count >> 32);
-    atomic_store_ulong(&user_shared_data->TickCountLowDeprecated, tick_count);
+    if (!user_shared_data_thread_started) start_user_shared_data_thread();
+    if (!user_shared_data_thread_running) set_user_shared_data_clock( current_time, monotonic_time );
 }
 
 void set_current_time(void)
 {
-    static const timeout_t ticks_1601_to_1970 = (timeout_t)86400 * (369 * 365 + 89) * TICKS_PER_SEC;
-    struct timeval now;
-    gettimeofday( &now, NULL );
-    current_time = (timeout_t)now.tv_sec * TICKS_PER_SEC + now.tv_usec * 10 + ticks_1601_to_1970;
+    current_time = get_system_time();
     monotonic_time = monotonic_counter();
     if (user_shared_data) set_user_shared_data_time();
 }
@@ -519,10 +580,257 @@ static inline void fd_poll_event( struct fd *fd, int event )
 
 #ifdef USE_EPOLL
 
+#ifdef USE_IO_URING
+
+/* The io_uring backend keeps a one-shot poll request armed for every fd that
+ * is being waited on. Requests are queued in the submission ring and only
+ * handed to the kernel together with the wait for completions, so changing
+ * the events of an fd doesn't cost a syscall of its own. One-shot polls are
+ * re-armed after each event to keep the level-triggered semantics of epoll.
+ */
+
+static int uring_fd = -1;
+static unsigned int uring_gen;             /* generation counter for poll requests */
+static unsigned long long *uring_armed;    /* user data of the armed poll request for each user */
+static int uring_armed_count;              /* count of allocated entries in the uring_armed array */
+
+static struct
+{
+    unsigned int        *head;
+    unsigned int        *tail;
+    unsigned int         mask;
+    unsigned int         entries;
+    struct io_uring_sqe *sqes;
+} uring_sq;
+
+static struct
+{
+    unsigned int        *head;
+    unsigned int        *tail;
+    unsigned int         mask;
+    struct io_uring_cqe *cqes;
+} uring_cq;
+
+/* give up on io_uring when something went wrong, the poll loop will take over */
+static void uring_shutdown(void)
+{
+    close( uring_fd );
+    uring_fd = -1;
+}
+
+static int uring_enter( unsigned int min_complete, int timeout )
+{
+    unsigned int to_submit = *uring_sq.tail - __atomic_load_n( uring_sq.head, __ATOMIC_ACQUIRE );
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+
+    if (!min_complete) return syscall( __NR_io_uring_enter, uring_fd, to_submit, 0, 0, NULL, 0 );
+
+    memset( &arg, 0, sizeof(arg) );
+    if (timeout != -1)
+    {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        arg.ts = (unsigned long)&ts;
+    }
+    return syscall( __NR_io_uring_enter, uring_fd, to_submit, min_complete,
+                    IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg) );
+}
+
+/* get a free submission entry, flushing the ring to the kernel if it's full */
+static struct io_uring_sqe *uring_get_sqe(void)
+{
+    unsigned int tail = *uring_sq.tail;
+    struct io_uring_sqe *sqe;
+
+    if (tail - __atomic_load_n( uring_sq.head, __ATOMIC_ACQUIRE ) >= uring_sq.entries &&
+        uring_enter( 0, -1 ) == -1)
+    {
+        perror( "io_uring_enter" );
+        uring_shutdown();
+        return NULL;
+    }
+    sqe = &uring_sq.sqes[tail & uring_sq.mask];
+    memset( sqe, 0, sizeof(*sqe) );
+    return sqe;
+}
+
+static void uring_commit_sqe(void)
+{
+    __atomic_store_n( uring_sq.tail, *uring_sq.tail + 1, __ATOMIC_RELEASE );
+}
+
+static void uring_poll_add( int user, int events )
+{
+    struct io_uring_sqe *sqe;
+
+    if (!(sqe = uring_get_sqe())) return;
+    if (!++uring_gen) uring_gen++;  /* user data must never be zero */
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = poll_users[user]->unix_fd;
+    sqe->poll32_events = events;
+    sqe->user_data = uring_armed[user] = ((unsigned long long)uring_gen << 32) | user;
+    uring_commit_sqe();
+}
+
+static void uring_poll_remove( int user )
+{
+    struct io_uring_sqe *sqe;
+
+    if (!(sqe = uring_get_sqe())) return;
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = uring_armed[user];
+    sqe->user_data = 0;
+    uring_armed[user] = 0;
+    uring_commit_sqe();
+}
+
+static int init_uring(void)
+{
+    const char *env = getenv( "WINEIOURING" );
+    struct io_uring_params params;
+    size_t sq_size, cq_size;
+    unsigned int *array, i;
+    char *ring;
+    void *sqes;
+    int fd;
+
+    if (!env || !atoi( env )) return 0;
+
+    memset( &params, 0, sizeof(params) );
+    if ((fd = syscall( __NR_io_uring_setup, 256, &params )) == -1) return 0;
+
+    /* we need completions to never be dropped and the wait timeout argument */
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP) ||
+        !(params.features & IORING_FEAT_EXT_ARG)) goto failed;
+
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring = mmap( NULL, max( sq_size, cq_size ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQ_RING );
+    if (ring == MAP_FAILED) goto failed;
+    sqes = mmap( NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, IORING_OFF_SQES );
+    if (sqes == MAP_FAILED) goto failed;
+
+    uring_sq.head    = (unsigned int *)(ring + params.sq_off.head);
+    uring_sq.tail    = (unsigned int *)(ring + params.sq_off.tail);
+    uring_sq.mask    = *(unsigned int *)(ring + params.sq_off.ring_mask);
+    uring_sq.entries = params.sq_entries;
+    uring_sq.sqes    = sqes;
+    uring_cq.head    = (unsigned int *)(ring + params.cq_off.head);
+    uring_cq.tail    = (unsigned int *)(ring + params.cq_off.tail);
+    uring_cq.mask    = *(unsigned int *)(ring + params.cq_off.ring_mask);
+    uring_cq.cqes    = (struct io_uring_cqe *)(ring + params.cq_off.cqes);
+
+    /* submission entries are always used in ring order */
+    array = (unsigned int *)(ring + params.sq_off.array);
+    for (i = 0; i < params.sq_entries; i++) array[i] = i;
+
+    uring_fd = fd;
+    return 1;
+
+failed:
+    close( fd );
+    return 0;
+}
+
+/* set the events that io_uring waits for on this fd; helper for set_fd_events */
+static inline void set_fd_uring_events( struct fd *fd, int user, int events )
+{
+    if (user >= uring_armed_count)
+    {
+        unsigned long long *new_armed;
+
+        if (!(new_armed = realloc( uring_armed, allocated_users * sizeof(*uring_armed) )))
+        {
+            uring_shutdown();
+            return;
+        }
+        memset( new_armed + uring_armed_count, 0, (allocated_users - uring_armed_count) * sizeof(*new_armed) );
+        uring_armed = new_armed;
+        uring_armed_count = allocated_users;
+    }
+
+    if (uring_armed[user])
+    {
+        if (events != -1 && pollfd[user].events == events) return;  /* nothing to do */
+        uring_poll_remove( user );
+    }
+    if (events != -1 && uring_fd != -1) uring_poll_add( user, events );
+}
+
+static inline void remove_uring_user( struct fd *fd, int user )
+{
+    if (user < uring_armed_count && uring_armed[user]) uring_poll_remove( user );
+}
+
+static inline void main_loop_uring(void)
+{
+    int i, ret, timeout, count, users[128];
+    unsigned int head, tail;
+
+    while (active_users)
+    {
+        timeout = get_next_timeout();
+
+        if (!active_users) break;  /* last user removed by a timeout */
+        if (uring_fd == -1) break;  /* an error occurred with io_uring */
+
+        ret = uring_enter( 1, timeout );
+        set_current_time();
+        if (ret == -1 && errno != ETIME && errno != EINTR && errno != EBUSY)
+        {
+            perror( "io_uring_enter" );
+            uring_shutdown();
+            break;
+        }
+
+        /* put the events into the pollfd array first, like poll does */
+        count = 0;
+        head = *uring_cq.head;
+        tail = __atomic_load_n( uring_cq.tail, __ATOMIC_ACQUIRE );
+        while (head != tail && count < ARRAY_SIZE( users ))
+        {
+            const struct io_uring_cqe *cqe = &uring_cq.cqes[head++ & uring_cq.mask];
+            int user = (unsigned int)cqe->user_data;
+
+            /* ignore removal results and completions of requests that have been replaced */
+            if (!cqe->user_data || user >= uring_armed_count || uring_armed[user] != cqe->user_data) continue;
+            uring_armed[user] = 0;
+            pollfd[user].revents = cqe->res < 0 ? POLLERR : cqe->res;
+            users[count++] = user;
+        }
+        __atomic_store_n( uring_cq.head, head, __ATOMIC_RELEASE );
+
+        /* read events from the pollfd array, as set_fd_events may modify them */
+        for (i = 0; i < count; i++)
+        {
+            int user = users[i];
+            if (pollfd[user].revents) fd_poll_event( poll_users[user], pollfd[user].revents );
+            /* re-arm the poll request unless the fd has been removed or already re-armed */
+            if (uring_fd != -1 && pollfd[user].fd != -1 && !uring_armed[user])
+                uring_poll_add( user, pollfd[user].events );
+        }
+    }
+}
+
+#else  /* USE_IO_URING */
+
+static const int uring_fd = -1;
+
+static inline int init_uring(void) { return 0; }
+static inline void set_fd_uring_events( struct fd *fd, int user, int events ) { }
+static inline void remove_uring_user( struct fd *fd, int user ) { }
+static inline void main_loop_uring(void) { }
+
+#endif  /* USE_IO_URING */
+
 static int epoll_fd = -1;
 
 static inline void init_epoll(void)
 {
+    if (init_uring()) return;
     epoll_fd = epoll_create( 128 );
 }
 
@@ -532,6 +840,11 @@ static inline void set_fd_epoll_events( struct fd *fd, int user, int events )
     struct epoll_event ev;
     int ctl;
 
+    if (uring_fd != -1)
+    {
+        set_fd_uring_events( fd, user, events );
+        return;
+    }
     if (epoll_fd == -1) return;
 
     if (events == -1)  /* stop waiting on this fd completely */
@@ -566,6 +879,11 @@ static inline void set_fd_epoll_events( struct fd *fd, int user, int events )
 
 static inline void remove_epoll_user( struct fd *fd, int user )
 {
+    if (uring_fd != -1)
+    {
+        remove_uring_user( fd, user );
+        return;
+    }
     if (epoll_fd == -1) return;
 
     if (pollfd[user].fd != -1)
@@ -585,6 +903,7 @@ static inline void main_loop_epoll(void)
     assert( POLLERR == EPOLLERR );
     assert( POLLHUP == EPOLLHUP );
 
+    if (uring_fd != -1) main_loop_uring();
     if (epoll_fd == -1) return;
 
     while (active_users)
@@ -893,7 +1212,10 @@ static void remove_poll_user( struct fd *fd, int user )
 /* process pending timeouts and return the time until the next timeout, in milliseconds */
 static int get_next_timeout(void)
 {
-    int ret = user_shared_data ? user_shared_data_timeout : -1;
+    int ret = -1;
+
+    /* the timezone bias still gets refreshed from here */
+    if (user_shared_data) ret = user_shared_data_thread_running ? 1000 : user_shared_data_timeout;
 
     if (!list_empty( &abs_timeout_list ) || !list_empty( &rel_timeout_list ))
     {
@@ -1133,7 +1455,7 @@ static void inode_destroy( struct object *obj )
     struct list *ptr;
 
     assert( list_empty(&inode->open) );
-    assert( list_empty(&inode->locks) );
+    assert( !inode->locks );
 
     list_remove( &inode->entry );
 
@@ -1174,7 +1496,7 @@ static struct inode *get_inode( dev_t dev, ino_t ino, int unix_fd )
         inode->device = device;
         inode->ino    = ino;
         list_init( &inode->open );
-        list_init( &inode->locks );
+        inode->locks = NULL;
         list_init( &inode->closed );
         list_add_head( &device->inode_hash[hash], &inode->entry );
     }
@@ -1186,7 +1508,7 @@ static struct inode *get_inode( dev_t dev, ino_t ino, int unix_fd )
 /* add fd to the inode list of file descriptors to close */
 static void inode_add_closed_fd( struct inode *inode, struct closed_fd *fd )
 {
-    if (!list_empty( &inode->locks ))
+    if (inode->locks)
     {
         list_add_head( &inode->closed, &fd->entry );
     }
@@ -1301,112 +1623,167 @@ static int set_unix_lock( struct fd *fd, file_pos_t start, file_pos_t end, int t
     }
 }
 
-/* check if interval [start;end) overlaps the lock */
-static inline int lock_overlaps( struct file_lock *lock, file_pos_t start, file_pos_t end )
+/* end of the locked region, a zero end means the lock extends to the end of the file */
+static inline file_pos_t lock_end( const struct file_lock *lock )
 {
-    if (lock->end && start >= lock->end) return 0;
-    if (end && lock->start >= end) return 0;
-    return 1;
+    return lock->end ? lock->end : FILE_POS_T_MAX;
 }
 
-/* remove Unix locks for all bytes in the specified area that are no longer locked */
-static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
+static inline int lock_height( const struct file_lock *node )
 {
-    struct hole
-    {
-        struct hole *next;
-        struct hole *prev;
-        file_pos_t   start;
-        file_pos_t   end;
-    } *first, *cur, *next, *buffer;
+    return node ? node->height : 0;
+}
 
-    struct list *ptr;
-    int count = 0;
+static inline int compare_locks( const struct file_lock *a, const struct file_lock *b )
+{
+    if (a->start != b->start) return a->start < b->start ? -1 : 1;
+    if (a == b) return 0;
+    return (const char *)a < (const char *)b ? -1 : 1;
+}
 
-    if (!fd->inode) return;
-    if (!fd->fs_locks) return;
-    if (start == end || start > max_unix_offset) return;
-    if (!end || end > max_unix_offset) end = max_unix_offset + 1;
+static void update_lock_node( struct file_lock *node )
+{
+    node->height = 1 + max( lock_height( node->left ), lock_height( node->right ));
+    node->max_end = lock_end( node );
+    if (node->left && node->left->max_end > node->max_end) node->max_end = node->left->max_end;
+    if (node->right && node->right->max_end > node->max_end) node->max_end = node->right->max_end;
+}
 
-    /* count the number of locks overlapping the specified area */
+static struct file_lock *rotate_lock_left( struct file_lock *node )
+{
+    struct file_lock *right = node->right;
+
+    node->right = right->left;
+    right->left = node;
+    update_lock_node( node );
+    update_lock_node( right );
+    return right;
+}
+
+static struct file_lock *rotate_lock_right( struct file_lock *node )
+{
+    struct file_lock *left = node->left;
+
+    node->left = left->right;
+    left->right = node;
+    update_lock_node( node );
+    update_lock_node( left );
+    return left;
+}
 
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+/* restore the AVL balance of a subtree after one of its children changed */
+static struct file_lock *balance_lock_node( struct file_lock *node )
+{
+    int diff;
+
+    update_lock_node( node );
+    diff = lock_height( node->left ) - lock_height( node->right );
+    if (diff > 1)
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
-        if (lock->start == lock->end) continue;
-        if (lock_overlaps( lock, start, end )) count++;
+        if (lock_height( node->left->left ) < lock_height( node->left->right ))
+            node->left = rotate_lock_left( node->left );
+        return rotate_lock_right( node );
     }
-
-    if (!count)  /* no locks at all, we can unlock everything */
+    if (diff < -1)
     {
-        set_unix_lock( fd, start, end, F_UNLCK );
-        return;
+        if (lock_height( node->right->right ) < lock_height( node->right->left ))
+            node->right = rotate_lock_right( node->right );
+        return rotate_lock_left( node );
     }
+    return node;
+}
 
-    /* allocate space for the list of holes */
-    /* max. number of holes is number of locks + 1 */
+static struct file_lock *insert_lock_node( struct file_lock *node, struct file_lock *lock )
+{
+    if (!node)
+    {
+        lock->left = lock->right = NULL;
+        update_lock_node( lock );
+        return lock;
+    }
+    if (compare_locks( lock, node ) < 0) node->left = insert_lock_node( node->left, lock );
+    else node->right = insert_lock_node( node->right, lock );
+    return balance_lock_node( node );
+}
 
-    if (!(buffer = malloc( sizeof(*buffer) * (count+1) ))) return;
-    first = buffer;
-    first->next  = NULL;
-    first->prev  = NULL;
-    first->start = start;
-    first->end   = end;
-    next = first + 1;
+static struct file_lock *remove_first_lock_node( struct file_lock *node, struct file_lock **first )
+{
+    if (!node->left)
+    {
+        *first = node;
+        return node->right;
+    }
+    node->left = remove_first_lock_node( node->left, first );
+    return balance_lock_node( node );
+}
 
-    /* build a sorted list of unlocked holes in the specified area */
+static struct file_lock *remove_lock_node( struct file_lock *node, struct file_lock *lock )
+{
+    struct file_lock *next;
+    int cmp;
 
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+    assert( node );
+    if ((cmp = compare_locks( lock, node )) < 0) node->left = remove_lock_node( node->left, lock );
+    else if (cmp > 0) node->right = remove_lock_node( node->right, lock );
+    else
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
-        if (lock->start == lock->end) continue;
-        if (!lock_overlaps( lock, start, end )) continue;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+        node->right = remove_first_lock_node( node->right, &next );
+        next->left = node->left;
+        next->right = node->right;
+        node = next;
+    }
+    return balance_lock_node( node );
+}
 
-        /* go through all the holes touched by this lock */
-        for (cur = first; cur; cur = cur->next)
-        {
-            if (cur->end <= lock->start) continue; /* hole is before start of lock */
-            if (lock->end && cur->start >= lock->end) break;  /* hole is after end of lock */
+/* call func for the locks overlapping interval [start;end) in start order, until it returns non-zero */
+/* end must not be zero; returns the lock that stopped the enumeration */
+static struct file_lock *enum_overlapping_locks( struct file_lock *node, file_pos_t start, file_pos_t end,
+                                                 int (*func)( struct file_lock *lock, void *arg ), void *arg )
+{
+    struct file_lock *ret;
 
-            /* now we know that lock is overlapping hole */
+    if (!node || node->max_end <= start) return NULL;  /* everything in the subtree ends before start */
+    if ((ret = enum_overlapping_locks( node->left, start, end, func, arg ))) return ret;
+    if (node->start >= end) return NULL;  /* node and right subtree start after end */
+    if (start < lock_end( node ) && func( node, arg )) return node;
+    return enum_overlapping_locks( node->right, start, end, func, arg );
+}
 
-            if (cur->start >= lock->start)  /* lock starts before hole, shrink from start */
-            {
-                cur->start = lock->end;
-                if (cur->start && cur->start < cur->end) break;  /* done with this lock */
-                /* now hole is empty, remove it */
-                if (cur->next) cur->next->prev = cur->prev;
-                if (cur->prev) cur->prev->next = cur->next;
-                else if (!(first = cur->next)) goto done;  /* no more holes at all */
-            }
-            else if (!lock->end || cur->end <= lock->end)  /* lock larger than hole, shrink from end */
-            {
-                cur->end = lock->start;
-                assert( cur->start < cur->end );
-            }
-            else  /* lock is in the middle of hole, split hole in two */
-            {
-                next->prev = cur;
-                next->next = cur->next;
-                cur->next = next;
-                next->start = lock->end;
-                next->end = cur->end;
-                cur->end = lock->start;
-                assert( next->start < next->end );
-                assert( cur->end < next->start );
-                next++;
-                break;  /* done with this lock */
-            }
-        }
-    }
+struct unlock_holes
+{
+    struct fd  *fd;
+    file_pos_t  pos;   /* start of the area not covered yet */
+    file_pos_t  end;
+};
+
+static int unlock_hole_before_lock( struct file_lock *lock, void *arg )
+{
+    struct unlock_holes *holes = arg;
 
-    /* clear Unix locks for all the holes */
+    if (lock->start == lock->end) return 0;
+    if (lock->start > holes->pos) set_unix_lock( holes->fd, holes->pos, lock->start, F_UNLCK );
+    if (lock_end( lock ) > holes->pos) holes->pos = lock_end( lock );
+    return holes->pos >= holes->end;
+}
+
+/* remove Unix locks for all bytes in the specified area that are no longer locked */
+static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
+{
+    struct unlock_holes holes;
 
-    for (cur = first; cur; cur = cur->next)
-        set_unix_lock( fd, cur->start, cur->end, F_UNLCK );
+    if (!fd->inode) return;
+    if (!fd->fs_locks) return;
+    if (start == end || start > max_unix_offset) return;
+    if (!end || end > max_unix_offset) end = max_unix_offset + 1;
 
- done:
-    free( buffer );
+    /* the locks come in start order, so the holes between them are found in a single pass */
+    holes.fd  = fd;
+    holes.pos = start;
+    holes.end = end;
+    enum_overlapping_locks( fd->inode->locks, start, end, unlock_hole_before_lock, &holes );
+    if (holes.pos < end) set_unix_lock( fd, holes.pos, end, F_UNLCK );
 }
 
 /* create a new lock on a fd */
@@ -1428,7 +1805,7 @@ static struct file_lock *add_lock( struct fd *fd, int shared, file_pos_t start,
         return NULL;
     }
     list_add_tail( &fd->locks, &lock->fd_entry );
-    list_add_tail( &fd->inode->locks, &lock->inode_entry );
+    fd->inode->locks = insert_lock_node( fd->inode->locks, lock );
     list_add_tail( &lock->process->locks, &lock->proc_entry );
     return lock;
 }
@@ -1439,10 +1816,10 @@ static void remove_lock( struct file_lock *lock, int remove_unix )
     struct inode *inode = lock->fd->inode;
 
     list_remove( &lock->fd_entry );
-    list_remove( &lock->inode_entry );
+    inode->locks = remove_lock_node( inode->locks, lock );
     list_remove( &lock->proc_entry );
     if (remove_unix) remove_unix_locks( lock->fd, lock->start, lock->end );
-    if (list_empty( &inode->locks )) inode_close_pending( inode, 1 );
+    if (!inode->locks) inode_close_pending( inode, 1 );
     lock->process = NULL;
     wake_up( &lock->obj, 0 );
     release_object( lock );
@@ -1476,11 +1853,24 @@ static void remove_fd_locks( struct fd *fd )
     if (start < end) remove_unix_locks( fd, start, end + 1 );
 }
 
+struct lock_request
+{
+    struct fd *fd;
+    int        shared;
+};
+
+static int lock_conflicts( struct file_lock *lock, void *arg )
+{
+    const struct lock_request *req = arg;
+    return !(req->shared && (lock->shared || lock->fd == req->fd));
+}
+
 /* add a lock on an fd */
 /* returns handle to wait on */
 obj_handle_t lock_fd( struct fd *fd, file_pos_t start, file_pos_t count, int shared, int wait )
 {
-    struct list *ptr;
+    struct lock_request req = { fd, shared };
+    struct file_lock *lock;
     file_pos_t end = start + count;
 
     if (!fd->inode)  /* not a regular file */
@@ -1497,12 +1887,9 @@ obj_handle_t lock_fd( struct fd *fd, file_pos_t start, file_pos_t count, int sha
     }
 
     /* check if another lock on that file overlaps the area */
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+    if ((lock = enum_overlapping_locks( fd->inode->locks, start, end ? end : FILE_POS_T_MAX,
+                                        lock_conflicts, &req )))
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
-        if (!lock_overlaps( lock, start, end )) continue;
-        if (shared && (lock->shared || lock->fd == fd)) continue;
-        /* found one */
         if (!wait)
         {
             set_error( STATUS_FILE_LOCK_CONFLICT );
@@ -1522,21 +1909,29 @@ obj_handle_t lock_fd( struct fd *fd, file_pos_t start, file_pos_t count, int sha
     return 0;
 }
 
+/* find a lock of the fd with the exact same parameters */
+static struct file_lock *find_fd_lock( struct file_lock *node, struct fd *fd, file_pos_t start, file_pos_t end )
+{
+    struct file_lock *ret;
+
+    if (!node) return NULL;
+    if (start < node->start) return find_fd_lock( node->left, fd, start, end );
+    if (start > node->start) return find_fd_lock( node->right, fd, start, end );
+    if (node->fd == fd && node->end == end) return node;
+    if ((ret = find_fd_lock( node->left, fd, start, end ))) return ret;
+    return find_fd_lock( node->right, fd, start, end );
+}
+
 /* remove a lock on an fd */
 void unlock_fd( struct fd *fd, file_pos_t start, file_pos_t count )
 {
-    struct list *ptr;
+    struct file_lock *lock;
     file_pos_t end = start + count;
 
-    /* find an existing lock with the exact same parameters */
-    LIST_FOR_EACH( ptr, &fd->locks )
+    if (fd->inode && (lock = find_fd_lock( fd->inode->locks, fd, start, end )))
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, fd_entry );
-        if ((lock->start == start) && (lock->end == end))
-        {
-            remove_lock( lock, 1 );
-            return;
-        }
+        remove_lock( lock, 1 );
+        return;
     }
     set_error( STATUS_FILE_LOCK_CONFLICT );
 }
@@ -1578,7 +1973,7 @@ static void fd_destroy( struct object *obj )
         free( fd->unix_name );
     }
 
-    if (do_esync())
+    if (fd->esync_fd != -1)
         close( fd->esync_fd );
     if (fd->fsync_idx) fsync_free_shm_idx( fd->fsync_idx );
 }
@@ -1707,8 +2102,6 @@ static struct fd *alloc_fd_object(void)
     list_init( &fd->inode_entry );
     list_init( &fd->locks );
 
-    if (do_esync())
-        fd->esync_fd = esync_create_fd( 1, 0 );
 
     if (do_fsync())
         fd->fsync_idx = fsync_alloc_shm( 1, 0 );
@@ -1759,8 +2152,6 @@ struct fd *alloc_pseudo_fd( const struct fd_ops *fd_user_ops, struct object *use
     if (do_fsync())
         fd->fsync_idx = fsync_alloc_shm( 0, 0 );
 
-    if (do_esync())
-        fd->esync_fd = esync_create_fd( 0, 0 );
 
     return fd;
 }
@@ -2244,7 +2635,7 @@ void set_fd_signaled( struct fd *fd, int signaled )
     if (do_fsync() && !signaled)
         fsync_clear( fd->user );
 
-    if (do_esync() && !signaled)
+    if (fd->esync_fd != -1 && !signaled)
         esync_clear( fd->esync_fd );
 }
 
@@ -2280,6 +2671,20 @@ int default_fd_get_esync_fd( struct object *obj, enum esync_type *type )
     return ret;
 }
 
+/* create the esync fd of a file object the first time a client asks to wait on it;
+ * most files are never waited on, so this avoids holding an eventfd for each of them */
+int default_fd_create_esync_fd( struct object *obj )
+{
+    struct fd *fd = get_obj_fd( obj );
+    int ret;
+
+    if (fd->esync_fd == -1)
+        fd->esync_fd = esync_create_fd( fd->signaled, 0 );
+    ret = fd->esync_fd;
+    release_object( fd );
+    return ret;
+}
+
 unsigned int default_fd_get_fsync_idx( struct object *obj, enum fsync_type *type )
 {
     struct fd *fd = get_obj_fd( obj );
@@ -2835,6 +3240,11 @@ struct completion *fd_get_completion( struct fd *fd, apc_param_t *p_key )
     return fd->completion ? (struct completion *)grab_object( fd->completion ) : NULL;
 }
 
+int fd_has_completion( struct fd *fd )
+{
+    return fd->completion != NULL;
+}
+
 void fd_copy_completion( struct fd *src, struct fd *dst )
 {
     assert( !dst->completion );
@@ -2941,6 +3351,7 @@ DECL_HANDLER(get_handle_fd)
             reply->type = fd->fd_ops->get_fd_type( fd );
             reply->options = fd->options;
             reply->access = get_handle_access( current->process, req->handle );
+            reply->sharing = fd->sharing;
             send_client_fd( current->process, unix_fd, req->handle );
         }
         release_object( fd );
@@ -111,6 +111,7 @@ extern void get_nt_name( struct fd *fd, struct unicode_str *name );
 
 extern int default_fd_signaled( struct object *obj, struct wait_queue_entry *entry );
 extern int default_fd_get_esync_fd( struct object *obj, enum esync_type *type );
+extern int default_fd_create_esync_fd( struct object *obj );
 extern unsigned int default_fd_get_fsync_idx( struct object *obj, enum fsync_type *type );
 extern int default_fd_get_poll_events( struct fd *fd );
 extern void default_poll_event( struct fd *fd, int event );
@@ -203,6 +204,7 @@ extern struct object *create_shared_mapping( struct object *root, const struct u
                                              unsigned int attr, const struct security_descriptor *sd, void **ptr );
 extern struct object *create_user_data_mapping( struct object *root, const struct unicode_str *name,
                                                 unsigned int attr, const struct security_descriptor *sd );
+extern struct object *get_data_mapping( struct process *process, obj_handle_t handle, mem_size_t size );
 
 /* device functions */
 
@@ -260,7 +262,13 @@ extern void async_request_complete( struct async *async, unsigned int status, da
 extern void async_request_complete_alloc( struct async *async, unsigned int status, data_size_t result,
                                           data_size_t out_size, const void *out_data );
 extern void async_wake_up( struct async_queue *queue, unsigned int status );
+extern void async_alert_users( struct async_queue *queue, struct process *process,
+                               const client_ptr_t *users, data_size_t count );
+extern struct async *async_park_user( struct async_queue *from, struct async_queue *to,
+                                      struct process *process, client_ptr_t user );
+extern int async_wake_parked( struct async *async );
 extern struct completion *fd_get_completion( struct fd *fd, apc_param_t *p_key );
+extern int fd_has_completion( struct fd *fd );
 extern void fd_copy_completion( struct fd *src, struct fd *dst );
 extern struct iosb *async_get_iosb( struct async *async );
 extern struct thread *async_get_thread( struct async *async );
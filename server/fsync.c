@@ -80,7 +80,12 @@ static uint64_t *shm_idx_free_map;
 static uint32_t shm_idx_free_map_size; /* uint64_t word count */
 static uint32_t shm_idx_free_search_start_hint;
 
+static unsigned int shm_idx_in_use;   /* number of allocated shm indices */
+static unsigned int shm_idx_peak;     /* highest number of indices allocated at once */
+static unsigned int fsync_fallbacks;  /* waits which had to go through the server */
+
 #define BITS_IN_FREE_MAP_WORD (8 * sizeof(*shm_idx_free_map))
+#define FREE_MAP_WORDS_PER_PAGE (FSYNC_SHM_PAGE_SIZE / 16 / BITS_IN_FREE_MAP_WORD)
 
 static void shm_cleanup(void)
 {
@@ -298,6 +303,8 @@ unsigned int fsync_alloc_shm( int low, int high )
         }
     }
 
+    if (++shm_idx_in_use > shm_idx_peak) shm_idx_peak = shm_idx_in_use;
+
     shm = get_shm( shm_idx );
     assert(shm);
     shm[0] = low;
@@ -311,6 +318,30 @@ unsigned int fsync_alloc_shm( int low, int high )
 #endif
 }
 
+static int is_shm_page_free( unsigned int page )
+{
+    unsigned int i, start = page * FREE_MAP_WORDS_PER_PAGE;
+
+    if (!page || start + FREE_MAP_WORDS_PER_PAGE > shm_idx_free_map_size) return 0;
+    for (i = start; i < start + FREE_MAP_WORDS_PER_PAGE; i++)
+        if (shm_idx_free_map[i] != ~(uint64_t)0) return 0;
+    return 1;
+}
+
+/* Give the memory of an unused page back to the system. The page following the
+ * one that just became free is released, so that one free page always remains
+ * committed and objects churning around a page boundary don't fault it in again. */
+static void release_shm_page( unsigned int page )
+{
+#ifdef FALLOC_FL_PUNCH_HOLE
+    if ((off_t)(page + 1) * FSYNC_SHM_PAGE_SIZE > shm_size) return;
+    if (!is_shm_page_free( page )) return;
+    if (fallocate( shm_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                   (off_t)page * FSYNC_SHM_PAGE_SIZE, FSYNC_SHM_PAGE_SIZE ) == -1 && debug_level)
+        perror( "fsync: fallocate" );
+#endif
+}
+
 void fsync_free_shm_idx( int shm_idx )
 {
     unsigned int idx;
@@ -339,6 +370,10 @@ void fsync_free_shm_idx( int shm_idx )
     shm_idx_free_map[idx] |= mask;
     if (idx < shm_idx_free_search_start_hint)
         shm_idx_free_search_start_hint = idx;
+    shm_idx_in_use--;
+
+    if (shm_idx_free_map[idx] == ~(uint64_t)0 && is_shm_page_free( idx / FREE_MAP_WORDS_PER_PAGE ))
+        release_shm_page( idx / FREE_MAP_WORDS_PER_PAGE + 1 );
 }
 
 /* Try to cleanup the shared mem indices locked by the wait on the killed processes.
@@ -608,6 +643,7 @@ DECL_HANDLER(get_fsync_idx)
             fprintf( stderr, "%04x: fsync: can't wait on object: ", current->id );
             obj->ops->dump( obj, 0 );
         }
+        fsync_fallbacks++;
         set_error( STATUS_NOT_IMPLEMENTED );
     }
 
@@ -628,3 +664,11 @@ DECL_HANDLER(fsync_free_shm_idx)
     }
     fsync_free_shm_idx( req->shm_idx );
 }
+
+DECL_HANDLER(get_fsync_stats)
+{
+    reply->in_use    = shm_idx_in_use;
+    reply->peak      = shm_idx_peak;
+    reply->fallbacks = fsync_fallbacks;
+    reply->size      = shm_size;
+}
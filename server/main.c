@@ -55,6 +55,9 @@ static void usage( FILE *fh )
     fprintf(fh, "   -h,    --help            display this help message\n");
     fprintf(fh, "   -k[n], --kill[=n]        kill the current wineserver, optionally with signal n\n");
     fprintf(fh, "   -p[n], --persistent[=n]  make server persistent, optionally for n seconds\n");
+    fprintf(fh, "   -s,    --sync            save the registry of the current wineserver to disk\n");
+    fprintf(fh, "   -t file, --trace=file    write a binary trace of all the requests to file\n");
+    fprintf(fh, "          --dump-trace=file print a binary trace file as text, with request latencies\n");
     fprintf(fh, "   -v,    --version         display version information and exit\n");
     fprintf(fh, "   -w,    --wait            wait until the current wineserver terminates\n");
     fprintf(fh, "\n");
@@ -91,6 +94,13 @@ static void option_callback( int optc, char *optarg )
         else
             master_socket_timeout = TIMEOUT_INFINITE;
         break;
+    case 's':
+        exit( !kill_lock_owner( SIGUSR1 ));
+    case 't':
+        open_binary_trace( optarg );
+        break;
+    case 'T':
+        exit( !dump_binary_trace( optarg ));
     case 'v':
         fprintf( stderr, "%s\n", PACKAGE_STRING );
         exit(0);
@@ -111,10 +121,13 @@ static struct long_option
 } long_options[] =
 {
     {"debug",       2, 'd'},
+    {"dump-trace",  1, 'T'},
     {"foreground",  0, 'f'},
     {"help",        0, 'h'},
     {"kill",        2, 'k'},
     {"persistent",  2, 'p'},
+    {"sync",        0, 's'},
+    {"trace",       1, 't'},
     {"version",     0, 'v'},
     {"wait",        0, 'w'},
     { NULL }
@@ -219,7 +232,7 @@ int main( int argc, char *argv[] )
 {
     setvbuf( stderr, NULL, _IOLBF, 0 );
     server_argv0 = argv[0];
-    parse_options( argc, argv, "d::fhk::p::vw", long_options, option_callback );
+    parse_options( argc, argv, "d::fhk::p::st:vw", long_options, option_callback );
 
     /* setup temporary handlers before the real signal initialization is done */
     signal( SIGPIPE, SIG_IGN );
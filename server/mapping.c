@@ -130,6 +130,29 @@ static const struct object_ops shared_map_ops =
 
 static struct list shared_map_list = LIST_INIT( shared_map_list );
 
+/* relocated contents of a PE image, shared copy-on-write by all processes mapping it at the same address */
+struct image_cache
+{
+    struct list     entry;           /* entry in global image cache list */
+    dev_t           dev;             /* device of the PE file */
+    ino_t           ino;             /* inode of the PE file */
+    off_t           file_size;       /* PE file size when the cache was created */
+    time_t          mtime;           /* PE file modification time when the cache was created */
+    client_ptr_t    base;            /* address the image is relocated to */
+    mem_size_t      size;            /* size of the image */
+    struct file    *file;            /* temp file holding the relocated image */
+    int             ready;           /* whether the temp file has been filled */
+};
+
+#define MAX_IMAGE_CACHE_SIZE ((mem_size_t)512 * 1024 * 1024)
+
+static struct list image_cache_list = LIST_INIT( image_cache_list );
+static mem_size_t image_cache_size;        /* total size of cached images */
+static unsigned int image_cache_hits;      /* image views mapped from the cache */
+static unsigned int image_cache_misses;    /* relocated image views mapped privately */
+static mem_size_t image_cache_shared;      /* total size of image views mapped from the cache */
+static mem_size_t image_cache_private;     /* total size of relocated image views mapped privately */
+
 /* memory view mapped in client address space */
 struct memory_view
 {
@@ -340,11 +363,17 @@ static int create_temp_file( file_pos_t size )
     int fd = memfd_create( "wine-mapping", MFD_ALLOW_SEALING );
     if (fd != -1)
     {
-        if (!grow_file( fd, size ))
+        /* memfd files can always be extended with ftruncate, no need for the grow_file() workaround */
+        if (ftruncate( fd, size ) == -1)
         {
+            file_set_error();
             close( fd );
             fd = -1;
         }
+#ifdef F_ADD_SEALS
+        /* the contents may be mapped in several processes, never let them be truncated under them */
+        else fcntl( fd, F_ADD_SEALS, F_SEAL_SHRINK );
+#endif
     }
     else file_set_error();
 #else
@@ -1096,6 +1125,21 @@ static struct mapping *get_mapping_obj( struct process *process, obj_handle_t ha
     return (struct mapping *)get_handle_obj( process, handle, access, &mapping_ops );
 }
 
+/* get a data section holding at least size bytes, used to pass large data between processes */
+struct object *get_data_mapping( struct process *process, obj_handle_t handle, mem_size_t size )
+{
+    struct mapping *mapping;
+
+    if (!(mapping = get_mapping_obj( process, handle, SECTION_MAP_READ ))) return NULL;
+    if ((mapping->flags & SEC_IMAGE) || mapping->size < size)
+    {
+        release_object( mapping );
+        set_error( STATUS_INVALID_PARAMETER );
+        return NULL;
+    }
+    return &mapping->obj;
+}
+
 /* open a new file for the file descriptor backing the view */
 struct file *get_view_file( const struct memory_view *view, unsigned int access, unsigned int sharing )
 {
@@ -1383,6 +1427,54 @@ DECL_HANDLER(get_mapping_info)
     release_object( mapping );
 }
 
+/* extend the size of a mapping */
+DECL_HANDLER(extend_mapping)
+{
+    struct mapping *mapping;
+    mem_size_t size;
+    int unix_fd;
+
+    if (!(mapping = get_mapping_obj( current->process, req->handle, SECTION_EXTEND_SIZE ))) return;
+
+    if (mapping->flags & SEC_IMAGE)
+    {
+        set_error( STATUS_SECTION_NOT_EXTENDED );
+        goto done;
+    }
+    size = req->size;
+    if (!(mapping->flags & SEC_FILE)) size = (size + page_mask) & ~((mem_size_t)page_mask);
+    if (size > mapping->size)
+    {
+        if (size >> 54 /* ntfs limit */)
+        {
+            set_error( STATUS_SECTION_TOO_BIG );
+            goto done;
+        }
+        if ((unix_fd = get_unix_fd( mapping->fd )) == -1) goto done;
+        if (mapping->flags & SEC_FILE)
+        {
+            struct stat st;
+
+            if (fstat( unix_fd, &st ) == -1)
+            {
+                file_set_error();
+                goto done;
+            }
+            if (st.st_size < size && !grow_file( unix_fd, size )) goto done;
+        }
+        else if (ftruncate( unix_fd, size ) == -1)
+        {
+            file_set_error();
+            goto done;
+        }
+        mapping->size = size;
+    }
+    reply->size = mapping->size;
+
+done:
+    release_object( mapping );
+}
+
 /* get the address to use to map an image mapping */
 DECL_HANDLER(get_image_map_address)
 {
@@ -1401,6 +1493,127 @@ DECL_HANDLER(get_image_map_address)
     release_object( mapping );
 }
 
+static void free_image_cache( struct image_cache *cache )
+{
+    list_remove( &cache->entry );
+    image_cache_size -= cache->size;
+    release_object( cache->file );
+    free( cache );
+}
+
+/* find the image cache entry for a mapping, dropping it if the PE file changed */
+static struct image_cache *find_image_cache( struct mapping *mapping, const struct stat *st, client_ptr_t base )
+{
+    struct image_cache *cache;
+
+    LIST_FOR_EACH_ENTRY( cache, &image_cache_list, struct image_cache, entry )
+    {
+        if (cache->dev != st->st_dev || cache->ino != st->st_ino || cache->base != base) continue;
+        if (cache->file_size == st->st_size && cache->mtime == st->st_mtime && cache->size == mapping->image.map_size)
+            return cache;
+        free_image_cache( cache );
+        return NULL;
+    }
+    return NULL;
+}
+
+/* get the cached relocated contents of an image mapping */
+DECL_HANDLER(get_image_cache)
+{
+    struct image_cache *cache;
+    struct mapping *mapping;
+    struct stat st;
+    int unix_fd;
+
+    if (!(mapping = get_mapping_obj( current->process, req->mapping, SECTION_MAP_READ ))) return;
+
+    if (!(mapping->flags & SEC_IMAGE) || !mapping->fd || mapping->shared ||
+        !req->base || req->base != mapping->image.map_addr)
+    {
+        set_error( STATUS_INVALID_PARAMETER );
+        goto done;
+    }
+    if ((unix_fd = get_unix_fd( mapping->fd )) == -1) goto done;
+    if (fstat( unix_fd, &st ) == -1)
+    {
+        file_set_error();
+        goto done;
+    }
+
+    if ((cache = find_image_cache( mapping, &st, req->base )))
+    {
+        if (!cache->ready) goto miss;  /* being filled by another process */
+        if ((reply->file = alloc_handle( current->process, cache->file, FILE_READ_DATA, 0 )))
+        {
+            reply->ready = 1;
+            image_cache_hits++;
+            image_cache_shared += cache->size;
+        }
+        goto done;
+    }
+
+    if (image_cache_size + mapping->image.map_size > MAX_IMAGE_CACHE_SIZE) goto miss;
+    if (!(cache = mem_alloc( sizeof(*cache) ))) goto done;
+    if ((unix_fd = create_temp_file( mapping->image.map_size )) == -1 ||
+        !(cache->file = create_file_for_fd( unix_fd, FILE_GENERIC_READ|FILE_GENERIC_WRITE, 0 )))
+    {
+        free( cache );
+        goto done;
+    }
+    cache->dev       = st.st_dev;
+    cache->ino       = st.st_ino;
+    cache->file_size = st.st_size;
+    cache->mtime     = st.st_mtime;
+    cache->base      = req->base;
+    cache->size      = mapping->image.map_size;
+    cache->ready     = 0;
+    list_add_head( &image_cache_list, &cache->entry );
+    image_cache_size += cache->size;
+
+    /* the caller maps the image privately, and fills the cache for the next ones */
+    if (!(reply->file = alloc_handle( current->process, cache->file, FILE_READ_DATA|FILE_WRITE_DATA, 0 )))
+        free_image_cache( cache );
+
+miss:
+    image_cache_misses++;
+    image_cache_private += mapping->image.map_size;
+done:
+    release_object( mapping );
+}
+
+/* mark the cached contents of an image mapping as valid, or discard them */
+DECL_HANDLER(set_image_cache_ready)
+{
+    struct image_cache *cache;
+    struct mapping *mapping;
+    struct stat st;
+    int unix_fd;
+
+    if (!(mapping = get_mapping_obj( current->process, req->mapping, SECTION_MAP_READ ))) return;
+
+    if (!(mapping->flags & SEC_IMAGE) || !mapping->fd) set_error( STATUS_INVALID_PARAMETER );
+    else if ((unix_fd = get_unix_fd( mapping->fd )) != -1 && !fstat( unix_fd, &st ) &&
+             (cache = find_image_cache( mapping, &st, req->base )) && !cache->ready)
+    {
+        if (req->success) cache->ready = 1;
+        else free_image_cache( cache );
+    }
+    release_object( mapping );
+}
+
+/* retrieve the image cache statistics */
+DECL_HANDLER(get_image_cache_stats)
+{
+    struct image_cache *cache;
+
+    LIST_FOR_EACH_ENTRY( cache, &image_cache_list, struct image_cache, entry ) reply->count++;
+    reply->hits         = image_cache_hits;
+    reply->misses       = image_cache_misses;
+    reply->size         = image_cache_size;
+    reply->shared_size  = image_cache_shared;
+    reply->private_size = image_cache_private;
+}
+
 /* add a memory view in the current process */
 DECL_HANDLER(map_view)
 {
@@ -544,7 +544,7 @@ static void named_pipe_device_destroy( struct object *obj )
 {
     struct named_pipe_device *device = (struct named_pipe_device*)obj;
     assert( obj->ops == &named_pipe_device_ops );
-    free( device->pipes );
+    free_namespace( device->pipes );
 }
 
 struct object *create_named_pipe_device( struct object *root, const struct unicode_str *name,
@@ -1001,6 +1001,32 @@ static void pipe_end_read( struct fd *fd, struct async *async, file_pos_t pos )
     set_error( STATUS_PENDING );
 }
 
+#define PIPE_COALESCE_SIZE 65536  /* largest buffered chunk that small writes are appended to */
+
+/* in byte mode, append a write that fits in the buffer to the already completed write at the
+ * tail of the queue, so that streams of small writes don't build up long message queues */
+static int coalesce_write( struct pipe_end *reader, struct async *async )
+{
+    data_size_t size = get_req_data_size();
+    struct pipe_message *message;
+    struct list *tail;
+    void *data;
+
+    if (reader->pipe->message_mode) return 0;
+    if (!(tail = list_tail( &reader->message_queue ))) return 0;
+    message = LIST_ENTRY( tail, struct pipe_message, entry );
+    if (message->async || message->iosb->in_size + size > PIPE_COALESCE_SIZE) return 0;
+    if (pipe_end_get_avail( reader ) + size > reader->buffer_size) return 0;
+    if (!(data = realloc( message->iosb->in_data, message->iosb->in_size + size ))) return 0;
+
+    memcpy( (char *)data + message->iosb->in_size, get_req_data(), size );
+    message->iosb->in_data = data;
+    message->iosb->in_size += size;
+    async_request_complete( async, STATUS_SUCCESS, size, 0, NULL );
+    reselect_read_queue( reader, 0 );
+    return 1;
+}
+
 static void pipe_end_write( struct fd *fd, struct async *async, file_pos_t pos )
 {
     struct pipe_end *pipe_end = get_fd_user( fd );
@@ -1024,6 +1050,12 @@ static void pipe_end_write( struct fd *fd, struct async *async, file_pos_t pos )
 
     if (!pipe_end->pipe->message_mode && !get_req_data_size()) return;
 
+    if (coalesce_write( pipe_end->connection, async ))
+    {
+        set_error( STATUS_PENDING );
+        return;
+    }
+
     iosb = async_get_iosb( async );
     message = queue_message( pipe_end->connection, iosb );
     release_object( iosb );
@@ -46,7 +46,14 @@
 struct namespace
 {
     unsigned int        hash_size;       /* size of hash table */
-    struct list         names[1];        /* array of hash entry lists */
+    unsigned int        count;           /* number of names in the hash table */
+    struct list        *names;           /* array of hash entry lists */
+};
+
+/* hash table sizes used when a namespace grows, primes spread the name hash best */
+static const unsigned int namespace_sizes[] =
+{
+    7, 37, 131, 509, 2039, 8191, 32749, 131071, 524287, 2097143
 };
 
 
@@ -134,11 +141,71 @@ void *memdup( const void *data, size_t len )
 
 /*****************************************************************/
 
+/* grow the hash table once its chains get too long on average */
+static void grow_namespace( struct namespace *namespace )
+{
+    struct object_name *ptr, *next;
+    struct list *names;
+    unsigned int i, hash_size = 0;
+
+    for (i = 0; i < ARRAY_SIZE(namespace_sizes); i++)
+    {
+        if (namespace_sizes[i] <= namespace->hash_size) continue;
+        hash_size = namespace_sizes[i];
+        break;
+    }
+    if (!hash_size || !(names = malloc( hash_size * sizeof(*names) ))) return;
+    for (i = 0; i < hash_size; i++) list_init( &names[i] );
+
+    for (i = 0; i < namespace->hash_size; i++)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE( ptr, next, &namespace->names[i], struct object_name, entry )
+        {
+            list_remove( &ptr->entry );
+            list_add_tail( &names[hash_strW( ptr->name, ptr->len, hash_size )], &ptr->entry );
+        }
+    }
+    free( namespace->names );
+    namespace->names = names;
+    namespace->hash_size = hash_size;
+}
+
 void namespace_add( struct namespace *namespace, struct object_name *ptr )
 {
-    unsigned int hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
+    unsigned int hash;
 
+    if (namespace->count >= 4 * namespace->hash_size) grow_namespace( namespace );
+    hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
     list_add_head( &namespace->names[hash], &ptr->entry );
+    ptr->namespace = namespace;
+    namespace->count++;
+}
+
+/* retrieve the size and longest chain of a namespace hash table */
+void get_namespace_stats( const struct namespace *namespace, unsigned int *count,
+                          unsigned int *hash_size, unsigned int *max_chain )
+{
+    unsigned int i, len;
+
+    *count = namespace->count;
+    *hash_size = namespace->hash_size;
+    *max_chain = 0;
+    for (i = 0; i < namespace->hash_size; i++)
+    {
+        if ((len = list_count( &namespace->names[i] )) > *max_chain) *max_chain = len;
+    }
+}
+
+/* call a function for every object of a namespace */
+void enum_namespace( const struct namespace *namespace,
+                     void (*func)( struct object *obj, void *arg ), void *arg )
+{
+    const struct object_name *ptr;
+    unsigned int i;
+
+    for (i = 0; i < namespace->hash_size; i++)
+        LIST_FOR_EACH_ENTRY( ptr, &namespace->names[i], const struct object_name, entry )
+            func( ptr->obj, arg );
 }
 
 /* allocate a name for an object */
@@ -150,6 +217,7 @@ static struct object_name *alloc_name( const struct unicode_str *name )
     {
         ptr->len = name->len;
         ptr->parent = NULL;
+        ptr->namespace = NULL;
         memcpy( ptr->name, name->str, name->len );
     }
     return ptr;
@@ -505,15 +573,26 @@ struct namespace *create_namespace( unsigned int hash_size )
     struct namespace *namespace;
     unsigned int i;
 
-    namespace = mem_alloc( sizeof(*namespace) + (hash_size - 1) * sizeof(namespace->names[0]) );
-    if (namespace)
+    if (!(namespace = mem_alloc( sizeof(*namespace) ))) return NULL;
+    if (!(namespace->names = mem_alloc( hash_size * sizeof(namespace->names[0]) )))
     {
-        namespace->hash_size      = hash_size;
-        for (i = 0; i < hash_size; i++) list_init( &namespace->names[i] );
+        free( namespace );
+        return NULL;
     }
+    namespace->hash_size      = hash_size;
+    namespace->count          = 0;
+    for (i = 0; i < hash_size; i++) list_init( &namespace->names[i] );
     return namespace;
 }
 
+/* free a namespace, its objects must have been unlinked already */
+void free_namespace( struct namespace *namespace )
+{
+    if (!namespace) return;
+    free( namespace->names );
+    free( namespace );
+}
+
 /* functions for unimplemented/default object operations */
 
 int no_add_queue( struct object *obj, struct wait_queue_entry *entry )
@@ -716,6 +795,7 @@ int no_link_name( struct object *obj, struct object_name *name, struct object *p
 void default_unlink_name( struct object *obj, struct object_name *name )
 {
     list_remove( &name->entry );
+    if (name->namespace) name->namespace->count--;
 }
 
 struct object *no_open_file( struct object *obj, unsigned int access, unsigned int sharing,
@@ -107,7 +107,6 @@ struct thread_input
     int                    caret_hide;    /* caret hide count */
     int                    caret_state;   /* caret on/off state */
     struct list            msg_list;      /* list of hardware messages */
-    unsigned char          desktop_keystate[256]; /* desktop keystate when keystate was synced */
     struct object         *shared_mapping; /* thread input shared memory mapping */
     const input_shm_t     *shared;        /* thread input shared memory ptr */
 };
@@ -293,11 +292,10 @@ static struct thread_input *create_thread_input( struct thread *thread )
             release_object( input );
             return NULL;
         }
-        memcpy( input->desktop_keystate, (void *)input->desktop->shared->keystate,
-                sizeof(input->desktop_keystate) );
-
         SHARED_WRITE_BEGIN( input, input_shm_t )
         {
+            memcpy( (void *)shared->desktop_keystate, (void *)input->desktop->shared->keystate,
+                    sizeof(shared->desktop_keystate) );
             shared->focus = 0;
             shared->active = 0;
             shared->capture = 0;
@@ -395,8 +393,8 @@ static void sync_input_keystate( struct thread_input *input )
     {
         for (i = 0; i < sizeof(shared->keystate); ++i)
         {
-            if (input->desktop_keystate[i] == input->desktop->shared->keystate[i]) continue;
-            shared->keystate[i] = input->desktop_keystate[i] = input->desktop->shared->keystate[i];
+            if (shared->desktop_keystate[i] == input->desktop->shared->keystate[i]) continue;
+            shared->keystate[i] = shared->desktop_keystate[i] = input->desktop->shared->keystate[i];
         }
         shared->sync_serial = input->desktop->shared->update_serial;
     }
@@ -3658,11 +3656,11 @@ DECL_HANDLER(set_key_state)
     SHARED_WRITE_BEGIN( queue->input, input_shm_t )
     {
         memcpy( (void *)shared->keystate, get_req_data(), size );
+        memcpy( (void *)shared->desktop_keystate, (void *)queue->input->desktop->shared->keystate,
+                sizeof(shared->desktop_keystate) );
     }
     SHARED_WRITE_END
 
-    memcpy( queue->input->desktop_keystate, (void *)queue->input->desktop->shared->keystate,
-            sizeof(queue->input->desktop_keystate) );
     if (req->async && (desktop = get_thread_desktop( current, 0 )))
     {
         SHARED_WRITE_BEGIN( desktop, desktop_shm_t )
@@ -3939,7 +3937,7 @@ DECL_HANDLER(get_rawinput_buffer)
     data_size_t size = 0, next_size = 0, pos = 0;
     struct list *ptr;
     char *buf, *tmp;
-    int count = 0, buf_size = 16 * sizeof(struct hardware_msg_data);
+    int count = 0, pending = 0, buf_size = 16 * sizeof(struct hardware_msg_data);
 
     if (!req->buffer_size) buf = NULL;
     else if (!(buf = mem_alloc( buf_size ))) return;
@@ -3952,7 +3950,11 @@ DECL_HANDLER(get_rawinput_buffer)
         data_size_t extra_size = data->size - sizeof(*data);
 
         ptr = list_next( &input->msg_list, ptr );
-        if (msg->msg != WM_INPUT) continue;
+        if (msg->msg != WM_INPUT)
+        {
+            if (get_hardware_msg_bit( msg->msg ) == QS_RAWINPUT) pending = 1;
+            continue;
+        }
 
         next_size = req->rawinput_size + extra_size;
         if (size + next_size > req->buffer_size) break;
@@ -3979,7 +3981,8 @@ DECL_HANDLER(get_rawinput_buffer)
         count++;
     }
 
-    if (req->clear_qs_rawinput && !ptr) clear_queue_bits( current->queue, QS_RAWINPUT );
+    /* clear the bit once drained, clients check it before asking for more */
+    if ((req->clear_qs_rawinput || !pending) && !ptr) clear_queue_bits( current->queue, QS_RAWINPUT );
 
     reply->next_size = next_size;
     reply->count = count;
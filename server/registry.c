@@ -33,6 +33,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -161,6 +162,20 @@ struct file_load_info
     size_t      tmplen;   /* length of temp buffer */
 };
 
+/* header of the binary cache saved next to a registry file */
+struct registry_cache_header
+{
+    char                magic[8];       /* REGISTRY_CACHE_MAGIC */
+    int                 prefix_type;    /* prefix type of the saved branch */
+    data_size_t         data_size;      /* size of the serialized keys following the header */
+    unsigned long long  text_size;      /* size of the text file the cache matches */
+    unsigned long long  text_ino;       /* inode of the text file */
+    long long           text_mtime;     /* modification time of the text file */
+    long long           text_mtime_ns;  /* nanoseconds part of the modification time */
+};
+
+#define REGISTRY_CACHE_MAGIC "WINEREG1"
+
 
 static void key_dump( struct object *obj, int verbose );
 static unsigned int key_map_access( struct object *obj, unsigned int access );
@@ -585,7 +600,7 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
     struct key *key = (struct key *)obj;
     struct key *parent_key = (struct key *)parent;
     struct unicode_str tmp;
-    int i, index;
+    int index;
 
     if (parent->ops != &key_ops)
     {
@@ -604,8 +619,8 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
     tmp.len = name->len;
     find_subkey( parent_key, &tmp, &index );
 
-    for (i = ++parent_key->last_subkey; i > index; i--)
-        parent_key->subkeys[i] = parent_key->subkeys[i - 1];
+    memmove( parent_key->subkeys + index + 1, parent_key->subkeys + index,
+             (++parent_key->last_subkey - index) * sizeof(*parent_key->subkeys) );
     parent_key->subkeys[index] = (struct key *)grab_object( key );
     if (!(parent_key->flags & KEY_WOWSHARE) && is_wow6432node( name->name, name->len ) &&
         !is_wow6432node( parent_key->obj.name->name, parent_key->obj.name->len ))
@@ -618,7 +633,8 @@ static void key_unlink_name( struct object *obj, struct object_name *name )
 {
     struct key *key = (struct key *)obj;
     struct key *parent = (struct key *)name->parent;
-    int i, nb_subkeys;
+    struct unicode_str tmp;
+    int index, nb_subkeys;
 
     if (!parent) return;
 
@@ -628,10 +644,12 @@ static void key_unlink_name( struct object *obj, struct object_name *name )
         return;
     }
 
-    for (i = 0; i <= parent->last_subkey; i++) if (parent->subkeys[i] == key) break;
-    assert( i <= parent->last_subkey );
-    for ( ; i < parent->last_subkey; i++) parent->subkeys[i] = parent->subkeys[i + 1];
-    parent->last_subkey--;
+    tmp.str = name->name;
+    tmp.len = name->len;
+    find_subkey( parent, &tmp, &index );
+    assert( index <= parent->last_subkey && parent->subkeys[index] == key );
+    memmove( parent->subkeys + index, parent->subkeys + index + 1,
+             (parent->last_subkey-- - index) * sizeof(*parent->subkeys) );
     name->parent = NULL;
     if (parent->wow6432node == key) parent->wow6432node = NULL;
     release_object( key );
@@ -686,6 +704,20 @@ static void key_destroy( struct object *obj )
     }
 }
 
+/* mark a key and all its parents as dirty (modified) */
+static void make_dirty( struct key *key )
+{
+    ++change_timestamp_counter;
+    while (key)
+    {
+        if (key->flags & KEY_VOLATILE) return;  /* nothing to do */
+        /* parents must stay dirty as long as one of their subkeys is */
+        key->flags |= KEY_DIRTY;
+        key->timestamp_counter = change_timestamp_counter;
+        key = get_parent( key );
+    }
+}
+
 /* allocate a key object */
 static struct key *create_key_object( struct object *parent, const struct unicode_str *name,
                                       unsigned int attributes, unsigned int options, timeout_t modif,
@@ -723,25 +755,12 @@ static struct key *create_key_object( struct object *parent, const struct unicod
                 release_object( key );
                 return NULL;
             }
-            else key->flags |= KEY_DIRTY;
+            else make_dirty( key );
         }
     }
     return key;
 }
 
-/* mark a key and all its parents as dirty (modified) */
-static void make_dirty( struct key *key )
-{
-    ++change_timestamp_counter;
-    while (key)
-    {
-        if (key->flags & (KEY_DIRTY|KEY_VOLATILE)) return;  /* nothing to do */
-        key->flags |= KEY_DIRTY;
-        key->timestamp_counter = change_timestamp_counter;
-        key = get_parent( key );
-    }
-}
-
 /* mark a key and all its subkeys as clean (not modified) */
 static void make_clean( struct key *key, abstime_t timestamp_counter )
 {
@@ -1008,8 +1027,9 @@ static void rename_key( struct key *key, const struct unicode_str *new_name )
 {
     struct object_name *new_name_ptr;
     struct key *subkey, *parent = get_parent( key );
+    struct unicode_str old_name;
     data_size_t len;
-    int i, index, cur_index;
+    int index, cur_index;
 
     /* changing to a path is not allowed */
     len = get_path_element( new_name->str, new_name->len );
@@ -1038,19 +1058,24 @@ static void rename_key( struct key *key, const struct unicode_str *new_name )
     new_name_ptr->obj = &key->obj;
     new_name_ptr->len = new_name->len;
     new_name_ptr->parent = &parent->obj;
+    new_name_ptr->namespace = NULL;
     memcpy( new_name_ptr->name, new_name->str, new_name->len );
 
-    for (cur_index = 0; cur_index <= parent->last_subkey; cur_index++)
-        if (parent->subkeys[cur_index] == key) break;
+    old_name.str = key->obj.name->name;
+    old_name.len = key->obj.name->len;
+    find_subkey( parent, &old_name, &cur_index );
+    assert( parent->subkeys[cur_index] == key );
 
     if (cur_index < index && (index - cur_index) > 1)
     {
         --index;
-        for (i = cur_index; i < index; ++i) parent->subkeys[i] = parent->subkeys[i+1];
+        memmove( parent->subkeys + cur_index, parent->subkeys + cur_index + 1,
+                 (index - cur_index) * sizeof(*parent->subkeys) );
     }
     else if (cur_index > index)
     {
-        for (i = cur_index; i > index; --i) parent->subkeys[i] = parent->subkeys[i-1];
+        memmove( parent->subkeys + index + 1, parent->subkeys + index,
+                 (cur_index - index) * sizeof(*parent->subkeys) );
     }
     parent->subkeys[index] = key;
 
@@ -1153,7 +1178,6 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
 {
     struct key_value *value;
     WCHAR *new_name = NULL;
-    int i;
 
     if (name->len > MAX_VALUE_LEN * sizeof(WCHAR))
     {
@@ -1165,7 +1189,8 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
         if (!grow_values( key )) return NULL;
     }
     if (name->len && !(new_name = memdup( name->str, name->len ))) return NULL;
-    for (i = ++key->last_value; i > index; i--) key->values[i] = key->values[i - 1];
+    memmove( key->values + index + 1, key->values + index,
+             (++key->last_value - index) * sizeof(*key->values) );
     value = &key->values[index];
     value->name    = new_name;
     value->namelen = name->len;
@@ -1315,7 +1340,7 @@ static void enum_value( struct key *key, int i, int info_class, struct enum_key_
 static void delete_value( struct key *key, const struct unicode_str *name )
 {
     struct key_value *value;
-    int i, index, nb_values;
+    int index, nb_values;
 
     if (key->flags & KEY_PREDEF)
     {
@@ -1331,8 +1356,8 @@ static void delete_value( struct key *key, const struct unicode_str *name )
     if (debug_level > 1) dump_operation( key, value, "Delete" );
     free( value->name );
     free( value->data );
-    for (i = index; i < key->last_value; i++) key->values[i] = key->values[i + 1];
-    key->last_value--;
+    memmove( key->values + index, key->values + index + 1,
+             (key->last_value-- - index) * sizeof(*key->values) );
     touch_key( key, REG_NOTIFY_CHANGE_LAST_SET );
 
     /* try to shrink the array */
@@ -1811,20 +1836,213 @@ static void load_registry( struct key *key, obj_handle_t handle )
     }
 }
 
+/* check whether the registry cache is enabled */
+static int use_registry_cache(void)
+{
+    static int cached = -1;
+    const char *env;
+
+    if (cached == -1) cached = (env = getenv( "WINEREGCACHE" )) && atoi( env );
+    return cached;
+}
+
+/* fill the registry cache header fields that identify the text file */
+static void get_registry_cache_stat( const struct stat *st, struct registry_cache_header *header )
+{
+    header->text_size  = st->st_size;
+    header->text_ino   = st->st_ino;
+    header->text_mtime = st->st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    header->text_mtime_ns = st->st_mtim.tv_nsec;
+#else
+    header->text_mtime_ns = 0;
+#endif
+}
+
+/* get a chunk of serialized registry data, checking the bounds */
+static const void *get_serialized_data( const char **ptr, const char *end, data_size_t size )
+{
+    const char *ret = *ptr;
+
+    if (end - ret < size) return NULL;
+    *ptr += size;
+    return ret;
+}
+
+/* load a serialized key with its values and subkeys; counterpart of serialize_key */
+/* the key is created as a subkey of parent, unless it's already specified */
+static int load_serialized_key( struct key *parent, struct key *key, const char **ptr, const char *end )
+{
+    const data_size_t *len;
+    const int *counts;
+    const unsigned int *flags, *type;
+    const timeout_t *modif;
+    const WCHAR *class;
+    struct unicode_str name;
+    struct key_value *value;
+    const void *data;
+    int i, index, ret = 0;
+
+    if (!(len = get_serialized_data( ptr, end, sizeof(*len) ))) return 0;
+    name.len = *len;
+    if (!(name.str = get_serialized_data( ptr, end, name.len ))) return 0;
+    if (!(len = get_serialized_data( ptr, end, sizeof(*len) ))) return 0;
+    if (!(class = get_serialized_data( ptr, end, *len ))) return 0;
+    if (!(counts = get_serialized_data( ptr, end, 2 * sizeof(*counts) ))) return 0;
+    if (!(flags = get_serialized_data( ptr, end, sizeof(*flags) ))) return 0;
+    if (!(modif = get_serialized_data( ptr, end, sizeof(*modif) ))) return 0;
+
+    if (key) grab_object( key );
+    else if (!(key = create_key_object( &parent->obj, &name, OBJ_OPENIF, 0, *modif, NULL ))) return 0;
+
+    key->modif = *modif;
+    key->flags |= *flags & KEY_SYMLINK;
+    if (*len)
+    {
+        free( key->class );
+        if (!(key->class = memdup( class, *len ))) goto done;
+        key->classlen = *len;
+    }
+
+    /* values are saved in sorted order, so they get appended without moving the array */
+    for (i = 0; i < counts[0]; i++)
+    {
+        if (!(len = get_serialized_data( ptr, end, sizeof(*len) ))) goto done;
+        name.len = *len;
+        if (!(name.str = get_serialized_data( ptr, end, name.len ))) goto done;
+        if (!(type = get_serialized_data( ptr, end, sizeof(*type) ))) goto done;
+        if (!(len = get_serialized_data( ptr, end, sizeof(*len) ))) goto done;
+        if (!(data = get_serialized_data( ptr, end, *len ))) goto done;
+
+        if (!(value = find_value( key, &name, &index )) &&
+            !(value = insert_value( key, &name, index ))) goto done;
+        free( value->data );
+        value->data = NULL;
+        value->len  = 0;
+        value->type = *type;
+        if (*len && !(value->data = memdup( data, *len ))) goto done;
+        value->len = *len;
+    }
+
+    for (i = 0; i < counts[1]; i++)
+        if (!load_serialized_key( key, NULL, ptr, end )) goto done;
+    ret = 1;
+
+done:
+    release_object( key );
+    return ret;
+}
+
+/* open the binary cache of a registry file and check that it is up to date with the text file */
+static int open_registry_cache( const char *filename, struct registry_cache_header *header )
+{
+    struct registry_cache_header expect;
+    struct stat st;
+    char *cache_name;
+    int fd;
+
+    if (!use_registry_cache() || stat( filename, &st ) == -1) return -1;
+    if (!(cache_name = malloc( strlen( filename ) + sizeof(".bin") ))) return -1;
+    sprintf( cache_name, "%s.bin", filename );
+    fd = open( cache_name, O_RDONLY );
+    free( cache_name );
+    if (fd == -1) return -1;
+
+    get_registry_cache_stat( &st, &expect );
+    if (read( fd, header, sizeof(*header) ) != sizeof(*header) ||
+        memcmp( header->magic, REGISTRY_CACHE_MAGIC, sizeof(header->magic) ) ||
+        header->text_size != expect.text_size || header->text_ino != expect.text_ino ||
+        header->text_mtime != expect.text_mtime || header->text_mtime_ns != expect.text_mtime_ns ||
+        (prefix_type != PREFIX_UNKNOWN && header->prefix_type != prefix_type) ||
+        fstat( fd, &st ) == -1 || st.st_size != sizeof(*header) + (off_t)header->data_size)
+    {
+        close( fd );
+        return -1;
+    }
+    return fd;
+}
+
+/* check if the binary cache of a registry file is up to date */
+static int is_registry_cache_valid( const char *filename )
+{
+    struct registry_cache_header header;
+    int fd = open_registry_cache( filename, &header );
+
+    if (fd == -1) return 0;
+    close( fd );
+    return 1;
+}
+
+/* load a registry branch from its binary cache, if it is up to date with the text file */
+static int load_registry_cache( const char *filename, struct key *key )
+{
+    struct registry_cache_header header;
+    size_t size;
+    const char *ptr;
+    char *data;
+    int fd, ret = 0;
+
+    if ((fd = open_registry_cache( filename, &header )) == -1) return 0;
+    size = sizeof(header) + header.data_size;
+    data = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if (data == MAP_FAILED) return 0;
+
+    ptr = data + sizeof(header);
+    if (load_serialized_key( NULL, key, &ptr, ptr + header.data_size ))
+    {
+        if (prefix_type == PREFIX_UNKNOWN) prefix_type = header.prefix_type;
+        ret = 1;
+    }
+    else fprintf( stderr, "%s.bin: corrupted registry cache, loading the text file\n", filename );
+
+    munmap( data, size );
+    return ret;
+}
+
+/* open the copy of a registry file in the template prefix, if one is configured */
+static FILE *open_registry_template( const char *filename, char **path )
+{
+    const char *dir = getenv( "WINE_REGISTRY_TEMPLATE" );
+    FILE *f;
+
+    if (!dir || dir[0] != '/') return NULL;
+    if (!(*path = malloc( strlen( dir ) + strlen( filename ) + 2 ))) return NULL;
+    sprintf( *path, "%s/%s", dir, filename );
+    if (!(f = fopen( *path, "r" )))
+    {
+        free( *path );
+        *path = NULL;
+    }
+    return f;
+}
+
 /* load one of the initial registry files */
 static int load_init_registry_from_file( const char *filename, struct key *key )
 {
+    char *template = NULL;
+    const char *path = filename;
     FILE *f;
 
-    if ((f = fopen( filename, "r" )))
+    /* a prefix without its own copy of the file shares the template one; since the branch
+     * is left clean, it only gets written to the prefix once something modifies it */
+    if (!(f = fopen( filename, "r" )) && errno == ENOENT &&
+        (f = open_registry_template( filename, &template )))
+        path = template;
+
+    if (f)
     {
-        load_keys( key, filename, f, 0 );
+        if (!load_registry_cache( path, key )) load_keys( key, path, f, 0 );
         fclose( f );
         if (get_error() == STATUS_NOT_REGISTRY_FILE)
         {
-            fprintf( stderr, "%s is not a valid registry file\n", filename );
+            fprintf( stderr, "%s is not a valid registry file\n", path );
+            free( template );
             return 1;
         }
+        /* the branch matches the file, don't write it back until it gets modified */
+        make_clean( key, change_timestamp_counter );
+        free( template );
     }
 
     assert( save_branch_count < MAX_SAVE_BRANCH_INFO );
@@ -2130,6 +2348,40 @@ static data_size_t save_registry( const struct key *key, char *buf )
     return size;
 }
 
+/* save the binary cache of a registry branch next to its text file */
+static void save_registry_cache( struct key *key, const char *path )
+{
+    struct registry_cache_header header;
+    struct stat st;
+    char *name, *tmp, *data = NULL;
+    int fd, ret = 0;
+
+    if (!use_registry_cache() || stat( path, &st ) == -1) return;
+    if (!(name = malloc( 2 * strlen( path ) + sizeof(".bin") + sizeof(".bin.tmp") ))) return;
+    tmp = name + sprintf( name, "%s.bin", path ) + 1;
+    sprintf( tmp, "%s.bin.tmp", path );
+
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, REGISTRY_CACHE_MAGIC, sizeof(header.magic) );
+    header.prefix_type = prefix_type;
+    header.data_size = serialize_key( key, NULL );
+    get_registry_cache_stat( &st, &header );
+
+    if (!(data = malloc( header.data_size ))) goto done;
+    serialize_key( key, data );
+
+    if ((fd = open( tmp, O_CREAT | O_TRUNC | O_WRONLY, 0666 )) == -1) goto done;
+    ret = (write( fd, &header, sizeof(header) ) == sizeof(header) &&
+           write( fd, data, header.data_size ) == header.data_size);
+    if (close( fd )) ret = 0;
+    if (ret) ret = !rename( tmp, name );
+    if (!ret) unlink( tmp );
+
+done:
+    free( data );
+    free( name );
+}
+
 /* save a registry branch to a file */
 static int save_branch( struct key *key, const char *path )
 {
@@ -2141,6 +2393,8 @@ static int save_branch( struct key *key, const char *path )
     if (!(key->flags & KEY_DIRTY))
     {
         if (debug_level > 1) dump_operation( key, NULL, "Not saving clean" );
+        /* the text file may have been written by the client, refresh the cache if needed */
+        if (!is_registry_cache_valid( path )) save_registry_cache( key, path );
         return 1;
     }
 
@@ -2197,6 +2451,7 @@ static int save_branch( struct key *key, const char *path )
         if (ret) ret = !rename( tmp, path );
         if (!ret) unlink( tmp );
     }
+    if (ret) save_registry_cache( key, path );
 
 done:
     free( tmp );
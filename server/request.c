@@ -62,6 +62,7 @@
 #include "handle.h"
 #define WANT_REQUEST_HANDLERS
 #include "request.h"
+#include "wine/sdt.h"
 
 /* Some versions of glibc don't define this */
 #ifndef SCM_RIGHTS
@@ -290,11 +291,25 @@ static void send_reply( union generic_reply *reply )
         fatal_protocol_error( current, "reply write: %s\n", strerror( errno ));
 }
 
+/* per-request statistics */
+struct request_stat
+{
+    unsigned int count;       /* number of times the request was handled */
+    timeout_t    total_time;  /* total time spent in the handler */
+    timeout_t    max_time;    /* longest time spent in the handler */
+    mem_size_t   bytes_in;    /* total size of the received requests */
+    mem_size_t   bytes_out;   /* total size of the sent replies */
+};
+
+static struct request_stat request_stats[REQ_NB_REQUESTS];
+
 /* call a request handler */
 static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    struct request_stat *stat = NULL;
+    timeout_t start = 0, time;
 
     current = thread;
     current->reply_size = 0;
@@ -302,19 +317,34 @@ static void call_req_handler( struct thread *thread )
     memset( &reply, 0, sizeof(reply) );
 
     if (debug_level) trace_request();
+    if (binary_trace_fd != -1) binary_trace_request();
+    WINE_PROBE2( wineserver, request_start, req, thread->id );
 
     if (req < REQ_NB_REQUESTS)
+    {
+        stat = &request_stats[req];
+        stat->bytes_in += sizeof(current->req) + current->req.request_header.request_size;
+        start = monotonic_counter();
         req_handlers[req]( &current->req, &reply );
+        time = monotonic_counter() - start;
+        stat->count++;
+        stat->total_time += time;
+        if (time > stat->max_time) stat->max_time = time;
+    }
     else
         set_error( STATUS_NOT_IMPLEMENTED );
 
+    WINE_PROBE3( wineserver, request_end, req, thread->id, thread->error );
+
     if (current)
     {
         if (current->reply_fd)
         {
             reply.reply_header.error = current->error;
             reply.reply_header.reply_size = current->reply_size;
+            if (stat) stat->bytes_out += sizeof(reply) + current->reply_size;
             if (debug_level) trace_reply( req, &reply );
+            if (binary_trace_fd != -1) binary_trace_reply( req, &reply );
             send_reply( &reply );
         }
         else
@@ -326,6 +356,142 @@ static void call_req_handler( struct thread *thread )
     current = NULL;
 }
 
+/* release the variable-size data of the current request */
+static inline void free_req_data( struct thread *thread )
+{
+    if (thread->req_data != thread->req_buffer) free( thread->req_data );
+    thread->req_data = NULL;
+}
+
+/* requests allowed in a batch; they must never block, and never kill or change the current thread */
+static const unsigned char batch_allowed[REQ_NB_REQUESTS] =
+{
+    [REQ_close_handle]           = 1,
+    [REQ_dup_handle]             = 1,
+    [REQ_get_object_info]        = 1,
+    [REQ_get_object_name]        = 1,
+    [REQ_open_event]             = 1,
+    [REQ_open_mutex]             = 1,
+    [REQ_open_semaphore]         = 1,
+    [REQ_open_mapping]           = 1,
+    [REQ_open_key]               = 1,
+    [REQ_get_key_value]          = 1,
+    [REQ_enum_key]               = 1,
+    [REQ_enum_key_value]         = 1,
+    [REQ_get_window_info]        = 1,
+    [REQ_get_window_property]    = 1,
+    [REQ_get_window_properties]  = 1,
+};
+
+/* execute a batch of independent requests in order */
+DECL_HANDLER(batch_requests)
+{
+    union generic_request batch = current->req;
+    void *batch_data = current->req_data;
+    const char *data = get_req_data();
+    data_size_t data_size = get_req_data_size(), max_size = get_reply_max_size();
+    data_size_t pos = 0, total = 0, size, reply_max;
+    unsigned int status = STATUS_SUCCESS, count = 0;
+    union generic_reply sub_reply;
+    enum request code;
+    char *replies;
+
+    if (!(replies = mem_alloc( max_size ? max_size : 1 ))) return;
+
+    while (pos < data_size)
+    {
+        if (data_size - pos < sizeof(current->req))
+        {
+            status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+        memcpy( &current->req, data + pos, sizeof(current->req) );
+        pos += sizeof(current->req);
+
+        code = current->req.request_header.req;
+        size = current->req.request_header.request_size;
+        reply_max = (current->req.request_header.reply_size + 7) & ~7;
+        if (code >= REQ_NB_REQUESTS || !batch_allowed[code] || size > data_size - pos ||
+            reply_max < current->req.request_header.reply_size ||
+            max_size - total < sizeof(sub_reply) || reply_max > max_size - total - sizeof(sub_reply))
+        {
+            status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        current->req_data = size ? (void *)(data + pos) : NULL;
+        current->reply_size = 0;
+        clear_error();
+        memset( &sub_reply, 0, sizeof(sub_reply) );
+
+        if (debug_level) trace_request();
+        if (binary_trace_fd != -1) binary_trace_request();
+        req_handlers[code]( &current->req, &sub_reply );
+        sub_reply.reply_header.error = current->error;
+        sub_reply.reply_header.reply_size = current->reply_size;
+        if (debug_level) trace_reply( code, &sub_reply );
+        if (binary_trace_fd != -1) binary_trace_reply( code, &sub_reply );
+
+        memcpy( replies + total, &sub_reply, sizeof(sub_reply) );
+        if (current->reply_size)
+            memcpy( replies + total + sizeof(sub_reply), current->reply_data, current->reply_size );
+        free( current->reply_data );
+        current->reply_data = NULL;
+        current->reply_size = 0;
+
+        total += sizeof(sub_reply) + reply_max;
+        pos += min( (size + 7) & ~7, data_size - pos );
+        count++;
+    }
+
+    current->req = batch;
+    current->req_data = batch_data;
+    clear_error();
+    if (status) set_error( status );
+    reply->count = count;
+    if (total) set_reply_data_ptr( replies, total );
+    else free( replies );
+}
+
+/* retrieve per-request statistics of the server */
+DECL_HANDLER(get_request_stats)
+{
+    char *ptr;
+    data_size_t size = 0, len;
+    unsigned int i;
+
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        if (!request_stats[i].count) continue;
+        size += (sizeof(struct request_stats) + strlen( get_request_name( i )) + 7) & ~7;
+    }
+
+    reply->uptime = current_time - server_start_time;
+    reply->total  = size;
+    if (size > get_reply_max_size()) set_error( STATUS_BUFFER_TOO_SMALL );
+    else if ((ptr = set_reply_data_size( size )))
+    {
+        memset( ptr, 0, size );
+        for (i = 0; i < REQ_NB_REQUESTS; i++)
+        {
+            struct request_stats *info = (struct request_stats *)ptr;
+
+            if (!request_stats[i].count) continue;
+            len = strlen( get_request_name( i ));
+            info->req        = i;
+            info->count      = request_stats[i].count;
+            info->total_time = request_stats[i].total_time;
+            info->max_time   = request_stats[i].max_time;
+            info->bytes_in   = request_stats[i].bytes_in;
+            info->bytes_out  = request_stats[i].bytes_out;
+            info->name_len   = len;
+            memcpy( info + 1, get_request_name( i ), len );
+            ptr += (sizeof(*info) + len + 7) & ~7;
+        }
+    }
+    if (req->reset && !get_error()) memset( request_stats, 0, sizeof(request_stats) );
+}
+
 /* read a request from a thread */
 void read_request( struct thread *thread )
 {
@@ -333,23 +499,54 @@ void read_request( struct thread *thread )
 
     if (!thread->req_toread)  /* no pending request */
     {
-        if ((ret = read( get_unix_fd( thread->request_fd ), &thread->req,
-                         sizeof(thread->req) )) != sizeof(thread->req)) goto error;
-        if (!(thread->req_toread = thread->req.request_header.request_size))
+        struct iovec vec[2];
+        data_size_t size;
+
+        if (!thread->req_buffer && !(thread->req_buffer = malloc( REQ_BUFFER_SIZE )))
+        {
+            fatal_protocol_error( thread, "no memory for request buffer\n" );
+            return;
+        }
+
+        /* the client writes the header and the data in one go, so try to fetch both at once */
+        vec[0].iov_base = &thread->req;
+        vec[0].iov_len  = sizeof(thread->req);
+        vec[1].iov_base = thread->req_buffer;
+        vec[1].iov_len  = REQ_BUFFER_SIZE;
+
+        if ((ret = readv( get_unix_fd( thread->request_fd ), vec, 2 )) < (int)sizeof(thread->req)) goto error;
+        ret -= sizeof(thread->req);
+        size = thread->req.request_header.request_size;
+
+        if ((data_size_t)ret > size)
+        {
+            fatal_protocol_error( thread, "request %d overflow %d > %u\n",
+                                  thread->req.request_header.req, ret, size );
+            return;
+        }
+        if (!size)
         {
             /* no data, handle request at once */
             call_req_handler( thread );
             return;
         }
-        if (!(thread->req_data = malloc( thread->req_toread )))
+        if (size <= REQ_BUFFER_SIZE) thread->req_data = thread->req_buffer;
+        else if ((thread->req_data = malloc( size ))) memcpy( thread->req_data, thread->req_buffer, ret );
+        else
         {
             fatal_protocol_error( thread, "no memory for %u bytes request %d\n",
-                                  thread->req_toread, thread->req.request_header.req );
+                                  size, thread->req.request_header.req );
+            return;
+        }
+        if (!(thread->req_toread = size - ret))
+        {
+            call_req_handler( thread );
+            free_req_data( thread );
             return;
         }
     }
 
-    /* read the variable sized data */
+    /* read the remaining part of the variable sized data */
     for (;;)
     {
         ret = read( get_unix_fd( thread->request_fd ),
@@ -360,8 +557,7 @@ void read_request( struct thread *thread )
         if (!(thread->req_toread -= ret))
         {
             call_req_handler( thread );
-            free( thread->req_data );
-            thread->req_data = NULL;
+            free_req_data( thread );
             return;
         }
     }
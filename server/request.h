@@ -65,6 +65,13 @@ extern int server_dir_fd, config_dir_fd;
 
 extern void trace_request(void);
 extern void trace_reply( enum request req, const union generic_reply *reply );
+extern int binary_trace_fd;
+extern void open_binary_trace( const char *name );
+extern void flush_binary_trace(void);
+extern void binary_trace_request(void);
+extern void binary_trace_reply( enum request req, const union generic_reply *reply );
+extern int dump_binary_trace( const char *name );
+extern const char *get_request_name( enum request req );
 
 /* get current tick count to return to client */
 static inline unsigned int get_tick_count(void)
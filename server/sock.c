@@ -53,6 +53,9 @@
 #include <time.h>
 #include <unistd.h>
 #include <limits.h>
+#ifdef HAVE_LINUX_ERRQUEUE_H
+# include <linux/errqueue.h>
+#endif
 #ifdef HAVE_LINUX_FILTER_H
 # include <linux/filter.h>
 #endif
@@ -134,6 +137,37 @@ union unix_sockaddr
 
 static struct list poll_list = LIST_INIT( poll_list );
 
+struct poll_req;
+
+/* each socket keeps a list of the poll entries referring to it, so that
+ * dispatching its events doesn't have to look at every pending poll */
+struct poll_entry
+{
+    struct list entry;          /* entry in the socket's poll list */
+    struct poll_req *req;
+    struct sock *sock;
+    int mask;
+    obj_handle_t handle;
+    int flags;
+    unsigned int status;
+};
+
+/* a send parked until the kernel has released the buffers of its zero-copy sends */
+struct zerocopy_wait
+{
+    struct list   entry;        /* entry in the socket's list, in sending order */
+    struct async *async;
+    unsigned int  end;          /* zerocopy_done value at which it can complete */
+};
+
+/* a range of zero-copy sends released before the previous ones */
+struct zerocopy_range
+{
+    struct list  entry;
+    unsigned int lo;            /* first and last released send, inclusive */
+    unsigned int hi;
+};
+
 struct poll_req
 {
     struct list entry;
@@ -144,14 +178,7 @@ struct poll_req
     int exclusive;
     int pending;
     unsigned int count;
-    struct
-    {
-        struct sock *sock;
-        int mask;
-        obj_handle_t handle;
-        int flags;
-        unsigned int status;
-    } sockets[1];
+    struct poll_entry sockets[1];
 };
 
 struct accept_req
@@ -234,12 +261,18 @@ struct sock
     struct async_queue  accept_q;    /* queue for asynchronous accepts */
     struct async_queue  connect_q;   /* queue for asynchronous connects */
     struct async_queue  poll_q;      /* queue for asynchronous polls */
+    struct async_queue  zerocopy_q;  /* queue for sends waiting for zero-copy notifications */
+    struct list         zerocopy_waits; /* pending zero-copy waits */
+    struct list         zerocopy_ranges; /* zero-copy notifications received out of order */
+    unsigned int        zerocopy_sent; /* number of zero-copy sends reported by clients */
+    unsigned int        zerocopy_done; /* all zero-copy sends before this one were released */
     struct object      *ifchange_obj; /* the interface change notification object */
     struct list         ifchange_entry; /* entry in ifchange notification list */
     struct list         accept_list; /* list of pending accept requests */
     struct accept_req  *accept_recv_req; /* pending accept-into request which will recv on this socket */
     struct connect_req *connect_req; /* pending connection request */
     struct poll_req    *main_poll;   /* main poll */
+    struct list         polls;       /* entries of poll requests for this socket */
     union win_sockaddr  addr;        /* socket name */
     int                 addr_len;    /* socket name length */
     union win_sockaddr  peer_addr;   /* peer name */
@@ -879,17 +912,44 @@ static void free_accept_req( void *private )
     free( req );
 }
 
-static void fill_accept_output( struct accept_req *req )
+/* store the local and remote addresses of an accepted socket, as AcceptEx expects them */
+static unsigned int fill_accept_addresses( int fd, char *out_data, unsigned int local_len, data_size_t out_size )
 {
-    const data_size_t out_size = req->iosb->out_size;
-    struct async *async = req->async;
     union unix_sockaddr unix_addr;
     struct WS_sockaddr *win_addr;
     unsigned int remote_len;
     socklen_t unix_len;
+    int win_len;
+
+    if (local_len)
+    {
+        if (local_len < sizeof(int)) return STATUS_BUFFER_TOO_SMALL;
+
+        unix_len = sizeof(unix_addr);
+        win_addr = (struct WS_sockaddr *)(out_data + sizeof(int));
+        if (getsockname( fd, &unix_addr.addr, &unix_len ) < 0 ||
+            (win_len = sockaddr_from_unix( &unix_addr, win_addr, local_len - sizeof(int) )) < 0)
+            return sock_get_ntstatus( errno );
+        memcpy( out_data, &win_len, sizeof(int) );
+    }
+
+    unix_len = sizeof(unix_addr);
+    win_addr = (struct WS_sockaddr *)(out_data + local_len + sizeof(int));
+    remote_len = out_size - local_len;
+    if (getpeername( fd, &unix_addr.addr, &unix_len ) < 0 ||
+        (win_len = sockaddr_from_unix( &unix_addr, win_addr, remote_len - sizeof(int) )) < 0)
+        return sock_get_ntstatus( errno );
+    memcpy( out_data + local_len, &win_len, sizeof(int) );
+    return STATUS_SUCCESS;
+}
+
+static void fill_accept_output( struct accept_req *req )
+{
+    const data_size_t out_size = req->iosb->out_size;
+    struct async *async = req->async;
+    unsigned int status;
     int fd, size = 0;
     char *out_data;
-    int win_len;
 
     if (!(out_data = mem_alloc( out_size )))
     {
@@ -913,43 +973,18 @@ static void fill_accept_output( struct accept_req *req )
         return;
     }
 
-    if (req->local_len)
+    if ((status = fill_accept_addresses( fd, out_data + req->recv_len, req->local_len, out_size - req->recv_len )))
     {
-        if (req->local_len < sizeof(int))
-        {
-            async_terminate( async, STATUS_BUFFER_TOO_SMALL );
-            free( out_data );
-            return;
-        }
-
-        unix_len = sizeof(unix_addr);
-        win_addr = (struct WS_sockaddr *)(out_data + req->recv_len + sizeof(int));
-        if (getsockname( fd, &unix_addr.addr, &unix_len ) < 0 ||
-            (win_len = sockaddr_from_unix( &unix_addr, win_addr, req->local_len - sizeof(int) )) < 0)
-        {
-            async_terminate( async, sock_get_ntstatus( errno ) );
-            free( out_data );
-            return;
-        }
-        memcpy( out_data + req->recv_len, &win_len, sizeof(int) );
-    }
-
-    unix_len = sizeof(unix_addr);
-    win_addr = (struct WS_sockaddr *)(out_data + req->recv_len + req->local_len + sizeof(int));
-    remote_len = out_size - req->recv_len - req->local_len;
-    if (getpeername( fd, &unix_addr.addr, &unix_len ) < 0 ||
-        (win_len = sockaddr_from_unix( &unix_addr, win_addr, remote_len - sizeof(int) )) < 0)
-    {
-        async_terminate( async, sock_get_ntstatus( errno ) );
+        async_terminate( async, status );
         free( out_data );
         return;
     }
-    memcpy( out_data + req->recv_len + req->local_len, &win_len, sizeof(int) );
 
     async_request_complete( req->async, STATUS_SUCCESS, size, out_size, out_data );
 }
 
-static void complete_async_accept( struct sock *sock, struct accept_req *req )
+/* returns FALSE once the backlog is empty, leaving the request queued */
+static int complete_async_accept( struct sock *sock, struct accept_req *req )
 {
     struct sock *acceptsock = req->acceptsock;
     struct async *async = req->async;
@@ -960,8 +995,9 @@ static void complete_async_accept( struct sock *sock, struct accept_req *req )
     {
         if (!accept_into_socket( sock, acceptsock ))
         {
+            if (get_error() == STATUS_DEVICE_NOT_READY) return FALSE;
             async_terminate( async, get_error() );
-            return;
+            return TRUE;
         }
         fill_accept_output( req );
     }
@@ -971,8 +1007,9 @@ static void complete_async_accept( struct sock *sock, struct accept_req *req )
 
         if (!(acceptsock = accept_socket( sock )))
         {
+            if (get_error() == STATUS_DEVICE_NOT_READY) return FALSE;
             async_terminate( async, get_error() );
-            return;
+            return TRUE;
         }
         handle = alloc_handle_no_access_check( async_get_thread( async )->process, &acceptsock->obj,
                                                GENERIC_READ | GENERIC_WRITE | SYNCHRONIZE, OBJ_INHERIT );
@@ -982,11 +1019,12 @@ static void complete_async_accept( struct sock *sock, struct accept_req *req )
         if (!handle)
         {
             async_terminate( async, get_error() );
-            return;
+            return TRUE;
         }
 
         async_request_complete_alloc( req->async, STATUS_SUCCESS, 0, sizeof(handle), &handle );
     }
+    return TRUE;
 }
 
 static void complete_async_accept_recv( struct accept_req *req )
@@ -1044,7 +1082,10 @@ static void free_poll_req( void *private )
     if (req->timeout) remove_timeout_user( req->timeout );
 
     for (i = 0; i < req->count; ++i)
+    {
+        list_remove( &req->sockets[i].entry );
         release_object( req->sockets[i].sock );
+    }
     release_object( req->async );
     release_object( req->iosb );
     list_remove( &req->entry );
@@ -1166,32 +1207,23 @@ static void complete_async_poll( struct poll_req *req, unsigned int status )
 static void complete_async_polls( struct sock *sock, int event, int error )
 {
     int flags = get_poll_flags( sock, event );
-    struct poll_req *req, *next;
+    struct poll_entry *entry, *next;
 
-    LIST_FOR_EACH_ENTRY_SAFE( req, next, &poll_list, struct poll_req, entry )
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &sock->polls, struct poll_entry, entry )
     {
-        unsigned int i;
+        struct poll_req *req = entry->req;
 
         if (req->iosb->status != STATUS_PENDING) continue;
+        if (!(entry->mask & flags)) continue;
 
-        for (i = 0; i < req->count; ++i)
-        {
-            if (req->sockets[i].sock != sock) continue;
-            if (!(req->sockets[i].mask & flags)) continue;
-
-            if (debug_level)
-                fprintf( stderr, "completing poll for socket %p, wanted %#x got %#x\n",
-                         sock, req->sockets[i].mask, flags );
+        if (debug_level)
+            fprintf( stderr, "completing poll for socket %p, wanted %#x got %#x\n",
+                     sock, entry->mask, flags );
 
-            req->sockets[i].flags = req->sockets[i].mask & flags;
-            req->sockets[i].status = sock_get_ntstatus( error );
+        entry->flags = entry->mask & flags;
+        entry->status = sock_get_ntstatus( error );
 
-            if (req->pending)
-            {
-                complete_async_poll( req, STATUS_SUCCESS );
-                break;
-            }
-        }
+        if (req->pending) complete_async_poll( req, STATUS_SUCCESS );
     }
 }
 
@@ -1210,16 +1242,19 @@ static int sock_dispatch_asyncs( struct sock *sock, int event, int error )
 {
     if (event & (POLLIN | POLLPRI))
     {
-        struct accept_req *req;
+        struct accept_req *req, *next;
 
-        LIST_FOR_EACH_ENTRY( req, &sock->accept_list, struct accept_req, entry )
+        /* serve as many queued accepts as there are connections waiting,
+         * instead of one per poll */
+        LIST_FOR_EACH_ENTRY_SAFE( req, next, &sock->accept_list, struct accept_req, entry )
         {
-            if (req->iosb->status == STATUS_PENDING && !req->accepted)
+            if (req->iosb->status != STATUS_PENDING || req->accepted) continue;
+            if (!complete_async_accept( sock, req ))
             {
-                complete_async_accept( sock, req );
-                event &= ~POLLIN;
+                clear_error();
                 break;
             }
+            event &= ~POLLIN;
         }
 
         if (sock->accept_recv_req && sock->accept_recv_req->iosb->status == STATUS_PENDING)
@@ -1340,6 +1375,93 @@ static void sock_dispatch_events( struct sock *sock, enum connection_state prevs
     post_sock_messages( sock );
 }
 
+/* complete the parked sends whose buffers have all been released */
+static void sock_wake_zerocopy( struct sock *sock )
+{
+    struct zerocopy_wait *wait, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( wait, next, &sock->zerocopy_waits, struct zerocopy_wait, entry )
+    {
+        if ((int)(wait->end - sock->zerocopy_done) > 0) break;
+        if (!async_wake_parked( wait->async )) continue;  /* retried once the client restarts it */
+        list_remove( &wait->entry );
+        release_object( wait->async );
+        free( wait );
+    }
+}
+
+#if defined(HAVE_LINUX_ERRQUEUE_H) && defined(SO_EE_ORIGIN_ZEROCOPY)
+
+static void sock_release_zerocopy( struct sock *sock, unsigned int lo, unsigned int hi )
+{
+    struct zerocopy_range *range, *next;
+
+    if ((int)(lo - sock->zerocopy_done) > 0)
+    {
+        /* keep it sorted until the sends before it are released too */
+        LIST_FOR_EACH_ENTRY( range, &sock->zerocopy_ranges, struct zerocopy_range, entry )
+            if ((int)(lo - range->lo) < 0) break;
+        if (!(next = mem_alloc( sizeof(*next) ))) return;
+        next->lo = lo;
+        next->hi = hi;
+        list_add_before( &range->entry, &next->entry );
+        return;
+    }
+
+    if ((int)(hi + 1 - sock->zerocopy_done) > 0) sock->zerocopy_done = hi + 1;
+    LIST_FOR_EACH_ENTRY_SAFE( range, next, &sock->zerocopy_ranges, struct zerocopy_range, entry )
+    {
+        if ((int)(range->lo - sock->zerocopy_done) > 0) break;
+        if ((int)(range->hi + 1 - sock->zerocopy_done) > 0) sock->zerocopy_done = range->hi + 1;
+        list_remove( &range->entry );
+        free( range );
+    }
+}
+
+/* consume the zero-copy notifications, which make the socket signal POLLERR;
+ * returns 1 if there were any */
+static int sock_drain_zerocopy( struct sock *sock )
+{
+    char control[CMSG_SPACE( sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6) )];
+    struct sock_extended_err *err;
+    struct cmsghdr *cmsg;
+    struct msghdr hdr;
+    int found = 0;
+
+    if (!is_tcp_socket( sock )) return 0;
+
+    for (;;)
+    {
+        memset( &hdr, 0, sizeof(hdr) );
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+        if (recvmsg( get_unix_fd( sock->fd ), &hdr, MSG_ERRQUEUE | MSG_DONTWAIT ) < 0) break;
+
+        for (cmsg = CMSG_FIRSTHDR( &hdr ); cmsg; cmsg = CMSG_NXTHDR( &hdr, cmsg ))
+        {
+            if (!(cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+                continue;
+            err = (struct sock_extended_err *)CMSG_DATA( cmsg );
+            if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || err->ee_errno) continue;
+            sock_release_zerocopy( sock, err->ee_info, err->ee_data );
+            found = 1;
+        }
+    }
+
+    if (found) sock_wake_zerocopy( sock );
+    return found;
+}
+
+#else
+
+static int sock_drain_zerocopy( struct sock *sock )
+{
+    return 0;
+}
+
+#endif
+
 static void sock_poll_event( struct fd *fd, int event )
 {
     struct sock *sock = get_fd_user( fd );
@@ -1354,7 +1476,12 @@ static void sock_poll_event( struct fd *fd, int event )
         fprintf(stderr, "socket %p select event: %x\n", sock, event);
 
     if (event & (POLLERR | POLLHUP))
+    {
+        int zerocopy = (event & POLLERR) && sock_drain_zerocopy( sock );
+
         error = sock_error( sock, &event );
+        if (zerocopy && !error && !(event & POLLHUP)) event &= ~POLLERR;
+    }
 
     switch (sock->state)
     {
@@ -1476,7 +1603,7 @@ static int sock_get_poll_events( struct fd *fd )
 {
     struct sock *sock = get_fd_user( fd );
     unsigned int mask = sock->mask & ~sock->reported_events;
-    struct poll_req *req;
+    struct poll_entry *entry;
     int ev = 0;
 
     assert( sock->obj.ops == &sock_ops );
@@ -1484,18 +1611,10 @@ static int sock_get_poll_events( struct fd *fd )
     if (!sock->type) /* not initialized yet */
         return -1;
 
-    LIST_FOR_EACH_ENTRY( req, &poll_list, struct poll_req, entry )
+    LIST_FOR_EACH_ENTRY( entry, &sock->polls, struct poll_entry, entry )
     {
-        unsigned int i;
-
-        if (req->iosb->status != STATUS_PENDING) continue;
-
-        for (i = 0; i < req->count; ++i)
-        {
-            if (req->sockets[i].sock != sock) continue;
-
-            ev |= poll_flags_from_afd( sock, req->sockets[i].mask );
-        }
+        if (entry->req->iosb->status != STATUS_PENDING) continue;
+        ev |= poll_flags_from_afd( sock, entry->mask );
     }
 
     switch (sock->state)
@@ -1625,6 +1744,8 @@ static void sock_reselect_async( struct fd *fd, struct async_queue *queue )
         sock->wr_shutdown_pending = 0;
     }
 
+    if (queue == &sock->zerocopy_q) sock_wake_zerocopy( sock );
+
     /* Don't reselect the ifchange queue; we always ask for POLLIN.
      * Don't reselect an uninitialized socket; we can't call set_fd_events() on
      * a pseudo-fd. */
@@ -1645,7 +1766,7 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
     if (sock->obj.handle_count == 1) /* last handle */
     {
         struct accept_req *accept_req, *accept_next;
-        struct poll_req *poll_req, *poll_next;
+        struct poll_entry *entry, *next;
 
         if (sock->accept_recv_req)
             async_terminate( sock->accept_recv_req->async, STATUS_CANCELLED );
@@ -1656,25 +1777,18 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
         if (sock->connect_req)
             async_terminate( sock->connect_req->async, STATUS_CANCELLED );
 
-        LIST_FOR_EACH_ENTRY_SAFE( poll_req, poll_next, &poll_list, struct poll_req, entry )
+        /* a poll may list the socket more than once; flag all entries before completing */
+        LIST_FOR_EACH_ENTRY( entry, &sock->polls, struct poll_entry, entry )
         {
-            struct iosb *iosb = poll_req->iosb;
-            BOOL signaled = FALSE;
-            unsigned int i;
-
-            if (iosb->status != STATUS_PENDING) continue;
-
-            for (i = 0; i < poll_req->count; ++i)
-            {
-                if (poll_req->sockets[i].sock == sock)
-                {
-                    signaled = TRUE;
-                    poll_req->sockets[i].flags = AFD_POLL_CLOSE;
-                    poll_req->sockets[i].status = 0;
-                }
-            }
+            if (entry->req->iosb->status != STATUS_PENDING) continue;
+            entry->flags = AFD_POLL_CLOSE;
+            entry->status = 0;
+        }
 
-            if (signaled) complete_async_poll( poll_req, STATUS_SUCCESS );
+        LIST_FOR_EACH_ENTRY_SAFE( entry, next, &sock->polls, struct poll_entry, entry )
+        {
+            if (entry->req->iosb->status != STATUS_PENDING) continue;
+            complete_async_poll( entry->req, STATUS_SUCCESS );
         }
     }
     return async_close_obj_handle( obj, process, handle );
@@ -1683,6 +1797,8 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
 static void sock_destroy( struct object *obj )
 {
     struct sock *sock = (struct sock *)obj;
+    struct zerocopy_wait *wait, *next_wait;
+    struct zerocopy_range *range, *next_range;
     unsigned int i;
 
     assert( obj->ops == &sock_ops );
@@ -1709,6 +1825,14 @@ static void sock_destroy( struct object *obj )
     free_async_queue( &sock->accept_q );
     free_async_queue( &sock->connect_q );
     free_async_queue( &sock->poll_q );
+    free_async_queue( &sock->zerocopy_q );
+    LIST_FOR_EACH_ENTRY_SAFE( wait, next_wait, &sock->zerocopy_waits, struct zerocopy_wait, entry )
+    {
+        release_object( wait->async );
+        free( wait );
+    }
+    LIST_FOR_EACH_ENTRY_SAFE( range, next_range, &sock->zerocopy_ranges, struct zerocopy_range, entry )
+        free( range );
     if (sock->event) release_object( sock->event );
     if (sock->fd) release_object( sock->fd );
 }
@@ -1762,8 +1886,14 @@ static struct sock *create_socket(void)
     init_async_queue( &sock->accept_q );
     init_async_queue( &sock->connect_q );
     init_async_queue( &sock->poll_q );
+    init_async_queue( &sock->zerocopy_q );
+    list_init( &sock->zerocopy_waits );
+    list_init( &sock->zerocopy_ranges );
+    sock->zerocopy_sent = 0;
+    sock->zerocopy_done = 0;
     memset( sock->errors, 0, sizeof(sock->errors) );
     list_init( &sock->accept_list );
+    list_init( &sock->polls );
     return sock;
 }
 
@@ -1989,14 +2119,68 @@ static int accept_new_fd( struct sock *sock )
      */
     struct sockaddr saddr;
     socklen_t slen = sizeof(saddr);
+#ifdef HAVE_ACCEPT4
+    int acceptfd = accept4( get_unix_fd(sock->fd), &saddr, &slen, SOCK_NONBLOCK );
+#else
     int acceptfd = accept( get_unix_fd(sock->fd), &saddr, &slen );
     if (acceptfd != -1)
         fcntl( acceptfd, F_SETFL, O_NONBLOCK );
-    else
+#endif
+    if (acceptfd == -1)
         set_error( sock_get_ntstatus( errno ));
     return acceptfd;
 }
 
+/* create the socket object of a connection accepted on a listening socket */
+static struct sock *create_accepted_socket( struct sock *sock, int acceptfd )
+{
+    union unix_sockaddr unix_addr;
+    struct sock *acceptsock;
+    socklen_t unix_len;
+
+    if (!(acceptsock = create_socket()))
+    {
+        close( acceptfd );
+        return NULL;
+    }
+
+    /* newly created socket gets the same properties of the listening socket */
+    acceptsock->state               = SOCK_CONNECTED;
+    acceptsock->bound               = 1;
+    acceptsock->nonblocking         = sock->nonblocking;
+    acceptsock->mask                = sock->mask;
+    acceptsock->proto               = sock->proto;
+    acceptsock->type                = sock->type;
+    acceptsock->family              = sock->family;
+    acceptsock->window              = sock->window;
+    acceptsock->message             = sock->message;
+    acceptsock->reuseaddr           = sock->reuseaddr;
+    acceptsock->exclusiveaddruse    = sock->exclusiveaddruse;
+    acceptsock->sndbuf              = sock->sndbuf;
+    acceptsock->rcvbuf              = sock->rcvbuf;
+    acceptsock->sndtimeo            = sock->sndtimeo;
+    acceptsock->rcvtimeo            = sock->rcvtimeo;
+    acceptsock->connect_time        = current_time;
+
+    if (sock->event) acceptsock->event = (struct event *)grab_object( sock->event );
+    if (!(acceptsock->fd = create_anonymous_fd( &sock_fd_ops, acceptfd, &acceptsock->obj,
+                                                get_fd_options( sock->fd ) )))
+    {
+        release_object( acceptsock );
+        return NULL;
+    }
+    unix_len = sizeof(unix_addr);
+    if (!getsockname( acceptfd, &unix_addr.addr, &unix_len ))
+    {
+        acceptsock->addr_len = sockaddr_from_unix( &unix_addr, &acceptsock->addr.addr, sizeof(acceptsock->addr) );
+        if (!getpeername( acceptfd, &unix_addr.addr, &unix_len ))
+            acceptsock->peer_addr_len = sockaddr_from_unix( &unix_addr,
+                                                            &acceptsock->peer_addr.addr,
+                                                            sizeof(acceptsock->peer_addr) );
+    }
+    return acceptsock;
+}
+
 /* accept a socket (creates a new fd) */
 static struct sock *accept_socket( struct sock *sock )
 {
@@ -2012,50 +2196,8 @@ static struct sock *accept_socket( struct sock *sock )
     }
     else
     {
-        union unix_sockaddr unix_addr;
-        socklen_t unix_len;
-
         if ((acceptfd = accept_new_fd( sock )) == -1) return NULL;
-        if (!(acceptsock = create_socket()))
-        {
-            close( acceptfd );
-            return NULL;
-        }
-
-        /* newly created socket gets the same properties of the listening socket */
-        acceptsock->state               = SOCK_CONNECTED;
-        acceptsock->bound               = 1;
-        acceptsock->nonblocking         = sock->nonblocking;
-        acceptsock->mask                = sock->mask;
-        acceptsock->proto               = sock->proto;
-        acceptsock->type                = sock->type;
-        acceptsock->family              = sock->family;
-        acceptsock->window              = sock->window;
-        acceptsock->message             = sock->message;
-        acceptsock->reuseaddr           = sock->reuseaddr;
-        acceptsock->exclusiveaddruse    = sock->exclusiveaddruse;
-        acceptsock->sndbuf              = sock->sndbuf;
-        acceptsock->rcvbuf              = sock->rcvbuf;
-        acceptsock->sndtimeo            = sock->sndtimeo;
-        acceptsock->rcvtimeo            = sock->rcvtimeo;
-        acceptsock->connect_time        = current_time;
-
-        if (sock->event) acceptsock->event = (struct event *)grab_object( sock->event );
-        if (!(acceptsock->fd = create_anonymous_fd( &sock_fd_ops, acceptfd, &acceptsock->obj,
-                                                    get_fd_options( sock->fd ) )))
-        {
-            release_object( acceptsock );
-            return NULL;
-        }
-        unix_len = sizeof(unix_addr);
-        if (!getsockname( acceptfd, &unix_addr.addr, &unix_len ))
-        {
-            acceptsock->addr_len = sockaddr_from_unix( &unix_addr, &acceptsock->addr.addr, sizeof(acceptsock->addr) );
-            if (!getpeername( acceptfd, &unix_addr.addr, &unix_len ))
-                acceptsock->peer_addr_len = sockaddr_from_unix( &unix_addr,
-                                                                &acceptsock->peer_addr.addr,
-                                                                sizeof(acceptsock->peer_addr) );
-        }
+        if (!(acceptsock = create_accepted_socket( sock, acceptfd ))) return NULL;
     }
 
     clear_error();
@@ -2551,6 +2693,82 @@ static void sock_ioctl( struct fd *fd, ioctl_code_t code, struct async *async )
         return;
     }
 
+    case IOCTL_AFD_WINE_ACCEPT_FD:
+    {
+        static const int access = FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | FILE_READ_DATA;
+        const struct afd_accept_fd_params *params = get_req_data();
+        struct sock *acceptsock, *newsock, *pending;
+        obj_handle_t handle;
+        char *out_data;
+        int acceptfd;
+
+        if (get_req_data_size() != sizeof(*params))
+        {
+            set_error( STATUS_INVALID_PARAMETER );
+            return;
+        }
+        if ((acceptfd = thread_get_inflight_fd( current, params->fd )) == -1)
+        {
+            set_error( STATUS_INVALID_HANDLE );
+            return;
+        }
+        if (sock->state != SOCK_LISTENING)
+        {
+            close( acceptfd );
+            set_error( STATUS_INVALID_PARAMETER );
+            return;
+        }
+        if (!(newsock = create_accepted_socket( sock, acceptfd ))) return;
+
+        /* The connection was accepted by the client. Handing it over as a deferred one
+         * lets the accept code below pick it up, and keeps it if anything fails. A
+         * connection deferred by WSAAccept still goes first. */
+        if (!(pending = sock->deferred)) sock->deferred = newsock;
+
+        if (!params->accept_handle)
+        {
+            if (get_reply_max_size() != sizeof(handle))
+                set_error( STATUS_BUFFER_TOO_SMALL );
+            else if ((acceptsock = accept_socket( sock )))
+            {
+                handle = alloc_handle( current->process, &acceptsock->obj,
+                                       GENERIC_READ | GENERIC_WRITE | SYNCHRONIZE, OBJ_INHERIT );
+                acceptsock->wparam = handle;
+                sock_reselect( acceptsock );
+                release_object( acceptsock );
+                set_reply_data( &handle, sizeof(handle) );
+            }
+        }
+        else if (get_reply_max_size() < params->local_len ||
+                 get_reply_max_size() - params->local_len < sizeof(int))
+            set_error( STATUS_BUFFER_TOO_SMALL );
+        else if ((acceptsock = (struct sock *)get_handle_obj( current->process, params->accept_handle,
+                                                              access, &sock_ops )))
+        {
+            if (acceptsock->accept_recv_req || acceptsock->state == SOCK_LISTENING)
+                set_error( STATUS_INVALID_PARAMETER );
+            else if (accept_into_socket( sock, acceptsock ))
+            {
+                unsigned int status;
+
+                acceptsock->wparam = params->accept_handle;
+                sock_reselect( acceptsock );
+                if ((out_data = set_reply_data_size( get_reply_max_size() )) &&
+                    (status = fill_accept_addresses( get_unix_fd( acceptsock->fd ), out_data,
+                                                     params->local_len, get_reply_max_size() )))
+                    set_error( status );
+            }
+            release_object( acceptsock );
+        }
+
+        if (pending)
+        {
+            if (!sock->deferred) sock->deferred = newsock;
+            else release_object( newsock );
+        }
+        return;
+    }
+
     case IOCTL_AFD_LISTEN:
     {
         const struct afd_listen_params *params = get_req_data();
@@ -3456,6 +3674,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
                          unsigned int count, const struct afd_poll_socket_64 *sockets )
 {
     BOOL signaled = FALSE;
+    struct pollfd *pollfds;
     struct poll_req *req;
     unsigned int i, j;
 
@@ -3467,12 +3686,18 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
 
     if (!(req = mem_alloc( offsetof( struct poll_req, sockets[count] ) )))
         return;
+    if (!(pollfds = mem_alloc( count * sizeof(*pollfds) )))
+    {
+        free( req );
+        return;
+    }
 
     req->timeout = NULL;
     req->pending = 0;
     if (timeout && timeout != TIMEOUT_INFINITE &&
         !(req->timeout = add_timeout_user( timeout, async_poll_timeout, req )))
     {
+        free( pollfds );
         free( req );
         return;
     }
@@ -3485,14 +3710,19 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         {
             for (j = 0; j < i; ++j) release_object( req->sockets[j].sock );
             if (req->timeout) remove_timeout_user( req->timeout );
+            free( pollfds );
             free( req );
             return;
         }
+        req->sockets[i].req = req;
         req->sockets[i].handle = sockets[i].socket;
         req->sockets[i].mask = sockets[i].flags;
         req->sockets[i].flags = 0;
     }
 
+    for (i = 0; i < count; ++i)
+        list_add_tail( &req->sockets[i].sock->polls, &req->sockets[i].entry );
+
     req->exclusive = exclusive;
     req->count = count;
     req->async = (struct async *)grab_object( async );
@@ -3504,16 +3734,27 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
     async_set_completion_callback( async, free_poll_req, req );
     queue_async( &poll_sock->poll_q, async );
 
+    /* check the current state of all the sockets with a single poll() call */
+    for (i = 0; i < count; ++i)
+    {
+        struct sock *sock = req->sockets[i].sock;
+
+        pollfds[i].events = poll_flags_from_afd( sock, req->sockets[i].mask );
+        pollfds[i].fd = pollfds[i].events >= 0 ? get_unix_fd( sock->fd ) : -1;
+        pollfds[i].revents = 0;
+    }
+    if (poll( pollfds, count, 0 ) < 0)
+    {
+        for (i = 0; i < count; ++i) pollfds[i].events = -1;
+    }
+
     for (i = 0; i < count; ++i)
     {
         struct sock *sock = req->sockets[i].sock;
         int mask = req->sockets[i].mask;
-        struct pollfd pollfd;
 
-        pollfd.fd = get_unix_fd( sock->fd );
-        pollfd.events = poll_flags_from_afd( sock, mask );
-        if (pollfd.events >= 0 && poll( &pollfd, 1, 0 ) >= 0)
-            sock_poll_event( sock->fd, pollfd.revents );
+        if (pollfds[i].events >= 0)
+            sock_poll_event( sock->fd, pollfds[i].revents );
 
         /* FIXME: do other error conditions deserve a similar treatment? */
         if (sock->state != SOCK_CONNECTING && sock->errors[AFD_POLL_BIT_CONNECT_ERR] && (mask & AFD_POLL_CONNECT_ERR))
@@ -3536,6 +3777,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
 
     for (i = 0; i < req->count; ++i)
         sock_reselect( req->sockets[i].sock );
+    free( pollfds );
     set_error( STATUS_PENDING );
 }
 
@@ -3902,6 +4144,12 @@ DECL_HANDLER(recv_socket)
         reply->wait = async_handoff( async, NULL, 0 );
         reply->options = get_fd_options( fd );
         reply->nonblocking = sock->nonblocking;
+        /* with no other handle and no event selection, only the client itself can queue
+         * receives or observe the read events, so it may skip us while none is queued */
+        reply->direct = !req->oob && sock->obj.handle_count == 1 && !sock->mask && !sock->event &&
+                        !sock->window && !sock->rd_shutdown && !sock->reset;
+        reply->completion = fd_has_completion( fd ) &&
+                            !(get_fd_comp_flags( fd ) & FILE_SKIP_COMPLETION_PORT_ON_SUCCESS);
         release_object( async );
     }
     release_object( sock );
@@ -4115,3 +4363,39 @@ DECL_HANDLER(socket_get_icmp_id)
     set_error( STATUS_NOT_FOUND );
     release_object( sock );
 }
+
+DECL_HANDLER(alert_socket_asyncs)
+{
+    struct sock *sock = (struct sock *)get_handle_obj( current->process, req->handle, 0, &sock_ops );
+
+    if (!sock) return;
+
+    async_alert_users( req->write ? &sock->write_q : &sock->read_q, current->process,
+                       get_req_data(), get_req_data_size() / sizeof(client_ptr_t) );
+    release_object( sock );
+}
+
+DECL_HANDLER(socket_wait_zerocopy)
+{
+    struct sock *sock = (struct sock *)get_handle_obj( current->process, req->handle, 0, &sock_ops );
+    struct zerocopy_wait *wait;
+
+    if (!sock) return;
+
+    /* the kernel numbers the zero-copy sends of a socket sequentially; clients
+     * report theirs right after making them, so this covers all of theirs */
+    sock->zerocopy_sent += req->count;
+
+    if (req->user && (int)(sock->zerocopy_sent - sock->zerocopy_done) > 0 &&
+        (wait = mem_alloc( sizeof(*wait) )))
+    {
+        if ((wait->async = async_park_user( &sock->write_q, &sock->zerocopy_q, current->process, req->user )))
+        {
+            wait->end = sock->zerocopy_sent;
+            list_add_tail( &sock->zerocopy_waits, &wait->entry );
+            reply->wait = 1;
+        }
+        else free( wait );
+    }
+    release_object( sock );
+}
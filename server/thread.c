@@ -231,12 +231,17 @@ static const struct fd_ops thread_fd_ops =
 static struct list thread_list = LIST_INIT(thread_list);
 #ifdef __linux__
 static int nice_limit;
+static int rt_limit;                /* highest SCHED_RR priority we may use, 0 if none */
 #endif
+static unsigned int rt_threads;     /* number of threads currently using SCHED_RR */
+static unsigned int rt_failures;    /* number of times SCHED_RR couldn't be set */
+
+#define RT_PRIORITY_DEFAULT_LIMIT 20  /* same default limit as rtkit */
 
 void init_threading(void)
 {
 #ifdef __linux__
-#ifdef RLIMIT_NICE
+#if defined(RLIMIT_NICE) || defined(RLIMIT_RTPRIO)
     struct rlimit rlimit;
 #endif
 #ifdef HAVE_SETPRIORITY
@@ -255,6 +260,21 @@ void init_threading(void)
     }
 #endif
     if (nice_limit < 0 && debug_level) fprintf(stderr, "wine: Using setpriority to control niceness in the [%d,%d] range\n", nice_limit, -nice_limit );
+#ifdef SCHED_RR
+    {
+        const char *env = getenv( "WINE_RT_PRIO" );
+        int limit = env ? atoi( env ) : RT_PRIORITY_DEFAULT_LIMIT;
+
+        rt_limit = min( limit, sched_get_priority_max( SCHED_RR ));
+#ifdef RLIMIT_RTPRIO
+        /* without cap_sys_nice, the clients are limited by RLIMIT_RTPRIO */
+        if (nice_limit != -19 && !getrlimit( RLIMIT_RTPRIO, &rlimit ) && rlimit.rlim_max != RLIM_INFINITY)
+            rt_limit = min( rt_limit, (int)rlimit.rlim_max );
+#endif
+        if (rt_limit < 0) rt_limit = 0;
+        if (rt_limit && debug_level) fprintf( stderr, "wine: Using SCHED_RR in the [1,%d] range\n", rt_limit );
+    }
+#endif
 #endif
 }
 
@@ -265,6 +285,7 @@ static inline void init_thread_structure( struct thread *thread )
 
     thread->unix_pid        = -1;  /* not known yet */
     thread->unix_tid        = -1;  /* not known yet */
+    thread->rt_priority     = 0;
     thread->context         = NULL;
     thread->teb             = 0;
     thread->entry_point     = 0;
@@ -277,6 +298,7 @@ static inline void init_thread_structure( struct thread *thread )
     thread->error           = 0;
     thread->req_data        = NULL;
     thread->req_toread      = 0;
+    thread->req_buffer      = NULL;
     thread->reply_data      = NULL;
     thread->reply_towrite   = 0;
     thread->request_fd      = NULL;
@@ -537,11 +559,14 @@ static void cleanup_thread( struct thread *thread )
     }
     clear_apc_queue( &thread->system_apc );
     clear_apc_queue( &thread->user_apc );
-    free( thread->req_data );
+    if (thread->req_data != thread->req_buffer) free( thread->req_data );
+    free( thread->req_buffer );
     free( thread->reply_data );
     if (thread->request_fd) release_object( thread->request_fd );
     if (thread->reply_fd) release_object( thread->reply_fd );
     if (thread->wait_fd) release_object( thread->wait_fd );
+    if (thread->rt_priority) rt_threads--;
+    thread->rt_priority = 0;
     cleanup_clipboard_thread(thread);
     destroy_thread_windows( thread );
     free_msg_queue( thread );
@@ -560,6 +585,7 @@ static void cleanup_thread( struct thread *thread )
     if (thread->input_shared_mapping) release_object( thread->input_shared_mapping );
     thread->input_shared_mapping = NULL;
     thread->req_data = NULL;
+    thread->req_buffer = NULL;
     thread->reply_data = NULL;
     thread->request_fd = NULL;
     thread->reply_fd = NULL;
@@ -803,14 +829,51 @@ static int get_unix_niceness( int base_priority )
 #define THREAD_PRIORITY_REALTIME_HIGHEST 6
 #define THREAD_PRIORITY_REALTIME_LOWEST -7
 
+#ifdef __linux__
+/* switch a thread to SCHED_RR, or back to SCHED_OTHER when rt_priority is 0 */
+static int set_thread_scheduler( struct thread *thread, int rt_priority )
+{
+#ifdef SCHED_RR
+    struct sched_param param;
+    int policy = rt_priority ? SCHED_RR : SCHED_OTHER;
+
+    if (thread->rt_priority == rt_priority) return 1;
+#ifdef SCHED_RESET_ON_FORK
+    policy |= SCHED_RESET_ON_FORK;
+#endif
+    param.sched_priority = rt_priority;
+    if (sched_setscheduler( thread->unix_tid, policy, &param ) == -1)
+    {
+        if (rt_priority) rt_failures++;
+        if (debug_level) fprintf( stderr, "wine: sched_setscheduler %d for pid %d failed: %d\n",
+                                  rt_priority, thread->unix_tid, errno );
+        return 0;
+    }
+    if (rt_priority && !thread->rt_priority) rt_threads++;
+    else if (!rt_priority && thread->rt_priority) rt_threads--;
+    thread->rt_priority = rt_priority;
+    return 1;
+#else
+    return !rt_priority;
+#endif
+}
+#endif
+
 static void apply_thread_priority( struct thread *thread, int priority_class, int priority )
 {
     int base_priority = get_base_priority( priority_class, priority );
 #ifdef __linux__
     int niceness;
 
-    /* FIXME: handle REALTIME class using SCHED_RR if possible, for now map it to highest non-realtime band */
-    if (priority_class == PROCESS_PRIOCLASS_REALTIME) base_priority = 15;
+    if (thread->unix_tid == -1) return;
+
+    /* time critical threads and the realtime class are mapped to SCHED_RR [1,rt_limit],
+     * with niceness as a fallback, where they get the highest non-realtime band */
+    if ((base_priority > 15 || priority == THREAD_PRIORITY_TIME_CRITICAL) && rt_limit &&
+        set_thread_scheduler( thread, 1 + (base_priority - 15) * (rt_limit - 1) / 16 ))
+        return;
+    if (!set_thread_scheduler( thread, 0 )) return;
+    if (base_priority > 15) base_priority = 15;
 #ifdef HAVE_SETPRIORITY
     if (nice_limit < 0)
     {
@@ -1676,7 +1739,7 @@ DECL_HANDLER(init_first_thread)
         process->affinity = current->affinity = get_thread_affinity( current );
     else
     {
-        set_thread_priority( current, current->process->priority, current->priority );
+        apply_thread_priority( current, current->process->priority, current->priority );
         set_thread_affinity( current, current->affinity );
     }
 
@@ -1709,7 +1772,7 @@ DECL_HANDLER(init_thread)
 
     init_thread_context( current );
     generate_debug_event( current, DbgCreateThreadStateChange, &req->entry );
-    set_thread_priority( current, current->process->priority, current->priority );
+    apply_thread_priority( current, current->process->priority, current->priority );
     set_thread_affinity( current, current->affinity );
 
     reply->suspend = (current->suspend || current->process->suspend || current->context != NULL);
@@ -2018,6 +2081,9 @@ DECL_HANDLER(queue_apc)
         process = get_process_from_handle( req->handle, PROCESS_VM_OPERATION );
         break;
     case APC_VIRTUAL_QUERY:
+    case APC_VIRTUAL_USAGE:
+    case APC_IO_COUNTERS:
+    case APC_HANDLE_IO:
         process = get_process_from_handle( req->handle, PROCESS_QUERY_INFORMATION );
         break;
     case APC_MAP_VIEW:
@@ -2312,3 +2378,14 @@ DECL_HANDLER(get_next_thread)
     set_error( STATUS_NO_MORE_ENTRIES );
     release_object( process );
 }
+
+/* retrieve the realtime scheduling statistics */
+DECL_HANDLER(get_scheduler_stats)
+{
+#ifdef __linux__
+    reply->rt_limit   = rt_limit;
+    reply->nice_limit = nice_limit;
+#endif
+    reply->rt_threads  = rt_threads;
+    reply->rt_failures = rt_failures;
+}
@@ -45,6 +45,7 @@ struct inflight_fd
     int server;  /* fd on the server side */
 };
 #define MAX_INFLIGHT_FDS 16  /* max number of fds in flight per thread */
+#define REQ_BUFFER_SIZE 1024 /* size of the per-thread buffer used for small request data */
 
 struct thread
 {
@@ -68,6 +69,7 @@ struct thread
     union generic_request  req;           /* current request */
     void                  *req_data;      /* variable-size data for request */
     unsigned int           req_toread;    /* amount of data still to read in request */
+    void                  *req_buffer;    /* preallocated buffer for small request data */
     void                  *reply_data;    /* variable-size data for reply */
     unsigned int           reply_size;    /* size of reply data */
     unsigned int           reply_towrite; /* amount of data still to write in reply */
@@ -84,6 +86,7 @@ struct thread
     client_ptr_t           entry_point;   /* entry point (in client address space) */
     affinity_t             affinity;      /* affinity mask */
     int                    priority;      /* priority level */
+    int                    rt_priority;   /* SCHED_RR priority of the Unix thread, 0 if not realtime */
     int                    suspend;       /* suspend count */
     int                    dbg_hidden;    /* hidden from debugger */
     obj_handle_t           desktop;       /* desktop handle */
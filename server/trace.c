@@ -21,9 +21,14 @@
 #include "config.h"
 
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #ifdef HAVE_SYS_UIO_H
 #include <sys/uio.h>
@@ -43,6 +48,7 @@
 #define USE_WS_PREFIX
 #include "winsock2.h"
 #include "file.h"
+#include "process.h"
 #include "request.h"
 #include "security.h"
 #include "unicode.h"
@@ -207,6 +213,9 @@ static void dump_apc_call( const char *prefix, const apc_call_t *call )
     case APC_VIRTUAL_QUERY:
         dump_uint64( "APC_VIRTUAL_QUERY,addr=", &call->virtual_query.addr );
         break;
+    case APC_VIRTUAL_USAGE:
+        dump_uint64( "APC_VIRTUAL_USAGE,addr=", &call->virtual_usage.addr );
+        break;
     case APC_VIRTUAL_PROTECT:
         dump_uint64( "APC_VIRTUAL_PROTECT,addr=", &call->virtual_protect.addr );
         dump_uint64( ",size=", &call->virtual_protect.size );
@@ -258,6 +267,12 @@ static void dump_apc_call( const char *prefix, const apc_call_t *call )
                  call->dup_handle.src_handle, call->dup_handle.dst_process, call->dup_handle.access,
                  call->dup_handle.attributes, call->dup_handle.options );
         break;
+    case APC_IO_COUNTERS:
+        fprintf( stderr, "APC_IO_COUNTERS" );
+        break;
+    case APC_HANDLE_IO:
+        fprintf( stderr, "APC_HANDLE_IO,handle=%04x", call->handle_io.handle );
+        break;
     default:
         fprintf( stderr, "type=%u", call->type );
         break;
@@ -298,6 +313,15 @@ static void dump_apc_result( const char *prefix, const apc_result_t *result )
                  result->virtual_query.state, result->virtual_query.prot,
                  result->virtual_query.alloc_prot, result->virtual_query.alloc_type );
         break;
+    case APC_VIRTUAL_USAGE:
+        fprintf( stderr, "APC_VIRTUAL_USAGE,status=%s",
+                 get_status_name( result->virtual_usage.status ));
+        dump_uint64( ",base=", &result->virtual_usage.base );
+        dump_uint64( ",size=", &result->virtual_usage.size );
+        dump_uint64( ",commit=", &result->virtual_usage.commit );
+        dump_uint64( ",resident=", &result->virtual_usage.resident );
+        fprintf( stderr, ",usage=%u", result->virtual_usage.usage );
+        break;
     case APC_VIRTUAL_PROTECT:
         fprintf( stderr, "APC_VIRTUAL_PROTECT,status=%s",
                  get_status_name( result->virtual_protect.status ));
@@ -342,6 +366,25 @@ static void dump_apc_result( const char *prefix, const apc_result_t *result )
         fprintf( stderr, "APC_DUP_HANDLE,status=%s,handle=%04x",
                  get_status_name( result->dup_handle.status ), result->dup_handle.handle );
         break;
+    case APC_IO_COUNTERS:
+        fprintf( stderr, "APC_IO_COUNTERS,status=%s",
+                 get_status_name( result->io_counters.status ));
+        dump_uint64( ",read_ops=", &result->io_counters.read_ops );
+        dump_uint64( ",write_ops=", &result->io_counters.write_ops );
+        dump_uint64( ",other_ops=", &result->io_counters.other_ops );
+        dump_uint64( ",read_bytes=", &result->io_counters.read_bytes );
+        dump_uint64( ",write_bytes=", &result->io_counters.write_bytes );
+        dump_uint64( ",other_bytes=", &result->io_counters.other_bytes );
+        break;
+    case APC_HANDLE_IO:
+        fprintf( stderr, "APC_HANDLE_IO,handle=%04x", result->handle_io.handle );
+        dump_uint64( ",read_bytes=", &result->handle_io.read_bytes );
+        dump_uint64( ",write_bytes=", &result->handle_io.write_bytes );
+        dump_timeout( ",read_time=", &result->handle_io.read_time );
+        dump_timeout( ",write_time=", &result->handle_io.write_time );
+        fprintf( stderr, ",read_ops=%u,write_ops=%u,async_ops=%u,zerocopy_ops=%u", result->handle_io.read_ops,
+                 result->handle_io.write_ops, result->handle_io.async_ops, result->handle_io.zerocopy_ops );
+        break;
     default:
         fprintf( stderr, "type=%u", result->type );
         break;
@@ -1396,6 +1439,71 @@ static void dump_varargs_handle_infos( const char *prefix, data_size_t size )
     fputc( '}', stderr );
 }
 
+static void dump_varargs_request_stats( const char *prefix, data_size_t size )
+{
+    const struct request_stats *stats;
+    data_size_t len;
+
+    fprintf( stderr, "%s{", prefix );
+    while (size >= sizeof(*stats))
+    {
+        stats = cur_data;
+        if (size - sizeof(*stats) < stats->name_len) break;
+        fprintf( stderr, "{req=%u,count=%u", stats->req, stats->count );
+        dump_timeout( ",total_time=", &stats->total_time );
+        dump_timeout( ",max_time=", &stats->max_time );
+        dump_uint64( ",bytes_in=", &stats->bytes_in );
+        dump_uint64( ",bytes_out=", &stats->bytes_out );
+        fprintf( stderr, ",name=\"%.*s\"}", (int)stats->name_len, (const char *)(stats + 1) );
+        len = min( (sizeof(*stats) + stats->name_len + 7) & ~7, size );
+        size -= len;
+        remove_data( len );
+        if (size) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+}
+
+static void dump_varargs_completion_msgs( const char *prefix, data_size_t size )
+{
+    const struct completion_msg *msg = cur_data;
+    data_size_t len = size / sizeof(*msg);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        dump_uint64( "{ckey=", &msg->ckey );
+        dump_uint64( ",cvalue=", &msg->cvalue );
+        dump_uint64( ",information=", &msg->information );
+        fprintf( stderr, ",status=%s}", get_status_name( msg->status ) );
+        msg++;
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
+static void dump_varargs_directory_stats( const char *prefix, data_size_t size )
+{
+    const struct directory_stats *stats;
+    data_size_t len;
+
+    fprintf( stderr, "%s{", prefix );
+    while (size >= sizeof(*stats))
+    {
+        stats = cur_data;
+        if (size - sizeof(*stats) < stats->name_len) break;
+        fprintf( stderr, "{count=%u,hash_size=%u,max_chain=%u,name=L\"",
+                 stats->count, stats->hash_size, stats->max_chain );
+        dump_strW( (const WCHAR *)(stats + 1), stats->name_len, stderr, "\"\"" );
+        fputs( "\"}", stderr );
+        len = min( (sizeof(*stats) + stats->name_len + 7) & ~7, size );
+        size -= len;
+        remove_data( len );
+        if (size) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+}
+
 static void dump_varargs_cpu_topology_override( const char *prefix, data_size_t size )
 {
     const struct cpu_topology_override *cpu_topology = cur_data;
@@ -2048,6 +2156,7 @@ static void dump_get_handle_fd_reply( const struct get_handle_fd_reply *req )
     fprintf( stderr, " type=%d", req->type );
     fprintf( stderr, ", cacheable=%d", req->cacheable );
     fprintf( stderr, ", access=%08x", req->access );
+    fprintf( stderr, ", sharing=%08x", req->sharing );
     fprintf( stderr, ", options=%08x", req->options );
 }
 
@@ -5719,6 +5828,11 @@ static const char *get_status_name( unsigned int status )
     return buffer;
 }
 
+const char *get_request_name( enum request req )
+{
+    return req < REQ_NB_REQUESTS ? req_names[req] : "?";
+}
+
 void trace_request(void)
 {
     enum request req = current->req.request_header.req;
@@ -5755,3 +5869,228 @@ void trace_reply( enum request req, const union generic_reply *reply )
     else fprintf( stderr, "%04x: %d() = %s\n",
                   current->id, req, get_status_name(current->error) );
 }
+
+/* binary request tracing, enabled with --trace and decoded with --dump-trace */
+
+#define BINARY_TRACE_MAGIC  0x52545357  /* "WSTR" */
+#define BINARY_TRACE_BUFFER 65536
+
+enum binary_trace_type
+{
+    BINARY_TRACE_REQUEST,
+    BINARY_TRACE_REPLY
+};
+
+struct binary_trace_header
+{
+    unsigned int magic;
+    unsigned int version;      /* protocol version of the server that wrote the file */
+};
+
+struct binary_trace_record
+{
+    unsigned int type;         /* enum binary_trace_type */
+    unsigned int req;          /* request code */
+    process_id_t pid;
+    thread_id_t  tid;
+    timeout_t    time;         /* monotonic time when the record was written */
+    unsigned int status;       /* reply status */
+    data_size_t  size;         /* size of the variable part following the fixed one */
+};
+
+int binary_trace_fd = -1;
+static char binary_trace_buffer[BINARY_TRACE_BUFFER];
+static unsigned int binary_trace_pos;
+
+static void write_binary_trace_data( const void *data, size_t size )
+{
+    ssize_t ret;
+
+    while (size && binary_trace_fd != -1)
+    {
+        if ((ret = write( binary_trace_fd, data, size )) == -1)
+        {
+            if (errno == EINTR) continue;
+            fprintf( stderr, "wineserver: failed to write binary trace: %s\n", strerror( errno ));
+            close( binary_trace_fd );
+            binary_trace_fd = -1;
+            return;
+        }
+        data = (const char *)data + ret;
+        size -= ret;
+    }
+}
+
+void flush_binary_trace(void)
+{
+    write_binary_trace_data( binary_trace_buffer, binary_trace_pos );
+    binary_trace_pos = 0;
+}
+
+static void append_binary_trace( const void *data, data_size_t size )
+{
+    if (binary_trace_pos + size > sizeof(binary_trace_buffer)) flush_binary_trace();
+    if (size > sizeof(binary_trace_buffer))
+    {
+        write_binary_trace_data( data, size );
+        return;
+    }
+    memcpy( binary_trace_buffer + binary_trace_pos, data, size );
+    binary_trace_pos += size;
+}
+
+void open_binary_trace( const char *name )
+{
+    struct binary_trace_header header = { BINARY_TRACE_MAGIC, SERVER_PROTOCOL_VERSION };
+
+    if ((binary_trace_fd = open( name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 )) == -1)
+    {
+        fprintf( stderr, "wineserver: cannot open trace file %s: %s\n", name, strerror( errno ));
+        exit(1);
+    }
+    append_binary_trace( &header, sizeof(header) );
+    atexit( flush_binary_trace );
+}
+
+static void append_binary_trace_record( enum binary_trace_type type, enum request req,
+                                        const void *fixed, const void *data, data_size_t size )
+{
+    struct binary_trace_record record;
+
+    record.type   = type;
+    record.req    = req;
+    record.pid    = current->process->id;
+    record.tid    = current->id;
+    record.time   = monotonic_counter();
+    record.status = type == BINARY_TRACE_REPLY ? current->error : 0;
+    record.size   = size;
+    append_binary_trace( &record, sizeof(record) );
+    append_binary_trace( fixed, sizeof(union generic_request) );
+    if (size) append_binary_trace( data, size );
+}
+
+void binary_trace_request(void)
+{
+    append_binary_trace_record( BINARY_TRACE_REQUEST, current->req.request_header.req, &current->req,
+                                get_req_data(), get_req_data_size() );
+}
+
+void binary_trace_reply( enum request req, const union generic_reply *reply )
+{
+    append_binary_trace_record( BINARY_TRACE_REPLY, req, reply,
+                                current->reply_data, reply->reply_header.reply_size );
+}
+
+static int read_binary_trace_data( FILE *file, void *data, size_t size )
+{
+    return !size || fread( data, size, 1, file ) == 1;
+}
+
+/* print a binary trace as text on stderr, followed by the latency of each request */
+int dump_binary_trace( const char *name )
+{
+    struct binary_trace_header header;
+    struct binary_trace_record record;
+    union generic_request fixed;
+    struct trace_stat
+    {
+        unsigned int count;
+        timeout_t    total_time;
+        timeout_t    max_time;
+    } stats[REQ_NB_REQUESTS];
+    timeout_t start = 0, *pending = NULL, time;
+    unsigned int i, pending_count = 0, index;
+    void *data = NULL;
+    FILE *file;
+
+    C_ASSERT( sizeof(union generic_request) == sizeof(union generic_reply) );
+
+    if (!(file = fopen( name, "rb" )))
+    {
+        fprintf( stderr, "wineserver: cannot open trace file %s: %s\n", name, strerror( errno ));
+        return 0;
+    }
+    if (!read_binary_trace_data( file, &header, sizeof(header) ) ||
+        header.magic != BINARY_TRACE_MAGIC || header.version != SERVER_PROTOCOL_VERSION)
+    {
+        fprintf( stderr, "wineserver: %s is not a trace file of this server version\n", name );
+        fclose( file );
+        return 0;
+    }
+
+    memset( stats, 0, sizeof(stats) );
+    while (read_binary_trace_data( file, &record, sizeof(record) ))
+    {
+        if (!read_binary_trace_data( file, &fixed, sizeof(fixed) ) ||
+            !(data = realloc( data, record.size + 1 )) ||
+            !read_binary_trace_data( file, data, record.size ))
+        {
+            fprintf( stderr, "wineserver: truncated trace file %s\n", name );
+            break;
+        }
+        if (!start) start = record.time;
+        time = record.time - start;
+        fprintf( stderr, "%u.%07u %04x:%04x: ", (unsigned int)(time / TICKS_PER_SEC),
+                 (unsigned int)(time % TICKS_PER_SEC), record.pid, record.tid );
+
+        if (record.req >= REQ_NB_REQUESTS)
+        {
+            fprintf( stderr, "%d%s\n", record.req, record.type == BINARY_TRACE_REQUEST ? "(?)" : "()" );
+            continue;
+        }
+
+        index = record.tid / 4;
+        if (index >= pending_count)
+        {
+            unsigned int new_count = max( index + 1, pending_count * 2 );
+            timeout_t *new_pending = realloc( pending, new_count * sizeof(*pending) );
+
+            if (!new_pending) break;
+            memset( new_pending + pending_count, 0, (new_count - pending_count) * sizeof(*pending) );
+            pending = new_pending;
+            pending_count = new_count;
+        }
+
+        cur_data = data;
+        cur_size = record.size;
+        if (record.type == BINARY_TRACE_REQUEST)
+        {
+            fprintf( stderr, "%s(", req_names[record.req] );
+            if (req_dumpers[record.req]) req_dumpers[record.req]( &fixed );
+            fprintf( stderr, " )\n" );
+            pending[index] = record.time;
+        }
+        else
+        {
+            fprintf( stderr, "%s() = %s", req_names[record.req], get_status_name( record.status ));
+            if (reply_dumpers[record.req])
+            {
+                fprintf( stderr, " {" );
+                reply_dumpers[record.req]( (const union generic_reply *)&fixed );
+                fprintf( stderr, " }" );
+            }
+            fputc( '\n', stderr );
+            if (pending[index])
+            {
+                time = record.time - pending[index];
+                stats[record.req].count++;
+                stats[record.req].total_time += time;
+                if (time > stats[record.req].max_time) stats[record.req].max_time = time;
+                pending[index] = 0;
+            }
+        }
+    }
+
+    fprintf( stderr, "\n%-32s %10s %12s %12s\n", "request", "count", "avg (us)", "max (us)" );
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        if (!stats[i].count) continue;
+        fprintf( stderr, "%-32s %10u %12.1f %12.1f\n", req_names[i], stats[i].count,
+                 (double)stats[i].total_time / stats[i].count / 10, (double)stats[i].max_time / 10 );
+    }
+
+    free( pending );
+    free( data );
+    fclose( file );
+    return 1;
+}
@@ -30,6 +30,7 @@
 #include "ntuser.h"
 
 #include "object.h"
+#include "file.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -72,6 +73,10 @@ struct window
     rectangle_t      client_rect;     /* client rectangle (relative to parent client area) */
     struct region   *win_region;      /* region for shaped windows (relative to window rect) */
     struct region   *update_region;   /* update region (relative to window rect) */
+    struct region   *vis_region;      /* cached visible region (relative to window rect) */
+    unsigned int     vis_flags;       /* DCX flags the cached visible region was computed for */
+    unsigned int     vis_serial;      /* window tree serial of the cached visible region */
+    unsigned int     children_serial; /* window tree serial of the last change to a child */
     unsigned int     style;           /* window style */
     unsigned int     ex_style;        /* window extended style */
     lparam_t         id;              /* window id */
@@ -99,6 +104,40 @@ struct window
 static void window_dump( struct object *obj, int verbose );
 static void window_destroy( struct object *obj );
 
+/* incremented whenever something that visible regions depend on changes */
+static unsigned int window_tree_serial = 1;
+
+/* a change to a window can only affect the visible regions of its parent and of the parent
+ * descendants, so the serial is recorded in the parent and checked along the ancestors */
+static inline void invalidate_visible_regions( struct window *win )
+{
+    if (win->parent) win = win->parent;
+    win->children_serial = ++window_tree_serial;
+}
+
+/* window state published to the clients, indexed by user handle */
+static window_shm_t *window_shm;
+
+#if defined(__i386__) || defined(__x86_64__)
+#define __SHARED_INCREMENT_SEQ( x ) ++(x)
+#else
+#define __SHARED_INCREMENT_SEQ( x ) __atomic_add_fetch( &(x), 1, __ATOMIC_RELEASE )
+#endif
+
+#define SHARED_WRITE_BEGIN( ptr, type )                              \
+    do {                                                             \
+        const type *__shared = (ptr);                                \
+        type *shared = (type *)__shared;                             \
+        unsigned int __seq = __SHARED_INCREMENT_SEQ( shared->seq );  \
+        assert( (__seq & 1) != 0 );                                  \
+        do
+
+#define SHARED_WRITE_END                                             \
+        while(0);                                                    \
+        __seq = __SHARED_INCREMENT_SEQ( shared->seq ) - __seq;       \
+        assert( __seq == 1 );                                        \
+    } while(0);
+
 static const struct object_ops window_ops =
 {
     sizeof(struct window),    /* size */
@@ -174,11 +213,13 @@ static void window_destroy( struct object *obj )
     if (win->parent)
     {
         list_remove( &win->entry );
+        invalidate_visible_regions( win );
         release_object( win->parent );
     }
 
     if (win->win_region) free_region( win->win_region );
     if (win->update_region) free_region( win->update_region );
+    if (win->vis_region) free_region( win->vis_region );
     if (win->class) release_class( win->class );
     free( win->text );
 
@@ -255,6 +296,65 @@ static unsigned int get_monitor_dpi( struct window *win )
     return win->dpi ? win->dpi : USER_DEFAULT_SCREEN_DPI;
 }
 
+/* get the shared memory entry of a window handle */
+static window_shm_t *get_window_shm( user_handle_t handle )
+{
+    static const WCHAR nameW[] = {'w','i','n','d','o','w','s'};
+    static const struct unicode_str name = {nameW, sizeof(nameW)};
+    unsigned int index = ((handle & 0xffff) - FIRST_USER_HANDLE) >> 1;
+    struct object *dir, *mapping;
+
+    if (!window_shm && (dir = create_thread_map_directory()))
+    {
+        /* the mapping lives as long as the server, clients map it on first use */
+        if ((mapping = create_shared_mapping( dir, &name, WINDOW_SHM_ENTRIES * sizeof(*window_shm),
+                                              0, NULL, (void **)&window_shm )))
+        {
+            make_object_permanent( mapping );
+            release_object( mapping );
+        }
+        release_object( dir );
+    }
+    if (!window_shm || index >= WINDOW_SHM_ENTRIES) return NULL;
+    return &window_shm[index];
+}
+
+/* publish the window state that clients query without a server call */
+static void update_window_shm( struct window *win )
+{
+    window_shm_t *entry;
+
+    if (!win->handle || !(entry = get_window_shm( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( entry, window_shm_t )
+    {
+        shared->handle      = win->handle;
+        shared->tid         = win->thread ? get_thread_id( win->thread ) : 0;
+        shared->pid         = win->thread ? get_process_id( win->thread->process ) : 0;
+        shared->parent      = win->parent ? win->parent->handle : 0;
+        shared->owner       = win->owner;
+        shared->style       = win->style;
+        shared->ex_style    = win->ex_style;
+        shared->window_rect = win->window_rect;
+        shared->client_rect = win->client_rect;
+    }
+    SHARED_WRITE_END
+}
+
+/* invalidate the shared memory entry of a window being destroyed */
+static void free_window_shm( struct window *win )
+{
+    window_shm_t *entry;
+
+    if (!(entry = get_window_shm( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( entry, window_shm_t )
+    {
+        shared->handle = 0;
+    }
+    SHARED_WRITE_END
+}
+
 /* link a window at the right place in the siblings list */
 static int link_window( struct window *win, struct window *previous )
 {
@@ -311,6 +411,7 @@ static int link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    invalidate_visible_regions( win );
     return old_prev != win->entry.prev;
 }
 
@@ -331,7 +432,11 @@ static int set_parent_window( struct window *win, struct window *parent )
 
     if (parent)
     {
-        if (win->parent) release_object( win->parent );
+        if (win->parent)
+        {
+            invalidate_visible_regions( win );
+            release_object( win->parent );
+        }
         win->parent = (struct window *)grab_object( parent );
         link_window( win, WINPTR_TOP );
 
@@ -355,7 +460,9 @@ static int set_parent_window( struct window *win, struct window *parent )
         list_add_head( &win->parent->unlinked, &win->entry );
         win->is_linked = 0;
         win->is_orphan = 1;
+        invalidate_visible_regions( win );
     }
+    update_window_shm( win );
     return 1;
 }
 
@@ -494,6 +601,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_window_shm( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -566,6 +674,10 @@ static struct window *create_window( struct window *parent, struct window *owner
     win->atom           = atom;
     win->last_active    = win->handle;
     win->win_region     = NULL;
+    win->vis_region     = NULL;
+    win->vis_flags      = 0;
+    win->vis_serial     = 0;
+    win->children_serial = 0;
     win->update_region  = NULL;
     win->style          = 0;
     win->ex_style       = 0;
@@ -1117,7 +1229,7 @@ static inline struct window *get_top_clipping_window( struct window *win )
 
 
 /* compute the visible region of a window, in window coordinates */
-static struct region *get_visible_region( struct window *win, unsigned int flags )
+static struct region *compute_visible_region( struct window *win, unsigned int flags )
 {
     struct region *tmp = NULL, *region;
     int offset_x, offset_y;
@@ -1196,6 +1308,45 @@ error:
 }
 
 
+/* check if the cached visible region of a window is still valid */
+static int is_visible_region_valid( struct window *win, unsigned int flags )
+{
+    struct window *ptr;
+
+    if (!win->vis_region || !win->vis_serial || win->vis_flags != flags) return 0;
+    for (ptr = win; ptr; ptr = ptr->parent)
+        if ((int)(ptr->children_serial - win->vis_serial) > 0) return 0;
+    return 1;
+}
+
+/* get the visible region of a window, in window coordinates, reusing the cached one if still valid */
+static struct region *get_visible_region( struct window *win, unsigned int flags )
+{
+    struct region *region;
+
+    flags &= DCX_WINDOW | DCX_PARENTCLIP | DCX_CLIPCHILDREN;
+
+    if (is_visible_region_valid( win, flags ))
+    {
+        if (!(region = create_empty_region())) return NULL;
+        if (copy_region( region, win->vis_region )) return region;
+        free_region( region );
+        return NULL;
+    }
+
+    if (!(region = compute_visible_region( win, flags ))) return NULL;
+
+    if (!win->vis_region) win->vis_region = create_empty_region();
+    if (win->vis_region && copy_region( win->vis_region, region ))
+    {
+        win->vis_flags = flags;
+        win->vis_serial = window_tree_serial;
+    }
+    else win->vis_serial = 0;
+    return region;
+}
+
+
 /* clip all children with a custom pixel format out of the visible region */
 static struct region *clip_pixel_format_children( struct window *parent, struct region *parent_clip,
                                                   struct region *region, int offset_x, int offset_y )
@@ -1811,6 +1962,7 @@ static void set_window_pos( struct window *win, struct window *previous,
     win->visible_rect = *visible_rect;
     win->surface_rect = *surface_rect;
     win->client_rect  = *client_rect;
+    invalidate_visible_regions( win );
     if (!(swp_flags & SWP_NOZORDER) && win->parent) zorder_changed |= link_window( win, previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
@@ -1828,8 +1980,10 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->surface_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shm( child );
         }
     }
+    update_window_shm( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) set_clip_rectangle( win->desktop, NULL, SET_CURSOR_NOCLIP, 1 );
@@ -1969,6 +2123,7 @@ static void set_window_region( struct window *win, struct region *region, int re
 
     if (win->win_region) free_region( win->win_region );
     win->win_region = region;
+    invalidate_visible_regions( win );
 
     /* expose anything revealed by the change */
     if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn, 0 ))))
@@ -1994,6 +2149,7 @@ void free_window_handle( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        invalidate_visible_regions( win );
         if (vis_rgn)
         {
             struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn, 0 );
@@ -2046,6 +2202,7 @@ void free_window_handle( struct window *win )
     detach_window_thread( win );
 
     if (win->parent) set_parent_window( win, NULL );
+    free_window_shm( win );
     free_user_handle( win->handle );
     win->handle = 0;
     release_object( win );
@@ -2101,6 +2258,8 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    invalidate_visible_regions( win );
+    update_window_shm( win );
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2164,6 +2323,8 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            invalidate_visible_regions( desktop->top_window );
+            update_window_shm( desktop->top_window );
         }
     }
 
@@ -2176,6 +2337,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shm( desktop->msg_window );
         }
     }
 
@@ -2211,6 +2373,7 @@ DECL_HANDLER(set_window_owner)
 
     reply->prev_owner = win->owner;
     reply->full_owner = win->owner = owner ? owner->handle : 0;
+    update_window_shm( win );
 }
 
 
@@ -2268,6 +2431,7 @@ DECL_HANDLER(set_window_info)
     reply->old_id        = win->id;
     reply->old_instance  = win->instance;
     reply->old_user_data = win->user_data;
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) invalidate_visible_regions( win );
     if (req->flags & SET_WIN_STYLE) win->style = req->style;
     if (req->flags & SET_WIN_EXSTYLE)
     {
@@ -2283,6 +2447,8 @@ DECL_HANDLER(set_window_info)
     if (req->flags & SET_WIN_EXTRA) memcpy( win->extra_bytes + req->extra_offset,
                                             &req->extra_value, req->extra_size );
 
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) update_window_shm( win );
+
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;
 }
@@ -2807,6 +2973,7 @@ DECL_HANDLER(update_window_zorder)
         {
             list_remove( &win->entry );
             list_add_before( &ptr->entry, &win->entry );
+            invalidate_visible_regions( win );
         }
         break;
     }